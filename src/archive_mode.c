@@ -0,0 +1,138 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "archive_mode.h"
+
+#include "buffer_sizes.h"
+#include "error_utilities.h"
+#include "file_source_archive.h"
+#include "hash_calculation_impl.h"
+#include "print_utilities.h"
+#include "std_streams.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int
+uhashtools_archive_mode_run
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    int ret = 1;
+    struct ArchiveFileSourceCtx* archive_ctx = NULL;
+    unsigned char* file_read_buf = NULL;
+    wchar_t error_message_buf[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    wchar_t* result_string_buf = NULL;
+    BOOL all_entries_hashed = TRUE;
+
+    UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
+    UHASHTOOLS_ASSERT(uhashtools_cli_arguments_has_archive_file(cli_arguments),
+                      L"Internal error: Entered archive mode without an archive file!");
+
+    uhashtools_std_streams_connect();
+
+    error_message_buf[0] = L'\0';
+
+    file_read_buf = (unsigned char*) malloc(FILE_READ_BUF_TSIZE);
+    result_string_buf = (wchar_t*) malloc(HASH_RESULT_BUFFER_TSIZE * sizeof *result_string_buf);
+
+    if (!file_read_buf || !result_string_buf)
+    {
+        (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+        goto cleanup_and_out;
+    }
+
+    archive_ctx = uhashtools_file_source_archive_start(error_message_buf,
+                                                       GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                       cli_arguments->archive_file);
+
+    if (!archive_ctx)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", cli_arguments->archive_file, error_message_buf);
+
+        goto cleanup_and_out;
+    }
+
+    for (;;)
+    {
+        struct FileSource entry_file_source;
+        struct ArchiveEntryInfo entry_info;
+        enum ArchiveReaderResult next_entry_rc = ARCHIVE_READER_RESULT_FAILED;
+        enum HashCalculatorResultCode hash_rc = HashCalculatorResultCode_FAILED;
+
+        next_entry_rc = uhashtools_file_source_archive_next_entry(archive_ctx, &entry_file_source, &entry_info);
+
+        if (next_entry_rc == ARCHIVE_READER_RESULT_END)
+        {
+            break;
+        }
+
+        if (next_entry_rc == ARCHIVE_READER_RESULT_FAILED)
+        {
+            (void) fwprintf_s(stderr,
+                              L"%s: %s\n",
+                              cli_arguments->archive_file,
+                              uhashtools_file_source_archive_get_error_message(archive_ctx));
+
+            all_entries_hashed = FALSE;
+            break;
+        }
+
+        hash_rc = uhashtools_hash_calculator_impl_hash_file_source(file_read_buf,
+                                                                   FILE_READ_BUF_TSIZE,
+                                                                   result_string_buf,
+                                                                   HASH_RESULT_BUFFER_TSIZE,
+                                                                   &entry_file_source,
+                                                                   NULL,
+                                                                   NULL,
+                                                                   NULL,
+                                                                   NULL);
+
+        uhashtools_file_source_close(&entry_file_source);
+
+        if (hash_rc != HashCalculatorResultCode_SUCCESS)
+        {
+            const wchar_t* archive_error_message = uhashtools_file_source_archive_get_error_message(archive_ctx);
+
+            /* A read error of an entry is always caused by the archive, which has the more precise message. */
+            (void) fwprintf_s(stderr,
+                              L"%s: %s\n",
+                              entry_info.entry_name,
+                              archive_error_message[0] != L'\0' ? archive_error_message : result_string_buf);
+
+            all_entries_hashed = FALSE;
+            break;
+        }
+
+        (void) wprintf_s(L"%s *%s\n", result_string_buf, entry_info.entry_name);
+    }
+
+    (void) fflush(stdout);
+
+    if (all_entries_hashed)
+    {
+        ret = 0;
+    }
+
+cleanup_and_out:
+    uhashtools_file_source_archive_stop(archive_ctx);
+
+    if (result_string_buf)
+    {
+        free((void*) result_string_buf);
+    }
+
+    if (file_read_buf)
+    {
+        free((void*) file_read_buf);
+    }
+
+    return ret;
+}
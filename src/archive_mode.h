@@ -0,0 +1,35 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "cli_arguments.h"
+
+/*
+ * The archive mode hashes every file entry of an archive without
+ * extracting the archive to the disk. No window is created in this
+ * mode. The result of each entry is written as a line in the format
+ * "<hash> *<entry name>" to stdout, which allows redirecting the
+ * results into a file that can be checked with the common "*sum"
+ * tools after extracting the archive.
+ */
+
+/**
+ * Runs the archive mode for the archive from the command line arguments.
+ * 
+ * @param cli_arguments Command line arguments with a set archive file.
+ * 
+ * @return Exit code of the process. Zero if all entries have been hashed
+ *         successfully else one.
+ */
+extern
+int
+uhashtools_archive_mode_run
+(
+    const struct CliArguments* cli_arguments
+);
@@ -0,0 +1,1513 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "archive_reader.h"
+
+#include "error_utilities.h"
+#include "inflate.h"
+#include "print_utilities.h"
+
+#include <io.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARCHIVE_INPUT_BUF_SIZE (1024 * 64)
+
+#define ZIP_LOCAL_HEADER_SIGNATURE 0x04034B50u
+#define ZIP_CENTRAL_HEADER_SIGNATURE 0x02014B50u
+#define ZIP_EOCD_SIGNATURE 0x06054B50u
+#define ZIP64_EOCD_SIGNATURE 0x06064B50u
+#define ZIP64_EOCD_LOCATOR_SIGNATURE 0x07064B50u
+#define ZIP_LOCAL_HEADER_SIZE 30
+#define ZIP_CENTRAL_HEADER_SIZE 46
+#define ZIP_EOCD_SIZE 22
+#define ZIP64_EOCD_SIZE 56
+#define ZIP64_EOCD_LOCATOR_SIZE 20
+#define ZIP_MAX_COMMENT_SIZE 0xFFFF
+#define ZIP_FLAG_ENCRYPTED 0x0001u
+#define ZIP_FLAG_UTF8_NAME 0x0800u
+#define ZIP_METHOD_STORED 0
+#define ZIP_METHOD_DEFLATED 8
+#define ZIP_CODE_PAGE_IBM437 437
+
+#define GZIP_FLAG_FHCRC 0x02u
+#define GZIP_FLAG_FEXTRA 0x04u
+#define GZIP_FLAG_FNAME 0x08u
+#define GZIP_FLAG_FCOMMENT 0x10u
+
+#define TAR_BLOCK_SIZE 512
+
+/*
+ * The scratch buffer must hold the end of a ZIP archive with a comment
+ * of the maximum size and the ZIP64 locator in front of it.
+ */
+#define ARCHIVE_SCRATCH_BUF_SIZE (ZIP64_EOCD_LOCATOR_SIZE + ZIP_EOCD_SIZE + ZIP_MAX_COMMENT_SIZE)
+
+enum ArchiveFormat
+{
+    ARCHIVE_FORMAT_ZIP,
+    ARCHIVE_FORMAT_TAR,
+    ARCHIVE_FORMAT_TAR_GZIP
+};
+
+struct ArchiveReader
+{
+    enum ArchiveFormat format;
+    FILE* archive_file_handle;
+    unsigned __int64 archive_file_size;
+
+    /* Buffered access to the archive file */
+    unsigned char input_buf[ARCHIVE_INPUT_BUF_SIZE];
+    size_t input_buf_pos;
+    size_t input_buf_len;
+    BOOL input_is_limited;
+    unsigned __int64 input_limit_remaining;
+
+    /* Decoder for deflated ZIP entries and the gzip stream of compressed tar archives */
+    struct InflateStream inflate_stream;
+
+    /* State of the current entry */
+    BOOL entry_is_deflated;
+    unsigned __int64 entry_remaining;
+    unsigned __int64 entry_size;
+    unsigned __int64 entry_read_total;
+    BOOL entry_reached_eof;
+
+    /* ZIP specific state */
+    unsigned __int64 zip_next_central_header_offset;
+    unsigned __int64 zip_remaining_central_headers;
+    unsigned int zip_entry_expected_crc32;
+    unsigned int zip_entry_crc32;
+    unsigned int crc32_table[256];
+
+    /* tar specific state */
+    unsigned __int64 tar_entry_padding;
+    BOOL tar_reached_end;
+    BOOL tar_has_pending_name;
+    BOOL tar_has_pending_size;
+    unsigned __int64 tar_pending_size;
+    wchar_t tar_pending_name[FILEPATH_BUFFER_TSIZE];
+
+    unsigned char scratch_buf[ARCHIVE_SCRATCH_BUF_SIZE];
+    wchar_t error_message[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+};
+
+/* Helper functions */
+
+static
+BOOL
+uhashtools_archive_reader_fail
+(
+    struct ArchiveReader* archive_reader,
+    const wchar_t* error_message
+)
+{
+    (void) wcscpy_s(archive_reader->error_message, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, error_message);
+
+    UHASHTOOLS_PRINTF_LINE_ERROR(L"Archive reader: %s", error_message);
+
+    return FALSE;
+}
+
+static
+unsigned int
+uhashtools_archive_reader_le16
+(
+    const unsigned char* buf
+)
+{
+    return (unsigned int) buf[0] | ((unsigned int) buf[1] << 8);
+}
+
+static
+unsigned int
+uhashtools_archive_reader_le32
+(
+    const unsigned char* buf
+)
+{
+    return (unsigned int) buf[0] |
+           ((unsigned int) buf[1] << 8) |
+           ((unsigned int) buf[2] << 16) |
+           ((unsigned int) buf[3] << 24);
+}
+
+static
+unsigned __int64
+uhashtools_archive_reader_le64
+(
+    const unsigned char* buf
+)
+{
+    return (unsigned __int64) uhashtools_archive_reader_le32(buf) |
+           ((unsigned __int64) uhashtools_archive_reader_le32(buf + 4) << 32);
+}
+
+static
+void
+uhashtools_archive_reader_init_crc32_table
+(
+    unsigned int* crc32_table
+)
+{
+    unsigned int i = 0;
+
+    for (i = 0; i < 256; ++i)
+    {
+        unsigned int crc = i;
+        int bit = 0;
+
+        for (bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 1u) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+
+        crc32_table[i] = crc;
+    }
+}
+
+static
+unsigned int
+uhashtools_archive_reader_update_crc32
+(
+    const unsigned int* crc32_table,
+    unsigned int crc,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    size_t i = 0;
+
+    crc = ~crc;
+
+    for (i = 0; i < data_size; ++i)
+    {
+        crc = crc32_table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+static
+BOOL
+uhashtools_archive_reader_convert_name
+(
+    const char* name,
+    size_t name_len,
+    UINT code_page,
+    wchar_t* out_buf,
+    size_t out_buf_tsize
+)
+{
+    int converted_tsize = 0;
+
+    if (name_len == 0 || name_len >= out_buf_tsize)
+    {
+        return FALSE;
+    }
+
+    converted_tsize = MultiByteToWideChar(code_page,
+                                          code_page == CP_UTF8 ? MB_ERR_INVALID_CHARS : 0,
+                                          name,
+                                          (int) name_len,
+                                          out_buf,
+                                          (int) out_buf_tsize - 1);
+
+    if (converted_tsize <= 0 && code_page == CP_UTF8)
+    {
+        /* Not valid UTF-8, so the name is most likely in the ANSI code page of the creator. */
+        converted_tsize = MultiByteToWideChar(CP_ACP,
+                                              0,
+                                              name,
+                                              (int) name_len,
+                                              out_buf,
+                                              (int) out_buf_tsize - 1);
+    }
+
+    if (converted_tsize <= 0)
+    {
+        return FALSE;
+    }
+
+    out_buf[converted_tsize] = L'\0';
+
+    return TRUE;
+}
+
+/* Buffered access to the archive file */
+
+static
+BOOL
+uhashtools_archive_reader_seek
+(
+    struct ArchiveReader* archive_reader,
+    unsigned __int64 offset
+)
+{
+    archive_reader->input_buf_pos = 0;
+    archive_reader->input_buf_len = 0;
+
+    if (offset > archive_reader->archive_file_size ||
+        _fseeki64(archive_reader->archive_file_handle, (__int64) offset, SEEK_SET) != 0)
+    {
+        return uhashtools_archive_reader_fail(archive_reader, L"The archive is corrupt (invalid offset)!");
+    }
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_archive_reader_read_raw
+(
+    struct ArchiveReader* archive_reader,
+    unsigned char* buf,
+    size_t buf_size,
+    size_t* read_size
+)
+{
+    size_t available_size = 0;
+
+    *read_size = 0;
+
+    if (archive_reader->input_is_limited && archive_reader->input_limit_remaining < (unsigned __int64) buf_size)
+    {
+        buf_size = (size_t) archive_reader->input_limit_remaining;
+    }
+
+    if (buf_size == 0)
+    {
+        return TRUE;
+    }
+
+    if (archive_reader->input_buf_pos >= archive_reader->input_buf_len)
+    {
+        archive_reader->input_buf_pos = 0;
+        archive_reader->input_buf_len = fread_s((void*) archive_reader->input_buf,
+                                                ARCHIVE_INPUT_BUF_SIZE,
+                                                sizeof(*archive_reader->input_buf),
+                                                ARCHIVE_INPUT_BUF_SIZE,
+                                                archive_reader->archive_file_handle);
+
+        if (archive_reader->input_buf_len == 0 && ferror(archive_reader->archive_file_handle))
+        {
+            return uhashtools_archive_reader_fail(archive_reader, L"Failed to read the archive file!");
+        }
+    }
+
+    available_size = archive_reader->input_buf_len - archive_reader->input_buf_pos;
+
+    if (available_size > buf_size)
+    {
+        available_size = buf_size;
+    }
+
+    (void) memcpy((void*) buf, (const void*) (archive_reader->input_buf + archive_reader->input_buf_pos), available_size);
+    archive_reader->input_buf_pos += available_size;
+
+    if (archive_reader->input_is_limited)
+    {
+        archive_reader->input_limit_remaining -= available_size;
+    }
+
+    *read_size = available_size;
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_archive_reader_inflate_input_function
+(
+    void* userdata,
+    unsigned char* buf,
+    size_t buf_size,
+    size_t* read_size
+)
+{
+    return uhashtools_archive_reader_read_raw((struct ArchiveReader*) userdata, buf, buf_size, read_size);
+}
+
+/* Reads exactly "size" bytes from the raw file or from the decompressed gzip stream. */
+static
+BOOL
+uhashtools_archive_reader_read_exact
+(
+    struct ArchiveReader* archive_reader,
+    BOOL from_inflate_stream,
+    unsigned char* buf,
+    size_t size,
+    size_t* read_size
+)
+{
+    *read_size = 0;
+
+    while (*read_size < size)
+    {
+        size_t current_read_size = 0;
+        BOOL reached_end = FALSE;
+
+        if (from_inflate_stream)
+        {
+            if (!uhashtools_inflate_read(&archive_reader->inflate_stream,
+                                         buf + *read_size,
+                                         size - *read_size,
+                                         &current_read_size,
+                                         &reached_end))
+            {
+                return uhashtools_archive_reader_fail(archive_reader, L"The compressed data of the archive is corrupt!");
+            }
+        }
+        else
+        {
+            if (!uhashtools_archive_reader_read_raw(archive_reader,
+                                                    buf + *read_size,
+                                                    size - *read_size,
+                                                    &current_read_size))
+            {
+                return FALSE;
+            }
+
+            reached_end = current_read_size == 0;
+        }
+
+        *read_size += current_read_size;
+
+        if (reached_end && current_read_size == 0)
+        {
+            break;
+        }
+    }
+
+    return TRUE;
+}
+
+/* ZIP support */
+
+static
+BOOL
+uhashtools_archive_reader_zip_find_central_directory
+(
+    struct ArchiveReader* archive_reader
+)
+{
+    unsigned char* tail_buf = archive_reader->scratch_buf;
+    unsigned __int64 tail_size = ARCHIVE_SCRATCH_BUF_SIZE;
+    unsigned __int64 tail_offset = 0;
+    unsigned __int64 central_directory_offset = 0;
+    unsigned __int64 central_directory_entries = 0;
+    size_t read_size = 0;
+    size_t eocd_pos = 0;
+    BOOL eocd_found = FALSE;
+
+    if (tail_size > archive_reader->archive_file_size)
+    {
+        tail_size = archive_reader->archive_file_size;
+    }
+
+    if (tail_size < ZIP_EOCD_SIZE)
+    {
+        return uhashtools_archive_reader_fail(archive_reader, L"The ZIP archive is corrupt (end of central directory not found)!");
+    }
+
+    tail_offset = archive_reader->archive_file_size - tail_size;
+
+    if (!uhashtools_archive_reader_seek(archive_reader, tail_offset) ||
+        !uhashtools_archive_reader_read_exact(archive_reader, FALSE, tail_buf, (size_t) tail_size, &read_size))
+    {
+        return FALSE;
+    }
+
+    if (read_size != (size_t) tail_size)
+    {
+        return uhashtools_archive_reader_fail(archive_reader, L"Failed to read the archive file!");
+    }
+
+    for (eocd_pos = (size_t) tail_size - ZIP_EOCD_SIZE + 1; eocd_pos > 0; --eocd_pos)
+    {
+        if (uhashtools_archive_reader_le32(tail_buf + eocd_pos - 1) == ZIP_EOCD_SIGNATURE)
+        {
+            eocd_pos -= 1;
+            eocd_found = TRUE;
+            break;
+        }
+    }
+
+    if (!eocd_found)
+    {
+        return uhashtools_archive_reader_fail(archive_reader, L"The ZIP archive is corrupt (end of central directory not found)!");
+    }
+
+    central_directory_entries = uhashtools_archive_reader_le16(tail_buf + eocd_pos + 10);
+    central_directory_offset = uhashtools_archive_reader_le32(tail_buf + eocd_pos + 16);
+
+    if (central_directory_entries == 0xFFFFu || central_directory_offset == 0xFFFFFFFFu)
+    {
+        unsigned char zip64_eocd[ZIP64_EOCD_SIZE];
+        unsigned __int64 zip64_eocd_offset = 0;
+
+        if (eocd_pos < ZIP64_EOCD_LOCATOR_SIZE ||
+            uhashtools_archive_reader_le32(tail_buf + eocd_pos - ZIP64_EOCD_LOCATOR_SIZE) != ZIP64_EOCD_LOCATOR_SIGNATURE)
+        {
+            return uhashtools_archive_reader_fail(archive_reader, L"The ZIP archive is corrupt (ZIP64 locator not found)!");
+        }
+
+        zip64_eocd_offset = uhashtools_archive_reader_le64(tail_buf + eocd_pos - ZIP64_EOCD_LOCATOR_SIZE + 8);
+
+        if (!uhashtools_archive_reader_seek(archive_reader, zip64_eocd_offset) ||
+            !uhashtools_archive_reader_read_exact(archive_reader, FALSE, zip64_eocd, ZIP64_EOCD_SIZE, &read_size))
+        {
+            return FALSE;
+        }
+
+        if (read_size != ZIP64_EOCD_SIZE || uhashtools_archive_reader_le32(zip64_eocd) != ZIP64_EOCD_SIGNATURE)
+        {
+            return uhashtools_archive_reader_fail(archive_reader, L"The ZIP archive is corrupt (invalid ZIP64 end of central directory)!");
+        }
+
+        central_directory_entries = uhashtools_archive_reader_le64(zip64_eocd + 32);
+        central_directory_offset = uhashtools_archive_reader_le64(zip64_eocd + 48);
+    }
+
+    archive_reader->zip_next_central_header_offset = central_directory_offset;
+    archive_reader->zip_remaining_central_headers = central_directory_entries;
+
+    UHASHTOOLS_PRINTF_LINE_DEBUG(L"ZIP archive with \"%I64u\" entries, central directory at offset \"%I64u\".",
+                                 central_directory_entries,
+                                 central_directory_offset);
+
+    return TRUE;
+}
+
+static
+void
+uhashtools_archive_reader_zip_apply_zip64_extra_field
+(
+    const unsigned char* extra_field,
+    size_t extra_field_size,
+    unsigned __int64* uncompressed_size,
+    unsigned __int64* compressed_size,
+    unsigned __int64* local_header_offset
+)
+{
+    size_t pos = 0;
+
+    while (pos + 4 <= extra_field_size)
+    {
+        const unsigned int header_id = uhashtools_archive_reader_le16(extra_field + pos);
+        const size_t data_size = uhashtools_archive_reader_le16(extra_field + pos + 2);
+        const unsigned char* data = extra_field + pos + 4;
+        size_t data_pos = 0;
+
+        if (pos + 4 + data_size > extra_field_size)
+        {
+            return;
+        }
+
+        if (header_id == 0x0001u)
+        {
+            /* The ZIP64 fields are only present if the regular field is set to 0xFFFFFFFF. */
+            if (*uncompressed_size == 0xFFFFFFFFu && data_pos + 8 <= data_size)
+            {
+                *uncompressed_size = uhashtools_archive_reader_le64(data + data_pos);
+                data_pos += 8;
+            }
+
+            if (*compressed_size == 0xFFFFFFFFu && data_pos + 8 <= data_size)
+            {
+                *compressed_size = uhashtools_archive_reader_le64(data + data_pos);
+                data_pos += 8;
+            }
+
+            if (*local_header_offset == 0xFFFFFFFFu && data_pos + 8 <= data_size)
+            {
+                *local_header_offset = uhashtools_archive_reader_le64(data + data_pos);
+            }
+
+            return;
+        }
+
+        pos += 4 + data_size;
+    }
+}
+
+static
+enum ArchiveReaderResult
+uhashtools_archive_reader_zip_next_entry
+(
+    struct ArchiveReader* archive_reader,
+    struct ArchiveEntryInfo* entry_info
+)
+{
+    while (archive_reader->zip_remaining_central_headers > 0)
+    {
+        unsigned char central_header[ZIP_CENTRAL_HEADER_SIZE];
+        unsigned char local_header[ZIP_LOCAL_HEADER_SIZE];
+        unsigned int flags = 0;
+        unsigned int compression_method = 0;
+        size_t name_len = 0;
+        size_t extra_len = 0;
+        size_t comment_len = 0;
+        unsigned __int64 compressed_size = 0;
+        unsigned __int64 uncompressed_size = 0;
+        unsigned __int64 local_header_offset = 0;
+        unsigned __int64 data_offset = 0;
+        size_t read_size = 0;
+
+        if (!uhashtools_archive_reader_seek(archive_reader, archive_reader->zip_next_central_header_offset) ||
+            !uhashtools_archive_reader_read_exact(archive_reader, FALSE, central_header, ZIP_CENTRAL_HEADER_SIZE, &read_size))
+        {
+            return ARCHIVE_READER_RESULT_FAILED;
+        }
+
+        if (read_size != ZIP_CENTRAL_HEADER_SIZE ||
+            uhashtools_archive_reader_le32(central_header) != ZIP_CENTRAL_HEADER_SIGNATURE)
+        {
+            (void) uhashtools_archive_reader_fail(archive_reader, L"The ZIP archive is corrupt (invalid central directory entry)!");
+
+            return ARCHIVE_READER_RESULT_FAILED;
+        }
+
+        flags = uhashtools_archive_reader_le16(central_header + 8);
+        compression_method = uhashtools_archive_reader_le16(central_header + 10);
+        archive_reader->zip_entry_expected_crc32 = uhashtools_archive_reader_le32(central_header + 16);
+        compressed_size = uhashtools_archive_reader_le32(central_header + 20);
+        uncompressed_size = uhashtools_archive_reader_le32(central_header + 24);
+        name_len = uhashtools_archive_reader_le16(central_header + 28);
+        extra_len = uhashtools_archive_reader_le16(central_header + 30);
+        comment_len = uhashtools_archive_reader_le16(central_header + 32);
+        local_header_offset = uhashtools_archive_reader_le32(central_header + 42);
+
+        archive_reader->zip_next_central_header_offset += ZIP_CENTRAL_HEADER_SIZE + name_len + extra_len + comment_len;
+        --archive_reader->zip_remaining_central_headers;
+
+        if (name_len >= FILEPATH_BUFFER_TSIZE)
+        {
+            (void) uhashtools_archive_reader_fail(archive_reader, L"The archive contains an entry with an invalid or too long name!");
+
+            return ARCHIVE_READER_RESULT_FAILED;
+        }
+
+        /*
+         * The name and the extra field directly follow the central header.
+         * Together both can be larger than the scratch buffer, in that case
+         * only the start of the extra field is read. The next central header
+         * is reached by seeking, so the rest doesn't have to be skipped.
+         */
+        if (extra_len > ARCHIVE_SCRATCH_BUF_SIZE - name_len)
+        {
+            extra_len = ARCHIVE_SCRATCH_BUF_SIZE - name_len;
+        }
+
+        if (!uhashtools_archive_reader_read_exact(archive_reader, FALSE, archive_reader->scratch_buf, name_len + extra_len, &read_size))
+        {
+            return ARCHIVE_READER_RESULT_FAILED;
+        }
+
+        if (read_size != name_len + extra_len)
+        {
+            (void) uhashtools_archive_reader_fail(archive_reader, L"The ZIP archive is corrupt (truncated central directory)!");
+
+            return ARCHIVE_READER_RESULT_FAILED;
+        }
+
+        if (name_len > 0 && archive_reader->scratch_buf[name_len - 1] == '/')
+        {
+            /* Directory entry */
+            continue;
+        }
+
+        if (!uhashtools_archive_reader_convert_name((const char*) archive_reader->scratch_buf,
+                                                    name_len,
+                                                    (flags & ZIP_FLAG_UTF8_NAME) ? CP_UTF8 : ZIP_CODE_PAGE_IBM437,
+                                                    entry_info->entry_name,
+                                                    FILEPATH_BUFFER_TSIZE))
+        {
+            (void) uhashtools_archive_reader_fail(archive_reader, L"The archive contains an entry with an invalid or too long name!");
+
+            return ARCHIVE_READER_RESULT_FAILED;
+        }
+
+        uhashtools_archive_reader_zip_apply_zip64_extra_field(archive_reader->scratch_buf + name_len,
+                                                              extra_len,
+                                                              &uncompressed_size,
+                                                              &compressed_size,
+                                                              &local_header_offset);
+
+        if (flags & ZIP_FLAG_ENCRYPTED)
+        {
+            (void) uhashtools_archive_reader_fail(archive_reader, L"The archive contains encrypted entries which are not supported!");
+
+            return ARCHIVE_READER_RESULT_FAILED;
+        }
+
+        if (compression_method != ZIP_METHOD_STORED && compression_method != ZIP_METHOD_DEFLATED)
+        {
+            (void) uhashtools_archive_reader_fail(archive_reader, L"The archive contains entries with an unsupported compression method!");
+
+            return ARCHIVE_READER_RESULT_FAILED;
+        }
+
+        if (!uhashtools_archive_reader_seek(archive_reader, local_header_offset) ||
+            !uhashtools_archive_reader_read_exact(archive_reader, FALSE, local_header, ZIP_LOCAL_HEADER_SIZE, &read_size))
+        {
+            return ARCHIVE_READER_RESULT_FAILED;
+        }
+
+        if (read_size != ZIP_LOCAL_HEADER_SIZE ||
+            uhashtools_archive_reader_le32(local_header) != ZIP_LOCAL_HEADER_SIGNATURE)
+        {
+            (void) uhashtools_archive_reader_fail(archive_reader, L"The ZIP archive is corrupt (invalid local file header)!");
+
+            return ARCHIVE_READER_RESULT_FAILED;
+        }
+
+        data_offset = local_header_offset + ZIP_LOCAL_HEADER_SIZE +
+                      uhashtools_archive_reader_le16(local_header + 26) +
+                      uhashtools_archive_reader_le16(local_header + 28);
+
+        if (data_offset > archive_reader->archive_file_size ||
+            compressed_size > archive_reader->archive_file_size - data_offset ||
+            (compression_method == ZIP_METHOD_STORED && compressed_size != uncompressed_size))
+        {
+            (void) uhashtools_archive_reader_fail(archive_reader, L"The ZIP archive is corrupt (invalid entry size)!");
+
+            return ARCHIVE_READER_RESULT_FAILED;
+        }
+
+        if (!uhashtools_archive_reader_seek(archive_reader, data_offset))
+        {
+            return ARCHIVE_READER_RESULT_FAILED;
+        }
+
+        archive_reader->input_is_limited = TRUE;
+        archive_reader->input_limit_remaining = compressed_size;
+        archive_reader->entry_is_deflated = compression_method == ZIP_METHOD_DEFLATED;
+        archive_reader->entry_remaining = uncompressed_size;
+        archive_reader->entry_size = uncompressed_size;
+        archive_reader->zip_entry_crc32 = 0;
+
+        if (archive_reader->entry_is_deflated)
+        {
+            uhashtools_inflate_init(&archive_reader->inflate_stream,
+                                    &uhashtools_archive_reader_inflate_input_function,
+                                    (void*) archive_reader);
+        }
+
+        entry_info->size = uncompressed_size;
+
+        return ARCHIVE_READER_RESULT_OK;
+    }
+
+    return ARCHIVE_READER_RESULT_END;
+}
+
+static
+BOOL
+uhashtools_archive_reader_zip_read_entry_data
+(
+    struct ArchiveReader* archive_reader,
+    unsigned char* buf,
+    size_t buf_size,
+    size_t* read_size
+)
+{
+    if (archive_reader->entry_is_deflated)
+    {
+        BOOL reached_end = FALSE;
+
+        if (!uhashtools_inflate_read(&archive_reader->inflate_stream, buf, buf_size, read_size, &reached_end))
+        {
+            return uhashtools_archive_reader_fail(archive_reader, L"The compressed data of an archive entry is corrupt!");
+        }
+
+        if (*read_size > archive_reader->entry_remaining || (reached_end && *read_size != archive_reader->entry_remaining))
+        {
+            return uhashtools_archive_reader_fail(archive_reader, L"The size of an archive entry doesn't match the size in the archive directory!");
+        }
+    }
+    else
+    {
+        if (!uhashtools_archive_reader_read_exact(archive_reader, FALSE, buf, buf_size, read_size))
+        {
+            return FALSE;
+        }
+
+        if (*read_size == 0 && archive_reader->entry_remaining > 0)
+        {
+            return uhashtools_archive_reader_fail(archive_reader, L"The archive is truncated!");
+        }
+    }
+
+    archive_reader->zip_entry_crc32 = uhashtools_archive_reader_update_crc32(archive_reader->crc32_table,
+                                                                             archive_reader->zip_entry_crc32,
+                                                                             buf,
+                                                                             *read_size);
+
+    return TRUE;
+}
+
+/* tar support */
+
+static
+BOOL
+uhashtools_archive_reader_tar_parse_number
+(
+    const unsigned char* field,
+    size_t field_size,
+    unsigned __int64* value
+)
+{
+    size_t i = 0;
+
+    *value = 0;
+
+    if (field[0] & 0x80u)
+    {
+        /* GNU base-256 encoding for values which don't fit into the octal field */
+        for (i = 1; i < field_size; ++i)
+        {
+            if (*value > (_UI64_MAX >> 8))
+            {
+                return FALSE;
+            }
+
+            *value = (*value << 8) | field[i];
+        }
+
+        return TRUE;
+    }
+
+    for (i = 0; i < field_size && field[i] == ' '; ++i)
+    {
+        /* Skipping leading spaces */
+    }
+
+    for (; i < field_size && field[i] >= '0' && field[i] <= '7'; ++i)
+    {
+        *value = (*value << 3) | (unsigned __int64) (field[i] - '0');
+    }
+
+    return i == field_size || field[i] == '\0' || field[i] == ' ';
+}
+
+static
+BOOL
+uhashtools_archive_reader_tar_is_header_valid
+(
+    const unsigned char* header
+)
+{
+    unsigned __int64 expected_checksum = 0;
+    unsigned __int64 checksum = 0;
+    size_t i = 0;
+
+    if (!uhashtools_archive_reader_tar_parse_number(header + 148, 8, &expected_checksum))
+    {
+        return FALSE;
+    }
+
+    for (i = 0; i < TAR_BLOCK_SIZE; ++i)
+    {
+        /* The checksum field itself is counted as spaces. */
+        checksum += (i >= 148 && i < 156) ? (unsigned int) ' ' : header[i];
+    }
+
+    return checksum == expected_checksum;
+}
+
+static
+BOOL
+uhashtools_archive_reader_tar_skip
+(
+    struct ArchiveReader* archive_reader,
+    unsigned __int64 skip_size
+)
+{
+    while (skip_size > 0)
+    {
+        size_t chunk_size = ARCHIVE_SCRATCH_BUF_SIZE;
+        size_t read_size = 0;
+
+        if ((unsigned __int64) chunk_size > skip_size)
+        {
+            chunk_size = (size_t) skip_size;
+        }
+
+        if (!uhashtools_archive_reader_read_exact(archive_reader,
+                                                  archive_reader->format == ARCHIVE_FORMAT_TAR_GZIP,
+                                                  archive_reader->scratch_buf,
+                                                  chunk_size,
+                                                  &read_size))
+        {
+            return FALSE;
+        }
+
+        if (read_size != chunk_size)
+        {
+            return uhashtools_archive_reader_fail(archive_reader, L"The archive is truncated!");
+        }
+
+        skip_size -= chunk_size;
+    }
+
+    return TRUE;
+}
+
+static
+unsigned __int64
+uhashtools_archive_reader_tar_padding
+(
+    unsigned __int64 size
+)
+{
+    return (TAR_BLOCK_SIZE - (size % TAR_BLOCK_SIZE)) % TAR_BLOCK_SIZE;
+}
+
+/* Reads the data of a meta entry (long name or pax header) into the scratch buffer. */
+static
+BOOL
+uhashtools_archive_reader_tar_read_meta_entry
+(
+    struct ArchiveReader* archive_reader,
+    unsigned __int64 size
+)
+{
+    unsigned __int64 padded_size = 0;
+    size_t read_size = 0;
+
+    /* Checked before adding the padding, which would wrap around for sizes close to 2^64. */
+    if (size >= ARCHIVE_SCRATCH_BUF_SIZE)
+    {
+        return uhashtools_archive_reader_fail(archive_reader, L"The archive contains an unsupported huge extended header!");
+    }
+
+    padded_size = size + uhashtools_archive_reader_tar_padding(size);
+
+    /* The padding is read together with the data because skipping it would overwrite the scratch buffer. */
+    if (padded_size >= ARCHIVE_SCRATCH_BUF_SIZE)
+    {
+        return uhashtools_archive_reader_fail(archive_reader, L"The archive contains an unsupported huge extended header!");
+    }
+
+    if (!uhashtools_archive_reader_read_exact(archive_reader,
+                                              archive_reader->format == ARCHIVE_FORMAT_TAR_GZIP,
+                                              archive_reader->scratch_buf,
+                                              (size_t) padded_size,
+                                              &read_size))
+    {
+        return FALSE;
+    }
+
+    if (read_size != (size_t) padded_size)
+    {
+        return uhashtools_archive_reader_fail(archive_reader, L"The archive is truncated!");
+    }
+
+    archive_reader->scratch_buf[size] = '\0';
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_archive_reader_tar_apply_pax_header
+(
+    struct ArchiveReader* archive_reader,
+    size_t pax_header_size
+)
+{
+    size_t pos = 0;
+
+    /* Every record has the format "<length> <key>=<value>\n". */
+    while (pos < pax_header_size)
+    {
+        const char* record = (const char*) archive_reader->scratch_buf + pos;
+        size_t record_len = 0;
+        size_t key_pos = 0;
+        const char* key = NULL;
+        const char* value = NULL;
+        size_t value_len = 0;
+
+        while (pos + key_pos < pax_header_size && record[key_pos] >= '0' && record[key_pos] <= '9')
+        {
+            record_len = record_len * 10 + (size_t) (record[key_pos] - '0');
+            ++key_pos;
+        }
+
+        if (record_len == 0 || record_len > pax_header_size - pos || record[key_pos] != ' ' || record[record_len - 1] != '\n')
+        {
+            return uhashtools_archive_reader_fail(archive_reader, L"The archive contains an invalid pax header!");
+        }
+
+        key = record + key_pos + 1;
+        value = (const char*) memchr((const void*) key, '=', record_len - key_pos - 1);
+
+        if (value)
+        {
+            ++value;
+            value_len = (size_t) (record + record_len - 1 - value);
+
+            if ((size_t) (value - key) == 5 && memcmp((const void*) key, (const void*) "path=", 5) == 0)
+            {
+                archive_reader->tar_has_pending_name = uhashtools_archive_reader_convert_name(value,
+                                                                                              value_len,
+                                                                                              CP_UTF8,
+                                                                                              archive_reader->tar_pending_name,
+                                                                                              FILEPATH_BUFFER_TSIZE);
+
+                if (!archive_reader->tar_has_pending_name)
+                {
+                    return uhashtools_archive_reader_fail(archive_reader, L"The archive contains an entry with an invalid or too long name!");
+                }
+            }
+            else if ((size_t) (value - key) == 5 && memcmp((const void*) key, (const void*) "size=", 5) == 0)
+            {
+                size_t i = 0;
+
+                archive_reader->tar_pending_size = 0;
+
+                for (i = 0; i < value_len && value[i] >= '0' && value[i] <= '9'; ++i)
+                {
+                    archive_reader->tar_pending_size = archive_reader->tar_pending_size * 10 + (unsigned __int64) (value[i] - '0');
+                }
+
+                archive_reader->tar_has_pending_size = TRUE;
+            }
+        }
+
+        pos += record_len;
+    }
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_archive_reader_tar_get_header_name
+(
+    struct ArchiveReader* archive_reader,
+    const unsigned char* header,
+    wchar_t* out_buf,
+    size_t out_buf_tsize
+)
+{
+    char name_buf[256 + 1];
+    size_t name_len = 0;
+    const unsigned char* name_field = header;
+    const unsigned char* prefix_field = header + 345;
+    size_t field_len = 0;
+
+    (void) archive_reader;
+
+    if (memcmp((const void*) (header + 257), (const void*) "ustar", 5) == 0 && prefix_field[0] != '\0')
+    {
+        for (field_len = 0; field_len < 155 && prefix_field[field_len] != '\0'; ++field_len)
+        {
+            name_buf[name_len++] = (char) prefix_field[field_len];
+        }
+
+        name_buf[name_len++] = '/';
+    }
+
+    for (field_len = 0; field_len < 100 && name_field[field_len] != '\0'; ++field_len)
+    {
+        name_buf[name_len++] = (char) name_field[field_len];
+    }
+
+    return uhashtools_archive_reader_convert_name(name_buf, name_len, CP_UTF8, out_buf, out_buf_tsize);
+}
+
+static
+enum ArchiveReaderResult
+uhashtools_archive_reader_tar_next_entry
+(
+    struct ArchiveReader* archive_reader,
+    struct ArchiveEntryInfo* entry_info
+)
+{
+    const BOOL from_inflate_stream = archive_reader->format == ARCHIVE_FORMAT_TAR_GZIP;
+
+    if (archive_reader->tar_reached_end)
+    {
+        return ARCHIVE_READER_RESULT_END;
+    }
+
+    /* Skipping the unread data and the padding of the previous entry. */
+    if (!uhashtools_archive_reader_tar_skip(archive_reader,
+                                            archive_reader->entry_remaining + archive_reader->tar_entry_padding))
+    {
+        return ARCHIVE_READER_RESULT_FAILED;
+    }
+
+    archive_reader->entry_remaining = 0;
+    archive_reader->tar_entry_padding = 0;
+
+    for (;;)
+    {
+        unsigned char header[TAR_BLOCK_SIZE];
+        unsigned __int64 entry_size = 0;
+        unsigned char type_flag = 0;
+        size_t read_size = 0;
+        size_t i = 0;
+        BOOL is_zero_block = TRUE;
+
+        if (!uhashtools_archive_reader_read_exact(archive_reader, from_inflate_stream, header, TAR_BLOCK_SIZE, &read_size))
+        {
+            return ARCHIVE_READER_RESULT_FAILED;
+        }
+
+        if (read_size == 0)
+        {
+            /* Some tools don't write the end of archive blocks. */
+            archive_reader->tar_reached_end = TRUE;
+
+            return ARCHIVE_READER_RESULT_END;
+        }
+
+        if (read_size != TAR_BLOCK_SIZE)
+        {
+            (void) uhashtools_archive_reader_fail(archive_reader, L"The archive is truncated!");
+
+            return ARCHIVE_READER_RESULT_FAILED;
+        }
+
+        for (i = 0; i < TAR_BLOCK_SIZE && is_zero_block; ++i)
+        {
+            is_zero_block = header[i] == 0;
+        }
+
+        if (is_zero_block)
+        {
+            archive_reader->tar_reached_end = TRUE;
+
+            return ARCHIVE_READER_RESULT_END;
+        }
+
+        if (!uhashtools_archive_reader_tar_is_header_valid(header) ||
+            !uhashtools_archive_reader_tar_parse_number(header + 124, 12, &entry_size))
+        {
+            (void) uhashtools_archive_reader_fail(archive_reader, L"The tar archive is corrupt (invalid header)!");
+
+            return ARCHIVE_READER_RESULT_FAILED;
+        }
+
+        type_flag = header[156];
+
+        if (type_flag == 'L')
+        {
+            /* GNU long name for the next entry */
+            if (!uhashtools_archive_reader_tar_read_meta_entry(archive_reader, entry_size))
+            {
+                return ARCHIVE_READER_RESULT_FAILED;
+            }
+
+            archive_reader->tar_has_pending_name = uhashtools_archive_reader_convert_name((const char*) archive_reader->scratch_buf,
+                                                                                          strlen((const char*) archive_reader->scratch_buf),
+                                                                                          CP_UTF8,
+                                                                                          archive_reader->tar_pending_name,
+                                                                                          FILEPATH_BUFFER_TSIZE);
+
+            if (!archive_reader->tar_has_pending_name)
+            {
+                (void) uhashtools_archive_reader_fail(archive_reader, L"The archive contains an entry with an invalid or too long name!");
+
+                return ARCHIVE_READER_RESULT_FAILED;
+            }
+
+            continue;
+        }
+
+        if (type_flag == 'x')
+        {
+            /* pax extended header for the next entry */
+            if (!uhashtools_archive_reader_tar_read_meta_entry(archive_reader, entry_size) ||
+                !uhashtools_archive_reader_tar_apply_pax_header(archive_reader, (size_t) entry_size))
+            {
+                return ARCHIVE_READER_RESULT_FAILED;
+            }
+
+            continue;
+        }
+
+        if (archive_reader->tar_has_pending_size)
+        {
+            entry_size = archive_reader->tar_pending_size;
+        }
+
+        if (type_flag != '0' && type_flag != '\0' && type_flag != '7')
+        {
+            /* Directories, links, devices, global pax headers and other special entries */
+            archive_reader->tar_has_pending_name = FALSE;
+            archive_reader->tar_has_pending_size = FALSE;
+
+            if (type_flag == '1' || type_flag == '2' || type_flag == '3' || type_flag == '4' ||
+                type_flag == '5' || type_flag == '6')
+            {
+                /* Those entries have no data even if the size field is set. */
+                entry_size = 0;
+            }
+
+            if (!uhashtools_archive_reader_tar_skip(archive_reader, entry_size + uhashtools_archive_reader_tar_padding(entry_size)))
+            {
+                return ARCHIVE_READER_RESULT_FAILED;
+            }
+
+            continue;
+        }
+
+        if (archive_reader->tar_has_pending_name)
+        {
+            (void) wcscpy_s(entry_info->entry_name, FILEPATH_BUFFER_TSIZE, archive_reader->tar_pending_name);
+        }
+        else if (!uhashtools_archive_reader_tar_get_header_name(archive_reader, header, entry_info->entry_name, FILEPATH_BUFFER_TSIZE))
+        {
+            (void) uhashtools_archive_reader_fail(archive_reader, L"The archive contains an entry with an invalid or too long name!");
+
+            return ARCHIVE_READER_RESULT_FAILED;
+        }
+
+        archive_reader->tar_has_pending_name = FALSE;
+        archive_reader->tar_has_pending_size = FALSE;
+
+        archive_reader->entry_remaining = entry_size;
+        archive_reader->entry_size = entry_size;
+        archive_reader->tar_entry_padding = uhashtools_archive_reader_tar_padding(entry_size);
+
+        entry_info->size = entry_size;
+
+        return ARCHIVE_READER_RESULT_OK;
+    }
+}
+
+static
+BOOL
+uhashtools_archive_reader_gzip_skip_header
+(
+    struct ArchiveReader* archive_reader
+)
+{
+    unsigned char header[10];
+    unsigned char field_buf[2];
+    size_t read_size = 0;
+    unsigned int flags = 0;
+
+    if (!uhashtools_archive_reader_read_exact(archive_reader, FALSE, header, sizeof header, &read_size))
+    {
+        return FALSE;
+    }
+
+    if (read_size != sizeof header || header[0] != 0x1Fu || header[1] != 0x8Bu || header[2] != 8)
+    {
+        return uhashtools_archive_reader_fail(archive_reader, L"The gzip stream is corrupt (invalid header)!");
+    }
+
+    flags = header[3];
+
+    if (flags & GZIP_FLAG_FEXTRA)
+    {
+        if (!uhashtools_archive_reader_read_exact(archive_reader, FALSE, field_buf, 2, &read_size) ||
+            read_size != 2 ||
+            !uhashtools_archive_reader_read_exact(archive_reader,
+                                                  FALSE,
+                                                  archive_reader->scratch_buf,
+                                                  uhashtools_archive_reader_le16(field_buf),
+                                                  &read_size))
+        {
+            return uhashtools_archive_reader_fail(archive_reader, L"The gzip stream is corrupt (invalid header)!");
+        }
+    }
+
+    if (flags & GZIP_FLAG_FNAME)
+    {
+        do
+        {
+            if (!uhashtools_archive_reader_read_exact(archive_reader, FALSE, field_buf, 1, &read_size) || read_size != 1)
+            {
+                return uhashtools_archive_reader_fail(archive_reader, L"The gzip stream is corrupt (invalid header)!");
+            }
+        } while (field_buf[0] != 0);
+    }
+
+    if (flags & GZIP_FLAG_FCOMMENT)
+    {
+        do
+        {
+            if (!uhashtools_archive_reader_read_exact(archive_reader, FALSE, field_buf, 1, &read_size) || read_size != 1)
+            {
+                return uhashtools_archive_reader_fail(archive_reader, L"The gzip stream is corrupt (invalid header)!");
+            }
+        } while (field_buf[0] != 0);
+    }
+
+    if (flags & GZIP_FLAG_FHCRC)
+    {
+        if (!uhashtools_archive_reader_read_exact(archive_reader, FALSE, field_buf, 2, &read_size) || read_size != 2)
+        {
+            return uhashtools_archive_reader_fail(archive_reader, L"The gzip stream is corrupt (invalid header)!");
+        }
+    }
+
+    uhashtools_inflate_init(&archive_reader->inflate_stream,
+                            &uhashtools_archive_reader_inflate_input_function,
+                            (void*) archive_reader);
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_archive_reader_detect_format
+(
+    struct ArchiveReader* archive_reader
+)
+{
+    unsigned char* header = archive_reader->scratch_buf;
+    size_t read_size = 0;
+
+    if (!uhashtools_archive_reader_read_exact(archive_reader, FALSE, header, TAR_BLOCK_SIZE, &read_size) ||
+        !uhashtools_archive_reader_seek(archive_reader, 0))
+    {
+        return FALSE;
+    }
+
+    if (read_size >= 4 && (uhashtools_archive_reader_le32(header) == ZIP_LOCAL_HEADER_SIGNATURE ||
+                           uhashtools_archive_reader_le32(header) == ZIP_EOCD_SIGNATURE))
+    {
+        archive_reader->format = ARCHIVE_FORMAT_ZIP;
+
+        return uhashtools_archive_reader_zip_find_central_directory(archive_reader);
+    }
+
+    if (read_size >= 2 && header[0] == 0x1Fu && header[1] == 0x8Bu)
+    {
+        archive_reader->format = ARCHIVE_FORMAT_TAR_GZIP;
+
+        return uhashtools_archive_reader_gzip_skip_header(archive_reader);
+    }
+
+    if (read_size == TAR_BLOCK_SIZE && uhashtools_archive_reader_tar_is_header_valid(header))
+    {
+        archive_reader->format = ARCHIVE_FORMAT_TAR;
+
+        return TRUE;
+    }
+
+    return uhashtools_archive_reader_fail(archive_reader,
+                                          L"Unsupported archive format! Supported formats are ZIP, tar and tar.gz.");
+}
+
+/* API functions */
+
+struct ArchiveReader*
+uhashtools_archive_reader_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* archive_file
+)
+{
+    struct ArchiveReader* ret = NULL;
+    struct ArchiveReader* archive_reader = NULL;
+    errno_t archive_file_open_error = 0;
+    __int64 filelengthi64_rc = 0;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(archive_file, L"Internal error: archive_file is NULL!");
+
+    archive_reader = (struct ArchiveReader*) calloc(1, sizeof *archive_reader);
+
+    if (!archive_reader)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+
+        goto cleanup_and_out;
+    }
+
+    uhashtools_archive_reader_init_crc32_table(archive_reader->crc32_table);
+
+    archive_file_open_error = _wfopen_s(&archive_reader->archive_file_handle, archive_file, L"rb");
+
+    if (archive_file_open_error || !archive_reader->archive_file_handle)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to open the selected archive!");
+
+        goto cleanup_and_out;
+    }
+
+    filelengthi64_rc = _filelengthi64(_fileno(archive_reader->archive_file_handle));
+
+    if (filelengthi64_rc == -1)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to get the size of the selected archive!");
+
+        goto cleanup_and_out;
+    }
+
+    archive_reader->archive_file_size = (unsigned __int64) filelengthi64_rc;
+
+    if (!uhashtools_archive_reader_detect_format(archive_reader))
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, archive_reader->error_message);
+
+        goto cleanup_and_out;
+    }
+
+    ret = archive_reader; archive_reader = NULL;
+
+cleanup_and_out:
+    uhashtools_archive_reader_close(archive_reader);
+
+    return ret;
+}
+
+enum ArchiveReaderResult
+uhashtools_archive_reader_next_entry
+(
+    struct ArchiveReader* archive_reader,
+    struct ArchiveEntryInfo* entry_info
+)
+{
+    enum ArchiveReaderResult ret = ARCHIVE_READER_RESULT_FAILED;
+
+    UHASHTOOLS_ASSERT(archive_reader, L"Internal error: Entered with archive_reader == NULL!");
+    UHASHTOOLS_ASSERT(entry_info, L"Internal error: Entered with entry_info == NULL!");
+
+    (void) memset((void*) entry_info, 0, sizeof *entry_info);
+
+    archive_reader->entry_reached_eof = FALSE;
+    archive_reader->entry_read_total = 0;
+
+    if (archive_reader->format == ARCHIVE_FORMAT_ZIP)
+    {
+        archive_reader->input_is_limited = FALSE;
+        ret = uhashtools_archive_reader_zip_next_entry(archive_reader, entry_info);
+    }
+    else
+    {
+        ret = uhashtools_archive_reader_tar_next_entry(archive_reader, entry_info);
+    }
+
+    if (ret == ARCHIVE_READER_RESULT_OK)
+    {
+        UHASHTOOLS_PRINTF_LINE_DEBUG(L"Next archive entry: \"%s\" (\"%I64u\" bytes).",
+                                     entry_info->entry_name,
+                                     entry_info->size);
+    }
+
+    return ret;
+}
+
+BOOL
+uhashtools_archive_reader_read_entry_data
+(
+    struct ArchiveReader* archive_reader,
+    unsigned char* buf,
+    size_t buf_size,
+    size_t* read_size,
+    BOOL* reached_eof
+)
+{
+    UHASHTOOLS_ASSERT(archive_reader, L"Internal error: Entered with archive_reader == NULL!");
+    UHASHTOOLS_ASSERT(buf && read_size && reached_eof, L"Internal error: Entered with a NULL argument!");
+
+    *read_size = 0;
+    *reached_eof = FALSE;
+
+    if (archive_reader->entry_reached_eof || archive_reader->entry_remaining == 0)
+    {
+        *reached_eof = TRUE;
+    }
+    else
+    {
+        if ((unsigned __int64) buf_size > archive_reader->entry_remaining && !archive_reader->entry_is_deflated)
+        {
+            buf_size = (size_t) archive_reader->entry_remaining;
+        }
+
+        if (archive_reader->format == ARCHIVE_FORMAT_ZIP)
+        {
+            if (!uhashtools_archive_reader_zip_read_entry_data(archive_reader, buf, buf_size, read_size))
+            {
+                return FALSE;
+            }
+        }
+        else
+        {
+            if ((unsigned __int64) buf_size > archive_reader->entry_remaining)
+            {
+                buf_size = (size_t) archive_reader->entry_remaining;
+            }
+
+            if (!uhashtools_archive_reader_read_exact(archive_reader,
+                                                      archive_reader->format == ARCHIVE_FORMAT_TAR_GZIP,
+                                                      buf,
+                                                      buf_size,
+                                                      read_size))
+            {
+                return FALSE;
+            }
+
+            if (*read_size != buf_size)
+            {
+                return uhashtools_archive_reader_fail(archive_reader, L"The archive is truncated!");
+            }
+        }
+
+        archive_reader->entry_remaining -= *read_size;
+        archive_reader->entry_read_total += *read_size;
+        *reached_eof = archive_reader->entry_remaining == 0;
+    }
+
+    if (*reached_eof && !archive_reader->entry_reached_eof)
+    {
+        archive_reader->entry_reached_eof = TRUE;
+
+        if (archive_reader->format == ARCHIVE_FORMAT_ZIP &&
+            archive_reader->zip_entry_crc32 != archive_reader->zip_entry_expected_crc32)
+        {
+            return uhashtools_archive_reader_fail(archive_reader, L"The CRC-32 of an archive entry doesn't match. The archive is corrupt!");
+        }
+    }
+
+    return TRUE;
+}
+
+const wchar_t*
+uhashtools_archive_reader_get_error_message
+(
+    const struct ArchiveReader* archive_reader
+)
+{
+    UHASHTOOLS_ASSERT(archive_reader, L"Internal error: Entered with archive_reader == NULL!");
+
+    return archive_reader->error_message;
+}
+
+void
+uhashtools_archive_reader_close
+(
+    struct ArchiveReader* archive_reader
+)
+{
+    if (!archive_reader)
+    {
+        return;
+    }
+
+    if (archive_reader->archive_file_handle)
+    {
+        (void) fclose(archive_reader->archive_file_handle);
+    }
+
+    free((void*) archive_reader);
+}
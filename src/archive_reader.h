@@ -0,0 +1,132 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "buffer_sizes.h"
+
+#include <Windows.h>
+
+/*
+ * Sequential reader for the file entries of an archive. Supported
+ * formats are ZIP (stored and deflated entries, including ZIP64),
+ * tar (ustar, GNU long names and pax headers) and gzip compressed
+ * tar. The entries are decompressed on the fly, so no entry is ever
+ * written to the disk. Directories, links and other special entries
+ * are skipped.
+ */
+
+struct ArchiveReader;
+
+enum ArchiveReaderResult
+{
+    ARCHIVE_READER_RESULT_OK,
+    ARCHIVE_READER_RESULT_END,
+    ARCHIVE_READER_RESULT_FAILED
+};
+
+struct ArchiveEntryInfo
+{
+    /**
+     * Path of the entry within the archive.
+     */
+    wchar_t entry_name[FILEPATH_BUFFER_TSIZE];
+
+    /**
+     * Uncompressed size of the entry. All supported formats store
+     * the size of an entry within its header.
+     */
+    unsigned __int64 size;
+};
+
+/**
+ * Opens an archive and detects its format.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if the
+ *                          archive can't be opened.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param archive_file Filepath of the archive.
+ * 
+ * @return The opened archive reader or NULL on error.
+ */
+extern
+struct ArchiveReader*
+uhashtools_archive_reader_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* archive_file
+);
+
+/**
+ * Moves to the next file entry of the archive. Data of the current
+ * entry which hasn't been read yet will be skipped.
+ * 
+ * @param archive_reader Opened archive reader.
+ * @param entry_info Receives the information about the next entry.
+ * 
+ * @return ARCHIVE_READER_RESULT_OK if "entry_info" contains the next entry,
+ *         ARCHIVE_READER_RESULT_END if there are no more entries or
+ *         ARCHIVE_READER_RESULT_FAILED on error. In the last case the error
+ *         message can be retrieved with "uhashtools_archive_reader_get_error_message()".
+ */
+extern
+enum ArchiveReaderResult
+uhashtools_archive_reader_next_entry
+(
+    struct ArchiveReader* archive_reader,
+    struct ArchiveEntryInfo* entry_info
+);
+
+/**
+ * Reads the next block of uncompressed data of the current entry.
+ * For ZIP archives the CRC-32 of the entry is verified as soon the
+ * end of the entry has been reached.
+ * 
+ * @param archive_reader Opened archive reader.
+ * @param buf Buffer which receives the data.
+ * @param buf_size Size of "buf" in bytes.
+ * @param read_size Receives the amount of bytes written into "buf".
+ * @param reached_eof Is set to TRUE if the end of the entry has been reached.
+ * 
+ * @return TRUE on success and FALSE on error.
+ */
+extern
+BOOL
+uhashtools_archive_reader_read_entry_data
+(
+    struct ArchiveReader* archive_reader,
+    unsigned char* buf,
+    size_t buf_size,
+    size_t* read_size,
+    BOOL* reached_eof
+);
+
+/**
+ * @param archive_reader Opened archive reader.
+ * 
+ * @return Message which describes the last error for the user.
+ */
+extern
+const wchar_t*
+uhashtools_archive_reader_get_error_message
+(
+    const struct ArchiveReader* archive_reader
+);
+
+/**
+ * Closes the archive and frees the reader.
+ * 
+ * @param archive_reader Opened archive reader or NULL.
+ */
+extern
+void
+uhashtools_archive_reader_close
+(
+    struct ArchiveReader* archive_reader
+);
@@ -0,0 +1,395 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "batch_worker.h"
+
+#include "buffer_sizes.h"
+#include "directory_walker.h"
+#include "error_utilities.h"
+#include "hash_calculation_impl.h"
+
+#include <process.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define BATCH_WORKER_THREAD_STACK_SIZE (1024 * 512)
+
+struct BatchWorkerResult
+{
+    struct BatchWorkerResult* next;
+    wchar_t* filepath;
+    unsigned __int64 file_size;
+    BOOL is_hashed;
+    struct HashDigest digest;
+
+    /* NULL if the file has been hashed. */
+    wchar_t* error_message;
+};
+
+struct BatchWorker
+{
+    HANDLE thread_handle;
+    HANDLE cancel_event;
+
+    wchar_t** paths;
+    size_t paths_count;
+
+    unsigned char* file_read_buf;
+    wchar_t error_message_buf[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+
+    /* Shared with the owner, protected by "results_lock". */
+    CRITICAL_SECTION results_lock;
+    struct BatchWorkerResult* results_head;
+    struct BatchWorkerResult* results_tail;
+    BOOL is_finished;
+};
+
+static
+void
+uhashtools_batch_worker_free_results
+(
+    struct BatchWorkerResult* result
+)
+{
+    while (result)
+    {
+        struct BatchWorkerResult* next = result->next;
+
+        free((void*) result->filepath);
+        free((void*) result->error_message);
+        free((void*) result);
+
+        result = next;
+    }
+}
+
+static
+BOOL
+uhashtools_batch_worker_is_cancel_requested
+(
+    void* userdata
+)
+{
+    const struct BatchWorker* batch_worker = (const struct BatchWorker*) userdata;
+
+    return WaitForSingleObject(batch_worker->cancel_event, 0) == WAIT_OBJECT_0;
+}
+
+/*
+ * Queues the result of a file. A result which can't be allocated is
+ * dropped, the batch continues with the remaining files.
+ */
+static
+void
+uhashtools_batch_worker_queue_result
+(
+    struct BatchWorker* batch_worker,
+    const wchar_t* filepath,
+    unsigned __int64 file_size,
+    const struct HashDigest* digest,
+    const wchar_t* error_message
+)
+{
+    struct BatchWorkerResult* result = NULL;
+
+    result = (struct BatchWorkerResult*) calloc(1, sizeof *result);
+
+    if (!result)
+    {
+        return;
+    }
+
+    result->filepath = _wcsdup(filepath);
+    result->file_size = file_size;
+
+    if (digest)
+    {
+        result->is_hashed = TRUE;
+        result->digest = *digest;
+    }
+    else
+    {
+        result->error_message = _wcsdup(error_message);
+    }
+
+    if (!result->filepath || (!digest && !result->error_message))
+    {
+        uhashtools_batch_worker_free_results(result);
+        return;
+    }
+
+    EnterCriticalSection(&batch_worker->results_lock);
+
+    if (batch_worker->results_tail)
+    {
+        batch_worker->results_tail->next = result;
+    }
+    else
+    {
+        batch_worker->results_head = result;
+    }
+
+    batch_worker->results_tail = result;
+
+    LeaveCriticalSection(&batch_worker->results_lock);
+}
+
+/* Also used as the file callback of the directory walker. */
+static
+BOOL
+uhashtools_batch_worker_hash_file
+(
+    const wchar_t* filepath,
+    unsigned __int64 file_size,
+    void* userdata
+)
+{
+    struct BatchWorker* batch_worker = (struct BatchWorker*) userdata;
+    struct HashDigest digest;
+    enum HashCalculatorResultCode hash_rc = HashCalculatorResultCode_FAILED;
+
+    hash_rc = uhashtools_hash_calculator_impl_hash_file_to_digest(batch_worker->file_read_buf,
+                                                                  FILE_READ_BUF_TSIZE,
+                                                                  &digest,
+                                                                  batch_worker->error_message_buf,
+                                                                  GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                                  filepath,
+                                                                  &uhashtools_batch_worker_is_cancel_requested,
+                                                                  batch_worker,
+                                                                  NULL,
+                                                                  NULL);
+
+    if (hash_rc == HashCalculatorResultCode_CANCELED)
+    {
+        return FALSE;
+    }
+
+    uhashtools_batch_worker_queue_result(batch_worker,
+                                         filepath,
+                                         file_size,
+                                         hash_rc == HashCalculatorResultCode_SUCCESS ? &digest : NULL,
+                                         batch_worker->error_message_buf);
+
+    return !uhashtools_batch_worker_is_cancel_requested(batch_worker);
+}
+
+static
+BOOL
+uhashtools_batch_worker_hash_path
+(
+    struct BatchWorker* batch_worker,
+    const wchar_t* path
+)
+{
+    WIN32_FILE_ATTRIBUTE_DATA attribute_data;
+    unsigned __int64 file_size = 0;
+    BOOL had_errors = FALSE;
+
+    if (GetFileAttributesExW(path, GetFileExInfoStandard, &attribute_data))
+    {
+        if (attribute_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        {
+            /* The skipped paths are only reported on the console. */
+            return uhashtools_directory_walker_walk(path,
+                                                    &uhashtools_batch_worker_hash_file,
+                                                    batch_worker,
+                                                    &had_errors);
+        }
+
+        file_size = ((unsigned __int64) attribute_data.nFileSizeHigh << 32) | attribute_data.nFileSizeLow;
+    }
+
+    /* If the attributes can't be read hashing reports why. */
+    return uhashtools_batch_worker_hash_file(path, file_size, batch_worker);
+}
+
+static
+unsigned int
+__stdcall
+uhashtools_batch_worker_thread_function
+(
+    void* thread_param
+)
+{
+    struct BatchWorker* batch_worker = (struct BatchWorker*) thread_param;
+    size_t path_index = 0;
+
+    UHASHTOOLS_ASSERT(batch_worker, L"Internal error: Entered with thread_param == NULL!");
+
+    for (path_index = 0; path_index < batch_worker->paths_count; ++path_index)
+    {
+        if (!uhashtools_batch_worker_hash_path(batch_worker, batch_worker->paths[path_index]))
+        {
+            break;
+        }
+    }
+
+    EnterCriticalSection(&batch_worker->results_lock);
+    batch_worker->is_finished = TRUE;
+    LeaveCriticalSection(&batch_worker->results_lock);
+
+    return 0;
+}
+
+static
+void
+uhashtools_batch_worker_free
+(
+    struct BatchWorker* batch_worker
+)
+{
+    size_t path_index = 0;
+
+    uhashtools_batch_worker_free_results(batch_worker->results_head);
+
+    if (batch_worker->paths)
+    {
+        for (path_index = 0; path_index < batch_worker->paths_count; ++path_index)
+        {
+            free((void*) batch_worker->paths[path_index]);
+        }
+    }
+
+    if (batch_worker->cancel_event)
+    {
+        (void) CloseHandle(batch_worker->cancel_event);
+    }
+
+    DeleteCriticalSection(&batch_worker->results_lock);
+    free((void*) batch_worker->paths);
+    free((void*) batch_worker->file_read_buf);
+    free((void*) batch_worker);
+}
+
+struct BatchWorker*
+uhashtools_batch_worker_start
+(
+    const wchar_t* const* paths,
+    size_t paths_count
+)
+{
+    struct BatchWorker* batch_worker = NULL;
+    size_t path_index = 0;
+    uintptr_t thread_handle = 0;
+
+    UHASHTOOLS_ASSERT(paths || paths_count == 0, L"Internal error: paths is NULL!");
+
+    batch_worker = (struct BatchWorker*) calloc(1, sizeof *batch_worker);
+
+    if (!batch_worker)
+    {
+        return NULL;
+    }
+
+    InitializeCriticalSection(&batch_worker->results_lock);
+
+    batch_worker->paths = (wchar_t**) calloc(paths_count + 1, sizeof *batch_worker->paths);
+    batch_worker->file_read_buf = (unsigned char*) malloc(FILE_READ_BUF_TSIZE);
+    batch_worker->cancel_event = CreateEventW(NULL, TRUE, FALSE, NULL);
+
+    if (!batch_worker->paths || !batch_worker->file_read_buf || !batch_worker->cancel_event)
+    {
+        goto error_out;
+    }
+
+    for (path_index = 0; path_index < paths_count; ++path_index)
+    {
+        batch_worker->paths[path_index] = _wcsdup(paths[path_index]);
+
+        if (!batch_worker->paths[path_index])
+        {
+            goto error_out;
+        }
+
+        batch_worker->paths_count = path_index + 1;
+    }
+
+    thread_handle = _beginthreadex(NULL,
+                                   BATCH_WORKER_THREAD_STACK_SIZE,
+                                   uhashtools_batch_worker_thread_function,
+                                   batch_worker,
+                                   0,
+                                   NULL);
+
+    if (thread_handle == 0)
+    {
+        goto error_out;
+    }
+
+    batch_worker->thread_handle = (HANDLE) thread_handle;
+
+    return batch_worker;
+
+error_out:
+    uhashtools_batch_worker_free(batch_worker);
+
+    return NULL;
+}
+
+BOOL
+uhashtools_batch_worker_take_results
+(
+    struct BatchWorker* batch_worker,
+    struct ResultStore* result_store,
+    BOOL* is_finished
+)
+{
+    struct BatchWorkerResult* results = NULL;
+    struct BatchWorkerResult* result = NULL;
+    BOOL ret = TRUE;
+
+    UHASHTOOLS_ASSERT(batch_worker, L"Internal error: batch_worker is NULL!");
+    UHASHTOOLS_ASSERT(result_store, L"Internal error: result_store is NULL!");
+    UHASHTOOLS_ASSERT(is_finished, L"Internal error: is_finished is NULL!");
+
+    EnterCriticalSection(&batch_worker->results_lock);
+
+    results = batch_worker->results_head;
+    batch_worker->results_head = NULL;
+    batch_worker->results_tail = NULL;
+    *is_finished = batch_worker->is_finished;
+
+    LeaveCriticalSection(&batch_worker->results_lock);
+
+    for (result = results; result && ret; result = result->next)
+    {
+        ret = uhashtools_result_store_append(result_store,
+                                             result->filepath,
+                                             result->file_size,
+                                             result->is_hashed ? &result->digest : NULL,
+                                             result->error_message);
+    }
+
+    uhashtools_batch_worker_free_results(results);
+
+    return ret;
+}
+
+void
+uhashtools_batch_worker_destroy
+(
+    struct BatchWorker* batch_worker
+)
+{
+    DWORD wait_rc = 0;
+
+    if (!batch_worker)
+    {
+        return;
+    }
+
+    (void) SetEvent(batch_worker->cancel_event);
+
+    wait_rc = WaitForSingleObject(batch_worker->thread_handle, INFINITE);
+    UHASHTOOLS_ASSERT(wait_rc == WAIT_OBJECT_0, L"Internal error: Failed to wait for the batch worker thread!");
+
+    (void) CloseHandle(batch_worker->thread_handle);
+
+    uhashtools_batch_worker_free(batch_worker);
+}
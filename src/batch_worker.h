@@ -0,0 +1,74 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "result_store.h"
+
+#include <Windows.h>
+
+/*
+ * The batch worker hashes a batch of files and directories on its own
+ * thread, directories are walked recursively (see "directory_walker.h").
+ * The files are hashed one after another. Their results are queued until
+ * the owner takes them, so the owner decides when its result store is
+ * written and the worker never has to wait for the owner.
+ */
+
+struct BatchWorker;
+
+/**
+ * Starts hashing a batch on a new thread.
+ * 
+ * @param paths Paths of the files and directories of the batch. They are
+ *              copied, so they only have to be valid during the call.
+ * @param paths_count Amount of the paths.
+ * 
+ * @return Started worker or NULL if the worker couldn't be started.
+ */
+extern
+struct BatchWorker*
+uhashtools_batch_worker_start
+(
+    const wchar_t* const* paths,
+    size_t paths_count
+);
+
+/**
+ * Appends all results which have been queued since the last call to the
+ * result store. The queue lock is only held to detach the queue, so the
+ * worker isn't blocked while the rows are appended.
+ * 
+ * @param batch_worker Started worker.
+ * @param result_store Store which receives the results.
+ * @param is_finished Set to TRUE if the worker has finished and all of its
+ *                    results have been taken.
+ * 
+ * @return TRUE on success and FALSE if appending to the store failed. The
+ *         results which couldn't be appended are dropped.
+ */
+extern
+BOOL
+uhashtools_batch_worker_take_results
+(
+    struct BatchWorker* batch_worker,
+    struct ResultStore* result_store,
+    BOOL* is_finished
+);
+
+/**
+ * Cancels the batch if it's still running, waits for the worker thread
+ * and frees the worker including the results which haven't been taken.
+ * Passing NULL is allowed.
+ */
+extern
+void
+uhashtools_batch_worker_destroy
+(
+    struct BatchWorker* batch_worker
+);
@@ -0,0 +1,340 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "block_list.h"
+
+#include "error_utilities.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BLOCK_LIST_HEADER_FORMAT "# uhashtools blocks 1 %u %I64u %I64u\n"
+
+/* Fits the header or a hex digest with its line feed and a carriage return of an edited file. */
+#define BLOCK_LIST_LINE_BUFFER_SIZE (HASH_DIGEST_MAX_SIZE * 2 + 64)
+
+static
+int
+uhashtools_block_list_hex_char_value
+(
+    char hex_char
+)
+{
+    if (hex_char >= '0' && hex_char <= '9')
+    {
+        return hex_char - '0';
+    }
+
+    if (hex_char >= 'a' && hex_char <= 'f')
+    {
+        return hex_char - 'a' + 10;
+    }
+
+    if (hex_char >= 'A' && hex_char <= 'F')
+    {
+        return hex_char - 'A' + 10;
+    }
+
+    return -1;
+}
+
+/* Decodes a line with a hex digest and nothing else. */
+static
+BOOL
+uhashtools_block_list_parse_digest_line
+(
+    const char* line,
+    unsigned int digest_size,
+    unsigned char* digest
+)
+{
+    unsigned int i = 0;
+
+    for (i = 0; i < digest_size; ++i)
+    {
+        const int upper_value = uhashtools_block_list_hex_char_value(line[i * 2]);
+        const int lower_value = upper_value < 0 ? -1 : uhashtools_block_list_hex_char_value(line[i * 2 + 1]);
+
+        if (lower_value < 0)
+        {
+            return FALSE;
+        }
+
+        digest[i] = (unsigned char) ((upper_value << 4) | lower_value);
+    }
+
+    line += digest_size * 2;
+
+    if (*line == '\r')
+    {
+        ++line;
+    }
+
+    return line[0] == '\n' && line[1] == '\0';
+}
+
+BOOL
+uhashtools_block_list_init
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    struct BlockList* block_list,
+    unsigned int digest_size,
+    unsigned __int64 block_size,
+    unsigned __int64 file_size
+)
+{
+    unsigned __int64 blocks_count = 0;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(block_list && !block_list->digests, L"Internal error: block_list is NULL or not empty!");
+    UHASHTOOLS_ASSERT(digest_size > 0 && digest_size <= HASH_DIGEST_MAX_SIZE,
+                      L"Internal error: Unsupported digest size!");
+    UHASHTOOLS_ASSERT(block_size > 0, L"Internal error: block_size is zero!");
+
+    blocks_count = file_size / block_size + (file_size % block_size != 0 ? 1 : 0);
+
+    if (blocks_count > ((size_t) -1) / digest_size)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to allocate the required memory. Please download more RAM!");
+
+        return FALSE;
+    }
+
+    if (blocks_count > 0)
+    {
+        block_list->digests = (unsigned char*) calloc((size_t) blocks_count, digest_size);
+
+        if (!block_list->digests)
+        {
+            (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to allocate the required memory. Please download more RAM!");
+
+            return FALSE;
+        }
+    }
+
+    block_list->digest_size = digest_size;
+    block_list->block_size = block_size;
+    block_list->file_size = file_size;
+    block_list->blocks_count = blocks_count;
+
+    return TRUE;
+}
+
+BOOL
+uhashtools_block_list_load
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* block_list_file,
+    unsigned int digest_size,
+    struct BlockList* block_list
+)
+{
+    BOOL ret = FALSE;
+    FILE* handle = NULL;
+    char line[BLOCK_LIST_LINE_BUFFER_SIZE];
+    unsigned int list_digest_size = 0;
+    unsigned __int64 block_size = 0;
+    unsigned __int64 file_size = 0;
+    unsigned __int64 block_index = 0;
+    char header_end = '\0';
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(block_list_file, L"Internal error: block_list_file is NULL!");
+
+    if (_wfopen_s(&handle, block_list_file, L"rb") != 0 || !handle)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to open the block list!");
+
+        return FALSE;
+    }
+
+    if (fgets(line, BLOCK_LIST_LINE_BUFFER_SIZE, handle))
+    {
+        const size_t line_len = strlen(line);
+
+        /* Like the digest lines the header may end with a carriage return of an edited file. */
+        if (line_len >= 2 && line[line_len - 2] == '\r' && line[line_len - 1] == '\n')
+        {
+            line[line_len - 2] = '\n';
+            line[line_len - 1] = '\0';
+        }
+    }
+    else
+    {
+        line[0] = '\0';
+    }
+
+    if (sscanf_s(line,
+                 "# uhashtools blocks 1 %u %I64u %I64u%c",
+                 &list_digest_size,
+                 &block_size,
+                 &file_size,
+                 &header_end,
+                 1) != 4 ||
+        header_end != '\n')
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The file isn't a block list of this application!");
+
+        goto cleanup_and_out;
+    }
+
+    if (list_digest_size != digest_size)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The block list has been written for another hash algorithm!");
+
+        goto cleanup_and_out;
+    }
+
+    if (block_size < BLOCK_LIST_MIN_BLOCK_SIZE || block_size > BLOCK_LIST_MAX_BLOCK_SIZE)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The block list is damaged!");
+
+        goto cleanup_and_out;
+    }
+
+    if (!uhashtools_block_list_init(error_message_buf,
+                                    error_message_buf_tsize,
+                                    block_list,
+                                    digest_size,
+                                    block_size,
+                                    file_size))
+    {
+        goto cleanup_and_out;
+    }
+
+    for (block_index = 0; block_index < block_list->blocks_count; ++block_index)
+    {
+        if (!fgets(line, BLOCK_LIST_LINE_BUFFER_SIZE, handle) ||
+            !uhashtools_block_list_parse_digest_line(line,
+                                                     digest_size,
+                                                     uhashtools_block_list_get_digest(block_list, block_index)))
+        {
+            (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The block list is damaged!");
+
+            goto cleanup_and_out;
+        }
+    }
+
+    /* Additional lines mean that the header doesn't belong to the digests. */
+    if (fgets(line, BLOCK_LIST_LINE_BUFFER_SIZE, handle) || ferror(handle))
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The block list is damaged!");
+
+        goto cleanup_and_out;
+    }
+
+    ret = TRUE;
+
+cleanup_and_out:
+    (void) fclose(handle);
+
+    if (!ret)
+    {
+        uhashtools_block_list_free(block_list);
+    }
+
+    return ret;
+}
+
+BOOL
+uhashtools_block_list_save
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* block_list_file,
+    const struct BlockList* block_list
+)
+{
+    static const char hex_chars[] = "0123456789abcdef";
+    BOOL had_errors = FALSE;
+    FILE* handle = NULL;
+    char line[BLOCK_LIST_LINE_BUFFER_SIZE];
+    unsigned __int64 block_index = 0;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(block_list_file, L"Internal error: block_list_file is NULL!");
+    UHASHTOOLS_ASSERT(block_list && block_list->digest_size > 0, L"Internal error: block_list is NULL or not initialized!");
+
+    /* Binary mode keeps the line feeds, so the block list is the same on every machine. */
+    if (_wfopen_s(&handle, block_list_file, L"wb") != 0 || !handle)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to create the block list!");
+
+        return FALSE;
+    }
+
+    if (fprintf(handle,
+                BLOCK_LIST_HEADER_FORMAT,
+                block_list->digest_size,
+                block_list->block_size,
+                block_list->file_size) < 0)
+    {
+        had_errors = TRUE;
+    }
+
+    for (block_index = 0; !had_errors && block_index < block_list->blocks_count; ++block_index)
+    {
+        const unsigned char* digest = uhashtools_block_list_get_digest(block_list, block_index);
+        const size_t line_size = block_list->digest_size * 2 + 1;
+        unsigned int i = 0;
+
+        for (i = 0; i < block_list->digest_size; ++i)
+        {
+            line[i * 2] = hex_chars[digest[i] >> 4];
+            line[i * 2 + 1] = hex_chars[digest[i] & 0x0F];
+        }
+
+        line[line_size - 1] = '\n';
+
+        if (fwrite((const void*) line, 1, line_size, handle) != line_size)
+        {
+            had_errors = TRUE;
+        }
+    }
+
+    if (fclose(handle) != 0)
+    {
+        had_errors = TRUE;
+    }
+
+    if (had_errors)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to write the block list!");
+    }
+
+    return !had_errors;
+}
+
+unsigned char*
+uhashtools_block_list_get_digest
+(
+    const struct BlockList* block_list,
+    unsigned __int64 block_index
+)
+{
+    UHASHTOOLS_ASSERT(block_list && block_index < block_list->blocks_count,
+                      L"Internal error: block_list is NULL or the block index is out of range!");
+
+    return block_list->digests + (size_t) block_index * block_list->digest_size;
+}
+
+void
+uhashtools_block_list_free
+(
+    struct BlockList* block_list
+)
+{
+    UHASHTOOLS_ASSERT(block_list, L"Internal error: block_list is NULL!");
+
+    free((void*) block_list->digests);
+
+    (void) memset((void*) block_list, 0, sizeof *block_list);
+}
@@ -0,0 +1,137 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "hash_calculation_impl.h"
+
+#include <Windows.h>
+
+/*
+ * A block list stores the digests of the fixed size blocks of a file, so
+ * a later verification can tell which parts of the file have changed
+ * instead of only that the file has changed.
+ * 
+ * The block list is a UTF-8 text file with one block per line:
+ * 
+ *   # uhashtools blocks 1 <digest size> <block size> <file size>
+ *   <hex digest of block 0>
+ *   <hex digest of block 1>
+ *   ...
+ * 
+ * Block "i" starts at offset "i * <block size>", only the last block may
+ * be shorter. An empty file has no blocks.
+ */
+
+/*
+ * Every block is hashed with a file source of its own, so blocks much
+ * smaller than the read buffer would mainly measure opening the file.
+ */
+#define BLOCK_LIST_MIN_BLOCK_SIZE (1024 * 64)
+#define BLOCK_LIST_MAX_BLOCK_SIZE (1024 * 1024 * 1024)
+
+/**
+ * Block digests of a file. The default initialisation is to do a memset
+ * zero, which is an empty list.
+ */
+struct BlockList
+{
+    unsigned int digest_size;
+    unsigned __int64 block_size;
+    unsigned __int64 file_size;
+    unsigned __int64 blocks_count;
+
+    /* "blocks_count" digests of "digest_size" bytes each, one after the other. */
+    unsigned char* digests;
+};
+
+/**
+ * Prepares an empty list with room for all blocks of a file. The digests
+ * are zero until they are set.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if
+ *                          the memory can't be allocated.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param block_list Zero initialized block list.
+ * @param digest_size Size of the digests of the product in bytes.
+ * @param block_size Size of a block in bytes.
+ * @param file_size Size of the file in bytes.
+ * 
+ * @return TRUE on success and FALSE on failure.
+ */
+extern
+BOOL
+uhashtools_block_list_init
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    struct BlockList* block_list,
+    unsigned int digest_size,
+    unsigned __int64 block_size,
+    unsigned __int64 file_size
+);
+
+/**
+ * Reads a block list and checks its header.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if
+ *                          the block list can't be read.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param block_list_file Path of the block list.
+ * @param digest_size Size of the digests of the product in bytes.
+ * @param block_list Zero initialized block list which receives the blocks.
+ * 
+ * @return TRUE on success and FALSE on failure.
+ */
+extern
+BOOL
+uhashtools_block_list_load
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* block_list_file,
+    unsigned int digest_size,
+    struct BlockList* block_list
+);
+
+/**
+ * Writes a block list. An existing file is replaced.
+ * 
+ * @return TRUE on success and FALSE on failure. On failure the user
+ *         error message is written into "error_message_buf".
+ */
+extern
+BOOL
+uhashtools_block_list_save
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* block_list_file,
+    const struct BlockList* block_list
+);
+
+/**
+ * @return Pointer to the "digest_size" bytes of the digest of a block.
+ */
+extern
+unsigned char*
+uhashtools_block_list_get_digest
+(
+    const struct BlockList* block_list,
+    unsigned __int64 block_index
+);
+
+/**
+ * Frees the digests and resets the list to the empty state.
+ */
+extern
+void
+uhashtools_block_list_free
+(
+    struct BlockList* block_list
+);
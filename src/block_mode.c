@@ -0,0 +1,436 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "block_mode.h"
+
+#include "block_list.h"
+#include "buffer_sizes.h"
+#include "error_utilities.h"
+#include "hash_calculation_impl.h"
+#include "product.h"
+#include "std_streams.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum BlockModeBlockState
+{
+    BlockModeBlockState_UNCHECKED,
+    BlockModeBlockState_MATCHING,
+    BlockModeBlockState_DIFFERING
+};
+
+struct BlockModeCtx
+{
+    const wchar_t* block_list_file;
+    const wchar_t* target_file;
+    unsigned int threads_count;
+    wchar_t error_message_buf[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+
+    struct BlockList block_list;
+
+    /* Only used by the verification. One "BlockModeBlockState" per hashed block. */
+    unsigned char* block_states;
+    unsigned __int64 max_mismatches;
+    unsigned __int64 mismatches_count;
+
+    /* Differing range which hasn't been written yet, since the next block may extend it. */
+    BOOL has_pending_range;
+    unsigned __int64 pending_range_start;
+    unsigned __int64 pending_range_end;
+    unsigned __int64 ranges_count;
+    unsigned __int64 differing_size;
+};
+
+static
+BOOL
+uhashtools_block_mode_get_file_size
+(
+    const wchar_t* target_file,
+    unsigned __int64* file_size
+)
+{
+    WIN32_FILE_ATTRIBUTE_DATA file_attributes;
+
+    if (!GetFileAttributesExW(target_file, GetFileExInfoStandard, &file_attributes) ||
+        (file_attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+    {
+        (void) fwprintf_s(stderr, L"%s: Failed to open the selected file!\n", target_file);
+
+        return FALSE;
+    }
+
+    *file_size = ((unsigned __int64) file_attributes.nFileSizeHigh << 32) | file_attributes.nFileSizeLow;
+
+    return TRUE;
+}
+
+/* Uses a worker per processor, but not more than allowed by "--max-threads". */
+static
+unsigned int
+uhashtools_block_mode_get_threads_count
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    SYSTEM_INFO system_info;
+    unsigned int threads_count = 0;
+
+    GetSystemInfo(&system_info);
+
+    threads_count = (unsigned int) system_info.dwNumberOfProcessors;
+
+    if (cli_arguments->throttle_max_threads > 0 && threads_count > cli_arguments->throttle_max_threads)
+    {
+        threads_count = cli_arguments->throttle_max_threads;
+    }
+
+    return threads_count > 0 ? threads_count : 1;
+}
+
+static
+BOOL
+uhashtools_block_mode_hash_blocks
+(
+    struct BlockModeCtx* ctx,
+    unsigned __int64 file_size,
+    unsigned __int64 blocks_count,
+    OnBlockDigestCallbackFunction* block_digest_callback
+)
+{
+    enum HashCalculatorResultCode hash_rc = HashCalculatorResultCode_FAILED;
+    unsigned int threads_count = ctx->threads_count;
+
+    if (blocks_count == 0)
+    {
+        return TRUE;
+    }
+
+    if ((unsigned __int64) threads_count > blocks_count)
+    {
+        threads_count = (unsigned int) blocks_count;
+    }
+
+    hash_rc = uhashtools_hash_calculator_impl_hash_file_blocks_to_digests(ctx->error_message_buf,
+                                                                          GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                                          ctx->target_file,
+                                                                          file_size,
+                                                                          ctx->block_list.block_size,
+                                                                          blocks_count,
+                                                                          threads_count,
+                                                                          block_digest_callback,
+                                                                          (void*) ctx);
+
+    if (hash_rc == HashCalculatorResultCode_FAILED)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", ctx->target_file, ctx->error_message_buf);
+
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_block_mode_store_digest
+(
+    unsigned __int64 block_index,
+    const struct HashDigest* digest,
+    void* userdata
+)
+{
+    struct BlockModeCtx* ctx = (struct BlockModeCtx*) userdata;
+
+    UHASHTOOLS_ASSERT(digest->size == ctx->block_list.digest_size, L"Internal error: Unexpected digest size!");
+
+    (void) memcpy((void*) uhashtools_block_list_get_digest(&ctx->block_list, block_index),
+                  (const void*) digest->bytes,
+                  digest->size);
+
+    return TRUE;
+}
+
+static
+int
+uhashtools_block_mode_write
+(
+    struct BlockModeCtx* ctx,
+    unsigned __int64 block_size
+)
+{
+    unsigned __int64 file_size = 0;
+
+    if (!uhashtools_block_mode_get_file_size(ctx->target_file, &file_size))
+    {
+        return 1;
+    }
+
+    if (!uhashtools_block_list_init(ctx->error_message_buf,
+                                    GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                    &ctx->block_list,
+                                    (unsigned int) uhashtools_product_get_builtin_hasher_digest_size(),
+                                    block_size,
+                                    file_size))
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", ctx->target_file, ctx->error_message_buf);
+
+        return 1;
+    }
+
+    if (!uhashtools_block_mode_hash_blocks(ctx, file_size, ctx->block_list.blocks_count, &uhashtools_block_mode_store_digest))
+    {
+        return 1;
+    }
+
+    if (!uhashtools_block_list_save(ctx->error_message_buf,
+                                    GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                    ctx->block_list_file,
+                                    &ctx->block_list))
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", ctx->block_list_file, ctx->error_message_buf);
+
+        return 1;
+    }
+
+    (void) wprintf_s(L"# %I64u blocks of %I64u bytes written for %I64u bytes\n",
+                     ctx->block_list.blocks_count,
+                     block_size,
+                     file_size);
+
+    (void) fflush(stdout);
+
+    return 0;
+}
+
+static
+BOOL
+uhashtools_block_mode_compare_digest
+(
+    unsigned __int64 block_index,
+    const struct HashDigest* digest,
+    void* userdata
+)
+{
+    struct BlockModeCtx* ctx = (struct BlockModeCtx*) userdata;
+    const BOOL is_matching = digest->size == ctx->block_list.digest_size &&
+                             memcmp((const void*) digest->bytes,
+                                    (const void*) uhashtools_block_list_get_digest(&ctx->block_list, block_index),
+                                    digest->size) == 0;
+
+    if (is_matching)
+    {
+        ctx->block_states[block_index] = BlockModeBlockState_MATCHING;
+
+        return TRUE;
+    }
+
+    ctx->block_states[block_index] = BlockModeBlockState_DIFFERING;
+    ++ctx->mismatches_count;
+
+    return ctx->max_mismatches == 0 || ctx->mismatches_count < ctx->max_mismatches;
+}
+
+static
+void
+uhashtools_block_mode_flush_range
+(
+    struct BlockModeCtx* ctx
+)
+{
+    if (!ctx->has_pending_range)
+    {
+        return;
+    }
+
+    (void) wprintf_s(L"MISMATCH %I64u %I64u\n",
+                     ctx->pending_range_start,
+                     ctx->pending_range_end - ctx->pending_range_start);
+
+    ++ctx->ranges_count;
+    ctx->differing_size += ctx->pending_range_end - ctx->pending_range_start;
+    ctx->has_pending_range = FALSE;
+}
+
+/*
+ * Collects the differing ranges in ascending order of their start, so
+ * adjacent or overlapping ranges are merged.
+ */
+static
+void
+uhashtools_block_mode_add_range
+(
+    struct BlockModeCtx* ctx,
+    unsigned __int64 range_start,
+    unsigned __int64 range_end
+)
+{
+    if (ctx->has_pending_range && ctx->pending_range_end >= range_start)
+    {
+        if (range_end > ctx->pending_range_end)
+        {
+            ctx->pending_range_end = range_end;
+        }
+
+        return;
+    }
+
+    uhashtools_block_mode_flush_range(ctx);
+
+    ctx->has_pending_range = TRUE;
+    ctx->pending_range_start = range_start;
+    ctx->pending_range_end = range_end;
+}
+
+static
+int
+uhashtools_block_mode_verify
+(
+    struct BlockModeCtx* ctx
+)
+{
+    unsigned __int64 file_size = 0;
+    unsigned __int64 blocks_count = 0;
+    unsigned __int64 unchecked_blocks_count = 0;
+    unsigned __int64 block_index = 0;
+    unsigned __int64 block_size = 0;
+
+    if (!uhashtools_block_mode_get_file_size(ctx->target_file, &file_size))
+    {
+        return 1;
+    }
+
+    if (!uhashtools_block_list_load(ctx->error_message_buf,
+                                    GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                    ctx->block_list_file,
+                                    (unsigned int) uhashtools_product_get_builtin_hasher_digest_size(),
+                                    &ctx->block_list))
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", ctx->block_list_file, ctx->error_message_buf);
+
+        return 1;
+    }
+
+    /* Only the blocks which exist in the file and in the block list can be compared. */
+    block_size = ctx->block_list.block_size;
+    blocks_count = file_size / block_size + (file_size % block_size != 0 ? 1 : 0);
+
+    if (blocks_count > ctx->block_list.blocks_count)
+    {
+        blocks_count = ctx->block_list.blocks_count;
+    }
+
+    ctx->block_states = (unsigned char*) calloc(blocks_count > 0 ? (size_t) blocks_count : 1, 1);
+
+    if (!ctx->block_states)
+    {
+        (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+        return 1;
+    }
+
+    if (!uhashtools_block_mode_hash_blocks(ctx, file_size, blocks_count, &uhashtools_block_mode_compare_digest))
+    {
+        return 1;
+    }
+
+    for (block_index = 0; block_index < blocks_count; ++block_index)
+    {
+        const unsigned __int64 block_start = block_index * block_size;
+
+        if (ctx->block_states[block_index] == BlockModeBlockState_DIFFERING)
+        {
+            uhashtools_block_mode_add_range(ctx,
+                                            block_start,
+                                            file_size - block_start < block_size ? file_size : block_start + block_size);
+        }
+        else if (ctx->block_states[block_index] == BlockModeBlockState_UNCHECKED)
+        {
+            ++unchecked_blocks_count;
+        }
+    }
+
+    if (file_size != ctx->block_list.file_size)
+    {
+        uhashtools_block_mode_add_range(ctx,
+                                        file_size < ctx->block_list.file_size ? file_size : ctx->block_list.file_size,
+                                        file_size < ctx->block_list.file_size ? ctx->block_list.file_size : file_size);
+    }
+
+    uhashtools_block_mode_flush_range(ctx);
+
+    (void) wprintf_s(L"# %I64u of %I64u blocks differ, %I64u bytes in %I64u ranges\n",
+                     ctx->mismatches_count,
+                     blocks_count - unchecked_blocks_count,
+                     ctx->differing_size,
+                     ctx->ranges_count);
+
+    if (file_size != ctx->block_list.file_size)
+    {
+        (void) wprintf_s(L"# The file has %I64u bytes instead of %I64u bytes\n", file_size, ctx->block_list.file_size);
+    }
+
+    if (unchecked_blocks_count > 0)
+    {
+        (void) wprintf_s(L"# Stopped after %I64u differing blocks, %I64u blocks haven't been checked\n",
+                         ctx->mismatches_count,
+                         unchecked_blocks_count);
+    }
+
+    (void) fflush(stdout);
+
+    return ctx->ranges_count > 0 ? 1 : 0;
+}
+
+int
+uhashtools_block_mode_run
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    int ret = 1;
+    struct BlockModeCtx* ctx = NULL;
+
+    UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
+    UHASHTOOLS_ASSERT(uhashtools_cli_arguments_has_block_list_file(cli_arguments),
+                      L"Internal error: Entered block mode without a block list!");
+
+    uhashtools_std_streams_connect();
+
+    ctx = (struct BlockModeCtx*) malloc(sizeof *ctx);
+
+    if (!ctx)
+    {
+        (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+        return 1;
+    }
+
+    (void) memset((void*) ctx, 0, sizeof *ctx);
+
+    ctx->block_list_file = cli_arguments->block_list_file;
+    ctx->target_file = cli_arguments->block_target_file;
+    ctx->threads_count = uhashtools_block_mode_get_threads_count(cli_arguments);
+    ctx->max_mismatches = cli_arguments->block_max_mismatches;
+
+    if (cli_arguments->is_block_verify)
+    {
+        ret = uhashtools_block_mode_verify(ctx);
+    }
+    else
+    {
+        ret = uhashtools_block_mode_write(ctx, cli_arguments->block_size);
+    }
+
+    uhashtools_block_list_free(&ctx->block_list);
+    free((void*) ctx->block_states);
+    free((void*) ctx);
+
+    return ret;
+}
@@ -0,0 +1,44 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "cli_arguments.h"
+
+/*
+ * The block mode has two variants, both without creating a window. The
+ * blocks are hashed in parallel by one worker thread per processor (or
+ * less with "--max-threads").
+ * 
+ * "--write-blocks <block list> <block size> <file>" hashes every block
+ * of the file and writes the block list (see "block_list.h").
+ * 
+ * "--verify-blocks <block list> <file> [<max mismatches>]" hashes the
+ * blocks of the file and compares them with the block list. Adjacent
+ * differing blocks are merged and each differing range is written to
+ * stdout as a line "MISMATCH <offset> <size>". If the size of the file
+ * has changed, the added or removed part is a differing range as well.
+ * With "<max mismatches>" the verification stops after that amount of
+ * differing blocks, the blocks which haven't been hashed yet are left
+ * unchecked.
+ */
+
+/**
+ * Runs the block mode variant selected by the command line arguments.
+ * 
+ * @param cli_arguments Command line arguments with a set block list.
+ * 
+ * @return Exit code of the process. Zero if the block list has been
+ *         written or if the file matches the block list else one.
+ */
+extern
+int
+uhashtools_block_mode_run
+(
+    const struct CliArguments* cli_arguments
+);
@@ -23,3 +23,4 @@
 #define FILEPATH_BUFFER_TSIZE 512
 #define HASH_RESULT_BUFFER_TSIZE 256
 #define GENERIC_TXT_MESSAGES_BUFFER_TSIZE 512
+#define LOG_LINE_BUFFER_TSIZE 1024
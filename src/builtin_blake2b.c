@@ -0,0 +1,199 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "builtin_blake2b.h"
+
+#include <string.h>
+#include <Windows.h>
+
+#define BLAKE2B_ROUNDS 12
+
+/* Parameter block word 0: digest length 64, no key, fanout 1, depth 1. */
+#define BLAKE2B_PARAMETER_WORD_0 0x01010040ULL
+
+#define BLAKE2B_ROTR64(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+#define BLAKE2B_G(a, b, c, d, x, y) \
+    do \
+    { \
+        a = a + b + (x); \
+        d = BLAKE2B_ROTR64(d ^ a, 32); \
+        c = c + d; \
+        b = BLAKE2B_ROTR64(b ^ c, 24); \
+        a = a + b + (y); \
+        d = BLAKE2B_ROTR64(d ^ a, 16); \
+        c = c + d; \
+        b = BLAKE2B_ROTR64(b ^ c, 63); \
+    } while (0)
+
+static const unsigned __int64 BLAKE2B_IV[8] =
+{
+    0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL, 0x3C6EF372FE94F82BULL, 0xA54FF53A5F1D36F1ULL,
+    0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL, 0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL
+};
+
+/* The rounds 10 and 11 are reusing the permutations of the rounds 0 and 1. */
+static const unsigned char BLAKE2B_SIGMA[10][16] =
+{
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+    { 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+    {  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+    {  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+    {  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+    { 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+    { 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+    {  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+    { 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 }
+};
+
+static
+void
+uhashtools_builtin_blake2b_compress
+(
+    unsigned __int64* h,
+    const unsigned char* block,
+    unsigned __int64 total_size,
+    BOOL is_last_block
+)
+{
+    unsigned __int64 m[16];
+    unsigned __int64 v[16];
+    int i = 0;
+
+    for (i = 0; i < 16; ++i)
+    {
+        /* Every target architecture of Windows is little endian. */
+        m[i] = *(const unsigned __int64 UNALIGNED*) (block + i * 8);
+    }
+
+    for (i = 0; i < 8; ++i)
+    {
+        v[i] = h[i];
+        v[i + 8] = BLAKE2B_IV[i];
+    }
+
+    /* The upper half of the 128 bit counter stays zero for every realistic input size. */
+    v[12] ^= total_size;
+
+    if (is_last_block)
+    {
+        v[14] = ~v[14];
+    }
+
+    for (i = 0; i < BLAKE2B_ROUNDS; ++i)
+    {
+        const unsigned char* s = BLAKE2B_SIGMA[i % 10];
+
+        BLAKE2B_G(v[0], v[4], v[8], v[12], m[s[0]], m[s[1]]);
+        BLAKE2B_G(v[1], v[5], v[9], v[13], m[s[2]], m[s[3]]);
+        BLAKE2B_G(v[2], v[6], v[10], v[14], m[s[4]], m[s[5]]);
+        BLAKE2B_G(v[3], v[7], v[11], v[15], m[s[6]], m[s[7]]);
+        BLAKE2B_G(v[0], v[5], v[10], v[15], m[s[8]], m[s[9]]);
+        BLAKE2B_G(v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+        BLAKE2B_G(v[2], v[7], v[8], v[13], m[s[12]], m[s[13]]);
+        BLAKE2B_G(v[3], v[4], v[9], v[14], m[s[14]], m[s[15]]);
+    }
+
+    for (i = 0; i < 8; ++i)
+    {
+        h[i] ^= v[i] ^ v[i + 8];
+    }
+}
+
+void
+uhashtools_builtin_blake2b_init
+(
+    struct BuiltinBlake2bState* state
+)
+{
+    (void) memcpy((void*) state->h, (const void*) BLAKE2B_IV, sizeof(state->h));
+    state->h[0] ^= BLAKE2B_PARAMETER_WORD_0;
+    state->total_size = 0;
+    state->block_fill = 0;
+}
+
+void
+uhashtools_builtin_blake2b_update
+(
+    struct BuiltinBlake2bState* state,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    /*
+     * The last block must be compressed with the finalization flag, so a
+     * block is only compressed if more data is following it.
+     */
+    if (state->block_fill + data_size <= BUILTIN_BLAKE2B_BLOCK_SIZE)
+    {
+        (void) memcpy((void*) (state->block + state->block_fill), (const void*) data, data_size);
+        state->block_fill += data_size;
+        return;
+    }
+
+    if (state->block_fill > 0)
+    {
+        const size_t copy_size = BUILTIN_BLAKE2B_BLOCK_SIZE - state->block_fill;
+
+        (void) memcpy((void*) (state->block + state->block_fill), (const void*) data, copy_size);
+        data += copy_size;
+        data_size -= copy_size;
+
+        state->total_size += BUILTIN_BLAKE2B_BLOCK_SIZE;
+        uhashtools_builtin_blake2b_compress(state->h, state->block, state->total_size, FALSE);
+        state->block_fill = 0;
+    }
+
+    /* Full blocks are hashed directly from the input without copying them. */
+    while (data_size > BUILTIN_BLAKE2B_BLOCK_SIZE)
+    {
+        state->total_size += BUILTIN_BLAKE2B_BLOCK_SIZE;
+        uhashtools_builtin_blake2b_compress(state->h, data, state->total_size, FALSE);
+        data += BUILTIN_BLAKE2B_BLOCK_SIZE;
+        data_size -= BUILTIN_BLAKE2B_BLOCK_SIZE;
+    }
+
+    (void) memcpy((void*) state->block, (const void*) data, data_size);
+    state->block_fill = data_size;
+}
+
+void
+uhashtools_builtin_blake2b_finish
+(
+    struct BuiltinBlake2bState* state,
+    unsigned char* digest
+)
+{
+    int i = 0;
+
+    (void) memset((void*) (state->block + state->block_fill), 0, BUILTIN_BLAKE2B_BLOCK_SIZE - state->block_fill);
+    state->total_size += state->block_fill;
+    uhashtools_builtin_blake2b_compress(state->h, state->block, state->total_size, TRUE);
+
+    for (i = 0; i < 8; ++i)
+    {
+        int j = 0;
+
+        for (j = 0; j < 8; ++j)
+        {
+            digest[i * 8 + j] = (unsigned char) (state->h[i] >> (j * 8));
+        }
+    }
+}
+
+BOOL
+uhashtools_builtin_blake2b_is_state_valid
+(
+    const struct BuiltinBlake2bState* state
+)
+{
+    /* The total size only counts the compressed blocks, the last block is always kept back. */
+    return state->block_fill <= BUILTIN_BLAKE2B_BLOCK_SIZE &&
+           state->total_size % BUILTIN_BLAKE2B_BLOCK_SIZE == 0;
+}
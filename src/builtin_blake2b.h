@@ -0,0 +1,86 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+/*
+ * Built-in implementation of the BLAKE2b hash algorithm (RFC 7693)
+ * with a digest size of 512 bit and without key. The Windows CNG API
+ * doesn't provide this algorithm, so it's always used.
+ */
+
+#define BUILTIN_BLAKE2B_DIGEST_SIZE 64
+#define BUILTIN_BLAKE2B_BLOCK_SIZE 128
+
+struct BuiltinBlake2bState
+{
+    unsigned __int64 h[8];
+    unsigned __int64 total_size;
+    unsigned char block[BUILTIN_BLAKE2B_BLOCK_SIZE];
+    size_t block_fill;
+};
+
+/**
+ * Initializes the hash state for a new calculation.
+ * 
+ * @param state Hash state which should be initialized.
+ */
+extern
+void
+uhashtools_builtin_blake2b_init
+(
+    struct BuiltinBlake2bState* state
+);
+
+/**
+ * Hashes the next part of the data.
+ * 
+ * @param state Initialized hash state.
+ * @param data Data which should be hashed.
+ * @param data_size Size of "data" in bytes.
+ */
+extern
+void
+uhashtools_builtin_blake2b_update
+(
+    struct BuiltinBlake2bState* state,
+    const unsigned char* data,
+    size_t data_size
+);
+
+/**
+ * Finishes the calculation and writes the digest.
+ * 
+ * @param state Hash state. It must be initialized again before reusing it.
+ * @param digest Buffer of BUILTIN_BLAKE2B_DIGEST_SIZE bytes which receives the digest.
+ */
+extern
+void
+uhashtools_builtin_blake2b_finish
+(
+    struct BuiltinBlake2bState* state,
+    unsigned char* digest
+);
+
+/**
+ * Checks the counters of a hash state which hasn't been created by this
+ * process (for example a state which has been read from a file), so a
+ * damaged state is rejected before it's used.
+ * 
+ * @param state Hash state which should be checked.
+ * 
+ * @return TRUE if the state can be used else FALSE.
+ */
+extern
+BOOL
+uhashtools_builtin_blake2b_is_state_valid
+(
+    const struct BuiltinBlake2bState* state
+);
@@ -0,0 +1,461 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "builtin_blake2sp.h"
+
+#include <string.h>
+#include <Windows.h>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+
+#define BLAKE2SP_HAS_SSE2_IMPL
+#endif
+
+#define BLAKE2S_ROUNDS 10
+#define BLAKE2S_DIGEST_SIZE 32
+
+/*
+ * Parameter block words of the tree: digest length 32, no key, fanout 8,
+ * depth 2, inner digest length 32. The leaves are using the node depth 0
+ * and their index as node offset, the root node is using the node depth 1.
+ */
+#define BLAKE2SP_PARAMETER_WORD_0 0x02080020u
+#define BLAKE2SP_LEAF_PARAMETER_WORD_3 0x20000000u
+#define BLAKE2SP_ROOT_PARAMETER_WORD_3 0x20010000u
+
+#define BLAKE2S_ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+#define BLAKE2S_G(a, b, c, d, x, y) \
+    do \
+    { \
+        a = a + b + (x); \
+        d = BLAKE2S_ROTR32(d ^ a, 16); \
+        c = c + d; \
+        b = BLAKE2S_ROTR32(b ^ c, 12); \
+        a = a + b + (y); \
+        d = BLAKE2S_ROTR32(d ^ a, 8); \
+        c = c + d; \
+        b = BLAKE2S_ROTR32(b ^ c, 7); \
+    } while (0)
+
+static const unsigned int BLAKE2S_IV[8] =
+{
+    0x6A09E667u, 0xBB67AE85u, 0x3C6EF372u, 0xA54FF53Au,
+    0x510E527Fu, 0x9B05688Cu, 0x1F83D9ABu, 0x5BE0CD19u
+};
+
+static const unsigned char BLAKE2S_SIGMA[BLAKE2S_ROUNDS][16] =
+{
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+    { 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+    {  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+    {  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+    {  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+    { 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+    { 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+    {  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+    { 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 }
+};
+
+/**
+ * Compresses one block of a single BLAKE2s node. Used for the root node,
+ * for the last blocks of the leaves and for all leaf blocks if SSE2 isn't
+ * available.
+ */
+static
+void
+uhashtools_blake2s_compress
+(
+    unsigned int* h,
+    const unsigned char* block,
+    unsigned __int64 counter,
+    BOOL is_last_block,
+    BOOL is_last_node
+)
+{
+    unsigned int m[16];
+    unsigned int v[16];
+    int i = 0;
+
+    for (i = 0; i < 16; ++i)
+    {
+        /* Every target architecture of Windows is little endian. */
+        m[i] = *(const unsigned int UNALIGNED*) (block + i * 4);
+    }
+
+    for (i = 0; i < 8; ++i)
+    {
+        v[i] = h[i];
+        v[i + 8] = BLAKE2S_IV[i];
+    }
+
+    v[12] ^= (unsigned int) counter;
+    v[13] ^= (unsigned int) (counter >> 32);
+
+    if (is_last_block)
+    {
+        v[14] = ~v[14];
+    }
+
+    if (is_last_node)
+    {
+        v[15] = ~v[15];
+    }
+
+    for (i = 0; i < BLAKE2S_ROUNDS; ++i)
+    {
+        const unsigned char* s = BLAKE2S_SIGMA[i];
+
+        BLAKE2S_G(v[0], v[4], v[8], v[12], m[s[0]], m[s[1]]);
+        BLAKE2S_G(v[1], v[5], v[9], v[13], m[s[2]], m[s[3]]);
+        BLAKE2S_G(v[2], v[6], v[10], v[14], m[s[4]], m[s[5]]);
+        BLAKE2S_G(v[3], v[7], v[11], v[15], m[s[6]], m[s[7]]);
+        BLAKE2S_G(v[0], v[5], v[10], v[15], m[s[8]], m[s[9]]);
+        BLAKE2S_G(v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+        BLAKE2S_G(v[2], v[7], v[8], v[13], m[s[12]], m[s[13]]);
+        BLAKE2S_G(v[3], v[4], v[9], v[14], m[s[14]], m[s[15]]);
+    }
+
+    for (i = 0; i < 8; ++i)
+    {
+        h[i] ^= v[i] ^ v[i + 8];
+    }
+}
+
+#ifdef BLAKE2SP_HAS_SSE2_IMPL
+
+#define BLAKE2SP_ROTR_VEC(x, n) _mm_or_si128(_mm_srli_epi32((x), (n)), _mm_slli_epi32((x), 32 - (n)))
+#define BLAKE2SP_ROTR16_VEC(x) _mm_shufflehi_epi16(_mm_shufflelo_epi16((x), 0xB1), 0xB1)
+
+#define BLAKE2SP_G_VEC(a, b, c, d, x, y) \
+    do \
+    { \
+        a = _mm_add_epi32(_mm_add_epi32(a, b), (x)); \
+        d = BLAKE2SP_ROTR16_VEC(_mm_xor_si128(d, a)); \
+        c = _mm_add_epi32(c, d); \
+        b = BLAKE2SP_ROTR_VEC(_mm_xor_si128(b, c), 12); \
+        a = _mm_add_epi32(_mm_add_epi32(a, b), (y)); \
+        d = BLAKE2SP_ROTR_VEC(_mm_xor_si128(d, a), 8); \
+        c = _mm_add_epi32(c, d); \
+        b = BLAKE2SP_ROTR_VEC(_mm_xor_si128(b, c), 7); \
+    } while (0)
+
+/**
+ * Compresses one block of 4 neighboring leaves at once. Every 32 bit
+ * element of the vectors belongs to another leaf. Only used for blocks
+ * which aren't the last block of their leaf.
+ */
+static
+void
+uhashtools_blake2sp_compress_4_leaves
+(
+    unsigned int h[8][BUILTIN_BLAKE2SP_LEAVES],
+    size_t first_leaf,
+    const unsigned char* group,
+    unsigned __int64 counter
+)
+{
+    __m128i m[16];
+    __m128i v[16];
+    int i = 0;
+
+    /* Transposes the blocks so that every vector contains the same message word of the 4 leaves. */
+    for (i = 0; i < 4; ++i)
+    {
+        const unsigned char* words = group + first_leaf * BUILTIN_BLAKE2SP_BLOCK_SIZE + i * 16;
+        const __m128i leaf_0 = _mm_loadu_si128((const __m128i*) words);
+        const __m128i leaf_1 = _mm_loadu_si128((const __m128i*) (words + BUILTIN_BLAKE2SP_BLOCK_SIZE));
+        const __m128i leaf_2 = _mm_loadu_si128((const __m128i*) (words + 2 * BUILTIN_BLAKE2SP_BLOCK_SIZE));
+        const __m128i leaf_3 = _mm_loadu_si128((const __m128i*) (words + 3 * BUILTIN_BLAKE2SP_BLOCK_SIZE));
+        const __m128i low_01 = _mm_unpacklo_epi32(leaf_0, leaf_1);
+        const __m128i high_01 = _mm_unpackhi_epi32(leaf_0, leaf_1);
+        const __m128i low_23 = _mm_unpacklo_epi32(leaf_2, leaf_3);
+        const __m128i high_23 = _mm_unpackhi_epi32(leaf_2, leaf_3);
+
+        m[i * 4] = _mm_unpacklo_epi64(low_01, low_23);
+        m[i * 4 + 1] = _mm_unpackhi_epi64(low_01, low_23);
+        m[i * 4 + 2] = _mm_unpacklo_epi64(high_01, high_23);
+        m[i * 4 + 3] = _mm_unpackhi_epi64(high_01, high_23);
+    }
+
+    for (i = 0; i < 8; ++i)
+    {
+        v[i] = _mm_loadu_si128((const __m128i*) &h[i][first_leaf]);
+        v[i + 8] = _mm_set1_epi32((int) BLAKE2S_IV[i]);
+    }
+
+    v[12] = _mm_xor_si128(v[12], _mm_set1_epi32((int) (unsigned int) counter));
+    v[13] = _mm_xor_si128(v[13], _mm_set1_epi32((int) (unsigned int) (counter >> 32)));
+
+    for (i = 0; i < BLAKE2S_ROUNDS; ++i)
+    {
+        const unsigned char* s = BLAKE2S_SIGMA[i];
+
+        BLAKE2SP_G_VEC(v[0], v[4], v[8], v[12], m[s[0]], m[s[1]]);
+        BLAKE2SP_G_VEC(v[1], v[5], v[9], v[13], m[s[2]], m[s[3]]);
+        BLAKE2SP_G_VEC(v[2], v[6], v[10], v[14], m[s[4]], m[s[5]]);
+        BLAKE2SP_G_VEC(v[3], v[7], v[11], v[15], m[s[6]], m[s[7]]);
+        BLAKE2SP_G_VEC(v[0], v[5], v[10], v[15], m[s[8]], m[s[9]]);
+        BLAKE2SP_G_VEC(v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+        BLAKE2SP_G_VEC(v[2], v[7], v[8], v[13], m[s[12]], m[s[13]]);
+        BLAKE2SP_G_VEC(v[3], v[4], v[9], v[14], m[s[14]], m[s[15]]);
+    }
+
+    for (i = 0; i < 8; ++i)
+    {
+        const __m128i old_h = _mm_loadu_si128((const __m128i*) &h[i][first_leaf]);
+
+        _mm_storeu_si128((__m128i*) &h[i][first_leaf], _mm_xor_si128(old_h, _mm_xor_si128(v[i], v[i + 8])));
+    }
+}
+
+#endif /* BLAKE2SP_HAS_SSE2_IMPL */
+
+static
+void
+uhashtools_blake2sp_get_leaf_h
+(
+    const struct BuiltinBlake2spState* state,
+    size_t leaf,
+    unsigned int* h
+)
+{
+    int i = 0;
+
+    for (i = 0; i < 8; ++i)
+    {
+        h[i] = state->h[i][leaf];
+    }
+}
+
+/**
+ * Compresses the next block of every leaf. Only allowed if every leaf
+ * has at least one more block, because the last block of a leaf must
+ * be compressed with the finalization flag.
+ */
+static
+void
+uhashtools_blake2sp_compress_group
+(
+    struct BuiltinBlake2spState* state,
+    const unsigned char* group
+)
+{
+    state->leaf_size += BUILTIN_BLAKE2SP_BLOCK_SIZE;
+
+#ifdef BLAKE2SP_HAS_SSE2_IMPL
+    uhashtools_blake2sp_compress_4_leaves(state->h, 0, group, state->leaf_size);
+    uhashtools_blake2sp_compress_4_leaves(state->h, 4, group, state->leaf_size);
+#else
+    {
+        size_t leaf = 0;
+
+        for (leaf = 0; leaf < BUILTIN_BLAKE2SP_LEAVES; ++leaf)
+        {
+            unsigned int h[8];
+            int i = 0;
+
+            uhashtools_blake2sp_get_leaf_h(state, leaf, h);
+            uhashtools_blake2s_compress(h, group + leaf * BUILTIN_BLAKE2SP_BLOCK_SIZE, state->leaf_size, FALSE, FALSE);
+
+            for (i = 0; i < 8; ++i)
+            {
+                state->h[i][leaf] = h[i];
+            }
+        }
+    }
+#endif
+}
+
+static
+size_t
+uhashtools_blake2sp_get_buffered_block_size
+(
+    const struct BuiltinBlake2spState* state,
+    size_t block_offset
+)
+{
+    if (state->buffer_fill <= block_offset)
+    {
+        return 0;
+    }
+
+    if (state->buffer_fill - block_offset > BUILTIN_BLAKE2SP_BLOCK_SIZE)
+    {
+        return BUILTIN_BLAKE2SP_BLOCK_SIZE;
+    }
+
+    return state->buffer_fill - block_offset;
+}
+
+void
+uhashtools_builtin_blake2sp_init
+(
+    struct BuiltinBlake2spState* state
+)
+{
+    size_t leaf = 0;
+
+    for (leaf = 0; leaf < BUILTIN_BLAKE2SP_LEAVES; ++leaf)
+    {
+        int i = 0;
+
+        for (i = 0; i < 8; ++i)
+        {
+            state->h[i][leaf] = BLAKE2S_IV[i];
+        }
+
+        state->h[0][leaf] ^= BLAKE2SP_PARAMETER_WORD_0;
+        state->h[2][leaf] ^= (unsigned int) leaf;
+        state->h[3][leaf] ^= BLAKE2SP_LEAF_PARAMETER_WORD_3;
+    }
+
+    state->leaf_size = 0;
+    state->buffer_fill = 0;
+}
+
+void
+uhashtools_builtin_blake2sp_update
+(
+    struct BuiltinBlake2spState* state,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    /*
+     * A group of blocks is only compressed if at least one more full
+     * group follows it. This guarantees that no leaf is at its last
+     * block, which must be compressed with the finalization flag.
+     */
+    if (state->buffer_fill + data_size <= sizeof(state->buffer))
+    {
+        (void) memcpy((void*) (state->buffer + state->buffer_fill), (const void*) data, data_size);
+        state->buffer_fill += data_size;
+        return;
+    }
+
+    if (state->buffer_fill > 0)
+    {
+        const size_t copy_size = sizeof(state->buffer) - state->buffer_fill;
+
+        (void) memcpy((void*) (state->buffer + state->buffer_fill), (const void*) data, copy_size);
+        data += copy_size;
+        data_size -= copy_size;
+
+        uhashtools_blake2sp_compress_group(state, state->buffer);
+
+        if (data_size < BUILTIN_BLAKE2SP_GROUP_SIZE)
+        {
+            (void) memmove((void*) state->buffer,
+                           (const void*) (state->buffer + BUILTIN_BLAKE2SP_GROUP_SIZE),
+                           BUILTIN_BLAKE2SP_GROUP_SIZE);
+            (void) memcpy((void*) (state->buffer + BUILTIN_BLAKE2SP_GROUP_SIZE), (const void*) data, data_size);
+            state->buffer_fill = BUILTIN_BLAKE2SP_GROUP_SIZE + data_size;
+            return;
+        }
+
+        uhashtools_blake2sp_compress_group(state, state->buffer + BUILTIN_BLAKE2SP_GROUP_SIZE);
+        state->buffer_fill = 0;
+    }
+
+    /* Groups are hashed directly from the input without copying them. */
+    while (data_size >= 2 * BUILTIN_BLAKE2SP_GROUP_SIZE)
+    {
+        uhashtools_blake2sp_compress_group(state, data);
+        data += BUILTIN_BLAKE2SP_GROUP_SIZE;
+        data_size -= BUILTIN_BLAKE2SP_GROUP_SIZE;
+    }
+
+    (void) memcpy((void*) state->buffer, (const void*) data, data_size);
+    state->buffer_fill = data_size;
+}
+
+void
+uhashtools_builtin_blake2sp_finish
+(
+    struct BuiltinBlake2spState* state,
+    unsigned char* digest
+)
+{
+    unsigned char leaf_digests[BUILTIN_BLAKE2SP_LEAVES * BLAKE2S_DIGEST_SIZE];
+    unsigned char last_block[BUILTIN_BLAKE2SP_BLOCK_SIZE];
+    unsigned int h[8];
+    size_t leaf = 0;
+    int i = 0;
+
+    /*
+     * The buffer contains up to two blocks per leaf. Each leaf compresses
+     * its last non-empty block (or an empty block if the leaf got no
+     * data at all) with the finalization flag.
+     */
+    for (leaf = 0; leaf < BUILTIN_BLAKE2SP_LEAVES; ++leaf)
+    {
+        const size_t first_offset = leaf * BUILTIN_BLAKE2SP_BLOCK_SIZE;
+        const size_t second_offset = BUILTIN_BLAKE2SP_GROUP_SIZE + first_offset;
+        const size_t second_size = uhashtools_blake2sp_get_buffered_block_size(state, second_offset);
+        unsigned __int64 counter = state->leaf_size;
+        size_t last_offset = first_offset;
+        size_t last_size = 0;
+
+        uhashtools_blake2sp_get_leaf_h(state, leaf, h);
+
+        if (second_size > 0)
+        {
+            counter += BUILTIN_BLAKE2SP_BLOCK_SIZE;
+            uhashtools_blake2s_compress(h, state->buffer + first_offset, counter, FALSE, FALSE);
+            last_offset = second_offset;
+            last_size = second_size;
+        }
+        else
+        {
+            last_size = uhashtools_blake2sp_get_buffered_block_size(state, first_offset);
+        }
+
+        (void) memset((void*) last_block, 0, sizeof(last_block));
+        (void) memcpy((void*) last_block, (const void*) (state->buffer + last_offset), last_size);
+        counter += last_size;
+        uhashtools_blake2s_compress(h, last_block, counter, TRUE, leaf == BUILTIN_BLAKE2SP_LEAVES - 1);
+
+        (void) memcpy((void*) (leaf_digests + leaf * BLAKE2S_DIGEST_SIZE), (const void*) h, BLAKE2S_DIGEST_SIZE);
+    }
+
+    /* The root node hashes the concatenated leaf digests (exactly 4 blocks). */
+    for (i = 0; i < 8; ++i)
+    {
+        h[i] = BLAKE2S_IV[i];
+    }
+
+    h[0] ^= BLAKE2SP_PARAMETER_WORD_0;
+    h[3] ^= BLAKE2SP_ROOT_PARAMETER_WORD_3;
+
+    for (i = 0; i < 4; ++i)
+    {
+        const BOOL is_last_block = (i == 3);
+
+        uhashtools_blake2s_compress(h,
+                                    leaf_digests + i * BUILTIN_BLAKE2SP_BLOCK_SIZE,
+                                    (unsigned __int64) (i + 1) * BUILTIN_BLAKE2SP_BLOCK_SIZE,
+                                    is_last_block,
+                                    is_last_block);
+    }
+
+    /* Every target architecture of Windows is little endian. */
+    (void) memcpy((void*) digest, (const void*) h, BUILTIN_BLAKE2SP_DIGEST_SIZE);
+}
+
+BOOL
+uhashtools_builtin_blake2sp_is_state_valid
+(
+    const struct BuiltinBlake2spState* state
+)
+{
+    return state->buffer_fill <= sizeof(state->buffer) &&
+           state->leaf_size % BUILTIN_BLAKE2SP_BLOCK_SIZE == 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+/*
+ * Built-in implementation of the BLAKE2sp hash algorithm with a digest
+ * size of 256 bit and without key. BLAKE2sp distributes the 64 byte
+ * blocks of the input round-robin to 8 independent BLAKE2s leaves and
+ * hashes their digests with a BLAKE2s root node. The leaves are
+ * processed in lockstep, so on x86 and x64 CPUs 4 leaves at a time
+ * are hashed with SSE2 (one leaf per 32 bit element). The Windows CNG
+ * API doesn't provide this algorithm, so it's always used.
+ */
+
+#define BUILTIN_BLAKE2SP_DIGEST_SIZE 32
+#define BUILTIN_BLAKE2SP_LEAVES 8
+#define BUILTIN_BLAKE2SP_BLOCK_SIZE 64
+#define BUILTIN_BLAKE2SP_GROUP_SIZE (BUILTIN_BLAKE2SP_LEAVES * BUILTIN_BLAKE2SP_BLOCK_SIZE)
+
+struct BuiltinBlake2spState
+{
+    /* Chaining values of the leaves, h[word][leaf] for loading 4 leaves at once. */
+    unsigned int h[8][BUILTIN_BLAKE2SP_LEAVES];
+    /* Amount of compressed bytes per leaf (equal for every leaf). */
+    unsigned __int64 leaf_size;
+    /* Up to two groups of blocks which can't be compressed yet. */
+    unsigned char buffer[2 * BUILTIN_BLAKE2SP_GROUP_SIZE];
+    size_t buffer_fill;
+};
+
+/**
+ * Initializes the hash state for a new calculation.
+ * 
+ * @param state Hash state which should be initialized.
+ */
+extern
+void
+uhashtools_builtin_blake2sp_init
+(
+    struct BuiltinBlake2spState* state
+);
+
+/**
+ * Hashes the next part of the data.
+ * 
+ * @param state Initialized hash state.
+ * @param data Data which should be hashed.
+ * @param data_size Size of "data" in bytes.
+ */
+extern
+void
+uhashtools_builtin_blake2sp_update
+(
+    struct BuiltinBlake2spState* state,
+    const unsigned char* data,
+    size_t data_size
+);
+
+/**
+ * Finishes the calculation and writes the digest.
+ * 
+ * @param state Hash state. It must be initialized again before reusing it.
+ * @param digest Buffer of BUILTIN_BLAKE2SP_DIGEST_SIZE bytes which receives the digest.
+ */
+extern
+void
+uhashtools_builtin_blake2sp_finish
+(
+    struct BuiltinBlake2spState* state,
+    unsigned char* digest
+);
+
+/**
+ * Checks the counters of a hash state which hasn't been created by this
+ * process (for example a state which has been read from a file), so a
+ * damaged state is rejected before it's used.
+ * 
+ * @param state Hash state which should be checked.
+ * 
+ * @return TRUE if the state can be used else FALSE.
+ */
+extern
+BOOL
+uhashtools_builtin_blake2sp_is_state_valid
+(
+    const struct BuiltinBlake2spState* state
+);
@@ -0,0 +1,380 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "builtin_crc32c.h"
+
+#include <Windows.h>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#include <nmmintrin.h>
+
+#define CRC32C_HAS_SSE42_IMPL
+#endif
+
+/* Bit reversed representation of the Castagnoli polynomial 0x1EDC6F41. */
+#define CRC32C_POLYNOMIAL 0x82F63B78u
+
+/*
+ * Sizes of the three parts which are processed interleaved by the SSE4.2
+ * implementation. The long blocks are used for the bulk of the data, the
+ * short blocks for the rest which doesn't fill three long blocks.
+ */
+#define CRC32C_LONG_BLOCK_SIZE 8192
+#define CRC32C_SHORT_BLOCK_SIZE 256
+
+#if defined(_M_X64)
+#define CRC32C_SSE42_WORD_SIZE 8
+#define CRC32C_SSE42_UPDATE_WORD(crc, data) ((unsigned int) _mm_crc32_u64((crc), *(const unsigned __int64*) (data)))
+#elif defined(_M_IX86)
+#define CRC32C_SSE42_WORD_SIZE 4
+#define CRC32C_SSE42_UPDATE_WORD(crc, data) _mm_crc32_u32((crc), *(const unsigned int*) (data))
+#endif
+
+struct Crc32cTables
+{
+    /* Tables of the software implementation (slicing by 8 bytes). */
+    unsigned int software_tables[8][256];
+
+    /*
+     * Tables which are advancing a CRC value over a long or short block of
+     * zero bytes. They are used to combine the CRC values of the parts which
+     * are processed interleaved.
+     */
+    unsigned int long_block_shift_tables[4][256];
+    unsigned int short_block_shift_tables[4][256];
+
+    BOOL use_sse42_impl;
+};
+
+static INIT_ONCE g_crc32c_tables_init_once = INIT_ONCE_STATIC_INIT;
+static struct Crc32cTables g_crc32c_tables;
+
+#ifdef CRC32C_HAS_SSE42_IMPL
+
+/* Returns a * b modulo the polynomial, both in bit reversed representation. */
+static
+unsigned int
+uhashtools_crc32c_multiply_mod_poly
+(
+    unsigned int a,
+    unsigned int b
+)
+{
+    unsigned int product = 0;
+    int i = 0;
+
+    for (i = 0; i < 32; ++i)
+    {
+        if (a & 0x80000000u)
+        {
+            product ^= b;
+        }
+
+        a <<= 1;
+        b = (b & 1) ? ((b >> 1) ^ CRC32C_POLYNOMIAL) : (b >> 1);
+    }
+
+    return product;
+}
+
+static
+void
+uhashtools_crc32c_init_shift_tables
+(
+    unsigned int shift_tables[4][256],
+    size_t zero_bytes_count
+)
+{
+    /* x^0 and x^8 in bit reversed representation. */
+    unsigned int shift_operator = 0x80000000u;
+    unsigned int power = 0x00800000u;
+    int table_index = 0;
+    unsigned int byte_value = 0;
+
+    /* The operator is x^(8 * zero_bytes_count), calculated by squaring. */
+    while (zero_bytes_count > 0)
+    {
+        if (zero_bytes_count & 1)
+        {
+            shift_operator = uhashtools_crc32c_multiply_mod_poly(power, shift_operator);
+        }
+
+        power = uhashtools_crc32c_multiply_mod_poly(power, power);
+        zero_bytes_count >>= 1;
+    }
+
+    for (table_index = 0; table_index < 4; ++table_index)
+    {
+        for (byte_value = 0; byte_value < 256; ++byte_value)
+        {
+            shift_tables[table_index][byte_value] = uhashtools_crc32c_multiply_mod_poly(shift_operator,
+                                                                                        byte_value << (table_index * 8));
+        }
+    }
+}
+
+#endif
+
+static
+BOOL
+CALLBACK
+uhashtools_crc32c_init_tables
+(
+    PINIT_ONCE init_once,
+    PVOID parameter,
+    PVOID* context
+)
+{
+    struct Crc32cTables* tables = &g_crc32c_tables;
+    unsigned int byte_value = 0;
+    int table_index = 0;
+
+    (void) init_once;
+    (void) parameter;
+    (void) context;
+
+    for (byte_value = 0; byte_value < 256; ++byte_value)
+    {
+        unsigned int crc = byte_value;
+        int bit = 0;
+
+        for (bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 1) ? ((crc >> 1) ^ CRC32C_POLYNOMIAL) : (crc >> 1);
+        }
+
+        tables->software_tables[0][byte_value] = crc;
+    }
+
+    for (table_index = 1; table_index < 8; ++table_index)
+    {
+        for (byte_value = 0; byte_value < 256; ++byte_value)
+        {
+            const unsigned int previous = tables->software_tables[table_index - 1][byte_value];
+
+            tables->software_tables[table_index][byte_value] = (previous >> 8) ^ tables->software_tables[0][previous & 0xFF];
+        }
+    }
+
+#ifdef CRC32C_HAS_SSE42_IMPL
+    {
+        int cpu_info[4] = {0};
+
+        __cpuid(cpu_info, 1);
+        tables->use_sse42_impl = (cpu_info[2] & (1 << 20)) ? TRUE : FALSE;
+    }
+
+    if (tables->use_sse42_impl)
+    {
+        uhashtools_crc32c_init_shift_tables(tables->long_block_shift_tables, CRC32C_LONG_BLOCK_SIZE);
+        uhashtools_crc32c_init_shift_tables(tables->short_block_shift_tables, CRC32C_SHORT_BLOCK_SIZE);
+    }
+#else
+    tables->use_sse42_impl = FALSE;
+#endif
+
+    return TRUE;
+}
+
+static
+unsigned int
+uhashtools_crc32c_update_software
+(
+    unsigned int crc,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    unsigned int (*tables)[256] = g_crc32c_tables.software_tables;
+
+    while (data_size >= 8)
+    {
+        const unsigned int low = crc ^ ((unsigned int) data[0]
+                                        | ((unsigned int) data[1] << 8)
+                                        | ((unsigned int) data[2] << 16)
+                                        | ((unsigned int) data[3] << 24));
+        const unsigned int high = (unsigned int) data[4]
+                                  | ((unsigned int) data[5] << 8)
+                                  | ((unsigned int) data[6] << 16)
+                                  | ((unsigned int) data[7] << 24);
+
+        crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF]
+              ^ tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24]
+              ^ tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF]
+              ^ tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+
+        data += 8;
+        data_size -= 8;
+    }
+
+    while (data_size > 0)
+    {
+        crc = (crc >> 8) ^ tables[0][(crc ^ *data) & 0xFF];
+        ++data;
+        --data_size;
+    }
+
+    return crc;
+}
+
+#ifdef CRC32C_HAS_SSE42_IMPL
+
+static
+__forceinline
+unsigned int
+uhashtools_crc32c_shift
+(
+    unsigned int shift_tables[4][256],
+    unsigned int crc
+)
+{
+    return shift_tables[0][crc & 0xFF] ^ shift_tables[1][(crc >> 8) & 0xFF]
+           ^ shift_tables[2][(crc >> 16) & 0xFF] ^ shift_tables[3][crc >> 24];
+}
+
+/*
+ * Processes as many groups of three blocks of "block_size" bytes as
+ * possible. The three blocks of a group are independent of each other,
+ * so the CPU can execute the "crc32" instructions for them in parallel.
+ * The CRC values of the second and third block are merged afterwards.
+ */
+static
+unsigned int
+uhashtools_crc32c_update_sse42_interleaved
+(
+    unsigned int crc,
+    const unsigned char** data,
+    size_t* data_size,
+    size_t block_size,
+    unsigned int shift_tables[4][256]
+)
+{
+    const unsigned char* next = *data;
+    size_t remaining_size = *data_size;
+
+    while (remaining_size >= block_size * 3)
+    {
+        const unsigned char* const block_end = next + block_size;
+        unsigned int crc1 = 0;
+        unsigned int crc2 = 0;
+
+        do
+        {
+            crc = CRC32C_SSE42_UPDATE_WORD(crc, next);
+            crc1 = CRC32C_SSE42_UPDATE_WORD(crc1, next + block_size);
+            crc2 = CRC32C_SSE42_UPDATE_WORD(crc2, next + block_size * 2);
+            next += CRC32C_SSE42_WORD_SIZE;
+        }
+        while (next < block_end);
+
+        crc = uhashtools_crc32c_shift(shift_tables, crc) ^ crc1;
+        crc = uhashtools_crc32c_shift(shift_tables, crc) ^ crc2;
+
+        next += block_size * 2;
+        remaining_size -= block_size * 3;
+    }
+
+    *data = next;
+    *data_size = remaining_size;
+
+    return crc;
+}
+
+static
+unsigned int
+uhashtools_crc32c_update_sse42
+(
+    unsigned int crc,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    /* Aligning the data for the word sized reads. */
+    while (data_size > 0 && ((size_t) data & (CRC32C_SSE42_WORD_SIZE - 1)) != 0)
+    {
+        crc = _mm_crc32_u8(crc, *data);
+        ++data;
+        --data_size;
+    }
+
+    crc = uhashtools_crc32c_update_sse42_interleaved(crc,
+                                                     &data,
+                                                     &data_size,
+                                                     CRC32C_LONG_BLOCK_SIZE,
+                                                     g_crc32c_tables.long_block_shift_tables);
+
+    crc = uhashtools_crc32c_update_sse42_interleaved(crc,
+                                                     &data,
+                                                     &data_size,
+                                                     CRC32C_SHORT_BLOCK_SIZE,
+                                                     g_crc32c_tables.short_block_shift_tables);
+
+    while (data_size >= CRC32C_SSE42_WORD_SIZE)
+    {
+        crc = CRC32C_SSE42_UPDATE_WORD(crc, data);
+        data += CRC32C_SSE42_WORD_SIZE;
+        data_size -= CRC32C_SSE42_WORD_SIZE;
+    }
+
+    while (data_size > 0)
+    {
+        crc = _mm_crc32_u8(crc, *data);
+        ++data;
+        --data_size;
+    }
+
+    return crc;
+}
+
+#endif
+
+void
+uhashtools_builtin_crc32c_init
+(
+    struct BuiltinCrc32cState* state
+)
+{
+    (void) InitOnceExecuteOnce(&g_crc32c_tables_init_once, uhashtools_crc32c_init_tables, NULL, NULL);
+
+    state->crc = 0xFFFFFFFFu;
+}
+
+void
+uhashtools_builtin_crc32c_update
+(
+    struct BuiltinCrc32cState* state,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+#ifdef CRC32C_HAS_SSE42_IMPL
+    if (g_crc32c_tables.use_sse42_impl)
+    {
+        state->crc = uhashtools_crc32c_update_sse42(state->crc, data, data_size);
+        return;
+    }
+#endif
+
+    state->crc = uhashtools_crc32c_update_software(state->crc, data, data_size);
+}
+
+void
+uhashtools_builtin_crc32c_finish
+(
+    struct BuiltinCrc32cState* state,
+    unsigned char* digest
+)
+{
+    const unsigned int crc = state->crc ^ 0xFFFFFFFFu;
+
+    digest[0] = (unsigned char) (crc >> 24);
+    digest[1] = (unsigned char) (crc >> 16);
+    digest[2] = (unsigned char) (crc >> 8);
+    digest[3] = (unsigned char) crc;
+}
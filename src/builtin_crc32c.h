@@ -0,0 +1,72 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+/*
+ * Built-in implementation of the CRC-32C checksum (Castagnoli
+ * polynomial, as used by iSCSI and ext4). It isn't a cryptographic hash
+ * algorithm and is only suitable for detecting accidental corruption.
+ * On x86 and x64 CPUs with SSE4.2 the "crc32" instruction is used and
+ * three independent parts of the data are processed interleaved, so
+ * the latency of the instruction doesn't limit the throughput. Other
+ * CPUs are using a table based software implementation. The Windows
+ * CNG API doesn't provide this algorithm, so it's always used.
+ */
+
+#define BUILTIN_CRC32C_DIGEST_SIZE 4
+
+struct BuiltinCrc32cState
+{
+    unsigned int crc;
+};
+
+/**
+ * Initializes the checksum state for a new calculation.
+ * 
+ * @param state Checksum state which should be initialized.
+ */
+extern
+void
+uhashtools_builtin_crc32c_init
+(
+    struct BuiltinCrc32cState* state
+);
+
+/**
+ * Adds the next part of the data to the checksum.
+ * 
+ * @param state Initialized checksum state.
+ * @param data Data which should be added.
+ * @param data_size Size of "data" in bytes.
+ */
+extern
+void
+uhashtools_builtin_crc32c_update
+(
+    struct BuiltinCrc32cState* state,
+    const unsigned char* data,
+    size_t data_size
+);
+
+/**
+ * Finishes the calculation and writes the checksum in big endian byte
+ * order (the usual textual representation).
+ * 
+ * @param state Checksum state. It must be initialized again before reusing it.
+ * @param digest Buffer of BUILTIN_CRC32C_DIGEST_SIZE bytes which receives the checksum.
+ */
+extern
+void
+uhashtools_builtin_crc32c_finish
+(
+    struct BuiltinCrc32cState* state,
+    unsigned char* digest
+);
@@ -0,0 +1,202 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "builtin_md5.h"
+
+#include <string.h>
+
+#define MD5_ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static const unsigned int MD5_ROUND_CONSTANTS[64] =
+{
+    0xD76AA478u, 0xE8C7B756u, 0x242070DBu, 0xC1BDCEEEu, 0xF57C0FAFu, 0x4787C62Au, 0xA8304613u, 0xFD469501u,
+    0x698098D8u, 0x8B44F7AFu, 0xFFFF5BB1u, 0x895CD7BEu, 0x6B901122u, 0xFD987193u, 0xA679438Eu, 0x49B40821u,
+    0xF61E2562u, 0xC040B340u, 0x265E5A51u, 0xE9B6C7AAu, 0xD62F105Du, 0x02441453u, 0xD8A1E681u, 0xE7D3FBC8u,
+    0x21E1CDE6u, 0xC33707D6u, 0xF4D50D87u, 0x455A14EDu, 0xA9E3E905u, 0xFCEFA3F8u, 0x676F02D9u, 0x8D2A4C8Au,
+    0xFFFA3942u, 0x8771F681u, 0x6D9D6122u, 0xFDE5380Cu, 0xA4BEEA44u, 0x4BDECFA9u, 0xF6BB4B60u, 0xBEBFBC70u,
+    0x289B7EC6u, 0xEAA127FAu, 0xD4EF3085u, 0x04881D05u, 0xD9D4D039u, 0xE6DB99E5u, 0x1FA27CF8u, 0xC4AC5665u,
+    0xF4292244u, 0x432AFF97u, 0xAB9423A7u, 0xFC93A039u, 0x655B59C3u, 0x8F0CCC92u, 0xFFEFF47Du, 0x85845DD1u,
+    0x6FA87E4Fu, 0xFE2CE6E0u, 0xA3014314u, 0x4E0811A1u, 0xF7537E82u, 0xBD3AF235u, 0x2AD7D2BBu, 0xEB86D391u
+};
+
+static const unsigned int MD5_SHIFT_AMOUNTS[64] =
+{
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+};
+
+static
+void
+uhashtools_builtin_md5_compress
+(
+    unsigned int* h,
+    const unsigned char* block
+)
+{
+    unsigned int m[16];
+    unsigned int a = h[0];
+    unsigned int b = h[1];
+    unsigned int c = h[2];
+    unsigned int d = h[3];
+    int i = 0;
+
+    for (i = 0; i < 16; ++i)
+    {
+        m[i] = (unsigned int) block[i * 4] |
+               ((unsigned int) block[i * 4 + 1] << 8) |
+               ((unsigned int) block[i * 4 + 2] << 16) |
+               ((unsigned int) block[i * 4 + 3] << 24);
+    }
+
+    for (i = 0; i < 64; ++i)
+    {
+        unsigned int f = 0;
+        int g = 0;
+        unsigned int t = 0;
+
+        if (i < 16)
+        {
+            f = (b & c) | (~b & d);
+            g = i;
+        }
+        else if (i < 32)
+        {
+            f = (d & b) | (~d & c);
+            g = (5 * i + 1) & 15;
+        }
+        else if (i < 48)
+        {
+            f = b ^ c ^ d;
+            g = (3 * i + 5) & 15;
+        }
+        else
+        {
+            f = c ^ (b | ~d);
+            g = (7 * i) & 15;
+        }
+
+        t = d;
+        d = c;
+        c = b;
+        b = b + MD5_ROTL(a + f + MD5_ROUND_CONSTANTS[i] + m[g], MD5_SHIFT_AMOUNTS[i]);
+        a = t;
+    }
+
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+}
+
+void
+uhashtools_builtin_md5_init
+(
+    struct BuiltinMd5State* state
+)
+{
+    state->h[0] = 0x67452301u;
+    state->h[1] = 0xEFCDAB89u;
+    state->h[2] = 0x98BADCFEu;
+    state->h[3] = 0x10325476u;
+    state->total_size = 0;
+    state->block_fill = 0;
+}
+
+void
+uhashtools_builtin_md5_update
+(
+    struct BuiltinMd5State* state,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    state->total_size += data_size;
+
+    if (state->block_fill > 0)
+    {
+        size_t copy_size = BUILTIN_MD5_BLOCK_SIZE - state->block_fill;
+
+        if (copy_size > data_size)
+        {
+            copy_size = data_size;
+        }
+
+        (void) memcpy((void*) (state->block + state->block_fill), (const void*) data, copy_size);
+        state->block_fill += copy_size;
+        data += copy_size;
+        data_size -= copy_size;
+
+        if (state->block_fill < BUILTIN_MD5_BLOCK_SIZE)
+        {
+            return;
+        }
+
+        uhashtools_builtin_md5_compress(state->h, state->block);
+        state->block_fill = 0;
+    }
+
+    /* Full blocks are hashed directly from the input without copying them. */
+    while (data_size >= BUILTIN_MD5_BLOCK_SIZE)
+    {
+        uhashtools_builtin_md5_compress(state->h, data);
+        data += BUILTIN_MD5_BLOCK_SIZE;
+        data_size -= BUILTIN_MD5_BLOCK_SIZE;
+    }
+
+    (void) memcpy((void*) state->block, (const void*) data, data_size);
+    state->block_fill = data_size;
+}
+
+void
+uhashtools_builtin_md5_finish
+(
+    struct BuiltinMd5State* state,
+    unsigned char* digest
+)
+{
+    const unsigned __int64 total_bits = state->total_size * 8;
+    int i = 0;
+
+    state->block[state->block_fill++] = 0x80;
+
+    if (state->block_fill > BUILTIN_MD5_BLOCK_SIZE - 8)
+    {
+        (void) memset((void*) (state->block + state->block_fill), 0, BUILTIN_MD5_BLOCK_SIZE - state->block_fill);
+        uhashtools_builtin_md5_compress(state->h, state->block);
+        state->block_fill = 0;
+    }
+
+    (void) memset((void*) (state->block + state->block_fill), 0, BUILTIN_MD5_BLOCK_SIZE - 8 - state->block_fill);
+
+    for (i = 0; i < 8; ++i)
+    {
+        state->block[BUILTIN_MD5_BLOCK_SIZE - 8 + i] = (unsigned char) (total_bits >> (i * 8));
+    }
+
+    uhashtools_builtin_md5_compress(state->h, state->block);
+
+    for (i = 0; i < 4; ++i)
+    {
+        digest[i * 4] = (unsigned char) state->h[i];
+        digest[i * 4 + 1] = (unsigned char) (state->h[i] >> 8);
+        digest[i * 4 + 2] = (unsigned char) (state->h[i] >> 16);
+        digest[i * 4 + 3] = (unsigned char) (state->h[i] >> 24);
+    }
+}
+
+BOOL
+uhashtools_builtin_md5_is_state_valid
+(
+    const struct BuiltinMd5State* state
+)
+{
+    return state->block_fill < BUILTIN_MD5_BLOCK_SIZE &&
+           state->block_fill == (size_t) (state->total_size % BUILTIN_MD5_BLOCK_SIZE);
+}
@@ -0,0 +1,86 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+/*
+ * Built-in implementation of the MD5 hash algorithm (RFC 1321).
+ * It's used instead of the Windows CNG API if the application has
+ * been built with "HASH_BACKEND=Builtin" (see "makefile").
+ */
+
+#define BUILTIN_MD5_DIGEST_SIZE 16
+#define BUILTIN_MD5_BLOCK_SIZE 64
+
+struct BuiltinMd5State
+{
+    unsigned int h[4];
+    unsigned __int64 total_size;
+    unsigned char block[BUILTIN_MD5_BLOCK_SIZE];
+    size_t block_fill;
+};
+
+/**
+ * Initializes the hash state for a new calculation.
+ * 
+ * @param state Hash state which should be initialized.
+ */
+extern
+void
+uhashtools_builtin_md5_init
+(
+    struct BuiltinMd5State* state
+);
+
+/**
+ * Hashes the next part of the data.
+ * 
+ * @param state Initialized hash state.
+ * @param data Data which should be hashed.
+ * @param data_size Size of "data" in bytes.
+ */
+extern
+void
+uhashtools_builtin_md5_update
+(
+    struct BuiltinMd5State* state,
+    const unsigned char* data,
+    size_t data_size
+);
+
+/**
+ * Finishes the calculation and writes the digest.
+ * 
+ * @param state Hash state. It must be initialized again before reusing it.
+ * @param digest Buffer of BUILTIN_MD5_DIGEST_SIZE bytes which receives the digest.
+ */
+extern
+void
+uhashtools_builtin_md5_finish
+(
+    struct BuiltinMd5State* state,
+    unsigned char* digest
+);
+
+/**
+ * Checks the counters of a hash state which hasn't been created by this
+ * process (for example a state which has been read from a file), so a
+ * damaged state is rejected before it's used.
+ * 
+ * @param state Hash state which should be checked.
+ * 
+ * @return TRUE if the state can be used else FALSE.
+ */
+extern
+BOOL
+uhashtools_builtin_md5_is_state_valid
+(
+    const struct BuiltinMd5State* state
+);
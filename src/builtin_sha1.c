@@ -0,0 +1,191 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "builtin_sha1.h"
+
+#include <string.h>
+
+#define SHA1_ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static
+void
+uhashtools_builtin_sha1_compress
+(
+    unsigned int* h,
+    const unsigned char* block
+)
+{
+    unsigned int w[80];
+    unsigned int a = h[0];
+    unsigned int b = h[1];
+    unsigned int c = h[2];
+    unsigned int d = h[3];
+    unsigned int e = h[4];
+    int i = 0;
+
+    for (i = 0; i < 16; ++i)
+    {
+        w[i] = ((unsigned int) block[i * 4] << 24) |
+               ((unsigned int) block[i * 4 + 1] << 16) |
+               ((unsigned int) block[i * 4 + 2] << 8) |
+               (unsigned int) block[i * 4 + 3];
+    }
+
+    for (i = 16; i < 80; ++i)
+    {
+        w[i] = SHA1_ROTL(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    for (i = 0; i < 80; ++i)
+    {
+        unsigned int f = 0;
+        unsigned int k = 0;
+        unsigned int t = 0;
+
+        if (i < 20)
+        {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999u;
+        }
+        else if (i < 40)
+        {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1u;
+        }
+        else if (i < 60)
+        {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDCu;
+        }
+        else
+        {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6u;
+        }
+
+        t = SHA1_ROTL(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = SHA1_ROTL(b, 30);
+        b = a;
+        a = t;
+    }
+
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+}
+
+void
+uhashtools_builtin_sha1_init
+(
+    struct BuiltinSha1State* state
+)
+{
+    state->h[0] = 0x67452301u;
+    state->h[1] = 0xEFCDAB89u;
+    state->h[2] = 0x98BADCFEu;
+    state->h[3] = 0x10325476u;
+    state->h[4] = 0xC3D2E1F0u;
+    state->total_size = 0;
+    state->block_fill = 0;
+}
+
+void
+uhashtools_builtin_sha1_update
+(
+    struct BuiltinSha1State* state,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    state->total_size += data_size;
+
+    if (state->block_fill > 0)
+    {
+        size_t copy_size = BUILTIN_SHA1_BLOCK_SIZE - state->block_fill;
+
+        if (copy_size > data_size)
+        {
+            copy_size = data_size;
+        }
+
+        (void) memcpy((void*) (state->block + state->block_fill), (const void*) data, copy_size);
+        state->block_fill += copy_size;
+        data += copy_size;
+        data_size -= copy_size;
+
+        if (state->block_fill < BUILTIN_SHA1_BLOCK_SIZE)
+        {
+            return;
+        }
+
+        uhashtools_builtin_sha1_compress(state->h, state->block);
+        state->block_fill = 0;
+    }
+
+    /* Full blocks are hashed directly from the input without copying them. */
+    while (data_size >= BUILTIN_SHA1_BLOCK_SIZE)
+    {
+        uhashtools_builtin_sha1_compress(state->h, data);
+        data += BUILTIN_SHA1_BLOCK_SIZE;
+        data_size -= BUILTIN_SHA1_BLOCK_SIZE;
+    }
+
+    (void) memcpy((void*) state->block, (const void*) data, data_size);
+    state->block_fill = data_size;
+}
+
+void
+uhashtools_builtin_sha1_finish
+(
+    struct BuiltinSha1State* state,
+    unsigned char* digest
+)
+{
+    const unsigned __int64 total_bits = state->total_size * 8;
+    int i = 0;
+
+    state->block[state->block_fill++] = 0x80;
+
+    if (state->block_fill > BUILTIN_SHA1_BLOCK_SIZE - 8)
+    {
+        (void) memset((void*) (state->block + state->block_fill), 0, BUILTIN_SHA1_BLOCK_SIZE - state->block_fill);
+        uhashtools_builtin_sha1_compress(state->h, state->block);
+        state->block_fill = 0;
+    }
+
+    (void) memset((void*) (state->block + state->block_fill), 0, BUILTIN_SHA1_BLOCK_SIZE - 8 - state->block_fill);
+
+    for (i = 0; i < 8; ++i)
+    {
+        state->block[BUILTIN_SHA1_BLOCK_SIZE - 1 - i] = (unsigned char) (total_bits >> (i * 8));
+    }
+
+    uhashtools_builtin_sha1_compress(state->h, state->block);
+
+    for (i = 0; i < 5; ++i)
+    {
+        digest[i * 4] = (unsigned char) (state->h[i] >> 24);
+        digest[i * 4 + 1] = (unsigned char) (state->h[i] >> 16);
+        digest[i * 4 + 2] = (unsigned char) (state->h[i] >> 8);
+        digest[i * 4 + 3] = (unsigned char) state->h[i];
+    }
+}
+
+BOOL
+uhashtools_builtin_sha1_is_state_valid
+(
+    const struct BuiltinSha1State* state
+)
+{
+    return state->block_fill < BUILTIN_SHA1_BLOCK_SIZE &&
+           state->block_fill == (size_t) (state->total_size % BUILTIN_SHA1_BLOCK_SIZE);
+}
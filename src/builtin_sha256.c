@@ -0,0 +1,199 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "builtin_sha256.h"
+
+#include <string.h>
+
+#define SHA256_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static const unsigned int SHA256_ROUND_CONSTANTS[64] =
+{
+    0x428A2F98u, 0x71374491u, 0xB5C0FBCFu, 0xE9B5DBA5u, 0x3956C25Bu, 0x59F111F1u, 0x923F82A4u, 0xAB1C5ED5u,
+    0xD807AA98u, 0x12835B01u, 0x243185BEu, 0x550C7DC3u, 0x72BE5D74u, 0x80DEB1FEu, 0x9BDC06A7u, 0xC19BF174u,
+    0xE49B69C1u, 0xEFBE4786u, 0x0FC19DC6u, 0x240CA1CCu, 0x2DE92C6Fu, 0x4A7484AAu, 0x5CB0A9DCu, 0x76F988DAu,
+    0x983E5152u, 0xA831C66Du, 0xB00327C8u, 0xBF597FC7u, 0xC6E00BF3u, 0xD5A79147u, 0x06CA6351u, 0x14292967u,
+    0x27B70A85u, 0x2E1B2138u, 0x4D2C6DFCu, 0x53380D13u, 0x650A7354u, 0x766A0ABBu, 0x81C2C92Eu, 0x92722C85u,
+    0xA2BFE8A1u, 0xA81A664Bu, 0xC24B8B70u, 0xC76C51A3u, 0xD192E819u, 0xD6990624u, 0xF40E3585u, 0x106AA070u,
+    0x19A4C116u, 0x1E376C08u, 0x2748774Cu, 0x34B0BCB5u, 0x391C0CB3u, 0x4ED8AA4Au, 0x5B9CCA4Fu, 0x682E6FF3u,
+    0x748F82EEu, 0x78A5636Fu, 0x84C87814u, 0x8CC70208u, 0x90BEFFFAu, 0xA4506CEBu, 0xBEF9A3F7u, 0xC67178F2u
+};
+
+static
+void
+uhashtools_builtin_sha256_compress
+(
+    unsigned int* h,
+    const unsigned char* block
+)
+{
+    unsigned int w[64];
+    unsigned int a = h[0];
+    unsigned int b = h[1];
+    unsigned int c = h[2];
+    unsigned int d = h[3];
+    unsigned int e = h[4];
+    unsigned int f = h[5];
+    unsigned int g = h[6];
+    unsigned int hh = h[7];
+    int i = 0;
+
+    for (i = 0; i < 16; ++i)
+    {
+        w[i] = ((unsigned int) block[i * 4] << 24) |
+               ((unsigned int) block[i * 4 + 1] << 16) |
+               ((unsigned int) block[i * 4 + 2] << 8) |
+               (unsigned int) block[i * 4 + 3];
+    }
+
+    for (i = 16; i < 64; ++i)
+    {
+        const unsigned int s0 = SHA256_ROTR(w[i - 15], 7) ^ SHA256_ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const unsigned int s1 = SHA256_ROTR(w[i - 2], 17) ^ SHA256_ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    for (i = 0; i < 64; ++i)
+    {
+        const unsigned int s1 = SHA256_ROTR(e, 6) ^ SHA256_ROTR(e, 11) ^ SHA256_ROTR(e, 25);
+        const unsigned int ch = (e & f) ^ (~e & g);
+        const unsigned int t1 = hh + s1 + ch + SHA256_ROUND_CONSTANTS[i] + w[i];
+        const unsigned int s0 = SHA256_ROTR(a, 2) ^ SHA256_ROTR(a, 13) ^ SHA256_ROTR(a, 22);
+        const unsigned int maj = (a & b) ^ (a & c) ^ (b & c);
+        const unsigned int t2 = s0 + maj;
+
+        hh = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+    h[5] += f;
+    h[6] += g;
+    h[7] += hh;
+}
+
+void
+uhashtools_builtin_sha256_init
+(
+    struct BuiltinSha256State* state
+)
+{
+    state->h[0] = 0x6A09E667u;
+    state->h[1] = 0xBB67AE85u;
+    state->h[2] = 0x3C6EF372u;
+    state->h[3] = 0xA54FF53Au;
+    state->h[4] = 0x510E527Fu;
+    state->h[5] = 0x9B05688Cu;
+    state->h[6] = 0x1F83D9ABu;
+    state->h[7] = 0x5BE0CD19u;
+    state->total_size = 0;
+    state->block_fill = 0;
+}
+
+void
+uhashtools_builtin_sha256_update
+(
+    struct BuiltinSha256State* state,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    state->total_size += data_size;
+
+    if (state->block_fill > 0)
+    {
+        size_t copy_size = BUILTIN_SHA256_BLOCK_SIZE - state->block_fill;
+
+        if (copy_size > data_size)
+        {
+            copy_size = data_size;
+        }
+
+        (void) memcpy((void*) (state->block + state->block_fill), (const void*) data, copy_size);
+        state->block_fill += copy_size;
+        data += copy_size;
+        data_size -= copy_size;
+
+        if (state->block_fill < BUILTIN_SHA256_BLOCK_SIZE)
+        {
+            return;
+        }
+
+        uhashtools_builtin_sha256_compress(state->h, state->block);
+        state->block_fill = 0;
+    }
+
+    /* Full blocks are hashed directly from the input without copying them. */
+    while (data_size >= BUILTIN_SHA256_BLOCK_SIZE)
+    {
+        uhashtools_builtin_sha256_compress(state->h, data);
+        data += BUILTIN_SHA256_BLOCK_SIZE;
+        data_size -= BUILTIN_SHA256_BLOCK_SIZE;
+    }
+
+    (void) memcpy((void*) state->block, (const void*) data, data_size);
+    state->block_fill = data_size;
+}
+
+void
+uhashtools_builtin_sha256_finish
+(
+    struct BuiltinSha256State* state,
+    unsigned char* digest
+)
+{
+    const unsigned __int64 total_bits = state->total_size * 8;
+    int i = 0;
+
+    state->block[state->block_fill++] = 0x80;
+
+    if (state->block_fill > BUILTIN_SHA256_BLOCK_SIZE - 8)
+    {
+        (void) memset((void*) (state->block + state->block_fill), 0, BUILTIN_SHA256_BLOCK_SIZE - state->block_fill);
+        uhashtools_builtin_sha256_compress(state->h, state->block);
+        state->block_fill = 0;
+    }
+
+    (void) memset((void*) (state->block + state->block_fill), 0, BUILTIN_SHA256_BLOCK_SIZE - 8 - state->block_fill);
+
+    for (i = 0; i < 8; ++i)
+    {
+        state->block[BUILTIN_SHA256_BLOCK_SIZE - 1 - i] = (unsigned char) (total_bits >> (i * 8));
+    }
+
+    uhashtools_builtin_sha256_compress(state->h, state->block);
+
+    for (i = 0; i < 8; ++i)
+    {
+        digest[i * 4] = (unsigned char) (state->h[i] >> 24);
+        digest[i * 4 + 1] = (unsigned char) (state->h[i] >> 16);
+        digest[i * 4 + 2] = (unsigned char) (state->h[i] >> 8);
+        digest[i * 4 + 3] = (unsigned char) state->h[i];
+    }
+}
+
+BOOL
+uhashtools_builtin_sha256_is_state_valid
+(
+    const struct BuiltinSha256State* state
+)
+{
+    return state->block_fill < BUILTIN_SHA256_BLOCK_SIZE &&
+           state->block_fill == (size_t) (state->total_size % BUILTIN_SHA256_BLOCK_SIZE);
+}
@@ -0,0 +1,86 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+/*
+ * Built-in implementation of the SHA-256 hash algorithm (FIPS 180-4).
+ * It's used instead of the Windows CNG API if the application has
+ * been built with "HASH_BACKEND=Builtin" (see "makefile").
+ */
+
+#define BUILTIN_SHA256_DIGEST_SIZE 32
+#define BUILTIN_SHA256_BLOCK_SIZE 64
+
+struct BuiltinSha256State
+{
+    unsigned int h[8];
+    unsigned __int64 total_size;
+    unsigned char block[BUILTIN_SHA256_BLOCK_SIZE];
+    size_t block_fill;
+};
+
+/**
+ * Initializes the hash state for a new calculation.
+ * 
+ * @param state Hash state which should be initialized.
+ */
+extern
+void
+uhashtools_builtin_sha256_init
+(
+    struct BuiltinSha256State* state
+);
+
+/**
+ * Hashes the next part of the data.
+ * 
+ * @param state Initialized hash state.
+ * @param data Data which should be hashed.
+ * @param data_size Size of "data" in bytes.
+ */
+extern
+void
+uhashtools_builtin_sha256_update
+(
+    struct BuiltinSha256State* state,
+    const unsigned char* data,
+    size_t data_size
+);
+
+/**
+ * Finishes the calculation and writes the digest.
+ * 
+ * @param state Hash state. It must be initialized again before reusing it.
+ * @param digest Buffer of BUILTIN_SHA256_DIGEST_SIZE bytes which receives the digest.
+ */
+extern
+void
+uhashtools_builtin_sha256_finish
+(
+    struct BuiltinSha256State* state,
+    unsigned char* digest
+);
+
+/**
+ * Checks the counters of a hash state which hasn't been created by this
+ * process (for example a state which has been read from a file), so a
+ * damaged state is rejected before it's used.
+ * 
+ * @param state Hash state which should be checked.
+ * 
+ * @return TRUE if the state can be used else FALSE.
+ */
+extern
+BOOL
+uhashtools_builtin_sha256_is_state_valid
+(
+    const struct BuiltinSha256State* state
+);
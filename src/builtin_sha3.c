@@ -0,0 +1,308 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "builtin_sha3.h"
+
+#include <string.h>
+#include <Windows.h>
+
+#define SHA3_ROUNDS 24
+#define SHA3_LANE_SIZE 8
+
+/* Domain separation bits of SHA-3 and the first bit of the padding. */
+#define SHA3_PADDING_START 0x06
+#define SHA3_PADDING_END 0x80
+
+#define SHA3_ROTL64(x, n) (((x) << (n)) | ((x) >> (64 - (n))))
+/* Avoids the undefined shift by 64 for the lanes with a rotation offset of 0. */
+#define SHA3_ROTL64_SAFE(x, n) ((n) == 0 ? (x) : SHA3_ROTL64(x, n))
+
+/* Index of the lane in row "y" and column "x" of the state. */
+#define SHA3_LANE(y, x) ((y) * 5 + (x))
+
+static const unsigned __int64 SHA3_ROUND_CONSTANTS[SHA3_ROUNDS] =
+{
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+static const unsigned char SHA3_RHO_OFFSETS[5][5] =
+{
+    {  0,  1, 62, 28, 27 },
+    { 36, 44,  6, 55, 20 },
+    {  3, 10, 43, 25, 39 },
+    { 41, 45, 15, 21,  8 },
+    { 18,  2, 61, 56, 14 }
+};
+
+/*
+ * The permutation uses the lane complementing transform of the Keccak
+ * reference: The lanes below are kept complemented during the whole
+ * calculation, which replaces most NOT operations of the chi step with
+ * OR operations. They are only complemented back for the output.
+ */
+static const unsigned char SHA3_COMPLEMENTED_LANES[6] =
+{
+    SHA3_LANE(0, 1), SHA3_LANE(0, 2), SHA3_LANE(1, 3), SHA3_LANE(2, 2), SHA3_LANE(3, 2), SHA3_LANE(4, 0)
+};
+
+#define SHA3_THETA_RHO(a, d, y, x) SHA3_ROTL64_SAFE((a)[SHA3_LANE(y, x)] ^ (d)[x], SHA3_RHO_OFFSETS[y][x])
+
+/**
+ * Calculates one round of the permutation from the state "a" into the
+ * state "r". The theta, rho and pi steps are merged into loading the
+ * five lanes of each output row, the chi and iota steps are applied
+ * while writing the output row.
+ */
+static
+__forceinline
+void
+uhashtools_sha3_round
+(
+    unsigned __int64* r,
+    const unsigned __int64* a,
+    int round_index
+)
+{
+    unsigned __int64 c[5];
+    unsigned __int64 d[5];
+    int x = 0;
+
+    for (x = 0; x < 5; ++x)
+    {
+        c[x] = a[SHA3_LANE(0, x)] ^ a[SHA3_LANE(1, x)] ^ a[SHA3_LANE(2, x)] ^ a[SHA3_LANE(3, x)] ^ a[SHA3_LANE(4, x)];
+    }
+
+    d[0] = SHA3_ROTL64(c[1], 1) ^ c[4];
+    d[1] = SHA3_ROTL64(c[2], 1) ^ c[0];
+    d[2] = SHA3_ROTL64(c[3], 1) ^ c[1];
+    d[3] = SHA3_ROTL64(c[4], 1) ^ c[2];
+    d[4] = SHA3_ROTL64(c[0], 1) ^ c[3];
+
+    c[0] = SHA3_THETA_RHO(a, d, 0, 0);
+    c[1] = SHA3_THETA_RHO(a, d, 1, 1);
+    c[2] = SHA3_THETA_RHO(a, d, 2, 2);
+    c[3] = SHA3_THETA_RHO(a, d, 3, 3);
+    c[4] = SHA3_THETA_RHO(a, d, 4, 4);
+
+    r[SHA3_LANE(0, 0)] = c[0] ^ (c[1] | c[2]) ^ SHA3_ROUND_CONSTANTS[round_index];
+    r[SHA3_LANE(0, 1)] = c[1] ^ (~c[2] | c[3]);
+    r[SHA3_LANE(0, 2)] = c[2] ^ (c[3] & c[4]);
+    r[SHA3_LANE(0, 3)] = c[3] ^ (c[4] | c[0]);
+    r[SHA3_LANE(0, 4)] = c[4] ^ (c[0] & c[1]);
+
+    c[0] = SHA3_THETA_RHO(a, d, 0, 3);
+    c[1] = SHA3_THETA_RHO(a, d, 1, 4);
+    c[2] = SHA3_THETA_RHO(a, d, 2, 0);
+    c[3] = SHA3_THETA_RHO(a, d, 3, 1);
+    c[4] = SHA3_THETA_RHO(a, d, 4, 2);
+
+    r[SHA3_LANE(1, 0)] = c[0] ^ (c[1] | c[2]);
+    r[SHA3_LANE(1, 1)] = c[1] ^ (c[2] & c[3]);
+    r[SHA3_LANE(1, 2)] = c[2] ^ (c[3] | ~c[4]);
+    r[SHA3_LANE(1, 3)] = c[3] ^ (c[4] | c[0]);
+    r[SHA3_LANE(1, 4)] = c[4] ^ (c[0] & c[1]);
+
+    c[0] = SHA3_THETA_RHO(a, d, 0, 1);
+    c[1] = SHA3_THETA_RHO(a, d, 1, 2);
+    c[2] = SHA3_THETA_RHO(a, d, 2, 3);
+    c[3] = SHA3_THETA_RHO(a, d, 3, 4);
+    c[4] = SHA3_THETA_RHO(a, d, 4, 0);
+
+    r[SHA3_LANE(2, 0)] = c[0] ^ (c[1] | c[2]);
+    r[SHA3_LANE(2, 1)] = c[1] ^ (c[2] & c[3]);
+    r[SHA3_LANE(2, 2)] = c[2] ^ (~c[3] & c[4]);
+    r[SHA3_LANE(2, 3)] = ~c[3] ^ (c[4] | c[0]);
+    r[SHA3_LANE(2, 4)] = c[4] ^ (c[0] & c[1]);
+
+    c[0] = SHA3_THETA_RHO(a, d, 0, 4);
+    c[1] = SHA3_THETA_RHO(a, d, 1, 0);
+    c[2] = SHA3_THETA_RHO(a, d, 2, 1);
+    c[3] = SHA3_THETA_RHO(a, d, 3, 2);
+    c[4] = SHA3_THETA_RHO(a, d, 4, 3);
+
+    r[SHA3_LANE(3, 0)] = c[0] ^ (c[1] & c[2]);
+    r[SHA3_LANE(3, 1)] = c[1] ^ (c[2] | c[3]);
+    r[SHA3_LANE(3, 2)] = c[2] ^ (~c[3] | c[4]);
+    r[SHA3_LANE(3, 3)] = ~c[3] ^ (c[4] & c[0]);
+    r[SHA3_LANE(3, 4)] = c[4] ^ (c[0] | c[1]);
+
+    c[0] = SHA3_THETA_RHO(a, d, 0, 2);
+    c[1] = SHA3_THETA_RHO(a, d, 1, 3);
+    c[2] = SHA3_THETA_RHO(a, d, 2, 4);
+    c[3] = SHA3_THETA_RHO(a, d, 3, 0);
+    c[4] = SHA3_THETA_RHO(a, d, 4, 1);
+
+    r[SHA3_LANE(4, 0)] = c[0] ^ (~c[1] & c[2]);
+    r[SHA3_LANE(4, 1)] = ~c[1] ^ (c[2] | c[3]);
+    r[SHA3_LANE(4, 2)] = c[2] ^ (c[3] & c[4]);
+    r[SHA3_LANE(4, 3)] = c[3] ^ (c[4] | c[0]);
+    r[SHA3_LANE(4, 4)] = c[4] ^ (c[0] & c[1]);
+}
+
+static
+void
+uhashtools_sha3_permute
+(
+    unsigned __int64* lanes
+)
+{
+    unsigned __int64 temp_lanes[25];
+    int round_index = 0;
+
+    /* Alternates between both states instead of copying the result of every round back. */
+    for (round_index = 0; round_index < SHA3_ROUNDS; round_index += 2)
+    {
+        uhashtools_sha3_round(temp_lanes, lanes, round_index);
+        uhashtools_sha3_round(lanes, temp_lanes, round_index + 1);
+    }
+}
+
+static
+void
+uhashtools_sha3_absorb_block
+(
+    struct BuiltinSha3State* state,
+    const unsigned char* block
+)
+{
+    const size_t lane_count = state->rate / SHA3_LANE_SIZE;
+    size_t i = 0;
+
+    for (i = 0; i < lane_count; ++i)
+    {
+        /* Every target architecture of Windows is little endian. */
+        state->lanes[i] ^= *(const unsigned __int64 UNALIGNED*) (block + i * SHA3_LANE_SIZE);
+    }
+
+    uhashtools_sha3_permute(state->lanes);
+}
+
+static
+void
+uhashtools_sha3_init
+(
+    struct BuiltinSha3State* state,
+    size_t digest_size
+)
+{
+    size_t i = 0;
+
+    (void) memset((void*) state->lanes, 0, sizeof(state->lanes));
+
+    for (i = 0; i < sizeof(SHA3_COMPLEMENTED_LANES); ++i)
+    {
+        state->lanes[SHA3_COMPLEMENTED_LANES[i]] = ~0ULL;
+    }
+
+    state->rate = 200 - 2 * digest_size;
+    state->block_fill = 0;
+}
+
+void
+uhashtools_builtin_sha3_256_init
+(
+    struct BuiltinSha3State* state
+)
+{
+    uhashtools_sha3_init(state, BUILTIN_SHA3_256_DIGEST_SIZE);
+}
+
+void
+uhashtools_builtin_sha3_512_init
+(
+    struct BuiltinSha3State* state
+)
+{
+    uhashtools_sha3_init(state, BUILTIN_SHA3_512_DIGEST_SIZE);
+}
+
+void
+uhashtools_builtin_sha3_update
+(
+    struct BuiltinSha3State* state,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    if (state->block_fill > 0)
+    {
+        size_t copy_size = state->rate - state->block_fill;
+
+        if (copy_size > data_size)
+        {
+            copy_size = data_size;
+        }
+
+        (void) memcpy((void*) (state->block + state->block_fill), (const void*) data, copy_size);
+        state->block_fill += copy_size;
+        data += copy_size;
+        data_size -= copy_size;
+
+        if (state->block_fill < state->rate)
+        {
+            return;
+        }
+
+        uhashtools_sha3_absorb_block(state, state->block);
+        state->block_fill = 0;
+    }
+
+    /* Full blocks are absorbed directly from the input without copying them. */
+    while (data_size >= state->rate)
+    {
+        uhashtools_sha3_absorb_block(state, data);
+        data += state->rate;
+        data_size -= state->rate;
+    }
+
+    (void) memcpy((void*) state->block, (const void*) data, data_size);
+    state->block_fill = data_size;
+}
+
+void
+uhashtools_builtin_sha3_finish
+(
+    struct BuiltinSha3State* state,
+    unsigned char* digest,
+    size_t digest_size
+)
+{
+    size_t i = 0;
+
+    (void) memset((void*) (state->block + state->block_fill), 0, state->rate - state->block_fill);
+    state->block[state->block_fill] |= SHA3_PADDING_START;
+    state->block[state->rate - 1] |= SHA3_PADDING_END;
+    uhashtools_sha3_absorb_block(state, state->block);
+
+    for (i = 0; i < sizeof(SHA3_COMPLEMENTED_LANES); ++i)
+    {
+        state->lanes[SHA3_COMPLEMENTED_LANES[i]] = ~state->lanes[SHA3_COMPLEMENTED_LANES[i]];
+    }
+
+    /* The digest is always shorter than the rate, so a single squeeze is enough. */
+    for (i = 0; i < digest_size; ++i)
+    {
+        digest[i] = (unsigned char) (state->lanes[i / SHA3_LANE_SIZE] >> ((i % SHA3_LANE_SIZE) * 8));
+    }
+}
+
+BOOL
+uhashtools_builtin_sha3_is_state_valid
+(
+    const struct BuiltinSha3State* state,
+    size_t digest_size
+)
+{
+    return state->rate == 200 - 2 * digest_size &&
+           state->block_fill < state->rate;
+}
@@ -0,0 +1,110 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+/*
+ * Built-in implementation of the SHA3-256 and SHA3-512 hash algorithms
+ * (FIPS 202). Both variants are sharing the Keccak-f[1600] permutation
+ * which works on 64-bit lanes. The Windows CNG API provides SHA-3 only
+ * on newer Windows versions, so this implementation is also used if
+ * the algorithm provider isn't available.
+ */
+
+#define BUILTIN_SHA3_256_DIGEST_SIZE 32
+#define BUILTIN_SHA3_512_DIGEST_SIZE 64
+/* The rate (block size) of SHA3-256, which is the largest rate of both variants. */
+#define BUILTIN_SHA3_MAX_RATE 136
+
+struct BuiltinSha3State
+{
+    /* Some lanes are stored complemented, see "builtin_sha3.c". */
+    unsigned __int64 lanes[25];
+    size_t rate;
+    unsigned char block[BUILTIN_SHA3_MAX_RATE];
+    size_t block_fill;
+};
+
+/**
+ * Initializes the hash state for a new SHA3-256 calculation.
+ * 
+ * @param state Hash state which should be initialized.
+ */
+extern
+void
+uhashtools_builtin_sha3_256_init
+(
+    struct BuiltinSha3State* state
+);
+
+/**
+ * Initializes the hash state for a new SHA3-512 calculation.
+ * 
+ * @param state Hash state which should be initialized.
+ */
+extern
+void
+uhashtools_builtin_sha3_512_init
+(
+    struct BuiltinSha3State* state
+);
+
+/**
+ * Hashes the next part of the data. Used by both variants.
+ * 
+ * @param state Initialized hash state.
+ * @param data Data which should be hashed.
+ * @param data_size Size of "data" in bytes.
+ */
+extern
+void
+uhashtools_builtin_sha3_update
+(
+    struct BuiltinSha3State* state,
+    const unsigned char* data,
+    size_t data_size
+);
+
+/**
+ * Finishes the calculation and writes the digest.
+ * 
+ * @param state Hash state. It must be initialized again before reusing it.
+ * @param digest Buffer which receives the digest.
+ * @param digest_size BUILTIN_SHA3_256_DIGEST_SIZE for SHA3-256 or
+ *                    BUILTIN_SHA3_512_DIGEST_SIZE for SHA3-512. Must
+ *                    match the variant which initialized the state.
+ */
+extern
+void
+uhashtools_builtin_sha3_finish
+(
+    struct BuiltinSha3State* state,
+    unsigned char* digest,
+    size_t digest_size
+);
+
+/**
+ * Checks the counters of a hash state which hasn't been created by this
+ * process (for example a state which has been read from a file), so a
+ * damaged state is rejected before it's used.
+ * 
+ * @param state Hash state which should be checked.
+ * @param digest_size Digest size of the variant which should have
+ *                    initialized the state.
+ * 
+ * @return TRUE if the state can be used else FALSE.
+ */
+extern
+BOOL
+uhashtools_builtin_sha3_is_state_valid
+(
+    const struct BuiltinSha3State* state,
+    size_t digest_size
+);
@@ -0,0 +1,253 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "builtin_sha512.h"
+
+#include <string.h>
+
+#define SHA512_ROTR(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+static const unsigned __int64 SHA512_ROUND_CONSTANTS[80] =
+{
+    0x428A2F98D728AE22ULL, 0x7137449123EF65CDULL, 0xB5C0FBCFEC4D3B2FULL, 0xE9B5DBA58189DBBCULL,
+    0x3956C25BF348B538ULL, 0x59F111F1B605D019ULL, 0x923F82A4AF194F9BULL, 0xAB1C5ED5DA6D8118ULL,
+    0xD807AA98A3030242ULL, 0x12835B0145706FBEULL, 0x243185BE4EE4B28CULL, 0x550C7DC3D5FFB4E2ULL,
+    0x72BE5D74F27B896FULL, 0x80DEB1FE3B1696B1ULL, 0x9BDC06A725C71235ULL, 0xC19BF174CF692694ULL,
+    0xE49B69C19EF14AD2ULL, 0xEFBE4786384F25E3ULL, 0x0FC19DC68B8CD5B5ULL, 0x240CA1CC77AC9C65ULL,
+    0x2DE92C6F592B0275ULL, 0x4A7484AA6EA6E483ULL, 0x5CB0A9DCBD41FBD4ULL, 0x76F988DA831153B5ULL,
+    0x983E5152EE66DFABULL, 0xA831C66D2DB43210ULL, 0xB00327C898FB213FULL, 0xBF597FC7BEEF0EE4ULL,
+    0xC6E00BF33DA88FC2ULL, 0xD5A79147930AA725ULL, 0x06CA6351E003826FULL, 0x142929670A0E6E70ULL,
+    0x27B70A8546D22FFCULL, 0x2E1B21385C26C926ULL, 0x4D2C6DFC5AC42AEDULL, 0x53380D139D95B3DFULL,
+    0x650A73548BAF63DEULL, 0x766A0ABB3C77B2A8ULL, 0x81C2C92E47EDAEE6ULL, 0x92722C851482353BULL,
+    0xA2BFE8A14CF10364ULL, 0xA81A664BBC423001ULL, 0xC24B8B70D0F89791ULL, 0xC76C51A30654BE30ULL,
+    0xD192E819D6EF5218ULL, 0xD69906245565A910ULL, 0xF40E35855771202AULL, 0x106AA07032BBD1B8ULL,
+    0x19A4C116B8D2D0C8ULL, 0x1E376C085141AB53ULL, 0x2748774CDF8EEB99ULL, 0x34B0BCB5E19B48A8ULL,
+    0x391C0CB3C5C95A63ULL, 0x4ED8AA4AE3418ACBULL, 0x5B9CCA4F7763E373ULL, 0x682E6FF3D6B2B8A3ULL,
+    0x748F82EE5DEFB2FCULL, 0x78A5636F43172F60ULL, 0x84C87814A1F0AB72ULL, 0x8CC702081A6439ECULL,
+    0x90BEFFFA23631E28ULL, 0xA4506CEBDE82BDE9ULL, 0xBEF9A3F7B2C67915ULL, 0xC67178F2E372532BULL,
+    0xCA273ECEEA26619CULL, 0xD186B8C721C0C207ULL, 0xEADA7DD6CDE0EB1EULL, 0xF57D4F7FEE6ED178ULL,
+    0x06F067AA72176FBAULL, 0x0A637DC5A2C898A6ULL, 0x113F9804BEF90DAEULL, 0x1B710B35131C471BULL,
+    0x28DB77F523047D84ULL, 0x32CAAB7B40C72493ULL, 0x3C9EBE0A15C9BEBCULL, 0x431D67C49C100D4CULL,
+    0x4CC5D4BECB3E42B6ULL, 0x597F299CFC657E2AULL, 0x5FCB6FAB3AD6FAECULL, 0x6C44198C4A475817ULL
+};
+
+static
+void
+uhashtools_builtin_sha512_compress
+(
+    unsigned __int64* h,
+    const unsigned char* block
+)
+{
+    unsigned __int64 w[80];
+    unsigned __int64 a = h[0];
+    unsigned __int64 b = h[1];
+    unsigned __int64 c = h[2];
+    unsigned __int64 d = h[3];
+    unsigned __int64 e = h[4];
+    unsigned __int64 f = h[5];
+    unsigned __int64 g = h[6];
+    unsigned __int64 hh = h[7];
+    int i = 0;
+
+    for (i = 0; i < 16; ++i)
+    {
+        int byte_index = 0;
+
+        w[i] = 0;
+
+        for (byte_index = 0; byte_index < 8; ++byte_index)
+        {
+            w[i] = (w[i] << 8) | block[i * 8 + byte_index];
+        }
+    }
+
+    for (i = 16; i < 80; ++i)
+    {
+        const unsigned __int64 s0 = SHA512_ROTR(w[i - 15], 1) ^ SHA512_ROTR(w[i - 15], 8) ^ (w[i - 15] >> 7);
+        const unsigned __int64 s1 = SHA512_ROTR(w[i - 2], 19) ^ SHA512_ROTR(w[i - 2], 61) ^ (w[i - 2] >> 6);
+
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    for (i = 0; i < 80; ++i)
+    {
+        const unsigned __int64 s1 = SHA512_ROTR(e, 14) ^ SHA512_ROTR(e, 18) ^ SHA512_ROTR(e, 41);
+        const unsigned __int64 ch = (e & f) ^ (~e & g);
+        const unsigned __int64 t1 = hh + s1 + ch + SHA512_ROUND_CONSTANTS[i] + w[i];
+        const unsigned __int64 s0 = SHA512_ROTR(a, 28) ^ SHA512_ROTR(a, 34) ^ SHA512_ROTR(a, 39);
+        const unsigned __int64 maj = (a & b) ^ (a & c) ^ (b & c);
+        const unsigned __int64 t2 = s0 + maj;
+
+        hh = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+    h[5] += f;
+    h[6] += g;
+    h[7] += hh;
+}
+
+void
+uhashtools_builtin_sha512_init
+(
+    struct BuiltinSha512State* state
+)
+{
+    state->h[0] = 0x6A09E667F3BCC908ULL;
+    state->h[1] = 0xBB67AE8584CAA73BULL;
+    state->h[2] = 0x3C6EF372FE94F82BULL;
+    state->h[3] = 0xA54FF53A5F1D36F1ULL;
+    state->h[4] = 0x510E527FADE682D1ULL;
+    state->h[5] = 0x9B05688C2B3E6C1FULL;
+    state->h[6] = 0x1F83D9ABFB41BD6BULL;
+    state->h[7] = 0x5BE0CD19137E2179ULL;
+    state->total_size = 0;
+    state->block_fill = 0;
+}
+
+void
+uhashtools_builtin_sha384_init
+(
+    struct BuiltinSha512State* state
+)
+{
+    state->h[0] = 0xCBBB9D5DC1059ED8ULL;
+    state->h[1] = 0x629A292A367CD507ULL;
+    state->h[2] = 0x9159015A3070DD17ULL;
+    state->h[3] = 0x152FECD8F70E5939ULL;
+    state->h[4] = 0x67332667FFC00B31ULL;
+    state->h[5] = 0x8EB44A8768581511ULL;
+    state->h[6] = 0xDB0C2E0D64F98FA7ULL;
+    state->h[7] = 0x47B5481DBEFA4FA4ULL;
+    state->total_size = 0;
+    state->block_fill = 0;
+}
+
+void
+uhashtools_builtin_sha512_256_init
+(
+    struct BuiltinSha512State* state
+)
+{
+    state->h[0] = 0x22312194FC2BF72CULL;
+    state->h[1] = 0x9F555FA3C84C64C2ULL;
+    state->h[2] = 0x2393B86B6F53B151ULL;
+    state->h[3] = 0x963877195940EABDULL;
+    state->h[4] = 0x96283EE2A88EFFE3ULL;
+    state->h[5] = 0xBE5E1E2553863992ULL;
+    state->h[6] = 0x2B0199FC2C85B8AAULL;
+    state->h[7] = 0x0EB72DDC81C52CA2ULL;
+    state->total_size = 0;
+    state->block_fill = 0;
+}
+
+void
+uhashtools_builtin_sha512_update
+(
+    struct BuiltinSha512State* state,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    state->total_size += data_size;
+
+    if (state->block_fill > 0)
+    {
+        size_t copy_size = BUILTIN_SHA512_BLOCK_SIZE - state->block_fill;
+
+        if (copy_size > data_size)
+        {
+            copy_size = data_size;
+        }
+
+        (void) memcpy((void*) (state->block + state->block_fill), (const void*) data, copy_size);
+        state->block_fill += copy_size;
+        data += copy_size;
+        data_size -= copy_size;
+
+        if (state->block_fill < BUILTIN_SHA512_BLOCK_SIZE)
+        {
+            return;
+        }
+
+        uhashtools_builtin_sha512_compress(state->h, state->block);
+        state->block_fill = 0;
+    }
+
+    /* Full blocks are hashed directly from the input without copying them. */
+    while (data_size >= BUILTIN_SHA512_BLOCK_SIZE)
+    {
+        uhashtools_builtin_sha512_compress(state->h, data);
+        data += BUILTIN_SHA512_BLOCK_SIZE;
+        data_size -= BUILTIN_SHA512_BLOCK_SIZE;
+    }
+
+    (void) memcpy((void*) state->block, (const void*) data, data_size);
+    state->block_fill = data_size;
+}
+
+void
+uhashtools_builtin_sha512_finish
+(
+    struct BuiltinSha512State* state,
+    unsigned char* digest,
+    size_t digest_size
+)
+{
+    const unsigned __int64 total_bits = state->total_size * 8;
+    size_t i = 0;
+
+    state->block[state->block_fill++] = 0x80;
+
+    if (state->block_fill > BUILTIN_SHA512_BLOCK_SIZE - 16)
+    {
+        (void) memset((void*) (state->block + state->block_fill), 0, BUILTIN_SHA512_BLOCK_SIZE - state->block_fill);
+        uhashtools_builtin_sha512_compress(state->h, state->block);
+        state->block_fill = 0;
+    }
+
+    /* The length field has 128 bits, the upper bits are set from the byte count overflow. */
+    (void) memset((void*) (state->block + state->block_fill), 0, BUILTIN_SHA512_BLOCK_SIZE - 16 - state->block_fill);
+    (void) memset((void*) (state->block + BUILTIN_SHA512_BLOCK_SIZE - 16), 0, 7);
+    state->block[BUILTIN_SHA512_BLOCK_SIZE - 9] = (unsigned char) (state->total_size >> 61);
+
+    for (i = 0; i < 8; ++i)
+    {
+        state->block[BUILTIN_SHA512_BLOCK_SIZE - 1 - i] = (unsigned char) (total_bits >> (i * 8));
+    }
+
+    uhashtools_builtin_sha512_compress(state->h, state->block);
+
+    /* The truncated variants are only using the first bytes of the digest. */
+    for (i = 0; i < digest_size; ++i)
+    {
+        digest[i] = (unsigned char) (state->h[i / 8] >> (56 - (i % 8) * 8));
+    }
+}
+
+BOOL
+uhashtools_builtin_sha512_is_state_valid
+(
+    const struct BuiltinSha512State* state
+)
+{
+    return state->block_fill < BUILTIN_SHA512_BLOCK_SIZE &&
+           state->block_fill == (size_t) (state->total_size % BUILTIN_SHA512_BLOCK_SIZE);
+}
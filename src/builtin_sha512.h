@@ -0,0 +1,119 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+/*
+ * Built-in implementation of the SHA-512 hash algorithm and its
+ * truncated variants SHA-384 and SHA-512/256 (FIPS 180-4). All
+ * variants are sharing the compression function which works on
+ * 64-bit words and is therefore faster than SHA-256 on 64-bit CPUs
+ * without SHA instruction set extensions. SHA-512/256 isn't provided
+ * by the Windows CNG API, so it always uses this implementation. The
+ * other variants are only using it if the application has been built
+ * with "HASH_BACKEND=Builtin" (see "makefile").
+ */
+
+#define BUILTIN_SHA512_DIGEST_SIZE 64
+#define BUILTIN_SHA384_DIGEST_SIZE 48
+#define BUILTIN_SHA512_256_DIGEST_SIZE 32
+#define BUILTIN_SHA512_BLOCK_SIZE 128
+
+struct BuiltinSha512State
+{
+    unsigned __int64 h[8];
+    unsigned __int64 total_size;
+    unsigned char block[BUILTIN_SHA512_BLOCK_SIZE];
+    size_t block_fill;
+};
+
+/**
+ * Initializes the hash state for a new SHA-512 calculation.
+ * 
+ * @param state Hash state which should be initialized.
+ */
+extern
+void
+uhashtools_builtin_sha512_init
+(
+    struct BuiltinSha512State* state
+);
+
+/**
+ * Initializes the hash state for a new SHA-384 calculation.
+ * 
+ * @param state Hash state which should be initialized.
+ */
+extern
+void
+uhashtools_builtin_sha384_init
+(
+    struct BuiltinSha512State* state
+);
+
+/**
+ * Initializes the hash state for a new SHA-512/256 calculation.
+ * 
+ * @param state Hash state which should be initialized.
+ */
+extern
+void
+uhashtools_builtin_sha512_256_init
+(
+    struct BuiltinSha512State* state
+);
+
+/**
+ * Hashes the next part of the data. Used by all variants.
+ * 
+ * @param state Initialized hash state.
+ * @param data Data which should be hashed.
+ * @param data_size Size of "data" in bytes.
+ */
+extern
+void
+uhashtools_builtin_sha512_update
+(
+    struct BuiltinSha512State* state,
+    const unsigned char* data,
+    size_t data_size
+);
+
+/**
+ * Finishes the calculation and writes the digest. Used by all variants.
+ * 
+ * @param state Hash state. It must be initialized again before reusing it.
+ * @param digest Buffer which receives the digest.
+ * @param digest_size Digest size of the variant (see "BUILTIN_SHA*_DIGEST_SIZE").
+ */
+extern
+void
+uhashtools_builtin_sha512_finish
+(
+    struct BuiltinSha512State* state,
+    unsigned char* digest,
+    size_t digest_size
+);
+
+/**
+ * Checks the counters of a hash state which hasn't been created by this
+ * process (for example a state which has been read from a file), so a
+ * damaged state is rejected before it's used.
+ * 
+ * @param state Hash state which should be checked.
+ * 
+ * @return TRUE if the state can be used else FALSE.
+ */
+extern
+BOOL
+uhashtools_builtin_sha512_is_state_valid
+(
+    const struct BuiltinSha512State* state
+);
@@ -0,0 +1,780 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "builtin_xxh3.h"
+
+#include <string.h>
+#include <Windows.h>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+
+#define XXH3_HAS_SSE2_IMPL
+#endif
+
+#if defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#define XXH3_STRIPE_SIZE 64
+#define XXH3_SECRET_SIZE 192
+#define XXH3_SECRET_SIZE_MIN 136
+#define XXH3_SECRET_CONSUME_RATE 8
+#define XXH3_STRIPES_PER_BLOCK ((XXH3_SECRET_SIZE - XXH3_STRIPE_SIZE) / XXH3_SECRET_CONSUME_RATE)
+#define XXH3_MIDSIZE_MAX 240
+#define XXH3_MIDSIZE_START_OFFSET 3
+#define XXH3_MIDSIZE_LAST_OFFSET 17
+#define XXH3_SECRET_MERGEACCS_START 11
+#define XXH3_SECRET_LASTACC_START 7
+
+#define XXH_PRIME32_1 0x9E3779B1u
+#define XXH_PRIME32_2 0x85EBCA77u
+#define XXH_PRIME32_3 0xC2B2AE3Du
+#define XXH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define XXH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME64_3 0x165667B19E3779F9ULL
+#define XXH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME64_5 0x27D4EB2F165667C5ULL
+#define XXH_PRIME_MX1 0x165667919E3779F9ULL
+#define XXH_PRIME_MX2 0x9FB21C651E98DF25ULL
+
+#define XXH3_ROTL32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+#define XXH3_ROTL64(x, n) (((x) << (n)) | ((x) >> (64 - (n))))
+
+struct Xxh3Hash128
+{
+    unsigned __int64 low;
+    unsigned __int64 high;
+};
+
+/* Default secret of the XXH3 specification. */
+static const unsigned char XXH3_SECRET[XXH3_SECRET_SIZE] =
+{
+    0xB8, 0xFE, 0x6C, 0x39, 0x23, 0xA4, 0x4B, 0xBE, 0x7C, 0x01, 0x81, 0x2C, 0xF7, 0x21, 0xAD, 0x1C,
+    0xDE, 0xD4, 0x6D, 0xE9, 0x83, 0x90, 0x97, 0xDB, 0x72, 0x40, 0xA4, 0xA4, 0xB7, 0xB3, 0x67, 0x1F,
+    0xCB, 0x79, 0xE6, 0x4E, 0xCC, 0xC0, 0xE5, 0x78, 0x82, 0x5A, 0xD0, 0x7D, 0xCC, 0xFF, 0x72, 0x21,
+    0xB8, 0x08, 0x46, 0x74, 0xF7, 0x43, 0x24, 0x8E, 0xE0, 0x35, 0x90, 0xE6, 0x81, 0x3A, 0x26, 0x4C,
+    0x3C, 0x28, 0x52, 0xBB, 0x91, 0xC3, 0x00, 0xCB, 0x88, 0xD0, 0x65, 0x8B, 0x1B, 0x53, 0x2E, 0xA3,
+    0x71, 0x64, 0x48, 0x97, 0xA2, 0x0D, 0xF9, 0x4E, 0x38, 0x19, 0xEF, 0x46, 0xA9, 0xDE, 0xAC, 0xD8,
+    0xA8, 0xFA, 0x76, 0x3F, 0xE3, 0x9C, 0x34, 0x3F, 0xF9, 0xDC, 0xBB, 0xC7, 0xC7, 0x0B, 0x4F, 0x1D,
+    0x8A, 0x51, 0xE0, 0x4B, 0xCD, 0xB4, 0x59, 0x31, 0xC8, 0x9F, 0x7E, 0xC9, 0xD9, 0x78, 0x73, 0x64,
+    0xEA, 0xC5, 0xAC, 0x83, 0x34, 0xD3, 0xEB, 0xC3, 0xC5, 0x81, 0xA0, 0xFF, 0xFA, 0x13, 0x63, 0xEB,
+    0x17, 0x0D, 0xDD, 0x51, 0xB7, 0xF0, 0xDA, 0x49, 0xD3, 0x16, 0x55, 0x26, 0x29, 0xD4, 0x68, 0x9E,
+    0x2B, 0x16, 0xBE, 0x58, 0x7D, 0x47, 0xA1, 0xFC, 0x8F, 0xF8, 0xB8, 0xD1, 0x7A, 0xD0, 0x31, 0xCE,
+    0x45, 0xCB, 0x3A, 0x8F, 0x95, 0x16, 0x04, 0x28, 0xAF, 0xD7, 0xFB, 0xCA, 0xBB, 0x4B, 0x40, 0x7E
+};
+
+static
+__forceinline
+unsigned int
+uhashtools_xxh3_read32
+(
+    const unsigned char* data
+)
+{
+    /* Every target architecture of Windows is little endian. */
+    return *(const unsigned int UNALIGNED*) data;
+}
+
+static
+__forceinline
+unsigned __int64
+uhashtools_xxh3_read64
+(
+    const unsigned char* data
+)
+{
+    return *(const unsigned __int64 UNALIGNED*) data;
+}
+
+static
+unsigned int
+uhashtools_xxh3_swap32
+(
+    unsigned int value
+)
+{
+    return (value >> 24) | ((value >> 8) & 0x0000FF00u) | ((value << 8) & 0x00FF0000u) | (value << 24);
+}
+
+static
+unsigned __int64
+uhashtools_xxh3_swap64
+(
+    unsigned __int64 value
+)
+{
+    return ((unsigned __int64) uhashtools_xxh3_swap32((unsigned int) value) << 32)
+           | uhashtools_xxh3_swap32((unsigned int) (value >> 32));
+}
+
+static
+__forceinline
+struct Xxh3Hash128
+uhashtools_xxh3_multiply_64_to_128
+(
+    unsigned __int64 a,
+    unsigned __int64 b
+)
+{
+    struct Xxh3Hash128 product;
+
+#if defined(_M_X64)
+    product.low = _umul128(a, b, &product.high);
+#else
+    const unsigned __int64 low_low = (a & 0xFFFFFFFFu) * (b & 0xFFFFFFFFu);
+    const unsigned __int64 high_low = (a >> 32) * (b & 0xFFFFFFFFu);
+    const unsigned __int64 low_high = (a & 0xFFFFFFFFu) * (b >> 32);
+    const unsigned __int64 high_high = (a >> 32) * (b >> 32);
+    const unsigned __int64 cross = (low_low >> 32) + (high_low & 0xFFFFFFFFu) + low_high;
+
+    product.high = (high_low >> 32) + (cross >> 32) + high_high;
+    product.low = (cross << 32) | (low_low & 0xFFFFFFFFu);
+#endif
+
+    return product;
+}
+
+static
+__forceinline
+unsigned __int64
+uhashtools_xxh3_multiply_fold_64
+(
+    unsigned __int64 a,
+    unsigned __int64 b
+)
+{
+    const struct Xxh3Hash128 product = uhashtools_xxh3_multiply_64_to_128(a, b);
+
+    return product.low ^ product.high;
+}
+
+static
+unsigned __int64
+uhashtools_xxh64_avalanche
+(
+    unsigned __int64 hash
+)
+{
+    hash ^= hash >> 33;
+    hash *= XXH_PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= XXH_PRIME64_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+static
+unsigned __int64
+uhashtools_xxh3_avalanche
+(
+    unsigned __int64 hash
+)
+{
+    hash ^= hash >> 37;
+    hash *= XXH_PRIME_MX1;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+static
+unsigned __int64
+uhashtools_xxh3_rrmxmx
+(
+    unsigned __int64 hash,
+    unsigned __int64 length
+)
+{
+    hash ^= XXH3_ROTL64(hash, 49) ^ XXH3_ROTL64(hash, 24);
+    hash *= XXH_PRIME_MX2;
+    hash ^= (hash >> 35) + length;
+    hash *= XXH_PRIME_MX2;
+    hash ^= hash >> 28;
+
+    return hash;
+}
+
+static
+__forceinline
+unsigned __int64
+uhashtools_xxh3_mix_16_bytes
+(
+    const unsigned char* input,
+    const unsigned char* secret
+)
+{
+    return uhashtools_xxh3_multiply_fold_64(uhashtools_xxh3_read64(input) ^ uhashtools_xxh3_read64(secret),
+                                            uhashtools_xxh3_read64(input + 8) ^ uhashtools_xxh3_read64(secret + 8));
+}
+
+static
+void
+uhashtools_xxh3_mix_32_bytes
+(
+    struct Xxh3Hash128* acc,
+    const unsigned char* input_1,
+    const unsigned char* input_2,
+    const unsigned char* secret
+)
+{
+    acc->low += uhashtools_xxh3_mix_16_bytes(input_1, secret);
+    acc->low ^= uhashtools_xxh3_read64(input_2) + uhashtools_xxh3_read64(input_2 + 8);
+    acc->high += uhashtools_xxh3_mix_16_bytes(input_2, secret + 16);
+    acc->high ^= uhashtools_xxh3_read64(input_1) + uhashtools_xxh3_read64(input_1 + 8);
+}
+
+/* XXH3-64 of inputs up to XXH3_MIDSIZE_MAX bytes. */
+static
+unsigned __int64
+uhashtools_xxh3_hash_short_64
+(
+    const unsigned char* input,
+    size_t length
+)
+{
+    const unsigned char* const secret = XXH3_SECRET;
+    unsigned __int64 acc = 0;
+    size_t i = 0;
+
+    if (length > 128)
+    {
+        const size_t rounds = length / 16;
+        unsigned __int64 acc_end = 0;
+
+        acc = length * XXH_PRIME64_1;
+
+        for (i = 0; i < 8; ++i)
+        {
+            acc += uhashtools_xxh3_mix_16_bytes(input + 16 * i, secret + 16 * i);
+        }
+
+        acc = uhashtools_xxh3_avalanche(acc);
+        acc_end = uhashtools_xxh3_mix_16_bytes(input + length - 16, secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LAST_OFFSET);
+
+        for (i = 8; i < rounds; ++i)
+        {
+            acc_end += uhashtools_xxh3_mix_16_bytes(input + 16 * i, secret + 16 * (i - 8) + XXH3_MIDSIZE_START_OFFSET);
+        }
+
+        return uhashtools_xxh3_avalanche(acc + acc_end);
+    }
+
+    if (length > 16)
+    {
+        acc = length * XXH_PRIME64_1;
+
+        if (length > 32)
+        {
+            if (length > 64)
+            {
+                if (length > 96)
+                {
+                    acc += uhashtools_xxh3_mix_16_bytes(input + 48, secret + 96);
+                    acc += uhashtools_xxh3_mix_16_bytes(input + length - 64, secret + 112);
+                }
+
+                acc += uhashtools_xxh3_mix_16_bytes(input + 32, secret + 64);
+                acc += uhashtools_xxh3_mix_16_bytes(input + length - 48, secret + 80);
+            }
+
+            acc += uhashtools_xxh3_mix_16_bytes(input + 16, secret + 32);
+            acc += uhashtools_xxh3_mix_16_bytes(input + length - 32, secret + 48);
+        }
+
+        acc += uhashtools_xxh3_mix_16_bytes(input, secret);
+        acc += uhashtools_xxh3_mix_16_bytes(input + length - 16, secret + 16);
+
+        return uhashtools_xxh3_avalanche(acc);
+    }
+
+    if (length > 8)
+    {
+        const unsigned __int64 input_low = uhashtools_xxh3_read64(input)
+                                           ^ uhashtools_xxh3_read64(secret + 24)
+                                           ^ uhashtools_xxh3_read64(secret + 32);
+        const unsigned __int64 input_high = uhashtools_xxh3_read64(input + length - 8)
+                                            ^ uhashtools_xxh3_read64(secret + 40)
+                                            ^ uhashtools_xxh3_read64(secret + 48);
+
+        acc = length + uhashtools_xxh3_swap64(input_low) + input_high
+              + uhashtools_xxh3_multiply_fold_64(input_low, input_high);
+
+        return uhashtools_xxh3_avalanche(acc);
+    }
+
+    if (length >= 4)
+    {
+        const unsigned __int64 input_64 = uhashtools_xxh3_read32(input + length - 4)
+                                          + ((unsigned __int64) uhashtools_xxh3_read32(input) << 32);
+        const unsigned __int64 bitflip = uhashtools_xxh3_read64(secret + 8) ^ uhashtools_xxh3_read64(secret + 16);
+
+        return uhashtools_xxh3_rrmxmx(input_64 ^ bitflip, length);
+    }
+
+    if (length > 0)
+    {
+        const unsigned int combined = ((unsigned int) input[0] << 16)
+                                      | ((unsigned int) input[length >> 1] << 24)
+                                      | (unsigned int) input[length - 1]
+                                      | ((unsigned int) length << 8);
+        const unsigned int bitflip = uhashtools_xxh3_read32(secret) ^ uhashtools_xxh3_read32(secret + 4);
+
+        return uhashtools_xxh64_avalanche(combined ^ bitflip);
+    }
+
+    return uhashtools_xxh64_avalanche(uhashtools_xxh3_read64(secret + 56) ^ uhashtools_xxh3_read64(secret + 64));
+}
+
+/* XXH3-128 of inputs up to XXH3_MIDSIZE_MAX bytes. */
+static
+struct Xxh3Hash128
+uhashtools_xxh3_hash_short_128
+(
+    const unsigned char* input,
+    size_t length
+)
+{
+    const unsigned char* const secret = XXH3_SECRET;
+    struct Xxh3Hash128 acc;
+    struct Xxh3Hash128 result;
+    size_t i = 0;
+
+    if (length > 16)
+    {
+        acc.low = length * XXH_PRIME64_1;
+        acc.high = 0;
+
+        if (length > 128)
+        {
+            for (i = 32; i < 160; i += 32)
+            {
+                uhashtools_xxh3_mix_32_bytes(&acc, input + i - 32, input + i - 16, secret + i - 32);
+            }
+
+            acc.low = uhashtools_xxh3_avalanche(acc.low);
+            acc.high = uhashtools_xxh3_avalanche(acc.high);
+
+            for (i = 160; i <= length; i += 32)
+            {
+                uhashtools_xxh3_mix_32_bytes(&acc,
+                                             input + i - 32,
+                                             input + i - 16,
+                                             secret + XXH3_MIDSIZE_START_OFFSET + i - 160);
+            }
+
+            uhashtools_xxh3_mix_32_bytes(&acc,
+                                         input + length - 16,
+                                         input + length - 32,
+                                         secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LAST_OFFSET - 16);
+        }
+        else
+        {
+            if (length > 32)
+            {
+                if (length > 64)
+                {
+                    if (length > 96)
+                    {
+                        uhashtools_xxh3_mix_32_bytes(&acc, input + 48, input + length - 64, secret + 96);
+                    }
+
+                    uhashtools_xxh3_mix_32_bytes(&acc, input + 32, input + length - 48, secret + 64);
+                }
+
+                uhashtools_xxh3_mix_32_bytes(&acc, input + 16, input + length - 32, secret + 32);
+            }
+
+            uhashtools_xxh3_mix_32_bytes(&acc, input, input + length - 16, secret);
+        }
+
+        result.low = uhashtools_xxh3_avalanche(acc.low + acc.high);
+        result.high = 0 - uhashtools_xxh3_avalanche(acc.low * XXH_PRIME64_1
+                                                    + acc.high * XXH_PRIME64_4
+                                                    + length * XXH_PRIME64_2);
+        return result;
+    }
+
+    if (length > 8)
+    {
+        const unsigned __int64 bitflip_low = uhashtools_xxh3_read64(secret + 32) ^ uhashtools_xxh3_read64(secret + 40);
+        const unsigned __int64 bitflip_high = uhashtools_xxh3_read64(secret + 48) ^ uhashtools_xxh3_read64(secret + 56);
+        const unsigned __int64 input_low = uhashtools_xxh3_read64(input);
+        const unsigned __int64 input_high = uhashtools_xxh3_read64(input + length - 8);
+        const unsigned __int64 keyed_high = input_high ^ bitflip_high;
+
+        acc = uhashtools_xxh3_multiply_64_to_128(input_low ^ input_high ^ bitflip_low, XXH_PRIME64_1);
+        acc.low += (unsigned __int64) (length - 1) << 54;
+        acc.high += keyed_high + (unsigned __int64) (unsigned int) keyed_high * (XXH_PRIME32_2 - 1);
+        acc.low ^= uhashtools_xxh3_swap64(acc.high);
+
+        result = uhashtools_xxh3_multiply_64_to_128(acc.low, XXH_PRIME64_2);
+        result.high += acc.high * XXH_PRIME64_2;
+        result.low = uhashtools_xxh3_avalanche(result.low);
+        result.high = uhashtools_xxh3_avalanche(result.high);
+        return result;
+    }
+
+    if (length >= 4)
+    {
+        const unsigned __int64 input_64 = uhashtools_xxh3_read32(input)
+                                          + ((unsigned __int64) uhashtools_xxh3_read32(input + length - 4) << 32);
+        const unsigned __int64 bitflip = uhashtools_xxh3_read64(secret + 16) ^ uhashtools_xxh3_read64(secret + 24);
+
+        result = uhashtools_xxh3_multiply_64_to_128(input_64 ^ bitflip, XXH_PRIME64_1 + ((unsigned __int64) length << 2));
+        result.high += result.low << 1;
+        result.low ^= result.high >> 3;
+        result.low ^= result.low >> 35;
+        result.low *= XXH_PRIME_MX2;
+        result.low ^= result.low >> 28;
+        result.high = uhashtools_xxh3_avalanche(result.high);
+        return result;
+    }
+
+    if (length > 0)
+    {
+        const unsigned int combined_low = ((unsigned int) input[0] << 16)
+                                          | ((unsigned int) input[length >> 1] << 24)
+                                          | (unsigned int) input[length - 1]
+                                          | ((unsigned int) length << 8);
+        const unsigned int swapped = uhashtools_xxh3_swap32(combined_low);
+        const unsigned int combined_high = XXH3_ROTL32(swapped, 13);
+
+        result.low = uhashtools_xxh64_avalanche(combined_low ^ (uhashtools_xxh3_read32(secret) ^ uhashtools_xxh3_read32(secret + 4)));
+        result.high = uhashtools_xxh64_avalanche(combined_high ^ (uhashtools_xxh3_read32(secret + 8) ^ uhashtools_xxh3_read32(secret + 12)));
+        return result;
+    }
+
+    result.low = uhashtools_xxh64_avalanche(uhashtools_xxh3_read64(secret + 64) ^ uhashtools_xxh3_read64(secret + 72));
+    result.high = uhashtools_xxh64_avalanche(uhashtools_xxh3_read64(secret + 80) ^ uhashtools_xxh3_read64(secret + 88));
+    return result;
+}
+
+/*
+ * Accumulates "stripes_count" stripes of 64 bytes. The secret advances by
+ * XXH3_SECRET_CONSUME_RATE bytes for every stripe.
+ */
+static
+void
+uhashtools_xxh3_accumulate
+(
+    unsigned __int64* acc,
+    const unsigned char* input,
+    const unsigned char* secret,
+    size_t stripes_count
+)
+{
+#ifdef XXH3_HAS_SSE2_IMPL
+    __m128i acc_vec[4];
+    size_t stripe = 0;
+    int i = 0;
+
+    for (i = 0; i < 4; ++i)
+    {
+        acc_vec[i] = _mm_loadu_si128((const __m128i*) acc + i);
+    }
+
+    for (stripe = 0; stripe < stripes_count; ++stripe)
+    {
+        const __m128i* const input_vec = (const __m128i*) (input + stripe * XXH3_STRIPE_SIZE);
+        const __m128i* const secret_vec = (const __m128i*) (secret + stripe * XXH3_SECRET_CONSUME_RATE);
+
+        for (i = 0; i < 4; ++i)
+        {
+            const __m128i data = _mm_loadu_si128(input_vec + i);
+            const __m128i data_key = _mm_xor_si128(data, _mm_loadu_si128(secret_vec + i));
+            const __m128i data_key_high = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+            const __m128i product = _mm_mul_epu32(data_key, data_key_high);
+            const __m128i data_swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+
+            acc_vec[i] = _mm_add_epi64(product, _mm_add_epi64(acc_vec[i], data_swapped));
+        }
+    }
+
+    for (i = 0; i < 4; ++i)
+    {
+        _mm_storeu_si128((__m128i*) acc + i, acc_vec[i]);
+    }
+#else
+    size_t stripe = 0;
+    int i = 0;
+
+    for (stripe = 0; stripe < stripes_count; ++stripe)
+    {
+        const unsigned char* const stripe_input = input + stripe * XXH3_STRIPE_SIZE;
+        const unsigned char* const stripe_secret = secret + stripe * XXH3_SECRET_CONSUME_RATE;
+
+        for (i = 0; i < 8; ++i)
+        {
+            const unsigned __int64 data = uhashtools_xxh3_read64(stripe_input + i * 8);
+            const unsigned __int64 data_key = data ^ uhashtools_xxh3_read64(stripe_secret + i * 8);
+
+            acc[i ^ 1] += data;
+            acc[i] += (data_key & 0xFFFFFFFFu) * (data_key >> 32);
+        }
+    }
+#endif
+}
+
+static
+void
+uhashtools_xxh3_scramble
+(
+    unsigned __int64* acc,
+    const unsigned char* secret
+)
+{
+#ifdef XXH3_HAS_SSE2_IMPL
+    const __m128i prime = _mm_set1_epi32((int) XXH_PRIME32_1);
+    int i = 0;
+
+    for (i = 0; i < 4; ++i)
+    {
+        const __m128i acc_vec = _mm_loadu_si128((const __m128i*) acc + i);
+        const __m128i data = _mm_xor_si128(acc_vec, _mm_srli_epi64(acc_vec, 47));
+        const __m128i data_key = _mm_xor_si128(data, _mm_loadu_si128((const __m128i*) secret + i));
+        const __m128i data_key_high = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+        const __m128i product_low = _mm_mul_epu32(data_key, prime);
+        const __m128i product_high = _mm_mul_epu32(data_key_high, prime);
+
+        _mm_storeu_si128((__m128i*) acc + i, _mm_add_epi64(product_low, _mm_slli_epi64(product_high, 32)));
+    }
+#else
+    int i = 0;
+
+    for (i = 0; i < 8; ++i)
+    {
+        unsigned __int64 value = acc[i];
+
+        value ^= value >> 47;
+        value ^= uhashtools_xxh3_read64(secret + i * 8);
+        value *= XXH_PRIME32_1;
+        acc[i] = value;
+    }
+#endif
+}
+
+/*
+ * Accumulates complete stripes and scrambles the accumulators every time
+ * a block of XXH3_STRIPES_PER_BLOCK stripes is completed.
+ */
+static
+void
+uhashtools_xxh3_consume_stripes
+(
+    struct BuiltinXxh3State* state,
+    const unsigned char* input,
+    size_t stripes_count
+)
+{
+    while (stripes_count > 0)
+    {
+        size_t block_stripes_left = XXH3_STRIPES_PER_BLOCK - state->block_stripes;
+
+        if (block_stripes_left > stripes_count)
+        {
+            block_stripes_left = stripes_count;
+        }
+
+        uhashtools_xxh3_accumulate(state->acc,
+                                   input,
+                                   XXH3_SECRET + state->block_stripes * XXH3_SECRET_CONSUME_RATE,
+                                   block_stripes_left);
+
+        input += block_stripes_left * XXH3_STRIPE_SIZE;
+        stripes_count -= block_stripes_left;
+        state->block_stripes += block_stripes_left;
+
+        if (state->block_stripes == XXH3_STRIPES_PER_BLOCK)
+        {
+            uhashtools_xxh3_scramble(state->acc, XXH3_SECRET + XXH3_SECRET_SIZE - XXH3_STRIPE_SIZE);
+            state->block_stripes = 0;
+        }
+    }
+}
+
+static
+unsigned __int64
+uhashtools_xxh3_merge_accs
+(
+    const unsigned __int64* acc,
+    const unsigned char* secret,
+    unsigned __int64 start
+)
+{
+    unsigned __int64 result = start;
+    int i = 0;
+
+    for (i = 0; i < 4; ++i)
+    {
+        result += uhashtools_xxh3_multiply_fold_64(acc[2 * i] ^ uhashtools_xxh3_read64(secret + 16 * i),
+                                                   acc[2 * i + 1] ^ uhashtools_xxh3_read64(secret + 16 * i + 8));
+    }
+
+    return uhashtools_xxh3_avalanche(result);
+}
+
+static
+void
+uhashtools_xxh3_write_big_endian_64
+(
+    unsigned char* out,
+    unsigned __int64 value
+)
+{
+    int i = 0;
+
+    for (i = 0; i < 8; ++i)
+    {
+        out[i] = (unsigned char) (value >> (56 - i * 8));
+    }
+}
+
+void
+uhashtools_builtin_xxh3_init
+(
+    struct BuiltinXxh3State* state
+)
+{
+    state->acc[0] = XXH_PRIME32_3;
+    state->acc[1] = XXH_PRIME64_1;
+    state->acc[2] = XXH_PRIME64_2;
+    state->acc[3] = XXH_PRIME64_3;
+    state->acc[4] = XXH_PRIME64_4;
+    state->acc[5] = XXH_PRIME32_2;
+    state->acc[6] = XXH_PRIME64_5;
+    state->acc[7] = XXH_PRIME32_1;
+    state->total_size = 0;
+    state->buffer_fill = 0;
+    state->block_stripes = 0;
+}
+
+void
+uhashtools_builtin_xxh3_update
+(
+    struct BuiltinXxh3State* state,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    state->total_size += data_size;
+
+    /*
+     * The last stripe is processed differently, so stripes are only
+     * consumed if it's known that more data follows.
+     */
+    if (state->buffer_fill + data_size <= BUILTIN_XXH3_BUFFER_SIZE)
+    {
+        (void) memcpy((void*) (state->buffer + state->buffer_fill), (const void*) data, data_size);
+        state->buffer_fill += data_size;
+        return;
+    }
+
+    if (state->buffer_fill > 0)
+    {
+        const size_t fill_size = BUILTIN_XXH3_BUFFER_SIZE - state->buffer_fill;
+
+        (void) memcpy((void*) (state->buffer + state->buffer_fill), (const void*) data, fill_size);
+        data += fill_size;
+        data_size -= fill_size;
+
+        uhashtools_xxh3_consume_stripes(state, state->buffer, BUILTIN_XXH3_BUFFER_SIZE / XXH3_STRIPE_SIZE);
+        state->buffer_fill = 0;
+    }
+
+    if (data_size > BUILTIN_XXH3_BUFFER_SIZE)
+    {
+        const size_t stripes_count = (data_size - 1) / XXH3_STRIPE_SIZE;
+
+        /* The data is hashed in place, so only the remaining tail gets copied. */
+        uhashtools_xxh3_consume_stripes(state, data, stripes_count);
+        data += stripes_count * XXH3_STRIPE_SIZE;
+        data_size -= stripes_count * XXH3_STRIPE_SIZE;
+
+        /* The last consumed stripe is kept for the case the final stripe is shorter. */
+        (void) memcpy((void*) (state->buffer + BUILTIN_XXH3_BUFFER_SIZE - XXH3_STRIPE_SIZE),
+                      (const void*) (data - XXH3_STRIPE_SIZE),
+                      XXH3_STRIPE_SIZE);
+    }
+
+    (void) memcpy((void*) state->buffer, (const void*) data, data_size);
+    state->buffer_fill = data_size;
+}
+
+void
+uhashtools_builtin_xxh3_finish
+(
+    struct BuiltinXxh3State* state,
+    unsigned char* digest,
+    size_t digest_size
+)
+{
+    struct Xxh3Hash128 hash;
+
+    if (state->total_size > XXH3_MIDSIZE_MAX)
+    {
+        const unsigned char* const last_stripe_secret = XXH3_SECRET + XXH3_SECRET_SIZE - XXH3_STRIPE_SIZE - XXH3_SECRET_LASTACC_START;
+
+        if (state->buffer_fill >= XXH3_STRIPE_SIZE)
+        {
+            uhashtools_xxh3_consume_stripes(state, state->buffer, (state->buffer_fill - 1) / XXH3_STRIPE_SIZE);
+            uhashtools_xxh3_accumulate(state->acc, state->buffer + state->buffer_fill - XXH3_STRIPE_SIZE, last_stripe_secret, 1);
+        }
+        else
+        {
+            /* The beginning of the last stripe is taken from the previously consumed data. */
+            unsigned char last_stripe[XXH3_STRIPE_SIZE];
+            const size_t previous_data_size = XXH3_STRIPE_SIZE - state->buffer_fill;
+
+            (void) memcpy((void*) last_stripe,
+                          (const void*) (state->buffer + BUILTIN_XXH3_BUFFER_SIZE - previous_data_size),
+                          previous_data_size);
+            (void) memcpy((void*) (last_stripe + previous_data_size), (const void*) state->buffer, state->buffer_fill);
+            uhashtools_xxh3_accumulate(state->acc, last_stripe, last_stripe_secret, 1);
+        }
+
+        hash.low = uhashtools_xxh3_merge_accs(state->acc,
+                                              XXH3_SECRET + XXH3_SECRET_MERGEACCS_START,
+                                              state->total_size * XXH_PRIME64_1);
+        hash.high = uhashtools_xxh3_merge_accs(state->acc,
+                                               XXH3_SECRET + XXH3_SECRET_SIZE - XXH3_STRIPE_SIZE - XXH3_SECRET_MERGEACCS_START,
+                                               ~(state->total_size * XXH_PRIME64_2));
+    }
+    else if (digest_size == BUILTIN_XXH3_128_DIGEST_SIZE)
+    {
+        hash = uhashtools_xxh3_hash_short_128(state->buffer, state->buffer_fill);
+    }
+    else
+    {
+        hash.low = uhashtools_xxh3_hash_short_64(state->buffer, state->buffer_fill);
+        hash.high = 0;
+    }
+
+    if (digest_size == BUILTIN_XXH3_128_DIGEST_SIZE)
+    {
+        uhashtools_xxh3_write_big_endian_64(digest, hash.high);
+        uhashtools_xxh3_write_big_endian_64(digest + 8, hash.low);
+    }
+    else
+    {
+        uhashtools_xxh3_write_big_endian_64(digest, hash.low);
+    }
+}
+
+BOOL
+uhashtools_builtin_xxh3_is_state_valid
+(
+    const struct BuiltinXxh3State* state
+)
+{
+    /* Inputs up to XXH3_MIDSIZE_MAX bytes are completely kept in the buffer. */
+    return state->buffer_fill <= BUILTIN_XXH3_BUFFER_SIZE &&
+           state->block_stripes < XXH3_STRIPES_PER_BLOCK &&
+           (state->total_size > XXH3_MIDSIZE_MAX || state->total_size == state->buffer_fill);
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+/*
+ * Built-in implementation of the XXH3 hash algorithm (64 and 128 bit
+ * variants, default secret and seed 0). It isn't a cryptographic hash
+ * algorithm and is only suitable for detecting accidental corruption.
+ * On x86 and x64 CPUs the stripes are processed with SSE2. The Windows
+ * CNG API doesn't provide this algorithm, so it's always used. The
+ * digests are written in the canonical (big endian) representation,
+ * which matches the output of the "xxhsum" tool.
+ */
+
+#define BUILTIN_XXH3_64_DIGEST_SIZE 8
+#define BUILTIN_XXH3_128_DIGEST_SIZE 16
+#define BUILTIN_XXH3_BUFFER_SIZE 256
+
+struct BuiltinXxh3State
+{
+    unsigned __int64 acc[8];
+    unsigned __int64 total_size;
+    unsigned char buffer[BUILTIN_XXH3_BUFFER_SIZE];
+    size_t buffer_fill;
+    size_t block_stripes;
+};
+
+/**
+ * Initializes the hash state for a new calculation. Used by both variants.
+ * 
+ * @param state Hash state which should be initialized.
+ */
+extern
+void
+uhashtools_builtin_xxh3_init
+(
+    struct BuiltinXxh3State* state
+);
+
+/**
+ * Hashes the next part of the data. Used by both variants.
+ * 
+ * @param state Initialized hash state.
+ * @param data Data which should be hashed.
+ * @param data_size Size of "data" in bytes.
+ */
+extern
+void
+uhashtools_builtin_xxh3_update
+(
+    struct BuiltinXxh3State* state,
+    const unsigned char* data,
+    size_t data_size
+);
+
+/**
+ * Finishes the calculation and writes the digest.
+ * 
+ * @param state Hash state. It must be initialized again before reusing it.
+ * @param digest Buffer which receives the digest.
+ * @param digest_size BUILTIN_XXH3_64_DIGEST_SIZE for XXH3-64 or
+ *                    BUILTIN_XXH3_128_DIGEST_SIZE for XXH3-128.
+ */
+extern
+void
+uhashtools_builtin_xxh3_finish
+(
+    struct BuiltinXxh3State* state,
+    unsigned char* digest,
+    size_t digest_size
+);
+
+/**
+ * Checks the counters of a hash state which hasn't been created by this
+ * process (for example a state which has been read from a file), so a
+ * damaged state is rejected before it's used.
+ * 
+ * @param state Hash state which should be checked.
+ * 
+ * @return TRUE if the state can be used else FALSE.
+ */
+extern
+BOOL
+uhashtools_builtin_xxh3_is_state_valid
+(
+    const struct BuiltinXxh3State* state
+);
@@ -0,0 +1,213 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "chunk_mode.h"
+
+#include "buffer_sizes.h"
+#include "chunker.h"
+#include "error_utilities.h"
+#include "file_source.h"
+#include "file_source_tap.h"
+#include "hash_calculation_impl.h"
+#include "std_streams.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct ChunkModeCtx
+{
+    unsigned char* file_read_buf;
+    wchar_t* result_string_buf;
+    wchar_t error_message_buf[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+
+    struct Chunker* chunker;
+
+    unsigned __int64 chunks_count;
+    unsigned __int64 chunks_total_size;
+    unsigned __int64 smallest_chunk_size;
+    unsigned __int64 largest_chunk_size;
+};
+
+static
+BOOL
+uhashtools_chunk_mode_on_chunk
+(
+    const struct ChunkerChunk* chunk,
+    void* userdata
+)
+{
+    struct ChunkModeCtx* ctx = (struct ChunkModeCtx*) userdata;
+
+    (void) uhashtools_hash_calculator_impl_digest_to_hex(&chunk->digest, ctx->result_string_buf, HASH_RESULT_BUFFER_TSIZE);
+    (void) wprintf_s(L"%I64u %I64u %s\n", chunk->offset, chunk->size, ctx->result_string_buf);
+
+    if (ctx->chunks_count == 0 || chunk->size < ctx->smallest_chunk_size)
+    {
+        ctx->smallest_chunk_size = chunk->size;
+    }
+
+    if (chunk->size > ctx->largest_chunk_size)
+    {
+        ctx->largest_chunk_size = chunk->size;
+    }
+
+    ++ctx->chunks_count;
+    ctx->chunks_total_size += chunk->size;
+
+    return TRUE;
+}
+
+/* Passes the data read by the hashing implementation to the chunker. */
+static
+BOOL
+uhashtools_chunk_mode_on_data_read
+(
+    const unsigned char* data,
+    size_t data_size,
+    void* userdata
+)
+{
+    struct ChunkModeCtx* ctx = (struct ChunkModeCtx*) userdata;
+
+    return uhashtools_chunker_feed(ctx->chunker, data, data_size);
+}
+
+static
+int
+uhashtools_chunk_mode_chunk_file
+(
+    struct ChunkModeCtx* ctx,
+    const struct CliArguments* cli_arguments
+)
+{
+    struct FileSource target_file_source;
+    struct FileSource tap_file_source;
+    struct HashDigest digest;
+    enum HashCalculatorResultCode hash_rc = HashCalculatorResultCode_FAILED;
+
+    target_file_source = uhashtools_file_source_open(ctx->error_message_buf,
+                                                     GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                     cli_arguments->chunk_target_file);
+
+    if (!target_file_source.is_ok)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", cli_arguments->chunk_target_file, ctx->error_message_buf);
+
+        return 1;
+    }
+
+    /* Takes over the target file source, also on failure. */
+    tap_file_source = uhashtools_file_source_tap_open(ctx->error_message_buf,
+                                                      GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                      &target_file_source,
+                                                      &uhashtools_chunk_mode_on_data_read,
+                                                      (void*) ctx);
+
+    if (!tap_file_source.is_ok)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", cli_arguments->chunk_target_file, ctx->error_message_buf);
+
+        return 1;
+    }
+
+    hash_rc = uhashtools_hash_calculator_impl_hash_file_source_to_digest(ctx->file_read_buf,
+                                                                         FILE_READ_BUF_TSIZE,
+                                                                         &digest,
+                                                                         ctx->error_message_buf,
+                                                                         GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                                         &tap_file_source,
+                                                                         NULL,
+                                                                         NULL,
+                                                                         NULL,
+                                                                         NULL);
+
+    uhashtools_file_source_close(&tap_file_source);
+
+    if (hash_rc != HashCalculatorResultCode_SUCCESS)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", cli_arguments->chunk_target_file, ctx->error_message_buf);
+
+        return 1;
+    }
+
+    (void) uhashtools_chunker_finish(ctx->chunker);
+
+    (void) uhashtools_hash_calculator_impl_digest_to_hex(&digest, ctx->result_string_buf, HASH_RESULT_BUFFER_TSIZE);
+    (void) wprintf_s(L"%s *%s\n", ctx->result_string_buf, cli_arguments->chunk_target_file);
+
+    (void) wprintf_s(L"# %I64u chunks, smallest %I64u bytes, largest %I64u bytes, average %I64u bytes\n",
+                     ctx->chunks_count,
+                     ctx->smallest_chunk_size,
+                     ctx->largest_chunk_size,
+                     ctx->chunks_count > 0 ? ctx->chunks_total_size / ctx->chunks_count : 0);
+
+    (void) fflush(stdout);
+
+    return 0;
+}
+
+int
+uhashtools_chunk_mode_run
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    int ret = 1;
+    struct ChunkModeCtx* ctx = NULL;
+
+    UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
+    UHASHTOOLS_ASSERT(uhashtools_cli_arguments_has_chunk_target_file(cli_arguments),
+                      L"Internal error: Entered chunk mode without a target file!");
+
+    uhashtools_std_streams_connect();
+
+    ctx = (struct ChunkModeCtx*) malloc(sizeof *ctx);
+
+    if (!ctx)
+    {
+        (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+        return 1;
+    }
+
+    (void) memset((void*) ctx, 0, sizeof *ctx);
+
+    ctx->file_read_buf = (unsigned char*) malloc(FILE_READ_BUF_TSIZE);
+    ctx->result_string_buf = (wchar_t*) malloc(HASH_RESULT_BUFFER_TSIZE * sizeof *ctx->result_string_buf);
+
+    if (!ctx->file_read_buf || !ctx->result_string_buf)
+    {
+        (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+        goto cleanup_and_out;
+    }
+
+    ctx->chunker = uhashtools_chunker_create(ctx->error_message_buf,
+                                             GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                             cli_arguments->chunk_average_size,
+                                             &uhashtools_chunk_mode_on_chunk,
+                                             (void*) ctx);
+
+    if (!ctx->chunker)
+    {
+        (void) fwprintf_s(stderr, L"%s\n", ctx->error_message_buf);
+
+        goto cleanup_and_out;
+    }
+
+    ret = uhashtools_chunk_mode_chunk_file(ctx, cli_arguments);
+
+cleanup_and_out:
+    uhashtools_chunker_destroy(ctx->chunker);
+    free((void*) ctx->result_string_buf);
+    free((void*) ctx->file_read_buf);
+    free((void*) ctx);
+
+    return ret;
+}
@@ -0,0 +1,38 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "cli_arguments.h"
+
+/*
+ * The chunk mode "--chunks <average size> <file>" splits a file into
+ * content-defined chunks (see "chunker.h") without creating a window.
+ * The chunker gets the data in the same pass which calculates the
+ * digest of the whole file, so the file is only read once.
+ * 
+ * Every chunk is written to stdout as a line
+ * "<offset> <size> <hash>", followed by the line "<hash> *<filepath>"
+ * with the digest of the whole file and a summary line starting with
+ * "#".
+ */
+
+/**
+ * Runs the chunk mode.
+ * 
+ * @param cli_arguments Command line arguments with a set chunk target file.
+ * 
+ * @return Exit code of the process. Zero if the file has been chunked
+ *         and hashed else one.
+ */
+extern
+int
+uhashtools_chunk_mode_run
+(
+    const struct CliArguments* cli_arguments
+);
@@ -0,0 +1,539 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "chunker.h"
+
+#include "error_utilities.h"
+#include "product.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * The AVX2 intrinsics (and "_xgetbv()") are only available since Visual
+ * Studio 2012, older compilers only build the scalar implementation.
+ */
+#if (defined(_M_X64) || defined(_M_IX86)) && defined(_MSC_VER) && _MSC_VER >= 1700
+#include <intrin.h>
+#include <immintrin.h>
+
+#define CHUNKER_HAS_AVX2_IMPL
+#endif
+
+/* Amount of bytes covered by the gear hash, every byte shifts the hash by one bit. */
+#define CHUNKER_GEAR_WINDOW_SIZE 64
+
+/* The data is scanned in windows of this size. The possible boundaries of a window are kept in bitmaps. */
+#define CHUNKER_SCAN_WINDOW_SIZE (1024 * 64)
+#define CHUNKER_SCAN_WINDOW_WORDS (CHUNKER_SCAN_WINDOW_SIZE / 64)
+
+/*
+ * The AVX2 implementation scans a window in four lanes. Smaller windows
+ * are scanned in a single lane, since each further lane has to be warmed
+ * up with 64 bytes.
+ */
+#define CHUNKER_SCAN_LANES 4
+#define CHUNKER_MIN_MULTI_LANE_SCAN_SIZE (1024 * 4)
+
+/* Seed of the gear table. Changing it moves all chunk boundaries. */
+#define CHUNKER_GEAR_TABLE_SEED 0x7548617368746F6FULL
+
+struct Chunker
+{
+    unsigned __int64 gear_table[256];
+    unsigned __int64 small_chunk_mask;
+    unsigned __int64 large_chunk_mask;
+    unsigned __int64 min_size;
+    unsigned __int64 average_size;
+    unsigned __int64 max_size;
+
+    /* Gear hash over the bytes in front of "scanned_size". */
+    unsigned __int64 gear_hash;
+    unsigned __int64 scanned_size;
+
+    /* Offset of the current chunk and offset up to which its data has been passed to the hasher. */
+    unsigned __int64 chunk_offset;
+    unsigned __int64 hashed_size;
+
+    void* hasher_state;
+    size_t digest_size;
+    BOOL use_avx2_impl;
+
+    /* Bit i is set if the gear hash behind byte i of the current window has no bit of the mask set. */
+    unsigned __int64 small_mask_hits[CHUNKER_SCAN_WINDOW_WORDS];
+    unsigned __int64 large_mask_hits[CHUNKER_SCAN_WINDOW_WORDS];
+
+    ChunkerChunkCallbackFunction* chunk_callback;
+    void* chunk_callback_userdata;
+};
+
+/* Fills the gear table with the output of the SplitMix64 generator, so it's the same for every build. */
+static
+void
+uhashtools_chunker_fill_gear_table
+(
+    unsigned __int64* gear_table
+)
+{
+    unsigned __int64 seed = CHUNKER_GEAR_TABLE_SEED;
+    size_t i = 0;
+
+    for (i = 0; i < 256; ++i)
+    {
+        unsigned __int64 value = 0;
+
+        seed += 0x9E3779B97F4A7C15ULL;
+        value = seed;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        gear_table[i] = value ^ (value >> 31);
+    }
+}
+
+/* Is called for a byte behind which the gear hash has no bit of the large chunk mask set. */
+static
+void
+uhashtools_chunker_mark_hit
+(
+    struct Chunker* chunker,
+    size_t window_position,
+    unsigned __int64 gear_hash
+)
+{
+    const unsigned __int64 bit = 1ULL << (window_position % 64);
+
+    chunker->large_mask_hits[window_position / 64] |= bit;
+
+    /* The small chunk mask contains all bits of the large chunk mask. */
+    if ((gear_hash & chunker->small_chunk_mask) == 0)
+    {
+        chunker->small_mask_hits[window_position / 64] |= bit;
+    }
+}
+
+#ifdef CHUNKER_HAS_AVX2_IMPL
+static
+BOOL
+uhashtools_chunker_is_avx2_supported
+(
+    void
+)
+{
+    int cpu_info[4] = {0};
+
+    __cpuid(cpu_info, 0);
+
+    if (cpu_info[0] < 7)
+    {
+        return FALSE;
+    }
+
+    /* Besides the CPU the operating system has to support AVX by saving the YMM registers (OSXSAVE, AVX and XCR0). */
+    __cpuid(cpu_info, 1);
+
+    if ((cpu_info[2] & (1 << 27)) == 0 || (cpu_info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+    {
+        return FALSE;
+    }
+
+    __cpuidex(cpu_info, 7, 0);
+
+    return (cpu_info[1] & (1 << 5)) ? TRUE : FALSE;
+}
+
+/*
+ * Calculates the gear hashes of four lanes of "lane_size" bytes at once.
+ * Every new hash depends on the previous one, so a single lane has to
+ * wait for each table lookup. The four lanes load the table entries for
+ * their next byte with a single gather instruction instead. Each lane
+ * starts with the hash in "lane_hashes" and receives its final hash.
+ */
+static
+void
+uhashtools_chunker_scan_lanes_avx2
+(
+    struct Chunker* chunker,
+    const unsigned char* data,
+    size_t lane_size,
+    unsigned __int64* lane_hashes
+)
+{
+    const __m256i large_chunk_mask = _mm256_set1_epi64x((__int64) chunker->large_chunk_mask);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m128i byte_mask = _mm_set1_epi32(0xFF);
+    __m256i hashes = _mm256_loadu_si256((const __m256i*) lane_hashes);
+    size_t i = 0;
+
+    UHASHTOOLS_ASSERT(lane_size % 4 == 0, L"Internal error: The lane size isn't a multiple of four!");
+
+    for (i = 0; i < lane_size; i += 4)
+    {
+        /* The next four bytes of every lane, the lowest byte is the first one. */
+        __m128i lane_bytes = _mm_set_epi32(*(const int*) (data + lane_size * 3 + i),
+                                           *(const int*) (data + lane_size * 2 + i),
+                                           *(const int*) (data + lane_size + i),
+                                           *(const int*) (data + i));
+        size_t j = 0;
+
+        for (j = 0; j < 4; ++j)
+        {
+            const __m128i table_indices = _mm_and_si128(lane_bytes, byte_mask);
+            const __m256i table_values = _mm256_i32gather_epi64((const __int64*) chunker->gear_table, table_indices, 8);
+
+            hashes = _mm256_add_epi64(_mm256_slli_epi64(hashes, 1), table_values);
+            lane_bytes = _mm_srli_epi32(lane_bytes, 8);
+
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi64(_mm256_and_si256(hashes, large_chunk_mask), zero)) != 0)
+            {
+                unsigned __int64 hit_hashes[CHUNKER_SCAN_LANES];
+                size_t lane = 0;
+
+                _mm256_storeu_si256((__m256i*) hit_hashes, hashes);
+
+                for (lane = 0; lane < CHUNKER_SCAN_LANES; ++lane)
+                {
+                    if ((hit_hashes[lane] & chunker->large_chunk_mask) == 0)
+                    {
+                        uhashtools_chunker_mark_hit(chunker, lane_size * lane + i + j, hit_hashes[lane]);
+                    }
+                }
+            }
+        }
+    }
+
+    _mm256_storeu_si256((__m256i*) lane_hashes, hashes);
+}
+#endif
+
+/*
+ * Calculates the gear hash behind every byte of the window and marks the
+ * possible boundaries in the bitmaps.
+ */
+static
+void
+uhashtools_chunker_scan_window
+(
+    struct Chunker* chunker,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    const unsigned __int64* gear_table = chunker->gear_table;
+    const unsigned __int64 large_chunk_mask = chunker->large_chunk_mask;
+    unsigned __int64 last_lane_hash = chunker->gear_hash;
+    size_t i = 0;
+
+    (void) memset((void*) chunker->small_mask_hits, 0, ((data_size + 63) / 64) * sizeof *chunker->small_mask_hits);
+    (void) memset((void*) chunker->large_mask_hits, 0, ((data_size + 63) / 64) * sizeof *chunker->large_mask_hits);
+
+#ifdef CHUNKER_HAS_AVX2_IMPL
+    if (chunker->use_avx2_impl && data_size >= CHUNKER_MIN_MULTI_LANE_SCAN_SIZE)
+    {
+        /*
+         * Since the hash only depends on the last 64 bytes, the lanes 1 to 3
+         * get the same hashes as a single lane after hashing the 64 bytes in
+         * front of their part of the window.
+         */
+        const size_t lane_size = data_size / (CHUNKER_SCAN_LANES * 4) * 4;
+        unsigned __int64 lane_hashes[CHUNKER_SCAN_LANES];
+        size_t lane = 0;
+
+        lane_hashes[0] = chunker->gear_hash;
+
+        for (lane = 1; lane < CHUNKER_SCAN_LANES; ++lane)
+        {
+            lane_hashes[lane] = 0;
+
+            for (i = lane_size * lane - CHUNKER_GEAR_WINDOW_SIZE; i < lane_size * lane; ++i)
+            {
+                lane_hashes[lane] = (lane_hashes[lane] << 1) + gear_table[data[i]];
+            }
+        }
+
+        uhashtools_chunker_scan_lanes_avx2(chunker, data, lane_size, lane_hashes);
+
+        /* The last lane continues with the bytes which don't fit into the equally sized lanes. */
+        last_lane_hash = lane_hashes[CHUNKER_SCAN_LANES - 1];
+        i = lane_size * CHUNKER_SCAN_LANES;
+    }
+#endif
+
+    for (; i < data_size; ++i)
+    {
+        last_lane_hash = (last_lane_hash << 1) + gear_table[data[i]];
+
+        if ((last_lane_hash & large_chunk_mask) == 0)
+        {
+            uhashtools_chunker_mark_hit(chunker, i, last_lane_hash);
+        }
+    }
+
+    chunker->gear_hash = last_lane_hash;
+    chunker->scanned_size += data_size;
+}
+
+/*
+ * Searches the first marked byte between "first_position" (inclusive)
+ * and "end_position" (exclusive) within the current window. The
+ * positions are offsets within the data stream.
+ */
+static
+BOOL
+uhashtools_chunker_find_hit
+(
+    const unsigned __int64* mask_hits,
+    unsigned __int64 window_offset,
+    unsigned __int64 window_end,
+    unsigned __int64 first_position,
+    unsigned __int64 end_position,
+    unsigned __int64* hit_position
+)
+{
+    size_t first_bit = 0;
+    size_t end_bit = 0;
+    size_t word_index = 0;
+    unsigned __int64 word = 0;
+
+    if (first_position < window_offset)
+    {
+        first_position = window_offset;
+    }
+
+    if (end_position > window_end)
+    {
+        end_position = window_end;
+    }
+
+    if (first_position >= end_position)
+    {
+        return FALSE;
+    }
+
+    first_bit = (size_t) (first_position - window_offset);
+    end_bit = (size_t) (end_position - window_offset);
+    word_index = first_bit / 64;
+    word = mask_hits[word_index] & (_UI64_MAX << (first_bit % 64));
+
+    while (word == 0)
+    {
+        ++word_index;
+
+        if (word_index * 64 >= end_bit)
+        {
+            return FALSE;
+        }
+
+        word = mask_hits[word_index];
+    }
+
+    first_bit = word_index * 64;
+
+    while ((word & 1) == 0)
+    {
+        word >>= 1;
+        ++first_bit;
+    }
+
+    if (first_bit >= end_bit)
+    {
+        return FALSE;
+    }
+
+    *hit_position = window_offset + first_bit;
+
+    return TRUE;
+}
+
+/* Finishes the hash of the current chunk, passes the chunk to the callback and starts the next chunk. */
+static
+BOOL
+uhashtools_chunker_emit_chunk
+(
+    struct Chunker* chunker
+)
+{
+    struct ChunkerChunk chunk;
+
+    (void) memset((void*) &chunk, 0, sizeof chunk);
+
+    chunk.offset = chunker->chunk_offset;
+    chunk.size = chunker->hashed_size - chunker->chunk_offset;
+    chunk.digest.size = (unsigned int) chunker->digest_size;
+    uhashtools_product_builtin_hasher_finish(chunker->hasher_state, chunk.digest.bytes);
+
+    uhashtools_product_builtin_hasher_init(chunker->hasher_state);
+    chunker->chunk_offset = chunker->hashed_size;
+
+    return chunker->chunk_callback(&chunk, chunker->chunk_callback_userdata);
+}
+
+struct Chunker*
+uhashtools_chunker_create
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    size_t average_size,
+    ChunkerChunkCallbackFunction* chunk_callback,
+    void* chunk_callback_userdata
+)
+{
+    struct Chunker* chunker = NULL;
+    unsigned int average_size_bits = 0;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(chunk_callback, L"Internal error: chunk_callback is NULL!");
+    UHASHTOOLS_ASSERT(average_size >= CHUNKER_MIN_AVERAGE_SIZE && average_size <= CHUNKER_MAX_AVERAGE_SIZE &&
+                      (average_size & (average_size - 1)) == 0,
+                      L"Internal error: The average chunk size isn't a power of two within the limits!");
+    UHASHTOOLS_ASSERT(uhashtools_product_get_builtin_hasher_digest_size() <= HASH_DIGEST_MAX_SIZE,
+                      L"Internal error: The digest of the built-in hasher is too big!");
+
+    while (((size_t) 1 << average_size_bits) < average_size)
+    {
+        ++average_size_bits;
+    }
+
+    chunker = (struct Chunker*) calloc(1, sizeof *chunker);
+
+    if (chunker)
+    {
+        chunker->hasher_state = malloc(uhashtools_product_get_builtin_hasher_state_size());
+    }
+
+    if (!chunker || !chunker->hasher_state)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+        uhashtools_chunker_destroy(chunker);
+
+        return NULL;
+    }
+
+    uhashtools_chunker_fill_gear_table(chunker->gear_table);
+
+#ifdef CHUNKER_HAS_AVX2_IMPL
+    chunker->use_avx2_impl = uhashtools_chunker_is_avx2_supported();
+#else
+    chunker->use_avx2_impl = FALSE;
+#endif
+
+    /* The masks use the highest bits of the hash, which depend on all 64 bytes. */
+    chunker->small_chunk_mask = _UI64_MAX << (64 - (average_size_bits + 2));
+    chunker->large_chunk_mask = _UI64_MAX << (64 - (average_size_bits - 2));
+    chunker->min_size = average_size / 4;
+    chunker->average_size = average_size;
+    chunker->max_size = (unsigned __int64) average_size * 8;
+    chunker->digest_size = uhashtools_product_get_builtin_hasher_digest_size();
+    chunker->chunk_callback = chunk_callback;
+    chunker->chunk_callback_userdata = chunk_callback_userdata;
+
+    uhashtools_product_builtin_hasher_init(chunker->hasher_state);
+
+    return chunker;
+}
+
+BOOL
+uhashtools_chunker_feed
+(
+    struct Chunker* chunker,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    UHASHTOOLS_ASSERT(chunker, L"Internal error: chunker is NULL!");
+    UHASHTOOLS_ASSERT(data || data_size == 0, L"Internal error: data is NULL!");
+
+    while (data_size > 0)
+    {
+        const size_t window_size = data_size < CHUNKER_SCAN_WINDOW_SIZE ? data_size : CHUNKER_SCAN_WINDOW_SIZE;
+        const unsigned __int64 window_offset = chunker->scanned_size;
+        const unsigned __int64 window_end = window_offset + window_size;
+
+        uhashtools_chunker_scan_window(chunker, data, window_size);
+
+        for (;;)
+        {
+            const unsigned __int64 chunk_offset = chunker->chunk_offset;
+            unsigned __int64 cut_position = 0;
+
+            /* A chunk ends behind the first marked byte which keeps its size within the limits. */
+            if (!uhashtools_chunker_find_hit(chunker->small_mask_hits,
+                                             window_offset,
+                                             window_end,
+                                             chunk_offset + chunker->min_size - 1,
+                                             chunk_offset + chunker->average_size - 1,
+                                             &cut_position) &&
+                !uhashtools_chunker_find_hit(chunker->large_mask_hits,
+                                             window_offset,
+                                             window_end,
+                                             chunk_offset + chunker->average_size - 1,
+                                             chunk_offset + chunker->max_size - 1,
+                                             &cut_position))
+            {
+                if (chunk_offset + chunker->max_size > window_end)
+                {
+                    break;
+                }
+
+                cut_position = chunk_offset + chunker->max_size - 1;
+            }
+
+            uhashtools_product_builtin_hasher_update(chunker->hasher_state,
+                                                     data + (size_t) (chunker->hashed_size - window_offset),
+                                                     (size_t) (cut_position + 1 - chunker->hashed_size));
+            chunker->hashed_size = cut_position + 1;
+
+            if (!uhashtools_chunker_emit_chunk(chunker))
+            {
+                return FALSE;
+            }
+        }
+
+        uhashtools_product_builtin_hasher_update(chunker->hasher_state,
+                                                 data + (size_t) (chunker->hashed_size - window_offset),
+                                                 (size_t) (window_end - chunker->hashed_size));
+        chunker->hashed_size = window_end;
+
+        data += window_size;
+        data_size -= window_size;
+    }
+
+    return TRUE;
+}
+
+BOOL
+uhashtools_chunker_finish
+(
+    struct Chunker* chunker
+)
+{
+    UHASHTOOLS_ASSERT(chunker, L"Internal error: chunker is NULL!");
+
+    if (chunker->hashed_size == chunker->chunk_offset)
+    {
+        return TRUE;
+    }
+
+    return uhashtools_chunker_emit_chunk(chunker);
+}
+
+void
+uhashtools_chunker_destroy
+(
+    struct Chunker* chunker
+)
+{
+    if (!chunker)
+    {
+        return;
+    }
+
+    free(chunker->hasher_state);
+    free((void*) chunker);
+}
@@ -0,0 +1,124 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "hash_calculation_impl.h"
+
+#include <Windows.h>
+
+/*
+ * Splits a stream of data into content-defined chunks with the FastCDC
+ * algorithm and hashes every chunk with the built-in hasher. Since the
+ * chunk boundaries only depend on the content around them, inserting or
+ * removing data only changes the chunks next to the modification, which
+ * is what deduplicating stores and delta synchronisation rely on.
+ * 
+ * A boundary is placed behind a byte if the gear hash over the 64 bytes
+ * up to it has all bits of a mask cleared. Chunks are at least a quarter
+ * and at most eight times the average size. Below the average size a
+ * mask with four more bits is used than above it ("normalized
+ * chunking"), which narrows the distribution of the chunk sizes. The
+ * gear hash only depends on the last 64 bytes, so the boundaries don't
+ * depend on how the data is split into "uhashtools_chunker_feed()"
+ * calls, and the data can be scanned in multiple independent lanes.
+ */
+
+/* Limits of the average chunk size, which has to be a power of two. */
+#define CHUNKER_MIN_AVERAGE_SIZE 1024
+#define CHUNKER_MAX_AVERAGE_SIZE (1024 * 1024 * 4)
+
+struct Chunker;
+
+/**
+ * Chunk as passed to the "ChunkerChunkCallbackFunction".
+ */
+struct ChunkerChunk
+{
+    /* Offset of the first byte within the data stream. */
+    unsigned __int64 offset;
+    unsigned __int64 size;
+    struct HashDigest digest;
+};
+
+/**
+ * Is called for every chunk in the order of the data stream.
+ * 
+ * @param chunk Found chunk.
+ * @param userdata Userdata passed to "uhashtools_chunker_create()".
+ * 
+ * @return TRUE to continue or FALSE to let the current
+ *         "uhashtools_chunker_feed()" or "uhashtools_chunker_finish()"
+ *         call fail.
+ */
+typedef BOOL ChunkerChunkCallbackFunction(const struct ChunkerChunk* chunk,
+                                          void* userdata);
+
+/**
+ * Creates a chunker.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if
+ *                          the chunker can't be created.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param average_size Average chunk size in bytes. Must be a power of two
+ *                     between CHUNKER_MIN_AVERAGE_SIZE and
+ *                     CHUNKER_MAX_AVERAGE_SIZE.
+ * @param chunk_callback Function which is called for every chunk.
+ * @param chunk_callback_userdata Userdata for "chunk_callback".
+ * 
+ * @return Created chunker or NULL on failure. Must be destroyed with
+ *         "uhashtools_chunker_destroy()".
+ */
+extern
+struct Chunker*
+uhashtools_chunker_create
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    size_t average_size,
+    ChunkerChunkCallbackFunction* chunk_callback,
+    void* chunk_callback_userdata
+);
+
+/**
+ * Passes the next part of the data stream to the chunker. The callback
+ * is called for every chunk which ends within this part.
+ * 
+ * @return FALSE if the callback has returned FALSE.
+ */
+extern
+BOOL
+uhashtools_chunker_feed
+(
+    struct Chunker* chunker,
+    const unsigned char* data,
+    size_t data_size
+);
+
+/**
+ * Passes the last chunk of the data stream to the callback. An empty
+ * data stream has no chunks.
+ * 
+ * @return FALSE if the callback has returned FALSE.
+ */
+extern
+BOOL
+uhashtools_chunker_finish
+(
+    struct Chunker* chunker
+);
+
+/**
+ * Destroys the chunker. Passing NULL is allowed.
+ */
+extern
+void
+uhashtools_chunker_destroy
+(
+    struct Chunker* chunker
+);
@@ -8,10 +8,139 @@
 
 #include "cli_arguments.h"
 
+#include "block_list.h"
+#include "chunker.h"
 #include "error_utilities.h"
+#include "serve_mode.h"
 
+#include <limits.h>
 #include <string.h>
 
+#define CLI_ARGUMENTS_MAX_THREADS 64
+
+/*
+ * Parses an unsigned decimal number. With "allow_binary_suffix" the
+ * suffixes "K", "M" and "G" are multiplying the number with 1024,
+ * 1024^2 and 1024^3.
+ */
+static
+BOOL
+uhashtools_cli_arguments_parse_unsigned
+(
+    const wchar_t* txt,
+    BOOL allow_binary_suffix,
+    unsigned __int64* value
+)
+{
+    unsigned __int64 parsed_value = 0;
+    unsigned __int64 multiplier = 1;
+    const wchar_t* current_char = txt;
+
+    if (*current_char < L'0' || *current_char > L'9')
+    {
+        return FALSE;
+    }
+
+    for (; *current_char >= L'0' && *current_char <= L'9'; ++current_char)
+    {
+        const unsigned __int64 digit = (unsigned __int64) (*current_char - L'0');
+
+        if (parsed_value > (_UI64_MAX - digit) / 10)
+        {
+            return FALSE;
+        }
+
+        parsed_value = parsed_value * 10 + digit;
+    }
+
+    if (allow_binary_suffix && *current_char != L'\0')
+    {
+        switch (*current_char)
+        {
+            case L'K': case L'k':
+                multiplier = 1024ULL;
+                break;
+            case L'M': case L'm':
+                multiplier = 1024ULL * 1024ULL;
+                break;
+            case L'G': case L'g':
+                multiplier = 1024ULL * 1024ULL * 1024ULL;
+                break;
+            default:
+                return FALSE;
+        }
+
+        ++current_char;
+    }
+
+    if (*current_char != L'\0' || parsed_value > _UI64_MAX / multiplier)
+    {
+        return FALSE;
+    }
+
+    *value = parsed_value * multiplier;
+
+    return TRUE;
+}
+
+/*
+ * Consumes the throttle options in front of the other arguments.
+ * 
+ * @return Amount of consumed arguments or -1 if an option is invalid.
+ */
+static
+int
+uhashtools_cli_arguments_consume_throttle_options
+(
+    struct CliArguments* cli_arguments,
+    int argc,
+    LPWSTR argv[]
+)
+{
+    int arg_index = 1;
+
+    while (arg_index < argc && argv[arg_index])
+    {
+        unsigned __int64 option_value = 0;
+
+        if (wcscmp(argv[arg_index], L"--background") == 0)
+        {
+            cli_arguments->throttle_use_background_mode = TRUE;
+            arg_index += 1;
+        }
+        else if (wcscmp(argv[arg_index], L"--throttle") == 0)
+        {
+            if (arg_index + 1 >= argc || !argv[arg_index + 1] ||
+                !uhashtools_cli_arguments_parse_unsigned(argv[arg_index + 1], TRUE, &option_value) ||
+                option_value == 0)
+            {
+                return -1;
+            }
+
+            cli_arguments->throttle_bytes_per_second = option_value;
+            arg_index += 2;
+        }
+        else if (wcscmp(argv[arg_index], L"--max-threads") == 0)
+        {
+            if (arg_index + 1 >= argc || !argv[arg_index + 1] ||
+                !uhashtools_cli_arguments_parse_unsigned(argv[arg_index + 1], FALSE, &option_value) ||
+                option_value == 0 || option_value > CLI_ARGUMENTS_MAX_THREADS)
+            {
+                return -1;
+            }
+
+            cli_arguments->throttle_max_threads = (unsigned int) option_value;
+            arg_index += 2;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return arg_index - 1;
+}
+
 void
 uhashtools_cli_arguments_fill_from_argc_argv
 (
@@ -22,9 +151,174 @@ uhashtools_cli_arguments_fill_from_argc_argv
 {
     wchar_t* cli_target_file = NULL;
     size_t cli_target_file_strlen = 0;
+    int consumed_args_count = 0;
 
     UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
 
+    if (argv)
+    {
+        consumed_args_count = uhashtools_cli_arguments_consume_throttle_options(cli_arguments, argc, argv);
+
+        if (consumed_args_count < 0)
+        {
+            (void) memset((void*) cli_arguments, 0, sizeof *cli_arguments);
+
+            return;
+        }
+
+        /* The remaining arguments are parsed as if the options had never been there. */
+        argc -= consumed_args_count;
+        argv += consumed_args_count;
+    }
+
+    if (argv && argc == 3 && argv[1] && argv[2] && wcscmp(argv[1], L"--archive") == 0)
+    {
+        const size_t cli_archive_file_strlen = wcslen(argv[2]);
+
+        if (cli_archive_file_strlen > 0 && cli_archive_file_strlen < FILEPATH_BUFFER_TSIZE)
+        {
+            (void) wcscpy_s(cli_arguments->archive_file, FILEPATH_BUFFER_TSIZE, argv[2]);
+        }
+
+        return;
+    }
+
+    if (argv && argc == 3 && argv[1] && argv[2] && wcscmp(argv[1], L"--dedup") == 0)
+    {
+        const size_t cli_dedup_directory_strlen = wcslen(argv[2]);
+
+        if (cli_dedup_directory_strlen > 0 && cli_dedup_directory_strlen < FILEPATH_BUFFER_TSIZE)
+        {
+            (void) wcscpy_s(cli_arguments->dedup_directory, FILEPATH_BUFFER_TSIZE, argv[2]);
+        }
+
+        return;
+    }
+
+    if (argv && argc == 4 && argv[1] && argv[2] && argv[3] &&
+        (wcscmp(argv[1], L"--known-set") == 0 || wcscmp(argv[1], L"--build-known-set") == 0))
+    {
+        const BOOL is_build = wcscmp(argv[1], L"--build-known-set") == 0;
+        const wchar_t* cli_known_set_file = is_build ? argv[3] : argv[2];
+        const wchar_t* cli_second_path = is_build ? argv[2] : argv[3];
+        const size_t cli_known_set_file_strlen = wcslen(cli_known_set_file);
+        const size_t cli_second_path_strlen = wcslen(cli_second_path);
+
+        if (cli_known_set_file_strlen > 0 && cli_known_set_file_strlen < FILEPATH_BUFFER_TSIZE &&
+            cli_second_path_strlen > 0 && cli_second_path_strlen < FILEPATH_BUFFER_TSIZE)
+        {
+            (void) wcscpy_s(cli_arguments->known_set_file, FILEPATH_BUFFER_TSIZE, cli_known_set_file);
+            (void) wcscpy_s(is_build ? cli_arguments->known_set_digest_list : cli_arguments->known_set_directory,
+                            FILEPATH_BUFFER_TSIZE,
+                            cli_second_path);
+        }
+
+        return;
+    }
+
+    if (argv && argc == 4 && argv[1] && argv[2] && argv[3] &&
+        (wcscmp(argv[1], L"--write-manifest") == 0 || wcscmp(argv[1], L"--verify-manifest") == 0))
+    {
+        const size_t cli_manifest_file_strlen = wcslen(argv[2]);
+        const size_t cli_manifest_directory_strlen = wcslen(argv[3]);
+
+        if (cli_manifest_file_strlen > 0 && cli_manifest_file_strlen < FILEPATH_BUFFER_TSIZE &&
+            cli_manifest_directory_strlen > 0 && cli_manifest_directory_strlen < FILEPATH_BUFFER_TSIZE)
+        {
+            (void) wcscpy_s(cli_arguments->manifest_file, FILEPATH_BUFFER_TSIZE, argv[2]);
+            (void) wcscpy_s(cli_arguments->manifest_directory, FILEPATH_BUFFER_TSIZE, argv[3]);
+            cli_arguments->is_manifest_verify = wcscmp(argv[1], L"--verify-manifest") == 0;
+        }
+
+        return;
+    }
+
+    if (argv && argc == 4 && argv[1] && argv[2] && argv[3] && wcscmp(argv[1], L"--incremental") == 0)
+    {
+        const size_t cli_state_file_strlen = wcslen(argv[2]);
+        const size_t cli_target_file_strlen = wcslen(argv[3]);
+
+        if (cli_state_file_strlen > 0 && cli_state_file_strlen < FILEPATH_BUFFER_TSIZE &&
+            cli_target_file_strlen > 0 && cli_target_file_strlen < FILEPATH_BUFFER_TSIZE)
+        {
+            (void) wcscpy_s(cli_arguments->incremental_state_file, FILEPATH_BUFFER_TSIZE, argv[2]);
+            (void) wcscpy_s(cli_arguments->incremental_target_file, FILEPATH_BUFFER_TSIZE, argv[3]);
+        }
+
+        return;
+    }
+
+    if (argv && argc == 4 && argv[1] && argv[2] && argv[3] && wcscmp(argv[1], L"--chunks") == 0)
+    {
+        const size_t cli_target_file_strlen = wcslen(argv[3]);
+        unsigned __int64 average_size = 0;
+
+        /* The chunker needs a power of two as average chunk size. */
+        if (uhashtools_cli_arguments_parse_unsigned(argv[2], TRUE, &average_size) &&
+            average_size >= CHUNKER_MIN_AVERAGE_SIZE && average_size <= CHUNKER_MAX_AVERAGE_SIZE &&
+            (average_size & (average_size - 1)) == 0 &&
+            cli_target_file_strlen > 0 && cli_target_file_strlen < FILEPATH_BUFFER_TSIZE)
+        {
+            (void) wcscpy_s(cli_arguments->chunk_target_file, FILEPATH_BUFFER_TSIZE, argv[3]);
+            cli_arguments->chunk_average_size = (size_t) average_size;
+        }
+
+        return;
+    }
+
+    if (argv && argc == 5 && argv[1] && argv[2] && argv[3] && argv[4] && wcscmp(argv[1], L"--write-blocks") == 0)
+    {
+        const size_t cli_block_list_file_strlen = wcslen(argv[2]);
+        const size_t cli_target_file_strlen = wcslen(argv[4]);
+        unsigned __int64 block_size = 0;
+
+        if (uhashtools_cli_arguments_parse_unsigned(argv[3], TRUE, &block_size) &&
+            block_size >= BLOCK_LIST_MIN_BLOCK_SIZE && block_size <= BLOCK_LIST_MAX_BLOCK_SIZE &&
+            cli_block_list_file_strlen > 0 && cli_block_list_file_strlen < FILEPATH_BUFFER_TSIZE &&
+            cli_target_file_strlen > 0 && cli_target_file_strlen < FILEPATH_BUFFER_TSIZE)
+        {
+            (void) wcscpy_s(cli_arguments->block_list_file, FILEPATH_BUFFER_TSIZE, argv[2]);
+            (void) wcscpy_s(cli_arguments->block_target_file, FILEPATH_BUFFER_TSIZE, argv[4]);
+            cli_arguments->block_size = block_size;
+        }
+
+        return;
+    }
+
+    if (argv && (argc == 4 || (argc == 5 && argv[4])) && argv[1] && argv[2] && argv[3] &&
+        wcscmp(argv[1], L"--verify-blocks") == 0)
+    {
+        const size_t cli_block_list_file_strlen = wcslen(argv[2]);
+        const size_t cli_target_file_strlen = wcslen(argv[3]);
+        unsigned __int64 max_mismatches = 0;
+
+        if ((argc == 4 || (uhashtools_cli_arguments_parse_unsigned(argv[4], FALSE, &max_mismatches) && max_mismatches > 0)) &&
+            cli_block_list_file_strlen > 0 && cli_block_list_file_strlen < FILEPATH_BUFFER_TSIZE &&
+            cli_target_file_strlen > 0 && cli_target_file_strlen < FILEPATH_BUFFER_TSIZE)
+        {
+            (void) wcscpy_s(cli_arguments->block_list_file, FILEPATH_BUFFER_TSIZE, argv[2]);
+            (void) wcscpy_s(cli_arguments->block_target_file, FILEPATH_BUFFER_TSIZE, argv[3]);
+            cli_arguments->is_block_verify = TRUE;
+            cli_arguments->block_max_mismatches = max_mismatches;
+        }
+
+        return;
+    }
+
+    if (argv && argc == 3 && argv[1] && argv[2] && wcscmp(argv[1], L"--serve") == 0)
+    {
+        const size_t cli_pipe_name_strlen = wcslen(argv[2]);
+
+        /* The name is appended to the pipe prefix, so it must not contain backslashes. */
+        if (cli_pipe_name_strlen > 0 && cli_pipe_name_strlen + wcslen(SERVE_MODE_PIPE_PREFIX) < FILEPATH_BUFFER_TSIZE &&
+            !wcschr(argv[2], L'\\'))
+        {
+            (void) wcscpy_s(cli_arguments->serve_pipe_name, FILEPATH_BUFFER_TSIZE, argv[2]);
+        }
+
+        return;
+    }
+
     if (!argv || argc != 2)
     {
         return;
@@ -57,3 +351,91 @@ uhashtools_cli_arguments_has_target_file
 
     return cli_arguments->target_file[0] != L'\0';
 }
+
+BOOL
+uhashtools_cli_arguments_has_archive_file
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
+
+    return cli_arguments->archive_file[0] != L'\0';
+}
+
+BOOL
+uhashtools_cli_arguments_has_dedup_directory
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
+
+    return cli_arguments->dedup_directory[0] != L'\0';
+}
+
+BOOL
+uhashtools_cli_arguments_has_known_set_file
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
+
+    return cli_arguments->known_set_file[0] != L'\0';
+}
+
+BOOL
+uhashtools_cli_arguments_has_manifest_file
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
+
+    return cli_arguments->manifest_file[0] != L'\0';
+}
+
+BOOL
+uhashtools_cli_arguments_has_incremental_state_file
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
+
+    return cli_arguments->incremental_state_file[0] != L'\0';
+}
+
+BOOL
+uhashtools_cli_arguments_has_chunk_target_file
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
+
+    return cli_arguments->chunk_target_file[0] != L'\0';
+}
+
+BOOL
+uhashtools_cli_arguments_has_block_list_file
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
+
+    return cli_arguments->block_list_file[0] != L'\0';
+}
+
+BOOL
+uhashtools_cli_arguments_has_serve_pipe_name
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
+
+    return cli_arguments->serve_pipe_name[0] != L'\0';
+}
@@ -28,6 +28,95 @@ struct CliArguments
      * be an empty C wide string. 
      */
     wchar_t target_file[FILEPATH_BUFFER_TSIZE];
+
+    /**
+     * Archive whose entries shall be hashed without showing the main
+     * window. This argument is set with "--archive <archive>" which
+     * must be the only arguments. If set the "target_file" argument
+     * is always empty.
+     */
+    wchar_t archive_file[FILEPATH_BUFFER_TSIZE];
+
+    /**
+     * Directory which shall be searched for duplicate files without
+     * showing the main window. This argument is set with
+     * "--dedup <directory>" which must be the only arguments. If set
+     * the other arguments are always empty.
+     */
+    wchar_t dedup_directory[FILEPATH_BUFFER_TSIZE];
+
+    /**
+     * Known set file for the known mode. It is set together with
+     * "known_set_directory" by "--known-set <known set> <directory>"
+     * or together with "known_set_digest_list" by
+     * "--build-known-set <digest list> <known set>". These must be
+     * the only arguments. If set the other arguments are always empty.
+     */
+    wchar_t known_set_file[FILEPATH_BUFFER_TSIZE];
+    wchar_t known_set_directory[FILEPATH_BUFFER_TSIZE];
+    wchar_t known_set_digest_list[FILEPATH_BUFFER_TSIZE];
+
+    /**
+     * Manifest file and directory tree for the manifest mode. They are
+     * set by "--write-manifest <manifest> <directory>" or by
+     * "--verify-manifest <manifest> <directory>", in which case
+     * "is_manifest_verify" is TRUE. These must be the only arguments.
+     * If set the other arguments are always empty.
+     */
+    wchar_t manifest_file[FILEPATH_BUFFER_TSIZE];
+    wchar_t manifest_directory[FILEPATH_BUFFER_TSIZE];
+    BOOL is_manifest_verify;
+
+    /**
+     * State file and growing file for the incremental mode. They are set
+     * by "--incremental <state file> <file>" which must be the only
+     * arguments. If set the other arguments are always empty.
+     */
+    wchar_t incremental_state_file[FILEPATH_BUFFER_TSIZE];
+    wchar_t incremental_target_file[FILEPATH_BUFFER_TSIZE];
+
+    /**
+     * Target file and average chunk size in bytes for the chunk mode.
+     * They are set by "--chunks <average size> <file>" which must be
+     * the only arguments. If set the other arguments are always empty.
+     */
+    wchar_t chunk_target_file[FILEPATH_BUFFER_TSIZE];
+    size_t chunk_average_size;
+
+    /**
+     * Block list and target file for the block mode. They are set by
+     * "--write-blocks <block list> <block size> <file>", which also
+     * sets "block_size", or by
+     * "--verify-blocks <block list> <file> [<max mismatches>]", in
+     * which case "is_block_verify" is TRUE. "block_max_mismatches" is
+     * zero if the verification shouldn't stop early. These must be the
+     * only arguments. If set the other arguments are always empty.
+     */
+    wchar_t block_list_file[FILEPATH_BUFFER_TSIZE];
+    wchar_t block_target_file[FILEPATH_BUFFER_TSIZE];
+    unsigned __int64 block_size;
+    BOOL is_block_verify;
+    unsigned __int64 block_max_mismatches;
+
+    /**
+     * Name of the named pipe for the serve mode without the
+     * "\\.\pipe\" prefix. It is set by "--serve <pipe name>" which
+     * must be the only arguments. If set the other arguments are always
+     * empty.
+     */
+    wchar_t serve_pipe_name[FILEPATH_BUFFER_TSIZE];
+
+    /**
+     * Limits for hashing on machines which are busy with other work
+     * (see "throttle.h"). They are set by the options
+     * "--throttle <rate>", "--background" and "--max-threads <count>"
+     * which can precede all other arguments. Zero or FALSE means no
+     * limit. If an option has an invalid value, all arguments are
+     * ignored.
+     */
+    unsigned __int64 throttle_bytes_per_second;
+    BOOL throttle_use_background_mode;
+    unsigned int throttle_max_threads;
 };
 
 /* 
@@ -70,3 +159,115 @@ uhashtools_cli_arguments_has_target_file
 (
     const struct CliArguments* cli_arguments
 );
+
+/**
+ * Checks if an archive file for the archive mode has been set.
+ * 
+ * @param cli_arguments Initialized instance of the CliArguments structure.
+ * 
+ * @return TRUE if an archive file is set else FALSE.
+ */
+extern
+BOOL
+uhashtools_cli_arguments_has_archive_file
+(
+    const struct CliArguments* cli_arguments
+);
+
+/**
+ * Checks if a directory for the dedup mode has been set.
+ * 
+ * @param cli_arguments Initialized instance of the CliArguments structure.
+ * 
+ * @return TRUE if a dedup directory is set else FALSE.
+ */
+extern
+BOOL
+uhashtools_cli_arguments_has_dedup_directory
+(
+    const struct CliArguments* cli_arguments
+);
+
+/**
+ * Checks if a known set file for the known mode has been set.
+ * 
+ * @param cli_arguments Initialized instance of the CliArguments structure.
+ * 
+ * @return TRUE if a known set file is set else FALSE.
+ */
+extern
+BOOL
+uhashtools_cli_arguments_has_known_set_file
+(
+    const struct CliArguments* cli_arguments
+);
+
+/**
+ * Checks if a manifest file for the manifest mode has been set.
+ * 
+ * @param cli_arguments Initialized instance of the CliArguments structure.
+ * 
+ * @return TRUE if a manifest file is set else FALSE.
+ */
+extern
+BOOL
+uhashtools_cli_arguments_has_manifest_file
+(
+    const struct CliArguments* cli_arguments
+);
+
+/**
+ * Checks if a state file for the incremental mode has been set.
+ * 
+ * @param cli_arguments Initialized instance of the CliArguments structure.
+ * 
+ * @return TRUE if a state file is set else FALSE.
+ */
+extern
+BOOL
+uhashtools_cli_arguments_has_incremental_state_file
+(
+    const struct CliArguments* cli_arguments
+);
+
+/**
+ * Checks if a target file for the chunk mode has been set.
+ * 
+ * @param cli_arguments Initialized instance of the CliArguments structure.
+ * 
+ * @return TRUE if a target file for the chunk mode is set else FALSE.
+ */
+extern
+BOOL
+uhashtools_cli_arguments_has_chunk_target_file
+(
+    const struct CliArguments* cli_arguments
+);
+
+/**
+ * Checks if a block list for the block mode has been set.
+ * 
+ * @param cli_arguments Initialized instance of the CliArguments structure.
+ * 
+ * @return TRUE if a block list is set else FALSE.
+ */
+extern
+BOOL
+uhashtools_cli_arguments_has_block_list_file
+(
+    const struct CliArguments* cli_arguments
+);
+
+/**
+ * Checks if a pipe name for the serve mode has been set.
+ * 
+ * @param cli_arguments Initialized instance of the CliArguments structure.
+ * 
+ * @return TRUE if a pipe name is set else FALSE.
+ */
+extern
+BOOL
+uhashtools_cli_arguments_has_serve_pipe_name
+(
+    const struct CliArguments* cli_arguments
+);
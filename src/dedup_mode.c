@@ -0,0 +1,699 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "dedup_mode.h"
+
+#include "buffer_sizes.h"
+#include "directory_walker.h"
+#include "error_utilities.h"
+#include "file_source_edges.h"
+#include "hash_calculation_impl.h"
+#include "io_scheduler.h"
+#include "print_utilities.h"
+#include "std_streams.h"
+
+#include <Windows.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Amount of bytes which are hashed from the start and from the end of
+ * each candidate. Files which differ usually already differ in their
+ * headers or trailers, and 4 KiB is a single read on most file systems.
+ */
+#define DEDUP_EDGE_SIZE (1024 * 4)
+
+#define DEDUP_FILES_INITIAL_CAPACITY 256
+
+struct DedupFile
+{
+    wchar_t* path;
+    unsigned __int64 size;
+
+    /* NULL if the file hasn't been hashed (yet) or if hashing it failed. */
+    wchar_t* partial_hash;
+    wchar_t* full_hash;
+};
+
+/*
+ * Buffers and counters owned by a single reader thread of the I/O
+ * scheduler. They are kept for all groups, so the buffers are only
+ * allocated once.
+ */
+struct DedupReaderCtx
+{
+    unsigned char* file_read_buf;
+    wchar_t* result_string_buf;
+    wchar_t error_message_buf[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    BOOL had_errors;
+    unsigned __int64 read_bytes;
+};
+
+struct DedupCtx
+{
+    struct DedupFile* files;
+    size_t files_count;
+    size_t files_capacity;
+
+    struct DedupReaderCtx* readers;
+    size_t readers_count;
+
+    /* Group which is hashed by the current "uhashtools_io_scheduler_run()" call. */
+    struct DedupFile* hashed_files;
+    BOOL is_hashing_full;
+
+    BOOL had_errors;
+    unsigned __int64 scanned_bytes;
+    unsigned __int64 read_bytes;
+    size_t duplicate_sets_count;
+    unsigned __int64 wasted_bytes;
+};
+
+static
+BOOL
+uhashtools_dedup_mode_add_file
+(
+    struct DedupCtx* ctx,
+    const wchar_t* path,
+    unsigned __int64 size
+)
+{
+    struct DedupFile* new_file = NULL;
+
+    if (ctx->files_count == ctx->files_capacity)
+    {
+        const size_t new_capacity = ctx->files_capacity ? ctx->files_capacity * 2 : DEDUP_FILES_INITIAL_CAPACITY;
+        struct DedupFile* new_files = (struct DedupFile*) realloc((void*) ctx->files, new_capacity * sizeof *new_files);
+
+        if (!new_files)
+        {
+            return FALSE;
+        }
+
+        ctx->files = new_files;
+        ctx->files_capacity = new_capacity;
+    }
+
+    new_file = &ctx->files[ctx->files_count];
+    (void) memset((void*) new_file, 0, sizeof *new_file);
+    new_file->path = _wcsdup(path);
+    new_file->size = size;
+
+    if (!new_file->path)
+    {
+        return FALSE;
+    }
+
+    ++ctx->files_count;
+    ctx->scanned_bytes += size;
+
+    return TRUE;
+}
+
+/* Collects the files for "uhashtools_directory_walker_walk()". */
+static
+BOOL
+uhashtools_dedup_mode_on_file_found
+(
+    const wchar_t* filepath,
+    unsigned __int64 file_size,
+    void* userdata
+)
+{
+    struct DedupCtx* ctx = (struct DedupCtx*) userdata;
+
+    /* Empty files are equal to each other, but they don't waste any space. */
+    if (file_size == 0)
+    {
+        return TRUE;
+    }
+
+    return uhashtools_dedup_mode_add_file(ctx, filepath, file_size);
+}
+
+static
+int
+uhashtools_dedup_mode_compare_hashes
+(
+    const wchar_t* left_hash,
+    const wchar_t* right_hash
+)
+{
+    /* Files without a hash are sorted to the end of their group. */
+    if (!left_hash || !right_hash)
+    {
+        return (left_hash == NULL) - (right_hash == NULL);
+    }
+
+    return wcscmp(left_hash, right_hash);
+}
+
+static
+int
+__cdecl
+uhashtools_dedup_mode_compare_by_size
+(
+    const void* left,
+    const void* right
+)
+{
+    const struct DedupFile* left_file = (const struct DedupFile*) left;
+    const struct DedupFile* right_file = (const struct DedupFile*) right;
+
+    if (left_file->size != right_file->size)
+    {
+        return left_file->size < right_file->size ? -1 : 1;
+    }
+
+    return wcscmp(left_file->path, right_file->path);
+}
+
+static
+int
+__cdecl
+uhashtools_dedup_mode_compare_by_partial_hash
+(
+    const void* left,
+    const void* right
+)
+{
+    const struct DedupFile* left_file = (const struct DedupFile*) left;
+    const struct DedupFile* right_file = (const struct DedupFile*) right;
+    const int hash_cmp_rc = uhashtools_dedup_mode_compare_hashes(left_file->partial_hash, right_file->partial_hash);
+
+    return hash_cmp_rc != 0 ? hash_cmp_rc : wcscmp(left_file->path, right_file->path);
+}
+
+static
+int
+__cdecl
+uhashtools_dedup_mode_compare_by_full_hash
+(
+    const void* left,
+    const void* right
+)
+{
+    const struct DedupFile* left_file = (const struct DedupFile*) left;
+    const struct DedupFile* right_file = (const struct DedupFile*) right;
+    const int hash_cmp_rc = uhashtools_dedup_mode_compare_hashes(left_file->full_hash, right_file->full_hash);
+
+    return hash_cmp_rc != 0 ? hash_cmp_rc : wcscmp(left_file->path, right_file->path);
+}
+
+/*
+ * Copies a calculated hash into the file. A file whose hash can't be
+ * copied is left without a hash like a file which couldn't be read.
+ */
+static
+wchar_t*
+uhashtools_dedup_mode_copy_hash
+(
+    BOOL* had_errors,
+    const struct DedupFile* file,
+    const wchar_t* hash
+)
+{
+    wchar_t* hash_copy = _wcsdup(hash);
+
+    if (!hash_copy)
+    {
+        (void) fwprintf_s(stderr, L"%s: Failed to allocate the required memory. Please download more RAM!\n", file->path);
+        *had_errors = TRUE;
+    }
+
+    return hash_copy;
+}
+
+static
+void
+uhashtools_dedup_mode_hash_partial
+(
+    struct DedupReaderCtx* reader,
+    struct DedupFile* file
+)
+{
+    struct FileSource file_source;
+    enum HashCalculatorResultCode hash_rc = HashCalculatorResultCode_FAILED;
+
+    file_source = uhashtools_file_source_edges_open(reader->error_message_buf,
+                                                    GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                    file->path,
+                                                    DEDUP_EDGE_SIZE);
+
+    if (!file_source.is_ok)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", file->path, reader->error_message_buf);
+        reader->had_errors = TRUE;
+
+        return;
+    }
+
+    hash_rc = uhashtools_hash_calculator_impl_hash_file_source(reader->file_read_buf,
+                                                               FILE_READ_BUF_TSIZE,
+                                                               reader->result_string_buf,
+                                                               HASH_RESULT_BUFFER_TSIZE,
+                                                               &file_source,
+                                                               NULL,
+                                                               NULL,
+                                                               NULL,
+                                                               NULL);
+
+    reader->read_bytes += file_source.size;
+    uhashtools_file_source_close(&file_source);
+
+    if (hash_rc != HashCalculatorResultCode_SUCCESS)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", file->path, reader->result_string_buf);
+        reader->had_errors = TRUE;
+
+        return;
+    }
+
+    file->partial_hash = uhashtools_dedup_mode_copy_hash(&reader->had_errors, file, reader->result_string_buf);
+}
+
+static
+void
+uhashtools_dedup_mode_hash_full
+(
+    struct DedupReaderCtx* reader,
+    struct DedupFile* file
+)
+{
+    enum HashCalculatorResultCode hash_rc = HashCalculatorResultCode_FAILED;
+
+    hash_rc = uhashtools_hash_calculator_impl_hash_file(reader->file_read_buf,
+                                                        FILE_READ_BUF_TSIZE,
+                                                        reader->result_string_buf,
+                                                        HASH_RESULT_BUFFER_TSIZE,
+                                                        file->path,
+                                                        NULL,
+                                                        NULL,
+                                                        NULL,
+                                                        NULL);
+
+    reader->read_bytes += file->size;
+
+    if (hash_rc != HashCalculatorResultCode_SUCCESS)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", file->path, reader->result_string_buf);
+        reader->had_errors = TRUE;
+
+        return;
+    }
+
+    file->full_hash = uhashtools_dedup_mode_copy_hash(&reader->had_errors, file, reader->result_string_buf);
+}
+
+/* Hashes a file of the current group for "uhashtools_io_scheduler_run()". */
+static
+void
+uhashtools_dedup_mode_hash_job
+(
+    const struct IoSchedulerJob* job,
+    void* opened_data,
+    size_t reader_index,
+    void* userdata
+)
+{
+    struct DedupCtx* ctx = (struct DedupCtx*) userdata;
+    struct DedupFile* file = &ctx->hashed_files[job->added_index];
+
+    UNREFERENCED_PARAMETER(opened_data);
+
+    if (ctx->is_hashing_full)
+    {
+        uhashtools_dedup_mode_hash_full(&ctx->readers[reader_index], file);
+    }
+    else
+    {
+        uhashtools_dedup_mode_hash_partial(&ctx->readers[reader_index], file);
+    }
+}
+
+/*
+ * Makes sure that there are at least "readers_count" reader contexts
+ * with allocated buffers.
+ */
+static
+BOOL
+uhashtools_dedup_mode_reserve_readers
+(
+    struct DedupCtx* ctx,
+    size_t readers_count
+)
+{
+    struct DedupReaderCtx* new_readers = NULL;
+
+    if (readers_count <= ctx->readers_count)
+    {
+        return TRUE;
+    }
+
+    new_readers = (struct DedupReaderCtx*) realloc((void*) ctx->readers, readers_count * sizeof *new_readers);
+
+    if (!new_readers)
+    {
+        return FALSE;
+    }
+
+    ctx->readers = new_readers;
+
+    while (ctx->readers_count < readers_count)
+    {
+        struct DedupReaderCtx* reader = &ctx->readers[ctx->readers_count];
+
+        (void) memset((void*) reader, 0, sizeof *reader);
+        ++ctx->readers_count;
+
+        reader->file_read_buf = (unsigned char*) malloc(FILE_READ_BUF_TSIZE);
+        reader->result_string_buf = (wchar_t*) malloc(HASH_RESULT_BUFFER_TSIZE * sizeof *reader->result_string_buf);
+
+        if (!reader->file_read_buf || !reader->result_string_buf)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Hashes the files of a group partially or completely. The files are
+ * read by the I/O scheduler, so the files of an SSD are read in
+ * parallel and the files of a hard disk in the order of their position
+ * on the disk.
+ */
+static
+void
+uhashtools_dedup_mode_hash_group
+(
+    struct DedupCtx* ctx,
+    struct DedupFile* files,
+    size_t files_count,
+    BOOL is_hashing_full
+)
+{
+    struct IoScheduler* io_scheduler = uhashtools_io_scheduler_create();
+    size_t i = 0;
+
+    if (!io_scheduler)
+    {
+        (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+        ctx->had_errors = TRUE;
+
+        return;
+    }
+
+    /* The job of the scheduler finds its file by the position in which it has been added. */
+    for (i = 0; i < files_count; ++i)
+    {
+        if (!uhashtools_io_scheduler_add_file(io_scheduler, files[i].path, files[i].size))
+        {
+            break;
+        }
+    }
+
+    if (i < files_count || !uhashtools_dedup_mode_reserve_readers(ctx, uhashtools_io_scheduler_prepare(io_scheduler)))
+    {
+        (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+        ctx->had_errors = TRUE;
+
+        goto cleanup_and_out;
+    }
+
+    ctx->hashed_files = files;
+    ctx->is_hashing_full = is_hashing_full;
+
+    if (!uhashtools_io_scheduler_run(io_scheduler, NULL, &uhashtools_dedup_mode_hash_job, (void*) ctx))
+    {
+        (void) fwprintf_s(stderr, L"Failed to start the reader threads!\n");
+        ctx->had_errors = TRUE;
+    }
+
+    ctx->hashed_files = NULL;
+
+cleanup_and_out:
+    uhashtools_io_scheduler_destroy(io_scheduler);
+}
+
+static
+void
+uhashtools_dedup_mode_report_duplicates
+(
+    struct DedupCtx* ctx,
+    const struct DedupFile* duplicates,
+    size_t duplicates_count
+)
+{
+    const unsigned __int64 wasted_bytes = duplicates->size * (duplicates_count - 1);
+    size_t i = 0;
+
+    ++ctx->duplicate_sets_count;
+    ctx->wasted_bytes += wasted_bytes;
+
+    (void) wprintf_s(L"# %Iu files with %I64u bytes each, %I64u bytes wasted\n",
+                     duplicates_count,
+                     duplicates->size,
+                     wasted_bytes);
+
+    for (i = 0; i < duplicates_count; ++i)
+    {
+        (void) wprintf_s(L"%s *%s\n", duplicates[i].full_hash, duplicates[i].path);
+    }
+
+    (void) wprintf_s(L"\n");
+}
+
+/*
+ * Returns the end of the group starting at "group_start" whose members
+ * have the same size and, if requested, the same partial or full hash.
+ * The files must be sorted by these keys. Files without the requested
+ * hash never form a group.
+ */
+static
+size_t
+uhashtools_dedup_mode_find_group_end
+(
+    const struct DedupFile* files,
+    size_t group_start,
+    size_t range_end,
+    BOOL compare_partial_hashes,
+    BOOL compare_full_hashes
+)
+{
+    size_t group_end = group_start + 1;
+
+    while (group_end < range_end &&
+           files[group_end].size == files[group_start].size &&
+           (!compare_partial_hashes ||
+            (files[group_start].partial_hash &&
+             uhashtools_dedup_mode_compare_hashes(files[group_end].partial_hash, files[group_start].partial_hash) == 0)) &&
+           (!compare_full_hashes ||
+            (files[group_start].full_hash &&
+             uhashtools_dedup_mode_compare_hashes(files[group_end].full_hash, files[group_start].full_hash) == 0)))
+    {
+        ++group_end;
+    }
+
+    return group_end;
+}
+
+/*
+ * Verifies a group of files whose partial hashes are colliding by
+ * hashing them completely.
+ */
+static
+void
+uhashtools_dedup_mode_process_partial_group
+(
+    struct DedupCtx* ctx,
+    struct DedupFile* files,
+    size_t files_count
+)
+{
+    size_t group_start = 0;
+    size_t i = 0;
+
+    /* Small files have been read completely for the partial hash already. */
+    if (files[0].size <= 2 * DEDUP_EDGE_SIZE)
+    {
+        for (i = 0; i < files_count; ++i)
+        {
+            files[i].full_hash = uhashtools_dedup_mode_copy_hash(&ctx->had_errors, &files[i], files[i].partial_hash);
+        }
+    }
+    else
+    {
+        uhashtools_dedup_mode_hash_group(ctx, files, files_count, TRUE);
+    }
+
+    qsort((void*) files, files_count, sizeof *files, &uhashtools_dedup_mode_compare_by_full_hash);
+
+    while (group_start < files_count)
+    {
+        const size_t group_end = uhashtools_dedup_mode_find_group_end(files, group_start, files_count, FALSE, TRUE);
+
+        if (group_end - group_start >= 2)
+        {
+            uhashtools_dedup_mode_report_duplicates(ctx, &files[group_start], group_end - group_start);
+        }
+
+        group_start = group_end;
+    }
+}
+
+/*
+ * Narrows a group of files with the same size down to the files whose
+ * partial hashes are colliding.
+ */
+static
+void
+uhashtools_dedup_mode_process_size_group
+(
+    struct DedupCtx* ctx,
+    struct DedupFile* files,
+    size_t files_count
+)
+{
+    size_t group_start = 0;
+
+    uhashtools_dedup_mode_hash_group(ctx, files, files_count, FALSE);
+
+    qsort((void*) files, files_count, sizeof *files, &uhashtools_dedup_mode_compare_by_partial_hash);
+
+    while (group_start < files_count)
+    {
+        const size_t group_end = uhashtools_dedup_mode_find_group_end(files, group_start, files_count, TRUE, FALSE);
+
+        if (group_end - group_start >= 2)
+        {
+            uhashtools_dedup_mode_process_partial_group(ctx, &files[group_start], group_end - group_start);
+        }
+
+        group_start = group_end;
+    }
+}
+
+static
+void
+uhashtools_dedup_mode_free_readers
+(
+    struct DedupCtx* ctx
+)
+{
+    size_t i = 0;
+
+    for (i = 0; i < ctx->readers_count; ++i)
+    {
+        free((void*) ctx->readers[i].result_string_buf);
+        free((void*) ctx->readers[i].file_read_buf);
+    }
+
+    free((void*) ctx->readers);
+    ctx->readers = NULL;
+    ctx->readers_count = 0;
+}
+
+static
+void
+uhashtools_dedup_mode_free_files
+(
+    struct DedupCtx* ctx
+)
+{
+    size_t i = 0;
+
+    for (i = 0; i < ctx->files_count; ++i)
+    {
+        free((void*) ctx->files[i].path);
+        free((void*) ctx->files[i].partial_hash);
+        free((void*) ctx->files[i].full_hash);
+    }
+
+    free((void*) ctx->files);
+    ctx->files = NULL;
+    ctx->files_count = 0;
+    ctx->files_capacity = 0;
+}
+
+int
+uhashtools_dedup_mode_run
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    int ret = 1;
+    struct DedupCtx ctx;
+    size_t group_start = 0;
+    size_t reader_index = 0;
+
+    UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
+    UHASHTOOLS_ASSERT(uhashtools_cli_arguments_has_dedup_directory(cli_arguments),
+                      L"Internal error: Entered dedup mode without a directory!");
+
+    uhashtools_std_streams_connect();
+
+    (void) memset((void*) &ctx, 0, sizeof ctx);
+
+    if (!uhashtools_directory_walker_walk(cli_arguments->dedup_directory,
+                                          &uhashtools_dedup_mode_on_file_found,
+                                          (void*) &ctx,
+                                          &ctx.had_errors))
+    {
+        (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+        goto cleanup_and_out;
+    }
+
+    UHASHTOOLS_PRINTF_LINE_INFO(L"Dedup mode: Found %Iu files with %I64u bytes.", ctx.files_count, ctx.scanned_bytes);
+
+    if (ctx.files_count > 0)
+    {
+        qsort((void*) ctx.files, ctx.files_count, sizeof *ctx.files, &uhashtools_dedup_mode_compare_by_size);
+    }
+
+    while (group_start < ctx.files_count)
+    {
+        const size_t group_end = uhashtools_dedup_mode_find_group_end(ctx.files, group_start, ctx.files_count, FALSE, FALSE);
+
+        if (group_end - group_start >= 2)
+        {
+            uhashtools_dedup_mode_process_size_group(&ctx, &ctx.files[group_start], group_end - group_start);
+        }
+
+        group_start = group_end;
+    }
+
+    for (reader_index = 0; reader_index < ctx.readers_count; ++reader_index)
+    {
+        ctx.had_errors |= ctx.readers[reader_index].had_errors;
+        ctx.read_bytes += ctx.readers[reader_index].read_bytes;
+    }
+
+    (void) wprintf_s(L"# %Iu duplicate sets, %I64u bytes wasted, %I64u of %I64u bytes read\n",
+                     ctx.duplicate_sets_count,
+                     ctx.wasted_bytes,
+                     ctx.read_bytes,
+                     ctx.scanned_bytes);
+
+    (void) fflush(stdout);
+
+    if (!ctx.had_errors)
+    {
+        ret = 0;
+    }
+
+cleanup_and_out:
+    uhashtools_dedup_mode_free_files(&ctx);
+    uhashtools_dedup_mode_free_readers(&ctx);
+
+    return ret;
+}
@@ -0,0 +1,46 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "cli_arguments.h"
+
+/*
+ * The dedup mode searches a directory tree for files with identical
+ * content. No window is created in this mode. To avoid reading every
+ * file completely the candidates are narrowed down in three steps:
+ * 
+ * 1. The files are grouped by their size. Files with a unique size
+ *    can't have a duplicate and are never opened.
+ * 2. Files of the same size are hashed over their first and last few
+ *    KiB (see "file_source_edges.h").
+ * 3. Only the files whose partial hashes are colliding are hashed
+ *    completely.
+ * 
+ * The files of each group are read by the I/O scheduler (see
+ * "io_scheduler.h"), so a group on an SSD is read in parallel and a
+ * group on a hard disk in the order of the positions of its files.
+ * 
+ * Every set of duplicates is written to stdout as a comment line with
+ * the wasted bytes, followed by one "<hash> *<filepath>" line per file.
+ */
+
+/**
+ * Runs the dedup mode for the directory from the command line arguments.
+ * 
+ * @param cli_arguments Command line arguments with a set dedup directory.
+ * 
+ * @return Exit code of the process. Zero if all files could be read
+ *         else one.
+ */
+extern
+int
+uhashtools_dedup_mode_run
+(
+    const struct CliArguments* cli_arguments
+);
@@ -0,0 +1,180 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "digest_cache.h"
+
+#include "buffer_sizes.h"
+#include "error_utilities.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+struct DigestCacheSlot
+{
+    /* NULL if the slot is empty. */
+    wchar_t* filepath;
+    unsigned __int64 file_size;
+    unsigned __int64 last_write_time;
+    struct HashDigest digest;
+};
+
+struct DigestCache
+{
+    CRITICAL_SECTION slots_lock;
+    struct DigestCacheSlot* slots;
+};
+
+/* FNV-1a over the UTF-16 code units of the path. */
+static
+size_t
+uhashtools_digest_cache_get_slot_index
+(
+    const wchar_t* filepath
+)
+{
+    unsigned int path_hash = 2166136261u;
+
+    for (; *filepath; ++filepath)
+    {
+        path_hash ^= (unsigned int) *filepath;
+        path_hash *= 16777619u;
+    }
+
+    return (size_t) (path_hash % DIGEST_CACHE_SLOTS_COUNT);
+}
+
+struct DigestCache*
+uhashtools_digest_cache_create
+(
+    void
+)
+{
+    struct DigestCache* digest_cache = NULL;
+
+    digest_cache = (struct DigestCache*) calloc(1, sizeof *digest_cache);
+
+    if (!digest_cache)
+    {
+        return NULL;
+    }
+
+    digest_cache->slots = (struct DigestCacheSlot*) calloc(DIGEST_CACHE_SLOTS_COUNT, sizeof *digest_cache->slots);
+
+    if (!digest_cache->slots)
+    {
+        free((void*) digest_cache);
+
+        return NULL;
+    }
+
+    InitializeCriticalSection(&digest_cache->slots_lock);
+
+    return digest_cache;
+}
+
+BOOL
+uhashtools_digest_cache_lookup
+(
+    struct DigestCache* digest_cache,
+    const wchar_t* filepath,
+    unsigned __int64 file_size,
+    unsigned __int64 last_write_time,
+    struct HashDigest* digest
+)
+{
+    const struct DigestCacheSlot* slot = NULL;
+    BOOL ret = FALSE;
+
+    UHASHTOOLS_ASSERT(digest_cache, L"Internal error: digest_cache is NULL!");
+    UHASHTOOLS_ASSERT(filepath, L"Internal error: filepath is NULL!");
+    UHASHTOOLS_ASSERT(digest, L"Internal error: digest is NULL!");
+
+    slot = &digest_cache->slots[uhashtools_digest_cache_get_slot_index(filepath)];
+
+    EnterCriticalSection(&digest_cache->slots_lock);
+
+    if (slot->filepath && wcscmp(slot->filepath, filepath) == 0 &&
+        slot->file_size == file_size && slot->last_write_time == last_write_time)
+    {
+        *digest = slot->digest;
+        ret = TRUE;
+    }
+
+    LeaveCriticalSection(&digest_cache->slots_lock);
+
+    return ret;
+}
+
+void
+uhashtools_digest_cache_store
+(
+    struct DigestCache* digest_cache,
+    const wchar_t* filepath,
+    unsigned __int64 file_size,
+    unsigned __int64 last_write_time,
+    const struct HashDigest* digest
+)
+{
+    struct DigestCacheSlot* slot = NULL;
+    wchar_t* filepath_copy = NULL;
+    wchar_t* replaced_filepath = NULL;
+
+    UHASHTOOLS_ASSERT(digest_cache, L"Internal error: digest_cache is NULL!");
+    UHASHTOOLS_ASSERT(filepath, L"Internal error: filepath is NULL!");
+    UHASHTOOLS_ASSERT(digest, L"Internal error: digest is NULL!");
+
+    if (wcslen(filepath) >= FILEPATH_BUFFER_TSIZE)
+    {
+        return;
+    }
+
+    /* The copy is made outside of the lock, a failed allocation only means that the file isn't cached. */
+    filepath_copy = _wcsdup(filepath);
+
+    if (!filepath_copy)
+    {
+        return;
+    }
+
+    slot = &digest_cache->slots[uhashtools_digest_cache_get_slot_index(filepath)];
+
+    EnterCriticalSection(&digest_cache->slots_lock);
+
+    replaced_filepath = slot->filepath;
+    slot->filepath = filepath_copy;
+    slot->file_size = file_size;
+    slot->last_write_time = last_write_time;
+    slot->digest = *digest;
+
+    LeaveCriticalSection(&digest_cache->slots_lock);
+
+    free((void*) replaced_filepath);
+}
+
+void
+uhashtools_digest_cache_destroy
+(
+    struct DigestCache* digest_cache
+)
+{
+    size_t slot_index = 0;
+
+    if (!digest_cache)
+    {
+        return;
+    }
+
+    for (slot_index = 0; slot_index < DIGEST_CACHE_SLOTS_COUNT; ++slot_index)
+    {
+        free((void*) digest_cache->slots[slot_index].filepath);
+    }
+
+    DeleteCriticalSection(&digest_cache->slots_lock);
+    free((void*) digest_cache->slots);
+    free((void*) digest_cache);
+}
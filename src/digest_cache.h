@@ -0,0 +1,95 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "hash_calculation_impl.h"
+
+#include <Windows.h>
+
+/*
+ * Remembers the digests of already hashed files for a long running
+ * process. Like in the manifest mode a file counts as unchanged as long
+ * as its size and last write time are the same.
+ * 
+ * The cache has a fixed amount of slots and every filepath has exactly
+ * one slot, which is selected by a hash of the path. A new entry
+ * replaces the previous entry of its slot, so the memory usage stays
+ * the same no matter how many files are hashed. All functions can be
+ * called from multiple threads at the same time.
+ */
+
+#define DIGEST_CACHE_SLOTS_COUNT (1024 * 64)
+
+struct DigestCache;
+
+/**
+ * Creates an empty cache.
+ * 
+ * @return Created cache or NULL if the memory allocation failed.
+ */
+extern
+struct DigestCache*
+uhashtools_digest_cache_create
+(
+    void
+);
+
+/**
+ * Looks up the digest of a file.
+ * 
+ * @param digest_cache Created cache.
+ * @param filepath Path of the file as requested.
+ * @param file_size Current size of the file.
+ * @param last_write_time Current last write time of the file as FILETIME value.
+ * @param digest Receives the digest if the file is found.
+ * 
+ * @return TRUE if the file has been found with the same size and last
+ *         write time else FALSE.
+ */
+extern
+BOOL
+uhashtools_digest_cache_lookup
+(
+    struct DigestCache* digest_cache,
+    const wchar_t* filepath,
+    unsigned __int64 file_size,
+    unsigned __int64 last_write_time,
+    struct HashDigest* digest
+);
+
+/**
+ * Stores the digest of a file. Paths which don't fit into
+ * FILEPATH_BUFFER_TSIZE characters are silently not stored.
+ * 
+ * @param digest_cache Created cache.
+ * @param filepath Path of the file as requested.
+ * @param file_size Size of the file before it has been hashed.
+ * @param last_write_time Last write time of the file before it has been hashed.
+ * @param digest Digest of the file.
+ */
+extern
+void
+uhashtools_digest_cache_store
+(
+    struct DigestCache* digest_cache,
+    const wchar_t* filepath,
+    unsigned __int64 file_size,
+    unsigned __int64 last_write_time,
+    const struct HashDigest* digest
+);
+
+/**
+ * Destroys the cache. Passing NULL is allowed.
+ */
+extern
+void
+uhashtools_digest_cache_destroy
+(
+    struct DigestCache* digest_cache
+);
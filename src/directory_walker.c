@@ -0,0 +1,217 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "directory_walker.h"
+
+#include "buffer_sizes.h"
+#include "error_utilities.h"
+
+#include <stdio.h>
+#include <string.h>
+
+struct DirectoryWalkerCtx
+{
+    wchar_t path_buf[FILEPATH_BUFFER_TSIZE];
+    DirectoryWalkerFileCallbackFunction* file_callback;
+    void* file_callback_userdata;
+    BOOL* had_errors;
+};
+
+/*
+ * Visits all entries below the directory in "path_buf". The buffer is
+ * shared by all recursion levels, every level appends its entry names
+ * and restores the previous content before returning.
+ */
+static
+BOOL
+uhashtools_directory_walker_walk_directory
+(
+    struct DirectoryWalkerCtx* ctx,
+    size_t path_len
+)
+{
+    WIN32_FIND_DATAW find_data;
+    HANDLE find_handle = INVALID_HANDLE_VALUE;
+    BOOL ret = TRUE;
+
+    if (path_len + 3 > FILEPATH_BUFFER_TSIZE)
+    {
+        (void) fwprintf_s(stderr, L"%s: The path is too long and has been skipped!\n", ctx->path_buf);
+        *ctx->had_errors = TRUE;
+
+        return TRUE;
+    }
+
+    (void) wcscpy_s(ctx->path_buf + path_len, FILEPATH_BUFFER_TSIZE - path_len, L"\\*");
+
+    find_handle = FindFirstFileExW(ctx->path_buf,
+                                   FindExInfoBasic,
+                                   &find_data,
+                                   FindExSearchNameMatch,
+                                   NULL,
+                                   FIND_FIRST_EX_LARGE_FETCH);
+
+    ctx->path_buf[path_len] = L'\0';
+
+    if (find_handle == INVALID_HANDLE_VALUE)
+    {
+        (void) fwprintf_s(stderr, L"%s: Failed to list the directory!\n", ctx->path_buf);
+        *ctx->had_errors = TRUE;
+
+        return TRUE;
+    }
+
+    do
+    {
+        size_t entry_path_len = 0;
+
+        if (wcscmp(find_data.cFileName, L".") == 0 || wcscmp(find_data.cFileName, L"..") == 0 ||
+            (find_data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT))
+        {
+            continue;
+        }
+
+        entry_path_len = path_len + 1 + wcslen(find_data.cFileName);
+
+        /* The entry must also fit for appending "\*" if it's a directory. */
+        if (entry_path_len + 3 > FILEPATH_BUFFER_TSIZE)
+        {
+            (void) fwprintf_s(stderr, L"%s\\%s: The path is too long and has been skipped!\n", ctx->path_buf, find_data.cFileName);
+            *ctx->had_errors = TRUE;
+
+            continue;
+        }
+
+        ctx->path_buf[path_len] = L'\\';
+        (void) wcscpy_s(ctx->path_buf + path_len + 1, FILEPATH_BUFFER_TSIZE - path_len - 1, find_data.cFileName);
+
+        if (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        {
+            ret = uhashtools_directory_walker_walk_directory(ctx, entry_path_len);
+        }
+        else
+        {
+            const unsigned __int64 file_size = ((unsigned __int64) find_data.nFileSizeHigh << 32) | find_data.nFileSizeLow;
+
+            ret = ctx->file_callback(ctx->path_buf, file_size, ctx->file_callback_userdata);
+        }
+
+        ctx->path_buf[path_len] = L'\0';
+    }
+    while (ret && FindNextFileW(find_handle, &find_data));
+
+    (void) FindClose(find_handle);
+
+    return ret;
+}
+
+BOOL
+uhashtools_directory_walker_walk
+(
+    const wchar_t* directory,
+    DirectoryWalkerFileCallbackFunction* file_callback,
+    void* file_callback_userdata,
+    BOOL* had_errors
+)
+{
+    struct DirectoryWalkerCtx ctx;
+    size_t path_len = 0;
+
+    UHASHTOOLS_ASSERT(directory, L"Internal error: directory is NULL!");
+    UHASHTOOLS_ASSERT(file_callback, L"Internal error: file_callback is NULL!");
+    UHASHTOOLS_ASSERT(had_errors, L"Internal error: had_errors is NULL!");
+
+    path_len = wcslen(directory);
+
+    if (path_len >= FILEPATH_BUFFER_TSIZE)
+    {
+        (void) fwprintf_s(stderr, L"%s: The path is too long and has been skipped!\n", directory);
+        *had_errors = TRUE;
+
+        return TRUE;
+    }
+
+    (void) wcscpy_s(ctx.path_buf, FILEPATH_BUFFER_TSIZE, directory);
+    ctx.file_callback = file_callback;
+    ctx.file_callback_userdata = file_callback_userdata;
+    ctx.had_errors = had_errors;
+
+    /* The separator is appended while walking the directory tree. */
+    while (path_len > 0 && (ctx.path_buf[path_len - 1] == L'\\' || ctx.path_buf[path_len - 1] == L'/'))
+    {
+        ctx.path_buf[--path_len] = L'\0';
+    }
+
+    return uhashtools_directory_walker_walk_directory(&ctx, path_len);
+}
+
+BOOL
+uhashtools_directory_walker_list
+(
+    const wchar_t* directory,
+    DirectoryWalkerEntryCallbackFunction* entry_callback,
+    void* entry_callback_userdata
+)
+{
+    wchar_t search_pattern[FILEPATH_BUFFER_TSIZE];
+    WIN32_FIND_DATAW find_data;
+    HANDLE find_handle = INVALID_HANDLE_VALUE;
+    BOOL ret = TRUE;
+
+    UHASHTOOLS_ASSERT(directory, L"Internal error: directory is NULL!");
+    UHASHTOOLS_ASSERT(entry_callback, L"Internal error: entry_callback is NULL!");
+
+    if (wcslen(directory) + 3 > FILEPATH_BUFFER_TSIZE)
+    {
+        return FALSE;
+    }
+
+    (void) wcscpy_s(search_pattern, FILEPATH_BUFFER_TSIZE, directory);
+    (void) wcscat_s(search_pattern, FILEPATH_BUFFER_TSIZE, L"\\*");
+
+    find_handle = FindFirstFileExW(search_pattern,
+                                   FindExInfoBasic,
+                                   &find_data,
+                                   FindExSearchNameMatch,
+                                   NULL,
+                                   FIND_FIRST_EX_LARGE_FETCH);
+
+    if (find_handle == INVALID_HANDLE_VALUE)
+    {
+        return FALSE;
+    }
+
+    do
+    {
+        struct DirectoryWalkerEntry entry;
+
+        if (wcscmp(find_data.cFileName, L".") == 0 || wcscmp(find_data.cFileName, L"..") == 0 ||
+            (find_data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT))
+        {
+            continue;
+        }
+
+        entry.name = find_data.cFileName;
+        entry.is_directory = (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        entry.file_size = 0;
+        entry.last_write_time = ((unsigned __int64) find_data.ftLastWriteTime.dwHighDateTime << 32) |
+                                find_data.ftLastWriteTime.dwLowDateTime;
+
+        if (!entry.is_directory)
+        {
+            entry.file_size = ((unsigned __int64) find_data.nFileSizeHigh << 32) | find_data.nFileSizeLow;
+        }
+
+        ret = entry_callback(&entry, entry_callback_userdata);
+    }
+    while (ret && FindNextFileW(find_handle, &find_data));
+
+    (void) FindClose(find_handle);
+
+    return ret;
+}
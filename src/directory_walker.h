@@ -0,0 +1,101 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+/**
+ * Is called for every regular file found by the directory walker.
+ * 
+ * @param filepath Path of the found file. Only valid during the call.
+ * @param file_size Size of the found file in bytes.
+ * @param userdata Userdata passed to "uhashtools_directory_walker_walk()".
+ * 
+ * @return TRUE to continue walking or FALSE to stop it.
+ */
+typedef BOOL DirectoryWalkerFileCallbackFunction(const wchar_t* filepath,
+                                                 unsigned __int64 file_size,
+                                                 void* userdata);
+
+/**
+ * Walks recursively through a directory tree and calls "file_callback"
+ * for every regular file. Reparse points (symbolic links and junctions)
+ * are skipped, so no file is visited twice and cycles can't occur.
+ * 
+ * Directories which can't be listed and paths which are longer than
+ * FILEPATH_BUFFER_TSIZE are reported on stderr and skipped. For the
+ * batches of the results window those reports are only visible if the
+ * application has been started from a console.
+ * 
+ * @param directory Directory to walk through.
+ * @param file_callback Function which is called for every found file.
+ * @param file_callback_userdata Userdata for "file_callback".
+ * @param had_errors Is set to TRUE if a directory or a file had to be skipped.
+ * 
+ * @return FALSE if the walk has been stopped by "file_callback" else TRUE.
+ */
+extern
+BOOL
+uhashtools_directory_walker_walk
+(
+    const wchar_t* directory,
+    DirectoryWalkerFileCallbackFunction* file_callback,
+    void* file_callback_userdata,
+    BOOL* had_errors
+);
+
+/**
+ * Entry of a directory as passed to "DirectoryWalkerEntryCallbackFunction".
+ */
+struct DirectoryWalkerEntry
+{
+    /* Name of the entry without the path. Only valid during the call. */
+    const wchar_t* name;
+    BOOL is_directory;
+
+    /* Size in bytes. Zero for directories. */
+    unsigned __int64 file_size;
+
+    /* Last write time as FILETIME value (100 ns units since 1601). */
+    unsigned __int64 last_write_time;
+};
+
+/**
+ * Is called for every entry found by "uhashtools_directory_walker_list()".
+ * 
+ * @param entry Found entry.
+ * @param userdata Userdata passed to "uhashtools_directory_walker_list()".
+ * 
+ * @return TRUE to continue listing or FALSE to stop it.
+ */
+typedef BOOL DirectoryWalkerEntryCallbackFunction(const struct DirectoryWalkerEntry* entry,
+                                                  void* userdata);
+
+/**
+ * Lists the regular files and subdirectories of a single directory
+ * without descending into the subdirectories. Like with
+ * "uhashtools_directory_walker_walk()" reparse points are skipped. The
+ * entries are passed in the order reported by the file system.
+ * 
+ * @param directory Directory to list. Must not end with a path separator.
+ * @param entry_callback Function which is called for every found entry.
+ * @param entry_callback_userdata Userdata for "entry_callback".
+ * 
+ * @return TRUE if the directory has been listed completely and FALSE if it
+ *         couldn't be listed or the listing has been stopped by
+ *         "entry_callback".
+ */
+extern
+BOOL
+uhashtools_directory_walker_list
+(
+    const wchar_t* directory,
+    DirectoryWalkerEntryCallbackFunction* entry_callback,
+    void* entry_callback_userdata
+);
@@ -8,6 +8,8 @@
 
 #include "error_utilities.h"
 
+#include "logger.h"
+
 #include <Windows.h>
 
 static HWND message_boxes_owner = NULL;
@@ -39,6 +41,9 @@ uhashtools_handle_fatal_error
     const wchar_t* error_txt
 )
 {
+  /* Writing the queued log lines first, they may describe the cause of the error. */
+  uhashtools_logger_stop();
+
   uhashtools_show_error_msg(error_title, error_txt);
   FatalExit(1);
 }
@@ -0,0 +1,129 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "file_source.h"
+
+#include "error_utilities.h"
+#include "file_source_crt.h"
+#include "file_source_overlapped.h"
+#include "file_source_stream.h"
+#include "print_utilities.h"
+
+#ifdef _DEBUG
+    #include "file_source_synthetic.h"
+#endif
+
+#include <string.h>
+
+struct FileSource
+uhashtools_file_source_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* target_file
+)
+{
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(target_file, L"Internal error: target_file is NULL!");
+
+#ifdef _DEBUG
+    if (uhashtools_file_source_synthetic_is_spec(target_file))
+    {
+        return uhashtools_file_source_synthetic_open(error_message_buf,
+                                                     error_message_buf_tsize,
+                                                     target_file);
+    }
+#endif
+
+    if (uhashtools_file_source_stream_is_stream_target(target_file))
+    {
+        return uhashtools_file_source_stream_open(error_message_buf,
+                                                  error_message_buf_tsize,
+                                                  target_file);
+    }
+
+    return uhashtools_file_source_open_regular_file(error_message_buf,
+                                                    error_message_buf_tsize,
+                                                    target_file);
+}
+
+struct FileSource
+uhashtools_file_source_open_regular_file
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* target_file
+)
+{
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(target_file, L"Internal error: target_file is NULL!");
+
+    if (uhashtools_file_source_overlapped_is_suitable(target_file))
+    {
+        struct FileSource overlapped_file_source = uhashtools_file_source_overlapped_open(error_message_buf,
+                                                                                          error_message_buf_tsize,
+                                                                                          target_file);
+
+        if (overlapped_file_source.is_ok)
+        {
+            return overlapped_file_source;
+        }
+
+        /* For example file systems which don't support unbuffered reads. */
+        UHASHTOOLS_PRINTF_LINE_INFO(L"Failed to open the file for overlapped reads. Falling back to the CRT file source.");
+    }
+
+    return uhashtools_file_source_crt_open(error_message_buf,
+                                           error_message_buf_tsize,
+                                           target_file);
+}
+
+BOOL
+uhashtools_file_source_read
+(
+    struct FileSource* file_source,
+    unsigned char* read_buf,
+    size_t read_buf_size,
+    const unsigned char** read_data,
+    size_t* read_data_size,
+    BOOL* reached_eof
+)
+{
+    UHASHTOOLS_ASSERT(file_source && file_source->is_ok,
+                      L"Internal error: Entered with a not opened file source!");
+    UHASHTOOLS_ASSERT(read_data && read_data_size && reached_eof,
+                      L"Internal error: Entered with a NULL output argument!");
+
+    *read_data = NULL;
+    *read_data_size = 0;
+    *reached_eof = FALSE;
+
+    return file_source->read_function(file_source,
+                                      read_buf,
+                                      read_buf_size,
+                                      read_data,
+                                      read_data_size,
+                                      reached_eof);
+}
+
+void
+uhashtools_file_source_close
+(
+    struct FileSource* file_source
+)
+{
+    if (!file_source || !file_source->is_ok)
+    {
+        return;
+    }
+
+    file_source->close_function(file_source);
+
+    (void) memset((void*) file_source, 0, sizeof *file_source);
+    file_source->is_ok = FALSE;
+}
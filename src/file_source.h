@@ -0,0 +1,142 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+struct FileSource;
+
+/**
+ * Reads the next block of data from the file source.
+ * 
+ * The backend can either copy the data into the provided "read_buf"
+ * buffer or let "read_data" point to memory owned by the backend.
+ * In both cases the returned data stays valid until the next call of
+ * a function of this file source.
+ * 
+ * @param file_source Opened file source.
+ * @param read_buf Buffer which the backend may use to store the read data.
+ * @param read_buf_size Size of "read_buf" in bytes.
+ * @param read_data Receives the pointer to the read data.
+ * @param read_data_size Receives the amount of read bytes. This amount is never
+ *                       bigger than "read_buf_size".
+ * @param reached_eof Is set to TRUE if the end of the file source has been reached.
+ *                    The data returned by this call must still be processed.
+ * 
+ * @return TRUE on success and FALSE on a read error.
+ */
+typedef BOOL FileSourceReadFunction(struct FileSource* file_source,
+                                    unsigned char* read_buf,
+                                    size_t read_buf_size,
+                                    const unsigned char** read_data,
+                                    size_t* read_data_size,
+                                    BOOL* reached_eof);
+
+/**
+ * Releases all resources of the backend.
+ * 
+ * @param file_source Opened file source.
+ */
+typedef void FileSourceCloseFunction(struct FileSource* file_source);
+
+/**
+ * Abstraction over the origin of the data which gets hashed.
+ * The hashing implementation only accesses the data of the target
+ * file through this structure which allows to replace the regular
+ * file access with other backends.
+ */
+struct FileSource
+{
+    BOOL is_ok;
+
+    /**
+     * FALSE if the size of the data isn't known in advance (for example
+     * if the data is read from a pipe). In this case "size" is zero and
+     * the data must be read until the backend signals the end of file.
+     */
+    BOOL has_known_size;
+    unsigned __int64 size;
+    FileSourceReadFunction* read_function;
+    FileSourceCloseFunction* close_function;
+    void* backend_data;
+};
+
+/**
+ * Opens the given target and selects the matching backend for it.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if the
+ *                          target can't be opened.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param target_file Filepath of the target file. "-" selects the standard input
+ *                    and a path starting with "\\.\pipe\" selects a named pipe
+ *                    (see "file_source_stream.h"). In debug builds this can also be
+ *                    the specification of a synthetic file source (see
+ *                    "file_source_synthetic.h").
+ * 
+ * @return Opened file source. If the member "is_ok" is FALSE the target couldn't be
+ *         opened and "error_message_buf" contains the reason.
+ */
+extern
+struct FileSource
+uhashtools_file_source_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* target_file
+);
+
+/**
+ * Opens the given target as regular file. Unlike "uhashtools_file_source_open()"
+ * the target is never interpreted as the standard input, a named pipe or the
+ * specification of a synthetic file source.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if the
+ *                          file can't be opened.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param target_file Filepath of the target file.
+ * 
+ * @return Opened file source. See "uhashtools_file_source_open()" for details.
+ */
+extern
+struct FileSource
+uhashtools_file_source_open_regular_file
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* target_file
+);
+
+/**
+ * Reads the next block of data from the file source.
+ * See "FileSourceReadFunction" for the description of the parameters.
+ */
+extern
+BOOL
+uhashtools_file_source_read
+(
+    struct FileSource* file_source,
+    unsigned char* read_buf,
+    size_t read_buf_size,
+    const unsigned char** read_data,
+    size_t* read_data_size,
+    BOOL* reached_eof
+);
+
+/**
+ * Closes the file source. Calling this function with an already
+ * closed or not successfully opened file source is allowed.
+ * 
+ * @param file_source File source to close.
+ */
+extern
+void
+uhashtools_file_source_close
+(
+    struct FileSource* file_source
+);
@@ -0,0 +1,562 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "file_source_archive.h"
+
+#include "error_utilities.h"
+#include "print_utilities.h"
+
+#include <process.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * The queue holds at most ARCHIVE_QUEUE_SLOT_COUNT blocks of
+ * decompressed data, so the memory consumption is limited to 2 MiB
+ * for the data of the queue.
+ */
+#define ARCHIVE_QUEUE_SLOT_COUNT 8
+#define ARCHIVE_QUEUE_SLOT_DATA_SIZE (1024 * 256)
+#define ARCHIVE_READER_THREAD_STACK_SIZE (1024 * 64)
+
+enum ArchiveQueueSlotType
+{
+    ARCHIVE_QUEUE_SLOT_TYPE_ENTRY_BEGIN,
+    ARCHIVE_QUEUE_SLOT_TYPE_ENTRY_DATA,
+    ARCHIVE_QUEUE_SLOT_TYPE_ARCHIVE_END,
+    ARCHIVE_QUEUE_SLOT_TYPE_FAILED
+};
+
+struct ArchiveQueueSlot
+{
+    enum ArchiveQueueSlotType type;
+
+    /* Only valid for ARCHIVE_QUEUE_SLOT_TYPE_ENTRY_BEGIN */
+    struct ArchiveEntryInfo entry_info;
+
+    /* Only valid for ARCHIVE_QUEUE_SLOT_TYPE_ENTRY_DATA */
+    unsigned char* data;
+    size_t data_size;
+    BOOL is_last_block;
+};
+
+struct ArchiveFileSourceCtx
+{
+    struct ArchiveReader* archive_reader;
+    HANDLE reader_thread_handle;
+
+    /*
+     * Ring buffer of the queue. The slots from "queue_head" up to
+     * "queue_count" slots after it are filled by the reader thread
+     * and owned by the consumer.
+     */
+    CRITICAL_SECTION queue_lock;
+    CONDITION_VARIABLE queue_slot_filled;
+    CONDITION_VARIABLE queue_slot_free;
+    struct ArchiveQueueSlot queue_slots[ARCHIVE_QUEUE_SLOT_COUNT];
+    unsigned char* queue_data_memory;
+    size_t queue_head;
+    size_t queue_count;
+    BOOL stop_requested;
+
+    /* State of the consumer */
+    struct ArchiveQueueSlot* held_slot;
+    size_t held_slot_offset;
+    BOOL entry_is_open;
+    BOOL entry_reached_eof;
+    BOOL archive_reached_end;
+    enum ArchiveReaderResult archive_end_result;
+
+    wchar_t error_message[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+};
+
+/* Reader thread side of the queue */
+
+static
+struct ArchiveQueueSlot*
+uhashtools_file_source_archive_acquire_free_slot
+(
+    struct ArchiveFileSourceCtx* ctx
+)
+{
+    struct ArchiveQueueSlot* ret = NULL;
+
+    EnterCriticalSection(&ctx->queue_lock);
+
+    while (ctx->queue_count == ARCHIVE_QUEUE_SLOT_COUNT && !ctx->stop_requested)
+    {
+        (void) SleepConditionVariableCS(&ctx->queue_slot_free, &ctx->queue_lock, INFINITE);
+    }
+
+    if (!ctx->stop_requested)
+    {
+        ret = &ctx->queue_slots[(ctx->queue_head + ctx->queue_count) % ARCHIVE_QUEUE_SLOT_COUNT];
+    }
+
+    LeaveCriticalSection(&ctx->queue_lock);
+
+    return ret;
+}
+
+static
+void
+uhashtools_file_source_archive_publish_slot
+(
+    struct ArchiveFileSourceCtx* ctx
+)
+{
+    EnterCriticalSection(&ctx->queue_lock);
+    ++ctx->queue_count;
+    WakeConditionVariable(&ctx->queue_slot_filled);
+    LeaveCriticalSection(&ctx->queue_lock);
+}
+
+static
+BOOL
+uhashtools_file_source_archive_produce_entry_data
+(
+    struct ArchiveFileSourceCtx* ctx
+)
+{
+    BOOL reached_eof = FALSE;
+
+    while (!reached_eof)
+    {
+        struct ArchiveQueueSlot* slot = uhashtools_file_source_archive_acquire_free_slot(ctx);
+
+        if (!slot)
+        {
+            return FALSE;
+        }
+
+        slot->data_size = 0;
+
+        /* Filling the whole slot keeps the synchronization overhead low. */
+        while (!reached_eof && slot->data_size < ARCHIVE_QUEUE_SLOT_DATA_SIZE)
+        {
+            size_t read_size = 0;
+
+            if (!uhashtools_archive_reader_read_entry_data(ctx->archive_reader,
+                                                           slot->data + slot->data_size,
+                                                           ARCHIVE_QUEUE_SLOT_DATA_SIZE - slot->data_size,
+                                                           &read_size,
+                                                           &reached_eof))
+            {
+                (void) wcscpy_s(ctx->error_message,
+                                GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                uhashtools_archive_reader_get_error_message(ctx->archive_reader));
+
+                slot->type = ARCHIVE_QUEUE_SLOT_TYPE_FAILED;
+                uhashtools_file_source_archive_publish_slot(ctx);
+
+                return FALSE;
+            }
+
+            slot->data_size += read_size;
+        }
+
+        slot->type = ARCHIVE_QUEUE_SLOT_TYPE_ENTRY_DATA;
+        slot->is_last_block = reached_eof;
+        uhashtools_file_source_archive_publish_slot(ctx);
+    }
+
+    return TRUE;
+}
+
+static
+unsigned int
+__stdcall
+uhashtools_file_source_archive_reader_thread_function
+(
+    void* thread_param
+)
+{
+    struct ArchiveFileSourceCtx* ctx = (struct ArchiveFileSourceCtx*) thread_param;
+
+    for (;;)
+    {
+        struct ArchiveEntryInfo entry_info;
+        enum ArchiveReaderResult next_entry_rc = ARCHIVE_READER_RESULT_FAILED;
+        struct ArchiveQueueSlot* slot = NULL;
+
+        next_entry_rc = uhashtools_archive_reader_next_entry(ctx->archive_reader, &entry_info);
+        slot = uhashtools_file_source_archive_acquire_free_slot(ctx);
+
+        if (!slot)
+        {
+            break;
+        }
+
+        if (next_entry_rc == ARCHIVE_READER_RESULT_END)
+        {
+            slot->type = ARCHIVE_QUEUE_SLOT_TYPE_ARCHIVE_END;
+            uhashtools_file_source_archive_publish_slot(ctx);
+            break;
+        }
+
+        if (next_entry_rc == ARCHIVE_READER_RESULT_FAILED)
+        {
+            (void) wcscpy_s(ctx->error_message,
+                            GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                            uhashtools_archive_reader_get_error_message(ctx->archive_reader));
+
+            slot->type = ARCHIVE_QUEUE_SLOT_TYPE_FAILED;
+            uhashtools_file_source_archive_publish_slot(ctx);
+            break;
+        }
+
+        slot->type = ARCHIVE_QUEUE_SLOT_TYPE_ENTRY_BEGIN;
+        slot->entry_info = entry_info;
+        uhashtools_file_source_archive_publish_slot(ctx);
+
+        if (!uhashtools_file_source_archive_produce_entry_data(ctx))
+        {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+/* Consumer side of the queue */
+
+static
+struct ArchiveQueueSlot*
+uhashtools_file_source_archive_take_slot
+(
+    struct ArchiveFileSourceCtx* ctx
+)
+{
+    struct ArchiveQueueSlot* ret = NULL;
+
+    EnterCriticalSection(&ctx->queue_lock);
+
+    while (ctx->queue_count == 0)
+    {
+        (void) SleepConditionVariableCS(&ctx->queue_slot_filled, &ctx->queue_lock, INFINITE);
+    }
+
+    ret = &ctx->queue_slots[ctx->queue_head];
+
+    LeaveCriticalSection(&ctx->queue_lock);
+
+    if (ret->type == ARCHIVE_QUEUE_SLOT_TYPE_ARCHIVE_END || ret->type == ARCHIVE_QUEUE_SLOT_TYPE_FAILED)
+    {
+        /* The reader thread has finished, so this slot is never released. */
+        ctx->archive_reached_end = TRUE;
+        ctx->archive_end_result = ret->type == ARCHIVE_QUEUE_SLOT_TYPE_ARCHIVE_END ? ARCHIVE_READER_RESULT_END
+                                                                                    : ARCHIVE_READER_RESULT_FAILED;
+    }
+
+    return ret;
+}
+
+static
+void
+uhashtools_file_source_archive_release_slot
+(
+    struct ArchiveFileSourceCtx* ctx
+)
+{
+    EnterCriticalSection(&ctx->queue_lock);
+    ctx->queue_head = (ctx->queue_head + 1) % ARCHIVE_QUEUE_SLOT_COUNT;
+    --ctx->queue_count;
+    WakeConditionVariable(&ctx->queue_slot_free);
+    LeaveCriticalSection(&ctx->queue_lock);
+}
+
+static
+void
+uhashtools_file_source_archive_release_held_slot
+(
+    struct ArchiveFileSourceCtx* ctx
+)
+{
+    if (ctx->held_slot)
+    {
+        uhashtools_file_source_archive_release_slot(ctx);
+        ctx->held_slot = NULL;
+        ctx->held_slot_offset = 0;
+    }
+}
+
+static
+BOOL
+uhashtools_file_source_archive_read
+(
+    struct FileSource* file_source,
+    unsigned char* read_buf,
+    size_t read_buf_size,
+    const unsigned char** read_data,
+    size_t* read_data_size,
+    BOOL* reached_eof
+)
+{
+    struct ArchiveFileSourceCtx* ctx = (struct ArchiveFileSourceCtx*) file_source->backend_data;
+    struct ArchiveQueueSlot* slot = NULL;
+    size_t remaining_slot_data_size = 0;
+
+    (void) read_buf;
+
+    *read_data = NULL;
+    *read_data_size = 0;
+
+    if (ctx->entry_reached_eof)
+    {
+        *reached_eof = TRUE;
+
+        return TRUE;
+    }
+
+    if (!ctx->held_slot || ctx->held_slot_offset >= ctx->held_slot->data_size)
+    {
+        uhashtools_file_source_archive_release_held_slot(ctx);
+
+        if (ctx->archive_reached_end)
+        {
+            return FALSE;
+        }
+
+        slot = uhashtools_file_source_archive_take_slot(ctx);
+
+        if (slot->type != ARCHIVE_QUEUE_SLOT_TYPE_ENTRY_DATA)
+        {
+            return FALSE;
+        }
+
+        ctx->held_slot = slot;
+        ctx->held_slot_offset = 0;
+    }
+
+    slot = ctx->held_slot;
+    remaining_slot_data_size = slot->data_size - ctx->held_slot_offset;
+
+    if (remaining_slot_data_size > read_buf_size)
+    {
+        remaining_slot_data_size = read_buf_size;
+    }
+
+    *read_data = slot->data + ctx->held_slot_offset;
+    *read_data_size = remaining_slot_data_size;
+    ctx->held_slot_offset += remaining_slot_data_size;
+
+    if (slot->is_last_block && ctx->held_slot_offset == slot->data_size)
+    {
+        ctx->entry_reached_eof = TRUE;
+        *reached_eof = TRUE;
+    }
+
+    return TRUE;
+}
+
+static
+void
+uhashtools_file_source_archive_close
+(
+    struct FileSource* file_source
+)
+{
+    struct ArchiveFileSourceCtx* ctx = (struct ArchiveFileSourceCtx*) file_source->backend_data;
+
+    /* The remaining data of the entry is skipped by the next call of "uhashtools_file_source_archive_next_entry()". */
+    uhashtools_file_source_archive_release_held_slot(ctx);
+}
+
+/* API functions */
+
+struct ArchiveFileSourceCtx*
+uhashtools_file_source_archive_start
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* archive_file
+)
+{
+    struct ArchiveFileSourceCtx* ret = NULL;
+    struct ArchiveFileSourceCtx* ctx = NULL;
+    uintptr_t thread_handle = 0;
+    unsigned int thread_id = 0;
+    size_t slot_index = 0;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(archive_file, L"Internal error: archive_file is NULL!");
+
+    ctx = (struct ArchiveFileSourceCtx*) calloc(1, sizeof *ctx);
+
+    if (ctx)
+    {
+        ctx->queue_data_memory = (unsigned char*) malloc(ARCHIVE_QUEUE_SLOT_COUNT * ARCHIVE_QUEUE_SLOT_DATA_SIZE);
+    }
+
+    if (!ctx || !ctx->queue_data_memory)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+
+        goto cleanup_and_out;
+    }
+
+    ctx->archive_reader = uhashtools_archive_reader_open(error_message_buf, error_message_buf_tsize, archive_file);
+
+    if (!ctx->archive_reader)
+    {
+        /*
+         * The function "uhashtools_archive_reader_open()" already writes the user
+         * error message into the "error_message_buf" buffer.
+         */
+
+        goto cleanup_and_out;
+    }
+
+    for (slot_index = 0; slot_index < ARCHIVE_QUEUE_SLOT_COUNT; ++slot_index)
+    {
+        ctx->queue_slots[slot_index].data = ctx->queue_data_memory + slot_index * ARCHIVE_QUEUE_SLOT_DATA_SIZE;
+    }
+
+    InitializeCriticalSection(&ctx->queue_lock);
+    InitializeConditionVariable(&ctx->queue_slot_filled);
+    InitializeConditionVariable(&ctx->queue_slot_free);
+
+    thread_handle = _beginthreadex(NULL,
+                                   ARCHIVE_READER_THREAD_STACK_SIZE,
+                                   uhashtools_file_source_archive_reader_thread_function,
+                                   (void*) ctx,
+                                   0,
+                                   &thread_id);
+
+    if (thread_handle == 0)
+    {
+        DeleteCriticalSection(&ctx->queue_lock);
+
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Internal error: Failed to start the archive reader thread!");
+
+        goto cleanup_and_out;
+    }
+
+    ctx->reader_thread_handle = (HANDLE) thread_handle;
+
+    ret = ctx; ctx = NULL;
+
+cleanup_and_out:
+    if (ctx)
+    {
+        uhashtools_archive_reader_close(ctx->archive_reader);
+        free((void*) ctx->queue_data_memory);
+        free((void*) ctx);
+    }
+
+    return ret;
+}
+
+enum ArchiveReaderResult
+uhashtools_file_source_archive_next_entry
+(
+    struct ArchiveFileSourceCtx* ctx,
+    struct FileSource* entry_file_source,
+    struct ArchiveEntryInfo* entry_info
+)
+{
+    struct ArchiveQueueSlot* slot = NULL;
+
+    UHASHTOOLS_ASSERT(ctx, L"Internal error: Entered with ctx == NULL!");
+    UHASHTOOLS_ASSERT(entry_file_source, L"Internal error: Entered with entry_file_source == NULL!");
+    UHASHTOOLS_ASSERT(entry_info, L"Internal error: Entered with entry_info == NULL!");
+
+    (void) memset((void*) entry_file_source, 0, sizeof *entry_file_source);
+    entry_file_source->is_ok = FALSE;
+
+    uhashtools_file_source_archive_release_held_slot(ctx);
+
+    /* Skipping the data of the previous entry which hasn't been read. */
+    while (ctx->entry_is_open && !ctx->entry_reached_eof && !ctx->archive_reached_end)
+    {
+        slot = uhashtools_file_source_archive_take_slot(ctx);
+
+        if (slot->type != ARCHIVE_QUEUE_SLOT_TYPE_ENTRY_DATA)
+        {
+            break;
+        }
+
+        ctx->entry_reached_eof = slot->is_last_block;
+        uhashtools_file_source_archive_release_slot(ctx);
+    }
+
+    ctx->entry_is_open = FALSE;
+
+    if (ctx->archive_reached_end)
+    {
+        return ctx->archive_end_result;
+    }
+
+    slot = uhashtools_file_source_archive_take_slot(ctx);
+
+    if (slot->type != ARCHIVE_QUEUE_SLOT_TYPE_ENTRY_BEGIN)
+    {
+        UHASHTOOLS_ASSERT(ctx->archive_reached_end, L"Internal error: Unexpected archive queue slot type!");
+
+        return ctx->archive_end_result;
+    }
+
+    *entry_info = slot->entry_info;
+    uhashtools_file_source_archive_release_slot(ctx);
+
+    ctx->entry_is_open = TRUE;
+    ctx->entry_reached_eof = FALSE;
+
+    entry_file_source->is_ok = TRUE;
+    entry_file_source->has_known_size = TRUE;
+    entry_file_source->size = entry_info->size;
+    entry_file_source->read_function = &uhashtools_file_source_archive_read;
+    entry_file_source->close_function = &uhashtools_file_source_archive_close;
+    entry_file_source->backend_data = (void*) ctx;
+
+    return ARCHIVE_READER_RESULT_OK;
+}
+
+const wchar_t*
+uhashtools_file_source_archive_get_error_message
+(
+    const struct ArchiveFileSourceCtx* ctx
+)
+{
+    UHASHTOOLS_ASSERT(ctx, L"Internal error: Entered with ctx == NULL!");
+
+    return ctx->error_message;
+}
+
+void
+uhashtools_file_source_archive_stop
+(
+    struct ArchiveFileSourceCtx* ctx
+)
+{
+    DWORD wait_rc = 0;
+
+    if (!ctx)
+    {
+        return;
+    }
+
+    EnterCriticalSection(&ctx->queue_lock);
+    ctx->stop_requested = TRUE;
+    WakeAllConditionVariable(&ctx->queue_slot_free);
+    LeaveCriticalSection(&ctx->queue_lock);
+
+    wait_rc = WaitForSingleObject(ctx->reader_thread_handle, INFINITE);
+    UHASHTOOLS_ASSERT(wait_rc == WAIT_OBJECT_0, L"Internal error: Failed to wait for the archive reader thread!");
+
+    (void) CloseHandle(ctx->reader_thread_handle);
+    DeleteCriticalSection(&ctx->queue_lock);
+    uhashtools_archive_reader_close(ctx->archive_reader);
+    free((void*) ctx->queue_data_memory);
+    free((void*) ctx);
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "archive_reader.h"
+#include "file_source.h"
+
+#include <Windows.h>
+
+/*
+ * The archive file source provides the entries of an archive (see
+ * "archive_reader.h") as file sources. Reading and decompressing the
+ * archive happens within an own thread, so the decompression of the
+ * next blocks runs in parallel to the hashing of the current block.
+ * The decompressed data is handed over through a bounded queue which
+ * limits the memory consumption independent of the entry sizes. The
+ * hashing side reads the data directly from the queue without copying
+ * it.
+ */
+
+struct ArchiveFileSourceCtx;
+
+/**
+ * Opens the archive and starts the thread which decompresses the entries.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if the
+ *                          archive can't be opened.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param archive_file Filepath of the archive.
+ * 
+ * @return The context of the started archive file source or NULL on error.
+ */
+extern
+struct ArchiveFileSourceCtx*
+uhashtools_file_source_archive_start
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* archive_file
+);
+
+/**
+ * Moves to the next file entry of the archive. The file source of the
+ * previous entry must have been closed before. Data of the previous
+ * entry which hasn't been read will be skipped.
+ * 
+ * @param ctx Context of the started archive file source.
+ * @param entry_file_source Receives the file source of the next entry.
+ * @param entry_info Receives the information about the next entry.
+ * 
+ * @return ARCHIVE_READER_RESULT_OK if "entry_file_source" has been opened,
+ *         ARCHIVE_READER_RESULT_END if there are no more entries or
+ *         ARCHIVE_READER_RESULT_FAILED if the archive couldn't be read. In
+ *         the last case the error message can be retrieved with
+ *         "uhashtools_file_source_archive_get_error_message()".
+ */
+extern
+enum ArchiveReaderResult
+uhashtools_file_source_archive_next_entry
+(
+    struct ArchiveFileSourceCtx* ctx,
+    struct FileSource* entry_file_source,
+    struct ArchiveEntryInfo* entry_info
+);
+
+/**
+ * @param ctx Context of the started archive file source.
+ * 
+ * @return Message which describes why reading the archive failed. Empty if
+ *         there was no error.
+ */
+extern
+const wchar_t*
+uhashtools_file_source_archive_get_error_message
+(
+    const struct ArchiveFileSourceCtx* ctx
+);
+
+/**
+ * Stops the decompression thread, closes the archive and frees the context.
+ * 
+ * @param ctx Context of the started archive file source or NULL.
+ */
+extern
+void
+uhashtools_file_source_archive_stop
+(
+    struct ArchiveFileSourceCtx* ctx
+);
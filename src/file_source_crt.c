@@ -0,0 +1,380 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "file_source_crt.h"
+
+#include "error_utilities.h"
+#include "print_utilities.h"
+
+#include <io.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Size of the buffer which is returned for the holes of sparse files.
+ * The buffer is never written, so it stays zero initialized.
+ */
+#define SPARSE_ZERO_BUF_SIZE (1024 * 512)
+
+/* Number of allocated ranges which are queried at once. */
+#define SPARSE_RANGE_QUERY_COUNT 64
+
+static unsigned char g_sparse_zero_buf[SPARSE_ZERO_BUF_SIZE];
+
+struct CrtFileSourceData
+{
+    FILE* target_file_handle;
+
+    /*
+     * For sparse files only the allocated ranges are read from the disk.
+     * The holes between them are returned from "g_sparse_zero_buf".
+     */
+    BOOL is_sparse;
+    unsigned __int64 file_size;
+    unsigned __int64 position;
+    BOOL position_needs_seek;
+    FILE_ALLOCATED_RANGE_BUFFER allocated_ranges[SPARSE_RANGE_QUERY_COUNT];
+    size_t allocated_ranges_count;
+    size_t allocated_ranges_index;
+    BOOL allocated_ranges_exhausted;
+};
+
+static
+BOOL
+uhashtools_file_source_crt_read_regular
+(
+    FILE* target_file_handle,
+    unsigned char* read_buf,
+    size_t read_buf_size,
+    size_t* read_characters,
+    BOOL* reached_eof
+)
+{
+    *read_characters = fread_s((void*) read_buf,
+                               read_buf_size,
+                               sizeof(*read_buf),
+                               read_buf_size,
+                               target_file_handle);
+
+    if (*read_characters != read_buf_size)
+    {
+        if (ferror(target_file_handle))
+        {
+            return FALSE;
+        }
+        else if (feof(target_file_handle))
+        {
+            *reached_eof = TRUE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Queries the next batch of allocated ranges starting at the current
+ * position. ERROR_MORE_DATA only means that there are more ranges than
+ * fitting into the buffer, they are queried with the next call.
+ */
+static
+BOOL
+uhashtools_file_source_crt_query_allocated_ranges
+(
+    struct CrtFileSourceData* crt_data
+)
+{
+    FILE_ALLOCATED_RANGE_BUFFER query_range;
+    DWORD returned_bytes = 0;
+    BOOL device_io_control_rc = FALSE;
+
+    query_range.FileOffset.QuadPart = (LONGLONG) crt_data->position;
+    query_range.Length.QuadPart = (LONGLONG) (crt_data->file_size - crt_data->position);
+
+    device_io_control_rc = DeviceIoControl((HANDLE) _get_osfhandle(_fileno(crt_data->target_file_handle)),
+                                           FSCTL_QUERY_ALLOCATED_RANGES,
+                                           (LPVOID) &query_range,
+                                           sizeof query_range,
+                                           (LPVOID) crt_data->allocated_ranges,
+                                           sizeof crt_data->allocated_ranges,
+                                           &returned_bytes,
+                                           NULL);
+
+    if (!device_io_control_rc && GetLastError() != ERROR_MORE_DATA)
+    {
+        return FALSE;
+    }
+
+    crt_data->allocated_ranges_count = returned_bytes / sizeof *crt_data->allocated_ranges;
+    crt_data->allocated_ranges_index = 0;
+    crt_data->allocated_ranges_exhausted = device_io_control_rc || crt_data->allocated_ranges_count == 0;
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_file_source_crt_read_sparse
+(
+    struct CrtFileSourceData* crt_data,
+    unsigned char* read_buf,
+    size_t read_buf_size,
+    const unsigned char** read_data,
+    size_t* read_data_size
+)
+{
+    while (crt_data->position < crt_data->file_size)
+    {
+        unsigned __int64 range_start = crt_data->file_size;
+        unsigned __int64 range_end = crt_data->file_size;
+        unsigned __int64 available_size = 0;
+
+        if (crt_data->allocated_ranges_index >= crt_data->allocated_ranges_count &&
+            !crt_data->allocated_ranges_exhausted &&
+            !uhashtools_file_source_crt_query_allocated_ranges(crt_data))
+        {
+            return FALSE;
+        }
+
+        if (crt_data->allocated_ranges_index < crt_data->allocated_ranges_count)
+        {
+            const FILE_ALLOCATED_RANGE_BUFFER* range = &crt_data->allocated_ranges[crt_data->allocated_ranges_index];
+
+            range_start = (unsigned __int64) range->FileOffset.QuadPart;
+            range_end = range_start + (unsigned __int64) range->Length.QuadPart;
+
+            if (range_end > crt_data->file_size)
+            {
+                range_end = crt_data->file_size;
+            }
+
+            if (crt_data->position >= range_end)
+            {
+                ++crt_data->allocated_ranges_index;
+                continue;
+            }
+        }
+
+        if (crt_data->position < range_start)
+        {
+            /* Within a hole: Returning zeros without accessing the disk. */
+            available_size = range_start - crt_data->position;
+
+            if (available_size > SPARSE_ZERO_BUF_SIZE)
+            {
+                available_size = SPARSE_ZERO_BUF_SIZE;
+            }
+
+            if (available_size > read_buf_size)
+            {
+                available_size = read_buf_size;
+            }
+
+            *read_data = g_sparse_zero_buf;
+            *read_data_size = (size_t) available_size;
+            crt_data->position += available_size;
+            crt_data->position_needs_seek = TRUE;
+
+            return TRUE;
+        }
+
+        /* Within an allocated range */
+        available_size = range_end - crt_data->position;
+
+        if (available_size > read_buf_size)
+        {
+            available_size = read_buf_size;
+        }
+
+        if (crt_data->position_needs_seek)
+        {
+            if (_fseeki64(crt_data->target_file_handle, (__int64) crt_data->position, SEEK_SET) != 0)
+            {
+                return FALSE;
+            }
+
+            crt_data->position_needs_seek = FALSE;
+        }
+
+        *read_data_size = fread_s((void*) read_buf,
+                                  read_buf_size,
+                                  sizeof(*read_buf),
+                                  (size_t) available_size,
+                                  crt_data->target_file_handle);
+        *read_data = read_buf;
+
+        if (*read_data_size != (size_t) available_size)
+        {
+            /* The file has been truncated while it has been read. */
+            return FALSE;
+        }
+
+        crt_data->position += available_size;
+
+        return TRUE;
+    }
+
+    *read_data = read_buf;
+    *read_data_size = 0;
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_file_source_crt_read
+(
+    struct FileSource* file_source,
+    unsigned char* read_buf,
+    size_t read_buf_size,
+    const unsigned char** read_data,
+    size_t* read_data_size,
+    BOOL* reached_eof
+)
+{
+    struct CrtFileSourceData* crt_data = (struct CrtFileSourceData*) file_source->backend_data;
+
+    if (crt_data->is_sparse)
+    {
+        if (!uhashtools_file_source_crt_read_sparse(crt_data, read_buf, read_buf_size, read_data, read_data_size))
+        {
+            return FALSE;
+        }
+
+        *reached_eof = crt_data->position >= crt_data->file_size;
+
+        return TRUE;
+    }
+
+    *read_data = read_buf;
+
+    return uhashtools_file_source_crt_read_regular(crt_data->target_file_handle,
+                                                   read_buf,
+                                                   read_buf_size,
+                                                   read_data_size,
+                                                   reached_eof);
+}
+
+static
+void
+uhashtools_file_source_crt_close
+(
+    struct FileSource* file_source
+)
+{
+    struct CrtFileSourceData* crt_data = (struct CrtFileSourceData*) file_source->backend_data;
+
+    (void) fclose(crt_data->target_file_handle);
+    free((void*) crt_data);
+}
+
+static
+BOOL
+uhashtools_file_source_crt_is_sparse_file
+(
+    FILE* target_file_handle
+)
+{
+    BY_HANDLE_FILE_INFORMATION file_information;
+
+    if (!GetFileInformationByHandle((HANDLE) _get_osfhandle(_fileno(target_file_handle)), &file_information))
+    {
+        return FALSE;
+    }
+
+    return (file_information.dwFileAttributes & FILE_ATTRIBUTE_SPARSE_FILE) != 0;
+}
+
+struct FileSource
+uhashtools_file_source_crt_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* target_file
+)
+{
+    struct FileSource ret;
+    errno_t target_file_open_error = 0;
+    FILE* target_file_handle = NULL;
+    struct CrtFileSourceData* crt_data = NULL;
+    int target_file_fd = 0;
+    __int64 filelengthi64_rc = 0;
+    unsigned __int64 target_file_size = 0;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(target_file, L"Internal error: target_file is NULL!");
+
+    (void) memset((void*) &ret, 0, sizeof ret);
+    ret.is_ok = FALSE;
+
+    target_file_open_error = _wfopen_s(&target_file_handle,
+                                       target_file,
+                                       L"rb");
+
+    if (target_file_open_error || !target_file_handle)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to open the selected file!");
+
+        goto cleanup_and_out;
+    }
+
+    target_file_fd = _fileno(target_file_handle);
+
+    UHASHTOOLS_ASSERT(target_file_fd != -1, L"Failed to get file descriptor of the opened file!");
+
+    filelengthi64_rc = _filelengthi64(target_file_fd);
+
+    if (filelengthi64_rc == -1)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to get the size of the selected file!");
+
+        goto cleanup_and_out;
+    }
+
+    target_file_size = (unsigned __int64) filelengthi64_rc;
+
+    UHASHTOOLS_PRINTF_LINE_INFO(L"The opened file has a size of \"%I64u\" bytes.", target_file_size);
+
+    (void) clearerr_s(target_file_handle);
+
+    crt_data = (struct CrtFileSourceData*) calloc(1, sizeof *crt_data);
+
+    if (!crt_data)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+
+        goto cleanup_and_out;
+    }
+
+    crt_data->file_size = target_file_size;
+    crt_data->is_sparse = uhashtools_file_source_crt_is_sparse_file(target_file_handle);
+
+    if (crt_data->is_sparse)
+    {
+        UHASHTOOLS_PRINTF_LINE_INFO(L"The opened file is a sparse file. Holes will be hashed without reading them.");
+    }
+
+    ret.is_ok = TRUE;
+    ret.has_known_size = TRUE;
+    ret.size = target_file_size;
+    ret.read_function = &uhashtools_file_source_crt_read;
+    ret.close_function = &uhashtools_file_source_crt_close;
+    crt_data->target_file_handle = target_file_handle; target_file_handle = NULL;
+    ret.backend_data = (void*) crt_data;
+
+cleanup_and_out:
+    if (target_file_handle)
+    {
+        (void) fclose(target_file_handle);
+    }
+
+    return ret;
+}
@@ -0,0 +1,32 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "file_source.h"
+
+#include <Windows.h>
+
+/**
+ * Opens a regular file with the file functions of the C runtime.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if the
+ *                          file can't be opened.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param target_file Filepath of the target file.
+ * 
+ * @return Opened file source. See "uhashtools_file_source_open()" for details.
+ */
+extern
+struct FileSource
+uhashtools_file_source_crt_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* target_file
+);
@@ -0,0 +1,218 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "file_source_edges.h"
+
+#include "error_utilities.h"
+
+#include <io.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The head and the tail of the file, or the whole file as a single range. */
+#define EDGES_MAX_RANGE_COUNT 2
+
+struct EdgesFileSourceData
+{
+    FILE* target_file_handle;
+    unsigned __int64 range_starts[EDGES_MAX_RANGE_COUNT];
+    unsigned __int64 range_ends[EDGES_MAX_RANGE_COUNT];
+    size_t range_count;
+    size_t range_index;
+    unsigned __int64 position;
+    BOOL position_needs_seek;
+};
+
+static
+BOOL
+uhashtools_file_source_edges_read
+(
+    struct FileSource* file_source,
+    unsigned char* read_buf,
+    size_t read_buf_size,
+    const unsigned char** read_data,
+    size_t* read_data_size,
+    BOOL* reached_eof
+)
+{
+    struct EdgesFileSourceData* edges_data = (struct EdgesFileSourceData*) file_source->backend_data;
+    unsigned __int64 available_size = 0;
+
+    *read_data = read_buf;
+    *read_data_size = 0;
+
+    while (edges_data->range_index < edges_data->range_count &&
+           edges_data->position >= edges_data->range_ends[edges_data->range_index])
+    {
+        ++edges_data->range_index;
+
+        if (edges_data->range_index < edges_data->range_count)
+        {
+            edges_data->position = edges_data->range_starts[edges_data->range_index];
+            edges_data->position_needs_seek = TRUE;
+        }
+    }
+
+    if (edges_data->range_index >= edges_data->range_count)
+    {
+        *reached_eof = TRUE;
+
+        return TRUE;
+    }
+
+    available_size = edges_data->range_ends[edges_data->range_index] - edges_data->position;
+
+    if (available_size > read_buf_size)
+    {
+        available_size = read_buf_size;
+    }
+
+    if (edges_data->position_needs_seek)
+    {
+        if (_fseeki64(edges_data->target_file_handle, (__int64) edges_data->position, SEEK_SET) != 0)
+        {
+            return FALSE;
+        }
+
+        edges_data->position_needs_seek = FALSE;
+    }
+
+    *read_data_size = fread_s((void*) read_buf,
+                              read_buf_size,
+                              sizeof(*read_buf),
+                              (size_t) available_size,
+                              edges_data->target_file_handle);
+
+    if (*read_data_size != (size_t) available_size)
+    {
+        /* The file has been truncated while it has been read. */
+        return FALSE;
+    }
+
+    edges_data->position += available_size;
+
+    *reached_eof = edges_data->range_index + 1 >= edges_data->range_count &&
+                   edges_data->position >= edges_data->range_ends[edges_data->range_index];
+
+    return TRUE;
+}
+
+static
+void
+uhashtools_file_source_edges_close
+(
+    struct FileSource* file_source
+)
+{
+    struct EdgesFileSourceData* edges_data = (struct EdgesFileSourceData*) file_source->backend_data;
+
+    (void) fclose(edges_data->target_file_handle);
+    free((void*) edges_data);
+}
+
+struct FileSource
+uhashtools_file_source_edges_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* target_file,
+    size_t edge_size
+)
+{
+    struct FileSource ret;
+    errno_t target_file_open_error = 0;
+    FILE* target_file_handle = NULL;
+    struct EdgesFileSourceData* edges_data = NULL;
+    __int64 filelengthi64_rc = 0;
+    unsigned __int64 target_file_size = 0;
+    size_t i = 0;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(target_file, L"Internal error: target_file is NULL!");
+    UHASHTOOLS_ASSERT(edge_size > 0, L"Internal error: edge_size is zero!");
+
+    (void) memset((void*) &ret, 0, sizeof ret);
+    ret.is_ok = FALSE;
+
+    target_file_open_error = _wfopen_s(&target_file_handle,
+                                       target_file,
+                                       L"rb");
+
+    if (target_file_open_error || !target_file_handle)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to open the selected file!");
+
+        goto cleanup_and_out;
+    }
+
+    filelengthi64_rc = _filelengthi64(_fileno(target_file_handle));
+
+    if (filelengthi64_rc == -1)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to get the size of the selected file!");
+
+        goto cleanup_and_out;
+    }
+
+    target_file_size = (unsigned __int64) filelengthi64_rc;
+
+    edges_data = (struct EdgesFileSourceData*) calloc(1, sizeof *edges_data);
+
+    if (!edges_data)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+
+        goto cleanup_and_out;
+    }
+
+    if (target_file_size > 2 * (unsigned __int64) edge_size)
+    {
+        edges_data->range_starts[0] = 0;
+        edges_data->range_ends[0] = edge_size;
+        edges_data->range_starts[1] = target_file_size - edge_size;
+        edges_data->range_ends[1] = target_file_size;
+        edges_data->range_count = 2;
+    }
+    else
+    {
+        edges_data->range_starts[0] = 0;
+        edges_data->range_ends[0] = target_file_size;
+        edges_data->range_count = 1;
+    }
+
+    ret.size = 0;
+
+    for (i = 0; i < edges_data->range_count; ++i)
+    {
+        ret.size += edges_data->range_ends[i] - edges_data->range_starts[i];
+    }
+
+    ret.is_ok = TRUE;
+    ret.has_known_size = TRUE;
+    ret.read_function = &uhashtools_file_source_edges_read;
+    ret.close_function = &uhashtools_file_source_edges_close;
+    edges_data->target_file_handle = target_file_handle; target_file_handle = NULL;
+    ret.backend_data = (void*) edges_data; edges_data = NULL;
+
+cleanup_and_out:
+    if (edges_data)
+    {
+        free((void*) edges_data);
+    }
+
+    if (target_file_handle)
+    {
+        (void) fclose(target_file_handle);
+    }
+
+    return ret;
+}
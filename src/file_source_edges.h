@@ -0,0 +1,42 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "file_source.h"
+
+#include <Windows.h>
+
+/**
+ * Opens a regular file, but only provides the first and the last
+ * "edge_size" bytes of it (in this order). Files which aren't bigger
+ * than two times "edge_size" are provided completely. The hash of this
+ * file source is a cheap fingerprint which is used by the duplicate
+ * finder (see "dedup_mode.h") to sort out files which can't be equal
+ * before reading them completely.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if the
+ *                          file can't be opened.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param target_file Filepath of the target file.
+ * @param edge_size Amount of bytes which are read from the start and from the
+ *                  end of the file.
+ * 
+ * @return Opened file source. The member "size" is the amount of bytes which are
+ *         provided and not the size of the file. See "uhashtools_file_source_open()"
+ *         for details.
+ */
+extern
+struct FileSource
+uhashtools_file_source_edges_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* target_file,
+    size_t edge_size
+);
@@ -0,0 +1,428 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "file_source_overlapped.h"
+
+#include "error_utilities.h"
+#include "print_utilities.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Amount of reads which are kept in flight. Set with "nmake READ_QUEUE_DEPTH=<n>". */
+#ifndef UHASHTOOLS_READ_QUEUE_DEPTH
+    #define UHASHTOOLS_READ_QUEUE_DEPTH 8
+#endif
+
+/* Size of a single read in KiB. Set with "nmake READ_BLOCK_SIZE_KIB=<n>". */
+#ifndef UHASHTOOLS_READ_BLOCK_SIZE_KIB
+    #define UHASHTOOLS_READ_BLOCK_SIZE_KIB 512
+#endif
+
+#if UHASHTOOLS_READ_QUEUE_DEPTH < 1 || UHASHTOOLS_READ_QUEUE_DEPTH > 64
+    #error "UHASHTOOLS_READ_QUEUE_DEPTH must be between 1 and 64."
+#endif
+
+/* Unbuffered reads must start at and cover whole sectors, which are at most 4 KiB big. */
+#if UHASHTOOLS_READ_BLOCK_SIZE_KIB < 4 || UHASHTOOLS_READ_BLOCK_SIZE_KIB % 4 != 0
+    #error "UHASHTOOLS_READ_BLOCK_SIZE_KIB must be a multiple of 4."
+#endif
+
+/* All read buffers together must stay allocatable in 32-bit builds. */
+#if UHASHTOOLS_READ_QUEUE_DEPTH * UHASHTOOLS_READ_BLOCK_SIZE_KIB > 1024 * 256
+    #error "The read buffers of UHASHTOOLS_READ_QUEUE_DEPTH * UHASHTOOLS_READ_BLOCK_SIZE_KIB are exceeding 256 MiB."
+#endif
+
+#define READ_BLOCK_SIZE ((DWORD) UHASHTOOLS_READ_BLOCK_SIZE_KIB * 1024)
+
+/*
+ * Smaller files are read by the CRT file source. They are read quickly
+ * anyway and unlike the unbuffered reads it can take them from the file
+ * system cache.
+ */
+#define OVERLAPPED_MIN_FILE_SIZE (1024 * 1024 * 16)
+
+struct OverlappedReadRequest
+{
+    OVERLAPPED overlapped;
+    unsigned char* read_buf;
+
+    /* TRUE from issuing the read until its result has been collected. */
+    BOOL is_in_flight;
+
+    /* Set if "ReadFile()" already reported the end of the file when issuing the read. */
+    BOOL is_immediate_eof;
+};
+
+struct OverlappedFileSourceData
+{
+    HANDLE file_handle;
+    unsigned __int64 file_size;
+    unsigned char* read_bufs;
+    struct OverlappedReadRequest requests[UHASHTOOLS_READ_QUEUE_DEPTH];
+
+    /*
+     * The requests are used as ring. The reads are issued and collected
+     * in the same order, so the blocks are handed out in file order.
+     */
+    size_t next_issue_index;
+    size_t next_collect_index;
+    size_t in_flight_count;
+    unsigned __int64 next_issue_offset;
+
+    /* Set after the first short read. No more reads are issued after it. */
+    BOOL reached_end;
+
+    /* Collected block which is currently handed out to the hasher. */
+    const unsigned char* current_block;
+    size_t current_block_size;
+    size_t current_block_pos;
+    BOOL current_block_is_last;
+};
+
+static
+BOOL
+uhashtools_file_source_overlapped_issue_reads
+(
+    struct OverlappedFileSourceData* overlapped_data
+)
+{
+    /*
+     * Reads are issued up to the size of the file at the time it has been
+     * opened. If the queue runs empty, one more read behind it is issued.
+     * It either returns the data which has been appended in the meantime
+     * or signals the end of the file.
+     */
+    while (!overlapped_data->reached_end &&
+           overlapped_data->in_flight_count < UHASHTOOLS_READ_QUEUE_DEPTH &&
+           (overlapped_data->next_issue_offset < overlapped_data->file_size || overlapped_data->in_flight_count == 0))
+    {
+        struct OverlappedReadRequest* request = &overlapped_data->requests[overlapped_data->next_issue_index];
+        const HANDLE request_event = request->overlapped.hEvent;
+        BOOL read_file_rc = FALSE;
+
+        (void) memset((void*) &request->overlapped, 0, sizeof request->overlapped);
+        request->overlapped.hEvent = request_event;
+        request->overlapped.Offset = (DWORD) (overlapped_data->next_issue_offset & 0xFFFFFFFFULL);
+        request->overlapped.OffsetHigh = (DWORD) (overlapped_data->next_issue_offset >> 32);
+        request->is_immediate_eof = FALSE;
+
+        read_file_rc = ReadFile(overlapped_data->file_handle,
+                                (LPVOID) request->read_buf,
+                                READ_BLOCK_SIZE,
+                                NULL,
+                                &request->overlapped);
+
+        if (!read_file_rc)
+        {
+            const DWORD read_file_error = GetLastError();
+
+            if (read_file_error == ERROR_HANDLE_EOF)
+            {
+                request->is_immediate_eof = TRUE;
+            }
+            else if (read_file_error != ERROR_IO_PENDING)
+            {
+                return FALSE;
+            }
+        }
+
+        request->is_in_flight = TRUE;
+        ++overlapped_data->in_flight_count;
+        overlapped_data->next_issue_offset += READ_BLOCK_SIZE;
+        overlapped_data->next_issue_index = (overlapped_data->next_issue_index + 1) % UHASHTOOLS_READ_QUEUE_DEPTH;
+    }
+
+    return TRUE;
+}
+
+/* Waits for the oldest read in flight and makes its block the current block. */
+static
+BOOL
+uhashtools_file_source_overlapped_collect_next_read
+(
+    struct OverlappedFileSourceData* overlapped_data
+)
+{
+    struct OverlappedReadRequest* request = &overlapped_data->requests[overlapped_data->next_collect_index];
+    DWORD read_bytes = 0;
+    BOOL read_success = TRUE;
+
+    UHASHTOOLS_ASSERT(overlapped_data->in_flight_count > 0 && request->is_in_flight,
+                      L"Internal error: Tried to collect a read which isn't in flight!");
+
+    if (!request->is_immediate_eof &&
+        !GetOverlappedResult(overlapped_data->file_handle, &request->overlapped, &read_bytes, TRUE))
+    {
+        read_success = GetLastError() == ERROR_HANDLE_EOF;
+        read_bytes = 0;
+    }
+
+    request->is_in_flight = FALSE;
+    --overlapped_data->in_flight_count;
+    overlapped_data->next_collect_index = (overlapped_data->next_collect_index + 1) % UHASHTOOLS_READ_QUEUE_DEPTH;
+
+    if (!read_success)
+    {
+        return FALSE;
+    }
+
+    overlapped_data->current_block = request->read_buf;
+    overlapped_data->current_block_size = read_bytes;
+    overlapped_data->current_block_pos = 0;
+    overlapped_data->current_block_is_last = read_bytes < READ_BLOCK_SIZE;
+
+    if (overlapped_data->current_block_is_last)
+    {
+        overlapped_data->reached_end = TRUE;
+    }
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_file_source_overlapped_read
+(
+    struct FileSource* file_source,
+    unsigned char* read_buf,
+    size_t read_buf_size,
+    const unsigned char** read_data,
+    size_t* read_data_size,
+    BOOL* reached_eof
+)
+{
+    struct OverlappedFileSourceData* overlapped_data = (struct OverlappedFileSourceData*) file_source->backend_data;
+    size_t available_size = 0;
+
+    UNREFERENCED_PARAMETER(read_buf);
+
+    if (overlapped_data->current_block_pos >= overlapped_data->current_block_size &&
+        !overlapped_data->current_block_is_last)
+    {
+        /* The caller is done with the current block, so its buffer can be reused. */
+        if (!uhashtools_file_source_overlapped_issue_reads(overlapped_data) ||
+            !uhashtools_file_source_overlapped_collect_next_read(overlapped_data))
+        {
+            return FALSE;
+        }
+    }
+
+    /* A block may be bigger than the buffer of the caller, so it's handed out in parts. */
+    available_size = overlapped_data->current_block_size - overlapped_data->current_block_pos;
+
+    if (available_size > read_buf_size)
+    {
+        available_size = read_buf_size;
+    }
+
+    *read_data = overlapped_data->current_block + overlapped_data->current_block_pos;
+    *read_data_size = available_size;
+    overlapped_data->current_block_pos += available_size;
+
+    *reached_eof = overlapped_data->current_block_is_last &&
+                   overlapped_data->current_block_pos >= overlapped_data->current_block_size;
+
+    return TRUE;
+}
+
+static
+void
+uhashtools_file_source_overlapped_free_data
+(
+    struct OverlappedFileSourceData* overlapped_data
+)
+{
+    size_t request_index = 0;
+
+    if (overlapped_data->in_flight_count > 0)
+    {
+        /* The buffers must not be freed while the system still writes into them. */
+        (void) CancelIoEx(overlapped_data->file_handle, NULL);
+
+        for (request_index = 0; request_index < UHASHTOOLS_READ_QUEUE_DEPTH; ++request_index)
+        {
+            struct OverlappedReadRequest* request = &overlapped_data->requests[request_index];
+            DWORD read_bytes = 0;
+
+            if (request->is_in_flight && !request->is_immediate_eof)
+            {
+                (void) GetOverlappedResult(overlapped_data->file_handle, &request->overlapped, &read_bytes, TRUE);
+            }
+
+            request->is_in_flight = FALSE;
+        }
+    }
+
+    for (request_index = 0; request_index < UHASHTOOLS_READ_QUEUE_DEPTH; ++request_index)
+    {
+        if (overlapped_data->requests[request_index].overlapped.hEvent)
+        {
+            (void) CloseHandle(overlapped_data->requests[request_index].overlapped.hEvent);
+        }
+    }
+
+    if (overlapped_data->read_bufs)
+    {
+        (void) VirtualFree((LPVOID) overlapped_data->read_bufs, 0, MEM_RELEASE);
+    }
+
+    if (overlapped_data->file_handle != INVALID_HANDLE_VALUE)
+    {
+        (void) CloseHandle(overlapped_data->file_handle);
+    }
+
+    free((void*) overlapped_data);
+}
+
+static
+void
+uhashtools_file_source_overlapped_close
+(
+    struct FileSource* file_source
+)
+{
+    uhashtools_file_source_overlapped_free_data((struct OverlappedFileSourceData*) file_source->backend_data);
+}
+
+BOOL
+uhashtools_file_source_overlapped_is_suitable
+(
+    const wchar_t* target_file
+)
+{
+    WIN32_FILE_ATTRIBUTE_DATA file_attribute_data;
+    unsigned __int64 file_size = 0;
+    const DWORD excluded_attributes = FILE_ATTRIBUTE_DIRECTORY |
+                                      FILE_ATTRIBUTE_SPARSE_FILE |
+                                      FILE_ATTRIBUTE_COMPRESSED |
+                                      FILE_ATTRIBUTE_ENCRYPTED;
+
+    UHASHTOOLS_ASSERT(target_file, L"Internal error: target_file is NULL!");
+
+    if (!GetFileAttributesExW(target_file, GetFileExInfoStandard, (LPVOID) &file_attribute_data))
+    {
+        return FALSE;
+    }
+
+    if (file_attribute_data.dwFileAttributes & excluded_attributes)
+    {
+        return FALSE;
+    }
+
+    file_size = ((unsigned __int64) file_attribute_data.nFileSizeHigh << 32) | file_attribute_data.nFileSizeLow;
+
+    return file_size >= OVERLAPPED_MIN_FILE_SIZE;
+}
+
+struct FileSource
+uhashtools_file_source_overlapped_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* target_file
+)
+{
+    struct FileSource ret;
+    struct OverlappedFileSourceData* overlapped_data = NULL;
+    LARGE_INTEGER file_size;
+    size_t request_index = 0;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(target_file, L"Internal error: target_file is NULL!");
+
+    (void) memset((void*) &ret, 0, sizeof ret);
+    ret.is_ok = FALSE;
+
+    overlapped_data = (struct OverlappedFileSourceData*) calloc(1, sizeof *overlapped_data);
+
+    if (!overlapped_data)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+
+        goto cleanup_and_out;
+    }
+
+    overlapped_data->file_handle = CreateFileW(target_file,
+                                               GENERIC_READ,
+                                               FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                               NULL,
+                                               OPEN_EXISTING,
+                                               FILE_FLAG_OVERLAPPED | FILE_FLAG_NO_BUFFERING,
+                                               NULL);
+
+    if (overlapped_data->file_handle == INVALID_HANDLE_VALUE)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to open the selected file!");
+
+        goto cleanup_and_out;
+    }
+
+    if (!GetFileSizeEx(overlapped_data->file_handle, &file_size))
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to get the size of the selected file!");
+
+        goto cleanup_and_out;
+    }
+
+    overlapped_data->file_size = (unsigned __int64) file_size.QuadPart;
+
+    /* VirtualAlloc() returns page aligned memory as required by the unbuffered reads. */
+    overlapped_data->read_bufs = (unsigned char*) VirtualAlloc(NULL,
+                                                               (SIZE_T) UHASHTOOLS_READ_QUEUE_DEPTH * READ_BLOCK_SIZE,
+                                                               MEM_COMMIT | MEM_RESERVE,
+                                                               PAGE_READWRITE);
+
+    if (!overlapped_data->read_bufs)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+
+        goto cleanup_and_out;
+    }
+
+    for (request_index = 0; request_index < UHASHTOOLS_READ_QUEUE_DEPTH; ++request_index)
+    {
+        struct OverlappedReadRequest* request = &overlapped_data->requests[request_index];
+
+        request->read_buf = overlapped_data->read_bufs + request_index * READ_BLOCK_SIZE;
+        request->overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+
+        if (!request->overlapped.hEvent)
+        {
+            (void) wcscpy_s(error_message_buf,
+                            error_message_buf_tsize,
+                            L"Internal error: Failed to create the events for reading the selected file!");
+
+            goto cleanup_and_out;
+        }
+    }
+
+    UHASHTOOLS_PRINTF_LINE_INFO(L"The opened file has a size of \"%I64u\" bytes. Reading it with %u reads of %u KiB in flight.",
+                                overlapped_data->file_size,
+                                (unsigned int) UHASHTOOLS_READ_QUEUE_DEPTH,
+                                (unsigned int) UHASHTOOLS_READ_BLOCK_SIZE_KIB);
+
+    ret.is_ok = TRUE;
+    ret.has_known_size = TRUE;
+    ret.size = overlapped_data->file_size;
+    ret.read_function = &uhashtools_file_source_overlapped_read;
+    ret.close_function = &uhashtools_file_source_overlapped_close;
+    ret.backend_data = (void*) overlapped_data; overlapped_data = NULL;
+
+cleanup_and_out:
+    if (overlapped_data)
+    {
+        uhashtools_file_source_overlapped_free_data(overlapped_data);
+    }
+
+    return ret;
+}
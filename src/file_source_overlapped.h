@@ -0,0 +1,65 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "file_source.h"
+
+#include <Windows.h>
+
+/*
+ * The overlapped file source reads big regular files with unbuffered
+ * overlapped reads. Instead of waiting for every single read like the
+ * CRT file source, it keeps multiple reads in flight, so SSDs (which
+ * only reach their rated throughput with many outstanding requests)
+ * are kept busy while the previous block is hashed.
+ * 
+ * The reads are going into a ring of page aligned buffers and are
+ * handed to the hasher in file order. The amount of reads in flight
+ * and the size of a single read are set at compile time (see
+ * "READ_QUEUE_DEPTH" and "READ_BLOCK_SIZE_KIB" in the makefile). How
+ * both are measured on a drive is described in
+ * "res/developer_documentation/read_queue_benchmark.md".
+ */
+
+/**
+ * Checks if the given target should be read with the overlapped file
+ * source. This is the case for regular files which are big enough to
+ * benefit from multiple reads in flight. Sparse, compressed and encrypted
+ * files are left to the CRT file source.
+ * 
+ * @param target_file Target file as passed by the user.
+ * 
+ * @return TRUE if "target_file" should be opened with the overlapped file
+ *         source else FALSE.
+ */
+extern
+BOOL
+uhashtools_file_source_overlapped_is_suitable
+(
+    const wchar_t* target_file
+);
+
+/**
+ * Opens a regular file for overlapped reads.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if the
+ *                          file can't be opened.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param target_file Filepath of the target file.
+ * 
+ * @return Opened file source. See "uhashtools_file_source_open()" for details.
+ */
+extern
+struct FileSource
+uhashtools_file_source_overlapped_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* target_file
+);
@@ -0,0 +1,225 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "file_source_range.h"
+
+#include "error_utilities.h"
+
+#include <io.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct RangeFileSourceData
+{
+    FILE* target_file_handle;
+    unsigned __int64 target_file_size;
+    unsigned __int64 remaining_size;
+};
+
+static
+BOOL
+uhashtools_file_source_range_read
+(
+    struct FileSource* file_source,
+    unsigned char* read_buf,
+    size_t read_buf_size,
+    const unsigned char** read_data,
+    size_t* read_data_size,
+    BOOL* reached_eof
+)
+{
+    struct RangeFileSourceData* range_data = (struct RangeFileSourceData*) file_source->backend_data;
+    size_t requested_size = read_buf_size;
+
+    *read_data = read_buf;
+    *read_data_size = 0;
+
+    if (range_data->remaining_size < (unsigned __int64) requested_size)
+    {
+        requested_size = (size_t) range_data->remaining_size;
+    }
+
+    if (requested_size > 0)
+    {
+        *read_data_size = fread_s((void*) read_buf,
+                                  read_buf_size,
+                                  sizeof(*read_buf),
+                                  requested_size,
+                                  range_data->target_file_handle);
+
+        if (*read_data_size != requested_size)
+        {
+            /* The file has been truncated while it has been read. */
+            return FALSE;
+        }
+    }
+
+    range_data->remaining_size -= requested_size;
+    *reached_eof = range_data->remaining_size == 0;
+
+    return TRUE;
+}
+
+static
+void
+uhashtools_file_source_range_close
+(
+    struct FileSource* file_source
+)
+{
+    struct RangeFileSourceData* range_data = (struct RangeFileSourceData*) file_source->backend_data;
+
+    (void) fclose(range_data->target_file_handle);
+    free((void*) range_data);
+}
+
+struct FileSource
+uhashtools_file_source_range_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* target_file,
+    unsigned __int64 range_start,
+    unsigned __int64 range_size
+)
+{
+    struct FileSource ret;
+    errno_t target_file_open_error = 0;
+    FILE* target_file_handle = NULL;
+    struct RangeFileSourceData* range_data = NULL;
+    __int64 filelengthi64_rc = 0;
+    unsigned __int64 target_file_size = 0;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(target_file, L"Internal error: target_file is NULL!");
+
+    (void) memset((void*) &ret, 0, sizeof ret);
+    ret.is_ok = FALSE;
+
+    target_file_open_error = _wfopen_s(&target_file_handle,
+                                       target_file,
+                                       L"rb");
+
+    if (target_file_open_error || !target_file_handle)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to open the selected file!");
+
+        goto cleanup_and_out;
+    }
+
+    filelengthi64_rc = _filelengthi64(_fileno(target_file_handle));
+
+    if (filelengthi64_rc == -1)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to get the size of the selected file!");
+
+        goto cleanup_and_out;
+    }
+
+    target_file_size = (unsigned __int64) filelengthi64_rc;
+
+    if (range_start > target_file_size)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The selected file has been truncated!");
+
+        goto cleanup_and_out;
+    }
+
+    if (_fseeki64(target_file_handle, (__int64) range_start, SEEK_SET) != 0)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to read the selected file!");
+
+        goto cleanup_and_out;
+    }
+
+    range_data = (struct RangeFileSourceData*) calloc(1, sizeof *range_data);
+
+    if (!range_data)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+
+        goto cleanup_and_out;
+    }
+
+    range_data->target_file_size = target_file_size;
+    range_data->remaining_size = target_file_size - range_start;
+
+    if (range_size < range_data->remaining_size)
+    {
+        range_data->remaining_size = range_size;
+    }
+
+    ret.is_ok = TRUE;
+    ret.has_known_size = TRUE;
+    ret.size = range_data->remaining_size;
+    ret.read_function = &uhashtools_file_source_range_read;
+    ret.close_function = &uhashtools_file_source_range_close;
+    range_data->target_file_handle = target_file_handle; target_file_handle = NULL;
+    ret.backend_data = (void*) range_data; range_data = NULL;
+
+cleanup_and_out:
+    if (range_data)
+    {
+        free((void*) range_data);
+    }
+
+    if (target_file_handle)
+    {
+        (void) fclose(target_file_handle);
+    }
+
+    return ret;
+}
+
+BOOL
+uhashtools_file_source_range_select
+(
+    struct FileSource* file_source,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    unsigned __int64 range_start,
+    unsigned __int64 range_size
+)
+{
+    struct RangeFileSourceData* range_data = NULL;
+
+    UHASHTOOLS_ASSERT(file_source && file_source->is_ok && file_source->read_function == &uhashtools_file_source_range_read,
+                      L"Internal error: Entered without an opened range file source!");
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+
+    range_data = (struct RangeFileSourceData*) file_source->backend_data;
+
+    if (range_start > range_data->target_file_size)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The selected file has been truncated!");
+
+        return FALSE;
+    }
+
+    if (_fseeki64(range_data->target_file_handle, (__int64) range_start, SEEK_SET) != 0)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to read the selected file!");
+
+        return FALSE;
+    }
+
+    range_data->remaining_size = range_data->target_file_size - range_start;
+
+    if (range_size < range_data->remaining_size)
+    {
+        range_data->remaining_size = range_size;
+    }
+
+    file_source->size = range_data->remaining_size;
+
+    return TRUE;
+}
@@ -0,0 +1,73 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "file_source.h"
+
+#include <Windows.h>
+
+/* Passed as "range_size" to provide everything from the start of the range to the end of the file. */
+#define FILE_SOURCE_RANGE_TO_EOF _UI64_MAX
+
+/**
+ * Opens a regular file, but only provides the bytes from "range_start"
+ * on. At most "range_size" bytes are provided and never more than the
+ * file contained when it has been opened, so data which is appended
+ * while the range is read isn't included. Used by the incremental mode
+ * (see "incremental_mode.h") to hash the appended part of a file and to
+ * spot-check the part which has already been hashed.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if the
+ *                          file can't be opened.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param target_file Filepath of the target file.
+ * @param range_start Offset of the first provided byte. Must not be bigger than
+ *                    the size of the file.
+ * @param range_size Maximum amount of provided bytes or FILE_SOURCE_RANGE_TO_EOF.
+ * 
+ * @return Opened file source. The member "size" is the amount of bytes which are
+ *         provided and not the size of the file. See "uhashtools_file_source_open()"
+ *         for details.
+ */
+extern
+struct FileSource
+uhashtools_file_source_range_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* target_file,
+    unsigned __int64 range_start,
+    unsigned __int64 range_size
+);
+
+/**
+ * Moves an opened range file source to another range of the same file,
+ * so a file whose ranges are read one after another is only opened once.
+ * The size of the file is still the size it had when it has been opened.
+ * 
+ * @param file_source File source opened by "uhashtools_file_source_range_open()".
+ * @param error_message_buf Buffer which receives the user error message if the
+ *                          range can't be selected.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param range_start Offset of the first provided byte.
+ * @param range_size Maximum amount of provided bytes or FILE_SOURCE_RANGE_TO_EOF.
+ * 
+ * @return TRUE on success and FALSE on error. The member "size" of the file
+ *         source is updated to the amount of bytes of the new range.
+ */
+extern
+BOOL
+uhashtools_file_source_range_select
+(
+    struct FileSource* file_source,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    unsigned __int64 range_start,
+    unsigned __int64 range_size
+);
@@ -0,0 +1,277 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "file_source_stream.h"
+
+#include "error_utilities.h"
+#include "print_utilities.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#define STREAM_STDIN_TARGET L"-"
+#define STREAM_NAMED_PIPE_PREFIX L"\\\\.\\pipe\\"
+#define STREAM_NAMED_PIPE_WAIT_TIMEOUT_MS 10000
+
+/*
+ * A single read from a pipe only returns the data which is currently
+ * within the pipe buffer of the operating system (usually only a few
+ * KiB). We're collecting at least this amount of data before handing
+ * it to the hashing implementation to keep the per block overhead low.
+ * We're not filling the whole read buffer since a slow writer would
+ * otherwise delay the progress reporting and the cancellation.
+ */
+#define STREAM_MIN_READ_BLOCK_SIZE (1024 * 64)
+
+struct StreamFileSourceData
+{
+    HANDLE stream_handle;
+    BOOL close_stream_handle;
+};
+
+static
+BOOL
+uhashtools_file_source_stream_read
+(
+    struct FileSource* file_source,
+    unsigned char* read_buf,
+    size_t read_buf_size,
+    const unsigned char** read_data,
+    size_t* read_data_size,
+    BOOL* reached_eof
+)
+{
+    struct StreamFileSourceData* stream_data = (struct StreamFileSourceData*) file_source->backend_data;
+    size_t min_read_block_size = STREAM_MIN_READ_BLOCK_SIZE;
+    size_t filled_size = 0;
+
+    if (min_read_block_size > read_buf_size)
+    {
+        min_read_block_size = read_buf_size;
+    }
+
+    while (filled_size < min_read_block_size)
+    {
+        DWORD bytes_to_read = MAXDWORD;
+        DWORD read_bytes = 0;
+        BOOL read_file_rc = FALSE;
+
+        if (read_buf_size - filled_size < (size_t) bytes_to_read)
+        {
+            bytes_to_read = (DWORD) (read_buf_size - filled_size);
+        }
+
+        read_file_rc = ReadFile(stream_data->stream_handle,
+                                (LPVOID) (read_buf + filled_size),
+                                bytes_to_read,
+                                &read_bytes,
+                                NULL);
+
+        if (!read_file_rc)
+        {
+            const DWORD read_file_error = GetLastError();
+
+            if (read_file_error == ERROR_BROKEN_PIPE)
+            {
+                /* The writing side has closed the pipe. */
+                *reached_eof = TRUE;
+                break;
+            }
+            else if (read_file_error != ERROR_MORE_DATA)
+            {
+                UHASHTOOLS_PRINTF_LINE_ERROR(L"ReadFile() failed with error code \"%lu\"!", read_file_error);
+
+                return FALSE;
+            }
+        }
+        else if (read_bytes == 0)
+        {
+            *reached_eof = TRUE;
+            break;
+        }
+
+        filled_size += read_bytes;
+    }
+
+    *read_data = read_buf;
+    *read_data_size = filled_size;
+
+    return TRUE;
+}
+
+static
+void
+uhashtools_file_source_stream_close
+(
+    struct FileSource* file_source
+)
+{
+    struct StreamFileSourceData* stream_data = (struct StreamFileSourceData*) file_source->backend_data;
+
+    if (stream_data->close_stream_handle)
+    {
+        (void) CloseHandle(stream_data->stream_handle);
+    }
+
+    free(stream_data);
+}
+
+static
+HANDLE
+uhashtools_file_source_stream_open_named_pipe
+(
+    const wchar_t* named_pipe_path
+)
+{
+    HANDLE ret = INVALID_HANDLE_VALUE;
+
+    ret = CreateFileW(named_pipe_path,
+                      GENERIC_READ,
+                      0,    /* Share mode */
+                      NULL, /* Security attributes */
+                      OPEN_EXISTING,
+                      FILE_ATTRIBUTE_NORMAL,
+                      NULL);
+
+    if (ret == INVALID_HANDLE_VALUE && GetLastError() == ERROR_PIPE_BUSY)
+    {
+        /* All instances of the pipe are in use. Wait for a free one and try it once again. */
+        if (WaitNamedPipeW(named_pipe_path, STREAM_NAMED_PIPE_WAIT_TIMEOUT_MS))
+        {
+            ret = CreateFileW(named_pipe_path,
+                              GENERIC_READ,
+                              0,    /* Share mode */
+                              NULL, /* Security attributes */
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              NULL);
+        }
+    }
+
+    return ret;
+}
+
+BOOL
+uhashtools_file_source_stream_is_stream_target
+(
+    const wchar_t* target_file
+)
+{
+    UHASHTOOLS_ASSERT(target_file, L"Internal error: target_file is NULL!");
+
+    return wcscmp(target_file, STREAM_STDIN_TARGET) == 0 ||
+           _wcsnicmp(target_file, STREAM_NAMED_PIPE_PREFIX, wcslen(STREAM_NAMED_PIPE_PREFIX)) == 0;
+}
+
+struct FileSource
+uhashtools_file_source_stream_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* target_file
+)
+{
+    struct FileSource ret;
+    struct StreamFileSourceData* stream_data = NULL;
+    HANDLE stream_handle = INVALID_HANDLE_VALUE;
+    BOOL close_stream_handle = FALSE;
+    DWORD stream_file_type = FILE_TYPE_UNKNOWN;
+    LARGE_INTEGER stream_size;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(target_file, L"Internal error: target_file is NULL!");
+
+    (void) memset((void*) &ret, 0, sizeof ret);
+    (void) memset((void*) &stream_size, 0, sizeof stream_size);
+    ret.is_ok = FALSE;
+
+    if (wcscmp(target_file, STREAM_STDIN_TARGET) == 0)
+    {
+        stream_handle = GetStdHandle(STD_INPUT_HANDLE);
+
+        if (!stream_handle || stream_handle == INVALID_HANDLE_VALUE)
+        {
+            (void) wcscpy_s(error_message_buf,
+                            error_message_buf_tsize,
+                            L"No data has been passed through the standard input!");
+
+            goto cleanup_and_out;
+        }
+    }
+    else
+    {
+        stream_handle = uhashtools_file_source_stream_open_named_pipe(target_file);
+
+        if (stream_handle == INVALID_HANDLE_VALUE)
+        {
+            (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to open the selected named pipe!");
+
+            goto cleanup_and_out;
+        }
+
+        close_stream_handle = TRUE;
+    }
+
+    stream_file_type = GetFileType(stream_handle);
+
+    if (stream_file_type == FILE_TYPE_CHAR)
+    {
+        /* Reading from an interactive console would block until the user closes the input. */
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"The standard input has to be redirected from a file or a pipe!");
+
+        goto cleanup_and_out;
+    }
+
+    stream_data = (struct StreamFileSourceData*) calloc(1, sizeof *stream_data);
+
+    if (!stream_data)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+
+        goto cleanup_and_out;
+    }
+
+    /* If the standard input is redirected from a regular file we can still provide a progress. */
+    if (stream_file_type == FILE_TYPE_DISK && GetFileSizeEx(stream_handle, &stream_size))
+    {
+        ret.has_known_size = TRUE;
+        ret.size = (unsigned __int64) stream_size.QuadPart;
+
+        UHASHTOOLS_PRINTF_LINE_INFO(L"The opened stream has a size of \"%I64u\" bytes.", ret.size);
+    }
+    else
+    {
+        UHASHTOOLS_PRINTF_LINE_INFO(L"The opened stream has an unknown size.");
+    }
+
+    stream_data->stream_handle = stream_handle;
+    stream_data->close_stream_handle = close_stream_handle; close_stream_handle = FALSE;
+
+    ret.is_ok = TRUE;
+    ret.read_function = &uhashtools_file_source_stream_read;
+    ret.close_function = &uhashtools_file_source_stream_close;
+    ret.backend_data = (void*) stream_data; stream_data = NULL;
+
+cleanup_and_out:
+    if (stream_data)
+    {
+        free(stream_data);
+    }
+
+    if (close_stream_handle)
+    {
+        (void) CloseHandle(stream_handle);
+    }
+
+    return ret;
+}
@@ -0,0 +1,61 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "file_source.h"
+
+#include <Windows.h>
+
+/*
+ * The stream file source reads data which is only available as a
+ * stream. Those streams can't be seeked and usually have no known
+ * size, so the data is read until the writing side closes the
+ * stream.
+ * 
+ * Supported targets:
+ * "-"                The standard input of the process. Allows hashing
+ *                    the output of another program without writing it
+ *                    to a temporary file first (for example
+ *                    "7z e -so archive.7z | usha256 -").
+ * "\\.\pipe\<name>"  A named pipe which has been created by another
+ *                    process.
+ */
+
+/**
+ * Checks if the given target must be opened with the stream file source.
+ * 
+ * @param target_file Target file as passed by the user.
+ * 
+ * @return TRUE if "target_file" is "-" or the path of a named pipe else FALSE.
+ */
+extern
+BOOL
+uhashtools_file_source_stream_is_stream_target
+(
+    const wchar_t* target_file
+);
+
+/**
+ * Opens the standard input or a named pipe as file source.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if the
+ *                          stream can't be opened.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param target_file "-" for the standard input or the path of a named pipe.
+ * 
+ * @return Opened file source. See "uhashtools_file_source_open()" for details.
+ */
+extern
+struct FileSource
+uhashtools_file_source_stream_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* target_file
+);
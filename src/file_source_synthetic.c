@@ -0,0 +1,327 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifdef _DEBUG
+
+#include "file_source_synthetic.h"
+
+#include "buffer_sizes.h"
+#include "error_utilities.h"
+#include "print_utilities.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#define SYNTHETIC_SPEC_PREFIX L"synthetic:"
+#define SYNTHETIC_PATTERN_BUF_SIZE (1024 * 64)
+#define SYNTHETIC_DEFAULT_SIZE (1024 * 1024 * 16)
+
+struct SyntheticFileSourceData
+{
+    unsigned __int64 size;
+    unsigned __int64 current_offset;
+    size_t chunk_size;
+    DWORD latency_ms;
+    DWORD jitter_ms;
+    BOOL fail_at_is_set;
+    unsigned __int64 fail_at;
+    BOOL hide_size;
+    unsigned int jitter_rng_state;
+    unsigned char pattern_buf[SYNTHETIC_PATTERN_BUF_SIZE];
+};
+
+static
+unsigned int
+uhashtools_synthetic_xorshift32
+(
+    unsigned int* rng_state
+)
+{
+    unsigned int x = *rng_state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *rng_state = x;
+
+    return x;
+}
+
+static
+BOOL
+uhashtools_synthetic_parse_u64
+(
+    const wchar_t* value_str,
+    unsigned __int64* value
+)
+{
+    wchar_t* value_str_end = NULL;
+
+    if (!value_str[0])
+    {
+        return FALSE;
+    }
+
+    *value = _wcstoui64(value_str, &value_str_end, 10);
+
+    return value_str_end && *value_str_end == L'\0';
+}
+
+static
+BOOL
+uhashtools_synthetic_parse_spec
+(
+    struct SyntheticFileSourceData* synthetic_data,
+    const wchar_t* synthetic_spec,
+    BOOL* pattern_is_zero
+)
+{
+    wchar_t spec_buf[FILEPATH_BUFFER_TSIZE];
+    wchar_t* next_token_ctx = NULL;
+    wchar_t* current_token = NULL;
+    errno_t copy_rc = 0;
+
+    copy_rc = wcscpy_s(spec_buf, FILEPATH_BUFFER_TSIZE, synthetic_spec + wcslen(SYNTHETIC_SPEC_PREFIX));
+
+    if (copy_rc != 0)
+    {
+        return FALSE;
+    }
+
+    for (current_token = wcstok_s(spec_buf, L",", &next_token_ctx);
+         current_token;
+         current_token = wcstok_s(NULL, L",", &next_token_ctx))
+    {
+        wchar_t* value_str = wcschr(current_token, L'=');
+        unsigned __int64 value = 0;
+
+        if (!value_str)
+        {
+            return FALSE;
+        }
+
+        *value_str = L'\0';
+        ++value_str;
+
+        if (wcscmp(current_token, L"pattern") == 0)
+        {
+            if (wcscmp(value_str, L"zero") == 0)
+            {
+                *pattern_is_zero = TRUE;
+            }
+            else if (wcscmp(value_str, L"random") == 0)
+            {
+                *pattern_is_zero = FALSE;
+            }
+            else
+            {
+                return FALSE;
+            }
+
+            continue;
+        }
+
+        if (!uhashtools_synthetic_parse_u64(value_str, &value))
+        {
+            return FALSE;
+        }
+
+        if (wcscmp(current_token, L"size") == 0)
+        {
+            synthetic_data->size = value;
+        }
+        else if (wcscmp(current_token, L"chunk_size") == 0 && value > 0 && value <= (unsigned __int64) MAXDWORD)
+        {
+            synthetic_data->chunk_size = (size_t) value;
+        }
+        else if (wcscmp(current_token, L"latency_ms") == 0 && value <= (unsigned __int64) MAXDWORD)
+        {
+            synthetic_data->latency_ms = (DWORD) value;
+        }
+        else if (wcscmp(current_token, L"jitter_ms") == 0 && value < (unsigned __int64) MAXDWORD)
+        {
+            synthetic_data->jitter_ms = (DWORD) value;
+        }
+        else if (wcscmp(current_token, L"hide_size") == 0 && value <= 1)
+        {
+            synthetic_data->hide_size = (BOOL) value;
+        }
+        else if (wcscmp(current_token, L"fail_at") == 0)
+        {
+            synthetic_data->fail_at_is_set = TRUE;
+            synthetic_data->fail_at = value;
+        }
+        else
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_file_source_synthetic_read
+(
+    struct FileSource* file_source,
+    unsigned char* read_buf,
+    size_t read_buf_size,
+    const unsigned char** read_data,
+    size_t* read_data_size,
+    BOOL* reached_eof
+)
+{
+    struct SyntheticFileSourceData* synthetic_data = (struct SyntheticFileSourceData*) file_source->backend_data;
+    const size_t pattern_offset = (size_t) (synthetic_data->current_offset % SYNTHETIC_PATTERN_BUF_SIZE);
+    unsigned __int64 read_size = synthetic_data->size - synthetic_data->current_offset;
+    DWORD read_delay_ms = synthetic_data->latency_ms;
+
+    UNREFERENCED_PARAMETER(read_buf);
+
+    if (synthetic_data->fail_at_is_set && synthetic_data->current_offset >= synthetic_data->fail_at)
+    {
+        UHASHTOOLS_PRINTF_LINE_DEBUG(L"Synthetic file source: Injecting read error at offset \"%I64u\".",
+                                     synthetic_data->current_offset);
+
+        return FALSE;
+    }
+
+    if (read_size > read_buf_size)
+    {
+        read_size = read_buf_size;
+    }
+
+    if (read_size > synthetic_data->chunk_size)
+    {
+        read_size = synthetic_data->chunk_size;
+    }
+
+    if (read_size > SYNTHETIC_PATTERN_BUF_SIZE - pattern_offset)
+    {
+        read_size = SYNTHETIC_PATTERN_BUF_SIZE - pattern_offset;
+    }
+
+    if (synthetic_data->fail_at_is_set && synthetic_data->current_offset + read_size > synthetic_data->fail_at)
+    {
+        /* Deliver the data up to the failure offset. The next read call will fail. */
+        read_size = synthetic_data->fail_at - synthetic_data->current_offset;
+    }
+
+    if (synthetic_data->jitter_ms > 0)
+    {
+        read_delay_ms += uhashtools_synthetic_xorshift32(&synthetic_data->jitter_rng_state) % (synthetic_data->jitter_ms + 1);
+    }
+
+    if (read_delay_ms > 0)
+    {
+        Sleep(read_delay_ms);
+    }
+
+    synthetic_data->current_offset += read_size;
+
+    *read_data = synthetic_data->pattern_buf + pattern_offset;
+    *read_data_size = (size_t) read_size;
+    *reached_eof = synthetic_data->current_offset >= synthetic_data->size;
+
+    return TRUE;
+}
+
+static
+void
+uhashtools_file_source_synthetic_close
+(
+    struct FileSource* file_source
+)
+{
+    free(file_source->backend_data);
+}
+
+BOOL
+uhashtools_file_source_synthetic_is_spec
+(
+    const wchar_t* target_file
+)
+{
+    UHASHTOOLS_ASSERT(target_file, L"Internal error: target_file is NULL!");
+
+    return wcsncmp(target_file, SYNTHETIC_SPEC_PREFIX, wcslen(SYNTHETIC_SPEC_PREFIX)) == 0;
+}
+
+struct FileSource
+uhashtools_file_source_synthetic_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* synthetic_spec
+)
+{
+    struct FileSource ret;
+    struct SyntheticFileSourceData* synthetic_data = NULL;
+    BOOL pattern_is_zero = FALSE;
+    unsigned int pattern_rng_state = 0x2545F491u;
+    size_t pattern_pos = 0;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(synthetic_spec, L"Internal error: synthetic_spec is NULL!");
+
+    (void) memset((void*) &ret, 0, sizeof ret);
+    ret.is_ok = FALSE;
+
+    synthetic_data = (struct SyntheticFileSourceData*) calloc(1, sizeof *synthetic_data);
+
+    if (!synthetic_data)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+
+        goto cleanup_and_out;
+    }
+
+    synthetic_data->size = SYNTHETIC_DEFAULT_SIZE;
+    synthetic_data->chunk_size = (size_t) -1;
+    synthetic_data->jitter_rng_state = 0x9E3779B9u;
+
+    if (!uhashtools_synthetic_parse_spec(synthetic_data, synthetic_spec, &pattern_is_zero))
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Invalid specification of the synthetic file source!");
+
+        goto cleanup_and_out;
+    }
+
+    if (!pattern_is_zero)
+    {
+        for (pattern_pos = 0; pattern_pos < SYNTHETIC_PATTERN_BUF_SIZE; ++pattern_pos)
+        {
+            synthetic_data->pattern_buf[pattern_pos] = (unsigned char) uhashtools_synthetic_xorshift32(&pattern_rng_state);
+        }
+    }
+
+    UHASHTOOLS_PRINTF_LINE_INFO(L"Opened synthetic file source with a size of \"%I64u\" bytes.", synthetic_data->size);
+
+    ret.is_ok = TRUE;
+    ret.has_known_size = !synthetic_data->hide_size;
+    ret.size = synthetic_data->hide_size ? 0 : synthetic_data->size;
+    ret.read_function = &uhashtools_file_source_synthetic_read;
+    ret.close_function = &uhashtools_file_source_synthetic_close;
+    ret.backend_data = (void*) synthetic_data; synthetic_data = NULL;
+
+cleanup_and_out:
+    if (synthetic_data)
+    {
+        free(synthetic_data);
+    }
+
+    return ret;
+}
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#ifdef _DEBUG
+
+#include "file_source.h"
+
+#include <Windows.h>
+
+/*
+ * The synthetic file source generates its content in memory instead
+ * of reading it from a disk. It can simulate slow, jittery or failing
+ * storage and is meant to test the behaviour of the hashing pipeline
+ * (progress reporting, cancellation and error handling) in a
+ * reproducible way. It's only available in debug builds.
+ * 
+ * A synthetic file source is selected by passing a specification
+ * instead of a filepath as target file. The specification starts
+ * with "synthetic:" followed by comma separated "key=value" options:
+ * 
+ * size=<bytes>          Size of the generated content (default: 16 MiB).
+ * chunk_size=<bytes>    Maximum amount of bytes returned per read call.
+ *                       Smaller values simulate short reads.
+ * latency_ms=<ms>       Delay of every read call.
+ * jitter_ms=<ms>        Additional random delay from 0 to this value
+ *                       on every read call.
+ * fail_at=<offset>      Simulates a read error as soon as this offset
+ *                       has been reached.
+ * pattern=<random|zero> Content of the generated data (default: random).
+ * hide_size=<0|1>       Reports the size as unknown like it's the case
+ *                       for pipes (default: 0).
+ * 
+ * Example: "synthetic:size=1073741824,latency_ms=2,jitter_ms=8,fail_at=536870912"
+ * 
+ * The generated content only depends on the "size" and "pattern"
+ * options, so the hash result of a synthetic file source is stable
+ * between runs.
+ */
+
+/**
+ * Checks if the given target is the specification of a synthetic file source.
+ * 
+ * @param target_file Target file as passed by the user.
+ * 
+ * @return TRUE if "target_file" starts with "synthetic:" else FALSE.
+ */
+extern
+BOOL
+uhashtools_file_source_synthetic_is_spec
+(
+    const wchar_t* target_file
+);
+
+/**
+ * Creates a synthetic file source from the given specification.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if the
+ *                          specification is invalid.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param synthetic_spec Specification of the synthetic file source.
+ * 
+ * @return Opened file source. See "uhashtools_file_source_open()" for details.
+ */
+extern
+struct FileSource
+uhashtools_file_source_synthetic_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* synthetic_spec
+);
+
+#endif
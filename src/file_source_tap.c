@@ -0,0 +1,110 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "file_source_tap.h"
+
+#include "error_utilities.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+struct TapFileSourceData
+{
+    struct FileSource tapped_file_source;
+    FileSourceTapCallbackFunction* tap_callback;
+    void* tap_callback_userdata;
+};
+
+static
+BOOL
+uhashtools_file_source_tap_read
+(
+    struct FileSource* file_source,
+    unsigned char* read_buf,
+    size_t read_buf_size,
+    const unsigned char** read_data,
+    size_t* read_data_size,
+    BOOL* reached_eof
+)
+{
+    struct TapFileSourceData* tap_data = (struct TapFileSourceData*) file_source->backend_data;
+
+    if (!uhashtools_file_source_read(&tap_data->tapped_file_source,
+                                     read_buf,
+                                     read_buf_size,
+                                     read_data,
+                                     read_data_size,
+                                     reached_eof))
+    {
+        return FALSE;
+    }
+
+    return tap_data->tap_callback(*read_data, *read_data_size, tap_data->tap_callback_userdata);
+}
+
+static
+void
+uhashtools_file_source_tap_close
+(
+    struct FileSource* file_source
+)
+{
+    struct TapFileSourceData* tap_data = (struct TapFileSourceData*) file_source->backend_data;
+
+    uhashtools_file_source_close(&tap_data->tapped_file_source);
+    free((void*) tap_data);
+}
+
+struct FileSource
+uhashtools_file_source_tap_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    struct FileSource* tapped_file_source,
+    FileSourceTapCallbackFunction* tap_callback,
+    void* tap_callback_userdata
+)
+{
+    struct FileSource ret;
+    struct TapFileSourceData* tap_data = NULL;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(tapped_file_source && tapped_file_source->is_ok,
+                      L"Internal error: tapped_file_source is NULL or not opened!");
+    UHASHTOOLS_ASSERT(tap_callback, L"Internal error: tap_callback is NULL!");
+
+    (void) memset((void*) &ret, 0, sizeof ret);
+    ret.is_ok = FALSE;
+
+    tap_data = (struct TapFileSourceData*) calloc(1, sizeof *tap_data);
+
+    if (!tap_data)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+        uhashtools_file_source_close(tapped_file_source);
+
+        return ret;
+    }
+
+    tap_data->tapped_file_source = *tapped_file_source;
+    tap_data->tap_callback = tap_callback;
+    tap_data->tap_callback_userdata = tap_callback_userdata;
+
+    ret.is_ok = TRUE;
+    ret.has_known_size = tapped_file_source->has_known_size;
+    ret.size = tapped_file_source->size;
+    ret.read_function = &uhashtools_file_source_tap_read;
+    ret.close_function = &uhashtools_file_source_tap_close;
+    ret.backend_data = (void*) tap_data;
+
+    (void) memset((void*) tapped_file_source, 0, sizeof *tapped_file_source);
+
+    return ret;
+}
@@ -0,0 +1,55 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "file_source.h"
+
+#include <Windows.h>
+
+/**
+ * Is called with every block of data read from the tapped file source.
+ * 
+ * @param data Read data. Only valid during the call.
+ * @param data_size Size of "data" in bytes.
+ * @param userdata Userdata passed to "uhashtools_file_source_tap_open()".
+ * 
+ * @return TRUE to continue or FALSE to let the read fail.
+ */
+typedef BOOL FileSourceTapCallbackFunction(const unsigned char* data,
+                                           size_t data_size,
+                                           void* userdata);
+
+/**
+ * Wraps an opened file source and passes every block of data read from
+ * it to a callback before returning it. This lets another consumer
+ * process the data in the same pass as the hashing implementation, for
+ * example the chunker of the chunk mode (see "chunk_mode.h").
+ * 
+ * @param error_message_buf Buffer which receives the user error message if the
+ *                          file source can't be wrapped.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param tapped_file_source Opened file source. It's owned by the returned file
+ *                           source from now on and closed together with it, even
+ *                           if wrapping fails.
+ * @param tap_callback Function which is called with every read block.
+ * @param tap_callback_userdata Userdata for "tap_callback".
+ * 
+ * @return Opened file source with the size of the tapped file source. See
+ *         "uhashtools_file_source_open()" for details.
+ */
+extern
+struct FileSource
+uhashtools_file_source_tap_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    struct FileSource* tapped_file_source,
+    FileSourceTapCallbackFunction* tap_callback,
+    void* tap_callback_userdata
+);
@@ -0,0 +1,106 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "gui_lv_common.h"
+
+#include "error_utilities.h"
+
+#include <CommCtrl.h>
+#include <Windows.h>
+
+#include <string.h>
+
+HWND
+uhashtools_lv_create
+(
+    HINSTANCE app_instance,
+    HWND parent_window,
+    DWORD style,
+    DWORD style_ex,
+    int x,
+    int y,
+    int width,
+    int height
+)
+{
+    HWND ret = NULL;
+    HFONT lv_font = NULL;
+    INITCOMMONCONTROLSEX init_common_controls;
+
+    /* Unlike the other controls the list view class has to be registered first. */
+    init_common_controls.dwSize = sizeof init_common_controls;
+    init_common_controls.dwICC = ICC_LISTVIEW_CLASSES;
+    (void) InitCommonControlsEx(&init_common_controls);
+
+    ret = CreateWindowExW(style_ex,
+                          WC_LISTVIEWW,    /* Window class */
+                          NULL,            /* Window title*/
+                          style,
+                          x,
+                          y,
+                          width,
+                          height,
+                          parent_window,
+                          NULL,            /* Menu handle */
+                          app_instance,
+                          NULL);           /* LP param */
+
+    UHASHTOOLS_ASSERT(ret != NULL, L"Internal error: CreateWindowExW failed!");
+
+    lv_font = (HFONT) GetStockObject(DEFAULT_GUI_FONT);
+    SendMessageW(ret, WM_SETFONT, (WPARAM) lv_font, MAKELPARAM(TRUE, 0));
+
+    return ret;
+}
+
+void
+uhashtools_lv_add_column
+(
+    HWND lv_handle,
+    int column_index,
+    int width,
+    int format,
+    const wchar_t* txt
+)
+{
+    LVCOLUMNW column;
+    int insert_rc = 0;
+
+    UHASHTOOLS_ASSERT(txt, L"Invalid param: Entered with txt == NULL!");
+
+    (void) memset((void*) &column, 0, sizeof column);
+
+    column.mask = LVCF_FMT | LVCF_WIDTH | LVCF_TEXT | LVCF_SUBITEM;
+    column.fmt = format;
+    column.cx = width;
+    column.pszText = (wchar_t*) txt;
+    column.iSubItem = column_index;
+
+    insert_rc = (int) SendMessageW(lv_handle, LVM_INSERTCOLUMNW, (WPARAM) column_index, (LPARAM) &column);
+    UHASHTOOLS_ASSERT(insert_rc == column_index, L"Internal error: Failed to insert a list view column!");
+}
+
+void
+uhashtools_lv_set_column_text
+(
+    HWND lv_handle,
+    int column_index,
+    const wchar_t* txt
+)
+{
+    LVCOLUMNW column;
+
+    UHASHTOOLS_ASSERT(txt, L"Invalid param: Entered with txt == NULL!");
+
+    (void) memset((void*) &column, 0, sizeof column);
+
+    column.mask = LVCF_TEXT;
+    column.pszText = (wchar_t*) txt;
+
+    (void) SendMessageW(lv_handle, LVM_SETCOLUMNW, (WPARAM) column_index, (LPARAM) &column);
+}
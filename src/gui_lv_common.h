@@ -0,0 +1,51 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+extern
+HWND
+uhashtools_lv_create
+(
+    HINSTANCE app_instance,
+    HWND parent_window,
+    DWORD style,
+    DWORD style_ex,
+    int x,
+    int y,
+    int width,
+    int height
+);
+
+/**
+ * Appends a column to a list view in report mode.
+ */
+extern
+void
+uhashtools_lv_add_column
+(
+    HWND lv_handle,
+    int column_index,
+    int width,
+    int format,
+    const wchar_t* txt
+);
+
+/**
+ * Changes the header text of a column.
+ */
+extern
+void
+uhashtools_lv_set_column_text
+(
+    HWND lv_handle,
+    int column_index,
+    const wchar_t* txt
+);
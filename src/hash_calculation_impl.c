@@ -9,14 +9,18 @@
 #include "hash_calculation_impl.h"
 
 #include "error_utilities.h"
+#include "file_source.h"
+#include "file_source_range.h"
 #include "print_utilities.h"
 #include "product.h"
+#include "throttle.h"
 
 #include <bcrypt.h>
-#include <io.h>
+#include <process.h>
 
 #include <limits.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #define FILE_READ_BUF_SIZE 1024 * 512
@@ -25,56 +29,91 @@
     #define STATUS_SUCCESS ((NTSTATUS) 0x00000000L)
 #endif
 
-struct OpenedTargetFile
+#ifndef STATUS_NOT_FOUND
+    #define STATUS_NOT_FOUND ((NTSTATUS) 0xC0000225L)
+#endif
+
+/* Interval for reporting the progress of targets with an unknown size. */
+#define STREAM_PROGRESS_REPORT_INTERVAL_MS 250
+
+/* The block workers read into a buffer on the heap, so they don't need much stack. */
+#define HASH_FILE_BLOCKS_THREAD_STACK_SIZE (1024 * 64)
+
+struct PreparedBuiltinHasherImpl
 {
     BOOL is_ok;
-    FILE* target_file_handle;
-    unsigned __int64 target_file_size;
+    void* hasher_state;
+    PUCHAR hash_out_buf;
+    size_t hash_out_buf_size;
 };
 
+#ifdef UHASHTOOLS_USE_BUILTIN_HASHER
+
+/*
+ * The hashing loop is bound to the built-in hasher implementation at compile
+ * time, so the code of the Windows CNG API implementation isn't part of the
+ * binary.
+ */
+#define PreparedHasherImpl PreparedBuiltinHasherImpl
+#define uhashtools_hash_impl_prepare uhashtools_builtin_hash_impl_prepare
+#define uhashtools_hash_impl_hash_data uhashtools_builtin_hash_impl_hash_data
+#define uhashtools_hash_impl_finish uhashtools_builtin_hash_impl_finish
+#define uhashtools_hash_impl_reset uhashtools_builtin_hash_impl_reset
+#define uhashtools_hash_impl_destroy uhashtools_builtin_hash_impl_destroy
+
+#else
+
 struct PreparedWinCngHasherImpl
 {
     BOOL is_ok;
+    BOOL is_algorithm_missing;
     BCRYPT_ALG_HANDLE cng_algorithm_provider_handle;
     PUCHAR cng_algorithm_object_memory;
+    ULONG cng_algorithm_object_size;
     PUCHAR hash_out_buf;
     size_t hash_out_buf_size;
     BCRYPT_HASH_HANDLE cng_algorithm_object_handle;
 };
 
-static
-void
-uhashtools_encode_single_byte_to_hex
-(
-    const unsigned char target_byte,
-    wchar_t* upper_hex_char,
-    wchar_t* lower_hex_char
-)
+/*
+ * Products with a hash algorithm which isn't provided by the Windows CNG
+ * API (see "uhashtools_product_get_bcrypt_algorithm_str()") are always
+ * using the built-in hasher implementation. The built-in hasher is also
+ * used if the algorithm is only provided by newer Windows versions (for
+ * example SHA-3).
+ */
+struct PreparedHasherImpl
 {
-    wchar_t print_buf[3];
-
-    (void) _snwprintf_s(print_buf, 3, _TRUNCATE, L"%.2hhx", target_byte);
+    BOOL is_ok;
+    BOOL uses_builtin_hasher;
+    struct PreparedBuiltinHasherImpl builtin_hasher_impl;
+    struct PreparedWinCngHasherImpl win_cng_hasher_impl;
+    PUCHAR hash_out_buf;
+    size_t hash_out_buf_size;
+};
 
-    *upper_hex_char = print_buf[0];
-    *lower_hex_char = print_buf[1];
-}
+#endif
 
+/*
+ * Writes the lower case hex string of the bytes including the
+ * terminator. Also used for filtering big result lists (see
+ * "result_store.h"), so the digits are taken from a table instead of
+ * formatting every byte.
+ */
 static
 BOOL
 uhashtools_encode_bytes_to_hex
 (
-    const PUCHAR bytes_buf,
+    const unsigned char* bytes_buf,
     const size_t bytes_buf_bytes,
     wchar_t* out_buf,
     size_t out_buf_tsize
 )
 {
-    const size_t result_hex_characters = bytes_buf_bytes * 2;
-    const size_t out_buf_required_tsize = result_hex_characters + 1;
+    static const wchar_t hex_digits[] = L"0123456789abcdef";
     size_t current_hash_buf_pos = 0;
-    size_t current_out_buf_pos = 0;
 
-    if (bytes_buf_bytes >= 2000 || out_buf_required_tsize > out_buf_tsize)
+    if (bytes_buf_bytes >= 2000 || out_buf_tsize < bytes_buf_bytes * 2 + 1)
     {
         return FALSE;
     }
@@ -82,17 +121,13 @@ uhashtools_encode_bytes_to_hex
     for (current_hash_buf_pos = 0; current_hash_buf_pos < bytes_buf_bytes; ++current_hash_buf_pos)
     {
         const unsigned char current_hash_byte = bytes_buf[current_hash_buf_pos];
-        wchar_t current_upper_hex_char = 0;
-        wchar_t current_lower_hex_char = 0;
 
-        uhashtools_encode_single_byte_to_hex(current_hash_byte, &current_upper_hex_char, &current_lower_hex_char);
-
-        out_buf[current_out_buf_pos] = current_upper_hex_char;
-        ++current_out_buf_pos;
-        out_buf[current_out_buf_pos] = current_lower_hex_char;
-        ++current_out_buf_pos;
+        out_buf[current_hash_buf_pos * 2] = hex_digits[current_hash_byte >> 4];
+        out_buf[current_hash_buf_pos * 2 + 1] = hex_digits[current_hash_byte & 0x0F];
     }
 
+    out_buf[bytes_buf_bytes * 2] = L'\0';
+
     return TRUE;
 }
 
@@ -129,88 +164,140 @@ uhashtools_calculate_current_progress
 }
 
 static
-struct OpenedTargetFile
-uhashtools_target_file_open
+struct PreparedBuiltinHasherImpl
+uhashtools_builtin_hash_impl_prepare
 (
     wchar_t* error_message_buf,
-    size_t error_message_buf_tsize,
-    const wchar_t* target_file
+    size_t error_message_buf_tsize
 )
 {
-    struct OpenedTargetFile ret;
-    errno_t target_file_open_error = 0;
-    FILE* target_file_handle = NULL;
-    int target_file_fd = 0;
-    __int64 filelengthi64_rc = 0;
-    unsigned __int64 target_file_size = 0;
+    struct PreparedBuiltinHasherImpl ret;
+    void* hasher_state = NULL;
+    PUCHAR hash_out_buf = NULL;
+    const size_t hash_out_buf_size = uhashtools_product_get_builtin_hasher_digest_size();
 
     UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
-    UHASHTOOLS_ASSERT(target_file, L"Internal error: target_file is NULL!");
 
     (void) memset((void*) &ret, 0, sizeof ret);
     ret.is_ok = FALSE;
 
-    target_file_open_error = _wfopen_s(&target_file_handle,
-                                       target_file,
-                                       L"rb");
+    hasher_state = malloc(uhashtools_product_get_builtin_hasher_state_size());
 
-    if (target_file_open_error || !target_file_handle)
+    if (!hasher_state)
     {
-        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to open the selected file!");
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
 
         goto cleanup_and_out;
     }
 
-    target_file_fd = _fileno(target_file_handle);
-
-    UHASHTOOLS_ASSERT(target_file_fd != -1, L"Failed to get file descriptor of the opened file!");
-
-    filelengthi64_rc = _filelengthi64(target_file_fd);
+    hash_out_buf = (PUCHAR) malloc(hash_out_buf_size);
 
-    if (filelengthi64_rc == -1)
+    if (!hash_out_buf)
     {
-        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to get the size of the selected file!");
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory for the hash result. Please download more RAM!");
 
         goto cleanup_and_out;
     }
 
-    target_file_size = (unsigned __int64) filelengthi64_rc;
-
-    UHASHTOOLS_PRINTF_LINE_INFO(L"The opened file has a size of \"%I64u\" bytes.", target_file_size);
-
-    (void) clearerr_s(target_file_handle);
+    uhashtools_product_builtin_hasher_init(hasher_state);
 
     ret.is_ok = TRUE;
-    ret.target_file_handle = target_file_handle; target_file_handle = NULL;
-    ret.target_file_size = target_file_size;
+    ret.hasher_state = hasher_state; hasher_state = NULL;
+    ret.hash_out_buf = hash_out_buf; hash_out_buf = NULL;
+    ret.hash_out_buf_size = hash_out_buf_size;
 
 cleanup_and_out:
-    if (target_file_handle)
+    if (hash_out_buf)
+    {
+        free((void*) hash_out_buf);
+    }
+
+    if (hasher_state)
     {
-        (void) fclose(target_file_handle);
+        free(hasher_state);
     }
 
     return ret;
 }
 
+static
+BOOL
+uhashtools_builtin_hash_impl_hash_data
+(
+    struct PreparedBuiltinHasherImpl* prepared_hasher_impl,
+    const unsigned char* data,
+    size_t data_size,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize
+)
+{
+    (void) error_message_buf;
+    (void) error_message_buf_tsize;
+
+    uhashtools_product_builtin_hasher_update(prepared_hasher_impl->hasher_state, data, data_size);
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_builtin_hash_impl_finish
+(
+    struct PreparedBuiltinHasherImpl* prepared_hasher_impl,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize
+)
+{
+    (void) error_message_buf;
+    (void) error_message_buf_tsize;
+
+    uhashtools_product_builtin_hasher_finish(prepared_hasher_impl->hasher_state, prepared_hasher_impl->hash_out_buf);
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_builtin_hash_impl_reset
+(
+    struct PreparedBuiltinHasherImpl* prepared_hasher_impl,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize
+)
+{
+    (void) error_message_buf;
+    (void) error_message_buf_tsize;
+
+    uhashtools_product_builtin_hasher_init(prepared_hasher_impl->hasher_state);
+
+    return TRUE;
+}
+
 static
 void
-uhashtools_target_file_close
+uhashtools_builtin_hash_impl_destroy
 (
-    struct OpenedTargetFile* opened_target_file
+    struct PreparedBuiltinHasherImpl* prepared_hasher_impl
 )
 {
-    if (!opened_target_file || !opened_target_file->is_ok)
+    if (!prepared_hasher_impl || !prepared_hasher_impl->is_ok)
     {
         return;
     }
 
-    (void) fclose(opened_target_file->target_file_handle);
+    free((void*) prepared_hasher_impl->hash_out_buf);
+    free(prepared_hasher_impl->hasher_state);
 
-    (void) memset((void*) opened_target_file, 0, sizeof *opened_target_file);
-    opened_target_file->is_ok = FALSE;
+    (void) memset((void*) prepared_hasher_impl, 0, sizeof *prepared_hasher_impl);
+    prepared_hasher_impl->is_ok = FALSE;
 }
 
+#ifndef UHASHTOOLS_USE_BUILTIN_HASHER
+
 static
 struct PreparedWinCngHasherImpl
 uhashtools_win_cng_hash_impl_prepare
@@ -244,6 +331,8 @@ uhashtools_win_cng_hash_impl_prepare
 
     if (open_algorithm_provider_rc != STATUS_SUCCESS)
     {
+        ret.is_algorithm_missing = (open_algorithm_provider_rc == STATUS_NOT_FOUND);
+
         (void) wcscpy_s(error_message_buf,
                         error_message_buf_tsize,
                         L"Failed to open the Windows BCrypt hashing algorithm provider!\nThis is either a bug in this software or your Windows doesn't have the required CNG algorithm provider.");
@@ -325,6 +414,7 @@ uhashtools_win_cng_hash_impl_prepare
     ret.is_ok = TRUE;
     ret.cng_algorithm_provider_handle = cng_algorithm_provider_handle; cng_algorithm_provider_handle = NULL;
     ret.cng_algorithm_object_memory = cng_algorithm_object_memory; cng_algorithm_object_memory = NULL;
+    ret.cng_algorithm_object_size = (ULONG) algorithm_object_required_memory;
     ret.hash_out_buf = hash_out_buf; hash_out_buf = NULL;
     ret.hash_out_buf_size = (size_t) hash_out_buf_required_size;
     ret.cng_algorithm_object_handle = cng_algorithm_object_handle; cng_algorithm_object_handle = NULL;
@@ -365,7 +455,11 @@ uhashtools_win_cng_hash_impl_destroy
         return;
     }
 
-    (void) BCryptDestroyHash(prepared_hasher_impl->cng_algorithm_object_handle);
+    if (prepared_hasher_impl->cng_algorithm_object_handle)
+    {
+        (void) BCryptDestroyHash(prepared_hasher_impl->cng_algorithm_object_handle);
+    }
+
     free((void*) prepared_hasher_impl->hash_out_buf);
     free((void*) prepared_hasher_impl->cng_algorithm_object_memory);
     (void) BCryptCloseAlgorithmProvider(prepared_hasher_impl->cng_algorithm_provider_handle, 0);
@@ -374,201 +468,576 @@ uhashtools_win_cng_hash_impl_destroy
     prepared_hasher_impl->is_ok = FALSE;
 }
 
+/*
+ * A finished CNG hash object can't be used again, so a new one is created
+ * in the memory of the old one. The algorithm provider stays open, which
+ * is the expensive part of preparing a hasher.
+ */
 static
-void
-uhashtools_report_current_calculation_progress
+BOOL
+uhashtools_win_cng_hash_impl_reset
 (
-    unsigned int current_calculation_progress,
-    OnProgressCallbackFunction* progress_callback,
-    void* progress_callback_userdata
+    struct PreparedWinCngHasherImpl* prepared_hasher_impl,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize
 )
 {
-    if (progress_callback)
+    NTSTATUS create_hash_object_rc = 0;
+
+    if (prepared_hasher_impl->cng_algorithm_object_handle)
+    {
+        (void) BCryptDestroyHash(prepared_hasher_impl->cng_algorithm_object_handle);
+        prepared_hasher_impl->cng_algorithm_object_handle = NULL;
+    }
+
+    create_hash_object_rc = BCryptCreateHash(prepared_hasher_impl->cng_algorithm_provider_handle,
+                                             &prepared_hasher_impl->cng_algorithm_object_handle,
+                                             prepared_hasher_impl->cng_algorithm_object_memory,
+                                             prepared_hasher_impl->cng_algorithm_object_size,
+                                             NULL,
+                                             0,
+                                             0);
+
+    if (create_hash_object_rc != STATUS_SUCCESS)
     {
-        progress_callback(current_calculation_progress, progress_callback_userdata);
+        prepared_hasher_impl->cng_algorithm_object_handle = NULL;
+
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Internal error: Failed to create the Win32 CNG hash object!");
+
+        return FALSE;
     }
+
+    return TRUE;
 }
 
 static
 BOOL
-uhashtools_check_is_cancelled
+uhashtools_win_cng_hash_impl_hash_data
 (
-    CheckIsCancelRequestedCallbackFunction* check_is_cancel_requested_callback,
-    void* check_is_cancel_requested_callback_userdata
+    struct PreparedWinCngHasherImpl* prepared_hasher_impl,
+    const unsigned char* data,
+    size_t data_size,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize
 )
 {
-    if (!check_is_cancel_requested_callback)
+    NTSTATUS hash_data_rc = 0;
+
+    hash_data_rc = BCryptHashData(prepared_hasher_impl->cng_algorithm_object_handle,
+                                  (PUCHAR) data,
+                                  (ULONG) data_size,
+                                  0);
+
+    if (hash_data_rc != STATUS_SUCCESS)
     {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Internal error: Failed to hash the selected file. BCryptHashData() failed!");
+
         return FALSE;
     }
 
-    return check_is_cancel_requested_callback(check_is_cancel_requested_callback_userdata);
+    return TRUE;
 }
 
-enum HashCalculatorResultCode
-uhashtools_hash_calculator_impl_hash_file
+static
+BOOL
+uhashtools_win_cng_hash_impl_finish
 (
-    unsigned char* file_read_buf,
-	size_t file_read_buf_tsize,
-    wchar_t* result_string_buf,
-    size_t result_string_buf_tsize,
-    const wchar_t* target_file,
-    CheckIsCancelRequestedCallbackFunction* check_is_cancel_requested_callback,
-    void* check_is_cancel_requested_callback_userdata,
-    OnProgressCallbackFunction* progress_callback,
-    void* progress_callback_userdata
+    struct PreparedWinCngHasherImpl* prepared_hasher_impl,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize
 )
 {
-    enum HashCalculatorResultCode ret = HashCalculatorResultCode_FAILED;
-    struct OpenedTargetFile opened_target_file;
-    struct PreparedWinCngHasherImpl prepared_hasher_impl;
-    BOOL hash_calculation_finished = FALSE;
-    BOOL hash_calculation_failed = FALSE;
-    BOOL cancel_requested = FALSE;
-    unsigned __int64 processed_bytes = 0;
-    unsigned int last_reported_calculation_progress = 0;
-
-    UHASHTOOLS_ASSERT(result_string_buf, L"Internal error: result_string_buf is NULL");
-    UHASHTOOLS_ASSERT(result_string_buf_tsize >= 256,
-                      L"Internal error: result_string_buf_tsize is to small. The buffer must fit at minimum 256 elements!");
-    UHASHTOOLS_ASSERT(target_file, L"Internal error: target_file is NULL");
+    NTSTATUS finish_hash_rc = 0;
 
-    (void) memset((void*) result_string_buf, 0, result_string_buf_tsize * (sizeof *result_string_buf));
-    (void) memset((void*) &opened_target_file, 0, sizeof opened_target_file);
-    (void) memset((void*) &prepared_hasher_impl, 0, sizeof prepared_hasher_impl);
-
-    /*
-     * Error handling beyond this point:
-     * Write the error message for the user into the "result_string_buf" buffer
-     * and jump out of this function with "goto cleanup_and_out;".
-     */
-
-    opened_target_file = uhashtools_target_file_open(result_string_buf, result_string_buf_tsize, target_file);
+    finish_hash_rc = BCryptFinishHash(prepared_hasher_impl->cng_algorithm_object_handle,
+                                      prepared_hasher_impl->hash_out_buf,
+                                      (ULONG) prepared_hasher_impl->hash_out_buf_size,
+                                      0);
 
-    if (!opened_target_file.is_ok)
+    if (finish_hash_rc != STATUS_SUCCESS)
     {
-        /*
-         * The function "uhashtools_target_file_open()" already writes the user
-         * error message into the "result_string_buf" buffer.
-         */
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Internal error: Failed to hash the selected file. BCryptFinishHash() failed!");
 
-        goto cleanup_and_out;
+        return FALSE;
     }
 
-    prepared_hasher_impl = uhashtools_win_cng_hash_impl_prepare(result_string_buf, result_string_buf_tsize);
-
-    if (!prepared_hasher_impl.is_ok)
-    {
-        /*
-         * The function "uhashtools_win_cng_hash_impl_prepare()" already writes the user
-         * error message into the "result_string_buf" buffer.
-         */
+    return TRUE;
+}
 
-        goto cleanup_and_out;
-    }
+static
+struct PreparedHasherImpl
+uhashtools_hash_impl_prepare
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize
+)
+{
+    struct PreparedHasherImpl ret;
 
-    cancel_requested = uhashtools_check_is_cancelled(check_is_cancel_requested_callback,
-                                                     check_is_cancel_requested_callback_userdata);
+    (void) memset((void*) &ret, 0, sizeof ret);
 
-    while (!hash_calculation_finished && !hash_calculation_failed && !cancel_requested)
+    if (uhashtools_product_get_bcrypt_algorithm_str())
     {
-        BOOL reached_eof = FALSE;
-        size_t read_characters = 0;
-        NTSTATUS hash_data_rc = 0;
-        unsigned int current_calculation_progress = 0;
-
-        /*
-         * Error handling within this while loop:
-         * Write the error message for the user into the "result_string_buf"
-         * buffer, set the variable "hash_calculation_failed" to 'TRUE' and
-         * jump out this loop using "break;".
-         */
-
-        read_characters = fread_s((void*) file_read_buf,
-                                  file_read_buf_tsize * sizeof(*file_read_buf),
-                                  sizeof(*file_read_buf),
-                                  file_read_buf_tsize,
-                                  opened_target_file.target_file_handle);
-
-        if (read_characters != file_read_buf_tsize)
-        {
-            if (ferror(opened_target_file.target_file_handle))
-            {
-                (void) wcscpy_s(result_string_buf,
-                                result_string_buf_tsize,
-                                L"Failed to read the selected file!");
-                
-                hash_calculation_failed = TRUE;
-                break;
-            }
-            else if (feof(opened_target_file.target_file_handle))
-            {
-                reached_eof = TRUE;
-            }
-        }
+        ret.win_cng_hasher_impl = uhashtools_win_cng_hash_impl_prepare(error_message_buf, error_message_buf_tsize);
+        ret.is_ok = ret.win_cng_hasher_impl.is_ok;
+        ret.hash_out_buf = ret.win_cng_hasher_impl.hash_out_buf;
+        ret.hash_out_buf_size = ret.win_cng_hasher_impl.hash_out_buf_size;
 
-        hash_data_rc = BCryptHashData(prepared_hasher_impl.cng_algorithm_object_handle,
-                                      file_read_buf,
-                                      (ULONG) read_characters,
-                                      0);
-
-        if (hash_data_rc != STATUS_SUCCESS)
+        if (ret.is_ok || !ret.win_cng_hasher_impl.is_algorithm_missing)
         {
-            (void) wcscpy_s(result_string_buf,
-                            result_string_buf_tsize,
-                            L"Internal error: Failed to hash the selected file. BCryptHashData() failed!");
-            
-            hash_calculation_failed = TRUE;
-            break;
+            return ret;
         }
 
-        processed_bytes += read_characters;
-        current_calculation_progress = uhashtools_calculate_current_progress(opened_target_file.target_file_size,
-                                                                             processed_bytes);
+        UHASHTOOLS_PRINTF_LINE_INFO(L"The Windows CNG API doesn't provide the hash algorithm. Using the built-in hasher instead.");
+    }
 
-        if (current_calculation_progress > last_reported_calculation_progress)
-        {
-            uhashtools_report_current_calculation_progress(current_calculation_progress,
-                                                           progress_callback,
-                                                           progress_callback_userdata);
+    ret.uses_builtin_hasher = TRUE;
+    ret.builtin_hasher_impl = uhashtools_builtin_hash_impl_prepare(error_message_buf, error_message_buf_tsize);
+    ret.is_ok = ret.builtin_hasher_impl.is_ok;
+    ret.hash_out_buf = ret.builtin_hasher_impl.hash_out_buf;
+    ret.hash_out_buf_size = ret.builtin_hasher_impl.hash_out_buf_size;
 
-            last_reported_calculation_progress = current_calculation_progress;
-        }
+    return ret;
+}
 
-        if (reached_eof)
-        {
-            NTSTATUS finish_hash_rc = 0;
-            BOOL encode_hash_to_hex_rc = FALSE;
+static
+BOOL
+uhashtools_hash_impl_hash_data
+(
+    struct PreparedHasherImpl* prepared_hasher_impl,
+    const unsigned char* data,
+    size_t data_size,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize
+)
+{
+    if (prepared_hasher_impl->uses_builtin_hasher)
+    {
+        return uhashtools_builtin_hash_impl_hash_data(&prepared_hasher_impl->builtin_hasher_impl,
+                                                      data,
+                                                      data_size,
+                                                      error_message_buf,
+                                                      error_message_buf_tsize);
+    }
 
-            finish_hash_rc = BCryptFinishHash(prepared_hasher_impl.cng_algorithm_object_handle,
-                                              prepared_hasher_impl.hash_out_buf,
-                                              (ULONG) prepared_hasher_impl.hash_out_buf_size,
-                                              0);
+    return uhashtools_win_cng_hash_impl_hash_data(&prepared_hasher_impl->win_cng_hasher_impl,
+                                                  data,
+                                                  data_size,
+                                                  error_message_buf,
+                                                  error_message_buf_tsize);
+}
 
-            if (finish_hash_rc != STATUS_SUCCESS)
-            {
-                (void) wcscpy_s(result_string_buf,
-                                result_string_buf_tsize,
-                                L"Internal error: Failed to hash the selected file. BCryptFinishHash() failed!");
-                
-                hash_calculation_failed = TRUE;
-                break;
-            }
+static
+BOOL
+uhashtools_hash_impl_finish
+(
+    struct PreparedHasherImpl* prepared_hasher_impl,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize
+)
+{
+    if (prepared_hasher_impl->uses_builtin_hasher)
+    {
+        return uhashtools_builtin_hash_impl_finish(&prepared_hasher_impl->builtin_hasher_impl,
+                                                   error_message_buf,
+                                                   error_message_buf_tsize);
+    }
 
-            encode_hash_to_hex_rc = uhashtools_encode_bytes_to_hex(prepared_hasher_impl.hash_out_buf,
-                                                                   prepared_hasher_impl.hash_out_buf_size,
-                                                                   result_string_buf,
-                                                                   result_string_buf_tsize);
+    return uhashtools_win_cng_hash_impl_finish(&prepared_hasher_impl->win_cng_hasher_impl,
+                                               error_message_buf,
+                                               error_message_buf_tsize);
+}
 
-            if (!encode_hash_to_hex_rc)
-            {
-                (void) wcscpy_s(result_string_buf,
-                                result_string_buf_tsize,
-                                L"Internal error: Failed to hash the selected file. Encoding the hash result to hex failed!");
-                
-                hash_calculation_failed = TRUE;
-                break;
-            }
+static
+BOOL
+uhashtools_hash_impl_reset
+(
+    struct PreparedHasherImpl* prepared_hasher_impl,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize
+)
+{
+    if (prepared_hasher_impl->uses_builtin_hasher)
+    {
+        return uhashtools_builtin_hash_impl_reset(&prepared_hasher_impl->builtin_hasher_impl,
+                                                  error_message_buf,
+                                                  error_message_buf_tsize);
+    }
+
+    return uhashtools_win_cng_hash_impl_reset(&prepared_hasher_impl->win_cng_hasher_impl,
+                                              error_message_buf,
+                                              error_message_buf_tsize);
+}
+
+static
+void
+uhashtools_hash_impl_destroy
+(
+    struct PreparedHasherImpl* prepared_hasher_impl
+)
+{
+    if (!prepared_hasher_impl || !prepared_hasher_impl->is_ok)
+    {
+        return;
+    }
+
+    if (prepared_hasher_impl->uses_builtin_hasher)
+    {
+        uhashtools_builtin_hash_impl_destroy(&prepared_hasher_impl->builtin_hasher_impl);
+    }
+    else
+    {
+        uhashtools_win_cng_hash_impl_destroy(&prepared_hasher_impl->win_cng_hasher_impl);
+    }
+
+    (void) memset((void*) prepared_hasher_impl, 0, sizeof *prepared_hasher_impl);
+    prepared_hasher_impl->is_ok = FALSE;
+}
+
+#endif
+
+static
+void
+uhashtools_report_current_calculation_progress
+(
+    BOOL is_size_known,
+    unsigned int current_calculation_progress,
+    unsigned __int64 processed_bytes,
+    DWORD calculation_start_tick,
+    OnProgressCallbackFunction* progress_callback,
+    void* progress_callback_userdata
+)
+{
+    struct HashCalculationProgress current_progress;
+    DWORD elapsed_ms = 0;
+
+    if (!progress_callback)
+    {
+        return;
+    }
+
+    (void) memset((void*) &current_progress, 0, sizeof current_progress);
+
+    elapsed_ms = GetTickCount() - calculation_start_tick;
+
+    current_progress.is_size_known = is_size_known;
+    current_progress.progress_in_percent = current_calculation_progress;
+    current_progress.processed_bytes = processed_bytes;
+    current_progress.bytes_per_second = elapsed_ms > 0 ? (processed_bytes * 1000u) / elapsed_ms : 0;
+
+    progress_callback(&current_progress, progress_callback_userdata);
+}
+
+static
+BOOL
+uhashtools_check_is_cancelled
+(
+    CheckIsCancelRequestedCallbackFunction* check_is_cancel_requested_callback,
+    void* check_is_cancel_requested_callback_userdata
+)
+{
+    if (!check_is_cancel_requested_callback)
+    {
+        return FALSE;
+    }
+
+    return check_is_cancel_requested_callback(check_is_cancel_requested_callback_userdata);
+}
+
+static
+BOOL
+uhashtools_finish_hash_to_digest
+(
+    struct PreparedHasherImpl* prepared_hasher_impl,
+    struct HashDigest* result_digest,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize
+)
+{
+    if (!uhashtools_hash_impl_finish(prepared_hasher_impl, error_message_buf, error_message_buf_tsize))
+    {
+        return FALSE;
+    }
+
+    if (prepared_hasher_impl->hash_out_buf_size > HASH_DIGEST_MAX_SIZE)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Internal error: Failed to hash the selected file. The hash result is too big!");
+
+        return FALSE;
+    }
+
+    (void) memcpy((void*) result_digest->bytes,
+                  (const void*) prepared_hasher_impl->hash_out_buf,
+                  prepared_hasher_impl->hash_out_buf_size);
+    result_digest->size = (unsigned int) prepared_hasher_impl->hash_out_buf_size;
+
+    return TRUE;
+}
+
+/*
+ * Fast path for file sources which fit completely into the read buffer.
+ * Usually they are hashed with a single read and a single hash call. No
+ * progress is reported and no cancel requests are checked, since the
+ * result is available immediately anyway. A file which has grown beyond
+ * the read buffer since it has been opened is left to the regular loop,
+ * in this case "reached_eof" stays FALSE and the hasher contains the
+ * "processed_bytes" which have been read so far.
+ */
+static
+BOOL
+uhashtools_hash_small_file_source
+(
+    struct PreparedHasherImpl* prepared_hasher_impl,
+    unsigned char* file_read_buf,
+    size_t file_read_buf_size,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    struct FileSource* opened_file_source,
+    unsigned __int64* processed_bytes,
+    BOOL* reached_eof
+)
+{
+    /* A file which has grown since it has been opened needs multiple reads. */
+    while (!*reached_eof && *processed_bytes <= (unsigned __int64) file_read_buf_size)
+    {
+        const unsigned char* read_data = NULL;
+        size_t read_size = 0;
+
+        if (!uhashtools_file_source_read(opened_file_source,
+                                         file_read_buf,
+                                         file_read_buf_size,
+                                         &read_data,
+                                         &read_size,
+                                         reached_eof))
+        {
+            (void) wcscpy_s(error_message_buf,
+                            error_message_buf_tsize,
+                            L"Failed to read the selected file!");
+
+            return FALSE;
+        }
+
+        uhashtools_throttle_pace_read(read_size);
+
+        if (!uhashtools_hash_impl_hash_data(prepared_hasher_impl,
+                                            read_data,
+                                            read_size,
+                                            error_message_buf,
+                                            error_message_buf_tsize))
+        {
+            return FALSE;
+        }
+
+        *processed_bytes += read_size;
+    }
+
+    return TRUE;
+}
+
+static
+enum HashCalculatorResultCode
+uhashtools_hash_opened_file_source
+(
+    struct PreparedHasherImpl* reused_hasher_impl,
+    unsigned char* file_read_buf,
+	size_t file_read_buf_tsize,
+    struct HashDigest* result_digest,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    struct FileSource* opened_file_source,
+    CheckIsCancelRequestedCallbackFunction* check_is_cancel_requested_callback,
+    void* check_is_cancel_requested_callback_userdata,
+    OnProgressCallbackFunction* progress_callback,
+    void* progress_callback_userdata
+)
+{
+    enum HashCalculatorResultCode ret = HashCalculatorResultCode_FAILED;
+    struct PreparedHasherImpl owned_hasher_impl;
+    struct PreparedHasherImpl* prepared_hasher_impl = NULL;
+    BOOL hash_calculation_finished = FALSE;
+    BOOL hash_calculation_failed = FALSE;
+    BOOL cancel_requested = FALSE;
+    BOOL small_file_reached_eof = FALSE;
+    unsigned __int64 processed_bytes = 0;
+    unsigned int last_reported_calculation_progress = 0;
+    DWORD calculation_start_tick = 0;
+    DWORD last_progress_report_tick = 0;
+
+    UHASHTOOLS_ASSERT(result_digest, L"Internal error: result_digest is NULL");
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL");
+    UHASHTOOLS_ASSERT(opened_file_source && opened_file_source->is_ok,
+                      L"Internal error: opened_file_source is NULL or not opened");
+
+    (void) memset((void*) result_digest, 0, sizeof *result_digest);
+    (void) memset((void*) error_message_buf, 0, error_message_buf_tsize * (sizeof *error_message_buf));
+    (void) memset((void*) &owned_hasher_impl, 0, sizeof owned_hasher_impl);
+
+    /*
+     * Error handling beyond this point:
+     * Write the error message for the user into the "error_message_buf" buffer
+     * and jump out of this function with "goto cleanup_and_out;".
+     */
+
+    if (reused_hasher_impl)
+    {
+        /* A reused hasher still contains the state of its previous calculation. */
+        if (!uhashtools_hash_impl_reset(reused_hasher_impl, error_message_buf, error_message_buf_tsize))
+        {
+            goto cleanup_and_out;
+        }
+
+        prepared_hasher_impl = reused_hasher_impl;
+    }
+    else
+    {
+        owned_hasher_impl = uhashtools_hash_impl_prepare(error_message_buf, error_message_buf_tsize);
+
+        if (!owned_hasher_impl.is_ok)
+        {
+            /*
+             * The function "uhashtools_hash_impl_prepare()" already writes the user
+             * error message into the "error_message_buf" buffer.
+             */
+
+            goto cleanup_and_out;
+        }
+
+        prepared_hasher_impl = &owned_hasher_impl;
+    }
+
+    if (opened_file_source->has_known_size &&
+        opened_file_source->size <= (unsigned __int64) (file_read_buf_tsize * sizeof(*file_read_buf)))
+    {
+        if (!uhashtools_hash_small_file_source(prepared_hasher_impl,
+                                               file_read_buf,
+                                               file_read_buf_tsize * sizeof(*file_read_buf),
+                                               error_message_buf,
+                                               error_message_buf_tsize,
+                                               opened_file_source,
+                                               &processed_bytes,
+                                               &small_file_reached_eof))
+        {
+            goto cleanup_and_out;
+        }
+
+        if (small_file_reached_eof)
+        {
+            if (uhashtools_finish_hash_to_digest(prepared_hasher_impl, result_digest, error_message_buf, error_message_buf_tsize))
+            {
+                ret = HashCalculatorResultCode_SUCCESS;
+            }
+
+            goto cleanup_and_out;
+        }
+    }
+
+    calculation_start_tick = GetTickCount();
+    last_progress_report_tick = calculation_start_tick;
+
+    if (!opened_file_source->has_known_size)
+    {
+        /* Let the receiver know as early as possible that there won't be a percentage progress. */
+        uhashtools_report_current_calculation_progress(FALSE,
+                                                       0,
+                                                       0,
+                                                       calculation_start_tick,
+                                                       progress_callback,
+                                                       progress_callback_userdata);
+    }
+
+    cancel_requested = uhashtools_check_is_cancelled(check_is_cancel_requested_callback,
+                                                     check_is_cancel_requested_callback_userdata);
+
+    while (!hash_calculation_finished && !hash_calculation_failed && !cancel_requested)
+    {
+        BOOL reached_eof = FALSE;
+        BOOL read_success = FALSE;
+        const unsigned char* read_data = NULL;
+        size_t read_characters = 0;
+        unsigned int current_calculation_progress = 0;
+        BOOL progress_report_is_due = FALSE;
+
+        /*
+         * Error handling within this while loop:
+         * Write the error message for the user into the "error_message_buf"
+         * buffer, set the variable "hash_calculation_failed" to 'TRUE' and
+         * jump out this loop using "break;".
+         */
+
+        read_success = uhashtools_file_source_read(opened_file_source,
+                                                   file_read_buf,
+                                                   file_read_buf_tsize * sizeof(*file_read_buf),
+                                                   &read_data,
+                                                   &read_characters,
+                                                   &reached_eof);
+
+        if (!read_success)
+        {
+            (void) wcscpy_s(error_message_buf,
+                            error_message_buf_tsize,
+                            L"Failed to read the selected file!");
+            
+            hash_calculation_failed = TRUE;
+            break;
+        }
+
+        uhashtools_throttle_pace_read(read_characters);
+
+        if (!uhashtools_hash_impl_hash_data(prepared_hasher_impl,
+                                            read_data,
+                                            read_characters,
+                                            error_message_buf,
+                                            error_message_buf_tsize))
+        {
+            hash_calculation_failed = TRUE;
+            break;
+        }
+
+        processed_bytes += read_characters;
+
+        if (opened_file_source->has_known_size)
+        {
+            current_calculation_progress = uhashtools_calculate_current_progress(opened_file_source->size,
+                                                                                 processed_bytes);
+            progress_report_is_due = current_calculation_progress > last_reported_calculation_progress;
+        }
+        else
+        {
+            /* Without a known size we're reporting the processed bytes in a fixed interval. */
+            progress_report_is_due = GetTickCount() - last_progress_report_tick >= STREAM_PROGRESS_REPORT_INTERVAL_MS;
+        }
+
+        if (progress_report_is_due)
+        {
+            uhashtools_report_current_calculation_progress(opened_file_source->has_known_size,
+                                                           current_calculation_progress,
+                                                           processed_bytes,
+                                                           calculation_start_tick,
+                                                           progress_callback,
+                                                           progress_callback_userdata);
+
+            last_reported_calculation_progress = current_calculation_progress;
+            last_progress_report_tick = GetTickCount();
+        }
+
+        if (reached_eof)
+        {
+            if (!uhashtools_finish_hash_to_digest(prepared_hasher_impl,
+                                                  result_digest,
+                                                  error_message_buf,
+                                                  error_message_buf_tsize))
+            {
+                hash_calculation_failed = TRUE;
+                break;
+            }
 
             hash_calculation_finished = TRUE;
             break;
@@ -587,7 +1056,7 @@ uhashtools_hash_calculator_impl_hash_file
     }
     else if (cancel_requested)
     {
-        (void) wcscpy_s(result_string_buf, result_string_buf_tsize, L"Received cancel request!");
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Received cancel request!");
 
         ret = HashCalculatorResultCode_CANCELED;
     }
@@ -597,15 +1066,812 @@ uhashtools_hash_calculator_impl_hash_file
     }
 
 cleanup_and_out:
-    if (prepared_hasher_impl.is_ok)
+    if (owned_hasher_impl.is_ok)
     {
-        uhashtools_win_cng_hash_impl_destroy(&prepared_hasher_impl);
+        uhashtools_hash_impl_destroy(&owned_hasher_impl);
     }
 
-    if (opened_target_file.is_ok)
+    return ret;
+}
+
+enum HashCalculatorResultCode
+uhashtools_hash_calculator_impl_hash_file_source_to_digest
+(
+    unsigned char* file_read_buf,
+    size_t file_read_buf_tsize,
+    struct HashDigest* result_digest,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    struct FileSource* opened_file_source,
+    CheckIsCancelRequestedCallbackFunction* check_is_cancel_requested_callback,
+    void* check_is_cancel_requested_callback_userdata,
+    OnProgressCallbackFunction* progress_callback,
+    void* progress_callback_userdata
+)
+{
+    enum HashCalculatorResultCode ret = HashCalculatorResultCode_FAILED;
+    struct ThrottleFileState throttle_file_state;
+
+    uhashtools_throttle_begin_file(&throttle_file_state);
+
+    ret = uhashtools_hash_opened_file_source(NULL,
+                                             file_read_buf,
+                                             file_read_buf_tsize,
+                                             result_digest,
+                                             error_message_buf,
+                                             error_message_buf_tsize,
+                                             opened_file_source,
+                                             check_is_cancel_requested_callback,
+                                             check_is_cancel_requested_callback_userdata,
+                                             progress_callback,
+                                             progress_callback_userdata);
+
+    uhashtools_throttle_end_file(&throttle_file_state);
+
+    return ret;
+}
+
+struct PreparedHasher
+{
+    struct PreparedHasherImpl prepared_hasher_impl;
+};
+
+struct PreparedHasher*
+uhashtools_hash_calculator_impl_prepare_hasher
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize
+)
+{
+    struct PreparedHasher* ret = NULL;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL");
+
+    ret = (struct PreparedHasher*) malloc(sizeof *ret);
+
+    if (!ret)
     {
-        uhashtools_target_file_close(&opened_target_file);
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+
+        return NULL;
     }
 
-    return ret;
+    ret->prepared_hasher_impl = uhashtools_hash_impl_prepare(error_message_buf, error_message_buf_tsize);
+
+    if (!ret->prepared_hasher_impl.is_ok)
+    {
+        free((void*) ret);
+
+        return NULL;
+    }
+
+    return ret;
+}
+
+void
+uhashtools_hash_calculator_impl_destroy_hasher
+(
+    struct PreparedHasher* prepared_hasher
+)
+{
+    if (!prepared_hasher)
+    {
+        return;
+    }
+
+    uhashtools_hash_impl_destroy(&prepared_hasher->prepared_hasher_impl);
+    free((void*) prepared_hasher);
+}
+
+enum HashCalculatorResultCode
+uhashtools_hash_calculator_impl_hash_file_source_with_hasher_to_digest
+(
+    struct PreparedHasher* prepared_hasher,
+    unsigned char* file_read_buf,
+    size_t file_read_buf_tsize,
+    struct HashDigest* result_digest,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    struct FileSource* opened_file_source,
+    CheckIsCancelRequestedCallbackFunction* check_is_cancel_requested_callback,
+    void* check_is_cancel_requested_callback_userdata,
+    OnProgressCallbackFunction* progress_callback,
+    void* progress_callback_userdata
+)
+{
+    enum HashCalculatorResultCode ret = HashCalculatorResultCode_FAILED;
+    struct ThrottleFileState throttle_file_state;
+
+    UHASHTOOLS_ASSERT(prepared_hasher, L"Internal error: prepared_hasher is NULL");
+
+    uhashtools_throttle_begin_file(&throttle_file_state);
+
+    ret = uhashtools_hash_opened_file_source(&prepared_hasher->prepared_hasher_impl,
+                                             file_read_buf,
+                                             file_read_buf_tsize,
+                                             result_digest,
+                                             error_message_buf,
+                                             error_message_buf_tsize,
+                                             opened_file_source,
+                                             check_is_cancel_requested_callback,
+                                             check_is_cancel_requested_callback_userdata,
+                                             progress_callback,
+                                             progress_callback_userdata);
+
+    uhashtools_throttle_end_file(&throttle_file_state);
+
+    return ret;
+}
+
+enum HashCalculatorResultCode
+uhashtools_hash_calculator_impl_hash_file_to_digest
+(
+    unsigned char* file_read_buf,
+    size_t file_read_buf_tsize,
+    struct HashDigest* result_digest,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* target_file,
+    CheckIsCancelRequestedCallbackFunction* check_is_cancel_requested_callback,
+    void* check_is_cancel_requested_callback_userdata,
+    OnProgressCallbackFunction* progress_callback,
+    void* progress_callback_userdata
+)
+{
+    enum HashCalculatorResultCode ret = HashCalculatorResultCode_FAILED;
+    struct FileSource opened_file_source;
+    struct ThrottleFileState throttle_file_state;
+
+    UHASHTOOLS_ASSERT(result_digest, L"Internal error: result_digest is NULL");
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL");
+    UHASHTOOLS_ASSERT(target_file, L"Internal error: target_file is NULL");
+
+    (void) memset((void*) result_digest, 0, sizeof *result_digest);
+    (void) memset((void*) error_message_buf, 0, error_message_buf_tsize * (sizeof *error_message_buf));
+
+    /* The thread slot is taken before the file is opened, so waiting threads aren't keeping files open. */
+    uhashtools_throttle_begin_file(&throttle_file_state);
+
+    opened_file_source = uhashtools_file_source_open(error_message_buf, error_message_buf_tsize, target_file);
+
+    if (!opened_file_source.is_ok)
+    {
+        /*
+         * The function "uhashtools_file_source_open()" already writes the user
+         * error message into the "error_message_buf" buffer.
+         */
+
+        uhashtools_throttle_end_file(&throttle_file_state);
+
+        return HashCalculatorResultCode_FAILED;
+    }
+
+    ret = uhashtools_hash_opened_file_source(NULL,
+                                             file_read_buf,
+                                             file_read_buf_tsize,
+                                             result_digest,
+                                             error_message_buf,
+                                             error_message_buf_tsize,
+                                             &opened_file_source,
+                                             check_is_cancel_requested_callback,
+                                             check_is_cancel_requested_callback_userdata,
+                                             progress_callback,
+                                             progress_callback_userdata);
+
+    uhashtools_file_source_close(&opened_file_source);
+    uhashtools_throttle_end_file(&throttle_file_state);
+
+    return ret;
+}
+
+BOOL
+uhashtools_hash_calculator_impl_hash_buffer_to_digest
+(
+    const unsigned char* data,
+    size_t data_size,
+    struct HashDigest* result_digest,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize
+)
+{
+    BOOL ret = FALSE;
+    struct PreparedHasherImpl prepared_hasher_impl;
+
+    UHASHTOOLS_ASSERT(data || data_size == 0, L"Internal error: data is NULL");
+    UHASHTOOLS_ASSERT(result_digest, L"Internal error: result_digest is NULL");
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL");
+
+    (void) memset((void*) result_digest, 0, sizeof *result_digest);
+
+    prepared_hasher_impl = uhashtools_hash_impl_prepare(error_message_buf, error_message_buf_tsize);
+
+    if (!prepared_hasher_impl.is_ok)
+    {
+        return FALSE;
+    }
+
+    /* Windows CNG takes the size as ULONG, so big buffers are hashed in parts. */
+    while (data_size > 0)
+    {
+        const size_t part_size = data_size < FILE_READ_BUF_SIZE ? data_size : FILE_READ_BUF_SIZE;
+
+        if (!uhashtools_hash_impl_hash_data(&prepared_hasher_impl,
+                                            data,
+                                            part_size,
+                                            error_message_buf,
+                                            error_message_buf_tsize))
+        {
+            goto cleanup_and_out;
+        }
+
+        data += part_size;
+        data_size -= part_size;
+    }
+
+    ret = uhashtools_finish_hash_to_digest(&prepared_hasher_impl,
+                                           result_digest,
+                                           error_message_buf,
+                                           error_message_buf_tsize);
+
+cleanup_and_out:
+    uhashtools_hash_impl_destroy(&prepared_hasher_impl);
+
+    return ret;
+}
+
+enum HashCalculatorResultCode
+uhashtools_hash_calculator_impl_resume_file_source_to_digest
+(
+    unsigned char* file_read_buf,
+    size_t file_read_buf_tsize,
+    struct HashDigest* result_digest,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    struct FileSource* opened_file_source,
+    struct HashResumeState* resume_state
+)
+{
+    enum HashCalculatorResultCode ret = HashCalculatorResultCode_FAILED;
+    struct PreparedBuiltinHasherImpl prepared_hasher_impl;
+    struct ThrottleFileState throttle_file_state;
+    const size_t hasher_state_size = uhashtools_product_get_builtin_hasher_state_size();
+    void* resumable_hasher_state = NULL;
+    unsigned __int64 hashed_size = 0;
+    BOOL reached_eof = FALSE;
+
+    UHASHTOOLS_ASSERT(result_digest, L"Internal error: result_digest is NULL");
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL");
+    UHASHTOOLS_ASSERT(opened_file_source && opened_file_source->is_ok,
+                      L"Internal error: opened_file_source is NULL or not opened");
+    UHASHTOOLS_ASSERT(resume_state, L"Internal error: resume_state is NULL");
+
+    (void) memset((void*) result_digest, 0, sizeof *result_digest);
+    (void) memset((void*) error_message_buf, 0, error_message_buf_tsize * (sizeof *error_message_buf));
+
+    uhashtools_throttle_begin_file(&throttle_file_state);
+
+    prepared_hasher_impl = uhashtools_builtin_hash_impl_prepare(error_message_buf, error_message_buf_tsize);
+
+    if (!prepared_hasher_impl.is_ok)
+    {
+        goto cleanup_and_out;
+    }
+
+    if (resume_state->hasher_state)
+    {
+        (void) memcpy(prepared_hasher_impl.hasher_state, (const void*) resume_state->hasher_state, hasher_state_size);
+        hashed_size = resume_state->hashed_size;
+    }
+
+    while (!reached_eof)
+    {
+        const unsigned char* read_data = NULL;
+        size_t read_size = 0;
+
+        if (!uhashtools_file_source_read(opened_file_source,
+                                         file_read_buf,
+                                         file_read_buf_tsize * sizeof(*file_read_buf),
+                                         &read_data,
+                                         &read_size,
+                                         &reached_eof))
+        {
+            (void) wcscpy_s(error_message_buf,
+                            error_message_buf_tsize,
+                            L"Failed to read the selected file!");
+
+            goto cleanup_and_out;
+        }
+
+        uhashtools_throttle_pace_read(read_size);
+
+        if (!uhashtools_builtin_hash_impl_hash_data(&prepared_hasher_impl,
+                                                    read_data,
+                                                    read_size,
+                                                    error_message_buf,
+                                                    error_message_buf_tsize))
+        {
+            goto cleanup_and_out;
+        }
+
+        hashed_size += read_size;
+    }
+
+    /* Finishing modifies the hasher state, so the state for the next run is copied before. */
+    resumable_hasher_state = malloc(hasher_state_size);
+
+    if (!resumable_hasher_state)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+
+        goto cleanup_and_out;
+    }
+
+    (void) memcpy(resumable_hasher_state, (const void*) prepared_hasher_impl.hasher_state, hasher_state_size);
+
+    if (!uhashtools_builtin_hash_impl_finish(&prepared_hasher_impl, error_message_buf, error_message_buf_tsize))
+    {
+        goto cleanup_and_out;
+    }
+
+    if (prepared_hasher_impl.hash_out_buf_size > HASH_DIGEST_MAX_SIZE)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Internal error: Failed to hash the selected file. The hash result is too big!");
+
+        goto cleanup_and_out;
+    }
+
+    (void) memcpy((void*) result_digest->bytes,
+                  (const void*) prepared_hasher_impl.hash_out_buf,
+                  prepared_hasher_impl.hash_out_buf_size);
+    result_digest->size = (unsigned int) prepared_hasher_impl.hash_out_buf_size;
+
+    uhashtools_hash_calculator_impl_free_resume_state(resume_state);
+    resume_state->hashed_size = hashed_size;
+    resume_state->hasher_state = resumable_hasher_state; resumable_hasher_state = NULL;
+
+    ret = HashCalculatorResultCode_SUCCESS;
+
+cleanup_and_out:
+    if (resumable_hasher_state)
+    {
+        free(resumable_hasher_state);
+    }
+
+    uhashtools_builtin_hash_impl_destroy(&prepared_hasher_impl);
+    uhashtools_throttle_end_file(&throttle_file_state);
+
+    return ret;
+}
+
+void
+uhashtools_hash_calculator_impl_free_resume_state
+(
+    struct HashResumeState* resume_state
+)
+{
+    UHASHTOOLS_ASSERT(resume_state, L"Internal error: resume_state is NULL");
+
+    if (resume_state->hasher_state)
+    {
+        free(resume_state->hasher_state);
+    }
+
+    (void) memset((void*) resume_state, 0, sizeof *resume_state);
+}
+
+/* State shared by the worker threads of "uhashtools_hash_calculator_impl_hash_file_blocks_to_digests()". */
+struct HashFileBlocksCtx
+{
+    const wchar_t* target_file;
+    unsigned __int64 file_size;
+    unsigned __int64 block_size;
+    unsigned __int64 blocks_count;
+    OnBlockDigestCallbackFunction* block_digest_callback;
+    void* block_digest_callback_userdata;
+
+    /* Protects the members below and serializes the calls of the callback. */
+    CRITICAL_SECTION blocks_lock;
+    unsigned __int64 next_block_index;
+    BOOL is_stopped;
+    BOOL is_failed;
+    wchar_t error_message_buf[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+};
+
+/*
+ * Hashes a single block with the file source and the hasher of the
+ * calling worker thread. The file source is moved to the block and the
+ * hasher is reset, so neither the file nor the algorithm provider are
+ * opened again for every block.
+ */
+static
+BOOL
+uhashtools_hash_file_block
+(
+    struct HashFileBlocksCtx* ctx,
+    struct PreparedHasherImpl* prepared_hasher_impl,
+    struct FileSource* file_source,
+    unsigned char* file_read_buf,
+    size_t file_read_buf_size,
+    unsigned __int64 block_index,
+    struct HashDigest* digest,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize
+)
+{
+    const unsigned __int64 block_offset = block_index * ctx->block_size;
+    const unsigned __int64 block_size = ctx->file_size - block_offset < ctx->block_size ? ctx->file_size - block_offset
+                                                                                        : ctx->block_size;
+    enum HashCalculatorResultCode hash_rc = HashCalculatorResultCode_FAILED;
+
+    if (!uhashtools_file_source_range_select(file_source,
+                                             error_message_buf,
+                                             error_message_buf_tsize,
+                                             block_offset,
+                                             block_size))
+    {
+        return FALSE;
+    }
+
+    if (file_source->size != block_size)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The selected file has been truncated!");
+
+        return FALSE;
+    }
+
+    hash_rc = uhashtools_hash_opened_file_source(prepared_hasher_impl,
+                                                 file_read_buf,
+                                                 file_read_buf_size,
+                                                 digest,
+                                                 error_message_buf,
+                                                 error_message_buf_tsize,
+                                                 file_source,
+                                                 NULL,
+                                                 NULL,
+                                                 NULL,
+                                                 NULL);
+
+    return hash_rc == HashCalculatorResultCode_SUCCESS;
+}
+
+/*
+ * Takes the next block until all blocks are taken or the calculation
+ * has been stopped. The first failure of any worker stops all workers.
+ */
+static
+unsigned int
+__stdcall
+uhashtools_hash_file_blocks_thread_function
+(
+    void* thread_param
+)
+{
+    struct HashFileBlocksCtx* ctx = (struct HashFileBlocksCtx*) thread_param;
+    wchar_t error_message_buf[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    unsigned char* file_read_buf = NULL;
+    size_t file_read_buf_size = FILE_READ_BUF_SIZE;
+    struct PreparedHasherImpl prepared_hasher_impl;
+    struct FileSource file_source;
+    struct ThrottleFileState throttle_file_state;
+    BOOL is_failed = FALSE;
+
+    (void) memset((void*) &prepared_hasher_impl, 0, sizeof prepared_hasher_impl);
+    (void) memset((void*) &file_source, 0, sizeof file_source);
+
+    /* A block never needs a bigger buffer than a single read of the whole block. */
+    if (ctx->block_size < (unsigned __int64) file_read_buf_size)
+    {
+        file_read_buf_size = (size_t) ctx->block_size;
+    }
+
+    file_read_buf = (unsigned char*) malloc(file_read_buf_size);
+
+    if (!file_read_buf)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+        is_failed = TRUE;
+    }
+
+    if (!is_failed)
+    {
+        prepared_hasher_impl = uhashtools_hash_impl_prepare(error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE);
+        is_failed = !prepared_hasher_impl.is_ok;
+    }
+
+    if (!is_failed)
+    {
+        /* Every block selects its own range of the file source. */
+        file_source = uhashtools_file_source_range_open(error_message_buf,
+                                                        GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                        ctx->target_file,
+                                                        0,
+                                                        0);
+        is_failed = !file_source.is_ok;
+    }
+
+    uhashtools_throttle_begin_file(&throttle_file_state);
+
+    EnterCriticalSection(&ctx->blocks_lock);
+
+    while (!is_failed && !ctx->is_stopped && ctx->next_block_index < ctx->blocks_count)
+    {
+        const unsigned __int64 block_index = ctx->next_block_index;
+        struct HashDigest digest;
+
+        ++ctx->next_block_index;
+
+        LeaveCriticalSection(&ctx->blocks_lock);
+
+        is_failed = !uhashtools_hash_file_block(ctx,
+                                                &prepared_hasher_impl,
+                                                &file_source,
+                                                file_read_buf,
+                                                file_read_buf_size,
+                                                block_index,
+                                                &digest,
+                                                error_message_buf,
+                                                GENERIC_TXT_MESSAGES_BUFFER_TSIZE);
+
+        EnterCriticalSection(&ctx->blocks_lock);
+
+        /* A block which has been finished after another worker stopped the calculation isn't reported anymore. */
+        if (!is_failed && !ctx->is_stopped &&
+            !ctx->block_digest_callback(block_index, &digest, ctx->block_digest_callback_userdata))
+        {
+            ctx->is_stopped = TRUE;
+        }
+    }
+
+    if (is_failed)
+    {
+        if (!ctx->is_failed)
+        {
+            (void) wcscpy_s(ctx->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, error_message_buf);
+            ctx->is_failed = TRUE;
+        }
+
+        ctx->is_stopped = TRUE;
+    }
+
+    LeaveCriticalSection(&ctx->blocks_lock);
+
+    uhashtools_throttle_end_file(&throttle_file_state);
+
+    uhashtools_file_source_close(&file_source);
+    uhashtools_hash_impl_destroy(&prepared_hasher_impl);
+    free((void*) file_read_buf);
+
+    return 0;
+}
+
+enum HashCalculatorResultCode
+uhashtools_hash_calculator_impl_hash_file_blocks_to_digests
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* target_file,
+    unsigned __int64 file_size,
+    unsigned __int64 block_size,
+    unsigned __int64 blocks_count,
+    unsigned int threads_count,
+    OnBlockDigestCallbackFunction* block_digest_callback,
+    void* block_digest_callback_userdata
+)
+{
+    enum HashCalculatorResultCode ret = HashCalculatorResultCode_FAILED;
+    struct HashFileBlocksCtx* ctx = NULL;
+    HANDLE* thread_handles = NULL;
+    unsigned int started_threads_count = 0;
+    unsigned int thread_index = 0;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL");
+    UHASHTOOLS_ASSERT(target_file, L"Internal error: target_file is NULL");
+    UHASHTOOLS_ASSERT(block_digest_callback, L"Internal error: block_digest_callback is NULL");
+    UHASHTOOLS_ASSERT(block_size > 0 && threads_count > 0, L"Internal error: Entered without a block size or threads!");
+    UHASHTOOLS_ASSERT(blocks_count <= file_size / block_size + (file_size % block_size != 0 ? 1 : 0),
+                      L"Internal error: More blocks than the file has!");
+
+    ctx = (struct HashFileBlocksCtx*) calloc(1, sizeof *ctx);
+    thread_handles = (HANDLE*) calloc(threads_count, sizeof *thread_handles);
+
+    if (!ctx || !thread_handles)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+
+        goto cleanup_and_out;
+    }
+
+    ctx->target_file = target_file;
+    ctx->file_size = file_size;
+    ctx->block_size = block_size;
+    ctx->blocks_count = blocks_count;
+    ctx->block_digest_callback = block_digest_callback;
+    ctx->block_digest_callback_userdata = block_digest_callback_userdata;
+    InitializeCriticalSection(&ctx->blocks_lock);
+
+    /* The threads are started suspended, so a failed start stops all of them before they take a block. */
+    for (thread_index = 0; thread_index < threads_count; ++thread_index)
+    {
+        unsigned int thread_id = 0;
+        const uintptr_t thread_handle = _beginthreadex(NULL,
+                                                       HASH_FILE_BLOCKS_THREAD_STACK_SIZE,
+                                                       uhashtools_hash_file_blocks_thread_function,
+                                                       (void*) ctx,
+                                                       CREATE_SUSPENDED,
+                                                       &thread_id);
+
+        if (thread_handle == 0)
+        {
+            (void) wcscpy_s(ctx->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, L"Failed to start the hashing threads!");
+            ctx->is_failed = TRUE;
+            ctx->is_stopped = TRUE;
+            break;
+        }
+
+        thread_handles[started_threads_count] = (HANDLE) thread_handle;
+        ++started_threads_count;
+    }
+
+    for (thread_index = 0; thread_index < started_threads_count; ++thread_index)
+    {
+        (void) ResumeThread(thread_handles[thread_index]);
+    }
+
+    for (thread_index = 0; thread_index < started_threads_count; ++thread_index)
+    {
+        DWORD wait_rc = WaitForSingleObject(thread_handles[thread_index], INFINITE);
+
+        UHASHTOOLS_ASSERT(wait_rc == WAIT_OBJECT_0, L"Internal error: Failed to wait for a block hashing thread!");
+
+        (void) CloseHandle(thread_handles[thread_index]);
+    }
+
+    DeleteCriticalSection(&ctx->blocks_lock);
+
+    if (ctx->is_failed)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, ctx->error_message_buf);
+    }
+    else if (ctx->is_stopped)
+    {
+        ret = HashCalculatorResultCode_CANCELED;
+    }
+    else
+    {
+        ret = HashCalculatorResultCode_SUCCESS;
+    }
+
+cleanup_and_out:
+    free((void*) thread_handles);
+    free((void*) ctx);
+
+    return ret;
+}
+
+/*
+ * Encodes the digest of a successful calculation into the result string
+ * buffer. On failure the buffer already contains the user error message.
+ */
+static
+enum HashCalculatorResultCode
+uhashtools_digest_result_to_hex
+(
+    enum HashCalculatorResultCode calculation_result_code,
+    const struct HashDigest* result_digest,
+    wchar_t* result_string_buf,
+    size_t result_string_buf_tsize
+)
+{
+    if (calculation_result_code != HashCalculatorResultCode_SUCCESS)
+    {
+        return calculation_result_code;
+    }
+
+    if (!uhashtools_hash_calculator_impl_digest_to_hex(result_digest, result_string_buf, result_string_buf_tsize))
+    {
+        (void) wcscpy_s(result_string_buf,
+                        result_string_buf_tsize,
+                        L"Internal error: Failed to hash the selected file. Encoding the hash result to hex failed!");
+
+        return HashCalculatorResultCode_FAILED;
+    }
+
+    return HashCalculatorResultCode_SUCCESS;
+}
+
+enum HashCalculatorResultCode
+uhashtools_hash_calculator_impl_hash_file_source
+(
+    unsigned char* file_read_buf,
+    size_t file_read_buf_tsize,
+    wchar_t* result_string_buf,
+    size_t result_string_buf_tsize,
+    struct FileSource* opened_file_source,
+    CheckIsCancelRequestedCallbackFunction* check_is_cancel_requested_callback,
+    void* check_is_cancel_requested_callback_userdata,
+    OnProgressCallbackFunction* progress_callback,
+    void* progress_callback_userdata
+)
+{
+    enum HashCalculatorResultCode ret = HashCalculatorResultCode_FAILED;
+    struct HashDigest result_digest;
+
+    UHASHTOOLS_ASSERT(result_string_buf, L"Internal error: result_string_buf is NULL");
+    UHASHTOOLS_ASSERT(result_string_buf_tsize >= 256,
+                      L"Internal error: result_string_buf_tsize is to small. The buffer must fit at minimum 256 elements!");
+
+    ret = uhashtools_hash_calculator_impl_hash_file_source_to_digest(file_read_buf,
+                                                                     file_read_buf_tsize,
+                                                                     &result_digest,
+                                                                     result_string_buf,
+                                                                     result_string_buf_tsize,
+                                                                     opened_file_source,
+                                                                     check_is_cancel_requested_callback,
+                                                                     check_is_cancel_requested_callback_userdata,
+                                                                     progress_callback,
+                                                                     progress_callback_userdata);
+
+    return uhashtools_digest_result_to_hex(ret, &result_digest, result_string_buf, result_string_buf_tsize);
+}
+
+enum HashCalculatorResultCode
+uhashtools_hash_calculator_impl_hash_file
+(
+    unsigned char* file_read_buf,
+    size_t file_read_buf_tsize,
+    wchar_t* result_string_buf,
+    size_t result_string_buf_tsize,
+    const wchar_t* target_file,
+    CheckIsCancelRequestedCallbackFunction* check_is_cancel_requested_callback,
+    void* check_is_cancel_requested_callback_userdata,
+    OnProgressCallbackFunction* progress_callback,
+    void* progress_callback_userdata
+)
+{
+    enum HashCalculatorResultCode ret = HashCalculatorResultCode_FAILED;
+    struct HashDigest result_digest;
+
+    UHASHTOOLS_ASSERT(result_string_buf, L"Internal error: result_string_buf is NULL");
+    UHASHTOOLS_ASSERT(result_string_buf_tsize >= 256,
+                      L"Internal error: result_string_buf_tsize is to small. The buffer must fit at minimum 256 elements!");
+
+    ret = uhashtools_hash_calculator_impl_hash_file_to_digest(file_read_buf,
+                                                              file_read_buf_tsize,
+                                                              &result_digest,
+                                                              result_string_buf,
+                                                              result_string_buf_tsize,
+                                                              target_file,
+                                                              check_is_cancel_requested_callback,
+                                                              check_is_cancel_requested_callback_userdata,
+                                                              progress_callback,
+                                                              progress_callback_userdata);
+
+    return uhashtools_digest_result_to_hex(ret, &result_digest, result_string_buf, result_string_buf_tsize);
+}
+
+BOOL
+uhashtools_hash_calculator_impl_digest_to_hex
+(
+    const struct HashDigest* digest,
+    wchar_t* out_buf,
+    size_t out_buf_tsize
+)
+{
+    UHASHTOOLS_ASSERT(digest, L"Internal error: digest is NULL");
+    UHASHTOOLS_ASSERT(out_buf, L"Internal error: out_buf is NULL");
+
+    return uhashtools_encode_bytes_to_hex(digest->bytes,
+                                          digest->size,
+                                          out_buf,
+                                          out_buf_tsize);
 }
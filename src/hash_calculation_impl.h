@@ -9,11 +9,28 @@
 #pragma once
 
 #include "buffer_sizes.h"
+#include "file_source.h"
 
 #include <Windows.h>
 
+/**
+ * Progress information of a running hash calculation.
+ */
+struct HashCalculationProgress
+{
+	/**
+	 * FALSE if the size of the target isn't known in advance (for
+	 * example if the data is read from a pipe). In this case only
+	 * "processed_bytes" and "bytes_per_second" are meaningful.
+	 */
+	BOOL is_size_known;
+	unsigned int progress_in_percent;
+	unsigned __int64 processed_bytes;
+	unsigned __int64 bytes_per_second;
+};
+
 typedef BOOL CheckIsCancelRequestedCallbackFunction(void* userdata);
-typedef void OnProgressCallbackFunction(unsigned int current_calculation_progress, void* userdata);
+typedef void OnProgressCallbackFunction(const struct HashCalculationProgress* current_calculation_progress, void* userdata);
 
 enum HashCalculatorResultCode
 {
@@ -22,6 +39,272 @@ enum HashCalculatorResultCode
 	HashCalculatorResultCode_FAILED
 };
 
+/* Size of the biggest digest of all products (SHA-512, BLAKE2b and SHA3-512). */
+#define HASH_DIGEST_MAX_SIZE 64
+
+/**
+ * Raw digest of a hash calculation. The digest is only encoded to hex
+ * when it's displayed, so the results can be passed around without
+ * carrying a string buffer with them.
+ */
+struct HashDigest
+{
+	unsigned int size;
+	unsigned char bytes[HASH_DIGEST_MAX_SIZE];
+};
+
+/**
+ * Hashes a file and writes the raw digest into "result_digest". If the
+ * calculation fails or gets canceled, the user error message is written
+ * into "error_message_buf" instead.
+ */
+extern
+enum HashCalculatorResultCode
+uhashtools_hash_calculator_impl_hash_file_to_digest
+(
+	unsigned char* file_read_buf,
+	size_t file_read_buf_tsize,
+	struct HashDigest* result_digest,
+	wchar_t* error_message_buf,
+	size_t error_message_buf_tsize,
+	const wchar_t* target_file,
+	CheckIsCancelRequestedCallbackFunction* check_is_cancel_requested_callback,
+	void* check_is_cancel_requested_callback_userdata,
+	OnProgressCallbackFunction* progress_callback,
+	void* progress_callback_userdata
+);
+
+/**
+ * Like "uhashtools_hash_calculator_impl_hash_file_to_digest()" but for
+ * an already opened file source. The file source is not closed by this
+ * function.
+ */
+extern
+enum HashCalculatorResultCode
+uhashtools_hash_calculator_impl_hash_file_source_to_digest
+(
+	unsigned char* file_read_buf,
+	size_t file_read_buf_tsize,
+	struct HashDigest* result_digest,
+	wchar_t* error_message_buf,
+	size_t error_message_buf_tsize,
+	struct FileSource* opened_file_source,
+	CheckIsCancelRequestedCallbackFunction* check_is_cancel_requested_callback,
+	void* check_is_cancel_requested_callback_userdata,
+	OnProgressCallbackFunction* progress_callback,
+	void* progress_callback_userdata
+);
+
+/**
+ * Hasher which keeps the algorithm provider of the Windows CNG API (or the
+ * state of the built-in hasher) between calculations. Threads which hash
+ * many files one after another prepare a single hasher instead of opening
+ * the algorithm provider for every file. A prepared hasher must only be
+ * used by one thread at a time.
+ */
+struct PreparedHasher;
+
+/**
+ * Prepares a hasher for "uhashtools_hash_calculator_impl_hash_file_source_with_hasher_to_digest()".
+ * 
+ * @param error_message_buf Buffer which receives the user error message if
+ *                          the hasher can't be prepared.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * 
+ * @return Prepared hasher or NULL on error. Must be freed with
+ *         "uhashtools_hash_calculator_impl_destroy_hasher()".
+ */
+extern
+struct PreparedHasher*
+uhashtools_hash_calculator_impl_prepare_hasher
+(
+	wchar_t* error_message_buf,
+	size_t error_message_buf_tsize
+);
+
+/**
+ * Frees a prepared hasher. Passing NULL is allowed.
+ */
+extern
+void
+uhashtools_hash_calculator_impl_destroy_hasher
+(
+	struct PreparedHasher* prepared_hasher
+);
+
+/**
+ * Like "uhashtools_hash_calculator_impl_hash_file_source_to_digest()" but
+ * the calculation uses the given prepared hasher, which is reset before.
+ */
+extern
+enum HashCalculatorResultCode
+uhashtools_hash_calculator_impl_hash_file_source_with_hasher_to_digest
+(
+	struct PreparedHasher* prepared_hasher,
+	unsigned char* file_read_buf,
+	size_t file_read_buf_tsize,
+	struct HashDigest* result_digest,
+	wchar_t* error_message_buf,
+	size_t error_message_buf_tsize,
+	struct FileSource* opened_file_source,
+	CheckIsCancelRequestedCallbackFunction* check_is_cancel_requested_callback,
+	void* check_is_cancel_requested_callback_userdata,
+	OnProgressCallbackFunction* progress_callback,
+	void* progress_callback_userdata
+);
+
+/**
+ * Hashes a buffer in memory with the hash algorithm of the product.
+ * 
+ * @param data Data which should be hashed.
+ * @param data_size Size of "data" in bytes.
+ * @param result_digest Receives the digest.
+ * @param error_message_buf Buffer which receives the user error message if
+ *                          the calculation fails.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * 
+ * @return TRUE on success and FALSE on failure.
+ */
+extern
+BOOL
+uhashtools_hash_calculator_impl_hash_buffer_to_digest
+(
+	const unsigned char* data,
+	size_t data_size,
+	struct HashDigest* result_digest,
+	wchar_t* error_message_buf,
+	size_t error_message_buf_tsize
+);
+
+/**
+ * Intermediate state of the built-in hasher after the first "hashed_size"
+ * bytes of a file. The states of the built-in hashers don't contain any
+ * pointers, so the state can be stored in a file and restored by a later
+ * run of the same product (see "incremental_state.h"). The default
+ * initialisation is to do a memset zero, which is the state before the
+ * first byte.
+ */
+struct HashResumeState
+{
+	unsigned __int64 hashed_size;
+
+	/* NULL or "uhashtools_product_get_builtin_hasher_state_size()" bytes */
+	void* hasher_state;
+};
+
+/**
+ * Continues a hash calculation at the end of "resume_state" and writes
+ * the raw digest into "result_digest". The file source has to provide
+ * the data which follows the already hashed part, the digest is the
+ * same as if the whole file had been hashed at once. The built-in
+ * hasher is always used, since the Windows CNG API can't export the
+ * state of a hash calculation.
+ * 
+ * @param resume_state State from which the calculation continues. On
+ *                     success it receives the state after the last byte
+ *                     of the file source, else it's left unchanged.
+ * 
+ * See "uhashtools_hash_calculator_impl_hash_file_to_digest()" for the
+ * other parameters.
+ */
+extern
+enum HashCalculatorResultCode
+uhashtools_hash_calculator_impl_resume_file_source_to_digest
+(
+	unsigned char* file_read_buf,
+	size_t file_read_buf_tsize,
+	struct HashDigest* result_digest,
+	wchar_t* error_message_buf,
+	size_t error_message_buf_tsize,
+	struct FileSource* opened_file_source,
+	struct HashResumeState* resume_state
+);
+
+/**
+ * Frees the hasher state and resets "resume_state" to the state before
+ * the first byte.
+ */
+extern
+void
+uhashtools_hash_calculator_impl_free_resume_state
+(
+	struct HashResumeState* resume_state
+);
+
+/**
+ * Receives the digest of a block from
+ * "uhashtools_hash_calculator_impl_hash_file_blocks_to_digests()". The
+ * calls come from the worker threads but are serialized, so the
+ * callback doesn't need any locking of its own.
+ * 
+ * @return TRUE to continue and FALSE to stop hashing the remaining blocks.
+ */
+typedef BOOL OnBlockDigestCallbackFunction(unsigned __int64 block_index, const struct HashDigest* digest, void* userdata);
+
+/**
+ * Hashes the blocks of a file in parallel. Block "i" is the range
+ * starting at "i * block_size" with "block_size" bytes, only the last
+ * block of the file may be shorter. Every worker thread opens the file
+ * and prepares a hasher once and hashes each block it takes with them,
+ * the hasher is reset between the blocks. The blocks are independent
+ * from each other and are finished in no particular order.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if
+ *                          the calculation fails.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param target_file File whose blocks should be hashed.
+ * @param file_size Size of the file in bytes when the blocks have been
+ *                  planned. If a block is shorter than expected, the
+ *                  calculation fails.
+ * @param block_size Size of a block in bytes.
+ * @param blocks_count Amount of blocks from the beginning of the file
+ *                     which should be hashed.
+ * @param threads_count Amount of worker threads.
+ * @param block_digest_callback Receives the digest of every block.
+ * 
+ * @return HashCalculatorResultCode_SUCCESS if all blocks have been hashed,
+ *         HashCalculatorResultCode_CANCELED if the callback stopped the
+ *         calculation or HashCalculatorResultCode_FAILED on failure.
+ */
+extern
+enum HashCalculatorResultCode
+uhashtools_hash_calculator_impl_hash_file_blocks_to_digests
+(
+	wchar_t* error_message_buf,
+	size_t error_message_buf_tsize,
+	const wchar_t* target_file,
+	unsigned __int64 file_size,
+	unsigned __int64 block_size,
+	unsigned __int64 blocks_count,
+	unsigned int threads_count,
+	OnBlockDigestCallbackFunction* block_digest_callback,
+	void* block_digest_callback_userdata
+);
+
+/**
+ * Encodes a digest as lower case hex string.
+ * 
+ * @param digest Digest which should be encoded.
+ * @param out_buf Buffer which receives the zero terminated hex string.
+ * @param out_buf_tsize Size of "out_buf" in wide characters. Must fit
+ *                      two characters per digest byte and the terminator.
+ * 
+ * @return TRUE on success and FALSE if "out_buf" is too small.
+ */
+extern
+BOOL
+uhashtools_hash_calculator_impl_digest_to_hex
+(
+	const struct HashDigest* digest,
+	wchar_t* out_buf,
+	size_t out_buf_tsize
+);
+
+/**
+ * Hashes a file and writes the hex encoded digest into "result_string_buf".
+ * If the calculation fails or gets canceled, the buffer receives the user
+ * error message instead.
+ */
 extern
 enum HashCalculatorResultCode
 uhashtools_hash_calculator_impl_hash_file
@@ -36,3 +319,22 @@ uhashtools_hash_calculator_impl_hash_file
 	OnProgressCallbackFunction* progress_callback,
 	void* progress_callback_userdata
 );
+
+/**
+ * Hashes the remaining data of an already opened file source. The
+ * file source is not closed by this function.
+ */
+extern
+enum HashCalculatorResultCode
+uhashtools_hash_calculator_impl_hash_file_source
+(
+	unsigned char* file_read_buf,
+	size_t file_read_buf_tsize,
+	wchar_t* result_string_buf,
+	size_t result_string_buf_tsize,
+	struct FileSource* opened_file_source,
+	CheckIsCancelRequestedCallbackFunction* check_is_cancel_requested_callback,
+	void* check_is_cancel_requested_callback_userdata,
+	OnProgressCallbackFunction* progress_callback,
+	void* progress_callback_userdata
+);
@@ -34,9 +34,11 @@ uhashtools_process_thread_messages
     UHASHTOOLS_ASSERT(received_thread_messages,
                       L"Internal error: Entered with received_thread_messages == NULL!");
 
-    while (PeekMessageW(&peeked_msg, (HWND) -1, WM_USER, WM_USER, PM_REMOVE))
+    /* Only the cancel requests are removed, queued jobs stay in the message queue. */
+    while (PeekMessageW(&peeked_msg, (HWND) -1, HCW_CANCEL_REQUEST_MESSAGE_ID, HCW_CANCEL_REQUEST_MESSAGE_ID, PM_REMOVE))
     {
-        if (peeked_msg.wParam == (WPARAM) HCWRC_CANCEL_HASH_CALCULATION)
+        if (peeked_msg.wParam == (WPARAM) HCWRC_CANCEL_HASH_CALCULATION &&
+            (unsigned int) peeked_msg.lParam == received_thread_messages->current_job_id)
         {
             received_thread_messages->cancel_requested = TRUE;
         }
@@ -69,7 +71,7 @@ static
 void
 uhashtools_on_progress_callback
 (
-    unsigned int current_calculation_progress,
+    const struct HashCalculationProgress* current_calculation_progress,
     void* userdata
 )
 {
@@ -111,78 +113,116 @@ uhashtools_thread_message_queue_init
 }
 
 static
-unsigned int
-__stdcall
-uhashtools_hash_calculation_worker_thread_function
+void
+uhashtools_hash_calculation_worker_process_job
 (
-    void* thread_param
+    struct HashCalculationWorkerCtx* worker_ctx,
+    const struct HashCalculationWorkerJob* job
 )
 {
-    struct HashCalculationWorkerCtx* worker_ctx = NULL;
-    const struct HashCalculationWorkerParam* hash_calc_worker_param = NULL;
+    const struct OutgoingEventMessageTarget* event_message_target = &worker_ctx->event_message_target;
     enum HashCalculatorResultCode calculation_result_code = HashCalculatorResultCode_FAILED;
 
-    UHASHTOOLS_ASSERT(thread_param, L"Internal error: Entered with thread_param == NULL!");
-
-    worker_ctx = (struct HashCalculationWorkerCtx*) calloc(1, sizeof *worker_ctx);
-    UHASHTOOLS_ASSERT(worker_ctx, L"Out of memory error: Failed to allocate memory for the hash calculation worker context data!");
-
-    hash_calc_worker_param = (const struct HashCalculationWorkerParam*) thread_param;
+    worker_ctx->received_thread_messages.current_job_id = job->job_id;
+    worker_ctx->received_thread_messages.cancel_requested = FALSE;
 
-    uhashtools_hash_calculation_worker_ctx_init(worker_ctx, hash_calc_worker_param);
-    uhashtools_thread_message_queue_init();
     uhashtools_hash_calculation_worker_com_send_worker_initialized_message(&worker_ctx->event_message_buf,
-                                                                           hash_calc_worker_param->event_message_receiver,
-                                                                           hash_calc_worker_param->event_message_buf,
-                                                                           hash_calc_worker_param->event_message_buf_is_writeable_event);
-
-    calculation_result_code = uhashtools_hash_calculator_impl_hash_file(worker_ctx->file_read_buf,
-                                                                        worker_ctx->file_read_buf_tsize,
-                                                                        worker_ctx->calculation_result_string,
-                                                                        worker_ctx->calculation_result_string_tsize,
-                                                                        hash_calc_worker_param->target_file,
-                                                                        &uhashtools_check_is_cancel_requests_callback,
-                                                                        &worker_ctx->received_thread_messages,
-                                                                        &uhashtools_on_progress_callback,
-                                                                        &worker_ctx->on_progress_cb_args);
+                                                                           event_message_target->event_message_receiver,
+                                                                           event_message_target->receiver_event_message_buf,
+                                                                           event_message_target->receiver_event_message_buf_is_writeable_event);
+
+    calculation_result_code = uhashtools_hash_calculator_impl_hash_file_to_digest(worker_ctx->file_read_buf,
+                                                                                  worker_ctx->file_read_buf_tsize,
+                                                                                  &worker_ctx->calculation_result_digest,
+                                                                                  worker_ctx->calculation_error_message,
+                                                                                  worker_ctx->calculation_error_message_tsize,
+                                                                                  job->target_file,
+                                                                                  &uhashtools_check_is_cancel_requests_callback,
+                                                                                  &worker_ctx->received_thread_messages,
+                                                                                  &uhashtools_on_progress_callback,
+                                                                                  &worker_ctx->on_progress_cb_args);
 
     switch (calculation_result_code)
     {
         case HashCalculatorResultCode_SUCCESS:
         {
             uhashtools_hash_calculation_worker_com_send_calculation_complete_message(&worker_ctx->event_message_buf,
-                                                                                     hash_calc_worker_param->event_message_receiver,
-                                                                                     hash_calc_worker_param->event_message_buf,
-                                                                                     hash_calc_worker_param->event_message_buf_is_writeable_event,
-                                                                                     worker_ctx->calculation_result_string);
+                                                                                     event_message_target->event_message_receiver,
+                                                                                     event_message_target->receiver_event_message_buf,
+                                                                                     event_message_target->receiver_event_message_buf_is_writeable_event,
+                                                                                     &worker_ctx->calculation_result_digest);
         } break;
         case HashCalculatorResultCode_CANCELED:
         {
             uhashtools_hash_calculation_worker_com_send_worker_canceled_message(&worker_ctx->event_message_buf,
-                                                                                hash_calc_worker_param->event_message_receiver,
-                                                                                hash_calc_worker_param->event_message_buf,
-                                                                                hash_calc_worker_param->event_message_buf_is_writeable_event);
+                                                                                event_message_target->event_message_receiver,
+                                                                                event_message_target->receiver_event_message_buf,
+                                                                                event_message_target->receiver_event_message_buf_is_writeable_event);
         } break;
         case HashCalculatorResultCode_FAILED:
         {
             uhashtools_hash_calculation_worker_com_send_calculation_failed_message(&worker_ctx->event_message_buf,
-                                                                                   hash_calc_worker_param->event_message_receiver,
-                                                                                   hash_calc_worker_param->event_message_buf,
-                                                                                   hash_calc_worker_param->event_message_buf_is_writeable_event,
-                                                                                   worker_ctx->calculation_result_string);
+                                                                                   event_message_target->event_message_receiver,
+                                                                                   event_message_target->receiver_event_message_buf,
+                                                                                   event_message_target->receiver_event_message_buf_is_writeable_event,
+                                                                                   worker_ctx->calculation_error_message);
         } break;
         default:
         {
             UHASHTOOLS_FATAL_ERROR(L"Internal error: calculation_result_code has an unexpected value!");
         }
     }
+}
+
+static
+unsigned int
+__stdcall
+uhashtools_hash_calculation_worker_thread_function
+(
+    void* thread_param
+)
+{
+    struct HashCalculationWorkerCtx* worker_ctx = NULL;
+    const struct HashCalculationWorkerParam* hash_calc_worker_param = NULL;
+    MSG received_msg;
+
+    UHASHTOOLS_ASSERT(thread_param, L"Internal error: Entered with thread_param == NULL!");
+
+    worker_ctx = (struct HashCalculationWorkerCtx*) calloc(1, sizeof *worker_ctx);
+    UHASHTOOLS_ASSERT(worker_ctx, L"Out of memory error: Failed to allocate memory for the hash calculation worker context data!");
+
+    hash_calc_worker_param = (const struct HashCalculationWorkerParam*) thread_param;
+
+    uhashtools_hash_calculation_worker_ctx_init(worker_ctx, hash_calc_worker_param);
+    uhashtools_thread_message_queue_init();
+
+    /* From now on jobs can be posted into the thread message queue. */
+    (void) SetEvent(hash_calc_worker_param->worker_ready_event);
 
-    if (worker_ctx)
+    /*
+     * Cancel requests which are received between the jobs are belonging to
+     * already finished jobs and are ignored.
+     */
+    while (GetMessageW(&received_msg, (HWND) -1, HCW_CANCEL_REQUEST_MESSAGE_ID, HCW_JOB_REQUEST_MESSAGE_ID) > 0)
     {
-        free(worker_ctx);
-        worker_ctx = NULL;
+        struct HashCalculationWorkerJob* job = NULL;
+
+        if (received_msg.message != HCW_JOB_REQUEST_MESSAGE_ID ||
+            received_msg.wParam != (WPARAM) HCWRC_START_HASH_CALCULATION)
+        {
+            continue;
+        }
+
+        job = (struct HashCalculationWorkerJob*) received_msg.lParam;
+        UHASHTOOLS_ASSERT(job, L"Internal error: Received job request without a job!");
+
+        uhashtools_hash_calculation_worker_process_job(worker_ctx, job);
+
+        free((void*) job);
     }
 
+    free(worker_ctx);
+
     return 0;
 }
 
@@ -192,23 +232,29 @@ uhashtools_hash_calculation_worker_start
     struct HashCalculationWorkerParam* worker_param_buf,
     struct HashCalculationWorkerEventMessage* event_message_buf,
     HANDLE event_message_buf_is_writeable_event,
-    HWND event_message_receiver,
-    const wchar_t* target_file
+    HWND event_message_receiver
 )
 {
     struct HashCalculationWorkerInstanceData return_value;
-    BOOL created_successfully = FALSE;
+    HANDLE worker_ready_event = NULL;
     uintptr_t thread_handle = 0;
     unsigned int thread_id = 0;
+    DWORD wait_rc = 0;
 
-    return_value.created_successfully = created_successfully;
-    return_value.thread_handle = (HANDLE) thread_handle;
-    return_value.thread_id = (DWORD) thread_id;
+    (void) memset((void*) &return_value, 0, sizeof return_value);
+    return_value.created_successfully = FALSE;
+
+    worker_ready_event = CreateEventW(NULL, TRUE, FALSE, NULL);
+
+    if (!worker_ready_event)
+    {
+        return return_value;
+    }
 
     worker_param_buf->event_message_buf = event_message_buf;
     worker_param_buf->event_message_buf_is_writeable_event = event_message_buf_is_writeable_event;
     worker_param_buf->event_message_receiver = event_message_receiver;
-    worker_param_buf->target_file = target_file;
+    worker_param_buf->worker_ready_event = worker_ready_event;
 
     thread_handle = _beginthreadex(NULL,
                                    WORKER_THREAD_STACK_SIZE,
@@ -219,23 +265,72 @@ uhashtools_hash_calculation_worker_start
 
     if (thread_handle == 0)
     {
+        (void) CloseHandle(worker_ready_event);
         return return_value;
     }
 
-    created_successfully = TRUE;
+    /*
+     * Posting a thread message fails as long the thread message queue of the
+     * worker doesn't exist, so we're waiting until the worker is ready.
+     */
+    wait_rc = WaitForSingleObject(worker_ready_event, INFINITE);
+    UHASHTOOLS_ASSERT(wait_rc == WAIT_OBJECT_0, L"Internal error: Failed to wait for the hash calculation worker thread!");
+
+    (void) CloseHandle(worker_ready_event);
+    worker_param_buf->worker_ready_event = NULL;
 
-    return_value.created_successfully = created_successfully;
+    return_value.created_successfully = TRUE;
     return_value.thread_handle = (HANDLE) thread_handle;
     return_value.thread_id = (DWORD) thread_id;
 
     return return_value;
 }
 
+BOOL
+uhashtools_hash_calculation_worker_submit_job
+(
+    struct HashCalculationWorkerInstanceData* worker_instance_data,
+    const wchar_t* target_file
+)
+{
+    struct HashCalculationWorkerJob* job = NULL;
+    unsigned int job_id = 0;
+
+    UHASHTOOLS_ASSERT(worker_instance_data && worker_instance_data->created_successfully,
+                      L"Internal error: Entered with worker_instance_data == NULL or a worker which isn't running!");
+    UHASHTOOLS_ASSERT(target_file, L"Internal error: Entered with target_file == NULL!");
+
+    job = (struct HashCalculationWorkerJob*) calloc(1, sizeof *job);
+
+    if (!job)
+    {
+        return FALSE;
+    }
+
+    job_id = worker_instance_data->current_job_id + 1;
+    job->job_id = job_id;
+    (void) wcscpy_s(job->target_file, FILEPATH_BUFFER_TSIZE, target_file);
+
+    if (!uhashtools_hash_calculation_worker_com_send_job_request(worker_instance_data->thread_id, job))
+    {
+        free((void*) job);
+        return FALSE;
+    }
+
+    /* The job may already be processed and freed by the worker at this point. */
+    worker_instance_data->current_job_id = job_id;
+
+    return TRUE;
+}
+
 void
 uhashtools_hash_calculation_worker_request_cancellation
 (
-    DWORD worker_thread_id
+    const struct HashCalculationWorkerInstanceData* worker_instance_data
 )
 {
-    uhashtools_hash_calculation_worker_com_send_cancel_request(worker_thread_id);
+    UHASHTOOLS_ASSERT(worker_instance_data, L"Internal error: Entered with worker_instance_data == NULL!");
+
+    uhashtools_hash_calculation_worker_com_send_cancel_request(worker_instance_data->thread_id,
+                                                               worker_instance_data->current_job_id);
 }
@@ -13,12 +13,22 @@
 
 #include <Windows.h>
 
+/*
+ * The hash calculation worker is a long-living thread which processes
+ * the submitted hash calculation jobs one after another. Its context
+ * data (including the file read buffer) is allocated once, so starting
+ * a job doesn't require creating a thread or allocating memory besides
+ * the job itself.
+ */
+
 struct HashCalculationWorkerParam
 {
     struct HashCalculationWorkerEventMessage* event_message_buf;
     HANDLE event_message_buf_is_writeable_event;
     HWND event_message_receiver;
-    const wchar_t* target_file;
+
+    /* Signalled by the worker as soon it can receive jobs. */
+    HANDLE worker_ready_event;
 };
 
 struct HashCalculationWorkerInstanceData
@@ -26,8 +36,23 @@ struct HashCalculationWorkerInstanceData
     BOOL created_successfully;
     HANDLE thread_handle;
     DWORD thread_id;
+    unsigned int current_job_id;
 };
 
+/**
+ * Starts the hash calculation worker thread. The worker thread runs until
+ * the process exits.
+ * 
+ * @param worker_param_buf Buffer for the start parameters of the worker. Must be
+ *                         valid as long the worker thread is running.
+ * @param event_message_buf Buffer which receives the event messages of the worker.
+ * @param event_message_buf_is_writeable_event Signals if the worker can write into
+ *                                             the "event_message_buf" buffer.
+ * @param event_message_receiver Window which receives the event messages.
+ * 
+ * @return Instance data of the started worker. The field "created_successfully"
+ *         is FALSE if the worker couldn't be started.
+ */
 extern
 struct HashCalculationWorkerInstanceData
 uhashtools_hash_calculation_worker_start
@@ -35,18 +60,35 @@ uhashtools_hash_calculation_worker_start
     struct HashCalculationWorkerParam* worker_param_buf,
     struct HashCalculationWorkerEventMessage* event_message_buf,
     HANDLE event_message_buf_is_writeable_event,
-    HWND event_message_receiver,
+    HWND event_message_receiver
+);
+
+/**
+ * Queues a hash calculation job for the given worker. The worker reports
+ * the progress and the result of the job with its event messages.
+ * 
+ * @param worker_instance_data Instance data of the started worker. The field
+ *                             "current_job_id" is set to the ID of the job.
+ * @param target_file Filepath of the file which should be hashed.
+ * 
+ * @return TRUE if the job has been queued and FALSE on error.
+ */
+extern
+BOOL
+uhashtools_hash_calculation_worker_submit_job
+(
+    struct HashCalculationWorkerInstanceData* worker_instance_data,
     const wchar_t* target_file
 );
 
 /**
- * Sends a cancellation request to the given worker thread.
+ * Sends a cancellation request for the current job to the given worker.
  * 
- * @param worker_thread_id Thread id of the hash calculation worker.
+ * @param worker_instance_data Instance data of the started worker.
  */
 extern
 void
 uhashtools_hash_calculation_worker_request_cancellation
 (
-    DWORD worker_thread_id
+    const struct HashCalculationWorkerInstanceData* worker_instance_data
 );
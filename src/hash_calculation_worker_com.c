@@ -11,6 +11,7 @@
 #include "error_utilities.h"
 #include "print_utilities.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 static
@@ -40,22 +41,19 @@ uhashtools_send_event_message
 }
 
 static
-void
+BOOL
 uhashtools_send_request_code_to_thread
 (
     DWORD receiver_thread_id,
-    enum HashCalculationWorkerRequestCodes request_code
+    UINT message_id,
+    enum HashCalculationWorkerRequestCodes request_code,
+    LPARAM request_data
 )
 {
-    BOOL post_thread_message_success = FALSE;
-
-    post_thread_message_success = PostThreadMessageW(receiver_thread_id,
-                                                    WM_USER,
-                                                    (WPARAM) request_code,
-                                                    0);
-    
-    UHASHTOOLS_ASSERT(post_thread_message_success,
-                      L"Failed to send the event message with PostThreadMessageW()!");
+    return PostThreadMessageW(receiver_thread_id,
+                              message_id,
+                              (WPARAM) request_code,
+                              request_data);
 }
 
 void
@@ -127,7 +125,7 @@ uhashtools_hash_calculation_worker_com_send_calculation_complete_message
     HWND event_message_receiver,
     struct HashCalculationWorkerEventMessage* receiver_event_message_buf,
     HANDLE receiver_event_message_buf_is_writeable_event,
-    const wchar_t* calculated_hash
+    const struct HashDigest* calculated_digest
 )
 {
     UHASHTOOLS_ASSERT(sender_event_message_buf,
@@ -139,18 +137,15 @@ uhashtools_hash_calculation_worker_com_send_calculation_complete_message
     UHASHTOOLS_ASSERT(receiver_event_message_buf_is_writeable_event &&
                       receiver_event_message_buf_is_writeable_event != INVALID_HANDLE_VALUE,
                       L"Internal error: Entered with empty or invalid 'receiver_event_message_buf_is_writeable_event' handle!");
-    UHASHTOOLS_ASSERT(calculated_hash, L"Internal error: Entered with calculated_hash == NULL!")
+    UHASHTOOLS_ASSERT(calculated_digest, L"Internal error: Entered with calculated_digest == NULL!")
 
     (void) memset((void*) sender_event_message_buf, 0, sizeof *sender_event_message_buf);
 
-    UHASHTOOLS_PRINTF_LINE_DEBUG(L"Sending calculated complete message with content \"%s\".",
-                                 calculated_hash);
+    UHASHTOOLS_PRINTF_LINE_DEBUG(L"Sending calculated complete message with a digest of %u bytes.",
+                                 calculated_digest->size);
 
     sender_event_message_buf->event_type = HCWET_CALCULATION_COMPLETE;
-
-    (void) wcscpy_s(sender_event_message_buf->event_data.operation_finished_data.calculated_hash,
-                    HASH_RESULT_BUFFER_TSIZE,
-                    calculated_hash);
+    sender_event_message_buf->event_data.operation_finished_data.calculated_digest = *calculated_digest;
 
     uhashtools_send_event_message(event_message_receiver,
                                   sender_event_message_buf,
@@ -177,6 +172,7 @@ uhashtools_hash_calculation_worker_com_send_calculation_failed_message
     UHASHTOOLS_ASSERT(receiver_event_message_buf_is_writeable_event &&
                       receiver_event_message_buf_is_writeable_event != INVALID_HANDLE_VALUE,
                       L"Internal error: Entered with empty or invalid 'receiver_event_message_buf_is_writeable_event' handle!");
+    UHASHTOOLS_ASSERT(user_error_message, L"Internal error: Entered with user_error_message == NULL!");
 
     (void) memset((void*) sender_event_message_buf, 0, sizeof *sender_event_message_buf);
 
@@ -184,9 +180,9 @@ uhashtools_hash_calculation_worker_com_send_calculation_failed_message
                                  user_error_message);
 
     sender_event_message_buf->event_type = HCWET_CALCULATION_FAILED;
-    (void) wcscpy_s(sender_event_message_buf->event_data.operation_failed_data.user_error_message,
-                    GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
-                    user_error_message);
+    sender_event_message_buf->event_data.operation_failed_data.user_error_message = _wcsdup(user_error_message);
+    UHASHTOOLS_ASSERT(sender_event_message_buf->event_data.operation_failed_data.user_error_message,
+                      L"Out of memory error: Failed to allocate memory for the user error message!");
 
     uhashtools_send_event_message(event_message_receiver,
                                   sender_event_message_buf,
@@ -201,7 +197,7 @@ uhashtools_hash_calculation_worker_com_send_calculation_progress_message
     HWND event_message_receiver,
     struct HashCalculationWorkerEventMessage* receiver_event_message_buf,
     HANDLE receiver_event_message_buf_is_writeable_event,
-    unsigned int current_calculation_progress
+    const struct HashCalculationProgress* current_calculation_progress
 )
 {
     UHASHTOOLS_ASSERT(sender_event_message_buf,
@@ -213,14 +209,20 @@ uhashtools_hash_calculation_worker_com_send_calculation_progress_message
     UHASHTOOLS_ASSERT(receiver_event_message_buf_is_writeable_event &&
                       receiver_event_message_buf_is_writeable_event != INVALID_HANDLE_VALUE,
                       L"Internal error: Entered with empty or invalid 'receiver_event_message_buf_is_writeable_event' handle!");
+    UHASHTOOLS_ASSERT(current_calculation_progress,
+                      L"Internal error: Entered with current_calculation_progress == NULL!");
 
     (void) memset((void*) sender_event_message_buf, 0, sizeof *sender_event_message_buf);
 
-    UHASHTOOLS_PRINTF_LINE_DEBUG(L"Sending calculated progress message with content \"%u\".",
-                                 current_calculation_progress);
+    UHASHTOOLS_PRINTF_LINE_DEBUG(L"Sending calculated progress message with content \"%u\" (\"%I64u\" bytes processed).",
+                                 current_calculation_progress->progress_in_percent,
+                                 current_calculation_progress->processed_bytes);
 
     sender_event_message_buf->event_type = HCWET_CALCULATION_PROGRESS_CHANGED;
-    sender_event_message_buf->event_data.progress_changed_data.current_progress_in_percent = current_calculation_progress;
+    sender_event_message_buf->event_data.progress_changed_data.is_size_known = current_calculation_progress->is_size_known;
+    sender_event_message_buf->event_data.progress_changed_data.current_progress_in_percent = current_calculation_progress->progress_in_percent;
+    sender_event_message_buf->event_data.progress_changed_data.processed_bytes = current_calculation_progress->processed_bytes;
+    sender_event_message_buf->event_data.progress_changed_data.bytes_per_second = current_calculation_progress->bytes_per_second;
 
     uhashtools_send_event_message(event_message_receiver,
                                   sender_event_message_buf,
@@ -231,8 +233,32 @@ uhashtools_hash_calculation_worker_com_send_calculation_progress_message
 void
 uhashtools_hash_calculation_worker_com_send_cancel_request
 (
-    DWORD receiver_thread_id
+    DWORD receiver_thread_id,
+    unsigned int job_id
+)
+{
+    BOOL post_thread_message_success = FALSE;
+
+    post_thread_message_success = uhashtools_send_request_code_to_thread(receiver_thread_id,
+                                                                         HCW_CANCEL_REQUEST_MESSAGE_ID,
+                                                                         HCWRC_CANCEL_HASH_CALCULATION,
+                                                                         (LPARAM) job_id);
+
+    UHASHTOOLS_ASSERT(post_thread_message_success,
+                      L"Failed to send the event message with PostThreadMessageW()!");
+}
+
+BOOL
+uhashtools_hash_calculation_worker_com_send_job_request
+(
+    DWORD receiver_thread_id,
+    struct HashCalculationWorkerJob* job
 )
 {
-    uhashtools_send_request_code_to_thread(receiver_thread_id, HCWRC_CANCEL_HASH_CALCULATION);
+    UHASHTOOLS_ASSERT(job, L"Internal error: Entered with job == NULL!");
+
+    return uhashtools_send_request_code_to_thread(receiver_thread_id,
+                                                  HCW_JOB_REQUEST_MESSAGE_ID,
+                                                  HCWRC_START_HASH_CALCULATION,
+                                                  (LPARAM) job);
 }
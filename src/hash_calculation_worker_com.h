@@ -9,6 +9,7 @@
 #pragma once
 
 #include "buffer_sizes.h"
+#include "hash_calculation_impl.h"
 
 #include <Windows.h>
 
@@ -29,17 +30,29 @@ enum HashCalculationWorkerEventType
 
 struct HashCalculationWorkerProgressChangedEventData
 {
+    BOOL is_size_known;
     unsigned int current_progress_in_percent;
+    unsigned __int64 processed_bytes;
+    unsigned __int64 bytes_per_second;
 };
 
+/*
+ * The event data is kept small since every event message is copied into
+ * the shared receiver buffer. The digest is transmitted as raw bytes and
+ * is only encoded to hex by the GUI thread.
+ */
 struct HashCalculationWorkerCompletedEventData
 {
-    wchar_t calculated_hash[HASH_RESULT_BUFFER_TSIZE];
+    struct HashDigest calculated_digest;
 };
 
 struct HashCalculationWorkerFailedEventData
 {
-    wchar_t user_error_message[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    /*
+     * Allocated by the worker thread and owned by the receiver of the
+     * event message, which must free it after the message has been shown.
+     */
+    wchar_t* user_error_message;
 };
 
 struct HashCalculationWorkerEventMessage
@@ -54,6 +67,13 @@ struct HashCalculationWorkerEventMessage
     
 };
 
+/*
+ * Every event message is copied into the receiver buffer and read by the
+ * GUI thread, so it has to stay within two cache lines of 64 bytes. The
+ * biggest event data is the digest of the complete event.
+ */
+C_ASSERT(sizeof(struct HashCalculationWorkerEventMessage) <= 64 * 2);
+
 /*
  * Enumerations and structures for transmitting requests from the
  * GUI thread to the hash calculation worker thread.
@@ -61,7 +81,28 @@ struct HashCalculationWorkerEventMessage
 
 enum HashCalculationWorkerRequestCodes
 {
-    HCWRC_CANCEL_HASH_CALCULATION
+    HCWRC_CANCEL_HASH_CALCULATION,
+    HCWRC_START_HASH_CALCULATION
+};
+
+/*
+ * The requests are sent as thread messages. Cancel requests and job
+ * requests are using different message IDs, so the worker can look
+ * for cancel requests of the current job without removing the queued
+ * jobs from its message queue.
+ */
+#define HCW_CANCEL_REQUEST_MESSAGE_ID WM_USER
+#define HCW_JOB_REQUEST_MESSAGE_ID (WM_USER + 1)
+
+/**
+ * Hash calculation job which is queued within the thread message queue
+ * of the worker. The job is allocated by the sender and freed by the
+ * worker after the job has been processed.
+ */
+struct HashCalculationWorkerJob
+{
+    unsigned int job_id;
+    wchar_t target_file[FILEPATH_BUFFER_TSIZE];
 };
 
 /* Functions for sending information from the worker thread to the GUI thread. */
@@ -180,7 +221,7 @@ uhashtools_hash_calculation_worker_com_send_worker_canceled_message
  *                                                      loop in the GUI thread. The GUI thread then copies
  *                                                      the event message data and after that resets this
  *                                                      event back into the signalled state.
- * @param calculated_hash Calculated hash sum of the selected file.
+ * @param calculated_digest Calculated digest of the selected file.
  */
 extern
 void
@@ -190,7 +231,7 @@ uhashtools_hash_calculation_worker_com_send_calculation_complete_message
     HWND event_message_receiver,
     struct HashCalculationWorkerEventMessage* receiver_event_message_buf,
     HANDLE receiver_event_message_buf_is_writeable_event,
-    const wchar_t* calculated_hash
+    const struct HashDigest* calculated_digest
 );
 
 /**
@@ -222,6 +263,7 @@ uhashtools_hash_calculation_worker_com_send_calculation_complete_message
  *                                                      the event message data and after that resets this
  *                                                      event back into the signalled state.
  * @param user_error_message Error message which shall be shown to the user of this application.
+ *                           A copy of the message is sent to the GUI thread.
  */
 extern
 void
@@ -262,7 +304,9 @@ uhashtools_hash_calculation_worker_com_send_calculation_failed_message
  *                                                      loop in the GUI thread. The GUI thread then copies
  *                                                      the event message data and after that resets this
  *                                                      event back into the signalled state.
- * @param current_calculation_progress Current calculation progress in range from 0 to 100.
+ * @param current_calculation_progress Current calculation progress. If the size of the
+ *                                     target is known the progress in percent is in range
+ *                                     from 0 to 100.
  */
 extern
 void
@@ -272,7 +316,7 @@ uhashtools_hash_calculation_worker_com_send_calculation_progress_message
     HWND event_message_receiver,
     struct HashCalculationWorkerEventMessage* receiver_event_message_buf,
     HANDLE receiver_event_message_buf_is_writeable_event,
-    unsigned int current_calculation_progress
+    const struct HashCalculationProgress* current_calculation_progress
 );
 
 
@@ -282,10 +326,32 @@ uhashtools_hash_calculation_worker_com_send_calculation_progress_message
  * Sends a cancellation request to the given worker thread.
  * 
  * @param receiver_thread_id Thread id of the hash calculation worker.
+ * @param job_id ID of the job which should be cancelled. The request is
+ *               ignored if the worker is no longer processing this job.
  */
 extern
 void
 uhashtools_hash_calculation_worker_com_send_cancel_request
 (
-    DWORD receiver_thread_id
+    DWORD receiver_thread_id,
+    unsigned int job_id
+);
+
+/**
+ * Queues a hash calculation job within the message queue of the given
+ * worker thread.
+ * 
+ * @param receiver_thread_id Thread id of the hash calculation worker.
+ * @param job Allocated job. On success the ownership of the job goes to
+ *            the worker thread.
+ * 
+ * @return TRUE if the job has been queued and FALSE on error. On error the
+ *         caller still owns the job.
+ */
+extern
+BOOL
+uhashtools_hash_calculation_worker_com_send_job_request
+(
+    DWORD receiver_thread_id,
+    struct HashCalculationWorkerJob* job
 );
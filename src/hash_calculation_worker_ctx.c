@@ -22,7 +22,7 @@ uhashtools_hash_calculation_worker_ctx_init
     UHASHTOOLS_ASSERT(worker_ctx,
                       L"Internal error (invalid argument): Argument 'worker_ctx' is a null pointer!");
 
-    worker_ctx->calculation_result_string_tsize = GENERIC_TXT_MESSAGES_BUFFER_TSIZE;
+    worker_ctx->calculation_error_message_tsize = GENERIC_TXT_MESSAGES_BUFFER_TSIZE;
     worker_ctx->file_read_buf_tsize = FILE_READ_BUF_TSIZE;
 
     worker_ctx->event_message_target.event_message_receiver = worker_param->event_message_receiver;
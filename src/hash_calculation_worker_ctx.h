@@ -16,6 +16,7 @@
 
 struct ReceivedThreadMessages
 {
+    unsigned int current_job_id;
     BOOL cancel_requested;
 };
 
@@ -38,8 +39,9 @@ struct HashCalculationWorkerCtx
     struct OutgoingEventMessageTarget event_message_target;
     struct HashCalculationWorkerEventMessage event_message_buf;
     struct ReceivedThreadMessages received_thread_messages;
-    wchar_t calculation_result_string[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
-    size_t calculation_result_string_tsize;
+    struct HashDigest calculation_result_digest;
+    wchar_t calculation_error_message[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    size_t calculation_error_message_tsize;
     unsigned char file_read_buf[FILE_READ_BUF_TSIZE];
     size_t file_read_buf_tsize;
 
@@ -0,0 +1,369 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "incremental_mode.h"
+
+#include "buffer_sizes.h"
+#include "error_utilities.h"
+#include "file_source_range.h"
+#include "hash_calculation_impl.h"
+#include "incremental_state.h"
+#include "std_streams.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct IncrementalModeCtx
+{
+    const wchar_t* state_file;
+    const wchar_t* target_file;
+
+    unsigned char* file_read_buf;
+    wchar_t* result_string_buf;
+    wchar_t error_message_buf[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+
+    struct IncrementalState state;
+
+    /* Amount of bytes read to check the already hashed part. */
+    unsigned __int64 checked_size;
+};
+
+/* Hashes a part of the target file, which has already been hashed before, for a check block. */
+static
+BOOL
+uhashtools_incremental_mode_hash_check_block
+(
+    struct IncrementalModeCtx* ctx,
+    unsigned __int64 offset,
+    unsigned __int64 size,
+    struct HashDigest* digest
+)
+{
+    struct FileSource file_source;
+    enum HashCalculatorResultCode hash_rc = HashCalculatorResultCode_FAILED;
+
+    file_source = uhashtools_file_source_range_open(ctx->error_message_buf,
+                                                    GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                    ctx->target_file,
+                                                    offset,
+                                                    size);
+
+    if (!file_source.is_ok)
+    {
+        return FALSE;
+    }
+
+    /* A shorter range means that the file has been truncated since its size has been queried. */
+    if (file_source.size != size)
+    {
+        uhashtools_file_source_close(&file_source);
+        (void) wcscpy_s(ctx->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, L"The selected file has been truncated!");
+
+        return FALSE;
+    }
+
+    hash_rc = uhashtools_hash_calculator_impl_hash_file_source_to_digest(ctx->file_read_buf,
+                                                                         FILE_READ_BUF_TSIZE,
+                                                                         digest,
+                                                                         ctx->error_message_buf,
+                                                                         GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                                         &file_source,
+                                                                         NULL,
+                                                                         NULL,
+                                                                         NULL,
+                                                                         NULL);
+
+    uhashtools_file_source_close(&file_source);
+
+    ctx->checked_size += size;
+
+    return hash_rc == HashCalculatorResultCode_SUCCESS;
+}
+
+/*
+ * Checks if the part of the file which has been hashed by the previous
+ * run is unchanged. Only the check blocks are read, so appending data in
+ * the middle of the file or rewriting parts between the check blocks
+ * isn't noticed.
+ */
+static
+BOOL
+uhashtools_incremental_mode_is_prefix_unchanged
+(
+    struct IncrementalModeCtx* ctx,
+    unsigned __int64 file_size
+)
+{
+    struct HashDigest digest;
+    size_t i = 0;
+
+    if (ctx->state.resume_state.hashed_size > file_size)
+    {
+        (void) wcscpy_s(ctx->error_message_buf,
+                        GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                        L"The file is smaller than the part which has already been hashed!");
+
+        return FALSE;
+    }
+
+    for (i = 0; i < ctx->state.check_blocks_count; ++i)
+    {
+        const struct IncrementalStateCheckBlock* check_block = &ctx->state.check_blocks[i];
+
+        if (check_block->offset > ctx->state.resume_state.hashed_size ||
+            check_block->size > ctx->state.resume_state.hashed_size - check_block->offset)
+        {
+            (void) wcscpy_s(ctx->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, L"The state file is damaged!");
+
+            return FALSE;
+        }
+
+        if (!uhashtools_incremental_mode_hash_check_block(ctx, check_block->offset, check_block->size, &digest))
+        {
+            return FALSE;
+        }
+
+        if (digest.size != check_block->digest.size ||
+            memcmp((const void*) digest.bytes, (const void*) check_block->digest.bytes, digest.size) != 0)
+        {
+            (void) wcscpy_s(ctx->error_message_buf,
+                            GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                            L"The part which has already been hashed has been changed!");
+
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Spreads the check blocks over the hashed part of the file. The first
+ * block always starts at the beginning of the file and the last block
+ * always ends at the end of the hashed part, where appending programs
+ * are most likely to rewrite data. Blocks which have already been
+ * checked by this run are reused without reading them again.
+ */
+static
+BOOL
+uhashtools_incremental_mode_place_check_blocks
+(
+    struct IncrementalModeCtx* ctx,
+    const struct IncrementalStateCheckBlock* checked_blocks,
+    size_t checked_blocks_count
+)
+{
+    const unsigned __int64 hashed_size = ctx->state.resume_state.hashed_size;
+    const unsigned __int64 block_size = INCREMENTAL_STATE_CHECK_BLOCK_SIZE;
+    unsigned __int64 blocks_count = (hashed_size + block_size - 1) / block_size;
+    size_t i = 0;
+    size_t j = 0;
+
+    if (blocks_count > INCREMENTAL_STATE_MAX_CHECK_BLOCKS)
+    {
+        blocks_count = INCREMENTAL_STATE_MAX_CHECK_BLOCKS;
+    }
+
+    ctx->state.check_blocks_count = 0;
+
+    for (i = 0; i < (size_t) blocks_count; ++i)
+    {
+        struct IncrementalStateCheckBlock* check_block = &ctx->state.check_blocks[i];
+        BOOL is_reused = FALSE;
+
+        if (hashed_size <= block_size * INCREMENTAL_STATE_MAX_CHECK_BLOCKS)
+        {
+            /* Small files are covered completely. */
+            check_block->offset = block_size * i;
+            check_block->size = hashed_size - check_block->offset < block_size ? hashed_size - check_block->offset : block_size;
+        }
+        else
+        {
+            check_block->offset = (hashed_size - block_size) / (INCREMENTAL_STATE_MAX_CHECK_BLOCKS - 1) * i;
+            check_block->size = block_size;
+
+            if (i == INCREMENTAL_STATE_MAX_CHECK_BLOCKS - 1)
+            {
+                check_block->offset = hashed_size - block_size;
+            }
+        }
+
+        for (j = 0; j < checked_blocks_count && !is_reused; ++j)
+        {
+            if (checked_blocks[j].offset == check_block->offset && checked_blocks[j].size == check_block->size)
+            {
+                check_block->digest = checked_blocks[j].digest;
+                is_reused = TRUE;
+            }
+        }
+
+        if (!is_reused &&
+            !uhashtools_incremental_mode_hash_check_block(ctx, check_block->offset, check_block->size, &check_block->digest))
+        {
+            return FALSE;
+        }
+
+        ctx->state.check_blocks_count = i + 1;
+    }
+
+    return TRUE;
+}
+
+static
+int
+uhashtools_incremental_mode_hash
+(
+    struct IncrementalModeCtx* ctx
+)
+{
+    WIN32_FILE_ATTRIBUTE_DATA file_attributes;
+    unsigned __int64 file_size = 0;
+    unsigned __int64 resumed_size = 0;
+    struct IncrementalStateCheckBlock checked_blocks[INCREMENTAL_STATE_MAX_CHECK_BLOCKS];
+    size_t checked_blocks_count = 0;
+    struct FileSource file_source;
+    struct HashDigest digest;
+    enum HashCalculatorResultCode hash_rc = HashCalculatorResultCode_FAILED;
+
+    if (!GetFileAttributesExW(ctx->target_file, GetFileExInfoStandard, &file_attributes) ||
+        (file_attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+    {
+        (void) fwprintf_s(stderr, L"%s: Failed to open the selected file!\n", ctx->target_file);
+
+        return 1;
+    }
+
+    file_size = ((unsigned __int64) file_attributes.nFileSizeHigh << 32) | file_attributes.nFileSizeLow;
+
+    /* A missing state file is the normal case for the first run. */
+    if (GetFileAttributesExW(ctx->state_file, GetFileExInfoStandard, &file_attributes))
+    {
+        if (!uhashtools_incremental_state_load(ctx->error_message_buf,
+                                               GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                               ctx->state_file,
+                                               &ctx->state) ||
+            !uhashtools_incremental_mode_is_prefix_unchanged(ctx, file_size))
+        {
+            (void) fwprintf_s(stderr, L"%s: %s The whole file is hashed again.\n", ctx->state_file, ctx->error_message_buf);
+            uhashtools_incremental_state_free(&ctx->state);
+        }
+    }
+
+    resumed_size = ctx->state.resume_state.hashed_size;
+    checked_blocks_count = ctx->state.check_blocks_count;
+    (void) memcpy((void*) checked_blocks, (const void*) ctx->state.check_blocks, sizeof checked_blocks);
+
+    file_source = uhashtools_file_source_range_open(ctx->error_message_buf,
+                                                    GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                    ctx->target_file,
+                                                    resumed_size,
+                                                    FILE_SOURCE_RANGE_TO_EOF);
+
+    if (!file_source.is_ok)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", ctx->target_file, ctx->error_message_buf);
+
+        return 1;
+    }
+
+    hash_rc = uhashtools_hash_calculator_impl_resume_file_source_to_digest(ctx->file_read_buf,
+                                                                           FILE_READ_BUF_TSIZE,
+                                                                           &digest,
+                                                                           ctx->error_message_buf,
+                                                                           GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                                           &file_source,
+                                                                           &ctx->state.resume_state);
+
+    uhashtools_file_source_close(&file_source);
+
+    if (hash_rc != HashCalculatorResultCode_SUCCESS)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", ctx->target_file, ctx->error_message_buf);
+
+        return 1;
+    }
+
+    if (!uhashtools_incremental_mode_place_check_blocks(ctx, checked_blocks, checked_blocks_count))
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", ctx->target_file, ctx->error_message_buf);
+
+        return 1;
+    }
+
+    if (!uhashtools_incremental_state_save(ctx->error_message_buf,
+                                           GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                           ctx->state_file,
+                                           &ctx->state))
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", ctx->state_file, ctx->error_message_buf);
+
+        return 1;
+    }
+
+    (void) uhashtools_hash_calculator_impl_digest_to_hex(&digest, ctx->result_string_buf, HASH_RESULT_BUFFER_TSIZE);
+
+    (void) wprintf_s(L"%s *%s\n", ctx->result_string_buf, ctx->target_file);
+    (void) wprintf_s(L"# Resumed at offset %I64u, %I64u bytes hashed, %I64u bytes checked\n",
+                     resumed_size,
+                     ctx->state.resume_state.hashed_size - resumed_size,
+                     ctx->checked_size);
+
+    (void) fflush(stdout);
+
+    return 0;
+}
+
+int
+uhashtools_incremental_mode_run
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    int ret = 1;
+    struct IncrementalModeCtx* ctx = NULL;
+
+    UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
+    UHASHTOOLS_ASSERT(uhashtools_cli_arguments_has_incremental_state_file(cli_arguments),
+                      L"Internal error: Entered incremental mode without a state file!");
+
+    uhashtools_std_streams_connect();
+
+    ctx = (struct IncrementalModeCtx*) malloc(sizeof *ctx);
+
+    if (!ctx)
+    {
+        (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+        return 1;
+    }
+
+    (void) memset((void*) ctx, 0, sizeof *ctx);
+
+    ctx->state_file = cli_arguments->incremental_state_file;
+    ctx->target_file = cli_arguments->incremental_target_file;
+    ctx->file_read_buf = (unsigned char*) malloc(FILE_READ_BUF_TSIZE);
+    ctx->result_string_buf = (wchar_t*) malloc(HASH_RESULT_BUFFER_TSIZE * sizeof *ctx->result_string_buf);
+
+    if (!ctx->file_read_buf || !ctx->result_string_buf)
+    {
+        (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+        goto cleanup_and_out;
+    }
+
+    ret = uhashtools_incremental_mode_hash(ctx);
+
+cleanup_and_out:
+    uhashtools_incremental_state_free(&ctx->state);
+    free((void*) ctx->result_string_buf);
+    free((void*) ctx->file_read_buf);
+    free((void*) ctx);
+
+    return ret;
+}
@@ -0,0 +1,40 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "cli_arguments.h"
+
+/*
+ * The incremental mode "--incremental <state file> <file>" hashes a file
+ * which only grows by appending data, like a log file or a journal,
+ * without creating a window.
+ * 
+ * The state file stores the state of the built-in hasher after the part
+ * of the file which has been hashed by the previous run (see
+ * "incremental_state.h"). If the file hasn't shrunk and the check blocks
+ * of the already hashed part still have the stored digests, only the
+ * appended data is read. Otherwise the whole file is hashed again. In
+ * both cases the state file is updated afterwards and the digest of the
+ * whole file is written to stdout as "<hash> *<filepath>".
+ */
+
+/**
+ * Runs the incremental mode.
+ * 
+ * @param cli_arguments Command line arguments with a set state file.
+ * 
+ * @return Exit code of the process. Zero if the file has been hashed and
+ *         the state file has been updated else one.
+ */
+extern
+int
+uhashtools_incremental_mode_run
+(
+    const struct CliArguments* cli_arguments
+);
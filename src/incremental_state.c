@@ -0,0 +1,258 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "incremental_state.h"
+
+#include "buffer_sizes.h"
+#include "error_utilities.h"
+#include "product.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INCREMENTAL_STATE_MAGIC "UHINCST1"
+#define INCREMENTAL_STATE_MAGIC_SIZE 8
+
+#define INCREMENTAL_STATE_PRODUCT_ID_TSIZE 32
+
+struct IncrementalStateFileCheckBlock
+{
+    unsigned __int64 offset;
+    unsigned __int64 size;
+    unsigned char digest[HASH_DIGEST_MAX_SIZE];
+};
+
+struct IncrementalStateFileHeader
+{
+    char magic[INCREMENTAL_STATE_MAGIC_SIZE];
+
+    /* Identifies the product, since the hasher states of some products have the same size. */
+    wchar_t product_id[INCREMENTAL_STATE_PRODUCT_ID_TSIZE];
+    unsigned int hasher_state_size;
+    unsigned int digest_size;
+    unsigned int check_blocks_count;
+    unsigned int reserved;
+    unsigned __int64 hashed_size;
+    struct IncrementalStateFileCheckBlock check_blocks[INCREMENTAL_STATE_MAX_CHECK_BLOCKS];
+};
+
+static
+void
+uhashtools_incremental_state_get_product_id
+(
+    wchar_t* product_id
+)
+{
+    (void) memset((void*) product_id, 0, INCREMENTAL_STATE_PRODUCT_ID_TSIZE * sizeof *product_id);
+    (void) wcsncpy_s(product_id,
+                     INCREMENTAL_STATE_PRODUCT_ID_TSIZE,
+                     uhashtools_product_get_mainwin_classname(),
+                     _TRUNCATE);
+}
+
+BOOL
+uhashtools_incremental_state_load
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* state_file,
+    struct IncrementalState* state
+)
+{
+    BOOL ret = FALSE;
+    FILE* state_file_handle = NULL;
+    struct IncrementalStateFileHeader header;
+    wchar_t product_id[INCREMENTAL_STATE_PRODUCT_ID_TSIZE];
+    const size_t hasher_state_size = uhashtools_product_get_builtin_hasher_state_size();
+    const size_t digest_size = uhashtools_product_get_builtin_hasher_digest_size();
+    void* hasher_state = NULL;
+    size_t i = 0;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(state, L"Internal error: state is NULL!");
+
+    if (_wfopen_s(&state_file_handle, state_file, L"rb") != 0 || !state_file_handle)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to open the state file!");
+
+        goto cleanup_and_out;
+    }
+
+    uhashtools_incremental_state_get_product_id(product_id);
+
+    if (fread((void*) &header, sizeof header, 1, state_file_handle) != 1 ||
+        memcmp((const void*) header.magic, (const void*) INCREMENTAL_STATE_MAGIC, INCREMENTAL_STATE_MAGIC_SIZE) != 0 ||
+        header.check_blocks_count > INCREMENTAL_STATE_MAX_CHECK_BLOCKS)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The selected file isn't a state file!");
+
+        goto cleanup_and_out;
+    }
+
+    if (memcmp((const void*) header.product_id, (const void*) product_id, sizeof product_id) != 0 ||
+        header.hasher_state_size != hasher_state_size ||
+        header.digest_size != digest_size)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"The state file has been written by another application or another version of it!");
+
+        goto cleanup_and_out;
+    }
+
+    hasher_state = malloc(hasher_state_size);
+
+    if (!hasher_state)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+
+        goto cleanup_and_out;
+    }
+
+    /*
+     * The hasher trusts its counters, so a damaged state could make it write beyond its buffers.
+     * A state which doesn't belong to the hashed size of the header would resume at the wrong offset.
+     */
+    if (fread(hasher_state, hasher_state_size, 1, state_file_handle) != 1 ||
+        !uhashtools_product_builtin_hasher_is_state_valid(hasher_state, header.hashed_size))
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The state file is damaged!");
+
+        goto cleanup_and_out;
+    }
+
+    (void) memset((void*) state, 0, sizeof *state);
+    state->resume_state.hashed_size = header.hashed_size;
+    state->resume_state.hasher_state = hasher_state; hasher_state = NULL;
+    state->check_blocks_count = header.check_blocks_count;
+
+    for (i = 0; i < state->check_blocks_count; ++i)
+    {
+        state->check_blocks[i].offset = header.check_blocks[i].offset;
+        state->check_blocks[i].size = header.check_blocks[i].size;
+        state->check_blocks[i].digest.size = (unsigned int) digest_size;
+        (void) memcpy((void*) state->check_blocks[i].digest.bytes,
+                      (const void*) header.check_blocks[i].digest,
+                      digest_size);
+    }
+
+    ret = TRUE;
+
+cleanup_and_out:
+    if (hasher_state)
+    {
+        free(hasher_state);
+    }
+
+    if (state_file_handle)
+    {
+        (void) fclose(state_file_handle);
+    }
+
+    return ret;
+}
+
+BOOL
+uhashtools_incremental_state_save
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* state_file,
+    const struct IncrementalState* state
+)
+{
+    BOOL ret = FALSE;
+    FILE* state_file_handle = NULL;
+    wchar_t temp_state_file[FILEPATH_BUFFER_TSIZE];
+    struct IncrementalStateFileHeader header;
+    const size_t hasher_state_size = uhashtools_product_get_builtin_hasher_state_size();
+    const size_t digest_size = uhashtools_product_get_builtin_hasher_digest_size();
+    BOOL is_written = FALSE;
+    size_t i = 0;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(state && state->resume_state.hasher_state, L"Internal error: Entered without a hasher state!");
+    UHASHTOOLS_ASSERT(state->check_blocks_count <= INCREMENTAL_STATE_MAX_CHECK_BLOCKS,
+                      L"Internal error: Too many check blocks!");
+
+    /* The new state is written next to the old one, so an interrupted run keeps the old state. */
+    if (wcscpy_s(temp_state_file, FILEPATH_BUFFER_TSIZE, state_file) != 0 ||
+        wcscat_s(temp_state_file, FILEPATH_BUFFER_TSIZE, L".tmp") != 0)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The path of the state file is too long!");
+
+        return FALSE;
+    }
+
+    (void) memset((void*) &header, 0, sizeof header);
+    (void) memcpy((void*) header.magic, (const void*) INCREMENTAL_STATE_MAGIC, INCREMENTAL_STATE_MAGIC_SIZE);
+    uhashtools_incremental_state_get_product_id(header.product_id);
+    header.hasher_state_size = (unsigned int) hasher_state_size;
+    header.digest_size = (unsigned int) digest_size;
+    header.check_blocks_count = (unsigned int) state->check_blocks_count;
+    header.hashed_size = state->resume_state.hashed_size;
+
+    for (i = 0; i < state->check_blocks_count; ++i)
+    {
+        header.check_blocks[i].offset = state->check_blocks[i].offset;
+        header.check_blocks[i].size = state->check_blocks[i].size;
+        (void) memcpy((void*) header.check_blocks[i].digest,
+                      (const void*) state->check_blocks[i].digest.bytes,
+                      digest_size);
+    }
+
+    if (_wfopen_s(&state_file_handle, temp_state_file, L"wb") != 0 || !state_file_handle)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to create the state file!");
+
+        goto cleanup_and_out;
+    }
+
+    is_written = fwrite((const void*) &header, sizeof header, 1, state_file_handle) == 1 &&
+                 fwrite(state->resume_state.hasher_state, hasher_state_size, 1, state_file_handle) == 1;
+
+    if (fclose(state_file_handle) != 0)
+    {
+        is_written = FALSE;
+    }
+
+    state_file_handle = NULL;
+
+    if (!is_written || !MoveFileExW(temp_state_file, state_file, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to write the state file!");
+        (void) DeleteFileW(temp_state_file);
+
+        goto cleanup_and_out;
+    }
+
+    ret = TRUE;
+
+cleanup_and_out:
+    if (state_file_handle)
+    {
+        (void) fclose(state_file_handle);
+    }
+
+    return ret;
+}
+
+void
+uhashtools_incremental_state_free
+(
+    struct IncrementalState* state
+)
+{
+    UHASHTOOLS_ASSERT(state, L"Internal error: state is NULL!");
+
+    uhashtools_hash_calculator_impl_free_resume_state(&state->resume_state);
+    (void) memset((void*) state, 0, sizeof *state);
+}
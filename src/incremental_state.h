@@ -0,0 +1,102 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "hash_calculation_impl.h"
+
+#include <Windows.h>
+
+/*
+ * The state file of the incremental mode (see "incremental_mode.h")
+ * stores the state of the built-in hasher after the already hashed
+ * part of a file. To detect files which have been rewritten instead of
+ * appended to, it also stores the digests of a few check blocks spread
+ * over the hashed part. The file consists of a fixed size header and
+ * the raw hasher state.
+ * 
+ * The state can only be restored by the same product built for the same
+ * architecture, since the layout of the hasher state differs between
+ * both.
+ */
+
+#define INCREMENTAL_STATE_CHECK_BLOCK_SIZE (1024 * 64)
+#define INCREMENTAL_STATE_MAX_CHECK_BLOCKS 8
+
+struct IncrementalStateCheckBlock
+{
+    unsigned __int64 offset;
+    unsigned __int64 size;
+    struct HashDigest digest;
+};
+
+/**
+ * Content of a state file. The default initialisation is to do a
+ * memset zero, which describes a file of which nothing has been hashed.
+ */
+struct IncrementalState
+{
+    struct HashResumeState resume_state;
+    size_t check_blocks_count;
+    struct IncrementalStateCheckBlock check_blocks[INCREMENTAL_STATE_MAX_CHECK_BLOCKS];
+};
+
+/**
+ * Reads a state file.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if
+ *                          the state can't be read.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param state_file Path of the state file.
+ * @param state Zero initialized state which receives the content. Has to be
+ *              freed with "uhashtools_incremental_state_free()".
+ * 
+ * @return TRUE on success and FALSE if the file is missing, damaged or has
+ *         been written by another product.
+ */
+extern
+BOOL
+uhashtools_incremental_state_load
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* state_file,
+    struct IncrementalState* state
+);
+
+/**
+ * Writes a state file. The previous state file is only replaced after
+ * the new one has been written completely.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if
+ *                          the state can't be written.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param state_file Path of the state file.
+ * @param state State with a hasher state.
+ * 
+ * @return TRUE on success and FALSE on failure.
+ */
+extern
+BOOL
+uhashtools_incremental_state_save
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* state_file,
+    const struct IncrementalState* state
+);
+
+/**
+ * Frees the hasher state and resets "state" to the zero initialized state.
+ */
+extern
+void
+uhashtools_incremental_state_free
+(
+    struct IncrementalState* state
+);
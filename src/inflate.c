@@ -0,0 +1,721 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "inflate.h"
+
+#include "error_utilities.h"
+
+#include <string.h>
+
+#define INFLATE_WINDOW_MASK (INFLATE_WINDOW_SIZE - 1)
+#define INFLATE_FAST_MASK ((1 << INFLATE_FAST_BITS) - 1)
+#define INFLATE_END_OF_BLOCK 256
+
+static const unsigned short INFLATE_LENGTH_BASE[29] =
+{
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+static const unsigned char INFLATE_LENGTH_EXTRA_BITS[29] =
+{
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+static const unsigned short INFLATE_DISTANCE_BASE[30] =
+{
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+
+static const unsigned char INFLATE_DISTANCE_EXTRA_BITS[30] =
+{
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static const unsigned char INFLATE_CODE_LENGTH_ORDER[19] =
+{
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+static
+unsigned int
+uhashtools_inflate_reverse_bits
+(
+    unsigned int value,
+    int bit_count
+)
+{
+    unsigned int ret = 0;
+    int i = 0;
+
+    for (i = 0; i < bit_count; ++i)
+    {
+        ret = (ret << 1) | (value & 1u);
+        value >>= 1;
+    }
+
+    return ret;
+}
+
+static
+unsigned int
+uhashtools_inflate_next_input_byte
+(
+    struct InflateStream* inflate_stream
+)
+{
+    if (inflate_stream->input_buf_pos >= inflate_stream->input_buf_len &&
+        !inflate_stream->input_reached_end &&
+        !inflate_stream->input_failed)
+    {
+        size_t read_size = 0;
+
+        if (!inflate_stream->input_function(inflate_stream->input_function_userdata,
+                                            inflate_stream->input_buf,
+                                            INFLATE_INPUT_BUF_SIZE,
+                                            &read_size))
+        {
+            inflate_stream->input_failed = TRUE;
+            read_size = 0;
+        }
+
+        inflate_stream->input_buf_pos = 0;
+        inflate_stream->input_buf_len = read_size;
+
+        if (read_size == 0)
+        {
+            inflate_stream->input_reached_end = TRUE;
+        }
+    }
+
+    if (inflate_stream->input_buf_pos < inflate_stream->input_buf_len)
+    {
+        return inflate_stream->input_buf[inflate_stream->input_buf_pos++];
+    }
+
+    /*
+     * We're running past the end of the input. Feeding zeros here keeps
+     * the bit reader simple. "uhashtools_inflate_is_truncated()" detects
+     * if one of those zeros has been consumed.
+     */
+    ++inflate_stream->input_overrun_bytes;
+
+    return 0;
+}
+
+static
+void
+uhashtools_inflate_fill_bits
+(
+    struct InflateStream* inflate_stream
+)
+{
+    while (inflate_stream->bit_count <= 24)
+    {
+        inflate_stream->bit_buffer |= uhashtools_inflate_next_input_byte(inflate_stream) << inflate_stream->bit_count;
+        inflate_stream->bit_count += 8;
+    }
+}
+
+static
+unsigned int
+uhashtools_inflate_get_bits
+(
+    struct InflateStream* inflate_stream,
+    int bit_count
+)
+{
+    unsigned int ret = 0;
+
+    if (bit_count == 0)
+    {
+        return 0;
+    }
+
+    if (inflate_stream->bit_count < bit_count)
+    {
+        uhashtools_inflate_fill_bits(inflate_stream);
+    }
+
+    ret = inflate_stream->bit_buffer & ((1u << bit_count) - 1u);
+    inflate_stream->bit_buffer >>= bit_count;
+    inflate_stream->bit_count -= bit_count;
+
+    return ret;
+}
+
+static
+BOOL
+uhashtools_inflate_is_truncated
+(
+    const struct InflateStream* inflate_stream
+)
+{
+    return inflate_stream->input_failed ||
+           (int) (inflate_stream->input_overrun_bytes * 8) > inflate_stream->bit_count;
+}
+
+static
+BOOL
+uhashtools_inflate_build_huffman_table
+(
+    struct InflateHuffmanTable* huffman_table,
+    const unsigned char* code_lengths,
+    int code_count
+)
+{
+    int code_length_counts[16];
+    int next_code[16];
+    int code = 0;
+    int symbol_index = 0;
+    int i = 0;
+
+    (void) memset((void*) code_length_counts, 0, sizeof code_length_counts);
+    (void) memset((void*) huffman_table->fast, 0, sizeof huffman_table->fast);
+
+    for (i = 0; i < code_count; ++i)
+    {
+        ++code_length_counts[code_lengths[i]];
+    }
+
+    code_length_counts[0] = 0;
+
+    for (i = 1; i < 16; ++i)
+    {
+        if (code_length_counts[i] > (1 << i))
+        {
+            return FALSE;
+        }
+    }
+
+    for (i = 1; i < 16; ++i)
+    {
+        next_code[i] = code;
+        huffman_table->first_code[i] = (unsigned short) code;
+        huffman_table->first_symbol[i] = (unsigned short) symbol_index;
+        code += code_length_counts[i];
+
+        if (code_length_counts[i] && code - 1 >= (1 << i))
+        {
+            /* Over-subscribed code */
+            return FALSE;
+        }
+
+        huffman_table->max_code[i] = (unsigned int) code << (16 - i);
+        code <<= 1;
+        symbol_index += code_length_counts[i];
+    }
+
+    huffman_table->max_code[16] = 0x10000;
+
+    for (i = 0; i < code_count; ++i)
+    {
+        const int code_length = code_lengths[i];
+
+        if (code_length)
+        {
+            const int sorted_index = next_code[code_length] - huffman_table->first_code[code_length] +
+                                     huffman_table->first_symbol[code_length];
+
+            huffman_table->code_size[sorted_index] = (unsigned char) code_length;
+            huffman_table->code_value[sorted_index] = (unsigned short) i;
+
+            if (code_length <= INFLATE_FAST_BITS)
+            {
+                unsigned int fast_index = uhashtools_inflate_reverse_bits((unsigned int) next_code[code_length],
+                                                                          code_length);
+
+                while (fast_index < (1u << INFLATE_FAST_BITS))
+                {
+                    huffman_table->fast[fast_index] = (unsigned short) ((code_length << 9) | i);
+                    fast_index += 1u << code_length;
+                }
+            }
+
+            ++next_code[code_length];
+        }
+    }
+
+    return TRUE;
+}
+
+static
+int
+uhashtools_inflate_decode_symbol
+(
+    struct InflateStream* inflate_stream,
+    const struct InflateHuffmanTable* huffman_table
+)
+{
+    unsigned int fast_entry = 0;
+    unsigned int reversed_code = 0;
+    int code_length = 0;
+    int sorted_index = 0;
+
+    if (inflate_stream->bit_count < 16)
+    {
+        uhashtools_inflate_fill_bits(inflate_stream);
+    }
+
+    fast_entry = huffman_table->fast[inflate_stream->bit_buffer & INFLATE_FAST_MASK];
+
+    if (fast_entry)
+    {
+        code_length = (int) (fast_entry >> 9);
+        inflate_stream->bit_buffer >>= code_length;
+        inflate_stream->bit_count -= code_length;
+
+        return (int) (fast_entry & 511u);
+    }
+
+    /* Slow path for codes which are longer than INFLATE_FAST_BITS. */
+    reversed_code = uhashtools_inflate_reverse_bits(inflate_stream->bit_buffer & 0xFFFFu, 16);
+
+    for (code_length = INFLATE_FAST_BITS + 1; reversed_code >= huffman_table->max_code[code_length]; ++code_length)
+    {
+        /* Searching the length of the current code */
+    }
+
+    if (code_length >= 16)
+    {
+        return -1;
+    }
+
+    sorted_index = (int) (reversed_code >> (16 - code_length)) - huffman_table->first_code[code_length] +
+                   huffman_table->first_symbol[code_length];
+
+    if (sorted_index < 0 || sorted_index >= 288 || huffman_table->code_size[sorted_index] != code_length)
+    {
+        return -1;
+    }
+
+    inflate_stream->bit_buffer >>= code_length;
+    inflate_stream->bit_count -= code_length;
+
+    return huffman_table->code_value[sorted_index];
+}
+
+static
+BOOL
+uhashtools_inflate_prepare_fixed_tables
+(
+    struct InflateStream* inflate_stream
+)
+{
+    unsigned char code_lengths[288];
+    int i = 0;
+
+    for (i = 0; i < 144; ++i)
+    {
+        code_lengths[i] = 8;
+    }
+
+    for (; i < 256; ++i)
+    {
+        code_lengths[i] = 9;
+    }
+
+    for (; i < 280; ++i)
+    {
+        code_lengths[i] = 7;
+    }
+
+    for (; i < 288; ++i)
+    {
+        code_lengths[i] = 8;
+    }
+
+    if (!uhashtools_inflate_build_huffman_table(&inflate_stream->literal_table, code_lengths, 288))
+    {
+        return FALSE;
+    }
+
+    for (i = 0; i < 30; ++i)
+    {
+        code_lengths[i] = 5;
+    }
+
+    return uhashtools_inflate_build_huffman_table(&inflate_stream->distance_table, code_lengths, 30);
+}
+
+static
+BOOL
+uhashtools_inflate_prepare_dynamic_tables
+(
+    struct InflateStream* inflate_stream
+)
+{
+    struct InflateHuffmanTable* code_length_table = &inflate_stream->distance_table;
+    unsigned char code_length_code_lengths[19];
+    unsigned char code_lengths[286 + 32 + 137];
+    int literal_code_count = 0;
+    int distance_code_count = 0;
+    int code_length_code_count = 0;
+    int total_code_count = 0;
+    int decoded_count = 0;
+    int i = 0;
+
+    literal_code_count = (int) uhashtools_inflate_get_bits(inflate_stream, 5) + 257;
+    distance_code_count = (int) uhashtools_inflate_get_bits(inflate_stream, 5) + 1;
+    code_length_code_count = (int) uhashtools_inflate_get_bits(inflate_stream, 4) + 4;
+    total_code_count = literal_code_count + distance_code_count;
+
+    if (literal_code_count > 286 || distance_code_count > 30)
+    {
+        return FALSE;
+    }
+
+    (void) memset((void*) code_length_code_lengths, 0, sizeof code_length_code_lengths);
+
+    for (i = 0; i < code_length_code_count; ++i)
+    {
+        code_length_code_lengths[INFLATE_CODE_LENGTH_ORDER[i]] = (unsigned char) uhashtools_inflate_get_bits(inflate_stream, 3);
+    }
+
+    /* The distance table isn't needed yet, so we're using its memory for the code length table. */
+    if (!uhashtools_inflate_build_huffman_table(code_length_table, code_length_code_lengths, 19))
+    {
+        return FALSE;
+    }
+
+    while (decoded_count < total_code_count)
+    {
+        int symbol = uhashtools_inflate_decode_symbol(inflate_stream, code_length_table);
+        int repeat_count = 0;
+        unsigned char repeat_value = 0;
+
+        if (symbol < 0 || symbol >= 19)
+        {
+            return FALSE;
+        }
+
+        if (symbol < 16)
+        {
+            code_lengths[decoded_count++] = (unsigned char) symbol;
+            continue;
+        }
+
+        if (symbol == 16)
+        {
+            if (decoded_count == 0)
+            {
+                return FALSE;
+            }
+
+            repeat_count = (int) uhashtools_inflate_get_bits(inflate_stream, 2) + 3;
+            repeat_value = code_lengths[decoded_count - 1];
+        }
+        else if (symbol == 17)
+        {
+            repeat_count = (int) uhashtools_inflate_get_bits(inflate_stream, 3) + 3;
+        }
+        else
+        {
+            repeat_count = (int) uhashtools_inflate_get_bits(inflate_stream, 7) + 11;
+        }
+
+        if (total_code_count - decoded_count < repeat_count)
+        {
+            return FALSE;
+        }
+
+        (void) memset((void*) (code_lengths + decoded_count), repeat_value, (size_t) repeat_count);
+        decoded_count += repeat_count;
+    }
+
+    if (code_lengths[INFLATE_END_OF_BLOCK] == 0)
+    {
+        return FALSE;
+    }
+
+    if (!uhashtools_inflate_build_huffman_table(&inflate_stream->literal_table, code_lengths, literal_code_count))
+    {
+        return FALSE;
+    }
+
+    return uhashtools_inflate_build_huffman_table(&inflate_stream->distance_table,
+                                                  code_lengths + literal_code_count,
+                                                  distance_code_count);
+}
+
+static
+BOOL
+uhashtools_inflate_read_block_header
+(
+    struct InflateStream* inflate_stream
+)
+{
+    unsigned int block_type = 0;
+
+    inflate_stream->is_final_block = (BOOL) uhashtools_inflate_get_bits(inflate_stream, 1);
+    block_type = uhashtools_inflate_get_bits(inflate_stream, 2);
+
+    if (block_type == 0)
+    {
+        unsigned int block_length = 0;
+        unsigned int block_length_complement = 0;
+
+        /* Stored blocks start at the next byte boundary. */
+        (void) uhashtools_inflate_get_bits(inflate_stream, inflate_stream->bit_count & 7);
+
+        block_length = uhashtools_inflate_get_bits(inflate_stream, 16);
+        block_length_complement = uhashtools_inflate_get_bits(inflate_stream, 16);
+
+        if (block_length != (~block_length_complement & 0xFFFFu))
+        {
+            return FALSE;
+        }
+
+        inflate_stream->stored_block_remaining = block_length;
+        inflate_stream->state = INFLATE_STATE_STORED_BLOCK;
+
+        return TRUE;
+    }
+    else if (block_type == 1)
+    {
+        inflate_stream->state = INFLATE_STATE_HUFFMAN_BLOCK;
+
+        return uhashtools_inflate_prepare_fixed_tables(inflate_stream);
+    }
+    else if (block_type == 2)
+    {
+        inflate_stream->state = INFLATE_STATE_HUFFMAN_BLOCK;
+
+        return uhashtools_inflate_prepare_dynamic_tables(inflate_stream);
+    }
+
+    return FALSE;
+}
+
+static
+void
+uhashtools_inflate_finish_block
+(
+    struct InflateStream* inflate_stream
+)
+{
+    inflate_stream->state = inflate_stream->is_final_block ? INFLATE_STATE_FINISHED
+                                                           : INFLATE_STATE_BLOCK_HEADER;
+}
+
+static
+__forceinline
+void
+uhashtools_inflate_emit_byte
+(
+    struct InflateStream* inflate_stream,
+    unsigned char* out_buf,
+    size_t* produced_size,
+    unsigned char value
+)
+{
+    out_buf[(*produced_size)++] = value;
+    inflate_stream->window[inflate_stream->window_pos] = value;
+    inflate_stream->window_pos = (inflate_stream->window_pos + 1) & INFLATE_WINDOW_MASK;
+    ++inflate_stream->total_out;
+}
+
+static
+BOOL
+uhashtools_inflate_read_stored_block
+(
+    struct InflateStream* inflate_stream,
+    unsigned char* out_buf,
+    size_t out_buf_size,
+    size_t* produced_size
+)
+{
+    while (inflate_stream->stored_block_remaining > 0 && *produced_size < out_buf_size)
+    {
+        if (inflate_stream->bit_count >= 8)
+        {
+            /* Draining the bytes which are still within the bit buffer. */
+            uhashtools_inflate_emit_byte(inflate_stream,
+                                         out_buf,
+                                         produced_size,
+                                         (unsigned char) uhashtools_inflate_get_bits(inflate_stream, 8));
+        }
+        else
+        {
+            const unsigned int next_byte = uhashtools_inflate_next_input_byte(inflate_stream);
+
+            if (inflate_stream->input_overrun_bytes > 0)
+            {
+                return FALSE;
+            }
+
+            uhashtools_inflate_emit_byte(inflate_stream, out_buf, produced_size, (unsigned char) next_byte);
+        }
+
+        --inflate_stream->stored_block_remaining;
+    }
+
+    if (inflate_stream->stored_block_remaining == 0)
+    {
+        uhashtools_inflate_finish_block(inflate_stream);
+    }
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_inflate_read_huffman_block
+(
+    struct InflateStream* inflate_stream,
+    unsigned char* out_buf,
+    size_t out_buf_size,
+    size_t* produced_size
+)
+{
+    while (*produced_size < out_buf_size)
+    {
+        int symbol = 0;
+        int distance_symbol = 0;
+
+        if (inflate_stream->match_remaining > 0)
+        {
+            const unsigned int match_distance = inflate_stream->match_distance;
+
+            while (inflate_stream->match_remaining > 0 && *produced_size < out_buf_size)
+            {
+                const unsigned char value = inflate_stream->window[(inflate_stream->window_pos - match_distance) & INFLATE_WINDOW_MASK];
+
+                uhashtools_inflate_emit_byte(inflate_stream, out_buf, produced_size, value);
+                --inflate_stream->match_remaining;
+            }
+
+            continue;
+        }
+
+        symbol = uhashtools_inflate_decode_symbol(inflate_stream, &inflate_stream->literal_table);
+
+        if (symbol < 0)
+        {
+            return FALSE;
+        }
+
+        if (symbol < 256)
+        {
+            uhashtools_inflate_emit_byte(inflate_stream, out_buf, produced_size, (unsigned char) symbol);
+            continue;
+        }
+
+        if (symbol == INFLATE_END_OF_BLOCK)
+        {
+            uhashtools_inflate_finish_block(inflate_stream);
+            break;
+        }
+
+        symbol -= 257;
+
+        if (symbol >= 29)
+        {
+            return FALSE;
+        }
+
+        inflate_stream->match_remaining = INFLATE_LENGTH_BASE[symbol] +
+                                          uhashtools_inflate_get_bits(inflate_stream, INFLATE_LENGTH_EXTRA_BITS[symbol]);
+
+        distance_symbol = uhashtools_inflate_decode_symbol(inflate_stream, &inflate_stream->distance_table);
+
+        if (distance_symbol < 0 || distance_symbol >= 30)
+        {
+            return FALSE;
+        }
+
+        inflate_stream->match_distance = INFLATE_DISTANCE_BASE[distance_symbol] +
+                                         uhashtools_inflate_get_bits(inflate_stream, INFLATE_DISTANCE_EXTRA_BITS[distance_symbol]);
+
+        if ((unsigned __int64) inflate_stream->match_distance > inflate_stream->total_out)
+        {
+            /* Reference before the start of the data */
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+void
+uhashtools_inflate_init
+(
+    struct InflateStream* inflate_stream,
+    InflateInputFunction* input_function,
+    void* input_function_userdata
+)
+{
+    UHASHTOOLS_ASSERT(inflate_stream, L"Internal error: Entered with inflate_stream == NULL!");
+    UHASHTOOLS_ASSERT(input_function, L"Internal error: Entered with input_function == NULL!");
+
+    (void) memset((void*) inflate_stream, 0, sizeof *inflate_stream);
+
+    inflate_stream->input_function = input_function;
+    inflate_stream->input_function_userdata = input_function_userdata;
+    inflate_stream->state = INFLATE_STATE_BLOCK_HEADER;
+}
+
+BOOL
+uhashtools_inflate_read
+(
+    struct InflateStream* inflate_stream,
+    unsigned char* out_buf,
+    size_t out_buf_size,
+    size_t* produced_size,
+    BOOL* reached_end
+)
+{
+    UHASHTOOLS_ASSERT(inflate_stream, L"Internal error: Entered with inflate_stream == NULL!");
+    UHASHTOOLS_ASSERT(out_buf && produced_size && reached_end, L"Internal error: Entered with a NULL argument!");
+
+    *produced_size = 0;
+    *reached_end = FALSE;
+
+    while (*produced_size < out_buf_size && inflate_stream->state != INFLATE_STATE_FINISHED)
+    {
+        BOOL step_success = FALSE;
+
+        switch (inflate_stream->state)
+        {
+            case INFLATE_STATE_BLOCK_HEADER:
+            {
+                step_success = uhashtools_inflate_read_block_header(inflate_stream);
+            } break;
+            case INFLATE_STATE_STORED_BLOCK:
+            {
+                step_success = uhashtools_inflate_read_stored_block(inflate_stream,
+                                                                    out_buf,
+                                                                    out_buf_size,
+                                                                    produced_size);
+            } break;
+            case INFLATE_STATE_HUFFMAN_BLOCK:
+            {
+                step_success = uhashtools_inflate_read_huffman_block(inflate_stream,
+                                                                     out_buf,
+                                                                     out_buf_size,
+                                                                     produced_size);
+            } break;
+            default:
+            {
+                UHASHTOOLS_FATAL_ERROR(L"Internal error: Invalid inflate state!");
+            }
+        }
+
+        if (!step_success || uhashtools_inflate_is_truncated(inflate_stream))
+        {
+            return FALSE;
+        }
+    }
+
+    *reached_end = inflate_stream->state == INFLATE_STATE_FINISHED;
+
+    return TRUE;
+}
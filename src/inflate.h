@@ -0,0 +1,129 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+/*
+ * Streaming decoder for raw DEFLATE data (RFC 1951) as used within
+ * ZIP and gzip archives. The compressed input is pulled through a
+ * callback function and the decompressed output is written into
+ * buffers provided by the caller, so the memory consumption doesn't
+ * depend on the size of the compressed data.
+ */
+
+#define INFLATE_WINDOW_SIZE (1024 * 32)
+#define INFLATE_INPUT_BUF_SIZE (1024 * 16)
+#define INFLATE_FAST_BITS 9
+
+/**
+ * Reads the next block of compressed input data.
+ * 
+ * @param userdata Userdata passed to "uhashtools_inflate_init()".
+ * @param buf Buffer which receives the compressed data.
+ * @param buf_size Size of "buf" in bytes.
+ * @param read_size Receives the amount of read bytes. Zero signals the end
+ *                  of the input data.
+ * 
+ * @return TRUE on success and FALSE on a read error.
+ */
+typedef BOOL InflateInputFunction(void* userdata,
+                                  unsigned char* buf,
+                                  size_t buf_size,
+                                  size_t* read_size);
+
+struct InflateHuffmanTable
+{
+    unsigned short fast[1 << INFLATE_FAST_BITS];
+    unsigned short first_code[16];
+    unsigned int max_code[17];
+    unsigned short first_symbol[16];
+    unsigned char code_size[288];
+    unsigned short code_value[288];
+};
+
+enum InflateState
+{
+    INFLATE_STATE_BLOCK_HEADER,
+    INFLATE_STATE_STORED_BLOCK,
+    INFLATE_STATE_HUFFMAN_BLOCK,
+    INFLATE_STATE_FINISHED
+};
+
+/**
+ * State of a DEFLATE decoder. The structure is big (about 40 KiB)
+ * and should therefore not be placed on the stack.
+ */
+struct InflateStream
+{
+    InflateInputFunction* input_function;
+    void* input_function_userdata;
+    unsigned char input_buf[INFLATE_INPUT_BUF_SIZE];
+    size_t input_buf_pos;
+    size_t input_buf_len;
+    BOOL input_reached_end;
+    BOOL input_failed;
+    unsigned int input_overrun_bytes;
+
+    unsigned int bit_buffer;
+    int bit_count;
+
+    enum InflateState state;
+    BOOL is_final_block;
+    unsigned int stored_block_remaining;
+    unsigned int match_remaining;
+    unsigned int match_distance;
+    struct InflateHuffmanTable literal_table;
+    struct InflateHuffmanTable distance_table;
+
+    unsigned char window[INFLATE_WINDOW_SIZE];
+    unsigned int window_pos;
+    unsigned __int64 total_out;
+};
+
+/**
+ * Initializes the decoder state.
+ * 
+ * @param inflate_stream Decoder state which should be initialized.
+ * @param input_function Function for pulling the compressed input data.
+ * @param input_function_userdata Userdata passed to "input_function".
+ */
+extern
+void
+uhashtools_inflate_init
+(
+    struct InflateStream* inflate_stream,
+    InflateInputFunction* input_function,
+    void* input_function_userdata
+);
+
+/**
+ * Decompresses the next part of the data.
+ * 
+ * @param inflate_stream Initialized decoder state.
+ * @param out_buf Buffer which receives the decompressed data.
+ * @param out_buf_size Size of "out_buf" in bytes.
+ * @param produced_size Receives the amount of bytes written into "out_buf".
+ * @param reached_end Is set to TRUE if the end of the compressed data has been
+ *                    reached. The data returned by this call must still be
+ *                    processed.
+ * 
+ * @return TRUE on success and FALSE if the compressed data is corrupt, truncated
+ *         or the input function failed.
+ */
+extern
+BOOL
+uhashtools_inflate_read
+(
+    struct InflateStream* inflate_stream,
+    unsigned char* out_buf,
+    size_t out_buf_size,
+    size_t* produced_size,
+    BOOL* reached_end
+);
@@ -0,0 +1,1089 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "io_scheduler.h"
+
+#include "buffer_sizes.h"
+#include "error_utilities.h"
+#include "print_utilities.h"
+
+#include <winioctl.h>
+
+#include <process.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define IO_SCHEDULER_READER_THREAD_STACK_SIZE (1024 * 512)
+#define IO_SCHEDULER_OPENER_THREAD_STACK_SIZE (1024 * 64)
+#define IO_SCHEDULER_INITIAL_CAPACITY 16
+
+/* Size of the "\\?\Volume{GUID}\" names returned by GetVolumeNameForVolumeMountPointW(). */
+#define VOLUME_NAME_TSIZE 64
+
+struct IoSchedulerDevice
+{
+    enum IoSchedulerMediaType media_type;
+
+    /* Physical disk of the device. Used to merge the volumes of one disk. */
+    BOOL has_device_number;
+    DWORD device_type;
+    DWORD device_number;
+
+    /* Range of the device within the ordered jobs. */
+    size_t first_job_index;
+    size_t end_job_index;
+    size_t next_job_index;
+    size_t readers_count;
+
+    /*
+     * Next job which hasn't been claimed for opening by the opener thread
+     * or a reader and the amount of jobs claimed by the opener thread which
+     * haven't been taken by a reader yet.
+     */
+    size_t next_open_job_index;
+    size_t opened_ahead_count;
+};
+
+struct IoSchedulerVolume
+{
+    /* Mount point as returned by GetVolumePathNameW(). */
+    wchar_t* volume_path;
+    size_t device_index;
+
+    /* Needed to turn the cluster numbers of the files into offsets on the disk. */
+    BOOL has_disk_layout;
+    unsigned __int64 disk_offset;
+    unsigned __int64 cluster_size;
+};
+
+/* Result of the open function for a single job. */
+struct IoSchedulerOpenedJob
+{
+    BOOL is_opened;
+    BOOL is_taken;
+    void* opened_data;
+};
+
+/* Reader or opener thread of a device. */
+struct IoSchedulerThread
+{
+    struct IoScheduler* io_scheduler;
+    BOOL is_opener;
+    size_t reader_index;
+    size_t device_index;
+    HANDLE thread_handle;
+};
+
+struct IoScheduler
+{
+    struct IoSchedulerJob* jobs;
+    size_t jobs_count;
+    size_t jobs_capacity;
+    struct IoSchedulerDevice* devices;
+    size_t devices_count;
+    size_t devices_capacity;
+    struct IoSchedulerVolume* volumes;
+    size_t volumes_count;
+    size_t volumes_capacity;
+
+    /* Shared device for the files whose volume can't be determined. */
+    BOOL has_unknown_device;
+    size_t unknown_device_index;
+
+    BOOL is_prepared;
+    size_t readers_count;
+
+    /*
+     * Protects the "next_*_job_index" of the devices and the "opened_jobs"
+     * while the threads are running. The condition variables are shared
+     * by all devices.
+     */
+    CRITICAL_SECTION jobs_lock;
+    CONDITION_VARIABLE job_opened;
+    CONDITION_VARIABLE job_taken;
+    IoSchedulerOpenFunction* open_function;
+    IoSchedulerJobFunction* job_function;
+    void* function_userdata;
+    BOOL is_start_failed;
+
+    /* Indexed like "jobs". Only used with an open function. */
+    struct IoSchedulerOpenedJob* opened_jobs;
+};
+
+/* Grows an array of the scheduler so it can take at least one more element. */
+static
+BOOL
+uhashtools_io_scheduler_reserve
+(
+    void** elements,
+    size_t* elements_capacity,
+    size_t elements_count,
+    size_t element_size
+)
+{
+    size_t new_capacity = 0;
+    void* new_elements = NULL;
+
+    if (elements_count < *elements_capacity)
+    {
+        return TRUE;
+    }
+
+    new_capacity = *elements_capacity ? *elements_capacity * 2 : IO_SCHEDULER_INITIAL_CAPACITY;
+    new_elements = realloc(*elements, new_capacity * element_size);
+
+    if (!new_elements)
+    {
+        return FALSE;
+    }
+
+    *elements = new_elements;
+    *elements_capacity = new_capacity;
+
+    return TRUE;
+}
+
+static
+HANDLE
+uhashtools_io_scheduler_open_volume
+(
+    const wchar_t* volume_path
+)
+{
+    wchar_t volume_name[VOLUME_NAME_TSIZE];
+    size_t volume_name_len = 0;
+
+    if (!GetVolumeNameForVolumeMountPointW(volume_path, volume_name, VOLUME_NAME_TSIZE))
+    {
+        return INVALID_HANDLE_VALUE;
+    }
+
+    /* With the trailing backslash the root directory would be opened instead of the volume. */
+    volume_name_len = wcslen(volume_name);
+
+    if (volume_name_len > 0 && volume_name[volume_name_len - 1] == L'\\')
+    {
+        volume_name[volume_name_len - 1] = L'\0';
+    }
+
+    /* No access rights are required for the storage queries. */
+    return CreateFileW(volume_name,
+                       0,
+                       FILE_SHARE_READ | FILE_SHARE_WRITE,
+                       NULL,
+                       OPEN_EXISTING,
+                       0,
+                       NULL);
+}
+
+static
+enum IoSchedulerMediaType
+uhashtools_io_scheduler_query_media_type
+(
+    HANDLE volume_handle,
+    const STORAGE_DEVICE_NUMBER* device_number
+)
+{
+    STORAGE_PROPERTY_QUERY property_query;
+    DEVICE_SEEK_PENALTY_DESCRIPTOR seek_penalty_descriptor;
+    DWORD returned_bytes = 0;
+
+    if (device_number &&
+        (device_number->DeviceType == FILE_DEVICE_CD_ROM || device_number->DeviceType == FILE_DEVICE_DVD))
+    {
+        return IoSchedulerMediaType_SEEK_PENALTY;
+    }
+
+    (void) memset((void*) &property_query, 0, sizeof property_query);
+    (void) memset((void*) &seek_penalty_descriptor, 0, sizeof seek_penalty_descriptor);
+    property_query.PropertyId = StorageDeviceSeekPenaltyProperty;
+    property_query.QueryType = PropertyStandardQuery;
+
+    if (!DeviceIoControl(volume_handle,
+                         IOCTL_STORAGE_QUERY_PROPERTY,
+                         (LPVOID) &property_query,
+                         sizeof property_query,
+                         (LPVOID) &seek_penalty_descriptor,
+                         sizeof seek_penalty_descriptor,
+                         &returned_bytes,
+                         NULL) ||
+        returned_bytes < sizeof seek_penalty_descriptor)
+    {
+        return IoSchedulerMediaType_UNKNOWN;
+    }
+
+    return seek_penalty_descriptor.IncursSeekPenalty ? IoSchedulerMediaType_SEEK_PENALTY
+                                                     : IoSchedulerMediaType_NO_SEEK_PENALTY;
+}
+
+/*
+ * Queries the offset of the volume on its disk and its cluster size. Volumes
+ * which are spanning multiple disks have no single offset and are left out.
+ */
+static
+BOOL
+uhashtools_io_scheduler_query_disk_layout
+(
+    HANDLE volume_handle,
+    const wchar_t* volume_path,
+    unsigned __int64* disk_offset,
+    unsigned __int64* cluster_size
+)
+{
+    VOLUME_DISK_EXTENTS volume_disk_extents;
+    DWORD returned_bytes = 0;
+    DWORD sectors_per_cluster = 0;
+    DWORD bytes_per_sector = 0;
+    DWORD free_clusters = 0;
+    DWORD total_clusters = 0;
+
+    if (!DeviceIoControl(volume_handle,
+                         IOCTL_VOLUME_GET_VOLUME_DISK_EXTENTS,
+                         NULL,
+                         0,
+                         (LPVOID) &volume_disk_extents,
+                         sizeof volume_disk_extents,
+                         &returned_bytes,
+                         NULL) ||
+        volume_disk_extents.NumberOfDiskExtents != 1)
+    {
+        return FALSE;
+    }
+
+    if (!GetDiskFreeSpaceW(volume_path, &sectors_per_cluster, &bytes_per_sector, &free_clusters, &total_clusters))
+    {
+        return FALSE;
+    }
+
+    *disk_offset = (unsigned __int64) volume_disk_extents.Extents[0].StartingOffset.QuadPart;
+    *cluster_size = (unsigned __int64) sectors_per_cluster * bytes_per_sector;
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_io_scheduler_add_volume
+(
+    struct IoScheduler* io_scheduler,
+    const wchar_t* volume_path,
+    size_t* volume_index
+)
+{
+    struct IoSchedulerVolume new_volume;
+    HANDLE volume_handle = INVALID_HANDLE_VALUE;
+    STORAGE_DEVICE_NUMBER device_number;
+    BOOL has_device_number = FALSE;
+    enum IoSchedulerMediaType media_type = IoSchedulerMediaType_UNKNOWN;
+    DWORD returned_bytes = 0;
+    size_t device_index = 0;
+    BOOL has_device = FALSE;
+
+    (void) memset((void*) &new_volume, 0, sizeof new_volume);
+    (void) memset((void*) &device_number, 0, sizeof device_number);
+
+    if (!uhashtools_io_scheduler_reserve((void**) &io_scheduler->volumes,
+                                         &io_scheduler->volumes_capacity,
+                                         io_scheduler->volumes_count,
+                                         sizeof *io_scheduler->volumes))
+    {
+        return FALSE;
+    }
+
+    new_volume.volume_path = _wcsdup(volume_path);
+
+    if (!new_volume.volume_path)
+    {
+        return FALSE;
+    }
+
+    volume_handle = uhashtools_io_scheduler_open_volume(volume_path);
+
+    if (volume_handle != INVALID_HANDLE_VALUE)
+    {
+        has_device_number = DeviceIoControl(volume_handle,
+                                            IOCTL_STORAGE_GET_DEVICE_NUMBER,
+                                            NULL,
+                                            0,
+                                            (LPVOID) &device_number,
+                                            sizeof device_number,
+                                            &returned_bytes,
+                                            NULL);
+
+        media_type = uhashtools_io_scheduler_query_media_type(volume_handle, has_device_number ? &device_number : NULL);
+
+        if (media_type == IoSchedulerMediaType_SEEK_PENALTY)
+        {
+            new_volume.has_disk_layout = uhashtools_io_scheduler_query_disk_layout(volume_handle,
+                                                                                   volume_path,
+                                                                                   &new_volume.disk_offset,
+                                                                                   &new_volume.cluster_size);
+        }
+
+        (void) CloseHandle(volume_handle);
+    }
+
+    /* Volumes on the same disk are sharing the device. */
+    if (has_device_number)
+    {
+        for (device_index = 0; device_index < io_scheduler->devices_count; ++device_index)
+        {
+            const struct IoSchedulerDevice* device = &io_scheduler->devices[device_index];
+
+            if (device->has_device_number &&
+                device->device_type == device_number.DeviceType &&
+                device->device_number == device_number.DeviceNumber)
+            {
+                has_device = TRUE;
+                break;
+            }
+        }
+    }
+
+    if (!has_device)
+    {
+        if (!uhashtools_io_scheduler_add_device(io_scheduler, media_type, &device_index))
+        {
+            free((void*) new_volume.volume_path);
+
+            return FALSE;
+        }
+
+        io_scheduler->devices[device_index].has_device_number = has_device_number;
+        io_scheduler->devices[device_index].device_type = device_number.DeviceType;
+        io_scheduler->devices[device_index].device_number = device_number.DeviceNumber;
+    }
+
+    UHASHTOOLS_PRINTF_LINE_INFO(L"I/O scheduler: Volume \"%s\" is on device %Iu (media type %d).",
+                                volume_path,
+                                device_index,
+                                (int) io_scheduler->devices[device_index].media_type);
+
+    new_volume.device_index = device_index;
+    io_scheduler->volumes[io_scheduler->volumes_count] = new_volume;
+    *volume_index = io_scheduler->volumes_count;
+    ++io_scheduler->volumes_count;
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_io_scheduler_get_unknown_device
+(
+    struct IoScheduler* io_scheduler,
+    size_t* device_index
+)
+{
+    if (!io_scheduler->has_unknown_device)
+    {
+        if (!uhashtools_io_scheduler_add_device(io_scheduler,
+                                                IoSchedulerMediaType_UNKNOWN,
+                                                &io_scheduler->unknown_device_index))
+        {
+            return FALSE;
+        }
+
+        io_scheduler->has_unknown_device = TRUE;
+    }
+
+    *device_index = io_scheduler->unknown_device_index;
+
+    return TRUE;
+}
+
+/* Returns the offset of the first cluster of the file on the disk. */
+static
+unsigned __int64
+uhashtools_io_scheduler_query_physical_offset
+(
+    const wchar_t* filepath,
+    const struct IoSchedulerVolume* volume
+)
+{
+    unsigned __int64 ret = IO_SCHEDULER_UNKNOWN_PHYSICAL_OFFSET;
+    HANDLE file_handle = INVALID_HANDLE_VALUE;
+    STARTING_VCN_INPUT_BUFFER starting_vcn;
+    RETRIEVAL_POINTERS_BUFFER retrieval_pointers;
+    DWORD returned_bytes = 0;
+    BOOL device_io_control_rc = FALSE;
+
+    if (!volume->has_disk_layout)
+    {
+        return ret;
+    }
+
+    file_handle = CreateFileW(filepath,
+                              FILE_READ_ATTRIBUTES,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL,
+                              OPEN_EXISTING,
+                              0,
+                              NULL);
+
+    if (file_handle == INVALID_HANDLE_VALUE)
+    {
+        return ret;
+    }
+
+    (void) memset((void*) &retrieval_pointers, 0, sizeof retrieval_pointers);
+    starting_vcn.StartingVcn.QuadPart = 0;
+
+    device_io_control_rc = DeviceIoControl(file_handle,
+                                           FSCTL_GET_RETRIEVAL_POINTERS,
+                                           (LPVOID) &starting_vcn,
+                                           sizeof starting_vcn,
+                                           (LPVOID) &retrieval_pointers,
+                                           sizeof retrieval_pointers,
+                                           &returned_bytes,
+                                           NULL);
+
+    /*
+     * ERROR_MORE_DATA only means that the file has more than one extent.
+     * Files which are stored within the MFT have no extents at all and a
+     * negative cluster number marks a compressed or sparse extent.
+     */
+    if ((device_io_control_rc || GetLastError() == ERROR_MORE_DATA) &&
+        retrieval_pointers.ExtentCount > 0 &&
+        retrieval_pointers.Extents[0].Lcn.QuadPart >= 0)
+    {
+        ret = volume->disk_offset + (unsigned __int64) retrieval_pointers.Extents[0].Lcn.QuadPart * volume->cluster_size;
+    }
+
+    (void) CloseHandle(file_handle);
+
+    return ret;
+}
+
+static
+int
+uhashtools_io_scheduler_compare_jobs
+(
+    const void* left,
+    const void* right
+)
+{
+    const struct IoSchedulerJob* left_job = (const struct IoSchedulerJob*) left;
+    const struct IoSchedulerJob* right_job = (const struct IoSchedulerJob*) right;
+
+    if (left_job->device_index != right_job->device_index)
+    {
+        return left_job->device_index < right_job->device_index ? -1 : 1;
+    }
+
+    if (left_job->physical_offset != right_job->physical_offset)
+    {
+        return left_job->physical_offset < right_job->physical_offset ? -1 : 1;
+    }
+
+    if (left_job->added_index != right_job->added_index)
+    {
+        return left_job->added_index < right_job->added_index ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/*
+ * Takes the next opened job of a device. If no job has been opened yet,
+ * the calling reader claims the next unclaimed job and opens it itself
+ * instead of waiting for the opener thread. On devices with a single
+ * reader the jobs are always taken in order, so the reader waits for a
+ * job which is being opened by the opener thread.
+ */
+static
+const struct IoSchedulerJob*
+uhashtools_io_scheduler_take_opened_job
+(
+    struct IoScheduler* io_scheduler,
+    size_t device_index,
+    void** opened_data
+)
+{
+    struct IoSchedulerDevice* device = &io_scheduler->devices[device_index];
+    const struct IoSchedulerJob* ret = NULL;
+    BOOL is_claimed_by_reader = FALSE;
+
+    EnterCriticalSection(&io_scheduler->jobs_lock);
+
+    while (!io_scheduler->is_start_failed)
+    {
+        size_t job_index = 0;
+
+        while (device->next_job_index < device->next_open_job_index &&
+               io_scheduler->opened_jobs[device->next_job_index].is_taken)
+        {
+            ++device->next_job_index;
+        }
+
+        if (device->next_job_index >= device->end_job_index)
+        {
+            break;
+        }
+
+        for (job_index = device->next_job_index; job_index < device->next_open_job_index; ++job_index)
+        {
+            if (io_scheduler->opened_jobs[job_index].is_opened && !io_scheduler->opened_jobs[job_index].is_taken)
+            {
+                break;
+            }
+        }
+
+        if (job_index < device->next_open_job_index)
+        {
+            *opened_data = io_scheduler->opened_jobs[job_index].opened_data;
+            --device->opened_ahead_count;
+        }
+        else if (device->next_open_job_index < device->end_job_index &&
+                 (device->next_job_index == device->next_open_job_index || device->readers_count > 1))
+        {
+            job_index = device->next_open_job_index;
+            ++device->next_open_job_index;
+            is_claimed_by_reader = TRUE;
+        }
+        else
+        {
+            (void) SleepConditionVariableCS(&io_scheduler->job_opened, &io_scheduler->jobs_lock, INFINITE);
+            continue;
+        }
+
+        io_scheduler->opened_jobs[job_index].is_taken = TRUE;
+        ret = &io_scheduler->jobs[job_index];
+        WakeAllConditionVariable(&io_scheduler->job_taken);
+        break;
+    }
+
+    LeaveCriticalSection(&io_scheduler->jobs_lock);
+
+    if (is_claimed_by_reader)
+    {
+        *opened_data = io_scheduler->open_function(ret, io_scheduler->function_userdata);
+    }
+
+    return ret;
+}
+
+static
+unsigned int
+__stdcall
+uhashtools_io_scheduler_reader_thread_function
+(
+    void* thread_param
+)
+{
+    struct IoSchedulerThread* reader = (struct IoSchedulerThread*) thread_param;
+    struct IoScheduler* io_scheduler = reader->io_scheduler;
+
+    /* If not all threads could be started, the started ones are leaving without processing a file. */
+    while (!io_scheduler->is_start_failed)
+    {
+        const struct IoSchedulerJob* job = NULL;
+        void* opened_data = NULL;
+
+        if (io_scheduler->open_function)
+        {
+            job = uhashtools_io_scheduler_take_opened_job(io_scheduler, reader->device_index, &opened_data);
+        }
+        else
+        {
+            job = uhashtools_io_scheduler_take_job(io_scheduler, reader->device_index);
+        }
+
+        if (!job)
+        {
+            break;
+        }
+
+        io_scheduler->job_function(job, opened_data, reader->reader_index, io_scheduler->function_userdata);
+    }
+
+    return 0;
+}
+
+/* Opens the jobs of a device ahead of its readers. */
+static
+unsigned int
+__stdcall
+uhashtools_io_scheduler_opener_thread_function
+(
+    void* thread_param
+)
+{
+    struct IoSchedulerThread* opener = (struct IoSchedulerThread*) thread_param;
+    struct IoScheduler* io_scheduler = opener->io_scheduler;
+    struct IoSchedulerDevice* device = &io_scheduler->devices[opener->device_index];
+
+    EnterCriticalSection(&io_scheduler->jobs_lock);
+
+    for (;;)
+    {
+        size_t job_index = 0;
+        void* opened_data = NULL;
+
+        while (!io_scheduler->is_start_failed &&
+               device->next_open_job_index < device->end_job_index &&
+               device->opened_ahead_count >= IO_SCHEDULER_OPEN_AHEAD_FILES)
+        {
+            (void) SleepConditionVariableCS(&io_scheduler->job_taken, &io_scheduler->jobs_lock, INFINITE);
+        }
+
+        if (io_scheduler->is_start_failed || device->next_open_job_index >= device->end_job_index)
+        {
+            break;
+        }
+
+        job_index = device->next_open_job_index;
+        ++device->next_open_job_index;
+        ++device->opened_ahead_count;
+
+        LeaveCriticalSection(&io_scheduler->jobs_lock);
+
+        opened_data = io_scheduler->open_function(&io_scheduler->jobs[job_index], io_scheduler->function_userdata);
+
+        EnterCriticalSection(&io_scheduler->jobs_lock);
+
+        io_scheduler->opened_jobs[job_index].opened_data = opened_data;
+        io_scheduler->opened_jobs[job_index].is_opened = TRUE;
+        WakeAllConditionVariable(&io_scheduler->job_opened);
+    }
+
+    LeaveCriticalSection(&io_scheduler->jobs_lock);
+
+    return 0;
+}
+
+struct IoScheduler*
+uhashtools_io_scheduler_create
+(
+    void
+)
+{
+    struct IoScheduler* io_scheduler = NULL;
+
+    io_scheduler = (struct IoScheduler*) calloc(1, sizeof *io_scheduler);
+
+    if (!io_scheduler)
+    {
+        return NULL;
+    }
+
+    InitializeCriticalSection(&io_scheduler->jobs_lock);
+    InitializeConditionVariable(&io_scheduler->job_opened);
+    InitializeConditionVariable(&io_scheduler->job_taken);
+
+    return io_scheduler;
+}
+
+BOOL
+uhashtools_io_scheduler_add_file
+(
+    struct IoScheduler* io_scheduler,
+    const wchar_t* filepath,
+    unsigned __int64 file_size
+)
+{
+    wchar_t volume_path[FILEPATH_BUFFER_TSIZE];
+    size_t volume_index = 0;
+    size_t device_index = 0;
+    unsigned __int64 physical_offset = IO_SCHEDULER_UNKNOWN_PHYSICAL_OFFSET;
+
+    UHASHTOOLS_ASSERT(io_scheduler && !io_scheduler->is_prepared,
+                      L"Internal error: Entered with a NULL or already prepared io_scheduler!");
+    UHASHTOOLS_ASSERT(filepath, L"Internal error: filepath is NULL!");
+
+    if (!GetVolumePathNameW(filepath, volume_path, FILEPATH_BUFFER_TSIZE))
+    {
+        if (!uhashtools_io_scheduler_get_unknown_device(io_scheduler, &device_index))
+        {
+            return FALSE;
+        }
+
+        return uhashtools_io_scheduler_add_job(io_scheduler,
+                                               filepath,
+                                               file_size,
+                                               device_index,
+                                               physical_offset);
+    }
+
+    /* The files of a job are usually spread over a few volumes only. */
+    for (volume_index = 0; volume_index < io_scheduler->volumes_count; ++volume_index)
+    {
+        if (_wcsicmp(io_scheduler->volumes[volume_index].volume_path, volume_path) == 0)
+        {
+            break;
+        }
+    }
+
+    if (volume_index == io_scheduler->volumes_count &&
+        !uhashtools_io_scheduler_add_volume(io_scheduler, volume_path, &volume_index))
+    {
+        return FALSE;
+    }
+
+    device_index = io_scheduler->volumes[volume_index].device_index;
+
+    if (io_scheduler->devices[device_index].media_type == IoSchedulerMediaType_SEEK_PENALTY)
+    {
+        physical_offset = uhashtools_io_scheduler_query_physical_offset(filepath, &io_scheduler->volumes[volume_index]);
+    }
+
+    return uhashtools_io_scheduler_add_job(io_scheduler,
+                                           filepath,
+                                           file_size,
+                                           device_index,
+                                           physical_offset);
+}
+
+BOOL
+uhashtools_io_scheduler_add_device
+(
+    struct IoScheduler* io_scheduler,
+    enum IoSchedulerMediaType media_type,
+    size_t* device_index
+)
+{
+    struct IoSchedulerDevice* device = NULL;
+
+    UHASHTOOLS_ASSERT(io_scheduler && !io_scheduler->is_prepared,
+                      L"Internal error: Entered with a NULL or already prepared io_scheduler!");
+    UHASHTOOLS_ASSERT(device_index, L"Internal error: device_index is NULL!");
+
+    if (!uhashtools_io_scheduler_reserve((void**) &io_scheduler->devices,
+                                         &io_scheduler->devices_capacity,
+                                         io_scheduler->devices_count,
+                                         sizeof *io_scheduler->devices))
+    {
+        return FALSE;
+    }
+
+    device = &io_scheduler->devices[io_scheduler->devices_count];
+    (void) memset((void*) device, 0, sizeof *device);
+    device->media_type = media_type;
+
+    *device_index = io_scheduler->devices_count;
+    ++io_scheduler->devices_count;
+
+    return TRUE;
+}
+
+BOOL
+uhashtools_io_scheduler_add_job
+(
+    struct IoScheduler* io_scheduler,
+    const wchar_t* filepath,
+    unsigned __int64 file_size,
+    size_t device_index,
+    unsigned __int64 physical_offset
+)
+{
+    struct IoSchedulerJob* job = NULL;
+    wchar_t* filepath_copy = NULL;
+
+    UHASHTOOLS_ASSERT(io_scheduler && !io_scheduler->is_prepared,
+                      L"Internal error: Entered with a NULL or already prepared io_scheduler!");
+    UHASHTOOLS_ASSERT(filepath, L"Internal error: filepath is NULL!");
+    UHASHTOOLS_ASSERT(device_index < io_scheduler->devices_count, L"Internal error: device_index is out of range!");
+
+    if (!uhashtools_io_scheduler_reserve((void**) &io_scheduler->jobs,
+                                         &io_scheduler->jobs_capacity,
+                                         io_scheduler->jobs_count,
+                                         sizeof *io_scheduler->jobs))
+    {
+        return FALSE;
+    }
+
+    filepath_copy = _wcsdup(filepath);
+
+    if (!filepath_copy)
+    {
+        return FALSE;
+    }
+
+    job = &io_scheduler->jobs[io_scheduler->jobs_count];
+    job->filepath = filepath_copy;
+    job->file_size = file_size;
+    job->device_index = device_index;
+    job->added_index = io_scheduler->jobs_count;
+
+    /* Without a seek penalty the files are read in the order in which they have been added. */
+    if (io_scheduler->devices[device_index].media_type == IoSchedulerMediaType_SEEK_PENALTY)
+    {
+        job->physical_offset = physical_offset;
+    }
+    else
+    {
+        job->physical_offset = IO_SCHEDULER_UNKNOWN_PHYSICAL_OFFSET;
+    }
+
+    ++io_scheduler->jobs_count;
+
+    return TRUE;
+}
+
+size_t
+uhashtools_io_scheduler_prepare
+(
+    struct IoScheduler* io_scheduler
+)
+{
+    size_t job_index = 0;
+    size_t device_index = 0;
+
+    UHASHTOOLS_ASSERT(io_scheduler && !io_scheduler->is_prepared,
+                      L"Internal error: Entered with a NULL or already prepared io_scheduler!");
+
+    io_scheduler->is_prepared = TRUE;
+
+    if (io_scheduler->jobs_count > 1)
+    {
+        qsort((void*) io_scheduler->jobs,
+              io_scheduler->jobs_count,
+              sizeof *io_scheduler->jobs,
+              &uhashtools_io_scheduler_compare_jobs);
+    }
+
+    for (job_index = 0; job_index < io_scheduler->jobs_count; ++job_index)
+    {
+        struct IoSchedulerDevice* device = &io_scheduler->devices[io_scheduler->jobs[job_index].device_index];
+
+        if (device->end_job_index == 0)
+        {
+            device->first_job_index = job_index;
+            device->next_job_index = job_index;
+            device->next_open_job_index = job_index;
+        }
+
+        device->end_job_index = job_index + 1;
+    }
+
+    io_scheduler->readers_count = 0;
+
+    for (device_index = 0; device_index < io_scheduler->devices_count; ++device_index)
+    {
+        struct IoSchedulerDevice* device = &io_scheduler->devices[device_index];
+        const size_t device_jobs_count = device->end_job_index - device->first_job_index;
+
+        device->readers_count = device_jobs_count > 0 ? 1 : 0;
+
+        if (device->media_type == IoSchedulerMediaType_NO_SEEK_PENALTY)
+        {
+            device->readers_count = device_jobs_count < IO_SCHEDULER_SSD_READERS ? device_jobs_count
+                                                                                 : IO_SCHEDULER_SSD_READERS;
+        }
+
+        io_scheduler->readers_count += device->readers_count;
+
+        UHASHTOOLS_PRINTF_LINE_INFO(L"I/O scheduler: Device %Iu has %Iu files and gets %Iu readers.",
+                                    device_index,
+                                    device_jobs_count,
+                                    device->readers_count);
+    }
+
+    return io_scheduler->readers_count;
+}
+
+const struct IoSchedulerJob*
+uhashtools_io_scheduler_take_job
+(
+    struct IoScheduler* io_scheduler,
+    size_t device_index
+)
+{
+    const struct IoSchedulerJob* ret = NULL;
+    struct IoSchedulerDevice* device = NULL;
+
+    UHASHTOOLS_ASSERT(io_scheduler && io_scheduler->is_prepared,
+                      L"Internal error: Entered with a NULL or not prepared io_scheduler!");
+    UHASHTOOLS_ASSERT(device_index < io_scheduler->devices_count, L"Internal error: device_index is out of range!");
+
+    device = &io_scheduler->devices[device_index];
+
+    EnterCriticalSection(&io_scheduler->jobs_lock);
+
+    if (device->next_job_index < device->end_job_index)
+    {
+        ret = &io_scheduler->jobs[device->next_job_index];
+        ++device->next_job_index;
+    }
+
+    LeaveCriticalSection(&io_scheduler->jobs_lock);
+
+    return ret;
+}
+
+BOOL
+uhashtools_io_scheduler_run
+(
+    struct IoScheduler* io_scheduler,
+    IoSchedulerOpenFunction* open_function,
+    IoSchedulerJobFunction* job_function,
+    void* userdata
+)
+{
+    BOOL ret = FALSE;
+    struct IoSchedulerThread* threads = NULL;
+    size_t threads_count = 0;
+    size_t thread_index = 0;
+    size_t device_index = 0;
+    size_t started_threads_count = 0;
+
+    UHASHTOOLS_ASSERT(io_scheduler && io_scheduler->is_prepared,
+                      L"Internal error: Entered with a NULL or not prepared io_scheduler!");
+    UHASHTOOLS_ASSERT(job_function, L"Internal error: job_function is NULL!");
+
+    if (io_scheduler->readers_count == 0)
+    {
+        return TRUE;
+    }
+
+    threads_count = io_scheduler->readers_count;
+
+    if (open_function)
+    {
+        /* One opener thread for each device with files. */
+        for (device_index = 0; device_index < io_scheduler->devices_count; ++device_index)
+        {
+            if (io_scheduler->devices[device_index].readers_count > 0)
+            {
+                ++threads_count;
+            }
+        }
+
+        io_scheduler->opened_jobs = (struct IoSchedulerOpenedJob*) calloc(io_scheduler->jobs_count,
+                                                                          sizeof *io_scheduler->opened_jobs);
+
+        if (!io_scheduler->opened_jobs)
+        {
+            return FALSE;
+        }
+    }
+
+    threads = (struct IoSchedulerThread*) calloc(threads_count, sizeof *threads);
+
+    if (!threads)
+    {
+        return FALSE;
+    }
+
+    io_scheduler->open_function = open_function;
+    io_scheduler->job_function = job_function;
+    io_scheduler->function_userdata = userdata;
+    io_scheduler->is_start_failed = FALSE;
+
+    /* The readers are coming first, so their thread index is their reader index. */
+    for (device_index = 0; device_index < io_scheduler->devices_count; ++device_index)
+    {
+        size_t device_reader_index = 0;
+
+        for (device_reader_index = 0; device_reader_index < io_scheduler->devices[device_index].readers_count; ++device_reader_index)
+        {
+            threads[thread_index].io_scheduler = io_scheduler;
+            threads[thread_index].reader_index = thread_index;
+            threads[thread_index].device_index = device_index;
+            ++thread_index;
+        }
+    }
+
+    for (device_index = 0; open_function && device_index < io_scheduler->devices_count; ++device_index)
+    {
+        if (io_scheduler->devices[device_index].readers_count > 0)
+        {
+            threads[thread_index].io_scheduler = io_scheduler;
+            threads[thread_index].is_opener = TRUE;
+            threads[thread_index].device_index = device_index;
+            ++thread_index;
+        }
+    }
+
+    /* The threads are started suspended, so either all of them or none are processing files. */
+    for (thread_index = 0; thread_index < threads_count; ++thread_index)
+    {
+        unsigned int thread_id = 0;
+        uintptr_t thread_handle = 0;
+
+        if (threads[thread_index].is_opener)
+        {
+            thread_handle = _beginthreadex(NULL,
+                                           IO_SCHEDULER_OPENER_THREAD_STACK_SIZE,
+                                           uhashtools_io_scheduler_opener_thread_function,
+                                           (void*) &threads[thread_index],
+                                           CREATE_SUSPENDED,
+                                           &thread_id);
+        }
+        else
+        {
+            thread_handle = _beginthreadex(NULL,
+                                           IO_SCHEDULER_READER_THREAD_STACK_SIZE,
+                                           uhashtools_io_scheduler_reader_thread_function,
+                                           (void*) &threads[thread_index],
+                                           CREATE_SUSPENDED,
+                                           &thread_id);
+        }
+
+        if (thread_handle == 0)
+        {
+            io_scheduler->is_start_failed = TRUE;
+            break;
+        }
+
+        threads[thread_index].thread_handle = (HANDLE) thread_handle;
+        ++started_threads_count;
+    }
+
+    for (thread_index = 0; thread_index < started_threads_count; ++thread_index)
+    {
+        (void) ResumeThread(threads[thread_index].thread_handle);
+    }
+
+    for (thread_index = 0; thread_index < started_threads_count; ++thread_index)
+    {
+        DWORD wait_rc = WaitForSingleObject(threads[thread_index].thread_handle, INFINITE);
+
+        UHASHTOOLS_ASSERT(wait_rc == WAIT_OBJECT_0, L"Internal error: Failed to wait for an I/O scheduler thread!");
+
+        (void) CloseHandle(threads[thread_index].thread_handle);
+    }
+
+    ret = !io_scheduler->is_start_failed;
+
+    free((void*) threads);
+
+    return ret;
+}
+
+void
+uhashtools_io_scheduler_destroy
+(
+    struct IoScheduler* io_scheduler
+)
+{
+    size_t index = 0;
+
+    if (!io_scheduler)
+    {
+        return;
+    }
+
+    for (index = 0; index < io_scheduler->jobs_count; ++index)
+    {
+        free((void*) io_scheduler->jobs[index].filepath);
+    }
+
+    for (index = 0; index < io_scheduler->volumes_count; ++index)
+    {
+        free((void*) io_scheduler->volumes[index].volume_path);
+    }
+
+    DeleteCriticalSection(&io_scheduler->jobs_lock);
+    free((void*) io_scheduler->opened_jobs);
+    free((void*) io_scheduler->jobs);
+    free((void*) io_scheduler->devices);
+    free((void*) io_scheduler->volumes);
+    free((void*) io_scheduler);
+}
@@ -0,0 +1,247 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+#include <limits.h>
+
+/*
+ * The I/O scheduler distributes the files of a multi-file job over
+ * reader threads depending on the physical device which stores them.
+ * Reading multiple files in parallel from a hard disk lets its heads
+ * jump between the files, while SSDs need multiple readers to reach
+ * their throughput. Therefore:
+ * 
+ * - The files are grouped by their physical device (disk number).
+ *   Volumes on the same disk are sharing one group.
+ * - Devices with a seek penalty (hard disks and optical drives) get
+ *   a single reader. Their files are read in the order of their
+ *   physical position on the disk, as far as the file system reports
+ *   it. Devices with an unknown media type get a single reader too.
+ * - SSDs get IO_SCHEDULER_SSD_READERS readers and their files are
+ *   read in the order in which they have been added.
+ * 
+ * Every device has its own readers, so files on different devices
+ * are always read in parallel.
+ * 
+ * Opening a file on a network share can take tens of milliseconds. If
+ * an open function is passed to "uhashtools_io_scheduler_run()", every
+ * device gets an additional opener thread which opens up to
+ * IO_SCHEDULER_OPEN_AHEAD_FILES files ahead of its readers, so the
+ * readers find the next file already opened. A reader which catches up
+ * with the opener opens the next file itself.
+ */
+
+/* Amount of reader threads for a device without a seek penalty. */
+#define IO_SCHEDULER_SSD_READERS 4
+
+/* Maximum amount of opened files per device which are waiting for a reader. */
+#define IO_SCHEDULER_OPEN_AHEAD_FILES 4
+
+/* Physical offset of files whose position on the disk is unknown. They are read last. */
+#define IO_SCHEDULER_UNKNOWN_PHYSICAL_OFFSET _UI64_MAX
+
+enum IoSchedulerMediaType
+{
+    IoSchedulerMediaType_UNKNOWN,
+    IoSchedulerMediaType_SEEK_PENALTY,
+    IoSchedulerMediaType_NO_SEEK_PENALTY
+};
+
+struct IoSchedulerJob
+{
+    wchar_t* filepath;
+    unsigned __int64 file_size;
+    size_t device_index;
+
+    /* Offset on the physical device or IO_SCHEDULER_UNKNOWN_PHYSICAL_OFFSET. */
+    unsigned __int64 physical_offset;
+
+    /* Position in the order of "uhashtools_io_scheduler_add_*()" calls. */
+    size_t added_index;
+};
+
+/**
+ * Called for each file before it is passed to "IoSchedulerJobFunction".
+ * It's called by the opener thread of the device or by a reader thread.
+ * 
+ * @param job Scheduled file.
+ * @param userdata Userdata which has been passed to "uhashtools_io_scheduler_run()".
+ * 
+ * @return Opened file data which is passed to "IoSchedulerJobFunction". The
+ *         job function is responsible for releasing it.
+ */
+typedef void* IoSchedulerOpenFunction(const struct IoSchedulerJob* job, void* userdata);
+
+/**
+ * Called by the reader threads for each file.
+ * 
+ * @param job Scheduled file.
+ * @param opened_data Data returned by the "IoSchedulerOpenFunction" for this
+ *                    job or NULL if no open function has been passed to
+ *                    "uhashtools_io_scheduler_run()".
+ * @param reader_index Index of the calling reader thread. It's smaller than
+ *                     the amount returned by "uhashtools_io_scheduler_prepare()",
+ *                     so it can be used to access data owned by this reader.
+ * @param userdata Userdata which has been passed to "uhashtools_io_scheduler_run()".
+ */
+typedef void IoSchedulerJobFunction(const struct IoSchedulerJob* job, void* opened_data, size_t reader_index, void* userdata);
+
+/**
+ * I/O scheduler. Must be destroyed with "uhashtools_io_scheduler_destroy()".
+ */
+struct IoScheduler;
+
+/**
+ * @return New empty scheduler or NULL if the memory allocation failed.
+ */
+extern
+struct IoScheduler*
+uhashtools_io_scheduler_create
+(
+    void
+);
+
+/**
+ * Adds a file. Its device, the media type of the device and for devices
+ * with a seek penalty its physical position are queried from the system.
+ * Files whose device can't be determined are assigned to a shared device
+ * with an unknown media type.
+ * 
+ * @param io_scheduler Scheduler which hasn't been prepared yet.
+ * @param filepath Path of the file. It's copied by the scheduler.
+ * @param file_size Size of the file in bytes.
+ * 
+ * @return TRUE on success or FALSE if the memory allocation failed.
+ */
+extern
+BOOL
+uhashtools_io_scheduler_add_file
+(
+    struct IoScheduler* io_scheduler,
+    const wchar_t* filepath,
+    unsigned __int64 file_size
+);
+
+/**
+ * Adds a device without querying the system. Together with
+ * "uhashtools_io_scheduler_add_job()" this allows to run the scheduling
+ * policy with simulated devices.
+ * 
+ * @param io_scheduler Scheduler which hasn't been prepared yet.
+ * @param media_type Media type of the device.
+ * @param device_index Receives the index of the new device.
+ * 
+ * @return TRUE on success or FALSE if the memory allocation failed.
+ */
+extern
+BOOL
+uhashtools_io_scheduler_add_device
+(
+    struct IoScheduler* io_scheduler,
+    enum IoSchedulerMediaType media_type,
+    size_t* device_index
+);
+
+/**
+ * Adds a file on a known device without querying the system.
+ * 
+ * @param io_scheduler Scheduler which hasn't been prepared yet.
+ * @param filepath Path of the file. It's copied by the scheduler.
+ * @param file_size Size of the file in bytes.
+ * @param device_index Index returned by "uhashtools_io_scheduler_add_device()".
+ * @param physical_offset Offset of the file on the device or
+ *                        IO_SCHEDULER_UNKNOWN_PHYSICAL_OFFSET. It's only used
+ *                        for devices with a seek penalty.
+ * 
+ * @return TRUE on success or FALSE if the memory allocation failed.
+ */
+extern
+BOOL
+uhashtools_io_scheduler_add_job
+(
+    struct IoScheduler* io_scheduler,
+    const wchar_t* filepath,
+    unsigned __int64 file_size,
+    size_t device_index,
+    unsigned __int64 physical_offset
+);
+
+/**
+ * Orders the added files and assigns the readers to the devices. No
+ * files can be added after this call.
+ * 
+ * @param io_scheduler Scheduler with the added files.
+ * 
+ * @return Amount of reader threads which will be used by
+ *         "uhashtools_io_scheduler_run()". Zero if no files have been added.
+ */
+extern
+size_t
+uhashtools_io_scheduler_prepare
+(
+    struct IoScheduler* io_scheduler
+);
+
+/**
+ * Takes the next file of a device. This is the part of the policy which
+ * runs in the reader threads of "uhashtools_io_scheduler_run()" if no
+ * open function is used.
+ * 
+ * @param io_scheduler Prepared scheduler.
+ * @param device_index Device of the reader.
+ * 
+ * @return The next job of the device or NULL if all of its files are taken.
+ */
+extern
+const struct IoSchedulerJob*
+uhashtools_io_scheduler_take_job
+(
+    struct IoScheduler* io_scheduler,
+    size_t device_index
+);
+
+/**
+ * Runs "job_function" for every added file within the reader threads
+ * and waits until all files have been processed.
+ * 
+ * @param io_scheduler Prepared scheduler.
+ * @param open_function Function which opens a single file ahead of the
+ *                      readers or NULL if the job function opens the files
+ *                      itself. It's called from multiple threads at the
+ *                      same time.
+ * @param job_function Function which processes a single file. It's called
+ *                     from multiple threads at the same time.
+ * @param userdata Userdata which is passed to "job_function".
+ * 
+ * @return TRUE on success or FALSE if the reader threads couldn't be
+ *         started. In this case no file has been processed.
+ */
+extern
+BOOL
+uhashtools_io_scheduler_run
+(
+    struct IoScheduler* io_scheduler,
+    IoSchedulerOpenFunction* open_function,
+    IoSchedulerJobFunction* job_function,
+    void* userdata
+);
+
+/**
+ * Destroys the scheduler. Passing NULL is allowed.
+ * 
+ * @param io_scheduler Scheduler to destroy.
+ */
+extern
+void
+uhashtools_io_scheduler_destroy
+(
+    struct IoScheduler* io_scheduler
+);
@@ -0,0 +1,374 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "known_mode.h"
+
+#include "buffer_sizes.h"
+#include "directory_walker.h"
+#include "error_utilities.h"
+#include "file_source.h"
+#include "hash_calculation_impl.h"
+#include "io_scheduler.h"
+#include "known_set.h"
+#include "print_utilities.h"
+#include "product.h"
+#include "std_streams.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Buffers and counters owned by a single reader thread of the I/O scheduler. */
+struct KnownModeReaderCtx
+{
+    unsigned char* file_read_buf;
+    wchar_t* result_string_buf;
+    BOOL had_errors;
+    unsigned __int64 known_files_count;
+    unsigned __int64 unknown_files_count;
+};
+
+/* File which has been opened ahead of its reader by "uhashtools_known_mode_open_file()". */
+struct KnownModeOpenedFile
+{
+    struct FileSource file_source;
+    wchar_t error_message[HASH_RESULT_BUFFER_TSIZE];
+};
+
+struct KnownModeCheckCtx
+{
+    const struct KnownSet* known_set;
+    struct IoScheduler* io_scheduler;
+    BOOL is_out_of_memory;
+    struct KnownModeReaderCtx* readers;
+    size_t readers_count;
+};
+
+static
+int
+uhashtools_known_mode_build
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    wchar_t error_message_buf[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    unsigned __int64 added_digests_count = 0;
+    unsigned __int64 skipped_lines_count = 0;
+
+    error_message_buf[0] = L'\0';
+
+    if (!uhashtools_known_set_build(error_message_buf,
+                                    GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                    cli_arguments->known_set_digest_list,
+                                    cli_arguments->known_set_file,
+                                    uhashtools_product_get_builtin_hasher_digest_size(),
+                                    &added_digests_count,
+                                    &skipped_lines_count))
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", cli_arguments->known_set_file, error_message_buf);
+
+        return 1;
+    }
+
+    (void) wprintf_s(L"# %I64u digests added, %I64u lines without digest skipped\n",
+                     added_digests_count,
+                     skipped_lines_count);
+
+    (void) fflush(stdout);
+
+    return 0;
+}
+
+/* Collects the files for "uhashtools_directory_walker_walk()". */
+static
+BOOL
+uhashtools_known_mode_on_file_found
+(
+    const wchar_t* filepath,
+    unsigned __int64 file_size,
+    void* userdata
+)
+{
+    struct KnownModeCheckCtx* ctx = (struct KnownModeCheckCtx*) userdata;
+
+    if (!uhashtools_io_scheduler_add_file(ctx->io_scheduler, filepath, file_size))
+    {
+        ctx->is_out_of_memory = TRUE;
+
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Opens the files for "uhashtools_io_scheduler_run()" while the readers
+ * are still hashing the previous files. Returns NULL if the memory
+ * allocation failed, in which case the reader opens the file itself.
+ */
+static
+void*
+uhashtools_known_mode_open_file
+(
+    const struct IoSchedulerJob* job,
+    void* userdata
+)
+{
+    struct KnownModeOpenedFile* opened_file = NULL;
+
+    UNREFERENCED_PARAMETER(userdata);
+
+    opened_file = (struct KnownModeOpenedFile*) malloc(sizeof *opened_file);
+
+    if (!opened_file)
+    {
+        return NULL;
+    }
+
+    opened_file->error_message[0] = L'\0';
+    opened_file->file_source = uhashtools_file_source_open(opened_file->error_message,
+                                                           HASH_RESULT_BUFFER_TSIZE,
+                                                           job->filepath);
+
+    return (void*) opened_file;
+}
+
+/* Hashes and checks the files for "uhashtools_io_scheduler_run()". */
+static
+void
+uhashtools_known_mode_check_file
+(
+    const struct IoSchedulerJob* job,
+    void* opened_data,
+    size_t reader_index,
+    void* userdata
+)
+{
+    struct KnownModeCheckCtx* ctx = (struct KnownModeCheckCtx*) userdata;
+    struct KnownModeReaderCtx* reader = &ctx->readers[reader_index];
+    struct KnownModeOpenedFile* opened_file = (struct KnownModeOpenedFile*) opened_data;
+    enum HashCalculatorResultCode hash_rc = HashCalculatorResultCode_FAILED;
+    struct HashDigest calculated_digest;
+    BOOL is_known = FALSE;
+
+    if (!opened_file)
+    {
+        hash_rc = uhashtools_hash_calculator_impl_hash_file_to_digest(reader->file_read_buf,
+                                                                      FILE_READ_BUF_TSIZE,
+                                                                      &calculated_digest,
+                                                                      reader->result_string_buf,
+                                                                      HASH_RESULT_BUFFER_TSIZE,
+                                                                      job->filepath,
+                                                                      NULL,
+                                                                      NULL,
+                                                                      NULL,
+                                                                      NULL);
+    }
+    else if (!opened_file->file_source.is_ok)
+    {
+        (void) wcscpy_s(reader->result_string_buf, HASH_RESULT_BUFFER_TSIZE, opened_file->error_message);
+    }
+    else
+    {
+        hash_rc = uhashtools_hash_calculator_impl_hash_file_source_to_digest(reader->file_read_buf,
+                                                                             FILE_READ_BUF_TSIZE,
+                                                                             &calculated_digest,
+                                                                             reader->result_string_buf,
+                                                                             HASH_RESULT_BUFFER_TSIZE,
+                                                                             &opened_file->file_source,
+                                                                             NULL,
+                                                                             NULL,
+                                                                             NULL,
+                                                                             NULL);
+
+        uhashtools_file_source_close(&opened_file->file_source);
+    }
+
+    if (opened_file)
+    {
+        free((void*) opened_file);
+    }
+
+    if (hash_rc != HashCalculatorResultCode_SUCCESS)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", job->filepath, reader->result_string_buf);
+        reader->had_errors = TRUE;
+
+        return;
+    }
+
+    is_known = uhashtools_known_set_contains(ctx->known_set, calculated_digest.bytes);
+
+    /* The hex encoding is only needed for the output line. */
+    (void) uhashtools_hash_calculator_impl_digest_to_hex(&calculated_digest,
+                                                         reader->result_string_buf,
+                                                         HASH_RESULT_BUFFER_TSIZE);
+
+    if (is_known)
+    {
+        ++reader->known_files_count;
+    }
+    else
+    {
+        ++reader->unknown_files_count;
+    }
+
+    (void) wprintf_s(L"%s %s *%s\n", is_known ? L"KNOWN" : L"UNKNOWN", reader->result_string_buf, job->filepath);
+}
+
+static
+int
+uhashtools_known_mode_check
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    int ret = 1;
+    struct KnownModeCheckCtx ctx;
+    struct KnownSet* known_set = NULL;
+    wchar_t error_message_buf[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    BOOL had_errors = FALSE;
+    unsigned __int64 known_files_count = 0;
+    unsigned __int64 unknown_files_count = 0;
+    size_t reader_index = 0;
+
+    (void) memset((void*) &ctx, 0, sizeof ctx);
+    error_message_buf[0] = L'\0';
+
+    known_set = uhashtools_known_set_open(error_message_buf,
+                                          GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                          cli_arguments->known_set_file,
+                                          uhashtools_product_get_builtin_hasher_digest_size());
+
+    if (!known_set)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", cli_arguments->known_set_file, error_message_buf);
+
+        goto cleanup_and_out;
+    }
+
+    UHASHTOOLS_PRINTF_LINE_INFO(L"Known mode: Opened a known set with %I64u digests.",
+                                uhashtools_known_set_get_digests_count(known_set));
+
+    ctx.known_set = known_set;
+    ctx.io_scheduler = uhashtools_io_scheduler_create();
+
+    if (!ctx.io_scheduler)
+    {
+        (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+        goto cleanup_and_out;
+    }
+
+    /* All files are collected first, so the scheduler can order them by their device. */
+    (void) uhashtools_directory_walker_walk(cli_arguments->known_set_directory,
+                                            &uhashtools_known_mode_on_file_found,
+                                            (void*) &ctx,
+                                            &had_errors);
+
+    if (ctx.is_out_of_memory)
+    {
+        (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+        goto cleanup_and_out;
+    }
+
+    ctx.readers_count = uhashtools_io_scheduler_prepare(ctx.io_scheduler);
+
+    if (ctx.readers_count > 0)
+    {
+        ctx.readers = (struct KnownModeReaderCtx*) calloc(ctx.readers_count, sizeof *ctx.readers);
+
+        if (!ctx.readers)
+        {
+            (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+            goto cleanup_and_out;
+        }
+    }
+
+    for (reader_index = 0; reader_index < ctx.readers_count; ++reader_index)
+    {
+        struct KnownModeReaderCtx* reader = &ctx.readers[reader_index];
+
+        reader->file_read_buf = (unsigned char*) malloc(FILE_READ_BUF_TSIZE);
+        reader->result_string_buf = (wchar_t*) malloc(HASH_RESULT_BUFFER_TSIZE * sizeof *reader->result_string_buf);
+
+        if (!reader->file_read_buf || !reader->result_string_buf)
+        {
+            (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+            goto cleanup_and_out;
+        }
+    }
+
+    if (!uhashtools_io_scheduler_run(ctx.io_scheduler,
+                                     &uhashtools_known_mode_open_file,
+                                     &uhashtools_known_mode_check_file,
+                                     (void*) &ctx))
+    {
+        (void) fwprintf_s(stderr, L"Failed to start the reader threads!\n");
+
+        goto cleanup_and_out;
+    }
+
+    for (reader_index = 0; reader_index < ctx.readers_count; ++reader_index)
+    {
+        had_errors |= ctx.readers[reader_index].had_errors;
+        known_files_count += ctx.readers[reader_index].known_files_count;
+        unknown_files_count += ctx.readers[reader_index].unknown_files_count;
+    }
+
+    (void) wprintf_s(L"# %I64u known files, %I64u unknown files\n",
+                     known_files_count,
+                     unknown_files_count);
+
+    (void) fflush(stdout);
+
+    if (!had_errors)
+    {
+        ret = 0;
+    }
+
+cleanup_and_out:
+    if (ctx.readers)
+    {
+        for (reader_index = 0; reader_index < ctx.readers_count; ++reader_index)
+        {
+            free((void*) ctx.readers[reader_index].result_string_buf);
+            free((void*) ctx.readers[reader_index].file_read_buf);
+        }
+
+        free((void*) ctx.readers);
+    }
+
+    uhashtools_io_scheduler_destroy(ctx.io_scheduler);
+    uhashtools_known_set_close(known_set);
+
+    return ret;
+}
+
+int
+uhashtools_known_mode_run
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
+    UHASHTOOLS_ASSERT(uhashtools_cli_arguments_has_known_set_file(cli_arguments),
+                      L"Internal error: Entered known mode without a known set file!");
+
+    uhashtools_std_streams_connect();
+
+    if (cli_arguments->known_set_digest_list[0] != L'\0')
+    {
+        return uhashtools_known_mode_build(cli_arguments);
+    }
+
+    return uhashtools_known_mode_check(cli_arguments);
+}
@@ -0,0 +1,39 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "cli_arguments.h"
+
+/*
+ * The known mode has two variants, both without creating a window:
+ * 
+ * "--build-known-set <digest list> <known set>" converts a text file
+ * with digests of the hash algorithm of the product into a known set
+ * file (see "known_set.h").
+ * 
+ * "--known-set <known set> <directory>" hashes every file of the
+ * directory tree and looks its digest up in the known set. Each result
+ * is written to stdout as a line "KNOWN <hash> *<filepath>" or
+ * "UNKNOWN <hash> *<filepath>".
+ */
+
+/**
+ * Runs the known mode variant selected by the command line arguments.
+ * 
+ * @param cli_arguments Command line arguments with a set known set file.
+ * 
+ * @return Exit code of the process. Zero if the set has been built or if
+ *         all files have been checked successfully else one.
+ */
+extern
+int
+uhashtools_known_mode_run
+(
+    const struct CliArguments* cli_arguments
+);
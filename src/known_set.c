@@ -0,0 +1,764 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "known_set.h"
+
+#include "error_utilities.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define KNOWN_SET_MAGIC "UHKNSET1"
+#define KNOWN_SET_MAGIC_SIZE 8
+
+/* The largest digest of all products (SHA-512, SHA3-512 and BLAKE2b). */
+#define KNOWN_SET_MAX_DIGEST_SIZE 64
+
+/*
+ * Each digest sets KNOWN_SET_BLOOM_HASH_COUNT bits within one block of
+ * the Bloom filter, so every lookup reads exactly one cache line. With
+ * at least 10 bits per digest the false positive rate stays around 1%.
+ */
+#define KNOWN_SET_BLOOM_BLOCK_SIZE 64
+#define KNOWN_SET_BLOOM_BLOCK_BITS (KNOWN_SET_BLOOM_BLOCK_SIZE * 8)
+#define KNOWN_SET_BLOOM_HASH_COUNT 7
+#define KNOWN_SET_BLOOM_BITS_PER_DIGEST 10
+
+/* The table is sized to a load factor between 35% and 70%. */
+#define KNOWN_SET_MIN_SLOT_COUNT 16
+
+#define KNOWN_SET_DIGEST_LIST_LINE_TSIZE 1024
+#define KNOWN_SET_DIGESTS_INITIAL_CAPACITY 4096
+
+struct KnownSetFileHeader
+{
+    char magic[KNOWN_SET_MAGIC_SIZE];
+    unsigned int digest_size;
+    unsigned int contains_zero_digest;
+    unsigned __int64 digests_count;
+    unsigned __int64 slot_count;
+    unsigned __int64 bloom_block_count;
+    unsigned char reserved[24];
+};
+
+struct KnownSet
+{
+    HANDLE file_handle;
+    HANDLE file_mapping_handle;
+    const unsigned char* file_view;
+
+    size_t digest_size;
+    BOOL contains_zero_digest;
+    unsigned __int64 digests_count;
+    const unsigned char* slots;
+    size_t slot_mask;
+    const unsigned char* bloom_blocks;
+    size_t bloom_block_mask;
+};
+
+/* Finalizer of SplitMix64, which spreads every input bit over the whole result. */
+static
+__forceinline
+unsigned __int64
+uhashtools_known_set_mix
+(
+    unsigned __int64 value
+)
+{
+    value ^= value >> 30;
+    value *= 0xBF58476D1CE4E5B9ULL;
+    value ^= value >> 27;
+    value *= 0x94D049BB133111EBULL;
+    value ^= value >> 31;
+
+    return value;
+}
+
+/*
+ * Calculates the hash for the table slot and the hash for the Bloom
+ * filter. The digests are already well distributed, but the digests of
+ * the short checksums (CRC-32C) don't fill a 64 bit hash on their own.
+ */
+static
+void
+uhashtools_known_set_hash_digest
+(
+    const unsigned char* digest,
+    size_t digest_size,
+    unsigned __int64* slot_hash,
+    unsigned __int64* bloom_hash
+)
+{
+    unsigned __int64 key = 0;
+    size_t i = 0;
+
+    for (i = 0; i < digest_size; ++i)
+    {
+        key ^= (unsigned __int64) digest[i] << ((i % 8) * 8);
+
+        if (i % 8 == 7)
+        {
+            key = uhashtools_known_set_mix(key);
+        }
+    }
+
+    *slot_hash = uhashtools_known_set_mix(key + 0x9E3779B97F4A7C15ULL);
+    *bloom_hash = uhashtools_known_set_mix(*slot_hash ^ key);
+}
+
+/*
+ * The Bloom hash is split into KNOWN_SET_BLOOM_HASH_COUNT bit positions
+ * of 9 bit within the block. The block itself is selected by the upper
+ * half of the slot hash, whose lower half selects the table slot.
+ */
+static
+__forceinline
+unsigned int
+uhashtools_known_set_bloom_bit
+(
+    unsigned __int64 bloom_hash,
+    size_t hash_index
+)
+{
+    return (unsigned int) (bloom_hash >> (hash_index * 9)) & (KNOWN_SET_BLOOM_BLOCK_BITS - 1);
+}
+
+static
+void
+uhashtools_known_set_bloom_add
+(
+    unsigned char* bloom_blocks,
+    size_t bloom_block_mask,
+    unsigned __int64 slot_hash,
+    unsigned __int64 bloom_hash
+)
+{
+    unsigned char* block = bloom_blocks + ((size_t) (slot_hash >> 32) & bloom_block_mask) * KNOWN_SET_BLOOM_BLOCK_SIZE;
+    size_t i = 0;
+
+    for (i = 0; i < KNOWN_SET_BLOOM_HASH_COUNT; ++i)
+    {
+        const unsigned int bit = uhashtools_known_set_bloom_bit(bloom_hash, i);
+
+        block[bit / 8] |= (unsigned char) (1 << (bit % 8));
+    }
+}
+
+static
+BOOL
+uhashtools_known_set_bloom_may_contain
+(
+    const unsigned char* bloom_blocks,
+    size_t bloom_block_mask,
+    unsigned __int64 slot_hash,
+    unsigned __int64 bloom_hash
+)
+{
+    const unsigned char* block = bloom_blocks + ((size_t) (slot_hash >> 32) & bloom_block_mask) * KNOWN_SET_BLOOM_BLOCK_SIZE;
+    size_t i = 0;
+
+    for (i = 0; i < KNOWN_SET_BLOOM_HASH_COUNT; ++i)
+    {
+        const unsigned int bit = uhashtools_known_set_bloom_bit(bloom_hash, i);
+
+        if (!(block[bit / 8] & (1 << (bit % 8))))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_known_set_is_zero_digest
+(
+    const unsigned char* digest,
+    size_t digest_size
+)
+{
+    size_t i = 0;
+
+    for (i = 0; i < digest_size; ++i)
+    {
+        if (digest[i] != 0)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static
+int
+uhashtools_known_set_hex_char_value
+(
+    char hex_char
+)
+{
+    if (hex_char >= '0' && hex_char <= '9')
+    {
+        return hex_char - '0';
+    }
+
+    if (hex_char >= 'a' && hex_char <= 'f')
+    {
+        return hex_char - 'a' + 10;
+    }
+
+    if (hex_char >= 'A' && hex_char <= 'F')
+    {
+        return hex_char - 'A' + 10;
+    }
+
+    return -1;
+}
+
+/*
+ * Parses the digest at the start of a line of the digest list. The hex
+ * digits must not continue after the digest, so digests of longer hash
+ * algorithms aren't accepted partially.
+ */
+static
+BOOL
+uhashtools_known_set_parse_digest_list_line
+(
+    const char* line,
+    size_t digest_size,
+    unsigned char* digest
+)
+{
+    size_t i = 0;
+
+    while (*line == ' ' || *line == '\t')
+    {
+        ++line;
+    }
+
+    if (*line == '"')
+    {
+        ++line;
+    }
+
+    /* The terminator isn't a hex digit, so a short line stops the decoding. */
+    for (i = 0; i < digest_size; ++i)
+    {
+        const int upper_value = uhashtools_known_set_hex_char_value(line[i * 2]);
+        const int lower_value = upper_value < 0 ? -1 : uhashtools_known_set_hex_char_value(line[i * 2 + 1]);
+
+        if (lower_value < 0)
+        {
+            return FALSE;
+        }
+
+        digest[i] = (unsigned char) ((upper_value << 4) | lower_value);
+    }
+
+    return uhashtools_known_set_hex_char_value(line[digest_size * 2]) < 0;
+}
+
+static
+size_t
+uhashtools_known_set_round_up_to_power_of_two
+(
+    unsigned __int64 value,
+    size_t minimum
+)
+{
+    size_t ret = minimum;
+
+    while ((unsigned __int64) ret < value)
+    {
+        ret *= 2;
+    }
+
+    return ret;
+}
+
+/*
+ * Inserts a digest into the table and the Bloom filter.
+ * 
+ * @return FALSE if the digest was already part of the table.
+ */
+static
+BOOL
+uhashtools_known_set_insert
+(
+    unsigned char* slots,
+    size_t slot_mask,
+    unsigned char* bloom_blocks,
+    size_t bloom_block_mask,
+    const unsigned char* digest,
+    size_t digest_size
+)
+{
+    unsigned __int64 slot_hash = 0;
+    unsigned __int64 bloom_hash = 0;
+    size_t slot_index = 0;
+
+    uhashtools_known_set_hash_digest(digest, digest_size, &slot_hash, &bloom_hash);
+
+    for (slot_index = (size_t) slot_hash & slot_mask; ; slot_index = (slot_index + 1) & slot_mask)
+    {
+        unsigned char* slot = slots + slot_index * digest_size;
+
+        if (uhashtools_known_set_is_zero_digest(slot, digest_size))
+        {
+            (void) memcpy((void*) slot, (const void*) digest, digest_size);
+            uhashtools_known_set_bloom_add(bloom_blocks, bloom_block_mask, slot_hash, bloom_hash);
+
+            return TRUE;
+        }
+
+        if (memcmp((const void*) slot, (const void*) digest, digest_size) == 0)
+        {
+            return FALSE;
+        }
+    }
+}
+
+BOOL
+uhashtools_known_set_build
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* digest_list_file,
+    const wchar_t* known_set_file,
+    size_t digest_size,
+    unsigned __int64* added_digests_count,
+    unsigned __int64* skipped_lines_count
+)
+{
+    BOOL ret = FALSE;
+    FILE* digest_list_handle = NULL;
+    FILE* known_set_handle = NULL;
+    char line[KNOWN_SET_DIGEST_LIST_LINE_TSIZE];
+    unsigned char* digests = NULL;
+    size_t digests_count = 0;
+    size_t digests_capacity = 0;
+    unsigned char* slots = NULL;
+    unsigned char* bloom_blocks = NULL;
+    size_t slot_count = 0;
+    size_t bloom_block_count = 0;
+    struct KnownSetFileHeader header;
+    size_t i = 0;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(digest_size > 0 && digest_size <= KNOWN_SET_MAX_DIGEST_SIZE,
+                      L"Internal error: Unsupported digest size!");
+
+    (void) memset((void*) &header, 0, sizeof header);
+    *added_digests_count = 0;
+    *skipped_lines_count = 0;
+
+    if (_wfopen_s(&digest_list_handle, digest_list_file, L"rb") != 0 || !digest_list_handle)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to open the digest list!");
+
+        goto cleanup_and_out;
+    }
+
+    while (fgets(line, KNOWN_SET_DIGEST_LIST_LINE_TSIZE, digest_list_handle))
+    {
+        const size_t line_len = strlen(line);
+        unsigned char digest[KNOWN_SET_MAX_DIGEST_SIZE];
+
+        /* The rest of an overlong line doesn't contain a digest. */
+        if (line_len > 0 && line[line_len - 1] != '\n')
+        {
+            int skipped_char = 0;
+
+            do
+            {
+                skipped_char = fgetc(digest_list_handle);
+            }
+            while (skipped_char != EOF && skipped_char != '\n');
+        }
+
+        if (!uhashtools_known_set_parse_digest_list_line(line, digest_size, digest))
+        {
+            ++*skipped_lines_count;
+            continue;
+        }
+
+        if (uhashtools_known_set_is_zero_digest(digest, digest_size))
+        {
+            header.contains_zero_digest = TRUE;
+            continue;
+        }
+
+        if (digests_count == digests_capacity)
+        {
+            const size_t new_capacity = digests_capacity ? digests_capacity * 2 : KNOWN_SET_DIGESTS_INITIAL_CAPACITY;
+            unsigned char* new_digests = NULL;
+
+            if (new_capacity > ((size_t) -1) / digest_size / 2)
+            {
+                (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The digest list contains too many digests!");
+
+                goto cleanup_and_out;
+            }
+
+            new_digests = (unsigned char*) realloc((void*) digests, new_capacity * digest_size);
+
+            if (!new_digests)
+            {
+                (void) wcscpy_s(error_message_buf,
+                                error_message_buf_tsize,
+                                L"Failed to allocate the required memory. Please download more RAM!");
+
+                goto cleanup_and_out;
+            }
+
+            digests = new_digests;
+            digests_capacity = new_capacity;
+        }
+
+        (void) memcpy((void*) (digests + digests_count * digest_size), (const void*) digest, digest_size);
+        ++digests_count;
+    }
+
+    if (ferror(digest_list_handle))
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to read the digest list!");
+
+        goto cleanup_and_out;
+    }
+
+    /* The capacity check above ensures that these sizes can't overflow. */
+    slot_count = uhashtools_known_set_round_up_to_power_of_two(((unsigned __int64) digests_count * 10 + 6) / 7,
+                                                               KNOWN_SET_MIN_SLOT_COUNT);
+    bloom_block_count = uhashtools_known_set_round_up_to_power_of_two(((unsigned __int64) digests_count * KNOWN_SET_BLOOM_BITS_PER_DIGEST +
+                                                                       KNOWN_SET_BLOOM_BLOCK_BITS - 1) / KNOWN_SET_BLOOM_BLOCK_BITS,
+                                                                      1);
+
+    slots = (unsigned char*) calloc(slot_count, digest_size);
+    bloom_blocks = (unsigned char*) calloc(bloom_block_count, KNOWN_SET_BLOOM_BLOCK_SIZE);
+
+    if (!slots || !bloom_blocks)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+
+        goto cleanup_and_out;
+    }
+
+    for (i = 0; i < digests_count; ++i)
+    {
+        if (uhashtools_known_set_insert(slots,
+                                        slot_count - 1,
+                                        bloom_blocks,
+                                        bloom_block_count - 1,
+                                        digests + i * digest_size,
+                                        digest_size))
+        {
+            ++header.digests_count;
+        }
+    }
+
+    (void) memcpy((void*) header.magic, (const void*) KNOWN_SET_MAGIC, KNOWN_SET_MAGIC_SIZE);
+    header.digest_size = (unsigned int) digest_size;
+    header.digests_count += header.contains_zero_digest ? 1 : 0;
+    header.slot_count = slot_count;
+    header.bloom_block_count = bloom_block_count;
+
+    if (_wfopen_s(&known_set_handle, known_set_file, L"wb") != 0 || !known_set_handle)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to create the known set file!");
+
+        goto cleanup_and_out;
+    }
+
+    if (fwrite((const void*) &header, sizeof header, 1, known_set_handle) != 1 ||
+        fwrite((const void*) bloom_blocks, KNOWN_SET_BLOOM_BLOCK_SIZE, bloom_block_count, known_set_handle) != bloom_block_count ||
+        fwrite((const void*) slots, digest_size, slot_count, known_set_handle) != slot_count)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to write the known set file!");
+
+        goto cleanup_and_out;
+    }
+
+    if (fclose(known_set_handle) != 0)
+    {
+        known_set_handle = NULL;
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to write the known set file!");
+
+        goto cleanup_and_out;
+    }
+
+    known_set_handle = NULL;
+    *added_digests_count = header.digests_count;
+    ret = TRUE;
+
+cleanup_and_out:
+    if (known_set_handle)
+    {
+        (void) fclose(known_set_handle);
+    }
+
+    if (digest_list_handle)
+    {
+        (void) fclose(digest_list_handle);
+    }
+
+    free((void*) bloom_blocks);
+    free((void*) slots);
+    free((void*) digests);
+
+    return ret;
+}
+
+static
+BOOL
+uhashtools_known_set_is_power_of_two
+(
+    unsigned __int64 value
+)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+struct KnownSet*
+uhashtools_known_set_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* known_set_file,
+    size_t digest_size
+)
+{
+    struct KnownSet* ret = NULL;
+    struct KnownSet* known_set = NULL;
+    LARGE_INTEGER file_size;
+    const struct KnownSetFileHeader* header = NULL;
+    unsigned __int64 bloom_size = 0;
+    unsigned __int64 slots_size = 0;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(known_set_file, L"Internal error: known_set_file is NULL!");
+
+    known_set = (struct KnownSet*) calloc(1, sizeof *known_set);
+
+    if (!known_set)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"Failed to allocate the required memory. Please download more RAM!");
+
+        goto cleanup_and_out;
+    }
+
+    known_set->file_handle = CreateFileW(known_set_file,
+                                         GENERIC_READ,
+                                         FILE_SHARE_READ,
+                                         NULL, /* Security attributes */
+                                         OPEN_EXISTING,
+                                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS,
+                                         NULL);
+
+    if (known_set->file_handle == INVALID_HANDLE_VALUE)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to open the known set file!");
+
+        goto cleanup_and_out;
+    }
+
+    if (!GetFileSizeEx(known_set->file_handle, &file_size))
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to get the size of the known set file!");
+
+        goto cleanup_and_out;
+    }
+
+    if ((unsigned __int64) file_size.QuadPart < sizeof *header)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The selected file isn't a known set file!");
+
+        goto cleanup_and_out;
+    }
+
+    if ((unsigned __int64) file_size.QuadPart > (size_t) -1)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"The known set file is too big for the 32 bit version of this application!");
+
+        goto cleanup_and_out;
+    }
+
+    known_set->file_mapping_handle = CreateFileMappingW(known_set->file_handle,
+                                                        NULL, /* Security attributes */
+                                                        PAGE_READONLY,
+                                                        0,
+                                                        0,
+                                                        NULL);
+
+    if (known_set->file_mapping_handle)
+    {
+        known_set->file_view = (const unsigned char*) MapViewOfFile(known_set->file_mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    }
+
+    if (!known_set->file_view)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to map the known set file into the memory!");
+
+        goto cleanup_and_out;
+    }
+
+    header = (const struct KnownSetFileHeader*) known_set->file_view;
+
+    if (memcmp((const void*) header->magic, (const void*) KNOWN_SET_MAGIC, KNOWN_SET_MAGIC_SIZE) != 0 ||
+        !uhashtools_known_set_is_power_of_two(header->slot_count) ||
+        !uhashtools_known_set_is_power_of_two(header->bloom_block_count) ||
+        header->digest_size == 0 ||
+        header->digest_size > KNOWN_SET_MAX_DIGEST_SIZE)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The selected file isn't a known set file!");
+
+        goto cleanup_and_out;
+    }
+
+    if (header->digest_size != digest_size)
+    {
+        (void) wcscpy_s(error_message_buf,
+                        error_message_buf_tsize,
+                        L"The known set has been built for another hash algorithm!");
+
+        goto cleanup_and_out;
+    }
+
+    /* Both counts are checked against the file size before multiplying to avoid overflows. */
+    if (header->bloom_block_count > (unsigned __int64) file_size.QuadPart / KNOWN_SET_BLOOM_BLOCK_SIZE ||
+        header->slot_count > (unsigned __int64) file_size.QuadPart / digest_size)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The known set file is damaged!");
+
+        goto cleanup_and_out;
+    }
+
+    bloom_size = header->bloom_block_count * KNOWN_SET_BLOOM_BLOCK_SIZE;
+    slots_size = header->slot_count * digest_size;
+
+    if (sizeof *header + bloom_size + slots_size != (unsigned __int64) file_size.QuadPart)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The known set file is damaged!");
+
+        goto cleanup_and_out;
+    }
+
+    known_set->digest_size = digest_size;
+    known_set->contains_zero_digest = header->contains_zero_digest != 0;
+    known_set->digests_count = header->digests_count;
+    known_set->bloom_blocks = known_set->file_view + sizeof *header;
+    known_set->bloom_block_mask = (size_t) header->bloom_block_count - 1;
+    known_set->slots = known_set->bloom_blocks + (size_t) bloom_size;
+    known_set->slot_mask = (size_t) header->slot_count - 1;
+
+    ret = known_set; known_set = NULL;
+
+cleanup_and_out:
+    uhashtools_known_set_close(known_set);
+
+    return ret;
+}
+
+unsigned __int64
+uhashtools_known_set_get_digests_count
+(
+    const struct KnownSet* known_set
+)
+{
+    UHASHTOOLS_ASSERT(known_set, L"Internal error: known_set is NULL!");
+
+    return known_set->digests_count;
+}
+
+BOOL
+uhashtools_known_set_contains
+(
+    const struct KnownSet* known_set,
+    const unsigned char* digest
+)
+{
+    unsigned __int64 slot_hash = 0;
+    unsigned __int64 bloom_hash = 0;
+    size_t slot_index = 0;
+    size_t probes_count = 0;
+
+    UHASHTOOLS_ASSERT(known_set, L"Internal error: known_set is NULL!");
+    UHASHTOOLS_ASSERT(digest, L"Internal error: digest is NULL!");
+
+    if (uhashtools_known_set_is_zero_digest(digest, known_set->digest_size))
+    {
+        return known_set->contains_zero_digest;
+    }
+
+    uhashtools_known_set_hash_digest(digest, known_set->digest_size, &slot_hash, &bloom_hash);
+
+    if (!uhashtools_known_set_bloom_may_contain(known_set->bloom_blocks, known_set->bloom_block_mask, slot_hash, bloom_hash))
+    {
+        return FALSE;
+    }
+
+    /*
+     * Tables built by this module always have an empty slot which ends the
+     * probing. The probing is still limited to the slot count, so a damaged
+     * set file without an empty slot can't hang the lookup.
+     */
+    for (slot_index = (size_t) slot_hash & known_set->slot_mask;
+         probes_count <= known_set->slot_mask;
+         slot_index = (slot_index + 1) & known_set->slot_mask, ++probes_count)
+    {
+        const unsigned char* slot = known_set->slots + slot_index * known_set->digest_size;
+
+        if (memcmp((const void*) slot, (const void*) digest, known_set->digest_size) == 0)
+        {
+            return TRUE;
+        }
+
+        if (uhashtools_known_set_is_zero_digest(slot, known_set->digest_size))
+        {
+            return FALSE;
+        }
+    }
+
+    return FALSE;
+}
+
+void
+uhashtools_known_set_close
+(
+    struct KnownSet* known_set
+)
+{
+    if (!known_set)
+    {
+        return;
+    }
+
+    if (known_set->file_view)
+    {
+        (void) UnmapViewOfFile((LPCVOID) known_set->file_view);
+    }
+
+    if (known_set->file_mapping_handle)
+    {
+        (void) CloseHandle(known_set->file_mapping_handle);
+    }
+
+    if (known_set->file_handle && known_set->file_handle != INVALID_HANDLE_VALUE)
+    {
+        (void) CloseHandle(known_set->file_handle);
+    }
+
+    free((void*) known_set);
+}
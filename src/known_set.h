@@ -0,0 +1,135 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+/*
+ * A known set is a file with a large set of digests (for example the
+ * digests of known-good or known-bad files) which is prepared for fast
+ * lookups. The digests are stored as raw bytes in an open addressing
+ * hash table with linear probing. A blocked Bloom filter in front of
+ * the table answers most lookups of unknown digests with a single
+ * cache line, without touching the much bigger table.
+ * 
+ * The file is memory mapped when it's opened, so opening a set with
+ * tens of millions of digests doesn't read or parse anything and only
+ * the accessed pages are loaded from the disk.
+ * 
+ * File layout (all numbers little endian):
+ * 
+ *   Header: struct KnownSetFileHeader (64 bytes)
+ *   Bloom filter: "bloom_block_count" blocks of 64 bytes
+ *   Hash table: "slot_count" slots of "digest_size" bytes
+ * 
+ * An all zero slot is empty. An all zero digest is therefore stored
+ * only as flag in the header.
+ */
+
+/**
+ * Opened known set. Must be closed with "uhashtools_known_set_close()".
+ */
+struct KnownSet;
+
+/**
+ * Builds a known set file from a text file with digests.
+ * 
+ * Each line of the digest list must start with the hex encoded digest,
+ * optionally preceded by whitespace or a double quote. Everything after
+ * the digest is ignored, so the output of the "*sum" tools, the archive
+ * mode and plain lists of digests are accepted. Lines which don't start
+ * with a digest of "digest_size" bytes (for example headers of CSV
+ * files) are skipped.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if
+ *                          building the set fails.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param digest_list_file Path of the text file with the digests.
+ * @param known_set_file Path of the known set file which should be written.
+ * @param digest_size Size of the digests in bytes.
+ * @param added_digests_count Receives the amount of stored (unique) digests.
+ * @param skipped_lines_count Receives the amount of lines without a digest.
+ * 
+ * @return TRUE on success and FALSE on failure.
+ */
+extern
+BOOL
+uhashtools_known_set_build
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* digest_list_file,
+    const wchar_t* known_set_file,
+    size_t digest_size,
+    unsigned __int64* added_digests_count,
+    unsigned __int64* skipped_lines_count
+);
+
+/**
+ * Opens a known set file by mapping it into the memory.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if
+ *                          opening the set fails.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param known_set_file Path of the known set file.
+ * @param digest_size Expected size of the digests in bytes. Sets of other hash
+ *                    algorithms are rejected.
+ * 
+ * @return Opened known set or NULL on failure.
+ */
+extern
+struct KnownSet*
+uhashtools_known_set_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* known_set_file,
+    size_t digest_size
+);
+
+/**
+ * @param known_set Opened known set.
+ * 
+ * @return Amount of digests within the set.
+ */
+extern
+unsigned __int64
+uhashtools_known_set_get_digests_count
+(
+    const struct KnownSet* known_set
+);
+
+/**
+ * Checks if a digest is part of the set.
+ * 
+ * @param known_set Opened known set.
+ * @param digest Digest with the size which has been passed to
+ *               "uhashtools_known_set_open()".
+ * 
+ * @return TRUE if the digest is known else FALSE.
+ */
+extern
+BOOL
+uhashtools_known_set_contains
+(
+    const struct KnownSet* known_set,
+    const unsigned char* digest
+);
+
+/**
+ * Closes the known set. Passing NULL is allowed.
+ * 
+ * @param known_set Known set to close.
+ */
+extern
+void
+uhashtools_known_set_close
+(
+    struct KnownSet* known_set
+);
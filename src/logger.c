@@ -0,0 +1,273 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "logger.h"
+
+#include "buffer_sizes.h"
+
+#include <process.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LOGGER_QUEUE_SLOT_COUNT 128
+#define LOGGER_THREAD_STACK_SIZE (1024 * 64)
+
+struct LoggerCtx
+{
+    HANDLE writer_thread_handle;
+    unsigned int writer_thread_id;
+
+    /*
+     * Set once by "uhashtools_logger_start()". The lock and the condition
+     * variables are never destroyed since log lines can be written until
+     * the process exits.
+     */
+    BOOL is_initialized;
+
+    /*
+     * Ring buffer of the queue. The slots from "queue_head" up to
+     * "queue_count" slots after it are filled and owned by the writer
+     * thread.
+     */
+    CRITICAL_SECTION queue_lock;
+    CONDITION_VARIABLE queue_slot_filled;
+    CONDITION_VARIABLE queue_slot_free;
+    wchar_t queue_slots[LOGGER_QUEUE_SLOT_COUNT][LOG_LINE_BUFFER_TSIZE];
+    size_t queue_head;
+    size_t queue_count;
+    BOOL is_running;
+};
+
+static struct LoggerCtx g_logger_ctx;
+
+static
+const wchar_t*
+uhashtools_logger_get_level_prefix
+(
+    enum LoggerLevel level
+)
+{
+    switch (level)
+    {
+        case LOGGER_LEVEL_DEBUG:
+            return L"[DEBUG]: ";
+        case LOGGER_LEVEL_INFO:
+            return L"[INFO]: ";
+        case LOGGER_LEVEL_WARN:
+            return L"[WARNING]: ";
+        default:
+            return L"[ERROR]: ";
+    }
+}
+
+static
+void
+uhashtools_logger_write_line_sync
+(
+    const wchar_t* line
+)
+{
+    (void) fwprintf_s(stderr, L"%s\n", line);
+    (void) fflush(stderr);
+}
+
+static
+unsigned int
+__stdcall
+uhashtools_logger_writer_thread_function
+(
+    void* thread_param
+)
+{
+    struct LoggerCtx* ctx = (struct LoggerCtx*) thread_param;
+
+    EnterCriticalSection(&ctx->queue_lock);
+
+    for (;;)
+    {
+        size_t taken_slots = 0;
+        size_t taken_head = 0;
+        size_t slot_index = 0;
+
+        while (ctx->queue_count == 0 && ctx->is_running)
+        {
+            (void) SleepConditionVariableCS(&ctx->queue_slot_filled, &ctx->queue_lock, INFINITE);
+        }
+
+        if (ctx->queue_count == 0)
+        {
+            /* Stop has been requested and all queued lines are written. */
+            break;
+        }
+
+        /*
+         * The taken slots aren't touched by the producers until they are
+         * released again, so they can be written without holding the lock.
+         */
+        taken_slots = ctx->queue_count;
+        taken_head = ctx->queue_head;
+
+        LeaveCriticalSection(&ctx->queue_lock);
+
+        for (slot_index = 0; slot_index < taken_slots; ++slot_index)
+        {
+            (void) fwprintf_s(stderr, L"%s\n", ctx->queue_slots[(taken_head + slot_index) % LOGGER_QUEUE_SLOT_COUNT]);
+        }
+
+        (void) fflush(stderr);
+
+        EnterCriticalSection(&ctx->queue_lock);
+
+        ctx->queue_head = (ctx->queue_head + taken_slots) % LOGGER_QUEUE_SLOT_COUNT;
+        ctx->queue_count -= taken_slots;
+        WakeAllConditionVariable(&ctx->queue_slot_free);
+    }
+
+    LeaveCriticalSection(&ctx->queue_lock);
+
+    return 0;
+}
+
+void
+uhashtools_logger_start
+(
+    void
+)
+{
+    struct LoggerCtx* ctx = &g_logger_ctx;
+    uintptr_t thread_handle = 0;
+
+    if (!ctx->is_initialized)
+    {
+        InitializeCriticalSection(&ctx->queue_lock);
+        InitializeConditionVariable(&ctx->queue_slot_filled);
+        InitializeConditionVariable(&ctx->queue_slot_free);
+        ctx->is_initialized = TRUE;
+    }
+
+    EnterCriticalSection(&ctx->queue_lock);
+
+    if (ctx->is_running)
+    {
+        LeaveCriticalSection(&ctx->queue_lock);
+        return;
+    }
+
+    ctx->is_running = TRUE;
+
+    LeaveCriticalSection(&ctx->queue_lock);
+
+    thread_handle = _beginthreadex(NULL,
+                                   LOGGER_THREAD_STACK_SIZE,
+                                   uhashtools_logger_writer_thread_function,
+                                   (void*) ctx,
+                                   0,
+                                   &ctx->writer_thread_id);
+
+    if (thread_handle == 0)
+    {
+        /* Falling back to writing the log lines synchronously. */
+        EnterCriticalSection(&ctx->queue_lock);
+        ctx->is_running = FALSE;
+        LeaveCriticalSection(&ctx->queue_lock);
+
+        return;
+    }
+
+    ctx->writer_thread_handle = (HANDLE) thread_handle;
+}
+
+void
+uhashtools_logger_write_line
+(
+    enum LoggerLevel level,
+    const wchar_t* format,
+    ...
+)
+{
+    struct LoggerCtx* ctx = &g_logger_ctx;
+    wchar_t line[LOG_LINE_BUFFER_TSIZE];
+    size_t prefix_length = 0;
+    va_list format_args;
+
+    (void) wcscpy_s(line, LOG_LINE_BUFFER_TSIZE, uhashtools_logger_get_level_prefix(level));
+    prefix_length = wcslen(line);
+
+    va_start(format_args, format);
+    (void) _vsnwprintf_s(line + prefix_length, LOG_LINE_BUFFER_TSIZE - prefix_length, _TRUNCATE, format, format_args);
+    va_end(format_args);
+
+    if (!ctx->is_initialized)
+    {
+        uhashtools_logger_write_line_sync(line);
+        return;
+    }
+
+    EnterCriticalSection(&ctx->queue_lock);
+
+    while (ctx->queue_count == LOGGER_QUEUE_SLOT_COUNT && ctx->is_running)
+    {
+        (void) SleepConditionVariableCS(&ctx->queue_slot_free, &ctx->queue_lock, INFINITE);
+    }
+
+    if (!ctx->is_running)
+    {
+        LeaveCriticalSection(&ctx->queue_lock);
+        uhashtools_logger_write_line_sync(line);
+        return;
+    }
+
+    (void) wcscpy_s(ctx->queue_slots[(ctx->queue_head + ctx->queue_count) % LOGGER_QUEUE_SLOT_COUNT],
+                    LOG_LINE_BUFFER_TSIZE,
+                    line);
+    ++ctx->queue_count;
+    WakeConditionVariable(&ctx->queue_slot_filled);
+
+    LeaveCriticalSection(&ctx->queue_lock);
+}
+
+void
+uhashtools_logger_stop
+(
+    void
+)
+{
+    struct LoggerCtx* ctx = &g_logger_ctx;
+    HANDLE writer_thread_handle = NULL;
+
+    if (!ctx->is_initialized)
+    {
+        return;
+    }
+
+    EnterCriticalSection(&ctx->queue_lock);
+
+    if (!ctx->is_running || GetCurrentThreadId() == (DWORD) ctx->writer_thread_id)
+    {
+        /* Already stopped or called by the writer thread itself (e.g. by the fatal error handler). */
+        LeaveCriticalSection(&ctx->queue_lock);
+        return;
+    }
+
+    ctx->is_running = FALSE;
+    writer_thread_handle = ctx->writer_thread_handle;
+    ctx->writer_thread_handle = NULL;
+    WakeAllConditionVariable(&ctx->queue_slot_filled);
+    WakeAllConditionVariable(&ctx->queue_slot_free);
+
+    LeaveCriticalSection(&ctx->queue_lock);
+
+    /*
+     * The result of the wait isn't checked since this function is also
+     * called by the fatal error handler.
+     */
+    (void) WaitForSingleObject(writer_thread_handle, INFINITE);
+    (void) CloseHandle(writer_thread_handle);
+}
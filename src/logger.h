@@ -0,0 +1,67 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+/*
+ * Asynchronous writer for the log lines of the "UHASHTOOLS_PRINTF_LINE_*"
+ * macros (see "print_utilities.h"). The calling thread only formats the
+ * line and copies it into a bounded queue. Writing the lines to stderr
+ * and flushing stderr happens within an own thread, once per batch of
+ * queued lines instead of once per line. If the logger isn't running,
+ * the lines are written synchronously.
+ */
+
+enum LoggerLevel
+{
+    LOGGER_LEVEL_DEBUG,
+    LOGGER_LEVEL_INFO,
+    LOGGER_LEVEL_WARN,
+    LOGGER_LEVEL_ERROR
+};
+
+/**
+ * Starts the thread which writes the queued log lines. Should be called
+ * once at the start of the application.
+ */
+extern
+void
+uhashtools_logger_start
+(
+    void
+);
+
+/**
+ * Formats a log line and queues it for writing.
+ * 
+ * @param level Level of the log line. Determines the prefix of the line.
+ * @param format fwprintf_s() format control.
+ * @param ... Optional fwprintf_s() format arguments.
+ */
+extern
+void
+uhashtools_logger_write_line
+(
+    enum LoggerLevel level,
+    const wchar_t* format,
+    ...
+);
+
+/**
+ * Writes all queued log lines and stops the writer thread. Log lines
+ * which are written afterwards are written synchronously. Can be called
+ * multiple times.
+ */
+extern
+void
+uhashtools_logger_stop
+(
+    void
+);
@@ -16,10 +16,20 @@
     #error This application must be compiled with the compiler option "/DUNICODE" and "/D_UNICODE"!
 #endif 
 
+#include "archive_mode.h"
+#include "block_mode.h"
+#include "chunk_mode.h"
 #include "cli_arguments.h"
+#include "dedup_mode.h"
 #include "error_utilities.h"
+#include "incremental_mode.h"
+#include "known_mode.h"
+#include "logger.h"
 #include "mainwin.h"
 #include "mainwin_ctx.h"
+#include "manifest_mode.h"
+#include "serve_mode.h"
+#include "throttle.h"
 
 #include <Windows.h>
 
@@ -41,14 +51,60 @@ wWinMain
      * is running.
      */
     static struct MainWindowCtx main_window_state;
+    int ret = 0;
 
     /* Silencing the unused parameter warnings */
     UNREFERENCED_PARAMETER(hPrevInstance);
     UNREFERENCED_PARAMETER(lpCmdLine);
 
+    uhashtools_logger_start();
+
     uhashtools_mainwin_ctx_init(&main_window_state);
     uhashtools_cli_arguments_fill_from_argc_argv(&main_window_state.cli_arguments, __argc, __wargv);
-    uhashtools_start_main_window(hInstance, nShowCmd, &main_window_state);
 
-    return 0;
+    uhashtools_throttle_start(main_window_state.cli_arguments.throttle_bytes_per_second,
+                              main_window_state.cli_arguments.throttle_use_background_mode,
+                              main_window_state.cli_arguments.throttle_max_threads);
+
+    if (uhashtools_cli_arguments_has_archive_file(&main_window_state.cli_arguments))
+    {
+        ret = uhashtools_archive_mode_run(&main_window_state.cli_arguments);
+    }
+    else if (uhashtools_cli_arguments_has_dedup_directory(&main_window_state.cli_arguments))
+    {
+        ret = uhashtools_dedup_mode_run(&main_window_state.cli_arguments);
+    }
+    else if (uhashtools_cli_arguments_has_known_set_file(&main_window_state.cli_arguments))
+    {
+        ret = uhashtools_known_mode_run(&main_window_state.cli_arguments);
+    }
+    else if (uhashtools_cli_arguments_has_manifest_file(&main_window_state.cli_arguments))
+    {
+        ret = uhashtools_manifest_mode_run(&main_window_state.cli_arguments);
+    }
+    else if (uhashtools_cli_arguments_has_incremental_state_file(&main_window_state.cli_arguments))
+    {
+        ret = uhashtools_incremental_mode_run(&main_window_state.cli_arguments);
+    }
+    else if (uhashtools_cli_arguments_has_chunk_target_file(&main_window_state.cli_arguments))
+    {
+        ret = uhashtools_chunk_mode_run(&main_window_state.cli_arguments);
+    }
+    else if (uhashtools_cli_arguments_has_block_list_file(&main_window_state.cli_arguments))
+    {
+        ret = uhashtools_block_mode_run(&main_window_state.cli_arguments);
+    }
+    else if (uhashtools_cli_arguments_has_serve_pipe_name(&main_window_state.cli_arguments))
+    {
+        ret = uhashtools_serve_mode_run(&main_window_state.cli_arguments);
+    }
+    else
+    {
+        uhashtools_start_main_window(hInstance, nShowCmd, &main_window_state);
+    }
+
+    /* Writing the remaining log lines before the process exits. */
+    uhashtools_logger_stop();
+
+    return ret;
 }
@@ -121,11 +121,10 @@ uhashtools_enter_main_message_loop
         }
         else if (getMsgResult == 0)
         {
-            int gui_rc = (int) msg.wParam;
             contLoop = FALSE;
 
             UHASHTOOLS_PRINTF_LINE_DEBUG(L"Exiting main loop normally with return code '%i'...",
-                                         gui_rc);
+                                         (int) msg.wParam);
         }
         else
         {
@@ -22,6 +22,7 @@
 #include "mainwin_pb_calc_result.h"
 #include "print_utilities.h"
 #include "product.h"
+#include "resultswin.h"
 #include "selectfiledialog.h"
 
 #if _WIN32_WINNT >= 0x0601
@@ -307,6 +308,29 @@ uhashtools_mainwin_change_displayed_calculation_progress
 #endif
 }
 
+void
+uhashtools_mainwin_change_displayed_indeterminate_calculation_progress
+(
+    struct MainWindowCtx* mainwin_ctx,
+    unsigned __int64 processed_bytes,
+    unsigned __int64 bytes_per_second
+)
+{
+    UHASHTOOLS_ASSERT(mainwin_ctx, L"Internal error: Entered with mainwin_ctx == NULL!");
+
+    uhashtools_pb_calc_result_on_indeterminate_work_progress(mainwin_ctx->pb_calc_result);
+
+    uhashtools_eb_calc_result_on_indeterminate_work_progress(mainwin_ctx->eb_calc_result,
+                                                             processed_bytes,
+                                                             bytes_per_second,
+                                                             mainwin_ctx->eb_calc_result_txt_buf);
+
+#if _WIN32_WINNT >= 0x0601
+    uhashtools_taskbar_icon_progress_bar_on_indeterminate_work_progress(&mainwin_ctx->pb_taskbar_icon_ctx,
+                                                                        &mainwin_ctx->taskbar_list_com_api);
+#endif
+}
+
 void
 uhashtools_mainwin_copy_hash_result_to_clipboard
 (
@@ -359,25 +383,73 @@ uhashtools_mainwin_hash_selected_file
     UHASHTOOLS_PRINTF_LINE_INFO(L"Handling file selection of file: \"%s\"", mainwin_ctx->target_file);
 
     uhashtools_mainwin_change_state(mainwin_ctx, MAINWINDOWSTATE_WORKING);
-    mainwin_ctx->worker_instance_data = uhashtools_hash_calculation_worker_start(&mainwin_ctx->worker_thread_param_buf,
-                                                                                 &mainwin_ctx->event_message_buf,
-                                                                                 mainwin_ctx->event_message_buf_is_writeable_event,
-                                                                                 mainwin_ctx->own_window_handle,
-                                                                                 mainwin_ctx->target_file);
-    
+
     if (!mainwin_ctx->worker_instance_data.created_successfully)
     {
-        UHASHTOOLS_PRINTF_LINE_ERROR(L"Failed to create hash calculation worker thread!");
+        /* The worker is started with the first job and is reused by all following jobs. */
+        mainwin_ctx->worker_instance_data = uhashtools_hash_calculation_worker_start(&mainwin_ctx->worker_thread_param_buf,
+                                                                                     &mainwin_ctx->event_message_buf,
+                                                                                     mainwin_ctx->event_message_buf_is_writeable_event,
+                                                                                     mainwin_ctx->own_window_handle);
+
+        if (!mainwin_ctx->worker_instance_data.created_successfully)
+        {
+            UHASHTOOLS_PRINTF_LINE_ERROR(L"Failed to create hash calculation worker thread!");
+
+            (void) wcscpy_s(mainwin_ctx->error_txt,
+                            GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                            L"Internal error: Failed to create hash calculation worker thread!");
+
+            uhashtools_mainwin_change_state(mainwin_ctx, MAINWINDOWSTATE_FINISHED_ERROR);
+
+            return;
+        }
+
+        UHASHTOOLS_PRINTF_LINE_DEBUG(L"Successfully created hash calculation worker thread with the thread id \"%lu\".",
+                                     mainwin_ctx->worker_instance_data.thread_id);
+    }
+
+    if (!uhashtools_hash_calculation_worker_submit_job(&mainwin_ctx->worker_instance_data, mainwin_ctx->target_file))
+    {
+        UHASHTOOLS_PRINTF_LINE_ERROR(L"Failed to submit the hash calculation job!");
 
         (void) wcscpy_s(mainwin_ctx->error_txt,
                         GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
-                        L"Internal error: Failed to create hash calculation worker thread!");
+                        L"Internal error: Failed to submit the hash calculation job!");
 
         uhashtools_mainwin_change_state(mainwin_ctx, MAINWINDOWSTATE_FINISHED_ERROR);
-        
+
         return;
     }
-    
-    UHASHTOOLS_PRINTF_LINE_DEBUG(L"Successfully created hash calculation worker thread with the thread id \"%lu\".",
-                                 mainwin_ctx->worker_instance_data.thread_id);
+
+    UHASHTOOLS_PRINTF_LINE_DEBUG(L"Submitted hash calculation job with the id \"%u\".",
+                                 mainwin_ctx->worker_instance_data.current_job_id);
+}
+
+void
+uhashtools_mainwin_hash_batch
+(
+    struct MainWindowCtx* mainwin_ctx,
+    const wchar_t* const* paths,
+    size_t paths_count
+)
+{
+    UHASHTOOLS_ASSERT(mainwin_ctx, L"Internal error: Entered with mainwin_ctx == NULL!");
+    UHASHTOOLS_ASSERT(paths, L"Internal error: Entered with paths == NULL!");
+
+    UHASHTOOLS_PRINTF_LINE_INFO(L"Handling a batch of \"%Iu\" dropped paths.", paths_count);
+
+    if (!uhashtools_resultswin_open(mainwin_ctx->app_instance_handle,
+                                    mainwin_ctx->own_window_handle,
+                                    paths,
+                                    paths_count))
+    {
+        UHASHTOOLS_PRINTF_LINE_ERROR(L"Failed to open the results window!");
+
+        (void) MessageBeep(MB_OK);
+        (void) MessageBoxW(mainwin_ctx->own_window_handle,
+                           L"Internal error: Failed to open the results window!",
+                           L"Calculation failed",
+                           MB_OK);
+    }
 }
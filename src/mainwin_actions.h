@@ -117,6 +117,23 @@ uhashtools_mainwin_change_displayed_calculation_progress
     unsigned int current_progress_in_percent
 );
 
+/**
+ * Changes the displayed calculation progress of a target with an
+ * unknown size (for example the standard input or a pipe).
+ * 
+ * @param mainwin_ctx Context data of the target mainwin instance.
+ * @param processed_bytes Amount of already hashed bytes.
+ * @param bytes_per_second Average throughput of the calculation.
+ */
+extern
+void
+uhashtools_mainwin_change_displayed_indeterminate_calculation_progress
+(
+    struct MainWindowCtx* mainwin_ctx,
+    unsigned __int64 processed_bytes,
+    unsigned __int64 bytes_per_second
+);
+
 /**
  * Copies the currently displayed hash result into the clipboard.
  * 
@@ -156,3 +173,20 @@ uhashtools_mainwin_hash_selected_file
 (
     struct MainWindowCtx* mainwin_ctx
 );
+
+/**
+ * Opens a results window which hashes a batch of files and directories
+ * (see "resultswin.h"). The main window itself isn't changed.
+ * 
+ * @param mainwin_ctx Context data of the target mainwin instance.
+ * @param paths Paths of the files and directories of the batch.
+ * @param paths_count Amount of the paths.
+ */
+extern
+void
+uhashtools_mainwin_hash_batch
+(
+    struct MainWindowCtx* mainwin_ctx,
+    const wchar_t* const* paths,
+    size_t paths_count
+);
@@ -14,6 +14,7 @@
 #include "gui_eb_common.h"
 #include "mainwin_state.h"
 
+#include <stdio.h>
 #include <wchar.h>
 #include <Windows.h>
 
@@ -154,3 +155,28 @@ uhashtools_eb_calc_result_on_state_changed
     uhashtools_gui_elm_set_visible(self, is_visible);
     uhashtools_eb_set_text(self, current_txt);
 }
+
+void
+uhashtools_eb_calc_result_on_indeterminate_work_progress
+(
+    HWND self,
+    unsigned __int64 processed_bytes,
+    unsigned __int64 bytes_per_second,
+    wchar_t* eb_calc_result_txt_buf
+)
+{
+    const double bytes_per_mib = 1024.0 * 1024.0;
+
+    UHASHTOOLS_ASSERT(eb_calc_result_txt_buf,
+                      L"Internal parameter error: Entered with eb_calc_result_txt_buf == NULL!");
+
+    (void) _snwprintf_s(eb_calc_result_txt_buf,
+                        HASH_RESULT_BUFFER_TSIZE,
+                        _TRUNCATE,
+                        L"%.1f MiB hashed (%.1f MiB/s)",
+                        (double) processed_bytes / bytes_per_mib,
+                        (double) bytes_per_second / bytes_per_mib);
+
+    uhashtools_gui_elm_set_visible(self, TRUE);
+    uhashtools_eb_set_text(self, eb_calc_result_txt_buf);
+}
@@ -42,3 +42,18 @@ uhashtools_eb_calc_result_on_state_changed
     const wchar_t* current_hash_result,
     wchar_t* eb_calc_result_txt_buf
 );
+
+/**
+ * Shows the amount of processed data and the throughput in place of
+ * the progress bar. Used if the size of the target isn't known and
+ * therefore no percentage progress can be displayed.
+ */
+extern
+void
+uhashtools_eb_calc_result_on_indeterminate_work_progress
+(
+    HWND self,
+    unsigned __int64 processed_bytes,
+    unsigned __int64 bytes_per_second,
+    wchar_t* eb_calc_result_txt_buf
+);
@@ -11,6 +11,7 @@
 #include "buffer_sizes.h"
 #include "cli_arguments.h"
 #include "error_utilities.h"
+#include "hash_calculation_impl.h"
 #include "hash_calculation_worker.h"
 #include "mainwin_actions.h"
 #include "mainwin_ctx.h"
@@ -22,6 +23,7 @@
 #endif
 
 #include <stdio.h>
+#include <stdlib.h>
 
 void
 uhashtools_mainwin_on_window_created
@@ -47,7 +49,7 @@ uhashtools_mainwin_on_cancel_button_pressed
 {
     UHASHTOOLS_ASSERT(mainwin_ctx, L"Internal error: Entered with mainwin_ctx == NULL!");
     
-    uhashtools_hash_calculation_worker_request_cancellation(mainwin_ctx->worker_instance_data.thread_id);
+    uhashtools_hash_calculation_worker_request_cancellation(&mainwin_ctx->worker_instance_data);
 }
 
 void
@@ -108,6 +110,57 @@ uhashtools_mainwin_on_taskbar_button_created
 }
 #endif
 
+/*
+ * Every dropped path is copied into its own FILEPATH_BUFFER_TSIZE slot of
+ * one allocation, the batch worker copies them again.
+ */
+static
+void
+uhashtools_mainwin_hash_dropped_batch
+(
+    struct MainWindowCtx* mainwin_ctx,
+    HDROP dropped_files_event_handle,
+    UINT dropped_files_count
+)
+{
+    wchar_t* paths_buf = NULL;
+    const wchar_t** paths = NULL;
+    UINT dropped_file_index = 0;
+    size_t paths_count = 0;
+
+    paths_buf = (wchar_t*) calloc(dropped_files_count, FILEPATH_BUFFER_TSIZE * sizeof *paths_buf);
+    paths = (const wchar_t**) calloc(dropped_files_count, sizeof *paths);
+
+    if (!paths_buf || !paths)
+    {
+        UHASHTOOLS_PRINTF_LINE_ERROR(L"Failed to allocate the required memory. Please download more RAM!");
+        goto cleanup_and_out;
+    }
+
+    for (dropped_file_index = 0; dropped_file_index < dropped_files_count; ++dropped_file_index)
+    {
+        wchar_t* path = paths_buf + (size_t) dropped_file_index * FILEPATH_BUFFER_TSIZE;
+
+        if (DragQueryFileW(dropped_files_event_handle, dropped_file_index, path, FILEPATH_BUFFER_TSIZE))
+        {
+            paths[paths_count++] = path;
+        }
+        else
+        {
+            UHASHTOOLS_PRINTF_LINE_WARN(L"Failed to get a file from the \"WM_DROPFILES\" event! Ignoring the file...");
+        }
+    }
+
+    if (paths_count > 0)
+    {
+        uhashtools_mainwin_hash_batch(mainwin_ctx, paths, paths_count);
+    }
+
+cleanup_and_out:
+    free((void*) paths);
+    free((void*) paths_buf);
+}
+
 void
 uhashtools_mainwin_on_file_dropped
 (
@@ -119,30 +172,39 @@ uhashtools_mainwin_on_file_dropped
     
     dropped_files_count = DragQueryFileW(dropped_files_event_handle, 0xFFFFFFFF, NULL, 0);
 
-    if (dropped_files_count >= 1)
+    if (dropped_files_count == 1)
     {
         wchar_t* ctx_target_file = mainwin_ctx->target_file;
         UINT get_drag_file_succeeded = 0;
-
-        if (dropped_files_count > 1)
-        {
-            UHASHTOOLS_PRINTF_LINE_WARN(L"The received \"WM_DROPFILES\" event contains multiple files! We're taking the first and ignoring the rest...");
-        }
+        DWORD file_attributes = INVALID_FILE_ATTRIBUTES;
 
         get_drag_file_succeeded = DragQueryFileW(dropped_files_event_handle,
                                                  0,
                                                  ctx_target_file,
                                                  FILEPATH_BUFFER_TSIZE);
 
-        if (get_drag_file_succeeded)
+        if (!get_drag_file_succeeded)
         {
-            uhashtools_mainwin_hash_selected_file(mainwin_ctx);
+            UHASHTOOLS_PRINTF_LINE_WARN(L"Failed to get the files from the \"WM_DROPFILES\" event! Ignoring the event...");
+            return;
+        }
+
+        file_attributes = GetFileAttributesW(ctx_target_file);
+
+        /* A single dropped directory is hashed as a batch. */
+        if (file_attributes != INVALID_FILE_ATTRIBUTES && (file_attributes & FILE_ATTRIBUTE_DIRECTORY))
+        {
+            uhashtools_mainwin_hash_dropped_batch(mainwin_ctx, dropped_files_event_handle, dropped_files_count);
         }
         else
         {
-            UHASHTOOLS_PRINTF_LINE_WARN(L"Failed to get the files from the \"WM_DROPFILES\" event! Ignoring the event...");
+            uhashtools_mainwin_hash_selected_file(mainwin_ctx);
         }
     }
+    else if (dropped_files_count > 1)
+    {
+        uhashtools_mainwin_hash_dropped_batch(mainwin_ctx, dropped_files_event_handle, dropped_files_count);
+    }
 }
 
 void
@@ -162,16 +224,29 @@ uhashtools_mainwin_on_hash_calculation_worker_event_message_received
     }
     else if (event_message->event_type == HCWET_CALCULATION_PROGRESS_CHANGED)
     {
-        const unsigned int current_progress = event_message->event_data.progress_changed_data.current_progress_in_percent;
-        
-        uhashtools_mainwin_change_displayed_calculation_progress(mainwin_ctx,
-                                                                 current_progress);
+        const struct HashCalculationWorkerProgressChangedEventData* progress_data = &event_message->event_data.progress_changed_data;
+
+        if (progress_data->is_size_known)
+        {
+            uhashtools_mainwin_change_displayed_calculation_progress(mainwin_ctx,
+                                                                     progress_data->current_progress_in_percent);
+        }
+        else
+        {
+            uhashtools_mainwin_change_displayed_indeterminate_calculation_progress(mainwin_ctx,
+                                                                                   progress_data->processed_bytes,
+                                                                                   progress_data->bytes_per_second);
+        }
     }
     else if (event_message->event_type == HCWET_CALCULATION_COMPLETE)
     {
-        (void) wcscpy_s(mainwin_ctx->hash_result,
-                        HASH_RESULT_BUFFER_TSIZE,
-                        event_message->event_data.operation_finished_data.calculated_hash);
+        const struct HashDigest* calculated_digest = &event_message->event_data.operation_finished_data.calculated_digest;
+        BOOL encode_hash_result_rc = FALSE;
+
+        encode_hash_result_rc = uhashtools_hash_calculator_impl_digest_to_hex(calculated_digest,
+                                                                              mainwin_ctx->hash_result,
+                                                                              HASH_RESULT_BUFFER_TSIZE);
+        UHASHTOOLS_ASSERT(encode_hash_result_rc, L"Internal error: Failed to encode the hash result to hex!");
 
         uhashtools_mainwin_change_state(mainwin_ctx,
                                         MAINWINDOWSTATE_FINISHED_SUCCESS);
@@ -181,7 +256,8 @@ uhashtools_mainwin_on_hash_calculation_worker_event_message_received
         (void) wcscpy_s(mainwin_ctx->error_txt,
                         GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
                         event_message->event_data.operation_failed_data.user_error_message);
-        
+        free((void*) event_message->event_data.operation_failed_data.user_error_message);
+
         uhashtools_mainwin_change_state(mainwin_ctx,
                                         MAINWINDOWSTATE_FINISHED_ERROR);
     }
@@ -99,3 +99,12 @@ uhashtools_pb_calc_result_on_work_progress
 {
     uhashtools_pb_set_progress(self, progress_in_percent);
 }
+
+void
+uhashtools_pb_calc_result_on_indeterminate_work_progress
+(
+    HWND self
+)
+{
+    uhashtools_gui_elm_set_visible(self, FALSE);
+}
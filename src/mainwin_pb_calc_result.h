@@ -45,3 +45,15 @@ uhashtools_pb_calc_result_on_work_progress
     HWND self,
     unsigned int progress_in_percent
 );
+
+/**
+ * Hides the progress bar since there is no percentage progress for
+ * targets with an unknown size. The result edit box shows the amount
+ * of processed data instead.
+ */
+extern
+void
+uhashtools_pb_calc_result_on_indeterminate_work_progress
+(
+    HWND self
+);
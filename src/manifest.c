@@ -0,0 +1,716 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "manifest.h"
+
+#include "error_utilities.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MANIFEST_HEADER_FORMAT "# uhashtools manifest 1 %u\n"
+
+/* The subtree lines of a directory are written with a fixed width, so the line can be filled in later. */
+#define MANIFEST_SUBTREE_LINES_DIGITS 20
+
+#define MANIFEST_MERKLE_NODE_MIN_CAPACITY 4096
+
+struct ManifestReader
+{
+    FILE* handle;
+    unsigned int digest_size;
+    BOOL is_corrupted;
+    char line[MANIFEST_LINE_BUFFER_SIZE];
+};
+
+struct ManifestWriter
+{
+    FILE* handle;
+    unsigned int digest_size;
+    BOOL had_errors;
+    unsigned __int64 lines_count;
+    char line[MANIFEST_LINE_BUFFER_SIZE];
+};
+
+static
+int
+uhashtools_manifest_hex_char_value
+(
+    char hex_char
+)
+{
+    if (hex_char >= '0' && hex_char <= '9')
+    {
+        return hex_char - '0';
+    }
+
+    if (hex_char >= 'a' && hex_char <= 'f')
+    {
+        return hex_char - 'a' + 10;
+    }
+
+    if (hex_char >= 'A' && hex_char <= 'F')
+    {
+        return hex_char - 'A' + 10;
+    }
+
+    return -1;
+}
+
+/* Parses the hex digest at "*cursor" and moves the cursor behind it. */
+static
+BOOL
+uhashtools_manifest_parse_digest
+(
+    const char** cursor,
+    unsigned int digest_size,
+    struct HashDigest* digest
+)
+{
+    const char* hex_digest = *cursor;
+    unsigned int i = 0;
+
+    for (i = 0; i < digest_size; ++i)
+    {
+        const int upper_value = uhashtools_manifest_hex_char_value(hex_digest[i * 2]);
+        const int lower_value = upper_value < 0 ? -1 : uhashtools_manifest_hex_char_value(hex_digest[i * 2 + 1]);
+
+        if (lower_value < 0)
+        {
+            return FALSE;
+        }
+
+        digest->bytes[i] = (unsigned char) ((upper_value << 4) | lower_value);
+    }
+
+    digest->size = digest_size;
+    *cursor = hex_digest + digest_size * 2;
+
+    return TRUE;
+}
+
+/* Parses the decimal number at "*cursor" and moves the cursor behind it. */
+static
+BOOL
+uhashtools_manifest_parse_number
+(
+    const char** cursor,
+    unsigned __int64* number
+)
+{
+    const char* digits = *cursor;
+
+    *number = 0;
+
+    if (*digits < '0' || *digits > '9')
+    {
+        return FALSE;
+    }
+
+    while (*digits >= '0' && *digits <= '9')
+    {
+        const unsigned int digit = (unsigned int) (*digits - '0');
+
+        if (*number > (_UI64_MAX - digit) / 10)
+        {
+            return FALSE;
+        }
+
+        *number = *number * 10 + digit;
+        ++digits;
+    }
+
+    *cursor = digits;
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_manifest_skip_separator
+(
+    const char** cursor
+)
+{
+    if (**cursor != ' ')
+    {
+        return FALSE;
+    }
+
+    ++*cursor;
+
+    return TRUE;
+}
+
+/* Writes the hex encoded digest into "line" and returns the amount of written characters. */
+static
+size_t
+uhashtools_manifest_format_digest
+(
+    char* line,
+    const struct HashDigest* digest
+)
+{
+    static const char hex_chars[] = "0123456789abcdef";
+    unsigned int i = 0;
+
+    for (i = 0; i < digest->size; ++i)
+    {
+        line[i * 2] = hex_chars[digest->bytes[i] >> 4];
+        line[i * 2 + 1] = hex_chars[digest->bytes[i] & 0x0F];
+    }
+
+    line[digest->size * 2] = '\0';
+
+    return digest->size * 2;
+}
+
+int
+uhashtools_manifest_compare_names
+(
+    const wchar_t* left_name,
+    const wchar_t* right_name
+)
+{
+    /* An ordinal order doesn't depend on the locale of the machine which wrote the manifest. */
+    return wcscmp(left_name, right_name);
+}
+
+struct ManifestReader*
+uhashtools_manifest_reader_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* manifest_file,
+    unsigned int digest_size
+)
+{
+    struct ManifestReader* manifest_reader = NULL;
+    unsigned int manifest_digest_size = 0;
+    char header_end = '\0';
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(digest_size > 0 && digest_size <= HASH_DIGEST_MAX_SIZE,
+                      L"Internal error: Unsupported digest size!");
+
+    manifest_reader = (struct ManifestReader*) malloc(sizeof *manifest_reader);
+
+    if (!manifest_reader)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to allocate the required memory. Please download more RAM!");
+
+        return NULL;
+    }
+
+    (void) memset((void*) manifest_reader, 0, sizeof *manifest_reader);
+    manifest_reader->digest_size = digest_size;
+
+    if (_wfopen_s(&manifest_reader->handle, manifest_file, L"rb") != 0 || !manifest_reader->handle)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to open the manifest!");
+
+        goto error_out;
+    }
+
+    if (!fgets(manifest_reader->line, MANIFEST_LINE_BUFFER_SIZE, manifest_reader->handle) ||
+        sscanf_s(manifest_reader->line, "# uhashtools manifest 1 %u%c", &manifest_digest_size, &header_end, 1) != 2 ||
+        header_end != '\n')
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The file isn't a manifest of this application!");
+
+        goto error_out;
+    }
+
+    if (manifest_digest_size != digest_size)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"The manifest has been written for another hash algorithm!");
+
+        goto error_out;
+    }
+
+    return manifest_reader;
+
+error_out:
+    uhashtools_manifest_reader_close(manifest_reader);
+
+    return NULL;
+}
+
+BOOL
+uhashtools_manifest_reader_next
+(
+    struct ManifestReader* manifest_reader,
+    struct ManifestEntry* entry
+)
+{
+    const char* cursor = NULL;
+    const char* name = NULL;
+    size_t line_len = 0;
+    int name_tsize = 0;
+
+    UHASHTOOLS_ASSERT(manifest_reader, L"Internal error: manifest_reader is NULL!");
+    UHASHTOOLS_ASSERT(entry, L"Internal error: entry is NULL!");
+
+    if (manifest_reader->is_corrupted)
+    {
+        return FALSE;
+    }
+
+    if (!fgets(manifest_reader->line, MANIFEST_LINE_BUFFER_SIZE, manifest_reader->handle))
+    {
+        if (ferror(manifest_reader->handle))
+        {
+            manifest_reader->is_corrupted = TRUE;
+        }
+
+        return FALSE;
+    }
+
+    (void) memset((void*) entry, 0, sizeof *entry);
+
+    /* Every line is terminated, so a missing line feed is a truncated or an overlong line. */
+    line_len = strlen(manifest_reader->line);
+
+    if (line_len == 0 || manifest_reader->line[line_len - 1] != '\n')
+    {
+        goto corrupted_out;
+    }
+
+    manifest_reader->line[line_len - 1] = '\0';
+    cursor = manifest_reader->line;
+
+    if (cursor[0] == 'D')
+    {
+        entry->type = ManifestEntryType_DIRECTORY;
+    }
+    else if (cursor[0] == 'F')
+    {
+        entry->type = ManifestEntryType_FILE;
+    }
+    else
+    {
+        goto corrupted_out;
+    }
+
+    ++cursor;
+
+    if (!uhashtools_manifest_skip_separator(&cursor) ||
+        !uhashtools_manifest_parse_digest(&cursor, manifest_reader->digest_size, &entry->digest) ||
+        !uhashtools_manifest_skip_separator(&cursor))
+    {
+        goto corrupted_out;
+    }
+
+    if (entry->type == ManifestEntryType_DIRECTORY)
+    {
+        if (!uhashtools_manifest_parse_number(&cursor, &entry->subtree_lines_count))
+        {
+            goto corrupted_out;
+        }
+    }
+    else if (!uhashtools_manifest_parse_number(&cursor, &entry->file_size) ||
+             !uhashtools_manifest_skip_separator(&cursor) ||
+             !uhashtools_manifest_parse_number(&cursor, &entry->last_write_time))
+    {
+        goto corrupted_out;
+    }
+
+    if (!uhashtools_manifest_skip_separator(&cursor) || *cursor == '\0')
+    {
+        goto corrupted_out;
+    }
+
+    name = strrchr(cursor, '\\');
+    name = name ? name + 1 : cursor;
+
+    name_tsize = MultiByteToWideChar(CP_UTF8,
+                                     MB_ERR_INVALID_CHARS,
+                                     name,
+                                     -1,
+                                     entry->name,
+                                     FILEPATH_BUFFER_TSIZE);
+
+    if (name_tsize <= 1)
+    {
+        goto corrupted_out;
+    }
+
+    return TRUE;
+
+corrupted_out:
+    manifest_reader->is_corrupted = TRUE;
+
+    return FALSE;
+}
+
+BOOL
+uhashtools_manifest_reader_is_corrupted
+(
+    const struct ManifestReader* manifest_reader
+)
+{
+    UHASHTOOLS_ASSERT(manifest_reader, L"Internal error: manifest_reader is NULL!");
+
+    return manifest_reader->is_corrupted;
+}
+
+void
+uhashtools_manifest_reader_close
+(
+    struct ManifestReader* manifest_reader
+)
+{
+    if (!manifest_reader)
+    {
+        return;
+    }
+
+    if (manifest_reader->handle)
+    {
+        (void) fclose(manifest_reader->handle);
+    }
+
+    free((void*) manifest_reader);
+}
+
+struct ManifestWriter*
+uhashtools_manifest_writer_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* manifest_file,
+    unsigned int digest_size
+)
+{
+    struct ManifestWriter* manifest_writer = NULL;
+
+    UHASHTOOLS_ASSERT(error_message_buf, L"Internal error: error_message_buf is NULL!");
+    UHASHTOOLS_ASSERT(digest_size > 0 && digest_size <= HASH_DIGEST_MAX_SIZE,
+                      L"Internal error: Unsupported digest size!");
+
+    manifest_writer = (struct ManifestWriter*) malloc(sizeof *manifest_writer);
+
+    if (!manifest_writer)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to allocate the required memory. Please download more RAM!");
+
+        return NULL;
+    }
+
+    (void) memset((void*) manifest_writer, 0, sizeof *manifest_writer);
+    manifest_writer->digest_size = digest_size;
+
+    /* Binary mode keeps the line feeds, so the manifest is the same on every machine. */
+    if (_wfopen_s(&manifest_writer->handle, manifest_file, L"wb") != 0 || !manifest_writer->handle)
+    {
+        (void) wcscpy_s(error_message_buf, error_message_buf_tsize, L"Failed to create the manifest!");
+
+        free((void*) manifest_writer);
+
+        return NULL;
+    }
+
+    if (fprintf(manifest_writer->handle, MANIFEST_HEADER_FORMAT, digest_size) < 0)
+    {
+        manifest_writer->had_errors = TRUE;
+    }
+
+    return manifest_writer;
+}
+
+/*
+ * Writes "<prefix> <relative path>\n". The prefix has to be in the line
+ * buffer of the writer already.
+ */
+static
+BOOL
+uhashtools_manifest_writer_write_line
+(
+    struct ManifestWriter* manifest_writer,
+    size_t prefix_len,
+    const wchar_t* relative_path
+)
+{
+    int path_size = 0;
+
+    manifest_writer->line[prefix_len] = ' ';
+
+    path_size = WideCharToMultiByte(CP_UTF8,
+                                    0,
+                                    relative_path,
+                                    -1,
+                                    manifest_writer->line + prefix_len + 1,
+                                    (int) (MANIFEST_LINE_BUFFER_SIZE - prefix_len - 2),
+                                    NULL,
+                                    NULL);
+
+    if (path_size <= 1)
+    {
+        manifest_writer->had_errors = TRUE;
+
+        return FALSE;
+    }
+
+    /* Replaces the terminator of the converted path. */
+    manifest_writer->line[prefix_len + (size_t) path_size] = '\n';
+
+    if (fwrite((const void*) manifest_writer->line, prefix_len + (size_t) path_size + 1, 1, manifest_writer->handle) != 1)
+    {
+        manifest_writer->had_errors = TRUE;
+
+        return FALSE;
+    }
+
+    ++manifest_writer->lines_count;
+
+    return TRUE;
+}
+
+/* Writes the "D <hex digest> <subtree lines>" prefix of a directory line into the line buffer. */
+static
+size_t
+uhashtools_manifest_writer_format_directory_prefix
+(
+    struct ManifestWriter* manifest_writer,
+    const struct HashDigest* digest,
+    unsigned __int64 subtree_lines_count
+)
+{
+    size_t prefix_len = 0;
+
+    manifest_writer->line[0] = 'D';
+    manifest_writer->line[1] = ' ';
+    prefix_len = 2 + uhashtools_manifest_format_digest(manifest_writer->line + 2, digest);
+
+    (void) sprintf_s(manifest_writer->line + prefix_len,
+                     MANIFEST_LINE_BUFFER_SIZE - prefix_len,
+                     " %020I64u",
+                     subtree_lines_count);
+
+    return prefix_len + 1 + MANIFEST_SUBTREE_LINES_DIGITS;
+}
+
+BOOL
+uhashtools_manifest_writer_begin_directory
+(
+    struct ManifestWriter* manifest_writer,
+    const wchar_t* relative_path,
+    struct ManifestDirectoryMark* directory_mark
+)
+{
+    struct HashDigest placeholder_digest;
+    size_t prefix_len = 0;
+
+    UHASHTOOLS_ASSERT(manifest_writer, L"Internal error: manifest_writer is NULL!");
+    UHASHTOOLS_ASSERT(directory_mark, L"Internal error: directory_mark is NULL!");
+
+    (void) memset((void*) &placeholder_digest, 0, sizeof placeholder_digest);
+    placeholder_digest.size = manifest_writer->digest_size;
+
+    directory_mark->file_offset = _ftelli64(manifest_writer->handle);
+    directory_mark->line_index = manifest_writer->lines_count;
+
+    if (directory_mark->file_offset < 0)
+    {
+        manifest_writer->had_errors = TRUE;
+
+        return FALSE;
+    }
+
+    prefix_len = uhashtools_manifest_writer_format_directory_prefix(manifest_writer, &placeholder_digest, 0);
+
+    return uhashtools_manifest_writer_write_line(manifest_writer, prefix_len, relative_path);
+}
+
+BOOL
+uhashtools_manifest_writer_end_directory
+(
+    struct ManifestWriter* manifest_writer,
+    const struct ManifestDirectoryMark* directory_mark,
+    const struct HashDigest* digest
+)
+{
+    size_t prefix_len = 0;
+
+    UHASHTOOLS_ASSERT(manifest_writer, L"Internal error: manifest_writer is NULL!");
+    UHASHTOOLS_ASSERT(directory_mark, L"Internal error: directory_mark is NULL!");
+    UHASHTOOLS_ASSERT(digest && digest->size == manifest_writer->digest_size,
+                      L"Internal error: The digest doesn't match the manifest!");
+
+    /* The directory line itself isn't part of its subtree. */
+    prefix_len = uhashtools_manifest_writer_format_directory_prefix(manifest_writer,
+                                                                    digest,
+                                                                    manifest_writer->lines_count - directory_mark->line_index - 1);
+
+    /* Only the prefix is replaced, it has the same length as the one of the placeholder line. */
+    if (_fseeki64(manifest_writer->handle, directory_mark->file_offset, SEEK_SET) != 0 ||
+        fwrite((const void*) manifest_writer->line, prefix_len, 1, manifest_writer->handle) != 1 ||
+        _fseeki64(manifest_writer->handle, 0, SEEK_END) != 0)
+    {
+        manifest_writer->had_errors = TRUE;
+
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+BOOL
+uhashtools_manifest_writer_add_file
+(
+    struct ManifestWriter* manifest_writer,
+    const wchar_t* relative_path,
+    const struct HashDigest* digest,
+    unsigned __int64 file_size,
+    unsigned __int64 last_write_time
+)
+{
+    size_t prefix_len = 0;
+
+    UHASHTOOLS_ASSERT(manifest_writer, L"Internal error: manifest_writer is NULL!");
+    UHASHTOOLS_ASSERT(digest && digest->size == manifest_writer->digest_size,
+                      L"Internal error: The digest doesn't match the manifest!");
+
+    manifest_writer->line[0] = 'F';
+    manifest_writer->line[1] = ' ';
+    prefix_len = 2 + uhashtools_manifest_format_digest(manifest_writer->line + 2, digest);
+
+    prefix_len += (size_t) sprintf_s(manifest_writer->line + prefix_len,
+                                     MANIFEST_LINE_BUFFER_SIZE - prefix_len,
+                                     " %I64u %I64u",
+                                     file_size,
+                                     last_write_time);
+
+    return uhashtools_manifest_writer_write_line(manifest_writer, prefix_len, relative_path);
+}
+
+BOOL
+uhashtools_manifest_writer_close
+(
+    struct ManifestWriter* manifest_writer
+)
+{
+    BOOL ret = FALSE;
+
+    if (!manifest_writer)
+    {
+        return TRUE;
+    }
+
+    ret = !manifest_writer->had_errors;
+
+    if (fclose(manifest_writer->handle) != 0)
+    {
+        ret = FALSE;
+    }
+
+    free((void*) manifest_writer);
+
+    return ret;
+}
+
+BOOL
+uhashtools_manifest_merkle_node_add
+(
+    struct ManifestMerkleNode* merkle_node,
+    enum ManifestEntryType type,
+    const wchar_t* name,
+    const struct HashDigest* digest
+)
+{
+    /* Type, UTF-8 name with terminator and the digest */
+    const size_t max_entry_size = 1 + FILEPATH_BUFFER_TSIZE * 3 + HASH_DIGEST_MAX_SIZE;
+    int name_size = 0;
+
+    UHASHTOOLS_ASSERT(merkle_node, L"Internal error: merkle_node is NULL!");
+    UHASHTOOLS_ASSERT(name && digest, L"Internal error: Entered with name == NULL or digest == NULL!");
+
+    if (merkle_node->data_capacity - merkle_node->data_size < max_entry_size)
+    {
+        size_t new_capacity = merkle_node->data_capacity * 2;
+        unsigned char* new_data = NULL;
+
+        if (new_capacity < merkle_node->data_size + max_entry_size)
+        {
+            new_capacity = merkle_node->data_size + max_entry_size;
+        }
+
+        if (new_capacity < MANIFEST_MERKLE_NODE_MIN_CAPACITY)
+        {
+            new_capacity = MANIFEST_MERKLE_NODE_MIN_CAPACITY;
+        }
+
+        new_data = (unsigned char*) realloc((void*) merkle_node->data, new_capacity);
+
+        if (!new_data)
+        {
+            return FALSE;
+        }
+
+        merkle_node->data = new_data;
+        merkle_node->data_capacity = new_capacity;
+    }
+
+    merkle_node->data[merkle_node->data_size] = type == ManifestEntryType_DIRECTORY ? 'D' : 'F';
+
+    name_size = WideCharToMultiByte(CP_UTF8,
+                                    0,
+                                    name,
+                                    -1,
+                                    (char*) merkle_node->data + merkle_node->data_size + 1,
+                                    FILEPATH_BUFFER_TSIZE * 3,
+                                    NULL,
+                                    NULL);
+
+    UHASHTOOLS_ASSERT(name_size > 0, L"Internal error: Failed to encode the entry name!");
+
+    (void) memcpy((void*) (merkle_node->data + merkle_node->data_size + 1 + (size_t) name_size),
+                  (const void*) digest->bytes,
+                  digest->size);
+
+    merkle_node->data_size += 1 + (size_t) name_size + digest->size;
+
+    return TRUE;
+}
+
+BOOL
+uhashtools_manifest_merkle_node_finish
+(
+    struct ManifestMerkleNode* merkle_node,
+    struct HashDigest* digest,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize
+)
+{
+    BOOL ret = FALSE;
+
+    UHASHTOOLS_ASSERT(merkle_node, L"Internal error: merkle_node is NULL!");
+
+    ret = uhashtools_hash_calculator_impl_hash_buffer_to_digest(merkle_node->data,
+                                                                merkle_node->data_size,
+                                                                digest,
+                                                                error_message_buf,
+                                                                error_message_buf_tsize);
+
+    merkle_node->data_size = 0;
+
+    return ret;
+}
+
+void
+uhashtools_manifest_merkle_node_free
+(
+    struct ManifestMerkleNode* merkle_node
+)
+{
+    UHASHTOOLS_ASSERT(merkle_node, L"Internal error: merkle_node is NULL!");
+
+    free((void*) merkle_node->data);
+    (void) memset((void*) merkle_node, 0, sizeof *merkle_node);
+}
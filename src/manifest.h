@@ -0,0 +1,292 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "buffer_sizes.h"
+#include "hash_calculation_impl.h"
+
+#include <Windows.h>
+
+/*
+ * A manifest stores the digests of all files of a directory tree
+ * together with their sizes and last write times, and a Merkle digest
+ * for every directory. Since a directory digest covers its whole
+ * subtree, the root digest identifies the content of the whole tree.
+ * 
+ * The manifest is a UTF-8 text file with one entry per line:
+ * 
+ *   # uhashtools manifest 1 <digest size>
+ *   D <hex digest> <subtree lines> <relative path>
+ *   F <hex digest> <size> <last write time> <relative path>
+ * 
+ * The entries are stored in depth-first order, the first entry is the
+ * root directory with the relative path ".". The entries of each
+ * directory are sorted with "uhashtools_manifest_compare_names()" and
+ * the subtree of a directory follows directly after its line. The
+ * "<subtree lines>" of a directory is the amount of lines of its
+ * subtree, so a subtree can be skipped without looking at its entries.
+ * The last write time is a FILETIME value in decimal.
+ * 
+ * The Merkle digest of a directory is the digest over the concatenation
+ * of its sorted entries, each encoded as:
+ * 
+ *   'F' or 'D', UTF-8 name, '\0', digest of the entry
+ */
+
+/* Size of a manifest line in bytes. Fits a path of FILEPATH_BUFFER_TSIZE characters encoded as UTF-8. */
+#define MANIFEST_LINE_BUFFER_SIZE (FILEPATH_BUFFER_TSIZE * 3 + 256)
+
+enum ManifestEntryType
+{
+    ManifestEntryType_FILE,
+    ManifestEntryType_DIRECTORY
+};
+
+/**
+ * Entry of a manifest as read by "uhashtools_manifest_reader_next()".
+ */
+struct ManifestEntry
+{
+    enum ManifestEntryType type;
+    struct HashDigest digest;
+
+    /* Only set for files. */
+    unsigned __int64 file_size;
+    unsigned __int64 last_write_time;
+
+    /* Only set for directories. */
+    unsigned __int64 subtree_lines_count;
+
+    /* Last component of the relative path or "." for the root directory. */
+    wchar_t name[FILEPATH_BUFFER_TSIZE];
+};
+
+/**
+ * Collects the entries of a directory for its Merkle digest.
+ * The default initialisation is to do a memset zero.
+ */
+struct ManifestMerkleNode
+{
+    unsigned char* data;
+    size_t data_size;
+    size_t data_capacity;
+};
+
+/**
+ * Position of a directory line which is filled in after its subtree has
+ * been written.
+ */
+struct ManifestDirectoryMark
+{
+    __int64 file_offset;
+    unsigned __int64 line_index;
+};
+
+struct ManifestReader;
+struct ManifestWriter;
+
+/**
+ * Defines the order of the entries of a directory.
+ * 
+ * @return Less than, equal to or greater than zero like "wcscmp()".
+ */
+extern
+int
+uhashtools_manifest_compare_names
+(
+    const wchar_t* left_name,
+    const wchar_t* right_name
+);
+
+/**
+ * Opens a manifest for reading and checks its header.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if
+ *                          the manifest can't be opened.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param manifest_file Path of the manifest.
+ * @param digest_size Size of the digests of the product in bytes.
+ * 
+ * @return Opened reader or NULL on failure.
+ */
+extern
+struct ManifestReader*
+uhashtools_manifest_reader_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* manifest_file,
+    unsigned int digest_size
+);
+
+/**
+ * Reads the next entry.
+ * 
+ * @param manifest_reader Opened reader.
+ * @param entry Receives the entry.
+ * 
+ * @return TRUE if an entry has been read and FALSE at the end of the
+ *         manifest or if the line is malformed (see
+ *         "uhashtools_manifest_reader_is_corrupted()").
+ */
+extern
+BOOL
+uhashtools_manifest_reader_next
+(
+    struct ManifestReader* manifest_reader,
+    struct ManifestEntry* entry
+);
+
+/**
+ * @return TRUE if a malformed line or a read error has been found.
+ */
+extern
+BOOL
+uhashtools_manifest_reader_is_corrupted
+(
+    const struct ManifestReader* manifest_reader
+);
+
+/**
+ * Closes the reader. Passing NULL is allowed.
+ */
+extern
+void
+uhashtools_manifest_reader_close
+(
+    struct ManifestReader* manifest_reader
+);
+
+/**
+ * Creates a manifest and writes its header.
+ * 
+ * @param error_message_buf Buffer which receives the user error message if
+ *                          the manifest can't be created.
+ * @param error_message_buf_tsize Size of "error_message_buf" in wide characters.
+ * @param manifest_file Path of the manifest. An existing file is replaced.
+ * @param digest_size Size of the digests of the product in bytes.
+ * 
+ * @return Opened writer or NULL on failure.
+ */
+extern
+struct ManifestWriter*
+uhashtools_manifest_writer_open
+(
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize,
+    const wchar_t* manifest_file,
+    unsigned int digest_size
+);
+
+/**
+ * Writes the line of a directory before its subtree is known. The digest
+ * and the amount of subtree lines are filled in by
+ * "uhashtools_manifest_writer_end_directory()".
+ * 
+ * @param manifest_writer Opened writer.
+ * @param relative_path Path relative to the root directory or ".".
+ * @param directory_mark Receives the position of the line.
+ * 
+ * @return FALSE if writing failed.
+ */
+extern
+BOOL
+uhashtools_manifest_writer_begin_directory
+(
+    struct ManifestWriter* manifest_writer,
+    const wchar_t* relative_path,
+    struct ManifestDirectoryMark* directory_mark
+);
+
+/**
+ * Fills in the line of a directory after its subtree has been written.
+ * 
+ * @param manifest_writer Opened writer.
+ * @param directory_mark Position returned by "uhashtools_manifest_writer_begin_directory()".
+ * @param digest Merkle digest of the directory.
+ * 
+ * @return FALSE if writing failed.
+ */
+extern
+BOOL
+uhashtools_manifest_writer_end_directory
+(
+    struct ManifestWriter* manifest_writer,
+    const struct ManifestDirectoryMark* directory_mark,
+    const struct HashDigest* digest
+);
+
+/**
+ * Writes the line of a file.
+ * 
+ * @return FALSE if writing failed.
+ */
+extern
+BOOL
+uhashtools_manifest_writer_add_file
+(
+    struct ManifestWriter* manifest_writer,
+    const wchar_t* relative_path,
+    const struct HashDigest* digest,
+    unsigned __int64 file_size,
+    unsigned __int64 last_write_time
+);
+
+/**
+ * Closes the writer. Passing NULL is allowed.
+ * 
+ * @return FALSE if writing the remaining data failed.
+ */
+extern
+BOOL
+uhashtools_manifest_writer_close
+(
+    struct ManifestWriter* manifest_writer
+);
+
+/**
+ * Appends an entry to the Merkle node of its directory.
+ * 
+ * @return FALSE if the memory allocation failed.
+ */
+extern
+BOOL
+uhashtools_manifest_merkle_node_add
+(
+    struct ManifestMerkleNode* merkle_node,
+    enum ManifestEntryType type,
+    const wchar_t* name,
+    const struct HashDigest* digest
+);
+
+/**
+ * Calculates the Merkle digest of the added entries and empties the node.
+ * 
+ * @return FALSE if the calculation failed. The user error message is
+ *         written into "error_message_buf".
+ */
+extern
+BOOL
+uhashtools_manifest_merkle_node_finish
+(
+    struct ManifestMerkleNode* merkle_node,
+    struct HashDigest* digest,
+    wchar_t* error_message_buf,
+    size_t error_message_buf_tsize
+);
+
+/**
+ * Frees the memory of the node.
+ */
+extern
+void
+uhashtools_manifest_merkle_node_free
+(
+    struct ManifestMerkleNode* merkle_node
+);
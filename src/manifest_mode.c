@@ -0,0 +1,904 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "manifest_mode.h"
+
+#include "buffer_sizes.h"
+#include "directory_walker.h"
+#include "error_utilities.h"
+#include "hash_calculation_impl.h"
+#include "manifest.h"
+#include "print_utilities.h"
+#include "product.h"
+#include "std_streams.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MANIFEST_MODE_LISTING_INITIAL_CAPACITY 64
+
+struct ManifestModeListedEntry
+{
+    wchar_t* name;
+    BOOL is_directory;
+    unsigned __int64 file_size;
+    unsigned __int64 last_write_time;
+};
+
+/* Entries of a single directory, sorted by "uhashtools_manifest_compare_names()". */
+struct ManifestModeListing
+{
+    struct ManifestModeListedEntry* entries;
+    size_t entries_count;
+    size_t entries_capacity;
+    BOOL is_out_of_memory;
+};
+
+struct ManifestModeCtx
+{
+    /* Path of the current entry. The relative path starts behind the first "root_path_len" characters. */
+    wchar_t path_buf[FILEPATH_BUFFER_TSIZE];
+    size_t root_path_len;
+
+    unsigned char* file_read_buf;
+    wchar_t* result_string_buf;
+
+    /* Set for errors which stop the whole run. */
+    wchar_t error_message_buf[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+
+    struct ManifestWriter* manifest_writer;
+    struct ManifestReader* manifest_reader;
+
+    BOOL had_errors;
+    unsigned __int64 hashed_files_count;
+    unsigned __int64 skipped_files_count;
+    unsigned __int64 changed_files_count;
+    unsigned __int64 added_entries_count;
+    unsigned __int64 removed_entries_count;
+    unsigned __int64 recalculated_directories_count;
+};
+
+static
+const wchar_t*
+uhashtools_manifest_mode_get_relative_path
+(
+    const struct ManifestModeCtx* ctx
+)
+{
+    if (ctx->path_buf[ctx->root_path_len] == L'\0')
+    {
+        return L".";
+    }
+
+    return ctx->path_buf + ctx->root_path_len + 1;
+}
+
+/*
+ * Appends "\<name>" to the path of the directory in "path_buf". Returns
+ * the new length of the path or zero if the path is too long, in which
+ * case the entry is skipped.
+ */
+static
+size_t
+uhashtools_manifest_mode_append_name
+(
+    struct ManifestModeCtx* ctx,
+    size_t path_len,
+    const wchar_t* name
+)
+{
+    const size_t entry_path_len = path_len + 1 + wcslen(name);
+
+    /* The entry must also fit for appending "\*" if it's a directory. */
+    if (entry_path_len + 3 > FILEPATH_BUFFER_TSIZE)
+    {
+        (void) fwprintf_s(stderr, L"%s\\%s: The path is too long and has been skipped!\n", ctx->path_buf, name);
+        ctx->had_errors = TRUE;
+
+        return 0;
+    }
+
+    ctx->path_buf[path_len] = L'\\';
+    (void) wcscpy_s(ctx->path_buf + path_len + 1, FILEPATH_BUFFER_TSIZE - path_len - 1, name);
+
+    return entry_path_len;
+}
+
+static
+void
+uhashtools_manifest_mode_print_entry
+(
+    struct ManifestModeCtx* ctx,
+    const wchar_t* label,
+    const struct HashDigest* digest,
+    BOOL is_directory
+)
+{
+    (void) uhashtools_hash_calculator_impl_digest_to_hex(digest, ctx->result_string_buf, HASH_RESULT_BUFFER_TSIZE);
+
+    /* Directories are marked with a trailing separator. */
+    (void) wprintf_s(L"%s %s *%s%s\n", label, ctx->result_string_buf, ctx->path_buf, is_directory ? L"\\" : L"");
+}
+
+/* Hashes the file in "path_buf". Failures are reported and skip the file. */
+static
+BOOL
+uhashtools_manifest_mode_hash_file
+(
+    struct ManifestModeCtx* ctx,
+    struct HashDigest* digest
+)
+{
+    enum HashCalculatorResultCode hash_rc = HashCalculatorResultCode_FAILED;
+
+    hash_rc = uhashtools_hash_calculator_impl_hash_file_to_digest(ctx->file_read_buf,
+                                                                  FILE_READ_BUF_TSIZE,
+                                                                  digest,
+                                                                  ctx->result_string_buf,
+                                                                  HASH_RESULT_BUFFER_TSIZE,
+                                                                  ctx->path_buf,
+                                                                  NULL,
+                                                                  NULL,
+                                                                  NULL,
+                                                                  NULL);
+
+    if (hash_rc != HashCalculatorResultCode_SUCCESS)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", ctx->path_buf, ctx->result_string_buf);
+        ctx->had_errors = TRUE;
+
+        return FALSE;
+    }
+
+    ++ctx->hashed_files_count;
+
+    return TRUE;
+}
+
+/* Collects the entries for "uhashtools_directory_walker_list()". */
+static
+BOOL
+uhashtools_manifest_mode_on_entry_found
+(
+    const struct DirectoryWalkerEntry* entry,
+    void* userdata
+)
+{
+    struct ManifestModeListing* listing = (struct ManifestModeListing*) userdata;
+    struct ManifestModeListedEntry* new_entry = NULL;
+
+    if (listing->entries_count == listing->entries_capacity)
+    {
+        const size_t new_capacity = listing->entries_capacity ? listing->entries_capacity * 2 : MANIFEST_MODE_LISTING_INITIAL_CAPACITY;
+        struct ManifestModeListedEntry* new_entries = (struct ManifestModeListedEntry*) realloc((void*) listing->entries,
+                                                                                               new_capacity * sizeof *new_entries);
+
+        if (!new_entries)
+        {
+            listing->is_out_of_memory = TRUE;
+
+            return FALSE;
+        }
+
+        listing->entries = new_entries;
+        listing->entries_capacity = new_capacity;
+    }
+
+    new_entry = &listing->entries[listing->entries_count];
+    new_entry->name = _wcsdup(entry->name);
+    new_entry->is_directory = entry->is_directory;
+    new_entry->file_size = entry->file_size;
+    new_entry->last_write_time = entry->last_write_time;
+
+    if (!new_entry->name)
+    {
+        listing->is_out_of_memory = TRUE;
+
+        return FALSE;
+    }
+
+    ++listing->entries_count;
+
+    return TRUE;
+}
+
+static
+int
+uhashtools_manifest_mode_compare_listed_entries
+(
+    const void* left,
+    const void* right
+)
+{
+    const struct ManifestModeListedEntry* left_entry = (const struct ManifestModeListedEntry*) left;
+    const struct ManifestModeListedEntry* right_entry = (const struct ManifestModeListedEntry*) right;
+
+    return uhashtools_manifest_compare_names(left_entry->name, right_entry->name);
+}
+
+static
+void
+uhashtools_manifest_mode_free_listing
+(
+    struct ManifestModeListing* listing
+)
+{
+    size_t i = 0;
+
+    for (i = 0; i < listing->entries_count; ++i)
+    {
+        free((void*) listing->entries[i].name);
+    }
+
+    free((void*) listing->entries);
+    (void) memset((void*) listing, 0, sizeof *listing);
+}
+
+/*
+ * Lists the directory in "path_buf" in manifest order. A directory which
+ * can't be listed is reported and treated as empty. Returns FALSE only if
+ * the memory allocation failed.
+ */
+static
+BOOL
+uhashtools_manifest_mode_list_directory
+(
+    struct ManifestModeCtx* ctx,
+    struct ManifestModeListing* listing
+)
+{
+    (void) memset((void*) listing, 0, sizeof *listing);
+
+    if (!uhashtools_directory_walker_list(ctx->path_buf,
+                                          &uhashtools_manifest_mode_on_entry_found,
+                                          (void*) listing))
+    {
+        if (listing->is_out_of_memory)
+        {
+            (void) wcscpy_s(ctx->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, L"Failed to allocate the required memory. Please download more RAM!");
+
+            return FALSE;
+        }
+
+        (void) fwprintf_s(stderr, L"%s: Failed to list the directory!\n", ctx->path_buf);
+        ctx->had_errors = TRUE;
+
+        uhashtools_manifest_mode_free_listing(listing);
+
+        return TRUE;
+    }
+
+    if (listing->entries_count > 0)
+    {
+        qsort((void*) listing->entries,
+              listing->entries_count,
+              sizeof *listing->entries,
+              &uhashtools_manifest_mode_compare_listed_entries);
+    }
+
+    return TRUE;
+}
+
+/*
+ * Completes the Merkle digest of a directory. Returns FALSE and sets the
+ * error message if the calculation failed.
+ */
+static
+BOOL
+uhashtools_manifest_mode_finish_directory
+(
+    struct ManifestModeCtx* ctx,
+    struct ManifestMerkleNode* merkle_node,
+    struct HashDigest* digest
+)
+{
+    if (!uhashtools_manifest_merkle_node_finish(merkle_node,
+                                                digest,
+                                                ctx->error_message_buf,
+                                                GENERIC_TXT_MESSAGES_BUFFER_TSIZE))
+    {
+        return FALSE;
+    }
+
+    ++ctx->recalculated_directories_count;
+
+    return TRUE;
+}
+
+/*
+ * Writes the subtree of the directory in "path_buf" into the manifest
+ * and calculates its Merkle digest. Returns FALSE if the run has to be
+ * stopped, the reason is in "error_message_buf".
+ */
+static
+BOOL
+uhashtools_manifest_mode_write_directory
+(
+    struct ManifestModeCtx* ctx,
+    size_t path_len,
+    struct HashDigest* digest
+)
+{
+    BOOL ret = FALSE;
+    struct ManifestModeListing listing;
+    struct ManifestMerkleNode merkle_node;
+    struct ManifestDirectoryMark directory_mark;
+    size_t i = 0;
+
+    (void) memset((void*) &listing, 0, sizeof listing);
+    (void) memset((void*) &merkle_node, 0, sizeof merkle_node);
+
+    if (!uhashtools_manifest_writer_begin_directory(ctx->manifest_writer,
+                                                    uhashtools_manifest_mode_get_relative_path(ctx),
+                                                    &directory_mark))
+    {
+        (void) wcscpy_s(ctx->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, L"Failed to write the manifest!");
+
+        goto cleanup_and_out;
+    }
+
+    if (!uhashtools_manifest_mode_list_directory(ctx, &listing))
+    {
+        goto cleanup_and_out;
+    }
+
+    for (i = 0; i < listing.entries_count; ++i)
+    {
+        const struct ManifestModeListedEntry* listed_entry = &listing.entries[i];
+        const size_t entry_path_len = uhashtools_manifest_mode_append_name(ctx, path_len, listed_entry->name);
+        struct HashDigest entry_digest;
+
+        if (entry_path_len == 0)
+        {
+            continue;
+        }
+
+        if (listed_entry->is_directory)
+        {
+            if (!uhashtools_manifest_mode_write_directory(ctx, entry_path_len, &entry_digest))
+            {
+                goto cleanup_and_out;
+            }
+        }
+        else
+        {
+            /* Files which can't be hashed aren't part of the manifest. */
+            if (!uhashtools_manifest_mode_hash_file(ctx, &entry_digest))
+            {
+                ctx->path_buf[path_len] = L'\0';
+                continue;
+            }
+
+            if (!uhashtools_manifest_writer_add_file(ctx->manifest_writer,
+                                                     uhashtools_manifest_mode_get_relative_path(ctx),
+                                                     &entry_digest,
+                                                     listed_entry->file_size,
+                                                     listed_entry->last_write_time))
+            {
+                (void) wcscpy_s(ctx->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, L"Failed to write the manifest!");
+
+                goto cleanup_and_out;
+            }
+        }
+
+        ctx->path_buf[path_len] = L'\0';
+
+        if (!uhashtools_manifest_merkle_node_add(&merkle_node,
+                                                 listed_entry->is_directory ? ManifestEntryType_DIRECTORY : ManifestEntryType_FILE,
+                                                 listed_entry->name,
+                                                 &entry_digest))
+        {
+            (void) wcscpy_s(ctx->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, L"Failed to allocate the required memory. Please download more RAM!");
+
+            goto cleanup_and_out;
+        }
+    }
+
+    if (!uhashtools_manifest_mode_finish_directory(ctx, &merkle_node, digest))
+    {
+        goto cleanup_and_out;
+    }
+
+    if (!uhashtools_manifest_writer_end_directory(ctx->manifest_writer, &directory_mark, digest))
+    {
+        (void) wcscpy_s(ctx->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, L"Failed to write the manifest!");
+
+        goto cleanup_and_out;
+    }
+
+    ret = TRUE;
+
+cleanup_and_out:
+    ctx->path_buf[path_len] = L'\0';
+    uhashtools_manifest_merkle_node_free(&merkle_node);
+    uhashtools_manifest_mode_free_listing(&listing);
+
+    return ret;
+}
+
+/*
+ * Reads the next entry of the manifest which belongs to the directory
+ * whose subtree has "*remaining_lines_count" unread lines.
+ */
+static
+BOOL
+uhashtools_manifest_mode_read_child
+(
+    struct ManifestModeCtx* ctx,
+    unsigned __int64* remaining_lines_count,
+    struct ManifestEntry* manifest_entry
+)
+{
+    unsigned __int64 entry_lines_count = 1;
+
+    if (!uhashtools_manifest_reader_next(ctx->manifest_reader, manifest_entry))
+    {
+        (void) wcscpy_s(ctx->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, L"The manifest is corrupted!");
+
+        return FALSE;
+    }
+
+    if (manifest_entry->type == ManifestEntryType_DIRECTORY)
+    {
+        entry_lines_count += manifest_entry->subtree_lines_count;
+    }
+
+    /* The subtree of a child has to fit into the subtree of its parent. */
+    if (entry_lines_count < manifest_entry->subtree_lines_count || entry_lines_count > *remaining_lines_count)
+    {
+        (void) wcscpy_s(ctx->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, L"The manifest is corrupted!");
+
+        return FALSE;
+    }
+
+    *remaining_lines_count -= entry_lines_count;
+
+    return TRUE;
+}
+
+/* Skips the subtree of a directory which doesn't exist anymore. */
+static
+BOOL
+uhashtools_manifest_mode_skip_subtree
+(
+    struct ManifestModeCtx* ctx,
+    unsigned __int64 subtree_lines_count
+)
+{
+    struct ManifestEntry skipped_entry;
+
+    while (subtree_lines_count > 0)
+    {
+        if (!uhashtools_manifest_reader_next(ctx->manifest_reader, &skipped_entry))
+        {
+            (void) wcscpy_s(ctx->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, L"The manifest is corrupted!");
+
+            return FALSE;
+        }
+
+        --subtree_lines_count;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Compares the subtree of the directory in "path_buf" with the manifest.
+ * The sorted entries of the directory are merged with the entries of the
+ * manifest, which are stored in the same order. "manifest_directory" is
+ * NULL if the directory isn't in the manifest.
+ * 
+ * The Merkle digest of the directory is only calculated again if
+ * anything below it has changed, else the digest of the manifest is
+ * used. Returns FALSE if the run has to be stopped, the reason is in
+ * "error_message_buf".
+ */
+static
+BOOL
+uhashtools_manifest_mode_verify_directory
+(
+    struct ManifestModeCtx* ctx,
+    size_t path_len,
+    const struct ManifestEntry* manifest_directory,
+    struct HashDigest* digest,
+    BOOL* is_changed
+)
+{
+    BOOL ret = FALSE;
+    struct ManifestModeListing listing;
+    struct ManifestMerkleNode merkle_node;
+    struct ManifestEntry manifest_entry;
+    BOOL has_manifest_entry = FALSE;
+    unsigned __int64 remaining_lines_count = 0;
+    size_t i = 0;
+
+    (void) memset((void*) &listing, 0, sizeof listing);
+    (void) memset((void*) &merkle_node, 0, sizeof merkle_node);
+
+    /* An added directory is a change of its parent even if it's empty. */
+    *is_changed = manifest_directory == NULL;
+
+    if (manifest_directory)
+    {
+        remaining_lines_count = manifest_directory->subtree_lines_count;
+    }
+
+    if (!uhashtools_manifest_mode_list_directory(ctx, &listing))
+    {
+        goto cleanup_and_out;
+    }
+
+    for (;;)
+    {
+        const struct ManifestModeListedEntry* listed_entry = NULL;
+        size_t entry_path_len = 0;
+        int order = 0;
+        struct HashDigest entry_digest;
+
+        if (!has_manifest_entry && remaining_lines_count > 0)
+        {
+            if (!uhashtools_manifest_mode_read_child(ctx, &remaining_lines_count, &manifest_entry))
+            {
+                goto cleanup_and_out;
+            }
+
+            has_manifest_entry = TRUE;
+        }
+
+        if (!has_manifest_entry && i == listing.entries_count)
+        {
+            break;
+        }
+
+        /* Negative if only the listed entry exists and positive if only the manifest entry exists. */
+        if (!has_manifest_entry)
+        {
+            order = -1;
+        }
+        else if (i == listing.entries_count)
+        {
+            order = 1;
+        }
+        else
+        {
+            order = uhashtools_manifest_compare_names(listing.entries[i].name, manifest_entry.name);
+
+            /* A file which has been replaced by a directory or vice versa is removed and added. */
+            if (order == 0 && listing.entries[i].is_directory != (manifest_entry.type == ManifestEntryType_DIRECTORY))
+            {
+                order = 1;
+            }
+        }
+
+        if (order > 0)
+        {
+            entry_path_len = uhashtools_manifest_mode_append_name(ctx, path_len, manifest_entry.name);
+
+            if (entry_path_len > 0)
+            {
+                uhashtools_manifest_mode_print_entry(ctx, L"REMOVED", &manifest_entry.digest, manifest_entry.type == ManifestEntryType_DIRECTORY);
+                ctx->path_buf[path_len] = L'\0';
+            }
+
+            if (manifest_entry.type == ManifestEntryType_DIRECTORY &&
+                !uhashtools_manifest_mode_skip_subtree(ctx, manifest_entry.subtree_lines_count))
+            {
+                goto cleanup_and_out;
+            }
+
+            ++ctx->removed_entries_count;
+            has_manifest_entry = FALSE;
+            *is_changed = TRUE;
+
+            continue;
+        }
+
+        listed_entry = &listing.entries[i++];
+        entry_path_len = uhashtools_manifest_mode_append_name(ctx, path_len, listed_entry->name);
+
+        if (entry_path_len == 0)
+        {
+            if (order == 0 && manifest_entry.type == ManifestEntryType_DIRECTORY &&
+                !uhashtools_manifest_mode_skip_subtree(ctx, manifest_entry.subtree_lines_count))
+            {
+                goto cleanup_and_out;
+            }
+
+            has_manifest_entry = has_manifest_entry && order != 0;
+            *is_changed = TRUE;
+
+            continue;
+        }
+
+        if (listed_entry->is_directory)
+        {
+            BOOL is_subtree_changed = FALSE;
+
+            if (!uhashtools_manifest_mode_verify_directory(ctx,
+                                                           entry_path_len,
+                                                           order == 0 ? &manifest_entry : NULL,
+                                                           &entry_digest,
+                                                           &is_subtree_changed))
+            {
+                goto cleanup_and_out;
+            }
+
+            *is_changed |= is_subtree_changed;
+        }
+        else if (order == 0 &&
+                 listed_entry->file_size == manifest_entry.file_size &&
+                 listed_entry->last_write_time == manifest_entry.last_write_time)
+        {
+            entry_digest = manifest_entry.digest;
+            ++ctx->skipped_files_count;
+        }
+        else if (!uhashtools_manifest_mode_hash_file(ctx, &entry_digest))
+        {
+            /* A file which can't be hashed isn't part of the digest of its directory. */
+            ctx->path_buf[path_len] = L'\0';
+            has_manifest_entry = has_manifest_entry && order != 0;
+            *is_changed = TRUE;
+
+            continue;
+        }
+        else if (order != 0)
+        {
+            uhashtools_manifest_mode_print_entry(ctx, L"ADDED", &entry_digest, FALSE);
+            ++ctx->added_entries_count;
+            *is_changed = TRUE;
+        }
+        else if (memcmp((const void*) entry_digest.bytes, (const void*) manifest_entry.digest.bytes, entry_digest.size) != 0)
+        {
+            uhashtools_manifest_mode_print_entry(ctx, L"CHANGED", &entry_digest, FALSE);
+            ++ctx->changed_files_count;
+            *is_changed = TRUE;
+        }
+
+        ctx->path_buf[path_len] = L'\0';
+
+        if (order == 0)
+        {
+            has_manifest_entry = FALSE;
+        }
+
+        if (!uhashtools_manifest_merkle_node_add(&merkle_node,
+                                                 listed_entry->is_directory ? ManifestEntryType_DIRECTORY : ManifestEntryType_FILE,
+                                                 listed_entry->name,
+                                                 &entry_digest))
+        {
+            (void) wcscpy_s(ctx->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, L"Failed to allocate the required memory. Please download more RAM!");
+
+            goto cleanup_and_out;
+        }
+    }
+
+    if (*is_changed)
+    {
+        if (!uhashtools_manifest_mode_finish_directory(ctx, &merkle_node, digest))
+        {
+            goto cleanup_and_out;
+        }
+    }
+    else
+    {
+        *digest = manifest_directory->digest;
+    }
+
+    ret = TRUE;
+
+cleanup_and_out:
+    ctx->path_buf[path_len] = L'\0';
+    uhashtools_manifest_merkle_node_free(&merkle_node);
+    uhashtools_manifest_mode_free_listing(&listing);
+
+    return ret;
+}
+
+static
+int
+uhashtools_manifest_mode_write
+(
+    struct ManifestModeCtx* ctx,
+    const struct CliArguments* cli_arguments
+)
+{
+    struct HashDigest root_digest;
+    BOOL is_written = FALSE;
+
+    ctx->manifest_writer = uhashtools_manifest_writer_open(ctx->error_message_buf,
+                                                           GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                           cli_arguments->manifest_file,
+                                                           (unsigned int) uhashtools_product_get_builtin_hasher_digest_size());
+
+    if (!ctx->manifest_writer)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", cli_arguments->manifest_file, ctx->error_message_buf);
+
+        return 1;
+    }
+
+    is_written = uhashtools_manifest_mode_write_directory(ctx, ctx->root_path_len, &root_digest);
+
+    if (!uhashtools_manifest_writer_close(ctx->manifest_writer) && is_written)
+    {
+        (void) wcscpy_s(ctx->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, L"Failed to write the manifest!");
+        is_written = FALSE;
+    }
+
+    ctx->manifest_writer = NULL;
+
+    if (!is_written)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", cli_arguments->manifest_file, ctx->error_message_buf);
+
+        return 1;
+    }
+
+    (void) uhashtools_hash_calculator_impl_digest_to_hex(&root_digest, ctx->result_string_buf, HASH_RESULT_BUFFER_TSIZE);
+
+    (void) wprintf_s(L"# %I64u files hashed, root digest %s\n",
+                     ctx->hashed_files_count,
+                     ctx->result_string_buf);
+
+    (void) fflush(stdout);
+
+    return ctx->had_errors ? 1 : 0;
+}
+
+static
+int
+uhashtools_manifest_mode_verify
+(
+    struct ManifestModeCtx* ctx,
+    const struct CliArguments* cli_arguments
+)
+{
+    int ret = 1;
+    struct ManifestEntry root_entry;
+    struct ManifestEntry trailing_entry;
+    struct HashDigest root_digest;
+    BOOL is_changed = FALSE;
+
+    ctx->manifest_reader = uhashtools_manifest_reader_open(ctx->error_message_buf,
+                                                           GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                           cli_arguments->manifest_file,
+                                                           (unsigned int) uhashtools_product_get_builtin_hasher_digest_size());
+
+    if (!ctx->manifest_reader)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", cli_arguments->manifest_file, ctx->error_message_buf);
+
+        goto cleanup_and_out;
+    }
+
+    (void) wcscpy_s(ctx->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, L"The manifest is corrupted!");
+
+    if (!uhashtools_manifest_reader_next(ctx->manifest_reader, &root_entry) ||
+        root_entry.type != ManifestEntryType_DIRECTORY ||
+        wcscmp(root_entry.name, L".") != 0)
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", cli_arguments->manifest_file, ctx->error_message_buf);
+
+        goto cleanup_and_out;
+    }
+
+    /* All lines have to belong to the subtree of the root directory. */
+    if (!uhashtools_manifest_mode_verify_directory(ctx, ctx->root_path_len, &root_entry, &root_digest, &is_changed) ||
+        uhashtools_manifest_reader_next(ctx->manifest_reader, &trailing_entry) ||
+        uhashtools_manifest_reader_is_corrupted(ctx->manifest_reader))
+    {
+        (void) fwprintf_s(stderr, L"%s: %s\n", cli_arguments->manifest_file, ctx->error_message_buf);
+
+        goto cleanup_and_out;
+    }
+
+    (void) wprintf_s(L"# %I64u files changed, %I64u entries added, %I64u entries removed\n",
+                     ctx->changed_files_count,
+                     ctx->added_entries_count,
+                     ctx->removed_entries_count);
+
+    (void) wprintf_s(L"# %I64u files hashed, %I64u files unchanged by size and last write time, %I64u directory digests recalculated\n",
+                     ctx->hashed_files_count,
+                     ctx->skipped_files_count,
+                     ctx->recalculated_directories_count);
+
+    (void) uhashtools_hash_calculator_impl_digest_to_hex(&root_digest, ctx->result_string_buf, HASH_RESULT_BUFFER_TSIZE);
+
+    if (memcmp((const void*) root_digest.bytes, (const void*) root_entry.digest.bytes, root_digest.size) == 0)
+    {
+        (void) wprintf_s(L"# Root digest %s matches the manifest\n", ctx->result_string_buf);
+    }
+    else
+    {
+        (void) wprintf_s(L"# Root digest %s differs from the manifest\n", ctx->result_string_buf);
+    }
+
+    (void) fflush(stdout);
+
+    if (!is_changed && !ctx->had_errors)
+    {
+        ret = 0;
+    }
+
+cleanup_and_out:
+    uhashtools_manifest_reader_close(ctx->manifest_reader);
+    ctx->manifest_reader = NULL;
+
+    return ret;
+}
+
+int
+uhashtools_manifest_mode_run
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    int ret = 1;
+    struct ManifestModeCtx* ctx = NULL;
+
+    UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
+    UHASHTOOLS_ASSERT(uhashtools_cli_arguments_has_manifest_file(cli_arguments),
+                      L"Internal error: Entered manifest mode without a manifest file!");
+
+    uhashtools_std_streams_connect();
+
+    ctx = (struct ManifestModeCtx*) malloc(sizeof *ctx);
+
+    if (!ctx)
+    {
+        (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+        return 1;
+    }
+
+    (void) memset((void*) ctx, 0, sizeof *ctx);
+
+    ctx->file_read_buf = (unsigned char*) malloc(FILE_READ_BUF_TSIZE);
+    ctx->result_string_buf = (wchar_t*) malloc(HASH_RESULT_BUFFER_TSIZE * sizeof *ctx->result_string_buf);
+
+    if (!ctx->file_read_buf || !ctx->result_string_buf)
+    {
+        (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+        goto cleanup_and_out;
+    }
+
+    (void) wcscpy_s(ctx->path_buf, FILEPATH_BUFFER_TSIZE, cli_arguments->manifest_directory);
+    ctx->root_path_len = wcslen(ctx->path_buf);
+
+    /* The separator is appended for every entry. */
+    while (ctx->root_path_len > 0 &&
+           (ctx->path_buf[ctx->root_path_len - 1] == L'\\' || ctx->path_buf[ctx->root_path_len - 1] == L'/'))
+    {
+        ctx->path_buf[--ctx->root_path_len] = L'\0';
+    }
+
+    if (ctx->root_path_len + 3 > FILEPATH_BUFFER_TSIZE)
+    {
+        (void) fwprintf_s(stderr, L"%s: The path is too long!\n", cli_arguments->manifest_directory);
+
+        goto cleanup_and_out;
+    }
+
+    if (cli_arguments->is_manifest_verify)
+    {
+        ret = uhashtools_manifest_mode_verify(ctx, cli_arguments);
+    }
+    else
+    {
+        ret = uhashtools_manifest_mode_write(ctx, cli_arguments);
+    }
+
+cleanup_and_out:
+    free((void*) ctx->result_string_buf);
+    free((void*) ctx->file_read_buf);
+    free((void*) ctx);
+
+    return ret;
+}
@@ -0,0 +1,42 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "cli_arguments.h"
+
+/*
+ * The manifest mode has two variants, both without creating a window:
+ * 
+ * "--write-manifest <manifest> <directory>" hashes every file of the
+ * directory tree and writes the manifest (see "manifest.h").
+ * 
+ * "--verify-manifest <manifest> <directory>" compares the directory tree
+ * with the manifest. Files whose size and last write time are unchanged
+ * aren't read again, their digests are taken from the manifest. Only the
+ * remaining files are hashed and only the Merkle digests of the
+ * directories on the path from a difference to the root are calculated
+ * again. Each difference is written to stdout as a line
+ * "CHANGED <hash> *<filepath>", "ADDED <hash> *<filepath>" or
+ * "REMOVED <hash> *<filepath>".
+ */
+
+/**
+ * Runs the manifest mode variant selected by the command line arguments.
+ * 
+ * @param cli_arguments Command line arguments with a set manifest file.
+ * 
+ * @return Exit code of the process. Zero if the manifest has been written
+ *         or if the directory tree matches the manifest else one.
+ */
+extern
+int
+uhashtools_manifest_mode_run
+(
+    const struct CliArguments* cli_arguments
+);
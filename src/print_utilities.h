@@ -8,60 +8,62 @@
 
 #pragma once
 
-#include <stdio.h>
+#include "logger.h"
+
+/*
+ * The log lines are written asynchronously by the logger (see "logger.h").
+ * Debug messages are only compiled into debug builds, so they don't cost
+ * anything within release builds.
+ */
 
 /**
- * This macro functions prints a formatted debug message line to stdout.
+ * This macro functions prints a formatted debug message line to stderr.
+ * Within release builds this macro function does nothing and the arguments
+ * aren't evaluated.
  * 
- * @param format wprintf_s() format control (datatype: const wchar_t*).
- * @param opt_arguments Optional wprintf_s() format arguments.
+ * @param format fwprintf_s() format control (datatype: const wchar_t*).
+ * @param opt_arguments Optional fwprintf_s() format arguments.
  */
+#ifdef _DEBUG
+#define UHASHTOOLS_PRINTF_LINE_DEBUG(...) \
+{ \
+    uhashtools_logger_write_line(LOGGER_LEVEL_DEBUG, __VA_ARGS__); \
+}
+#else
 #define UHASHTOOLS_PRINTF_LINE_DEBUG(...) \
 { \
-    (void) wprintf_s(L"[DEBUG]: "); \
-    (void) wprintf_s(__VA_ARGS__); \
-    (void) wprintf_s(L"\n"); \
-    (void) fflush(stdout); \
 }
+#endif
 
 /**
- * This macro functions prints a formatted information message line to stdout.
+ * This macro functions prints a formatted information message line to stderr.
  * 
- * @param format wprintf_s() format control (datatype: const wchar_t*).
- * @param opt_arguments Optional wprintf_s() format arguments.
+ * @param format fwprintf_s() format control (datatype: const wchar_t*).
+ * @param opt_arguments Optional fwprintf_s() format arguments.
  */
 #define UHASHTOOLS_PRINTF_LINE_INFO(...) \
 { \
-    (void) wprintf_s(L"[INFO]: "); \
-    (void) wprintf_s(__VA_ARGS__); \
-    (void) wprintf_s(L"\n"); \
-    (void) fflush(stdout); \
+    uhashtools_logger_write_line(LOGGER_LEVEL_INFO, __VA_ARGS__); \
 }
 
 /**
- * This macro functions prints a formatted warning message line to stdout.
+ * This macro functions prints a formatted warning message line to stderr.
  * 
- * @param format wprintf_s() format control (datatype: const wchar_t*).
- * @param opt_arguments Optional wprintf_s() format arguments.
+ * @param format fwprintf_s() format control (datatype: const wchar_t*).
+ * @param opt_arguments Optional fwprintf_s() format arguments.
  */
 #define UHASHTOOLS_PRINTF_LINE_WARN(...) \
 { \
-    (void) wprintf_s(L"[WARNING]: "); \
-    (void) wprintf_s(__VA_ARGS__); \
-    (void) wprintf_s(L"\n"); \
-    (void) fflush(stdout); \
+    uhashtools_logger_write_line(LOGGER_LEVEL_WARN, __VA_ARGS__); \
 }
 
 /**
- * This macro functions prints a formatted error message line to stdout.
+ * This macro functions prints a formatted error message line to stderr.
  * 
- * @param format wprintf_s() format control (datatype: const wchar_t*).
- * @param opt_arguments Optional wprintf_s() format arguments.
+ * @param format fwprintf_s() format control (datatype: const wchar_t*).
+ * @param opt_arguments Optional fwprintf_s() format arguments.
  */
 #define UHASHTOOLS_PRINTF_LINE_ERROR(...) \
 { \
-    (void) wprintf_s(L"[ERROR]: "); \
-    (void) wprintf_s(__VA_ARGS__); \
-    (void) wprintf_s(L"\n"); \
-    (void) fflush(stdout); \
+    uhashtools_logger_write_line(LOGGER_LEVEL_ERROR, __VA_ARGS__); \
 }
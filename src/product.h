@@ -31,9 +31,81 @@ uhashtools_product_get_recommended_mainwin_width
     void
 );
 
+/**
+ * @return Name of the hash algorithm for the Windows CNG API or NULL if the
+ *         Windows CNG API doesn't provide the hash algorithm. In the last case
+ *         the built-in hasher is used independent of the hash backend. The
+ *         built-in hasher is also used if the algorithm provider is missing
+ *         on the running Windows version (for example SHA-3 on Windows 10).
+ */
 extern
 const wchar_t*
 uhashtools_product_get_bcrypt_algorithm_str
 (
     void
 );
+
+/*
+ * The following functions are wrapping the built-in implementation of
+ * the hash algorithm of the product (see "builtin_*.h"). They are only
+ * used if the application has been built with "HASH_BACKEND=Builtin"
+ * or if the Windows CNG API doesn't provide the hash algorithm.
+ */
+
+extern
+size_t
+uhashtools_product_get_builtin_hasher_state_size
+(
+    void
+);
+
+extern
+size_t
+uhashtools_product_get_builtin_hasher_digest_size
+(
+    void
+);
+
+extern
+void
+uhashtools_product_builtin_hasher_init
+(
+    void* state
+);
+
+extern
+void
+uhashtools_product_builtin_hasher_update
+(
+    void* state,
+    const unsigned char* data,
+    size_t data_size
+);
+
+extern
+void
+uhashtools_product_builtin_hasher_finish
+(
+    void* state,
+    unsigned char* digest
+);
+
+/**
+ * Checks a hasher state which has been restored from a file before it's
+ * passed to "uhashtools_product_builtin_hasher_update()".
+ * 
+ * @param state Restored hasher state.
+ * @param hashed_size Amount of bytes which should have been hashed with
+ *                    the state. It's compared with the counters of the
+ *                    state as far as the hasher keeps them.
+ * 
+ * @return TRUE if the state can be used and FALSE if it's damaged or
+ *         belongs to another amount of bytes.
+ */
+extern
+BOOL
+uhashtools_product_builtin_hasher_is_state_valid
+(
+    const void* state,
+    unsigned __int64 hashed_size
+);
@@ -0,0 +1,116 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "product.h"
+
+#include "builtin_blake2sp.h"
+#include "product_ublake2sp.h"
+
+#include <Windows.h>
+
+const wchar_t MAINWIN_CLASSNAME[] = UHASHTOOLS_MAINWIN_CLASSNAME;
+const wchar_t MAINWIN_TITLE[] = UHASHTOOLS_MAINWIN_TITLE;
+const int MAINWIN_RECOMMENDED_WIDTH = UHASHTOOLS_MAINWIN_RECOMMENDED_WIDTH;
+
+const wchar_t*
+uhashtools_product_get_mainwin_classname
+(
+    void
+)
+{
+    return MAINWIN_CLASSNAME;
+}
+
+const wchar_t*
+uhashtools_product_get_mainwin_title
+(
+    void
+)
+{
+    return MAINWIN_TITLE;
+}
+
+int
+uhashtools_product_get_recommended_mainwin_width
+(
+    void
+)
+{
+    return MAINWIN_RECOMMENDED_WIDTH;
+}
+
+const wchar_t*
+uhashtools_product_get_bcrypt_algorithm_str
+(
+    void
+)
+{
+    /* BLAKE2sp isn't provided by the Windows CNG API, so the built-in hasher is always used. */
+    return NULL;
+}
+
+size_t
+uhashtools_product_get_builtin_hasher_state_size
+(
+    void
+)
+{
+    return sizeof(struct BuiltinBlake2spState);
+}
+
+size_t
+uhashtools_product_get_builtin_hasher_digest_size
+(
+    void
+)
+{
+    return BUILTIN_BLAKE2SP_DIGEST_SIZE;
+}
+
+void
+uhashtools_product_builtin_hasher_init
+(
+    void* state
+)
+{
+    uhashtools_builtin_blake2sp_init((struct BuiltinBlake2spState*) state);
+}
+
+void
+uhashtools_product_builtin_hasher_update
+(
+    void* state,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    uhashtools_builtin_blake2sp_update((struct BuiltinBlake2spState*) state, data, data_size);
+}
+
+void
+uhashtools_product_builtin_hasher_finish
+(
+    void* state,
+    unsigned char* digest
+)
+{
+    uhashtools_builtin_blake2sp_finish((struct BuiltinBlake2spState*) state, digest);
+}
+
+BOOL
+uhashtools_product_builtin_hasher_is_state_valid
+(
+    const void* state,
+    unsigned __int64 hashed_size
+)
+{
+    const struct BuiltinBlake2spState* blake2sp_state = (const struct BuiltinBlake2spState*) state;
+
+    return uhashtools_builtin_blake2sp_is_state_valid(blake2sp_state) &&
+           blake2sp_state->leaf_size * BUILTIN_BLAKE2SP_LEAVES + blake2sp_state->buffer_fill == hashed_size;
+}
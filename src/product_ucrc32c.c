@@ -0,0 +1,117 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "product.h"
+
+#include "builtin_crc32c.h"
+#include "product_ucrc32c.h"
+
+#include <Windows.h>
+
+const wchar_t MAINWIN_CLASSNAME[] = UHASHTOOLS_MAINWIN_CLASSNAME;
+const wchar_t MAINWIN_TITLE[] = UHASHTOOLS_MAINWIN_TITLE;
+const int MAINWIN_RECOMMENDED_WIDTH = UHASHTOOLS_MAINWIN_RECOMMENDED_WIDTH;
+
+const wchar_t*
+uhashtools_product_get_mainwin_classname
+(
+    void
+)
+{
+    return MAINWIN_CLASSNAME;
+}
+
+const wchar_t*
+uhashtools_product_get_mainwin_title
+(
+    void
+)
+{
+    return MAINWIN_TITLE;
+}
+
+int
+uhashtools_product_get_recommended_mainwin_width
+(
+    void
+)
+{
+    return MAINWIN_RECOMMENDED_WIDTH;
+}
+
+const wchar_t*
+uhashtools_product_get_bcrypt_algorithm_str
+(
+    void
+)
+{
+    /* CRC-32C isn't provided by the Windows CNG API, so the built-in hasher is always used. */
+    return NULL;
+}
+
+size_t
+uhashtools_product_get_builtin_hasher_state_size
+(
+    void
+)
+{
+    return sizeof(struct BuiltinCrc32cState);
+}
+
+size_t
+uhashtools_product_get_builtin_hasher_digest_size
+(
+    void
+)
+{
+    return BUILTIN_CRC32C_DIGEST_SIZE;
+}
+
+void
+uhashtools_product_builtin_hasher_init
+(
+    void* state
+)
+{
+    uhashtools_builtin_crc32c_init((struct BuiltinCrc32cState*) state);
+}
+
+void
+uhashtools_product_builtin_hasher_update
+(
+    void* state,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    uhashtools_builtin_crc32c_update((struct BuiltinCrc32cState*) state, data, data_size);
+}
+
+void
+uhashtools_product_builtin_hasher_finish
+(
+    void* state,
+    unsigned char* digest
+)
+{
+    uhashtools_builtin_crc32c_finish((struct BuiltinCrc32cState*) state, digest);
+}
+
+BOOL
+uhashtools_product_builtin_hasher_is_state_valid
+(
+    const void* state,
+    unsigned __int64 hashed_size
+)
+{
+    /* Every value is a valid checksum and the amount of hashed bytes isn't stored. */
+    (void) state;
+    (void) hashed_size;
+
+    return TRUE;
+}
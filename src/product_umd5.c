@@ -8,6 +8,7 @@
 
 #include "product.h"
 
+#include "builtin_md5.h"
 #include "product_umd5.h"
 
 #include <Windows.h>
@@ -52,3 +53,64 @@ uhashtools_product_get_bcrypt_algorithm_str
 {
     return BCRYPT_HASH_ALGORITHM_NAME;
 }
+
+size_t
+uhashtools_product_get_builtin_hasher_state_size
+(
+    void
+)
+{
+    return sizeof(struct BuiltinMd5State);
+}
+
+size_t
+uhashtools_product_get_builtin_hasher_digest_size
+(
+    void
+)
+{
+    return BUILTIN_MD5_DIGEST_SIZE;
+}
+
+void
+uhashtools_product_builtin_hasher_init
+(
+    void* state
+)
+{
+    uhashtools_builtin_md5_init((struct BuiltinMd5State*) state);
+}
+
+void
+uhashtools_product_builtin_hasher_update
+(
+    void* state,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    uhashtools_builtin_md5_update((struct BuiltinMd5State*) state, data, data_size);
+}
+
+void
+uhashtools_product_builtin_hasher_finish
+(
+    void* state,
+    unsigned char* digest
+)
+{
+    uhashtools_builtin_md5_finish((struct BuiltinMd5State*) state, digest);
+}
+
+BOOL
+uhashtools_product_builtin_hasher_is_state_valid
+(
+    const void* state,
+    unsigned __int64 hashed_size
+)
+{
+    const struct BuiltinMd5State* md5_state = (const struct BuiltinMd5State*) state;
+
+    return uhashtools_builtin_md5_is_state_valid(md5_state) &&
+           md5_state->total_size == hashed_size;
+}
@@ -8,6 +8,7 @@
 
 #include "product.h"
 
+#include "builtin_sha1.h"
 #include "product_usha1.h"
 
 #include <Windows.h>
@@ -52,3 +53,64 @@ uhashtools_product_get_bcrypt_algorithm_str
 {
     return BCRYPT_HASH_ALGORITHM_NAME;
 }
+
+size_t
+uhashtools_product_get_builtin_hasher_state_size
+(
+    void
+)
+{
+    return sizeof(struct BuiltinSha1State);
+}
+
+size_t
+uhashtools_product_get_builtin_hasher_digest_size
+(
+    void
+)
+{
+    return BUILTIN_SHA1_DIGEST_SIZE;
+}
+
+void
+uhashtools_product_builtin_hasher_init
+(
+    void* state
+)
+{
+    uhashtools_builtin_sha1_init((struct BuiltinSha1State*) state);
+}
+
+void
+uhashtools_product_builtin_hasher_update
+(
+    void* state,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    uhashtools_builtin_sha1_update((struct BuiltinSha1State*) state, data, data_size);
+}
+
+void
+uhashtools_product_builtin_hasher_finish
+(
+    void* state,
+    unsigned char* digest
+)
+{
+    uhashtools_builtin_sha1_finish((struct BuiltinSha1State*) state, digest);
+}
+
+BOOL
+uhashtools_product_builtin_hasher_is_state_valid
+(
+    const void* state,
+    unsigned __int64 hashed_size
+)
+{
+    const struct BuiltinSha1State* sha1_state = (const struct BuiltinSha1State*) state;
+
+    return uhashtools_builtin_sha1_is_state_valid(sha1_state) &&
+           sha1_state->total_size == hashed_size;
+}
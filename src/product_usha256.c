@@ -8,6 +8,7 @@
 
 #include "product.h"
 
+#include "builtin_sha256.h"
 #include "product_usha256.h"
 
 #include <Windows.h>
@@ -52,3 +53,64 @@ uhashtools_product_get_bcrypt_algorithm_str
 {
     return BCRYPT_HASH_ALGORITHM_NAME;
 }
+
+size_t
+uhashtools_product_get_builtin_hasher_state_size
+(
+    void
+)
+{
+    return sizeof(struct BuiltinSha256State);
+}
+
+size_t
+uhashtools_product_get_builtin_hasher_digest_size
+(
+    void
+)
+{
+    return BUILTIN_SHA256_DIGEST_SIZE;
+}
+
+void
+uhashtools_product_builtin_hasher_init
+(
+    void* state
+)
+{
+    uhashtools_builtin_sha256_init((struct BuiltinSha256State*) state);
+}
+
+void
+uhashtools_product_builtin_hasher_update
+(
+    void* state,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    uhashtools_builtin_sha256_update((struct BuiltinSha256State*) state, data, data_size);
+}
+
+void
+uhashtools_product_builtin_hasher_finish
+(
+    void* state,
+    unsigned char* digest
+)
+{
+    uhashtools_builtin_sha256_finish((struct BuiltinSha256State*) state, digest);
+}
+
+BOOL
+uhashtools_product_builtin_hasher_is_state_valid
+(
+    const void* state,
+    unsigned __int64 hashed_size
+)
+{
+    const struct BuiltinSha256State* sha256_state = (const struct BuiltinSha256State*) state;
+
+    return uhashtools_builtin_sha256_is_state_valid(sha256_state) &&
+           sha256_state->total_size == hashed_size;
+}
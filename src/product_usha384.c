@@ -0,0 +1,116 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "product.h"
+
+#include "builtin_sha512.h"
+#include "product_usha384.h"
+
+#include <Windows.h>
+
+const wchar_t MAINWIN_CLASSNAME[] = UHASHTOOLS_MAINWIN_CLASSNAME;
+const wchar_t MAINWIN_TITLE[] = UHASHTOOLS_MAINWIN_TITLE;
+const int MAINWIN_RECOMMENDED_WIDTH = UHASHTOOLS_MAINWIN_RECOMMENDED_WIDTH;
+const wchar_t BCRYPT_HASH_ALGORITHM_NAME[] = UHASHTOOLS_BCRYPT_HASH_ALGORITHM_NAME;
+
+const wchar_t*
+uhashtools_product_get_mainwin_classname
+(
+    void
+)
+{
+    return MAINWIN_CLASSNAME;
+}
+
+const wchar_t*
+uhashtools_product_get_mainwin_title
+(
+    void
+)
+{
+    return MAINWIN_TITLE;
+}
+
+int
+uhashtools_product_get_recommended_mainwin_width
+(
+    void
+)
+{
+    return MAINWIN_RECOMMENDED_WIDTH;
+}
+
+const wchar_t*
+uhashtools_product_get_bcrypt_algorithm_str
+(
+    void
+)
+{
+    return BCRYPT_HASH_ALGORITHM_NAME;
+}
+
+size_t
+uhashtools_product_get_builtin_hasher_state_size
+(
+    void
+)
+{
+    return sizeof(struct BuiltinSha512State);
+}
+
+size_t
+uhashtools_product_get_builtin_hasher_digest_size
+(
+    void
+)
+{
+    return BUILTIN_SHA384_DIGEST_SIZE;
+}
+
+void
+uhashtools_product_builtin_hasher_init
+(
+    void* state
+)
+{
+    uhashtools_builtin_sha384_init((struct BuiltinSha512State*) state);
+}
+
+void
+uhashtools_product_builtin_hasher_update
+(
+    void* state,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    uhashtools_builtin_sha512_update((struct BuiltinSha512State*) state, data, data_size);
+}
+
+void
+uhashtools_product_builtin_hasher_finish
+(
+    void* state,
+    unsigned char* digest
+)
+{
+    uhashtools_builtin_sha512_finish((struct BuiltinSha512State*) state, digest, BUILTIN_SHA384_DIGEST_SIZE);
+}
+
+BOOL
+uhashtools_product_builtin_hasher_is_state_valid
+(
+    const void* state,
+    unsigned __int64 hashed_size
+)
+{
+    const struct BuiltinSha512State* sha512_state = (const struct BuiltinSha512State*) state;
+
+    return uhashtools_builtin_sha512_is_state_valid(sha512_state) &&
+           sha512_state->total_size == hashed_size;
+}
@@ -0,0 +1,27 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/* Product specific resource compiler definitions */
+#define UHASHTOOLS_RC_INTERNALNAME_STR L"usha3_512\0"
+#define UHASHTOOLS_RC_ORIGINALFILENAME_STR L"usha3_512.exe\0"
+#define UHASHTOOLS_RC_FILEDESCRIPTION_STR L"\x00b5SHA3-512\0"
+#define UHASHTOOLS_RC_PRODUCTNAME_STR L"\x00b5SHA3-512\0"
+
+/* Product specific C code definitions */
+#define UHASHTOOLS_MAINWIN_CLASSNAME L"CLASS_USHA3_512_MAINWIN"
+#define UHASHTOOLS_MAINWIN_TITLE L"\x00b5SHA3-512"
+#define UHASHTOOLS_MAINWIN_RECOMMENDED_WIDTH 550
+/* Same as BCRYPT_SHA3_512_ALGORITHM, which isn't defined by older Windows SDKs. */
+#define UHASHTOOLS_BCRYPT_HASH_ALGORITHM_NAME L"SHA3-512"
+
+/*
+ * Because this file is included by a resource file, this file must
+ * always end with an empty line!
+ */
@@ -0,0 +1,25 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/* Product specific resource compiler definitions */
+#define UHASHTOOLS_RC_INTERNALNAME_STR L"usha512_256\0"
+#define UHASHTOOLS_RC_ORIGINALFILENAME_STR L"usha512_256.exe\0"
+#define UHASHTOOLS_RC_FILEDESCRIPTION_STR L"\x00b5SHA-512/256\0"
+#define UHASHTOOLS_RC_PRODUCTNAME_STR L"\x00b5SHA-512/256\0"
+
+/* Product specific C code definitions */
+#define UHASHTOOLS_MAINWIN_CLASSNAME L"CLASS_USHA512_256_MAINWIN"
+#define UHASHTOOLS_MAINWIN_TITLE L"\x00b5SHA-512/256"
+#define UHASHTOOLS_MAINWIN_RECOMMENDED_WIDTH 550
+
+/*
+ * Because this file is included by a resource file, this file must
+ * always end with an empty line!
+ */
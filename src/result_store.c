@@ -0,0 +1,1085 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "result_store.h"
+
+#include "buffer_sizes.h"
+#include "error_utilities.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <wctype.h>
+
+#define RESULT_STORE_MIN_CAPACITY 1024
+
+/* Runs of this length are sorted by insertion sort before they are merged. */
+#define RESULT_STORE_SORT_RUN_LENGTH 16
+
+struct ResultStoreRow
+{
+    unsigned __int64 file_size;
+    unsigned int directory_index;
+
+    /* Offset of the file name within the text buffer. */
+    unsigned int name_offset;
+
+    /* Index within the digests or offset of the error message within the text buffer if the row has failed. */
+    unsigned int detail;
+    BOOL is_failed;
+};
+
+struct ResultStore
+{
+    struct ResultStoreRow* rows;
+    size_t rows_count;
+    size_t rows_capacity;
+    size_t failed_rows_count;
+
+    /* The digests of all hashed rows, "digest_size" bytes each. */
+    unsigned char* digests;
+    size_t digests_count;
+    size_t digests_capacity;
+    unsigned int digest_size;
+
+    /* Zero terminated directories, file names and error messages. */
+    wchar_t* txt;
+    size_t txt_length;
+    size_t txt_capacity;
+
+    /* Offsets of the directories within the text buffer. */
+    unsigned int* directory_offsets;
+    size_t directories_count;
+    size_t directories_capacity;
+};
+
+struct ResultStoreSortCtx;
+
+/* Compares two items whose sort keys are equal. */
+typedef int ResultStoreCompareFunction(const struct ResultStoreSortCtx* sort_ctx,
+                                       unsigned int lhs,
+                                       unsigned int rhs);
+
+struct ResultStoreSortCtx
+{
+    const struct ResultStore* result_store;
+    enum ResultStoreColumn sort_column;
+    BOOL is_sort_descending;
+
+    /* NULL if the sort keys are containing the complete sorted values. */
+    ResultStoreCompareFunction* compare_function;
+
+    /* Position of every directory in the sorted directories, only set when sorting by filepath. */
+    unsigned int* directory_ranks;
+};
+
+/* Order preserving prefix of the sorted value of a row or a directory. */
+struct ResultStoreSortKey
+{
+    unsigned __int64 key;
+    unsigned int item_index;
+};
+
+#define RESULT_STORE_DIRECTORY_MATCH_UNKNOWN 0
+#define RESULT_STORE_DIRECTORY_MATCH_YES 1
+#define RESULT_STORE_DIRECTORY_MATCH_NO 2
+
+struct ResultStoreFilterCtx
+{
+    wchar_t lowered_filter_txt[RESULT_STORE_FILTER_TXT_TSIZE];
+    BOOL is_filter_txt_spanning_directories;
+    BOOL is_filter_txt_hex;
+
+    /* One of the RESULT_STORE_DIRECTORY_MATCH_* values for every directory. */
+    unsigned char* directory_matches;
+
+    /* Large enough for a filepath and a hex encoded digest. */
+    wchar_t* txt_buf;
+};
+
+static
+BOOL
+uhashtools_result_store_reserve
+(
+    void** items,
+    size_t* items_capacity,
+    size_t item_size,
+    size_t required_items_count
+)
+{
+    size_t new_capacity = *items_capacity > 0 ? *items_capacity : RESULT_STORE_MIN_CAPACITY;
+    void* new_items = NULL;
+
+    if (required_items_count <= *items_capacity)
+    {
+        return TRUE;
+    }
+
+    while (new_capacity < required_items_count)
+    {
+        new_capacity *= 2;
+    }
+
+    if (new_capacity > ((size_t) -1) / item_size)
+    {
+        return FALSE;
+    }
+
+    new_items = realloc(*items, new_capacity * item_size);
+
+    if (!new_items)
+    {
+        return FALSE;
+    }
+
+    *items = new_items;
+    *items_capacity = new_capacity;
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_result_store_append_txt
+(
+    struct ResultStore* result_store,
+    const wchar_t* txt,
+    size_t txt_length,
+    unsigned int* txt_offset
+)
+{
+    const size_t required_length = result_store->txt_length + txt_length + 1;
+
+    if (required_length > UINT_MAX ||
+        !uhashtools_result_store_reserve((void**) &result_store->txt, &result_store->txt_capacity, sizeof(wchar_t), required_length))
+    {
+        return FALSE;
+    }
+
+    (void) memcpy((void*) (result_store->txt + result_store->txt_length), (const void*) txt, txt_length * sizeof(wchar_t));
+    result_store->txt[result_store->txt_length + txt_length] = L'\0';
+
+    *txt_offset = (unsigned int) result_store->txt_length;
+    result_store->txt_length = required_length;
+
+    return TRUE;
+}
+
+static
+BOOL
+uhashtools_result_store_is_last_directory
+(
+    const struct ResultStore* result_store,
+    const wchar_t* directory,
+    size_t directory_length
+)
+{
+    const wchar_t* last_directory = NULL;
+
+    if (result_store->directories_count == 0)
+    {
+        return FALSE;
+    }
+
+    last_directory = result_store->txt + result_store->directory_offsets[result_store->directories_count - 1];
+
+    return wcsncmp(last_directory, directory, directory_length) == 0 && last_directory[directory_length] == L'\0';
+}
+
+/* Lowers a character for comparing texts ignoring the case, ASCII characters are lowered without the C runtime. */
+static
+wint_t
+uhashtools_result_store_lower_char
+(
+    wchar_t txt_char
+)
+{
+    if (txt_char < 0x80)
+    {
+        return (txt_char >= L'A' && txt_char <= L'Z') ? (wint_t) (txt_char - L'A' + L'a') : (wint_t) txt_char;
+    }
+
+    return towlower(txt_char);
+}
+
+static
+void
+uhashtools_result_store_copy_lowered
+(
+    wchar_t* dst_buf,
+    size_t dst_buf_tsize,
+    const wchar_t* src_txt
+)
+{
+    size_t char_index = 0;
+
+    for (char_index = 0; char_index + 1 < dst_buf_tsize && src_txt[char_index]; ++char_index)
+    {
+        dst_buf[char_index] = (wchar_t) uhashtools_result_store_lower_char(src_txt[char_index]);
+    }
+
+    dst_buf[char_index] = L'\0';
+}
+
+/* Compares two texts ignoring the case in the same way as "uhashtools_result_store_get_txt_key()". */
+static
+int
+uhashtools_result_store_compare_txt
+(
+    const wchar_t* lhs_txt,
+    const wchar_t* rhs_txt
+)
+{
+    for (;; ++lhs_txt, ++rhs_txt)
+    {
+        const wint_t lhs_char = uhashtools_result_store_lower_char(*lhs_txt);
+        const wint_t rhs_char = uhashtools_result_store_lower_char(*rhs_txt);
+
+        if (lhs_char != rhs_char)
+        {
+            return lhs_char < rhs_char ? -1 : 1;
+        }
+
+        if (lhs_char == 0)
+        {
+            return 0;
+        }
+    }
+}
+
+/*
+ * Packs the first "chars_count" lowered characters of a text into a
+ * key with the same order as "uhashtools_result_store_compare_txt()".
+ * A character which doesn't fit into 16 bits ends the key, so texts
+ * with the same key still have to be compared completely.
+ */
+static
+unsigned __int64
+uhashtools_result_store_get_txt_key
+(
+    const wchar_t* txt,
+    unsigned int chars_count
+)
+{
+    unsigned __int64 txt_key = 0;
+    unsigned int char_index = 0;
+    BOOL is_key_complete = FALSE;
+
+    for (char_index = 0; char_index < chars_count; ++char_index)
+    {
+        wint_t key_char = 0;
+
+        if (!is_key_complete && *txt)
+        {
+            key_char = uhashtools_result_store_lower_char(*txt);
+            ++txt;
+
+            if (key_char >= 0xFFFF)
+            {
+                key_char = 0xFFFF;
+                is_key_complete = TRUE;
+            }
+        }
+
+        txt_key = (txt_key << 16) | (unsigned __int64) key_char;
+    }
+
+    return txt_key;
+}
+
+static
+BOOL
+uhashtools_result_store_matches_filter
+(
+    const struct ResultStore* result_store,
+    size_t row_index,
+    const struct ResultStoreFilterCtx* filter_ctx
+)
+{
+    const struct ResultStoreRow* row = &result_store->rows[row_index];
+    unsigned char* directory_match = &filter_ctx->directory_matches[row->directory_index];
+    struct HashDigest digest;
+
+    if (filter_ctx->is_filter_txt_spanning_directories)
+    {
+        uhashtools_result_store_get_filepath(result_store, row_index, filter_ctx->txt_buf, FILEPATH_BUFFER_TSIZE);
+        uhashtools_result_store_copy_lowered(filter_ctx->txt_buf, FILEPATH_BUFFER_TSIZE, filter_ctx->txt_buf);
+
+        if (wcsstr(filter_ctx->txt_buf, filter_ctx->lowered_filter_txt))
+        {
+            return TRUE;
+        }
+    }
+    else
+    {
+        /* Without a path separator in the filter text the directory and the file name can be checked separately. */
+        if (*directory_match == RESULT_STORE_DIRECTORY_MATCH_UNKNOWN)
+        {
+            uhashtools_result_store_copy_lowered(filter_ctx->txt_buf,
+                                                 FILEPATH_BUFFER_TSIZE,
+                                                 result_store->txt + result_store->directory_offsets[row->directory_index]);
+
+            *directory_match = wcsstr(filter_ctx->txt_buf, filter_ctx->lowered_filter_txt) ? RESULT_STORE_DIRECTORY_MATCH_YES
+                                                                                           : RESULT_STORE_DIRECTORY_MATCH_NO;
+        }
+
+        if (*directory_match == RESULT_STORE_DIRECTORY_MATCH_YES)
+        {
+            return TRUE;
+        }
+
+        uhashtools_result_store_copy_lowered(filter_ctx->txt_buf, FILEPATH_BUFFER_TSIZE, result_store->txt + row->name_offset);
+
+        if (wcsstr(filter_ctx->txt_buf, filter_ctx->lowered_filter_txt))
+        {
+            return TRUE;
+        }
+    }
+
+    if (!filter_ctx->is_filter_txt_hex || !uhashtools_result_store_get_digest(result_store, row_index, &digest))
+    {
+        return FALSE;
+    }
+
+    (void) uhashtools_hash_calculator_impl_digest_to_hex(&digest, filter_ctx->txt_buf, FILEPATH_BUFFER_TSIZE);
+
+    return wcsstr(filter_ctx->txt_buf, filter_ctx->lowered_filter_txt) != NULL;
+}
+
+static
+int
+uhashtools_result_store_compare_sort_keys
+(
+    const struct ResultStoreSortCtx* sort_ctx,
+    const struct ResultStoreSortKey* lhs,
+    const struct ResultStoreSortKey* rhs
+)
+{
+    int ret = 0;
+
+    if (lhs->key != rhs->key)
+    {
+        ret = lhs->key < rhs->key ? -1 : 1;
+    }
+    else if (sort_ctx->compare_function)
+    {
+        ret = sort_ctx->compare_function(sort_ctx, lhs->item_index, rhs->item_index);
+    }
+
+    return sort_ctx->is_sort_descending ? -ret : ret;
+}
+
+/*
+ * Stable bottom-up merge sort, since the C runtime has no stable sort with
+ * a context parameter. The keys are sorted instead of the rows, so most
+ * comparisons don't have to look into the store.
+ */
+static
+BOOL
+uhashtools_result_store_sort
+(
+    struct ResultStoreSortKey* sort_keys,
+    size_t sort_keys_count,
+    const struct ResultStoreSortCtx* sort_ctx
+)
+{
+    struct ResultStoreSortKey* tmp_sort_keys = NULL;
+    struct ResultStoreSortKey* src_sort_keys = sort_keys;
+    struct ResultStoreSortKey* dst_sort_keys = NULL;
+    size_t run_begin = 0;
+    size_t run_width = 0;
+
+    if (sort_keys_count < 2)
+    {
+        return TRUE;
+    }
+
+    tmp_sort_keys = (struct ResultStoreSortKey*) malloc(sort_keys_count * sizeof *tmp_sort_keys);
+
+    if (!tmp_sort_keys)
+    {
+        return FALSE;
+    }
+
+    dst_sort_keys = tmp_sort_keys;
+
+    for (run_begin = 0; run_begin < sort_keys_count; run_begin += RESULT_STORE_SORT_RUN_LENGTH)
+    {
+        const size_t run_end = sort_keys_count - run_begin > RESULT_STORE_SORT_RUN_LENGTH ? run_begin + RESULT_STORE_SORT_RUN_LENGTH
+                                                                                           : sort_keys_count;
+        size_t insert_pos = 0;
+
+        for (insert_pos = run_begin + 1; insert_pos < run_end; ++insert_pos)
+        {
+            const struct ResultStoreSortKey inserted_sort_key = sort_keys[insert_pos];
+            size_t pos = insert_pos;
+
+            while (pos > run_begin && uhashtools_result_store_compare_sort_keys(sort_ctx, &sort_keys[pos - 1], &inserted_sort_key) > 0)
+            {
+                sort_keys[pos] = sort_keys[pos - 1];
+                --pos;
+            }
+
+            sort_keys[pos] = inserted_sort_key;
+        }
+    }
+
+    for (run_width = RESULT_STORE_SORT_RUN_LENGTH; run_width < sort_keys_count; run_width *= 2)
+    {
+        struct ResultStoreSortKey* swapped_sort_keys = NULL;
+
+        for (run_begin = 0; run_begin < sort_keys_count; run_begin += run_width * 2)
+        {
+            const size_t left_end = sort_keys_count - run_begin > run_width ? run_begin + run_width : sort_keys_count;
+            const size_t right_end = sort_keys_count - left_end > run_width ? left_end + run_width : sort_keys_count;
+            size_t left_pos = run_begin;
+            size_t right_pos = left_end;
+            size_t dst_pos = run_begin;
+
+            /* Taking from the right run only if it is smaller keeps the sort stable. */
+            while (left_pos < left_end && right_pos < right_end)
+            {
+                if (uhashtools_result_store_compare_sort_keys(sort_ctx, &src_sort_keys[right_pos], &src_sort_keys[left_pos]) < 0)
+                {
+                    dst_sort_keys[dst_pos++] = src_sort_keys[right_pos++];
+                }
+                else
+                {
+                    dst_sort_keys[dst_pos++] = src_sort_keys[left_pos++];
+                }
+            }
+
+            while (left_pos < left_end)
+            {
+                dst_sort_keys[dst_pos++] = src_sort_keys[left_pos++];
+            }
+
+            while (right_pos < right_end)
+            {
+                dst_sort_keys[dst_pos++] = src_sort_keys[right_pos++];
+            }
+        }
+
+        swapped_sort_keys = src_sort_keys;
+        src_sort_keys = dst_sort_keys;
+        dst_sort_keys = swapped_sort_keys;
+    }
+
+    if (src_sort_keys != sort_keys)
+    {
+        (void) memcpy((void*) sort_keys, (const void*) src_sort_keys, sort_keys_count * sizeof *sort_keys);
+    }
+
+    free((void*) tmp_sort_keys);
+
+    return TRUE;
+}
+
+static
+int
+uhashtools_result_store_compare_directories
+(
+    const struct ResultStoreSortCtx* sort_ctx,
+    unsigned int lhs,
+    unsigned int rhs
+)
+{
+    const struct ResultStore* result_store = sort_ctx->result_store;
+
+    return uhashtools_result_store_compare_txt(result_store->txt + result_store->directory_offsets[lhs],
+                                               result_store->txt + result_store->directory_offsets[rhs]);
+}
+
+/*
+ * Sorts the directories once, so sorting the rows by filepath only has
+ * to compare the ranks of their directories and their file names.
+ */
+static
+unsigned int*
+uhashtools_result_store_rank_directories
+(
+    const struct ResultStore* result_store,
+    size_t directories_count
+)
+{
+    struct ResultStoreSortCtx sort_ctx;
+    struct ResultStoreSortKey* sort_keys = NULL;
+    unsigned int* directory_ranks = NULL;
+    size_t directory_index = 0;
+
+    (void) memset((void*) &sort_ctx, 0, sizeof sort_ctx);
+    sort_ctx.result_store = result_store;
+    sort_ctx.compare_function = &uhashtools_result_store_compare_directories;
+
+    sort_keys = (struct ResultStoreSortKey*) malloc(directories_count * sizeof *sort_keys);
+    directory_ranks = (unsigned int*) malloc(directories_count * sizeof *directory_ranks);
+
+    if (!sort_keys || !directory_ranks)
+    {
+        goto error_out;
+    }
+
+    for (directory_index = 0; directory_index < directories_count; ++directory_index)
+    {
+        sort_keys[directory_index].key = uhashtools_result_store_get_txt_key(result_store->txt + result_store->directory_offsets[directory_index], 4);
+        sort_keys[directory_index].item_index = (unsigned int) directory_index;
+    }
+
+    if (!uhashtools_result_store_sort(sort_keys, directories_count, &sort_ctx))
+    {
+        goto error_out;
+    }
+
+    /* The same directory can be stored more than once, those entries are getting the same rank. */
+    directory_ranks[sort_keys[0].item_index] = 0;
+
+    for (directory_index = 1; directory_index < directories_count; ++directory_index)
+    {
+        const unsigned int previous_directory = sort_keys[directory_index - 1].item_index;
+        const unsigned int current_directory = sort_keys[directory_index].item_index;
+
+        if (uhashtools_result_store_compare_directories(&sort_ctx, previous_directory, current_directory) == 0)
+        {
+            directory_ranks[current_directory] = directory_ranks[previous_directory];
+        }
+        else
+        {
+            directory_ranks[current_directory] = (unsigned int) directory_index;
+        }
+    }
+
+    free((void*) sort_keys);
+
+    return directory_ranks;
+
+error_out:
+    free((void*) sort_keys);
+    free((void*) directory_ranks);
+
+    return NULL;
+}
+
+static
+int
+uhashtools_result_store_compare_names
+(
+    const struct ResultStoreSortCtx* sort_ctx,
+    unsigned int lhs,
+    unsigned int rhs
+)
+{
+    const struct ResultStore* result_store = sort_ctx->result_store;
+
+    return uhashtools_result_store_compare_txt(result_store->txt + result_store->rows[lhs].name_offset,
+                                               result_store->txt + result_store->rows[rhs].name_offset);
+}
+
+static
+int
+uhashtools_result_store_compare_digests
+(
+    const struct ResultStoreSortCtx* sort_ctx,
+    unsigned int lhs,
+    unsigned int rhs
+)
+{
+    const struct ResultStore* result_store = sort_ctx->result_store;
+    const struct ResultStoreRow* lhs_row = &result_store->rows[lhs];
+    const struct ResultStoreRow* rhs_row = &result_store->rows[rhs];
+
+    if (lhs_row->is_failed || rhs_row->is_failed)
+    {
+        return (int) lhs_row->is_failed - (int) rhs_row->is_failed;
+    }
+
+    return memcmp((const void*) (result_store->digests + (size_t) lhs_row->detail * result_store->digest_size),
+                  (const void*) (result_store->digests + (size_t) rhs_row->detail * result_store->digest_size),
+                  result_store->digest_size);
+}
+
+static
+unsigned __int64
+uhashtools_result_store_get_row_key
+(
+    const struct ResultStoreSortCtx* sort_ctx,
+    unsigned int row_index
+)
+{
+    const struct ResultStore* result_store = sort_ctx->result_store;
+    const struct ResultStoreRow* row = &result_store->rows[row_index];
+    unsigned __int64 row_key = 0;
+    unsigned int byte_index = 0;
+
+    switch (sort_ctx->sort_column)
+    {
+        case RESULT_STORE_COLUMN_FILEPATH:
+        {
+            row_key = ((unsigned __int64) sort_ctx->directory_ranks[row->directory_index] << 32) |
+                      uhashtools_result_store_get_txt_key(result_store->txt + row->name_offset, 2);
+        } break;
+        case RESULT_STORE_COLUMN_FILE_SIZE:
+        {
+            row_key = row->file_size;
+        } break;
+        case RESULT_STORE_COLUMN_DIGEST:
+        {
+            if (row->is_failed)
+            {
+                row_key = _UI64_MAX;
+                break;
+            }
+
+            /* The leading bytes of the digest as big endian number. */
+            for (byte_index = 0; byte_index < 8; ++byte_index)
+            {
+                row_key <<= 8;
+
+                if (byte_index < result_store->digest_size)
+                {
+                    row_key |= result_store->digests[(size_t) row->detail * result_store->digest_size + byte_index];
+                }
+            }
+        } break;
+        default:
+        {
+            UHASHTOOLS_FATAL_ERROR(L"Internal error: sort_column has an unexpected value!");
+        }
+    }
+
+    return row_key;
+}
+
+struct ResultStore*
+uhashtools_result_store_create
+(
+    void
+)
+{
+    return (struct ResultStore*) calloc(1, sizeof(struct ResultStore));
+}
+
+BOOL
+uhashtools_result_store_append
+(
+    struct ResultStore* result_store,
+    const wchar_t* filepath,
+    unsigned __int64 file_size,
+    const struct HashDigest* digest,
+    const wchar_t* error_message
+)
+{
+    const wchar_t* name = NULL;
+    size_t directory_length = 0;
+    struct ResultStoreRow row;
+
+    UHASHTOOLS_ASSERT(result_store, L"Internal error: Entered with result_store == NULL!");
+    UHASHTOOLS_ASSERT(filepath, L"Internal error: Entered with filepath == NULL!");
+
+    /* The rows are referenced by unsigned int indexes within the views. */
+    if (result_store->rows_count >= UINT_MAX)
+    {
+        return FALSE;
+    }
+
+    (void) memset((void*) &row, 0, sizeof row);
+    row.file_size = file_size;
+
+    name = wcsrchr(filepath, L'\\');
+
+    if (name)
+    {
+        directory_length = (size_t) (name - filepath);
+        ++name;
+    }
+    else
+    {
+        name = filepath;
+    }
+
+    /* The files of a batch are mostly coming directory by directory. */
+    if (!uhashtools_result_store_is_last_directory(result_store, filepath, directory_length))
+    {
+        unsigned int directory_offset = 0;
+
+        if (!uhashtools_result_store_reserve((void**) &result_store->directory_offsets,
+                                             &result_store->directories_capacity,
+                                             sizeof *result_store->directory_offsets,
+                                             result_store->directories_count + 1) ||
+            !uhashtools_result_store_append_txt(result_store, filepath, directory_length, &directory_offset))
+        {
+            return FALSE;
+        }
+
+        result_store->directory_offsets[result_store->directories_count++] = directory_offset;
+    }
+
+    row.directory_index = (unsigned int) (result_store->directories_count - 1);
+
+    if (!uhashtools_result_store_append_txt(result_store, name, wcslen(name), &row.name_offset))
+    {
+        return FALSE;
+    }
+
+    if (digest)
+    {
+        if (result_store->digests_count == 0)
+        {
+            result_store->digest_size = digest->size;
+        }
+
+        UHASHTOOLS_ASSERT(digest->size == result_store->digest_size,
+                          L"Internal error: All digests of a result store must have the same size!");
+
+        if (!uhashtools_result_store_reserve((void**) &result_store->digests,
+                                             &result_store->digests_capacity,
+                                             1,
+                                             (result_store->digests_count + 1) * result_store->digest_size))
+        {
+            return FALSE;
+        }
+
+        (void) memcpy((void*) (result_store->digests + result_store->digests_count * result_store->digest_size),
+                      (const void*) digest->bytes,
+                      result_store->digest_size);
+
+        row.detail = (unsigned int) result_store->digests_count;
+    }
+    else
+    {
+        const wchar_t* stored_error_message = error_message ? error_message : L"";
+
+        if (!uhashtools_result_store_append_txt(result_store, stored_error_message, wcslen(stored_error_message), &row.detail))
+        {
+            return FALSE;
+        }
+
+        row.is_failed = TRUE;
+    }
+
+    if (!uhashtools_result_store_reserve((void**) &result_store->rows,
+                                         &result_store->rows_capacity,
+                                         sizeof *result_store->rows,
+                                         result_store->rows_count + 1))
+    {
+        return FALSE;
+    }
+
+    result_store->rows[result_store->rows_count++] = row;
+
+    if (row.is_failed)
+    {
+        ++result_store->failed_rows_count;
+    }
+    else
+    {
+        ++result_store->digests_count;
+    }
+
+    return TRUE;
+}
+
+size_t
+uhashtools_result_store_get_rows_count
+(
+    const struct ResultStore* result_store
+)
+{
+    UHASHTOOLS_ASSERT(result_store, L"Internal error: Entered with result_store == NULL!");
+
+    return result_store->rows_count;
+}
+
+size_t
+uhashtools_result_store_get_failed_rows_count
+(
+    const struct ResultStore* result_store
+)
+{
+    UHASHTOOLS_ASSERT(result_store, L"Internal error: Entered with result_store == NULL!");
+
+    return result_store->failed_rows_count;
+}
+
+void
+uhashtools_result_store_get_filepath
+(
+    const struct ResultStore* result_store,
+    size_t row_index,
+    wchar_t* filepath_buf,
+    size_t filepath_buf_tsize
+)
+{
+    const struct ResultStoreRow* row = NULL;
+    const wchar_t* directory = NULL;
+
+    UHASHTOOLS_ASSERT(result_store, L"Internal error: Entered with result_store == NULL!");
+    UHASHTOOLS_ASSERT(row_index < result_store->rows_count, L"Internal error: row_index is out of range!");
+    UHASHTOOLS_ASSERT(filepath_buf && filepath_buf_tsize > 0, L"Internal error: Entered without filepath_buf!");
+
+    row = &result_store->rows[row_index];
+    directory = result_store->txt + result_store->directory_offsets[row->directory_index];
+
+    (void) _snwprintf_s(filepath_buf,
+                        filepath_buf_tsize,
+                        _TRUNCATE,
+                        directory[0] ? L"%s\\%s" : L"%s%s",
+                        directory,
+                        result_store->txt + row->name_offset);
+}
+
+unsigned __int64
+uhashtools_result_store_get_file_size
+(
+    const struct ResultStore* result_store,
+    size_t row_index
+)
+{
+    UHASHTOOLS_ASSERT(result_store, L"Internal error: Entered with result_store == NULL!");
+    UHASHTOOLS_ASSERT(row_index < result_store->rows_count, L"Internal error: row_index is out of range!");
+
+    return result_store->rows[row_index].file_size;
+}
+
+BOOL
+uhashtools_result_store_get_digest
+(
+    const struct ResultStore* result_store,
+    size_t row_index,
+    struct HashDigest* digest
+)
+{
+    const struct ResultStoreRow* row = NULL;
+
+    UHASHTOOLS_ASSERT(result_store, L"Internal error: Entered with result_store == NULL!");
+    UHASHTOOLS_ASSERT(row_index < result_store->rows_count, L"Internal error: row_index is out of range!");
+    UHASHTOOLS_ASSERT(digest, L"Internal error: Entered with digest == NULL!");
+
+    row = &result_store->rows[row_index];
+
+    if (row->is_failed)
+    {
+        return FALSE;
+    }
+
+    digest->size = result_store->digest_size;
+    (void) memcpy((void*) digest->bytes,
+                  (const void*) (result_store->digests + (size_t) row->detail * result_store->digest_size),
+                  result_store->digest_size);
+
+    return TRUE;
+}
+
+const wchar_t*
+uhashtools_result_store_get_error_message
+(
+    const struct ResultStore* result_store,
+    size_t row_index
+)
+{
+    const struct ResultStoreRow* row = NULL;
+
+    UHASHTOOLS_ASSERT(result_store, L"Internal error: Entered with result_store == NULL!");
+    UHASHTOOLS_ASSERT(row_index < result_store->rows_count, L"Internal error: row_index is out of range!");
+
+    row = &result_store->rows[row_index];
+
+    return row->is_failed ? result_store->txt + row->detail : NULL;
+}
+
+BOOL
+uhashtools_result_store_build_view
+(
+    const struct ResultStore* result_store,
+    size_t rows_count,
+    const struct ResultStoreViewSpec* view_spec,
+    struct ResultStoreView* view
+)
+{
+    BOOL ret = FALSE;
+    struct ResultStoreFilterCtx filter_ctx;
+    struct ResultStoreSortCtx sort_ctx;
+    struct ResultStoreSortKey* sort_keys = NULL;
+    wchar_t txt_buf[FILEPATH_BUFFER_TSIZE];
+    size_t directories_count = 0;
+    size_t row_index = 0;
+
+    UHASHTOOLS_ASSERT(result_store, L"Internal error: Entered with result_store == NULL!");
+    UHASHTOOLS_ASSERT(rows_count <= result_store->rows_count, L"Internal error: rows_count is out of range!");
+    UHASHTOOLS_ASSERT(view_spec, L"Internal error: Entered with view_spec == NULL!");
+    UHASHTOOLS_ASSERT(view, L"Internal error: Entered with view == NULL!");
+
+    (void) memset((void*) view, 0, sizeof *view);
+    (void) memset((void*) &filter_ctx, 0, sizeof filter_ctx);
+    (void) memset((void*) &sort_ctx, 0, sizeof sort_ctx);
+
+    view->store_rows_count = rows_count;
+
+    if (rows_count == 0)
+    {
+        return TRUE;
+    }
+
+    /* The directories are appended in the order of the rows, so only the directories up to the last row are used. */
+    directories_count = (size_t) result_store->rows[rows_count - 1].directory_index + 1;
+
+    view->row_indexes = (unsigned int*) malloc(rows_count * sizeof *view->row_indexes);
+
+    if (!view->row_indexes)
+    {
+        goto cleanup_and_out;
+    }
+
+    uhashtools_result_store_copy_lowered(filter_ctx.lowered_filter_txt, RESULT_STORE_FILTER_TXT_TSIZE, view_spec->filter_txt);
+
+    if (filter_ctx.lowered_filter_txt[0] == L'\0')
+    {
+        for (row_index = 0; row_index < rows_count; ++row_index)
+        {
+            view->row_indexes[row_index] = (unsigned int) row_index;
+        }
+
+        view->rows_count = rows_count;
+    }
+    else
+    {
+        filter_ctx.is_filter_txt_spanning_directories = wcschr(filter_ctx.lowered_filter_txt, L'\\') != NULL;
+        filter_ctx.is_filter_txt_hex = wcsspn(filter_ctx.lowered_filter_txt, L"0123456789abcdef") == wcslen(filter_ctx.lowered_filter_txt);
+        filter_ctx.directory_matches = (unsigned char*) calloc(directories_count, sizeof *filter_ctx.directory_matches);
+        filter_ctx.txt_buf = txt_buf;
+
+        if (!filter_ctx.directory_matches)
+        {
+            goto cleanup_and_out;
+        }
+
+        for (row_index = 0; row_index < rows_count; ++row_index)
+        {
+            if (uhashtools_result_store_matches_filter(result_store, row_index, &filter_ctx))
+            {
+                view->row_indexes[view->rows_count++] = (unsigned int) row_index;
+            }
+        }
+    }
+
+    if (view->rows_count < 2)
+    {
+        ret = TRUE;
+        goto cleanup_and_out;
+    }
+
+    if (view_spec->sort_column == RESULT_STORE_COLUMN_NONE)
+    {
+        if (view_spec->is_sort_descending)
+        {
+            size_t front_pos = 0;
+            size_t back_pos = view->rows_count - 1;
+
+            for (; front_pos < back_pos; ++front_pos, --back_pos)
+            {
+                const unsigned int swapped_index = view->row_indexes[front_pos];
+
+                view->row_indexes[front_pos] = view->row_indexes[back_pos];
+                view->row_indexes[back_pos] = swapped_index;
+            }
+        }
+
+        ret = TRUE;
+        goto cleanup_and_out;
+    }
+
+    sort_ctx.result_store = result_store;
+    sort_ctx.sort_column = view_spec->sort_column;
+    sort_ctx.is_sort_descending = view_spec->is_sort_descending;
+
+    if (view_spec->sort_column == RESULT_STORE_COLUMN_FILEPATH)
+    {
+        sort_ctx.compare_function = &uhashtools_result_store_compare_names;
+        sort_ctx.directory_ranks = uhashtools_result_store_rank_directories(result_store, directories_count);
+
+        if (!sort_ctx.directory_ranks)
+        {
+            goto cleanup_and_out;
+        }
+    }
+    else if (view_spec->sort_column == RESULT_STORE_COLUMN_DIGEST)
+    {
+        sort_ctx.compare_function = &uhashtools_result_store_compare_digests;
+    }
+
+    sort_keys = (struct ResultStoreSortKey*) malloc(view->rows_count * sizeof *sort_keys);
+
+    if (!sort_keys)
+    {
+        goto cleanup_and_out;
+    }
+
+    for (row_index = 0; row_index < view->rows_count; ++row_index)
+    {
+        sort_keys[row_index].key = uhashtools_result_store_get_row_key(&sort_ctx, view->row_indexes[row_index]);
+        sort_keys[row_index].item_index = view->row_indexes[row_index];
+    }
+
+    if (!uhashtools_result_store_sort(sort_keys, view->rows_count, &sort_ctx))
+    {
+        goto cleanup_and_out;
+    }
+
+    for (row_index = 0; row_index < view->rows_count; ++row_index)
+    {
+        view->row_indexes[row_index] = sort_keys[row_index].item_index;
+    }
+
+    ret = TRUE;
+
+cleanup_and_out:
+    free((void*) sort_keys);
+    free((void*) sort_ctx.directory_ranks);
+    free((void*) filter_ctx.directory_matches);
+
+    if (!ret)
+    {
+        uhashtools_result_store_view_free(view);
+    }
+
+    return ret;
+}
+
+void
+uhashtools_result_store_view_free
+(
+    struct ResultStoreView* view
+)
+{
+    if (!view)
+    {
+        return;
+    }
+
+    free((void*) view->row_indexes);
+    (void) memset((void*) view, 0, sizeof *view);
+}
+
+void
+uhashtools_result_store_destroy
+(
+    struct ResultStore* result_store
+)
+{
+    if (!result_store)
+    {
+        return;
+    }
+
+    free((void*) result_store->rows);
+    free((void*) result_store->digests);
+    free((void*) result_store->txt);
+    free((void*) result_store->directory_offsets);
+    free((void*) result_store);
+}
@@ -0,0 +1,213 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "hash_calculation_impl.h"
+
+#include <Windows.h>
+
+/*
+ * Compact store for the results of a batch of hashed files. A batch can
+ * consist of hundreds of thousands of files, so the results aren't kept
+ * as display strings:
+ * 
+ * - The directory of a filepath is only stored once for consecutive
+ *   files of the same directory, every row only stores the file name.
+ * - The digests are stored as raw bytes in one array. They are only
+ *   encoded to hex for the rows which are displayed.
+ * - A row itself only consists of the file size and a few offsets.
+ * 
+ * The order in which the rows are displayed is described by a view,
+ * which is built for a sort order and a filter text. Building a view
+ * only reads from the store, so it can be done by another thread as
+ * long as no rows are appended in the meantime. Apart from that the
+ * store isn't synchronized. This unit only uses the C runtime.
+ */
+
+#define RESULT_STORE_FILTER_TXT_TSIZE 128
+
+enum ResultStoreColumn
+{
+    /* Order in which the rows have been appended. */
+    RESULT_STORE_COLUMN_NONE,
+    RESULT_STORE_COLUMN_FILEPATH,
+    RESULT_STORE_COLUMN_FILE_SIZE,
+    /* In ascending order the failed rows are placed behind the hashed ones. */
+    RESULT_STORE_COLUMN_DIGEST
+};
+
+struct ResultStoreViewSpec
+{
+    enum ResultStoreColumn sort_column;
+    BOOL is_sort_descending;
+
+    /*
+     * Only rows whose filepath or hex encoded digest contains this text
+     * (ignoring the case) are part of the view. An empty text matches
+     * all rows.
+     */
+    wchar_t filter_txt[RESULT_STORE_FILTER_TXT_TSIZE];
+};
+
+struct ResultStoreView
+{
+    /* Amount of the rows which have existed when the view has been built. */
+    size_t store_rows_count;
+
+    /* Indexes of the matching rows in display order. */
+    unsigned int* row_indexes;
+    size_t rows_count;
+};
+
+struct ResultStore;
+
+/**
+ * Creates an empty store.
+ * 
+ * @return Created store or NULL if the memory allocation failed.
+ */
+extern
+struct ResultStore*
+uhashtools_result_store_create
+(
+    void
+);
+
+/**
+ * Appends the result of a file. All digests of a store must have the
+ * same size.
+ * 
+ * @param result_store Created store.
+ * @param filepath Path of the file.
+ * @param file_size Size of the file in bytes.
+ * @param digest Digest of the file or NULL if the file couldn't be hashed.
+ * @param error_message User error message if "digest" is NULL else ignored.
+ * 
+ * @return TRUE on success and FALSE if the memory allocation failed or
+ *         the store is full.
+ */
+extern
+BOOL
+uhashtools_result_store_append
+(
+    struct ResultStore* result_store,
+    const wchar_t* filepath,
+    unsigned __int64 file_size,
+    const struct HashDigest* digest,
+    const wchar_t* error_message
+);
+
+extern
+size_t
+uhashtools_result_store_get_rows_count
+(
+    const struct ResultStore* result_store
+);
+
+extern
+size_t
+uhashtools_result_store_get_failed_rows_count
+(
+    const struct ResultStore* result_store
+);
+
+/**
+ * Writes the filepath of a row into "filepath_buf". Too long paths are
+ * truncated.
+ */
+extern
+void
+uhashtools_result_store_get_filepath
+(
+    const struct ResultStore* result_store,
+    size_t row_index,
+    wchar_t* filepath_buf,
+    size_t filepath_buf_tsize
+);
+
+extern
+unsigned __int64
+uhashtools_result_store_get_file_size
+(
+    const struct ResultStore* result_store,
+    size_t row_index
+);
+
+/**
+ * Gets the digest of a row.
+ * 
+ * @return TRUE if the file has been hashed and FALSE if the hashing has
+ *         failed, in which case "digest" stays unchanged.
+ */
+extern
+BOOL
+uhashtools_result_store_get_digest
+(
+    const struct ResultStore* result_store,
+    size_t row_index,
+    struct HashDigest* digest
+);
+
+/**
+ * Gets the user error message of a row.
+ * 
+ * @return Error message or NULL if the file has been hashed. The message
+ *         is valid until the store is destroyed.
+ */
+extern
+const wchar_t*
+uhashtools_result_store_get_error_message
+(
+    const struct ResultStore* result_store,
+    size_t row_index
+);
+
+/**
+ * Builds a view over the first "rows_count" rows of the store. Sorting
+ * is stable, so rows which are equal in the sort column keep the order
+ * in which they have been appended.
+ * 
+ * @param result_store Created store.
+ * @param rows_count Amount of rows to include, at most the amount of rows
+ *                   in the store.
+ * @param view_spec Sort order and filter text of the view.
+ * @param view Receives the built view, which must be freed with
+ *             "uhashtools_result_store_view_free()".
+ * 
+ * @return TRUE on success and FALSE if the memory allocation failed.
+ */
+extern
+BOOL
+uhashtools_result_store_build_view
+(
+    const struct ResultStore* result_store,
+    size_t rows_count,
+    const struct ResultStoreViewSpec* view_spec,
+    struct ResultStoreView* view
+);
+
+/**
+ * Frees the memory of a built view and resets it to an empty view.
+ */
+extern
+void
+uhashtools_result_store_view_free
+(
+    struct ResultStoreView* view
+);
+
+/**
+ * Destroys the store. Passing NULL is allowed.
+ */
+extern
+void
+uhashtools_result_store_destroy
+(
+    struct ResultStore* result_store
+);
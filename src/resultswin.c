@@ -0,0 +1,895 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "resultswin.h"
+
+#include "batch_worker.h"
+#include "buffer_sizes.h"
+#include "error_utilities.h"
+#include "gui_common.h"
+#include "gui_eb_common.h"
+#include "gui_lbl_common.h"
+#include "gui_lv_common.h"
+#include "hash_calculation_impl.h"
+#include "print_utilities.h"
+#include "product.h"
+#include "result_store.h"
+
+#include <CommCtrl.h>
+#include <process.h>
+#include <Windows.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Graphical element values */
+
+#define RESULTSWIN_CLASSNAME L"uhashtools_resultswin"
+
+const DWORD RESULTSWIN_STYLE = WS_OVERLAPPEDWINDOW;
+const DWORD RESULTSWIN_STYLE_EX = WS_EX_OVERLAPPEDWINDOW;
+const int RESULTSWIN_WIDTH = 800;
+const int RESULTSWIN_HIGHT = 500;
+const int RESULTSWIN_WIDTH_MIN = 400;
+const int RESULTSWIN_HIGHT_MIN = 250;
+
+const DWORD RW_LBL_STYLE = WS_CHILD | WS_VISIBLE | SS_SIMPLE;
+const DWORD RW_EB_FILTER_STYLE = WS_CHILD | WS_VISIBLE | WS_TABSTOP | ES_LEFT | ES_AUTOHSCROLL;
+const DWORD RW_EB_FILTER_STYLE_EX = WS_EX_CLIENTEDGE;
+const int RW_EB_FILTER_HIGHT = LBL_DEFAULT_HIGHT + 4;
+const DWORD RW_LV_RESULTS_STYLE = WS_CHILD | WS_VISIBLE | WS_TABSTOP | LVS_REPORT | LVS_OWNERDATA | LVS_SHOWSELALWAYS;
+const DWORD RW_LV_RESULTS_STYLE_EX = WS_EX_CLIENTEDGE;
+
+#define RW_LV_COLUMNS_COUNT 3
+
+static const wchar_t* const RW_LV_COLUMN_TITLES[RW_LV_COLUMNS_COUNT] = { L"Filepath", L"Size", L"Hash" };
+static const int RW_LV_COLUMN_WIDTHS[RW_LV_COLUMNS_COUNT] = { 400, 100, 260 };
+static const int RW_LV_COLUMN_FORMATS[RW_LV_COLUMNS_COUNT] = { LVCFMT_LEFT, LVCFMT_RIGHT, LVCFMT_LEFT };
+static const enum ResultStoreColumn RW_LV_COLUMN_STORE_COLUMNS[RW_LV_COLUMNS_COUNT] = { RESULT_STORE_COLUMN_FILEPATH,
+                                                                                        RESULT_STORE_COLUMN_FILE_SIZE,
+                                                                                        RESULT_STORE_COLUMN_DIGEST };
+
+/* Timer and messages */
+
+#define RESULTSWIN_TAKE_RESULTS_TIMER_ID 1
+#define RESULTSWIN_TAKE_RESULTS_INTERVAL_MS 250
+
+/* Posted by the view builder thread after the view has been built. */
+#define RESULTSWIN_VIEW_BUILT_MESSAGE_ID WM_APP
+
+#define RESULTSWIN_VIEW_BUILDER_THREAD_STACK_SIZE (1024 * 64)
+
+struct ResultsWindowCtx
+{
+    HINSTANCE app_instance_handle;
+    HWND own_window_handle;
+
+    /* Batch state */
+
+    struct BatchWorker* batch_worker;
+    BOOL is_batch_finished;
+    BOOL is_out_of_memory;
+    struct ResultStore* result_store;
+
+    /*
+     * Displayed view. As long no sort order and no filter text is set the
+     * rows are displayed in the order of the store and "view" is empty.
+     */
+    struct ResultStoreViewSpec view_spec;
+    BOOL is_identity_view;
+    struct ResultStoreView view;
+    size_t displayed_rows_count;
+
+    /*
+     * View builder state. While the thread is running no results are
+     * appended to the store, since the thread is reading from it.
+     */
+    HANDLE view_builder_thread_handle;
+    struct ResultStoreViewSpec built_view_spec;
+    size_t built_view_rows_count;
+    struct ResultStoreView built_view;
+    BOOL is_view_built_successfully;
+    BOOL is_view_outdated;
+
+    /* GUI elements */
+
+    HWND lbl_filter;
+    HWND eb_filter;
+    HWND lv_results;
+    HWND lbl_status;
+    wchar_t txt_buf[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    wchar_t hex_buf[HASH_RESULT_BUFFER_TSIZE];
+};
+
+/* Helper functions */
+
+static
+BOOL
+uhashtools_resultswin_is_identity_view_spec
+(
+    const struct ResultStoreViewSpec* view_spec
+)
+{
+    return view_spec->sort_column == RESULT_STORE_COLUMN_NONE &&
+           !view_spec->is_sort_descending &&
+           view_spec->filter_txt[0] == L'\0';
+}
+
+static
+unsigned int
+__stdcall
+uhashtools_resultswin_view_builder_thread_function
+(
+    void* thread_param
+)
+{
+    struct ResultsWindowCtx* resultswin_ctx = (struct ResultsWindowCtx*) thread_param;
+
+    UHASHTOOLS_ASSERT(resultswin_ctx, L"Internal error: Entered with thread_param == NULL!");
+
+    resultswin_ctx->is_view_built_successfully = uhashtools_result_store_build_view(resultswin_ctx->result_store,
+                                                                                    resultswin_ctx->built_view_rows_count,
+                                                                                    &resultswin_ctx->built_view_spec,
+                                                                                    &resultswin_ctx->built_view);
+
+    /* Fails if the window is already destroyed, which waits for this thread anyway. */
+    (void) PostMessageW(resultswin_ctx->own_window_handle, RESULTSWIN_VIEW_BUILT_MESSAGE_ID, 0, 0);
+
+    return 0;
+}
+
+static
+void
+uhashtools_resultswin_update_status
+(
+    struct ResultsWindowCtx* resultswin_ctx
+)
+{
+    const size_t rows_count = uhashtools_result_store_get_rows_count(resultswin_ctx->result_store);
+    const size_t failed_rows_count = uhashtools_result_store_get_failed_rows_count(resultswin_ctx->result_store);
+    const wchar_t* state_txt = NULL;
+
+    if (resultswin_ctx->is_out_of_memory)
+    {
+        state_txt = L"Failed to allocate the required memory. Please download more RAM!";
+    }
+    else if (resultswin_ctx->is_batch_finished)
+    {
+        state_txt = L"Finished.";
+    }
+    else
+    {
+        state_txt = L"Hashing...";
+    }
+
+    (void) _snwprintf_s(resultswin_ctx->txt_buf,
+                        GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                        _TRUNCATE,
+                        L"%Iu files hashed, %Iu failed, %Iu shown. %s",
+                        rows_count - failed_rows_count,
+                        failed_rows_count,
+                        resultswin_ctx->displayed_rows_count,
+                        state_txt);
+
+    uhashtools_lbl_change_text(resultswin_ctx->lbl_status, resultswin_ctx->txt_buf);
+}
+
+static
+void
+uhashtools_resultswin_set_displayed_rows_count
+(
+    struct ResultsWindowCtx* resultswin_ctx,
+    size_t rows_count,
+    BOOL keep_displayed_rows
+)
+{
+    resultswin_ctx->displayed_rows_count = rows_count;
+
+    /* Rows which are only appended at the end don't require redrawing the visible rows. */
+    (void) SendMessageW(resultswin_ctx->lv_results,
+                        LVM_SETITEMCOUNT,
+                        (WPARAM) rows_count,
+                        keep_displayed_rows ? (LPARAM) (LVSICF_NOINVALIDATEALL | LVSICF_NOSCROLL) : 0);
+
+    if (!keep_displayed_rows)
+    {
+        (void) InvalidateRect(resultswin_ctx->lv_results, NULL, TRUE);
+    }
+
+    uhashtools_resultswin_update_status(resultswin_ctx);
+}
+
+/*
+ * Displays the store with the current view spec. Views which have to be
+ * sorted or filtered are built on the view builder thread, if it's
+ * already running the view is rebuilt after it has finished.
+ */
+static
+void
+uhashtools_resultswin_update_view
+(
+    struct ResultsWindowCtx* resultswin_ctx
+)
+{
+    uintptr_t thread_handle = 0;
+
+    if (resultswin_ctx->view_builder_thread_handle)
+    {
+        resultswin_ctx->is_view_outdated = TRUE;
+        return;
+    }
+
+    if (uhashtools_resultswin_is_identity_view_spec(&resultswin_ctx->view_spec))
+    {
+        uhashtools_result_store_view_free(&resultswin_ctx->view);
+        resultswin_ctx->is_identity_view = TRUE;
+        uhashtools_resultswin_set_displayed_rows_count(resultswin_ctx,
+                                                       uhashtools_result_store_get_rows_count(resultswin_ctx->result_store),
+                                                       FALSE);
+        return;
+    }
+
+    resultswin_ctx->built_view_spec = resultswin_ctx->view_spec;
+    resultswin_ctx->built_view_rows_count = uhashtools_result_store_get_rows_count(resultswin_ctx->result_store);
+    resultswin_ctx->is_view_built_successfully = FALSE;
+
+    thread_handle = _beginthreadex(NULL,
+                                   RESULTSWIN_VIEW_BUILDER_THREAD_STACK_SIZE,
+                                   uhashtools_resultswin_view_builder_thread_function,
+                                   resultswin_ctx,
+                                   0,
+                                   NULL);
+
+    if (thread_handle == 0)
+    {
+        UHASHTOOLS_PRINTF_LINE_ERROR(L"Failed to start the view builder thread!");
+        return;
+    }
+
+    resultswin_ctx->view_builder_thread_handle = (HANDLE) thread_handle;
+}
+
+static
+void
+uhashtools_resultswin_take_results
+(
+    struct ResultsWindowCtx* resultswin_ctx
+)
+{
+    size_t previous_rows_count = 0;
+    size_t rows_count = 0;
+
+    /* The view builder thread is reading from the store. */
+    if (resultswin_ctx->view_builder_thread_handle)
+    {
+        return;
+    }
+
+    previous_rows_count = uhashtools_result_store_get_rows_count(resultswin_ctx->result_store);
+
+    if (!uhashtools_batch_worker_take_results(resultswin_ctx->batch_worker,
+                                              resultswin_ctx->result_store,
+                                              &resultswin_ctx->is_batch_finished))
+    {
+        resultswin_ctx->is_out_of_memory = TRUE;
+    }
+
+    if (resultswin_ctx->is_batch_finished)
+    {
+        (void) KillTimer(resultswin_ctx->own_window_handle, RESULTSWIN_TAKE_RESULTS_TIMER_ID);
+    }
+
+    rows_count = uhashtools_result_store_get_rows_count(resultswin_ctx->result_store);
+
+    if (rows_count == previous_rows_count)
+    {
+        uhashtools_resultswin_update_status(resultswin_ctx);
+    }
+    else if (resultswin_ctx->is_identity_view)
+    {
+        uhashtools_resultswin_set_displayed_rows_count(resultswin_ctx, rows_count, TRUE);
+    }
+    else
+    {
+        uhashtools_resultswin_update_view(resultswin_ctx);
+    }
+}
+
+static
+void
+uhashtools_resultswin_update_column_titles
+(
+    struct ResultsWindowCtx* resultswin_ctx
+)
+{
+    int column_index = 0;
+
+    for (column_index = 0; column_index < RW_LV_COLUMNS_COUNT; ++column_index)
+    {
+        const wchar_t* sort_marker = L"";
+
+        if (RW_LV_COLUMN_STORE_COLUMNS[column_index] == resultswin_ctx->view_spec.sort_column)
+        {
+            sort_marker = resultswin_ctx->view_spec.is_sort_descending ? L" \x25BC" : L" \x25B2";
+        }
+
+        (void) _snwprintf_s(resultswin_ctx->txt_buf,
+                            GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                            _TRUNCATE,
+                            L"%s%s",
+                            RW_LV_COLUMN_TITLES[column_index],
+                            sort_marker);
+
+        uhashtools_lv_set_column_text(resultswin_ctx->lv_results, column_index, resultswin_ctx->txt_buf);
+    }
+}
+
+static
+void
+uhashtools_resultswin_resize_child_elements
+(
+    struct ResultsWindowCtx* resultswin_ctx,
+    int new_width,
+    int new_height
+)
+{
+    const int eb_filter_x = MW_FC_LBL_WIDTH + (DEFAULT_DISTANCE * 2);
+    const int lv_results_y = DEFAULT_DISTANCE + RW_EB_FILTER_HIGHT + DEFAULT_DISTANCE;
+    const int lbl_status_y = new_height - DEFAULT_DISTANCE - LBL_DEFAULT_HIGHT;
+
+    uhashtools_gui_elm_resize(resultswin_ctx->eb_filter,
+                              new_width - eb_filter_x - DEFAULT_DISTANCE,
+                              RW_EB_FILTER_HIGHT);
+    uhashtools_gui_elm_resize(resultswin_ctx->lv_results,
+                              new_width - (DEFAULT_DISTANCE * 2),
+                              lbl_status_y - DEFAULT_DISTANCE - lv_results_y);
+    uhashtools_gui_elm_move(resultswin_ctx->lbl_status, DEFAULT_DISTANCE, lbl_status_y);
+    uhashtools_gui_elm_resize(resultswin_ctx->lbl_status,
+                              new_width - (DEFAULT_DISTANCE * 2),
+                              LBL_DEFAULT_HIGHT);
+}
+
+static
+void
+uhashtools_resultswin_init_ui_controls
+(
+    struct ResultsWindowCtx* resultswin_ctx
+)
+{
+    HINSTANCE app_instance = resultswin_ctx->app_instance_handle;
+    HWND hwnd = resultswin_ctx->own_window_handle;
+    RECT client_rect;
+    int column_index = 0;
+
+    resultswin_ctx->lbl_filter = uhashtools_lbl_create(app_instance,
+                                                       hwnd,
+                                                       RW_LBL_STYLE,
+                                                       0,
+                                                       DEFAULT_DISTANCE,
+                                                       DEFAULT_DISTANCE + 3,
+                                                       MW_FC_LBL_WIDTH,
+                                                       LBL_DEFAULT_HIGHT,
+                                                       L"Filter:");
+    resultswin_ctx->eb_filter = uhashtools_eb_create(app_instance,
+                                                     hwnd,
+                                                     RW_EB_FILTER_STYLE,
+                                                     RW_EB_FILTER_STYLE_EX,
+                                                     MW_FC_LBL_WIDTH + (DEFAULT_DISTANCE * 2),
+                                                     DEFAULT_DISTANCE,
+                                                     0,
+                                                     RW_EB_FILTER_HIGHT,
+                                                     L"");
+    (void) SendMessageW(resultswin_ctx->eb_filter, EM_LIMITTEXT, (WPARAM) (RESULT_STORE_FILTER_TXT_TSIZE - 1), 0);
+
+    resultswin_ctx->lv_results = uhashtools_lv_create(app_instance,
+                                                      hwnd,
+                                                      RW_LV_RESULTS_STYLE,
+                                                      RW_LV_RESULTS_STYLE_EX,
+                                                      DEFAULT_DISTANCE,
+                                                      DEFAULT_DISTANCE + RW_EB_FILTER_HIGHT + DEFAULT_DISTANCE,
+                                                      0,
+                                                      0);
+    (void) SendMessageW(resultswin_ctx->lv_results,
+                        LVM_SETEXTENDEDLISTVIEWSTYLE,
+                        (WPARAM) LVS_EX_FULLROWSELECT,
+                        (LPARAM) LVS_EX_FULLROWSELECT);
+
+    for (column_index = 0; column_index < RW_LV_COLUMNS_COUNT; ++column_index)
+    {
+        uhashtools_lv_add_column(resultswin_ctx->lv_results,
+                                 column_index,
+                                 RW_LV_COLUMN_WIDTHS[column_index],
+                                 RW_LV_COLUMN_FORMATS[column_index],
+                                 RW_LV_COLUMN_TITLES[column_index]);
+    }
+
+    resultswin_ctx->lbl_status = uhashtools_lbl_create(app_instance,
+                                                       hwnd,
+                                                       RW_LBL_STYLE,
+                                                       0,
+                                                       DEFAULT_DISTANCE,
+                                                       0,
+                                                       0,
+                                                       LBL_DEFAULT_HIGHT,
+                                                       L"");
+
+    (void) GetClientRect(hwnd, &client_rect);
+    uhashtools_resultswin_resize_child_elements(resultswin_ctx,
+                                                client_rect.right - client_rect.left,
+                                                client_rect.bottom - client_rect.top);
+    uhashtools_resultswin_update_status(resultswin_ctx);
+}
+
+/* Event handlers */
+
+static
+void
+uhashtools_resultswin_on_view_built
+(
+    struct ResultsWindowCtx* resultswin_ctx
+)
+{
+    DWORD wait_rc = 0;
+
+    if (!resultswin_ctx->view_builder_thread_handle)
+    {
+        return;
+    }
+
+    wait_rc = WaitForSingleObject(resultswin_ctx->view_builder_thread_handle, INFINITE);
+    UHASHTOOLS_ASSERT(wait_rc == WAIT_OBJECT_0, L"Internal error: Failed to wait for the view builder thread!");
+
+    (void) CloseHandle(resultswin_ctx->view_builder_thread_handle);
+    resultswin_ctx->view_builder_thread_handle = NULL;
+
+    if (!resultswin_ctx->is_view_built_successfully)
+    {
+        resultswin_ctx->is_out_of_memory = TRUE;
+        uhashtools_resultswin_update_status(resultswin_ctx);
+    }
+    else if (resultswin_ctx->is_view_outdated)
+    {
+        /* The view spec has changed in the meantime, the built view isn't displayed at all. */
+        uhashtools_result_store_view_free(&resultswin_ctx->built_view);
+    }
+    else
+    {
+        uhashtools_result_store_view_free(&resultswin_ctx->view);
+        resultswin_ctx->view = resultswin_ctx->built_view;
+        (void) memset((void*) &resultswin_ctx->built_view, 0, sizeof resultswin_ctx->built_view);
+        resultswin_ctx->is_identity_view = FALSE;
+
+        uhashtools_resultswin_set_displayed_rows_count(resultswin_ctx, resultswin_ctx->view.rows_count, FALSE);
+    }
+
+    if (resultswin_ctx->is_view_outdated)
+    {
+        resultswin_ctx->is_view_outdated = FALSE;
+        uhashtools_resultswin_update_view(resultswin_ctx);
+    }
+}
+
+static
+void
+uhashtools_resultswin_on_filter_changed
+(
+    struct ResultsWindowCtx* resultswin_ctx
+)
+{
+    (void) GetWindowTextW(resultswin_ctx->eb_filter,
+                          resultswin_ctx->view_spec.filter_txt,
+                          RESULT_STORE_FILTER_TXT_TSIZE);
+
+    uhashtools_resultswin_update_view(resultswin_ctx);
+}
+
+/*
+ * Clicking a column sorts ascending by it, clicking it again sorts
+ * descending and a third click restores the order of the batch.
+ */
+static
+void
+uhashtools_resultswin_on_column_clicked
+(
+    struct ResultsWindowCtx* resultswin_ctx,
+    int column_index
+)
+{
+    struct ResultStoreViewSpec* view_spec = &resultswin_ctx->view_spec;
+    enum ResultStoreColumn clicked_column = RESULT_STORE_COLUMN_NONE;
+
+    if (column_index < 0 || column_index >= RW_LV_COLUMNS_COUNT)
+    {
+        return;
+    }
+
+    clicked_column = RW_LV_COLUMN_STORE_COLUMNS[column_index];
+
+    if (view_spec->sort_column != clicked_column)
+    {
+        view_spec->sort_column = clicked_column;
+        view_spec->is_sort_descending = FALSE;
+    }
+    else if (!view_spec->is_sort_descending)
+    {
+        view_spec->is_sort_descending = TRUE;
+    }
+    else
+    {
+        view_spec->sort_column = RESULT_STORE_COLUMN_NONE;
+        view_spec->is_sort_descending = FALSE;
+    }
+
+    uhashtools_resultswin_update_column_titles(resultswin_ctx);
+    uhashtools_resultswin_update_view(resultswin_ctx);
+}
+
+/* Only the texts of the visible rows are requested by the list view. */
+static
+void
+uhashtools_resultswin_on_get_display_info
+(
+    struct ResultsWindowCtx* resultswin_ctx,
+    NMLVDISPINFOW* display_info
+)
+{
+    LVITEMW* item = &display_info->item;
+    const struct ResultStore* result_store = resultswin_ctx->result_store;
+    struct HashDigest digest;
+    size_t row_index = 0;
+
+    if (!(item->mask & LVIF_TEXT) || !item->pszText || item->cchTextMax <= 0)
+    {
+        return;
+    }
+
+    item->pszText[0] = L'\0';
+
+    if (item->iItem < 0 || (size_t) item->iItem >= resultswin_ctx->displayed_rows_count)
+    {
+        return;
+    }
+
+    row_index = resultswin_ctx->is_identity_view ? (size_t) item->iItem
+                                                 : (size_t) resultswin_ctx->view.row_indexes[item->iItem];
+
+    switch (item->iSubItem)
+    {
+        case 0:
+        {
+            uhashtools_result_store_get_filepath(result_store, row_index, item->pszText, (size_t) item->cchTextMax);
+        } break;
+        case 1:
+        {
+            (void) _snwprintf_s(item->pszText,
+                                (size_t) item->cchTextMax,
+                                _TRUNCATE,
+                                L"%I64u",
+                                uhashtools_result_store_get_file_size(result_store, row_index));
+        } break;
+        case 2:
+        {
+            if (uhashtools_result_store_get_digest(result_store, row_index, &digest))
+            {
+                (void) uhashtools_hash_calculator_impl_digest_to_hex(&digest,
+                                                                     resultswin_ctx->hex_buf,
+                                                                     HASH_RESULT_BUFFER_TSIZE);
+                (void) wcsncpy_s(item->pszText, (size_t) item->cchTextMax, resultswin_ctx->hex_buf, _TRUNCATE);
+            }
+            else
+            {
+                (void) wcsncpy_s(item->pszText,
+                                 (size_t) item->cchTextMax,
+                                 uhashtools_result_store_get_error_message(result_store, row_index),
+                                 _TRUNCATE);
+            }
+        } break;
+        default:
+        {
+            break;
+        }
+    }
+}
+
+/* Message handlers */
+
+static
+LRESULT
+uhashtools_resultswin_handle_message_WM_CREATE
+(
+    HWND hwnd,
+    LPARAM lParam
+)
+{
+    struct ResultsWindowCtx* resultswin_ctx = NULL;
+    const CREATESTRUCTW* create_params = (const CREATESTRUCTW*) lParam;
+    LONG_PTR set_window_long_ptr_rc = 0;
+
+    if (create_params == NULL || create_params->lpCreateParams == NULL)
+    {
+        UHASHTOOLS_PRINTF_LINE_ERROR(L"Results window: WM_CREATE failed! 'create_params' or 'create_params->lpCreateParams' were NULL!");
+
+        return -1;
+    }
+
+    resultswin_ctx = (struct ResultsWindowCtx*) create_params->lpCreateParams;
+    resultswin_ctx->own_window_handle = hwnd;
+
+    uhashtools_resultswin_init_ui_controls(resultswin_ctx);
+
+    if (!SetTimer(hwnd, RESULTSWIN_TAKE_RESULTS_TIMER_ID, RESULTSWIN_TAKE_RESULTS_INTERVAL_MS, NULL))
+    {
+        UHASHTOOLS_PRINTF_LINE_ERROR(L"Results window: WM_CREATE failed! Function 'SetTimer()' failed!");
+
+        return -1;
+    }
+
+    /* From now on the window owns the context data, see WM_NCDESTROY. */
+    SetLastError(0);
+    set_window_long_ptr_rc = SetWindowLongPtrW(hwnd, GWLP_USERDATA, (LONG_PTR) resultswin_ctx);
+
+    if (!set_window_long_ptr_rc && GetLastError() != 0)
+    {
+        UHASHTOOLS_PRINTF_LINE_ERROR(L"Results window: WM_CREATE failed! Function 'SetWindowLongPtrW()' failed!");
+
+        return -1;
+    }
+
+    return 0;
+}
+
+static
+void
+uhashtools_resultswin_ctx_free
+(
+    struct ResultsWindowCtx* resultswin_ctx
+)
+{
+    DWORD wait_rc = 0;
+
+    if (resultswin_ctx->view_builder_thread_handle)
+    {
+        wait_rc = WaitForSingleObject(resultswin_ctx->view_builder_thread_handle, INFINITE);
+        UHASHTOOLS_ASSERT(wait_rc == WAIT_OBJECT_0, L"Internal error: Failed to wait for the view builder thread!");
+
+        (void) CloseHandle(resultswin_ctx->view_builder_thread_handle);
+    }
+
+    uhashtools_batch_worker_destroy(resultswin_ctx->batch_worker);
+    uhashtools_result_store_view_free(&resultswin_ctx->built_view);
+    uhashtools_result_store_view_free(&resultswin_ctx->view);
+    uhashtools_result_store_destroy(resultswin_ctx->result_store);
+    free((void*) resultswin_ctx);
+}
+
+static
+LRESULT
+uhashtools_resultswin_handle_message_WM_NCDESTROY
+(
+    HWND hwnd,
+    struct ResultsWindowCtx* resultswin_ctx
+)
+{
+    /* The child windows are already destroyed at this point. */
+    (void) SetWindowLongPtrW(hwnd, GWLP_USERDATA, 0);
+    (void) KillTimer(hwnd, RESULTSWIN_TAKE_RESULTS_TIMER_ID);
+
+    uhashtools_resultswin_ctx_free(resultswin_ctx);
+
+    return 0;
+}
+
+static
+LRESULT
+uhashtools_resultswin_handle_message_WM_NOTIFY
+(
+    HWND hwnd,
+    UINT uMsg,
+    WPARAM wParam,
+    LPARAM lParam,
+    struct ResultsWindowCtx* resultswin_ctx
+)
+{
+    const NMHDR* notification = (const NMHDR*) lParam;
+
+    if (notification->hwndFrom == resultswin_ctx->lv_results)
+    {
+        if (notification->code == LVN_GETDISPINFOW)
+        {
+            uhashtools_resultswin_on_get_display_info(resultswin_ctx, (NMLVDISPINFOW*) lParam);
+
+            return 0;
+        }
+        else if (notification->code == LVN_COLUMNCLICK)
+        {
+            uhashtools_resultswin_on_column_clicked(resultswin_ctx, ((const NMLISTVIEW*) lParam)->iSubItem);
+
+            return 0;
+        }
+    }
+
+    return DefWindowProcW(hwnd, uMsg, wParam, lParam);
+}
+
+static
+LRESULT
+CALLBACK uhashtools_resultswin_proc
+(
+    HWND hwnd,
+    UINT uMsg,
+    WPARAM wParam,
+    LPARAM lParam
+)
+{
+    struct ResultsWindowCtx* resultswin_ctx = NULL;
+
+    resultswin_ctx = (struct ResultsWindowCtx*) GetWindowLongPtrW(hwnd, GWLP_USERDATA);
+
+    if (uMsg == WM_CREATE)
+    {
+        return uhashtools_resultswin_handle_message_WM_CREATE(hwnd, lParam);
+    }
+    else if (uMsg == WM_GETMINMAXINFO)
+    {
+        MINMAXINFO* min_max_info = (MINMAXINFO*) lParam;
+
+        min_max_info->ptMinTrackSize.x = RESULTSWIN_WIDTH_MIN;
+        min_max_info->ptMinTrackSize.y = RESULTSWIN_HIGHT_MIN;
+
+        return 0;
+    }
+    else if (uMsg == WM_CTLCOLORSTATIC || uMsg == WM_CTLCOLOREDIT)
+    {
+        HDC hdc = (HDC) wParam;
+        SetTextColor(hdc, GetSysColor(COLOR_WINDOWTEXT));
+        SetBkColor(hdc, GetSysColor(COLOR_WINDOW));
+
+        return (LRESULT) GetSysColorBrush(COLOR_WINDOW);
+    }
+    else if (resultswin_ctx && uMsg == WM_NCDESTROY)
+    {
+        return uhashtools_resultswin_handle_message_WM_NCDESTROY(hwnd, resultswin_ctx);
+    }
+    else if (resultswin_ctx && uMsg == WM_SIZE)
+    {
+        uhashtools_resultswin_resize_child_elements(resultswin_ctx, LOWORD(lParam), HIWORD(lParam));
+
+        return 0;
+    }
+    else if (resultswin_ctx && uMsg == WM_TIMER && wParam == RESULTSWIN_TAKE_RESULTS_TIMER_ID)
+    {
+        uhashtools_resultswin_take_results(resultswin_ctx);
+
+        return 0;
+    }
+    else if (resultswin_ctx && uMsg == RESULTSWIN_VIEW_BUILT_MESSAGE_ID)
+    {
+        uhashtools_resultswin_on_view_built(resultswin_ctx);
+
+        return 0;
+    }
+    else if (resultswin_ctx && uMsg == WM_COMMAND &&
+             (HWND) lParam == resultswin_ctx->eb_filter && HIWORD(wParam) == EN_CHANGE)
+    {
+        uhashtools_resultswin_on_filter_changed(resultswin_ctx);
+
+        return 0;
+    }
+    else if (resultswin_ctx && uMsg == WM_NOTIFY)
+    {
+        return uhashtools_resultswin_handle_message_WM_NOTIFY(hwnd, uMsg, wParam, lParam, resultswin_ctx);
+    }
+    else
+    {
+        return DefWindowProcW(hwnd, uMsg, wParam, lParam);
+    }
+}
+
+static
+BOOL
+uhashtools_resultswin_register_class
+(
+    HINSTANCE app_instance
+)
+{
+    WNDCLASSEXW wc;
+
+    (void) memset((void*) &wc, 0, sizeof wc);
+
+    wc.cbSize = sizeof(WNDCLASSEXW);
+    wc.lpfnWndProc = uhashtools_resultswin_proc;
+    wc.hInstance = app_instance;
+    wc.lpszClassName = RESULTSWIN_CLASSNAME;
+    wc.hIcon = LoadIconW(app_instance, L"UHASHTOOLS_APPLICATION_ICON");
+    wc.hCursor = LoadCursorW(NULL, IDC_ARROW);
+    wc.hbrBackground = (HBRUSH) (COLOR_WINDOW + 1);
+
+    /* The class is registered by the first results window and kept until the process exits. */
+    return RegisterClassExW(&wc) != 0 || GetLastError() == ERROR_CLASS_ALREADY_EXISTS;
+}
+
+/* API functions */
+
+BOOL
+uhashtools_resultswin_open
+(
+    HINSTANCE app_instance,
+    HWND owner_window,
+    const wchar_t* const* paths,
+    size_t paths_count
+)
+{
+    struct ResultsWindowCtx* resultswin_ctx = NULL;
+    wchar_t title[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    HWND resultswin_handle = NULL;
+
+    UHASHTOOLS_ASSERT(paths, L"Internal error: Entered with paths == NULL!");
+
+    if (!uhashtools_resultswin_register_class(app_instance))
+    {
+        UHASHTOOLS_PRINTF_LINE_ERROR(L"Failed to register the results window class!");
+
+        return FALSE;
+    }
+
+    resultswin_ctx = (struct ResultsWindowCtx*) calloc(1, sizeof *resultswin_ctx);
+
+    if (!resultswin_ctx)
+    {
+        return FALSE;
+    }
+
+    resultswin_ctx->app_instance_handle = app_instance;
+    resultswin_ctx->is_identity_view = TRUE;
+    resultswin_ctx->result_store = uhashtools_result_store_create();
+
+    if (resultswin_ctx->result_store)
+    {
+        resultswin_ctx->batch_worker = uhashtools_batch_worker_start(paths, paths_count);
+    }
+
+    if (!resultswin_ctx->batch_worker)
+    {
+        uhashtools_resultswin_ctx_free(resultswin_ctx);
+
+        return FALSE;
+    }
+
+    (void) _snwprintf_s(title,
+                        GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                        _TRUNCATE,
+                        L"%s - Results",
+                        uhashtools_product_get_mainwin_title());
+
+    resultswin_handle = CreateWindowExW(RESULTSWIN_STYLE_EX,
+                                        RESULTSWIN_CLASSNAME,
+                                        title,
+                                        RESULTSWIN_STYLE,
+                                        CW_USEDEFAULT,
+                                        CW_USEDEFAULT,
+                                        RESULTSWIN_WIDTH,
+                                        RESULTSWIN_HIGHT,
+                                        owner_window,
+                                        NULL,
+                                        app_instance,
+                                        (LPVOID) resultswin_ctx);
+
+    if (!resultswin_handle)
+    {
+        /* The context data is only owned by the window if it has been created. */
+        uhashtools_resultswin_ctx_free(resultswin_ctx);
+
+        return FALSE;
+    }
+
+    ShowWindow(resultswin_handle, SW_SHOWNORMAL);
+    UpdateWindow(resultswin_handle);
+
+    return TRUE;
+}
@@ -0,0 +1,45 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+/*
+ * The results window shows the results of a batch of dropped files and
+ * directories. Every batch gets its own window, which is owned by the
+ * main window and hashes its batch with a batch worker (see
+ * "batch_worker.h").
+ * 
+ * The results are kept in a result store (see "result_store.h") and are
+ * shown by a list view with the style LVS_OWNERDATA, which only asks for
+ * the texts of the visible rows. Sorting by a column and filtering are
+ * done by building a view of the store on a separate thread, so the
+ * window stays responsive with hundreds of thousands of rows.
+ */
+
+/**
+ * Opens a results window and starts hashing the batch.
+ * 
+ * @param app_instance Handle of the application.
+ * @param owner_window Window which owns the results window.
+ * @param paths Paths of the dropped files and directories. They are
+ *              copied, so they only have to be valid during the call.
+ * @param paths_count Amount of the paths.
+ * 
+ * @return TRUE if the window has been opened and FALSE on error.
+ */
+extern
+BOOL
+uhashtools_resultswin_open
+(
+    HINSTANCE app_instance,
+    HWND owner_window,
+    const wchar_t* const* paths,
+    size_t paths_count
+);
@@ -0,0 +1,678 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "serve_mode.h"
+
+#include "buffer_sizes.h"
+#include "digest_cache.h"
+#include "error_utilities.h"
+#include "file_source.h"
+#include "file_source_stream.h"
+#include "hash_calculation_impl.h"
+#include "std_streams.h"
+
+#include <process.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wctype.h>
+
+/* Cache hits are cheap, so there are more pipe instances than hashing threads on small machines. */
+#define SERVE_MODE_MIN_INSTANCES 4
+#define SERVE_MODE_MAX_INSTANCES 64
+
+#define SERVE_MODE_PIPE_BUFFER_SIZE 4096
+#define SERVE_MODE_THREAD_STACK_SIZE (1024 * 64)
+
+/* Interval for canceling the blocking pipe operations of the instances while stopping. */
+#define SERVE_MODE_STOP_POLL_INTERVAL_MS 100
+
+/* A path of a request always fits into FILEPATH_BUFFER_TSIZE with its terminator. */
+#define SERVE_MODE_REQUEST_BUFFER_SIZE (SERVE_MODE_MESSAGE_HEADER_SIZE + (FILEPATH_BUFFER_TSIZE - 1) * sizeof(wchar_t))
+#define SERVE_MODE_RESPONSE_BUFFER_SIZE (SERVE_MODE_MESSAGE_HEADER_SIZE + GENERIC_TXT_MESSAGES_BUFFER_TSIZE * sizeof(wchar_t))
+
+struct ServeModeCtx;
+
+struct ServeModeInstance
+{
+    struct ServeModeCtx* ctx;
+    HANDLE pipe_handle;
+    HANDLE thread_handle;
+
+    /* Keeps the algorithm provider open, so it isn't opened again for every request. */
+    struct PreparedHasher* prepared_hasher;
+    unsigned char* file_read_buf;
+    unsigned char request_buf[SERVE_MODE_REQUEST_BUFFER_SIZE];
+    unsigned char response_buf[SERVE_MODE_RESPONSE_BUFFER_SIZE];
+    wchar_t filepath[FILEPATH_BUFFER_TSIZE];
+    wchar_t error_message_buf[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+
+    /* Only written by the thread of the instance, summed up after it has exited. */
+    unsigned __int64 requests_count;
+    unsigned __int64 cache_hits_count;
+};
+
+struct ServeModeCtx
+{
+    wchar_t pipe_path[FILEPATH_BUFFER_TSIZE];
+
+    /* Manual reset event which is set by a stop request. */
+    HANDLE stop_event;
+    struct DigestCache* digest_cache;
+
+    struct ServeModeInstance* instances;
+    unsigned int instances_count;
+};
+
+static
+BOOL
+uhashtools_serve_mode_is_stopping
+(
+    struct ServeModeCtx* ctx
+)
+{
+    return WaitForSingleObject(ctx->stop_event, 0) == WAIT_OBJECT_0;
+}
+
+static
+BOOL
+uhashtools_serve_mode_write_response
+(
+    struct ServeModeInstance* instance,
+    unsigned char status,
+    unsigned char flags,
+    const struct HashDigest* digest
+)
+{
+    DWORD response_size = SERVE_MODE_MESSAGE_HEADER_SIZE;
+    DWORD written_size = 0;
+
+    instance->response_buf[0] = status;
+    instance->response_buf[1] = flags;
+    instance->response_buf[2] = 0;
+    instance->response_buf[3] = 0;
+
+    if (status == SERVE_MODE_RESPONSE_OK && digest)
+    {
+        instance->response_buf[2] = (unsigned char) digest->size;
+        (void) memcpy((void*) (instance->response_buf + SERVE_MODE_MESSAGE_HEADER_SIZE), (const void*) digest->bytes, digest->size);
+        response_size += digest->size;
+    }
+    else if (status == SERVE_MODE_RESPONSE_FAILED)
+    {
+        const size_t message_size = wcslen(instance->error_message_buf) * sizeof(wchar_t);
+
+        (void) memcpy((void*) (instance->response_buf + SERVE_MODE_MESSAGE_HEADER_SIZE),
+                      (const void*) instance->error_message_buf,
+                      message_size);
+        response_size += (DWORD) message_size;
+    }
+
+    return WriteFile(instance->pipe_handle, (LPCVOID) instance->response_buf, response_size, &written_size, NULL) &&
+           written_size == response_size;
+}
+
+static
+BOOL
+uhashtools_serve_mode_write_error
+(
+    struct ServeModeInstance* instance,
+    const wchar_t* error_message
+)
+{
+    (void) wcscpy_s(instance->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, error_message);
+
+    return uhashtools_serve_mode_write_response(instance, SERVE_MODE_RESPONSE_FAILED, 0, NULL);
+}
+
+/*
+ * Checks if the path of a request addresses a device instead of a file.
+ * Besides the stream targets of the file sources this are the paths in
+ * the Win32 device namespace and named pipes on a server, which would be
+ * connected by opening them. Windows accepts slashes as separators, so
+ * they are compared as backslashes.
+ */
+static
+BOOL
+uhashtools_serve_mode_is_device_path
+(
+    const wchar_t* filepath
+)
+{
+    wchar_t normalized_path[FILEPATH_BUFFER_TSIZE];
+    const wchar_t* unc_path = NULL;
+    const wchar_t* share_name = NULL;
+    size_t char_index = 0;
+
+    if (uhashtools_file_source_stream_is_stream_target(filepath))
+    {
+        return TRUE;
+    }
+
+    for (char_index = 0; char_index < FILEPATH_BUFFER_TSIZE - 1 && filepath[char_index] != L'\0'; ++char_index)
+    {
+        normalized_path[char_index] = filepath[char_index] == L'/' ? L'\\' : filepath[char_index];
+    }
+
+    normalized_path[char_index] = L'\0';
+
+    if (wcsncmp(normalized_path, L"\\\\.\\", 4) == 0)
+    {
+        return TRUE;
+    }
+
+    if (wcsncmp(normalized_path, L"\\\\?\\", 4) == 0)
+    {
+        if (_wcsnicmp(normalized_path + 4, L"UNC\\", 4) != 0)
+        {
+            /* Only drive paths like "\\?\C:\" are allowed in the long path form. */
+            return !(iswalpha(normalized_path[4]) && normalized_path[5] == L':' && normalized_path[6] == L'\\');
+        }
+
+        unc_path = normalized_path + 8;
+    }
+    else if (wcsncmp(normalized_path, L"\\\\", 2) == 0)
+    {
+        unc_path = normalized_path + 2;
+    }
+
+    if (!unc_path)
+    {
+        return FALSE;
+    }
+
+    share_name = wcschr(unc_path, L'\\');
+
+    return share_name && _wcsnicmp(share_name + 1, L"pipe", 4) == 0 &&
+           (share_name[5] == L'\\' || share_name[5] == L'\0');
+}
+
+/*
+ * Gets the size and the last write time of a regular file. Devices like
+ * "CON" or "NUL" and directories are reported as failure.
+ */
+static
+BOOL
+uhashtools_serve_mode_get_file_state
+(
+    const wchar_t* filepath,
+    unsigned __int64* file_size,
+    unsigned __int64* last_write_time
+)
+{
+    HANDLE file_handle = INVALID_HANDLE_VALUE;
+    BY_HANDLE_FILE_INFORMATION file_information;
+    BOOL is_regular_file = FALSE;
+
+    file_handle = CreateFileW(filepath,
+                              FILE_READ_ATTRIBUTES,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL,
+                              OPEN_EXISTING,
+                              0,
+                              NULL);
+
+    if (file_handle == INVALID_HANDLE_VALUE)
+    {
+        return FALSE;
+    }
+
+    is_regular_file = GetFileType(file_handle) == FILE_TYPE_DISK &&
+                      GetFileInformationByHandle(file_handle, &file_information) &&
+                      !(file_information.dwFileAttributes & (FILE_ATTRIBUTE_DIRECTORY | FILE_ATTRIBUTE_DEVICE));
+
+    (void) CloseHandle(file_handle);
+
+    if (!is_regular_file)
+    {
+        return FALSE;
+    }
+
+    *file_size = ((unsigned __int64) file_information.nFileSizeHigh << 32) | file_information.nFileSizeLow;
+    *last_write_time = ((unsigned __int64) file_information.ftLastWriteTime.dwHighDateTime << 32) |
+                       file_information.ftLastWriteTime.dwLowDateTime;
+
+    return TRUE;
+}
+
+/*
+ * The paths are sent by other processes, so they are only opened as
+ * regular files. The server never reads its own standard input or
+ * connects to a named pipe on behalf of a client.
+ */
+static
+BOOL
+uhashtools_serve_mode_hash_file
+(
+    struct ServeModeInstance* instance,
+    struct HashDigest* digest,
+    BOOL* is_cached
+)
+{
+    unsigned __int64 file_size = 0;
+    unsigned __int64 last_write_time = 0;
+    unsigned __int64 hashed_file_size = 0;
+    unsigned __int64 hashed_last_write_time = 0;
+    struct FileSource file_source;
+    enum HashCalculatorResultCode hash_rc = HashCalculatorResultCode_FAILED;
+
+    *is_cached = FALSE;
+
+    if (uhashtools_serve_mode_is_device_path(instance->filepath))
+    {
+        (void) wcscpy_s(instance->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, L"Only regular files can be hashed!");
+
+        return FALSE;
+    }
+
+    if (!uhashtools_serve_mode_get_file_state(instance->filepath, &file_size, &last_write_time))
+    {
+        (void) wcscpy_s(instance->error_message_buf, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, L"Failed to open the selected file!");
+
+        return FALSE;
+    }
+
+    if (uhashtools_digest_cache_lookup(instance->ctx->digest_cache, instance->filepath, file_size, last_write_time, digest))
+    {
+        *is_cached = TRUE;
+
+        return TRUE;
+    }
+
+    file_source = uhashtools_file_source_open_regular_file(instance->error_message_buf,
+                                                           GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                           instance->filepath);
+
+    if (!file_source.is_ok)
+    {
+        return FALSE;
+    }
+
+    hash_rc = uhashtools_hash_calculator_impl_hash_file_source_with_hasher_to_digest(instance->prepared_hasher,
+                                                                                     instance->file_read_buf,
+                                                                                     FILE_READ_BUF_TSIZE,
+                                                                                     digest,
+                                                                                     instance->error_message_buf,
+                                                                                     GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                                                     &file_source,
+                                                                                     NULL,
+                                                                                     NULL,
+                                                                                     NULL,
+                                                                                     NULL);
+
+    uhashtools_file_source_close(&file_source);
+
+    if (hash_rc != HashCalculatorResultCode_SUCCESS)
+    {
+        return FALSE;
+    }
+
+    /* The digest of a file which has been changed while it has been hashed may mix both versions, so it isn't cached. */
+    if (uhashtools_serve_mode_get_file_state(instance->filepath, &hashed_file_size, &hashed_last_write_time) &&
+        hashed_file_size == file_size && hashed_last_write_time == last_write_time)
+    {
+        uhashtools_digest_cache_store(instance->ctx->digest_cache, instance->filepath, file_size, last_write_time, digest);
+    }
+
+    return TRUE;
+}
+
+/*
+ * Reads and answers a single request.
+ * 
+ * @return FALSE if the connection should be closed.
+ */
+static
+BOOL
+uhashtools_serve_mode_serve_request
+(
+    struct ServeModeInstance* instance
+)
+{
+    DWORD request_size = 0;
+    DWORD path_size = 0;
+    struct HashDigest digest;
+    BOOL is_cached = FALSE;
+
+    if (!ReadFile(instance->pipe_handle, (LPVOID) instance->request_buf, SERVE_MODE_REQUEST_BUFFER_SIZE, &request_size, NULL))
+    {
+        /* Anything else than a too big message means that the client has disconnected or the server is stopping. */
+        if (GetLastError() != ERROR_MORE_DATA)
+        {
+            return FALSE;
+        }
+
+        while (!ReadFile(instance->pipe_handle, (LPVOID) instance->request_buf, SERVE_MODE_REQUEST_BUFFER_SIZE, &request_size, NULL))
+        {
+            if (GetLastError() != ERROR_MORE_DATA)
+            {
+                return FALSE;
+            }
+        }
+
+        ++instance->requests_count;
+
+        return uhashtools_serve_mode_write_error(instance, L"The path is too long!");
+    }
+
+    ++instance->requests_count;
+
+    if (request_size < SERVE_MODE_MESSAGE_HEADER_SIZE)
+    {
+        return uhashtools_serve_mode_write_error(instance, L"The request is malformed!");
+    }
+
+    switch (instance->request_buf[0])
+    {
+        case SERVE_MODE_REQUEST_HASH_FILE:
+            path_size = request_size - SERVE_MODE_MESSAGE_HEADER_SIZE;
+
+            if (path_size == 0 || path_size % sizeof(wchar_t) != 0)
+            {
+                return uhashtools_serve_mode_write_error(instance, L"The request is malformed!");
+            }
+
+            (void) memcpy((void*) instance->filepath,
+                          (const void*) (instance->request_buf + SERVE_MODE_MESSAGE_HEADER_SIZE),
+                          path_size);
+            instance->filepath[path_size / sizeof(wchar_t)] = L'\0';
+
+            if (!uhashtools_serve_mode_hash_file(instance, &digest, &is_cached))
+            {
+                return uhashtools_serve_mode_write_response(instance, SERVE_MODE_RESPONSE_FAILED, 0, NULL);
+            }
+
+            if (is_cached)
+            {
+                ++instance->cache_hits_count;
+            }
+
+            return uhashtools_serve_mode_write_response(instance,
+                                                        SERVE_MODE_RESPONSE_OK,
+                                                        is_cached ? SERVE_MODE_RESPONSE_FLAG_CACHED : 0,
+                                                        &digest);
+
+        case SERVE_MODE_REQUEST_STOP:
+            (void) SetEvent(instance->ctx->stop_event);
+            (void) uhashtools_serve_mode_write_response(instance, SERVE_MODE_RESPONSE_OK, 0, NULL);
+
+            return FALSE;
+
+        default:
+            return uhashtools_serve_mode_write_error(instance, L"The request type is unknown!");
+    }
+}
+
+/* Serves one client after the other on the pipe instance until the server is stopping. */
+static
+unsigned int
+__stdcall
+uhashtools_serve_mode_instance_thread_function
+(
+    void* thread_param
+)
+{
+    struct ServeModeInstance* instance = (struct ServeModeInstance*) thread_param;
+
+    while (!uhashtools_serve_mode_is_stopping(instance->ctx))
+    {
+        if (!ConnectNamedPipe(instance->pipe_handle, NULL) && GetLastError() != ERROR_PIPE_CONNECTED)
+        {
+            /* A client which has disconnected before it has been accepted leaves the instance in the closing state. */
+            (void) DisconnectNamedPipe(instance->pipe_handle);
+
+            continue;
+        }
+
+        while (!uhashtools_serve_mode_is_stopping(instance->ctx) && uhashtools_serve_mode_serve_request(instance))
+        {
+        }
+
+        /* Lets the client read the last response before the connection is closed. */
+        (void) FlushFileBuffers(instance->pipe_handle);
+        (void) DisconnectNamedPipe(instance->pipe_handle);
+    }
+
+    return 0;
+}
+
+static
+unsigned int
+uhashtools_serve_mode_get_instances_count
+(
+    void
+)
+{
+    SYSTEM_INFO system_info;
+    unsigned int instances_count = 0;
+
+    GetSystemInfo(&system_info);
+
+    instances_count = (unsigned int) system_info.dwNumberOfProcessors;
+
+    if (instances_count < SERVE_MODE_MIN_INSTANCES)
+    {
+        instances_count = SERVE_MODE_MIN_INSTANCES;
+    }
+
+    if (instances_count > SERVE_MODE_MAX_INSTANCES)
+    {
+        instances_count = SERVE_MODE_MAX_INSTANCES;
+    }
+
+    return instances_count;
+}
+
+static
+BOOL
+uhashtools_serve_mode_create_instances
+(
+    struct ServeModeCtx* ctx
+)
+{
+    unsigned int instance_index = 0;
+
+    for (instance_index = 0; instance_index < ctx->instances_count; ++instance_index)
+    {
+        struct ServeModeInstance* instance = &ctx->instances[instance_index];
+
+        instance->ctx = ctx;
+        instance->pipe_handle = INVALID_HANDLE_VALUE;
+        instance->file_read_buf = (unsigned char*) malloc(FILE_READ_BUF_TSIZE);
+
+        if (!instance->file_read_buf)
+        {
+            (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+            return FALSE;
+        }
+
+        instance->prepared_hasher = uhashtools_hash_calculator_impl_prepare_hasher(instance->error_message_buf,
+                                                                                   GENERIC_TXT_MESSAGES_BUFFER_TSIZE);
+
+        if (!instance->prepared_hasher)
+        {
+            (void) fwprintf_s(stderr, L"%s\n", instance->error_message_buf);
+
+            return FALSE;
+        }
+
+        /* The first instance fails if another process is already serving on the pipe name. */
+        instance->pipe_handle = CreateNamedPipeW(ctx->pipe_path,
+                                                 PIPE_ACCESS_DUPLEX | (instance_index == 0 ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0),
+                                                 PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                                                 PIPE_UNLIMITED_INSTANCES,
+                                                 SERVE_MODE_PIPE_BUFFER_SIZE,
+                                                 SERVE_MODE_PIPE_BUFFER_SIZE,
+                                                 0,
+                                                 NULL);
+
+        if (instance->pipe_handle == INVALID_HANDLE_VALUE)
+        {
+            if (instance_index == 0 && GetLastError() == ERROR_ACCESS_DENIED)
+            {
+                (void) fwprintf_s(stderr, L"%s: Another process is already serving on this pipe!\n", ctx->pipe_path);
+            }
+            else
+            {
+                (void) fwprintf_s(stderr, L"%s: Failed to create the named pipe!\n", ctx->pipe_path);
+            }
+
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Runs the instance threads until a stop request has been received. The
+ * threads are blocked in the pipe operations while waiting for clients,
+ * so these operations are canceled until the threads have noticed the
+ * stop request.
+ */
+static
+int
+uhashtools_serve_mode_serve
+(
+    struct ServeModeCtx* ctx
+)
+{
+    unsigned int instance_index = 0;
+    unsigned int started_threads_count = 0;
+    unsigned __int64 requests_count = 0;
+    unsigned __int64 cache_hits_count = 0;
+    int ret = 0;
+
+    for (instance_index = 0; instance_index < ctx->instances_count; ++instance_index)
+    {
+        unsigned int thread_id = 0;
+        const uintptr_t thread_handle = _beginthreadex(NULL,
+                                                       SERVE_MODE_THREAD_STACK_SIZE,
+                                                       uhashtools_serve_mode_instance_thread_function,
+                                                       (void*) &ctx->instances[instance_index],
+                                                       0,
+                                                       &thread_id);
+
+        if (thread_handle == 0)
+        {
+            (void) fwprintf_s(stderr, L"%s: Failed to start the server threads!\n", ctx->pipe_path);
+            (void) SetEvent(ctx->stop_event);
+            ret = 1;
+            break;
+        }
+
+        ctx->instances[instance_index].thread_handle = (HANDLE) thread_handle;
+        ++started_threads_count;
+    }
+
+    if (ret == 0)
+    {
+        (void) wprintf_s(L"# Serving on %s with %u pipe instances\n", ctx->pipe_path, ctx->instances_count);
+        (void) fflush(stdout);
+    }
+
+    (void) WaitForSingleObject(ctx->stop_event, INFINITE);
+
+    for (instance_index = 0; instance_index < started_threads_count; ++instance_index)
+    {
+        struct ServeModeInstance* instance = &ctx->instances[instance_index];
+
+        while (WaitForSingleObject(instance->thread_handle, SERVE_MODE_STOP_POLL_INTERVAL_MS) == WAIT_TIMEOUT)
+        {
+            (void) CancelSynchronousIo(instance->thread_handle);
+        }
+
+        (void) CloseHandle(instance->thread_handle);
+
+        requests_count += instance->requests_count;
+        cache_hits_count += instance->cache_hits_count;
+    }
+
+    if (ret == 0)
+    {
+        (void) wprintf_s(L"# Served %I64u requests, %I64u from the digest cache\n", requests_count, cache_hits_count);
+        (void) fflush(stdout);
+    }
+
+    return ret;
+}
+
+int
+uhashtools_serve_mode_run
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    int ret = 1;
+    struct ServeModeCtx* ctx = NULL;
+    unsigned int instance_index = 0;
+
+    UHASHTOOLS_ASSERT(cli_arguments, L"Internal error: Entered with cli_arguments == NULL!");
+    UHASHTOOLS_ASSERT(uhashtools_cli_arguments_has_serve_pipe_name(cli_arguments),
+                      L"Internal error: Entered serve mode without a pipe name!");
+
+    uhashtools_std_streams_connect();
+
+    ctx = (struct ServeModeCtx*) malloc(sizeof *ctx);
+
+    if (!ctx)
+    {
+        (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+        return 1;
+    }
+
+    (void) memset((void*) ctx, 0, sizeof *ctx);
+
+    (void) wcscpy_s(ctx->pipe_path, FILEPATH_BUFFER_TSIZE, SERVE_MODE_PIPE_PREFIX);
+    (void) wcscat_s(ctx->pipe_path, FILEPATH_BUFFER_TSIZE, cli_arguments->serve_pipe_name);
+
+    ctx->instances_count = uhashtools_serve_mode_get_instances_count();
+    ctx->stop_event = CreateEventW(NULL, TRUE, FALSE, NULL);
+    ctx->digest_cache = uhashtools_digest_cache_create();
+    ctx->instances = (struct ServeModeInstance*) calloc(ctx->instances_count, sizeof *ctx->instances);
+
+    if (!ctx->stop_event || !ctx->digest_cache || !ctx->instances)
+    {
+        (void) fwprintf_s(stderr, L"Failed to allocate the required memory. Please download more RAM!\n");
+
+        goto cleanup_and_out;
+    }
+
+    if (!uhashtools_serve_mode_create_instances(ctx))
+    {
+        goto cleanup_and_out;
+    }
+
+    ret = uhashtools_serve_mode_serve(ctx);
+
+cleanup_and_out:
+    for (instance_index = 0; ctx->instances && instance_index < ctx->instances_count; ++instance_index)
+    {
+        if (ctx->instances[instance_index].pipe_handle && ctx->instances[instance_index].pipe_handle != INVALID_HANDLE_VALUE)
+        {
+            (void) CloseHandle(ctx->instances[instance_index].pipe_handle);
+        }
+
+        uhashtools_hash_calculator_impl_destroy_hasher(ctx->instances[instance_index].prepared_hasher);
+        free((void*) ctx->instances[instance_index].file_read_buf);
+    }
+
+    if (ctx->stop_event)
+    {
+        (void) CloseHandle(ctx->stop_event);
+    }
+
+    uhashtools_digest_cache_destroy(ctx->digest_cache);
+    free((void*) ctx->instances);
+    free((void*) ctx);
+
+    return ret;
+}
@@ -0,0 +1,71 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "cli_arguments.h"
+
+/*
+ * The serve mode "--serve <pipe name>" keeps running without creating a
+ * window and hashes files for other processes on the same machine, so
+ * tools which need many digests don't pay the process start for every
+ * file. The digests are kept in a digest cache (see "digest_cache.h"),
+ * so asking again for an unchanged file doesn't read it again.
+ * 
+ * The requests are served over the named pipe "\\.\pipe\<pipe name>"
+ * in message mode. Several pipe instances are served by their own
+ * threads, so multiple clients are served at the same time. A client
+ * can send any amount of requests over its connection, every request
+ * is answered by exactly one response. All messages start with a
+ * header of SERVE_MODE_MESSAGE_HEADER_SIZE bytes:
+ * 
+ *   Request:  <type> 0 0 0 <payload>
+ *   Response: <status> <flags> <digest size> 0 <payload>
+ * 
+ * Request types:
+ * 
+ *   SERVE_MODE_REQUEST_HASH_FILE: The payload is the path of the file
+ *   in UTF-16LE without a terminator. Only regular files are hashed,
+ *   "-", named pipes and other devices are answered with an error.
+ *   SERVE_MODE_REQUEST_STOP: Stops the server after the response. The
+ *   payload is empty.
+ * 
+ * The payload of a response with SERVE_MODE_RESPONSE_OK is the raw
+ * digest of the file (or nothing for a stop request). The flag
+ * SERVE_MODE_RESPONSE_FLAG_CACHED is set if the digest has been taken
+ * from the digest cache. The payload of a response with
+ * SERVE_MODE_RESPONSE_FAILED is the user error message in UTF-16LE
+ * without a terminator.
+ */
+
+#define SERVE_MODE_PIPE_PREFIX L"\\\\.\\pipe\\"
+
+#define SERVE_MODE_MESSAGE_HEADER_SIZE 4
+
+#define SERVE_MODE_REQUEST_HASH_FILE 1
+#define SERVE_MODE_REQUEST_STOP 2
+
+#define SERVE_MODE_RESPONSE_OK 0
+#define SERVE_MODE_RESPONSE_FAILED 1
+
+#define SERVE_MODE_RESPONSE_FLAG_CACHED 0x01
+
+/**
+ * Runs the serve mode until a stop request has been received.
+ * 
+ * @param cli_arguments Command line arguments with a set pipe name.
+ * 
+ * @return Exit code of the process. Zero if the server has been stopped
+ *         by a stop request else one.
+ */
+extern
+int
+uhashtools_serve_mode_run
+(
+    const struct CliArguments* cli_arguments
+);
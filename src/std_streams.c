@@ -0,0 +1,42 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "std_streams.h"
+
+#include <fcntl.h>
+#include <io.h>
+#include <Windows.h>
+
+#include <stdio.h>
+
+void
+uhashtools_std_streams_connect
+(
+    void
+)
+{
+    FILE* reopened_stream = NULL;
+    HANDLE stdout_handle = GetStdHandle(STD_OUTPUT_HANDLE);
+
+    if ((stdout_handle == NULL || stdout_handle == INVALID_HANDLE_VALUE) &&
+        AttachConsole(ATTACH_PARENT_PROCESS))
+    {
+        (void) freopen_s(&reopened_stream, "CONOUT$", "w", stdout);
+        (void) freopen_s(&reopened_stream, "CONOUT$", "w", stderr);
+    }
+
+    if (_fileno(stdout) >= 0)
+    {
+        (void) _setmode(_fileno(stdout), GetFileType(GetStdHandle(STD_OUTPUT_HANDLE)) == FILE_TYPE_CHAR ? _O_U16TEXT : _O_U8TEXT);
+    }
+
+    if (_fileno(stderr) >= 0)
+    {
+        (void) _setmode(_fileno(stderr), _O_U16TEXT);
+    }
+}
@@ -0,0 +1,27 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/**
+ * Prepares stdout and stderr for the window-less modes (see
+ * "archive_mode.h" and "dedup_mode.h").
+ * 
+ * Applications of the Windows subsystem aren't connected to the
+ * console they have been started from. If the output hasn't been
+ * redirected into a file or a pipe this function attaches to the
+ * console of the parent process, so the results are visible in the
+ * CMD window. Both streams are switched to a Unicode mode, because
+ * the printed filepaths can contain any Unicode character.
+ */
+extern
+void
+uhashtools_std_streams_connect
+(
+    void
+);
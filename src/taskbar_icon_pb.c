@@ -123,4 +123,32 @@ uhashtools_taskbar_icon_progress_bar_on_work_progress
     own_state->current_progress_in_percent = progress_in_percent;
 }
 
+void
+uhashtools_taskbar_icon_progress_bar_on_indeterminate_work_progress
+(
+    struct TaskbarIconProgressBarCtx* own_state,
+    struct TaskbarListComApi* taskbar_list_com_api
+)
+{
+    BOOL set_progress_view_success = FALSE;
+
+    UHASHTOOLS_ASSERT(own_state, L"Internal error: Entered with own_state == NULL!");
+    UHASHTOOLS_ASSERT(taskbar_list_com_api, L"Internal error: Entered with taskbar_list_com_api == NULL!");
+
+    if (own_state->current_progress_view_mode == PROGRESS_VIEW_MODE_INDETERMINATE_PROGRESS)
+    {
+        return;
+    }
+
+    set_progress_view_success = uhashtools_taskbar_list_com_api_set_progress_view_mode(taskbar_list_com_api,
+                                                                                       PROGRESS_VIEW_MODE_INDETERMINATE_PROGRESS);
+
+    if (!set_progress_view_success)
+    {
+        return;
+    }
+
+    own_state->current_progress_view_mode = PROGRESS_VIEW_MODE_INDETERMINATE_PROGRESS;
+}
+
 #endif
@@ -50,4 +50,20 @@ uhashtools_taskbar_icon_progress_bar_on_work_progress
     unsigned int progress_in_percent
 );
 
+/**
+ * Event reactor function to react on progress of an operation whose
+ * total amount of work isn't known (for example hashing a pipe). The
+ * taskbar icon shows an indeterminate progress in this case.
+ * 
+ * @param own_state State of this object instance. Must not be NULL.
+ * @param taskbar_list_com_api Initialized taskbar COM api instance. See taskbarlist_com_api.h for details. Must not be NULL.
+ */
+extern
+void
+uhashtools_taskbar_icon_progress_bar_on_indeterminate_work_progress
+(
+    struct TaskbarIconProgressBarCtx* own_state,
+    struct TaskbarListComApi* taskbar_list_com_api
+);
+
 #endif
@@ -30,6 +30,7 @@ uhashtools_taskbar_progress_flags_from_pvm
     {
         case PROGRESS_VIEW_MODE_NONE: return TBPF_NOPROGRESS;
         case PROGRESS_VIEW_MODE_NORMAL_PROGRESS: return TBPF_NORMAL;
+        case PROGRESS_VIEW_MODE_INDETERMINATE_PROGRESS: return TBPF_INDETERMINATE;
         case PROGRESS_VIEW_MODE_ERROR_PROGRESS: return TBPF_ERROR;
         default: return TBPF_NOPROGRESS;
     }
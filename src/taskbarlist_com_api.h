@@ -19,6 +19,7 @@ enum ProgressViewMode
 {
     PROGRESS_VIEW_MODE_NONE,
     PROGRESS_VIEW_MODE_NORMAL_PROGRESS,
+    PROGRESS_VIEW_MODE_INDETERMINATE_PROGRESS,
     PROGRESS_VIEW_MODE_ERROR_PROGRESS
 };
 
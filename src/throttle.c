@@ -0,0 +1,174 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "throttle.h"
+
+#include "error_utilities.h"
+#include "print_utilities.h"
+
+#include <string.h>
+
+struct ThrottleCtx
+{
+    /* Set once by "uhashtools_throttle_start()". Nothing is ever destroyed. */
+    BOOL is_initialized;
+
+    /* Pacing of the reads. Zero "max_bytes_per_second" means no limit. */
+    unsigned __int64 max_bytes_per_second;
+    LONGLONG counter_frequency;
+    LONGLONG burst_tolerance_ticks;
+    CRITICAL_SECTION pacing_lock;
+
+    /* Counter value at which the reads which have been charged so far are allowed. */
+    LONGLONG next_read_tick;
+
+    BOOL use_background_mode;
+
+    /* Limits the files which are hashed at the same time. NULL means no limit. */
+    HANDLE thread_slots_semaphore;
+};
+
+static struct ThrottleCtx g_throttle_ctx;
+
+void
+uhashtools_throttle_start
+(
+    unsigned __int64 max_bytes_per_second,
+    BOOL use_background_mode,
+    unsigned int max_hashing_threads
+)
+{
+    struct ThrottleCtx* ctx = &g_throttle_ctx;
+    LARGE_INTEGER counter_frequency;
+
+    UHASHTOOLS_ASSERT(!ctx->is_initialized, L"Internal error: The throttle has already been started!");
+
+    if (max_bytes_per_second > 0)
+    {
+        /* Never fails on Windows XP and newer. */
+        (void) QueryPerformanceFrequency(&counter_frequency);
+
+        ctx->max_bytes_per_second = max_bytes_per_second;
+        ctx->counter_frequency = counter_frequency.QuadPart;
+        ctx->burst_tolerance_ticks = counter_frequency.QuadPart * THROTTLE_BURST_TOLERANCE_MS / 1000;
+        InitializeCriticalSection(&ctx->pacing_lock);
+
+        UHASHTOOLS_PRINTF_LINE_INFO(L"Throttle: Limiting the reads to %I64u bytes per second.", max_bytes_per_second);
+    }
+
+    ctx->use_background_mode = use_background_mode;
+
+    if (max_hashing_threads > 0)
+    {
+        ctx->thread_slots_semaphore = CreateSemaphoreW(NULL,
+                                                       (LONG) max_hashing_threads,
+                                                       (LONG) max_hashing_threads,
+                                                       NULL);
+
+        UHASHTOOLS_ASSERT(ctx->thread_slots_semaphore, L"Internal error: Failed to create the thread slots semaphore!");
+
+        UHASHTOOLS_PRINTF_LINE_INFO(L"Throttle: Hashing at most %u files at the same time.", max_hashing_threads);
+    }
+
+    ctx->is_initialized = TRUE;
+}
+
+void
+uhashtools_throttle_begin_file
+(
+    struct ThrottleFileState* file_state
+)
+{
+    struct ThrottleCtx* ctx = &g_throttle_ctx;
+
+    UHASHTOOLS_ASSERT(file_state, L"Internal error: Entered with file_state == NULL!");
+
+    (void) memset((void*) file_state, 0, sizeof *file_state);
+
+    if (!ctx->is_initialized)
+    {
+        return;
+    }
+
+    if (ctx->thread_slots_semaphore)
+    {
+        DWORD wait_rc = WaitForSingleObject(ctx->thread_slots_semaphore, INFINITE);
+
+        UHASHTOOLS_ASSERT(wait_rc == WAIT_OBJECT_0, L"Internal error: Failed to wait for a thread slot!");
+
+        file_state->has_thread_slot = TRUE;
+    }
+
+    /* Fails if the thread is already in background mode. Then it's left in it at the end. */
+    if (ctx->use_background_mode)
+    {
+        file_state->is_in_background_mode = SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+    }
+}
+
+void
+uhashtools_throttle_pace_read
+(
+    size_t read_bytes
+)
+{
+    struct ThrottleCtx* ctx = &g_throttle_ctx;
+    LARGE_INTEGER now;
+    LONGLONG read_cost_ticks = 0;
+    LONGLONG wait_ticks = 0;
+
+    if (!ctx->is_initialized || ctx->max_bytes_per_second == 0 || read_bytes == 0)
+    {
+        return;
+    }
+
+    read_cost_ticks = (LONGLONG) ((double) read_bytes * (double) ctx->counter_frequency / (double) ctx->max_bytes_per_second);
+
+    EnterCriticalSection(&ctx->pacing_lock);
+
+    (void) QueryPerformanceCounter(&now);
+
+    /* Time in which nothing has been read can't be saved up for later bursts. */
+    if (ctx->next_read_tick < now.QuadPart)
+    {
+        ctx->next_read_tick = now.QuadPart;
+    }
+
+    ctx->next_read_tick += read_cost_ticks;
+    wait_ticks = ctx->next_read_tick - now.QuadPart - ctx->burst_tolerance_ticks;
+
+    LeaveCriticalSection(&ctx->pacing_lock);
+
+    if (wait_ticks > 0)
+    {
+        Sleep((DWORD) (wait_ticks * 1000 / ctx->counter_frequency) + 1);
+    }
+}
+
+void
+uhashtools_throttle_end_file
+(
+    struct ThrottleFileState* file_state
+)
+{
+    struct ThrottleCtx* ctx = &g_throttle_ctx;
+
+    UHASHTOOLS_ASSERT(file_state, L"Internal error: Entered with file_state == NULL!");
+
+    if (file_state->is_in_background_mode)
+    {
+        (void) SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+        file_state->is_in_background_mode = FALSE;
+    }
+
+    if (file_state->has_thread_slot)
+    {
+        (void) ReleaseSemaphore(ctx->thread_slots_semaphore, 1, NULL);
+        file_state->has_thread_slot = FALSE;
+    }
+}
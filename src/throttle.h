@@ -0,0 +1,102 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Windows.h>
+
+/*
+ * Process wide limits for hashing on machines which are busy with other
+ * work (see the "--throttle", "--background" and "--max-threads" command
+ * line options):
+ * 
+ * - The read data of all hashing threads together is paced to a maximum
+ *   rate. Every read is charged after it completes and the reading thread
+ *   sleeps until the rate allows the read, so the data flows in steps of
+ *   a single read instead of bursts. A debt of up to
+ *   THROTTLE_BURST_TOLERANCE_MS is tolerated to absorb the coarse
+ *   granularity of Sleep().
+ * - The hashing threads can run in background mode, which lowers their
+ *   CPU, I/O and memory priority.
+ * - The amount of files which are hashed at the same time can be capped.
+ * 
+ * The limits are set once at the start of the application. Without a
+ * call of "uhashtools_throttle_start()" nothing is limited.
+ */
+
+#define THROTTLE_BURST_TOLERANCE_MS 100
+
+/**
+ * State of a single file hash between "uhashtools_throttle_begin_file()"
+ * and "uhashtools_throttle_end_file()".
+ */
+struct ThrottleFileState
+{
+    BOOL has_thread_slot;
+    BOOL is_in_background_mode;
+};
+
+/**
+ * Sets the limits. Must be called once before any hashing thread is started.
+ * 
+ * @param max_bytes_per_second Maximum read rate of all hashing threads
+ *                             together or zero for no limit.
+ * @param use_background_mode TRUE if the hashing threads shall run in
+ *                            background mode.
+ * @param max_hashing_threads Maximum amount of files which are hashed at
+ *                            the same time or zero for no limit.
+ */
+extern
+void
+uhashtools_throttle_start
+(
+    unsigned __int64 max_bytes_per_second,
+    BOOL use_background_mode,
+    unsigned int max_hashing_threads
+);
+
+/**
+ * Called by a hashing thread before it starts to read a file. Waits until
+ * the file may be hashed and switches the thread into background mode if
+ * requested.
+ * 
+ * @param file_state Receives the state which has to be passed to
+ *                   "uhashtools_throttle_end_file()".
+ */
+extern
+void
+uhashtools_throttle_begin_file
+(
+    struct ThrottleFileState* file_state
+);
+
+/**
+ * Charges a completed read against the rate limit and sleeps if the read
+ * came too early.
+ * 
+ * @param read_bytes Amount of read bytes.
+ */
+extern
+void
+uhashtools_throttle_pace_read
+(
+    size_t read_bytes
+);
+
+/**
+ * Called by a hashing thread after it has finished a file. Reverts the
+ * changes of "uhashtools_throttle_begin_file()".
+ * 
+ * @param file_state State filled by "uhashtools_throttle_begin_file()".
+ */
+extern
+void
+uhashtools_throttle_end_file
+(
+    struct ThrottleFileState* file_state
+);
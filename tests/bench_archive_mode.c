@@ -0,0 +1,549 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Measures the archive mode against extracting the archive to the disk
+ * and hashing the extracted files afterwards, which is what the users
+ * did before the archive mode existed. The archive is a tar.gz archive
+ * with 128 MiB of compressible data (or the amount of MiB passed as
+ * first argument) in entries of 4 MiB.
+ * 
+ * Both run in a child process like from the command line. The child
+ * reports its peak resident memory, which contains the memory that it
+ * has inherited from the benchmark (printed as baseline). Extracting
+ * additionally needs the size of the archive content on the disk, but
+ * the extracted files are in the disk cache when they are hashed, so
+ * the times are the best case for extracting.
+ * 
+ * Both have to print the same digests. The archive, the extracted files
+ * and the outputs are written next to the benchmark executable and
+ * removed afterwards.
+ */
+
+#include "test_utilities.h"
+
+#include "archive_mode.h"
+#include "archive_reader.h"
+#include "buffer_sizes.h"
+#include "cli_arguments.h"
+#include "hash_calculation_impl.h"
+#include "std_streams.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <wchar.h>
+#include <zlib.h>
+
+#define BENCH_DEFAULT_DATA_SIZE_MIB 128
+#define BENCH_ENTRY_SIZE (1024 * 1024 * 4)
+
+enum BenchPathKind
+{
+    BENCH_PATH_KIND_ARCHIVE,
+    BENCH_PATH_KIND_EXTRACTED,
+    BENCH_PATH_KIND_PEAK,
+    BENCH_PATH_KIND_ARCHIVE_MODE_STDOUT,
+    BENCH_PATH_KIND_EXTRACT_STDOUT,
+    BENCH_PATH_KIND_STDERR,
+    BENCH_PATH_KINDS_COUNT
+};
+
+static char bench_paths[BENCH_PATH_KINDS_COUNT][FILEPATH_BUFFER_TSIZE];
+static unsigned int bench_entries_count = 0;
+
+/* Set by the child which extracts the archive. */
+static double bench_extract_seconds = 0.0;
+
+/* Reads a line like "VmHWM:     1234 kB" of "/proc/self/status" in MiB. */
+static
+double
+uhashtools_bench_get_status_mib
+(
+    const char* field_name
+)
+{
+    FILE* status_file = fopen("/proc/self/status", "r");
+    char line[256];
+    unsigned long value_kib = 0;
+
+    if (!status_file)
+    {
+        return 0.0;
+    }
+
+    while (fgets(line, (int) sizeof line, status_file))
+    {
+        if (strncmp(line, field_name, strlen(field_name)) == 0 &&
+            sscanf(line + strlen(field_name), " %lu", &value_kib) == 1)
+        {
+            break;
+        }
+    }
+
+    (void) fclose(status_file);
+
+    return (double) value_kib / 1024.0;
+}
+
+/* Writes the peak resident memory and the extraction time of the child for the benchmark. */
+static
+void
+uhashtools_bench_write_peak
+(
+    void
+)
+{
+    FILE* peak_file = fopen(bench_paths[BENCH_PATH_KIND_PEAK], "w");
+
+    if (peak_file)
+    {
+        (void) fprintf(peak_file, "%f %f\n", uhashtools_bench_get_status_mib("VmHWM:"), bench_extract_seconds);
+        (void) fclose(peak_file);
+    }
+}
+
+static
+double
+uhashtools_bench_read_peak
+(
+    double* extract_seconds
+)
+{
+    FILE* peak_file = fopen(bench_paths[BENCH_PATH_KIND_PEAK], "r");
+    double peak_mib = 0.0;
+
+    *extract_seconds = 0.0;
+
+    if (peak_file)
+    {
+        if (fscanf(peak_file, "%lf %lf", &peak_mib, extract_seconds) != 2)
+        {
+            peak_mib = 0.0;
+        }
+
+        (void) fclose(peak_file);
+    }
+
+    (void) remove(bench_paths[BENCH_PATH_KIND_PEAK]);
+
+    return peak_mib;
+}
+
+static
+void
+uhashtools_bench_get_extracted_path
+(
+    char* path,
+    unsigned int entry_index
+)
+{
+    (void) sprintf(path, "%.*s_%03u", (int) (FILEPATH_BUFFER_TSIZE - 16), bench_paths[BENCH_PATH_KIND_EXTRACTED], entry_index);
+}
+
+static
+void
+uhashtools_bench_tar_set_octal
+(
+    unsigned char* field,
+    size_t field_size,
+    unsigned __int64 value
+)
+{
+    size_t i = field_size - 1;
+
+    field[i] = '\0';
+
+    while (i > 0)
+    {
+        field[--i] = (unsigned char) ('0' + (value & 7));
+        value >>= 3;
+    }
+}
+
+static
+BOOL
+uhashtools_bench_write_tar_header
+(
+    gzFile archive_file,
+    const char* name,
+    size_t size
+)
+{
+    unsigned char header[512];
+    unsigned int checksum = 0;
+    size_t i = 0;
+
+    (void) memset((void*) header, 0, sizeof header);
+    (void) memcpy((void*) header, (const void*) name, strlen(name));
+
+    uhashtools_bench_tar_set_octal(header + 100, 8, 0644);
+    uhashtools_bench_tar_set_octal(header + 108, 8, 1000);
+    uhashtools_bench_tar_set_octal(header + 116, 8, 1000);
+    uhashtools_bench_tar_set_octal(header + 124, 12, size);
+    uhashtools_bench_tar_set_octal(header + 136, 12, 01234567012);
+    header[156] = '0';
+    (void) memcpy((void*) (header + 257), (const void*) "ustar\0" "00", 8);
+
+    /* The checksum is calculated with spaces in its own field. */
+    (void) memset((void*) (header + 148), ' ', 8);
+
+    for (i = 0; i < sizeof header; ++i)
+    {
+        checksum += header[i];
+    }
+
+    uhashtools_bench_tar_set_octal(header + 148, 7, checksum);
+
+    return gzwrite(archive_file, (voidpc) header, (unsigned int) sizeof header) == (int) sizeof header;
+}
+
+/* The entries have a multiple of 512 bytes, so they need no padding. */
+static
+BOOL
+uhashtools_bench_write_archive
+(
+    size_t data_size
+)
+{
+    unsigned char* entry_data = (unsigned char*) malloc(BENCH_ENTRY_SIZE);
+    unsigned char end_blocks[512 * 2];
+    gzFile archive_file = NULL;
+    BOOL is_written = FALSE;
+    unsigned int entry_index = 0;
+
+    UHASHTOOLS_TEST_CHECK(entry_data);
+    if (!entry_data)
+    {
+        return FALSE;
+    }
+
+    archive_file = gzopen(bench_paths[BENCH_PATH_KIND_ARCHIVE], "wb");
+    UHASHTOOLS_TEST_CHECK(archive_file);
+    if (!archive_file)
+    {
+        free((void*) entry_data);
+        return FALSE;
+    }
+
+    is_written = TRUE;
+    bench_entries_count = (unsigned int) (data_size / BENCH_ENTRY_SIZE);
+
+    for (entry_index = 0; entry_index < bench_entries_count && is_written; ++entry_index)
+    {
+        char name[32];
+
+        (void) sprintf(name, "data/file_%03u.bin", entry_index);
+
+        /* Random data with repeated parts compresses to about a half. */
+        uhashtools_test_fill_data(TEST_DATA_KIND_REPEATS, entry_data, BENCH_ENTRY_SIZE);
+
+        is_written = uhashtools_bench_write_tar_header(archive_file, name, BENCH_ENTRY_SIZE) &&
+                     gzwrite(archive_file, (voidpc) entry_data, BENCH_ENTRY_SIZE) == BENCH_ENTRY_SIZE;
+    }
+
+    (void) memset((void*) end_blocks, 0, sizeof end_blocks);
+    is_written = is_written && gzwrite(archive_file, (voidpc) end_blocks, (unsigned int) sizeof end_blocks) == (int) sizeof end_blocks;
+    is_written = gzclose(archive_file) == Z_OK && is_written;
+
+    free((void*) entry_data);
+
+    UHASHTOOLS_TEST_CHECK(is_written);
+
+    return is_written;
+}
+
+static
+int
+uhashtools_bench_run_archive_mode
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    const int exit_code = uhashtools_archive_mode_run(cli_arguments);
+
+    uhashtools_bench_write_peak();
+
+    return exit_code;
+}
+
+/* Extracts every entry of the archive into a file of its own. */
+static
+BOOL
+uhashtools_bench_extract_archive
+(
+    const wchar_t* archive_wpath,
+    unsigned char* file_read_buf,
+    wchar_t (*entry_names)[FILEPATH_BUFFER_TSIZE]
+)
+{
+    wchar_t error_message_buf[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    struct ArchiveReader* archive_reader = uhashtools_archive_reader_open(error_message_buf,
+                                                                         GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                                         archive_wpath);
+    struct ArchiveEntryInfo entry_info;
+    enum ArchiveReaderResult next_entry_rc = ARCHIVE_READER_RESULT_FAILED;
+    unsigned int entry_index = 0;
+    BOOL is_extracted = archive_reader != NULL;
+
+    while (is_extracted &&
+           entry_index < bench_entries_count &&
+           (next_entry_rc = uhashtools_archive_reader_next_entry(archive_reader, &entry_info)) == ARCHIVE_READER_RESULT_OK)
+    {
+        char extracted_path[FILEPATH_BUFFER_TSIZE];
+        FILE* extracted_file = NULL;
+        BOOL reached_eof = FALSE;
+
+        uhashtools_bench_get_extracted_path(extracted_path, entry_index);
+        (void) wcscpy_s(entry_names[entry_index], FILEPATH_BUFFER_TSIZE, entry_info.entry_name);
+
+        extracted_file = fopen(extracted_path, "wb");
+        is_extracted = extracted_file != NULL;
+
+        while (is_extracted && !reached_eof)
+        {
+            size_t read_size = 0;
+
+            is_extracted = uhashtools_archive_reader_read_entry_data(archive_reader,
+                                                                     file_read_buf,
+                                                                     FILE_READ_BUF_TSIZE,
+                                                                     &read_size,
+                                                                     &reached_eof) &&
+                           fwrite((const void*) file_read_buf, 1, read_size, extracted_file) == read_size;
+        }
+
+        if (extracted_file)
+        {
+            is_extracted = fclose(extracted_file) == 0 && is_extracted;
+        }
+
+        ++entry_index;
+    }
+
+    is_extracted = is_extracted && entry_index == bench_entries_count &&
+                   uhashtools_archive_reader_next_entry(archive_reader, &entry_info) == ARCHIVE_READER_RESULT_END;
+
+    uhashtools_archive_reader_close(archive_reader);
+
+    return is_extracted;
+}
+
+/* Extracts the archive first and hashes the extracted files afterwards. */
+static
+int
+uhashtools_bench_run_extract_then_hash
+(
+    const struct CliArguments* cli_arguments
+)
+{
+    unsigned char* file_read_buf = (unsigned char*) malloc(FILE_READ_BUF_TSIZE);
+    wchar_t (*entry_names)[FILEPATH_BUFFER_TSIZE] = (wchar_t (*)[FILEPATH_BUFFER_TSIZE]) calloc(bench_entries_count, sizeof *entry_names);
+    wchar_t result_string_buf[HASH_RESULT_BUFFER_TSIZE];
+    BOOL all_entries_hashed = FALSE;
+    double start_seconds = 0.0;
+    unsigned int entry_index = 0;
+
+    uhashtools_std_streams_connect();
+
+    if (!file_read_buf || !entry_names)
+    {
+        free((void*) entry_names);
+        free((void*) file_read_buf);
+
+        return 1;
+    }
+
+    start_seconds = uhashtools_test_get_seconds();
+    all_entries_hashed = uhashtools_bench_extract_archive(cli_arguments->archive_file, file_read_buf, entry_names);
+    bench_extract_seconds = uhashtools_test_get_seconds() - start_seconds;
+
+    for (entry_index = 0; entry_index < bench_entries_count && all_entries_hashed; ++entry_index)
+    {
+        char extracted_path[FILEPATH_BUFFER_TSIZE];
+        wchar_t extracted_wpath[FILEPATH_BUFFER_TSIZE];
+
+        uhashtools_bench_get_extracted_path(extracted_path, entry_index);
+        (void) mbstowcs(extracted_wpath, extracted_path, FILEPATH_BUFFER_TSIZE);
+
+        all_entries_hashed = uhashtools_hash_calculator_impl_hash_file(file_read_buf,
+                                                                       FILE_READ_BUF_TSIZE,
+                                                                       result_string_buf,
+                                                                       HASH_RESULT_BUFFER_TSIZE,
+                                                                       extracted_wpath,
+                                                                       NULL,
+                                                                       NULL,
+                                                                       NULL,
+                                                                       NULL) == HashCalculatorResultCode_SUCCESS;
+
+        if (all_entries_hashed)
+        {
+            (void) wprintf_s(L"%s *%s\n", result_string_buf, entry_names[entry_index]);
+        }
+    }
+
+    (void) fflush(stdout);
+
+    /* Removing the extracted files isn't part of the measurement. */
+    uhashtools_bench_write_peak();
+
+    for (entry_index = 0; entry_index < bench_entries_count; ++entry_index)
+    {
+        char extracted_path[FILEPATH_BUFFER_TSIZE];
+
+        uhashtools_bench_get_extracted_path(extracted_path, entry_index);
+        (void) remove(extracted_path);
+    }
+
+    free((void*) entry_names);
+    free((void*) file_read_buf);
+
+    return all_entries_hashed ? 0 : 1;
+}
+
+/* Compares two output files and returns FALSE if they differ or are empty. */
+static
+BOOL
+uhashtools_bench_is_same_output
+(
+    const char* path_a,
+    const char* path_b
+)
+{
+    FILE* file_a = fopen(path_a, "rb");
+    FILE* file_b = fopen(path_b, "rb");
+    BOOL is_same = file_a != NULL && file_b != NULL;
+    size_t compared_size = 0;
+
+    while (is_same)
+    {
+        const int char_a = fgetc(file_a);
+        const int char_b = fgetc(file_b);
+
+        is_same = char_a == char_b;
+
+        if (char_a == EOF)
+        {
+            break;
+        }
+
+        ++compared_size;
+    }
+
+    if (file_a)
+    {
+        (void) fclose(file_a);
+    }
+
+    if (file_b)
+    {
+        (void) fclose(file_b);
+    }
+
+    return is_same && compared_size > 0;
+}
+
+static
+void
+uhashtools_bench_print_result
+(
+    const char* run_name,
+    size_t data_size,
+    double seconds,
+    double peak_mib
+)
+{
+    (void) printf("%-24s %8.3f s %9.1f MiB/s   peak resident %8.1f MiB\n",
+                  run_name,
+                  seconds,
+                  (double) data_size / seconds / (1024.0 * 1024.0),
+                  peak_mib);
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    static const char* const path_suffixes[BENCH_PATH_KINDS_COUNT] = { ".tar.gz", ".extracted", ".peak", ".out1", ".out2", ".err" };
+    const size_t data_size_mib = argc > 1 ? (size_t) strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_DATA_SIZE_MIB;
+    wchar_t* cli_argv[3];
+    wchar_t archive_wpath[FILEPATH_BUFFER_TSIZE];
+    struct CliArguments cli_arguments;
+    double start_seconds = 0.0;
+    double seconds = 0.0;
+    double extract_seconds = 0.0;
+    double peak_mib = 0.0;
+    size_t data_size = 0;
+    unsigned int i = 0;
+
+    for (i = 0; i < BENCH_PATH_KINDS_COUNT; ++i)
+    {
+        (void) sprintf(bench_paths[i], "%.*s%s", (int) (FILEPATH_BUFFER_TSIZE - 16), argv[0], path_suffixes[i]);
+    }
+
+    (void) mbstowcs(archive_wpath, bench_paths[BENCH_PATH_KIND_ARCHIVE], FILEPATH_BUFFER_TSIZE);
+    (void) memset((void*) &cli_arguments, 0, sizeof cli_arguments);
+
+    cli_argv[0] = (wchar_t*) L"uhashtools";
+    cli_argv[1] = (wchar_t*) L"--archive";
+    cli_argv[2] = archive_wpath;
+    uhashtools_cli_arguments_fill_from_argc_argv(&cli_arguments, 3, cli_argv);
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_cli_arguments_has_archive_file(&cli_arguments));
+    UHASHTOOLS_TEST_CHECK(data_size_mib * 1024 * 1024 >= BENCH_ENTRY_SIZE);
+    if (data_size_mib * 1024 * 1024 < BENCH_ENTRY_SIZE || !uhashtools_bench_write_archive(data_size_mib * 1024 * 1024))
+    {
+        (void) remove(bench_paths[BENCH_PATH_KIND_ARCHIVE]);
+
+        return uhashtools_test_finish("bench_archive_mode");
+    }
+
+    data_size = (size_t) bench_entries_count * BENCH_ENTRY_SIZE;
+
+    (void) printf("%u entries of %u MiB in a tar.gz archive, baseline resident %.1f MiB\n",
+                  bench_entries_count,
+                  (unsigned int) (BENCH_ENTRY_SIZE / (1024 * 1024)),
+                  uhashtools_bench_get_status_mib("VmRSS:"));
+
+    start_seconds = uhashtools_test_get_seconds();
+    UHASHTOOLS_TEST_CHECK(uhashtools_test_run_mode(uhashtools_bench_run_archive_mode,
+                                                   &cli_arguments,
+                                                   bench_paths[BENCH_PATH_KIND_ARCHIVE_MODE_STDOUT],
+                                                   bench_paths[BENCH_PATH_KIND_STDERR]) == 0);
+    seconds = uhashtools_test_get_seconds() - start_seconds;
+    peak_mib = uhashtools_bench_read_peak(&extract_seconds);
+    uhashtools_bench_print_result("Archive mode", data_size, seconds, peak_mib);
+
+    start_seconds = uhashtools_test_get_seconds();
+    UHASHTOOLS_TEST_CHECK(uhashtools_test_run_mode(uhashtools_bench_run_extract_then_hash,
+                                                   &cli_arguments,
+                                                   bench_paths[BENCH_PATH_KIND_EXTRACT_STDOUT],
+                                                   bench_paths[BENCH_PATH_KIND_STDERR]) == 0);
+    seconds = uhashtools_test_get_seconds() - start_seconds;
+
+    peak_mib = uhashtools_bench_read_peak(&extract_seconds);
+    uhashtools_bench_print_result("Extract, then hash", data_size, seconds, peak_mib);
+    (void) printf("%-24s %8.3f s extracting %8.3f s hashing   %8.1f MiB on the disk\n",
+                  "",
+                  extract_seconds,
+                  seconds - extract_seconds,
+                  (double) data_size / (1024.0 * 1024.0));
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_bench_is_same_output(bench_paths[BENCH_PATH_KIND_ARCHIVE_MODE_STDOUT],
+                                                          bench_paths[BENCH_PATH_KIND_EXTRACT_STDOUT]));
+
+    for (i = 0; i < BENCH_PATH_KINDS_COUNT; ++i)
+    {
+        (void) remove(bench_paths[i]);
+    }
+
+    return uhashtools_test_finish("bench_archive_mode");
+}
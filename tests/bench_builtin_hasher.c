@@ -0,0 +1,243 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Measures the built-in hasher of a product for messages of 64 bytes up
+ * to 1 MiB. Every message size hashes 64 MiB of random data in total (or
+ * the amount of MiB passed as first argument), once directly through
+ * the interface of "product.h" and once through the hashing loop of
+ * "hash_calculation_impl.c", which prepares and finishes a hasher per
+ * message like it does per file.
+ * 
+ * The benchmark is built once per product like "test_builtin_hasher.c".
+ * The builds with "UHASHTOOLS_USE_BUILTIN_HASHER" measure the loop which
+ * is bound to the built-in hasher at compile time ("specialized"), the
+ * other builds the loop which chooses between Windows CNG and the
+ * built-in hasher at run time ("generic", see "makefile").
+ * 
+ * On x86 and x64 the cycles per byte are counted with the time stamp
+ * counter. It ticks with the nominal frequency of the processor, so the
+ * numbers are only comparable between runs on the same machine.
+ */
+
+#include "test_utilities.h"
+
+#include "hash_calculation_impl.h"
+#include "product.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#define BENCH_DEFAULT_DATA_SIZE_MIB 64
+
+/* The fastest of several runs is printed, so other processes disturb less. */
+#define BENCH_RUNS_COUNT 3
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BENCH_HAS_CYCLE_COUNTER
+#endif
+
+#ifdef UHASHTOOLS_USE_BUILTIN_HASHER
+#define BENCH_LOOP_NAME "specialized loop"
+#define BENCH_NAME_SUFFIX ""
+#else
+#define BENCH_LOOP_NAME "generic loop"
+#define BENCH_NAME_SUFFIX ", generic"
+#endif
+
+static
+unsigned __int64
+uhashtools_bench_get_cycles
+(
+    void
+)
+{
+#ifdef BENCH_HAS_CYCLE_COUNTER
+    return (unsigned __int64) __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static
+void
+uhashtools_bench_print_result
+(
+    const char* run_name,
+    size_t message_size,
+    size_t data_size,
+    double seconds,
+    unsigned __int64 cycles
+)
+{
+#ifdef BENCH_HAS_CYCLE_COUNTER
+    (void) printf("%-18s %8lu B: %9.1f MiB/s %7.2f cycles/B\n",
+                  run_name,
+                  (unsigned long) message_size,
+                  (double) data_size / seconds / (1024.0 * 1024.0),
+                  (double) cycles / (double) data_size);
+#else
+    (void) cycles;
+
+    (void) printf("%-18s %8lu B: %9.1f MiB/s\n",
+                  run_name,
+                  (unsigned long) message_size,
+                  (double) data_size / seconds / (1024.0 * 1024.0));
+#endif
+}
+
+static
+void
+uhashtools_bench_hasher
+(
+    const unsigned char* data,
+    size_t data_size,
+    size_t message_size,
+    void* hasher_state,
+    unsigned char* digest
+)
+{
+    double best_seconds = 0.0;
+    unsigned __int64 best_cycles = 0;
+    size_t data_offset = 0;
+    unsigned int run_index = 0;
+
+    for (run_index = 0; run_index < BENCH_RUNS_COUNT; ++run_index)
+    {
+        const double start_seconds = uhashtools_test_get_seconds();
+        const unsigned __int64 start_cycles = uhashtools_bench_get_cycles();
+        double seconds = 0.0;
+
+        for (data_offset = 0; data_offset + message_size <= data_size; data_offset += message_size)
+        {
+            uhashtools_product_builtin_hasher_init(hasher_state);
+            uhashtools_product_builtin_hasher_update(hasher_state, data + data_offset, message_size);
+            uhashtools_product_builtin_hasher_finish(hasher_state, digest);
+        }
+
+        seconds = uhashtools_test_get_seconds() - start_seconds;
+
+        if (run_index == 0 || seconds < best_seconds)
+        {
+            best_seconds = seconds;
+            best_cycles = uhashtools_bench_get_cycles() - start_cycles;
+        }
+    }
+
+    uhashtools_bench_print_result("built-in hasher", message_size, data_offset, best_seconds, best_cycles);
+}
+
+static
+void
+uhashtools_bench_loop
+(
+    const unsigned char* data,
+    size_t data_size,
+    size_t message_size,
+    struct HashDigest* result_digest
+)
+{
+    wchar_t error_message_buf[256];
+    double best_seconds = 0.0;
+    unsigned __int64 best_cycles = 0;
+    size_t data_offset = 0;
+    unsigned int run_index = 0;
+
+    for (run_index = 0; run_index < BENCH_RUNS_COUNT; ++run_index)
+    {
+        const double start_seconds = uhashtools_test_get_seconds();
+        const unsigned __int64 start_cycles = uhashtools_bench_get_cycles();
+        double seconds = 0.0;
+
+        for (data_offset = 0; data_offset + message_size <= data_size; data_offset += message_size)
+        {
+            if (!uhashtools_hash_calculator_impl_hash_buffer_to_digest(data + data_offset,
+                                                                       message_size,
+                                                                       result_digest,
+                                                                       error_message_buf,
+                                                                       sizeof error_message_buf / sizeof error_message_buf[0]))
+            {
+                (void) printf("Hashing failed: %ls\n", error_message_buf);
+                UHASHTOOLS_TEST_CHECK(FALSE);
+                return;
+            }
+        }
+
+        seconds = uhashtools_test_get_seconds() - start_seconds;
+
+        if (run_index == 0 || seconds < best_seconds)
+        {
+            best_seconds = seconds;
+            best_cycles = uhashtools_bench_get_cycles() - start_cycles;
+        }
+    }
+
+    uhashtools_bench_print_result(BENCH_LOOP_NAME, message_size, data_offset, best_seconds, best_cycles);
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    static const size_t message_sizes[] = { 64, 1024, 1024 * 16, 1024 * 1024 };
+    const wchar_t* algorithm_name = uhashtools_product_get_mainwin_title() + 1;
+    const size_t data_size_mib = argc > 1 ? (size_t) strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_DATA_SIZE_MIB;
+    const size_t data_size = data_size_mib * 1024 * 1024;
+    unsigned char* data = (unsigned char*) malloc(data_size);
+    void* hasher_state = malloc(uhashtools_product_get_builtin_hasher_state_size());
+    unsigned char hasher_digest[HASH_DIGEST_MAX_SIZE];
+    struct HashDigest loop_digest;
+    char bench_name[64];
+    unsigned int i = 0;
+
+#if defined(_M_X64)
+    (void) sprintf(bench_name, "bench_builtin_hasher (%ls, x64%s)", algorithm_name, BENCH_NAME_SUFFIX);
+#else
+    (void) sprintf(bench_name, "bench_builtin_hasher (%ls%s)", algorithm_name, BENCH_NAME_SUFFIX);
+#endif
+
+    UHASHTOOLS_TEST_CHECK(data);
+    UHASHTOOLS_TEST_CHECK(hasher_state);
+    UHASHTOOLS_TEST_CHECK(uhashtools_product_get_builtin_hasher_digest_size() <= HASH_DIGEST_MAX_SIZE);
+    if (!data || !hasher_state)
+    {
+        free((void*) data);
+        free(hasher_state);
+
+        return uhashtools_test_finish(bench_name);
+    }
+
+    uhashtools_test_fill_data(TEST_DATA_KIND_RANDOM, data, data_size);
+
+    (void) printf("%ls, %lu MiB of random data\n", algorithm_name, (unsigned long) data_size_mib);
+
+    for (i = 0; i < sizeof message_sizes / sizeof message_sizes[0]; ++i)
+    {
+        if (message_sizes[i] > data_size)
+        {
+            break;
+        }
+
+        uhashtools_bench_hasher(data, data_size, message_sizes[i], hasher_state, hasher_digest);
+        uhashtools_bench_loop(data, data_size, message_sizes[i], &loop_digest);
+
+        /* Both have hashed the last message last. */
+        UHASHTOOLS_TEST_CHECK(loop_digest.size == uhashtools_product_get_builtin_hasher_digest_size());
+        UHASHTOOLS_TEST_CHECK(memcmp((const void*) loop_digest.bytes, (const void*) hasher_digest, loop_digest.size) == 0);
+    }
+
+    free(hasher_state);
+    free((void*) data);
+
+    return uhashtools_test_finish(bench_name);
+}
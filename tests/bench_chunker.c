@@ -0,0 +1,222 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Measures the throughput of the chunker and the distribution of the
+ * chunk sizes with 256 MiB of random data (or the amount of MiB passed
+ * as first argument) for several average chunk sizes. The data is fed
+ * in parts of 1 MiB like the read buffer of the chunk mode.
+ * 
+ * Every chunk is hashed by the chunker, so the benchmark is built with
+ * the XXH3 product, whose hasher is fast enough to leave the time to the
+ * boundary scan. On x86_64 it's built a second time with the AVX2
+ * scanner (see "makefile").
+ */
+
+#include "test_utilities.h"
+
+#include "chunker.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_DEFAULT_DATA_SIZE_MIB 256
+#define BENCH_FEED_SIZE (1024 * 1024)
+
+/* Chunk sizes are counted in buckets relative to the average size. */
+#define BENCH_SIZE_BUCKETS_COUNT 6
+
+struct BenchChunkStats
+{
+    size_t average_size;
+    unsigned __int64 chunks_count;
+
+    /* The last chunk of the data is cut by its end, so it's left out of the minimum. */
+    unsigned __int64 min_size;
+    unsigned __int64 last_size;
+    unsigned __int64 max_size;
+    double size_sum;
+    double size_square_sum;
+    unsigned __int64 bucket_counts[BENCH_SIZE_BUCKETS_COUNT];
+};
+
+static
+BOOL
+uhashtools_bench_on_chunk
+(
+    const struct ChunkerChunk* chunk,
+    void* userdata
+)
+{
+    struct BenchChunkStats* stats = (struct BenchChunkStats*) userdata;
+    const double relative_size = (double) chunk->size / (double) stats->average_size;
+    unsigned int bucket_index = 0;
+
+    if (stats->chunks_count == 1 || (stats->chunks_count > 1 && stats->last_size < stats->min_size))
+    {
+        stats->min_size = stats->last_size;
+    }
+
+    stats->last_size = chunk->size;
+
+    if (chunk->size > stats->max_size)
+    {
+        stats->max_size = chunk->size;
+    }
+
+    ++stats->chunks_count;
+    stats->size_sum += (double) chunk->size;
+    stats->size_square_sum += (double) chunk->size * (double) chunk->size;
+
+    /* < 0.5x, < 1x, < 2x, < 4x, < 8x and the maximum size of 8x */
+    if (relative_size >= 8.0)
+    {
+        bucket_index = 5;
+    }
+    else if (relative_size >= 4.0)
+    {
+        bucket_index = 4;
+    }
+    else if (relative_size >= 2.0)
+    {
+        bucket_index = 3;
+    }
+    else if (relative_size >= 1.0)
+    {
+        bucket_index = 2;
+    }
+    else if (relative_size >= 0.5)
+    {
+        bucket_index = 1;
+    }
+
+    ++stats->bucket_counts[bucket_index];
+
+    return TRUE;
+}
+
+static
+void
+uhashtools_bench_chunk
+(
+    const unsigned char* data,
+    size_t data_size,
+    size_t average_size
+)
+{
+    wchar_t error_message_buf[256];
+    struct BenchChunkStats stats;
+    struct Chunker* chunker = NULL;
+    double start_seconds = 0.0;
+    double seconds = 0.0;
+    double mean_size = 0.0;
+    double size_stddev = 0.0;
+    size_t data_offset = 0;
+    unsigned int i = 0;
+
+    (void) memset((void*) &stats, 0, sizeof stats);
+    stats.average_size = average_size;
+
+    chunker = uhashtools_chunker_create(error_message_buf,
+                                        sizeof error_message_buf / sizeof error_message_buf[0],
+                                        average_size,
+                                        uhashtools_bench_on_chunk,
+                                        (void*) &stats);
+
+    UHASHTOOLS_TEST_CHECK(chunker);
+    if (!chunker)
+    {
+        return;
+    }
+
+    start_seconds = uhashtools_test_get_seconds();
+
+    for (data_offset = 0; data_offset < data_size; data_offset += BENCH_FEED_SIZE)
+    {
+        const size_t feed_size = data_size - data_offset < BENCH_FEED_SIZE ? data_size - data_offset : BENCH_FEED_SIZE;
+
+        UHASHTOOLS_TEST_CHECK(uhashtools_chunker_feed(chunker, data + data_offset, feed_size));
+    }
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_chunker_finish(chunker));
+
+    seconds = uhashtools_test_get_seconds() - start_seconds;
+
+    uhashtools_chunker_destroy(chunker);
+
+    UHASHTOOLS_TEST_CHECK(stats.chunks_count > 0);
+    UHASHTOOLS_TEST_CHECK(stats.size_sum == (double) data_size);
+    if (stats.chunks_count == 0)
+    {
+        return;
+    }
+
+    mean_size = stats.size_sum / (double) stats.chunks_count;
+    size_stddev = sqrt(stats.size_square_sum / (double) stats.chunks_count - mean_size * mean_size);
+
+    (void) printf("Average %7lu: %8.1f MiB/s %9lu chunks   mean %9.0f   stddev %9.0f   min %8lu   max %8lu\n",
+                  (unsigned long) average_size,
+                  (double) data_size / seconds / (1024.0 * 1024.0),
+                  (unsigned long) stats.chunks_count,
+                  mean_size,
+                  size_stddev,
+                  (unsigned long) stats.min_size,
+                  (unsigned long) stats.max_size);
+
+    (void) printf("                 ");
+
+    for (i = 0; i < BENCH_SIZE_BUCKETS_COUNT; ++i)
+    {
+        static const char* const bucket_names[BENCH_SIZE_BUCKETS_COUNT] = { "<0.5x", "<1x", "<2x", "<4x", "<8x", "8x" };
+
+        (void) printf(" %5s %5.1f%%", bucket_names[i], (double) stats.bucket_counts[i] * 100.0 / (double) stats.chunks_count);
+    }
+
+    (void) printf("\n");
+
+    /* Normalized chunking keeps the mean near the average size. */
+    UHASHTOOLS_TEST_CHECK(mean_size >= (double) average_size * 0.5 && mean_size <= (double) average_size * 2.0);
+    UHASHTOOLS_TEST_CHECK(stats.min_size >= average_size / 4 || stats.chunks_count == 1);
+    UHASHTOOLS_TEST_CHECK(stats.last_size <= (unsigned __int64) average_size * 8);
+    UHASHTOOLS_TEST_CHECK(stats.max_size <= (unsigned __int64) average_size * 8);
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    static const size_t average_sizes[] = { 1024 * 4, 1024 * 16, 1024 * 64, 1024 * 1024 };
+    const size_t data_size_mib = argc > 1 ? (size_t) strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_DATA_SIZE_MIB;
+    const size_t data_size = data_size_mib * 1024 * 1024;
+    unsigned char* data = (unsigned char*) malloc(data_size);
+    unsigned int i = 0;
+
+    UHASHTOOLS_TEST_CHECK(data);
+    if (!data)
+    {
+        return uhashtools_test_finish("bench_chunker");
+    }
+
+    uhashtools_test_fill_data(TEST_DATA_KIND_RANDOM, data, data_size);
+
+    (void) printf("%lu MiB of random data\n", (unsigned long) data_size_mib);
+
+    for (i = 0; i < sizeof average_sizes / sizeof average_sizes[0]; ++i)
+    {
+        uhashtools_bench_chunk(data, data_size, average_sizes[i]);
+    }
+
+    free((void*) data);
+
+    return uhashtools_test_finish("bench_chunker");
+}
@@ -0,0 +1,316 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Measures building and opening a known set of 2 million SHA-256 digests
+ * (or the amount of digests passed as first argument), the memory which
+ * it takes and the lookups per second of known and of unknown digests.
+ * The known digests are looked up in random order, so most of them miss
+ * the cache. The unknown digests are mostly answered by the Bloom filter.
+ * 
+ * The memory is reported as size of the known set file, which is mapped
+ * as a whole, and as resident memory of the process after opening the
+ * set and after the lookups. The pages of the mapping are loaded only
+ * when they are accessed, so opening takes no time and no memory.
+ * 
+ * The digest list and the known set are written next to the benchmark
+ * executable and removed afterwards.
+ */
+
+#include "test_utilities.h"
+
+#include "buffer_sizes.h"
+#include "known_set.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <wchar.h>
+
+#define BENCH_DEFAULT_DIGESTS_COUNT 2000000
+#define BENCH_DIGEST_SIZE 32
+#define BENCH_LOOKUPS_COUNT 4000000
+
+static char bench_list_path[FILEPATH_BUFFER_TSIZE];
+static char bench_set_path[FILEPATH_BUFFER_TSIZE];
+
+static
+void
+uhashtools_bench_random_digest
+(
+    unsigned char* digest
+)
+{
+    size_t i = 0;
+
+    for (i = 0; i < BENCH_DIGEST_SIZE; ++i)
+    {
+        digest[i] = (unsigned char) uhashtools_test_random();
+    }
+}
+
+/* Resident memory of the process in MiB. */
+static
+double
+uhashtools_bench_get_resident_mib
+(
+    void
+)
+{
+    FILE* statm_file = fopen("/proc/self/statm", "r");
+    unsigned long total_pages = 0;
+    unsigned long resident_pages = 0;
+
+    if (!statm_file)
+    {
+        return 0.0;
+    }
+
+    if (fscanf(statm_file, "%lu %lu", &total_pages, &resident_pages) != 2)
+    {
+        resident_pages = 0;
+    }
+
+    (void) fclose(statm_file);
+
+    return (double) resident_pages * (double) sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+}
+
+static
+double
+uhashtools_bench_get_peak_resident_mib
+(
+    void
+)
+{
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0.0;
+    }
+
+    /* Linux reports the peak in KiB. */
+    return (double) usage.ru_maxrss / 1024.0;
+}
+
+static
+BOOL
+uhashtools_bench_write_digest_list
+(
+    const unsigned char* digests,
+    size_t digests_count
+)
+{
+    static const char hex_digits[] = "0123456789abcdef";
+    FILE* list_file = fopen(bench_list_path, "wb");
+    char line[BENCH_DIGEST_SIZE * 2 + 32];
+    BOOL is_written = FALSE;
+    size_t i = 0;
+    size_t j = 0;
+
+    UHASHTOOLS_TEST_CHECK(list_file);
+    if (!list_file)
+    {
+        return FALSE;
+    }
+
+    for (i = 0; i < digests_count; ++i)
+    {
+        const unsigned char* digest = digests + i * BENCH_DIGEST_SIZE;
+
+        for (j = 0; j < BENCH_DIGEST_SIZE; ++j)
+        {
+            line[j * 2] = hex_digits[digest[j] >> 4];
+            line[j * 2 + 1] = hex_digits[digest[j] & 0x0F];
+        }
+
+        (void) sprintf(line + BENCH_DIGEST_SIZE * 2, "  file_%lu.bin\n", (unsigned long) i);
+        (void) fputs(line, list_file);
+    }
+
+    is_written = !ferror(list_file);
+    is_written = fclose(list_file) == 0 && is_written;
+
+    UHASHTOOLS_TEST_CHECK(is_written);
+
+    return is_written;
+}
+
+/*
+ * Looks up BENCH_LOOKUPS_COUNT digests, which are picked from "digests"
+ * by random indexes, and returns how many of them are known.
+ */
+static
+size_t
+uhashtools_bench_lookup
+(
+    const char* run_name,
+    const struct KnownSet* known_set,
+    const unsigned char* digests,
+    size_t digests_count
+)
+{
+    size_t* indexes = (size_t*) malloc(sizeof(size_t) * BENCH_LOOKUPS_COUNT);
+    size_t found_count = 0;
+    double start_seconds = 0.0;
+    double seconds = 0.0;
+    size_t i = 0;
+
+    UHASHTOOLS_TEST_CHECK(indexes);
+    if (!indexes)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < BENCH_LOOKUPS_COUNT; ++i)
+    {
+        indexes[i] = (((size_t) uhashtools_test_random() << 16) ^ (size_t) uhashtools_test_random()) % digests_count;
+    }
+
+    start_seconds = uhashtools_test_get_seconds();
+
+    for (i = 0; i < BENCH_LOOKUPS_COUNT; ++i)
+    {
+        if (uhashtools_known_set_contains(known_set, digests + indexes[i] * BENCH_DIGEST_SIZE))
+        {
+            ++found_count;
+        }
+    }
+
+    seconds = uhashtools_test_get_seconds() - start_seconds;
+
+    (void) printf("%-24s %8.3f s %12.0f lookups/s   resident %8.1f MiB\n",
+                  run_name,
+                  seconds,
+                  (double) BENCH_LOOKUPS_COUNT / seconds,
+                  uhashtools_bench_get_resident_mib());
+
+    free((void*) indexes);
+
+    return found_count;
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    const size_t digests_count = argc > 1 ? (size_t) strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_DIGESTS_COUNT;
+    unsigned char* digests = (unsigned char*) malloc(digests_count * BENCH_DIGEST_SIZE);
+    unsigned char* unknown_digests = (unsigned char*) malloc(digests_count * BENCH_DIGEST_SIZE);
+    wchar_t list_wpath[FILEPATH_BUFFER_TSIZE];
+    wchar_t set_wpath[FILEPATH_BUFFER_TSIZE];
+    wchar_t error_message_buf[256];
+    struct KnownSet* known_set = NULL;
+    unsigned __int64 added_digests_count = 0;
+    unsigned __int64 skipped_lines_count = 0;
+    double start_seconds = 0.0;
+    FILE* set_file = NULL;
+    long set_file_size = 0;
+    size_t i = 0;
+
+    (void) sprintf(bench_list_path, "%.*s.txt", (int) (FILEPATH_BUFFER_TSIZE - 8), argv[0]);
+    (void) sprintf(bench_set_path, "%.*s.kset", (int) (FILEPATH_BUFFER_TSIZE - 8), argv[0]);
+    (void) mbstowcs(list_wpath, bench_list_path, FILEPATH_BUFFER_TSIZE);
+    (void) mbstowcs(set_wpath, bench_set_path, FILEPATH_BUFFER_TSIZE);
+
+    UHASHTOOLS_TEST_CHECK(digests_count > 0);
+    UHASHTOOLS_TEST_CHECK(digests);
+    UHASHTOOLS_TEST_CHECK(unknown_digests);
+    if (digests_count == 0 || !digests || !unknown_digests)
+    {
+        goto cleanup_and_out;
+    }
+
+    for (i = 0; i < digests_count; ++i)
+    {
+        uhashtools_bench_random_digest(digests + i * BENCH_DIGEST_SIZE);
+        uhashtools_bench_random_digest(unknown_digests + i * BENCH_DIGEST_SIZE);
+    }
+
+    start_seconds = uhashtools_test_get_seconds();
+    if (!uhashtools_bench_write_digest_list(digests, digests_count))
+    {
+        goto cleanup_and_out;
+    }
+    (void) printf("%-24s %8.3f s %12lu digests\n", "Write digest list", uhashtools_test_get_seconds() - start_seconds, (unsigned long) digests_count);
+
+    start_seconds = uhashtools_test_get_seconds();
+    UHASHTOOLS_TEST_CHECK(uhashtools_known_set_build(error_message_buf,
+                                                     sizeof error_message_buf / sizeof error_message_buf[0],
+                                                     list_wpath,
+                                                     set_wpath,
+                                                     BENCH_DIGEST_SIZE,
+                                                     &added_digests_count,
+                                                     &skipped_lines_count));
+    (void) printf("%-24s %8.3f s   peak resident %8.1f MiB\n",
+                  "Build known set",
+                  uhashtools_test_get_seconds() - start_seconds,
+                  uhashtools_bench_get_peak_resident_mib());
+
+    UHASHTOOLS_TEST_CHECK(added_digests_count == digests_count);
+    UHASHTOOLS_TEST_CHECK(skipped_lines_count == 0);
+
+    set_file = fopen(bench_set_path, "rb");
+    UHASHTOOLS_TEST_CHECK(set_file);
+    if (set_file)
+    {
+        if (fseek(set_file, 0, SEEK_END) == 0)
+        {
+            set_file_size = ftell(set_file);
+        }
+
+        (void) fclose(set_file);
+    }
+
+    (void) printf("%-24s %8.1f MiB %10.1f bytes/digest\n",
+                  "Known set file",
+                  (double) set_file_size / (1024.0 * 1024.0),
+                  (double) set_file_size / (double) digests_count);
+
+    start_seconds = uhashtools_test_get_seconds();
+    known_set = uhashtools_known_set_open(error_message_buf,
+                                          sizeof error_message_buf / sizeof error_message_buf[0],
+                                          set_wpath,
+                                          BENCH_DIGEST_SIZE);
+    (void) printf("%-24s %8.6f s   resident %8.1f MiB\n",
+                  "Open known set",
+                  uhashtools_test_get_seconds() - start_seconds,
+                  uhashtools_bench_get_resident_mib());
+
+    UHASHTOOLS_TEST_CHECK(known_set);
+    if (!known_set)
+    {
+        goto cleanup_and_out;
+    }
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_known_set_get_digests_count(known_set) == digests_count);
+
+    /* The first lookups load the pages of the mapping from the disk cache. */
+    UHASHTOOLS_TEST_CHECK(uhashtools_bench_lookup("Lookup known (first)", known_set, digests, digests_count) == BENCH_LOOKUPS_COUNT);
+    UHASHTOOLS_TEST_CHECK(uhashtools_bench_lookup("Lookup known", known_set, digests, digests_count) == BENCH_LOOKUPS_COUNT);
+
+    /* Random 256 bit digests don't collide with the known ones. */
+    UHASHTOOLS_TEST_CHECK(uhashtools_bench_lookup("Lookup unknown", known_set, unknown_digests, digests_count) == 0);
+
+cleanup_and_out:
+    uhashtools_known_set_close(known_set);
+
+    (void) remove(bench_list_path);
+    (void) remove(bench_set_path);
+
+    free((void*) unknown_digests);
+    free((void*) digests);
+
+    return uhashtools_test_finish("bench_known_set");
+}
@@ -0,0 +1,199 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Measures what the log lines cost the thread which writes them. First a
+ * burst of 200k lines is written synchronously and through the writer
+ * thread of the logger. Then 128 MiB of random data (or the amount of
+ * MiB passed as first argument) are hashed with SHA-256 in blocks of
+ * 4 KiB without logging, with a synchronous log line per block and with
+ * a queued log line per block.
+ * 
+ * stderr is redirected into a file next to the benchmark executable,
+ * which is removed afterwards.
+ */
+
+#include "test_utilities.h"
+
+#include "buffer_sizes.h"
+#include "logger.h"
+#include "product.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <wchar.h>
+
+#define BENCH_DEFAULT_DATA_SIZE_MIB 128
+#define BENCH_BLOCK_SIZE (1024 * 4)
+#define BENCH_BURST_LINES_COUNT 200000
+
+enum BenchLogMode
+{
+    BENCH_LOG_MODE_OFF,
+    BENCH_LOG_MODE_SYNCHRONOUS,
+    BENCH_LOG_MODE_QUEUED
+};
+
+static
+void
+uhashtools_bench_burst
+(
+    const char* run_name
+)
+{
+    const double start_seconds = uhashtools_test_get_seconds();
+    double caller_seconds = 0.0;
+    double seconds = 0.0;
+    unsigned int line_index = 0;
+
+    for (line_index = 0; line_index < BENCH_BURST_LINES_COUNT; ++line_index)
+    {
+        uhashtools_logger_write_line(LOGGER_LEVEL_DEBUG, L"Hashed block %u of file \"%s\".", line_index, L"C:\\data\\file.bin");
+    }
+
+    caller_seconds = uhashtools_test_get_seconds() - start_seconds;
+
+    /* Waits until the queued lines are written. */
+    uhashtools_logger_stop();
+
+    seconds = uhashtools_test_get_seconds() - start_seconds;
+
+    (void) printf("%-24s %8.3f s caller %8.3f s total %10.0f lines/s %8.2f us/line\n",
+                  run_name,
+                  caller_seconds,
+                  seconds,
+                  (double) BENCH_BURST_LINES_COUNT / seconds,
+                  caller_seconds * 1000000.0 / (double) BENCH_BURST_LINES_COUNT);
+}
+
+static
+void
+uhashtools_bench_hash
+(
+    const char* run_name,
+    const unsigned char* data,
+    size_t data_size,
+    enum BenchLogMode log_mode,
+    void* hasher_state,
+    unsigned char* digest
+)
+{
+    const double start_seconds = uhashtools_test_get_seconds();
+    double seconds = 0.0;
+    size_t data_offset = 0;
+
+    if (log_mode == BENCH_LOG_MODE_QUEUED)
+    {
+        uhashtools_logger_start();
+    }
+
+    uhashtools_product_builtin_hasher_init(hasher_state);
+
+    for (data_offset = 0; data_offset + BENCH_BLOCK_SIZE <= data_size; data_offset += BENCH_BLOCK_SIZE)
+    {
+        uhashtools_product_builtin_hasher_update(hasher_state, data + data_offset, BENCH_BLOCK_SIZE);
+
+        if (log_mode != BENCH_LOG_MODE_OFF)
+        {
+            uhashtools_logger_write_line(LOGGER_LEVEL_DEBUG, L"Hashed %lu bytes of file \"%s\".", (unsigned long) data_offset, L"C:\\data\\file.bin");
+        }
+    }
+
+    uhashtools_product_builtin_hasher_finish(hasher_state, digest);
+
+    seconds = uhashtools_test_get_seconds() - start_seconds;
+
+    uhashtools_logger_stop();
+
+    (void) printf("%-24s %8.3f s %9.1f MiB/s\n",
+                  run_name,
+                  seconds,
+                  (double) data_offset / seconds / (1024.0 * 1024.0));
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    const size_t data_size_mib = argc > 1 ? (size_t) strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_DATA_SIZE_MIB;
+    const size_t data_size = data_size_mib * 1024 * 1024;
+    unsigned char* data = (unsigned char*) malloc(data_size);
+    void* hasher_state = malloc(uhashtools_product_get_builtin_hasher_state_size());
+    unsigned char digests[3][64];
+    char stderr_path[FILEPATH_BUFFER_TSIZE];
+    int original_stderr_fd = -1;
+    int stderr_file_fd = -1;
+
+    UHASHTOOLS_TEST_CHECK(data);
+    UHASHTOOLS_TEST_CHECK(hasher_state);
+    UHASHTOOLS_TEST_CHECK(uhashtools_product_get_builtin_hasher_digest_size() <= sizeof digests[0]);
+    if (!data || !hasher_state)
+    {
+        free((void*) data);
+        free(hasher_state);
+
+        return uhashtools_test_finish("bench_logger");
+    }
+
+    (void) sprintf(stderr_path, "%.*s.err", (int) (FILEPATH_BUFFER_TSIZE - 8), argv[0]);
+
+    original_stderr_fd = dup(STDERR_FILENO);
+    stderr_file_fd = open(stderr_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    UHASHTOOLS_TEST_CHECK(original_stderr_fd >= 0);
+    UHASHTOOLS_TEST_CHECK(stderr_file_fd >= 0);
+    if (original_stderr_fd < 0 || stderr_file_fd < 0 || dup2(stderr_file_fd, STDERR_FILENO) < 0)
+    {
+        free((void*) data);
+        free(hasher_state);
+
+        return uhashtools_test_finish("bench_logger");
+    }
+
+    (void) close(stderr_file_fd);
+
+    /*
+     * The C runtime of MSVC writes a formatted line with a single write
+     * even to the unbuffered stderr, glibc in many small parts. With a
+     * buffer the writes are like on Windows, because the logger flushes
+     * stderr after every synchronous line and after every batch.
+     */
+    (void) setvbuf(stderr, NULL, _IOFBF, 1024 * 64);
+
+    uhashtools_test_fill_data(TEST_DATA_KIND_RANDOM, data, data_size);
+
+    /* The logger isn't started yet, so the lines are written synchronously. */
+    uhashtools_bench_burst("Burst synchronous");
+
+    uhashtools_logger_start();
+    uhashtools_bench_burst("Burst queued");
+
+    (void) printf("%lu MiB of random data in blocks of %u bytes\n", (unsigned long) data_size_mib, (unsigned int) BENCH_BLOCK_SIZE);
+
+    uhashtools_bench_hash("Hash without logging", data, data_size, BENCH_LOG_MODE_OFF, hasher_state, digests[0]);
+    uhashtools_bench_hash("Hash logging synchronous", data, data_size, BENCH_LOG_MODE_SYNCHRONOUS, hasher_state, digests[1]);
+    uhashtools_bench_hash("Hash logging queued", data, data_size, BENCH_LOG_MODE_QUEUED, hasher_state, digests[2]);
+
+    UHASHTOOLS_TEST_CHECK(memcmp((const void*) digests[0], (const void*) digests[1], uhashtools_product_get_builtin_hasher_digest_size()) == 0);
+    UHASHTOOLS_TEST_CHECK(memcmp((const void*) digests[0], (const void*) digests[2], uhashtools_product_get_builtin_hasher_digest_size()) == 0);
+
+    (void) fflush(stderr);
+    (void) dup2(original_stderr_fd, STDERR_FILENO);
+    (void) close(original_stderr_fd);
+    (void) remove(stderr_path);
+
+    free(hasher_state);
+    free((void*) data);
+
+    return uhashtools_test_finish("bench_logger");
+}
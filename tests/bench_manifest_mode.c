@@ -0,0 +1,326 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Measures writing a manifest of a tree with 20k files of 16 KiB (or the
+ * amount of files passed as first argument) and verifying the tree after
+ * 0.1% of the files have been changed. The files are spread over groups
+ * of 10 directories with 100 files each. The verification hashes only
+ * the changed files, so it should take a small fraction of the time of
+ * writing. Its root digest has to be the one of a manifest which is
+ * written from scratch afterwards.
+ * 
+ * The tree is written next to the benchmark executable and removed
+ * afterwards.
+ */
+
+#define _GNU_SOURCE
+
+#include "test_utilities.h"
+
+#include "buffer_sizes.h"
+#include "cli_arguments.h"
+#include "hash_calculation_impl.h"
+#include "manifest_mode.h"
+
+#include <fcntl.h>
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wchar.h>
+
+#define BENCH_DEFAULT_FILES_COUNT 20000
+#define BENCH_FILE_SIZE (16 * 1024)
+#define BENCH_FILES_PER_DIRECTORY 100
+#define BENCH_DIRECTORIES_PER_GROUP 10
+
+/* One changed file per 1000 files */
+#define BENCH_CHANGED_FILES_DIVISOR 1000
+
+#define BENCH_FIRST_WRITE_TIME 1600000000
+
+enum BenchPathKind
+{
+    BENCH_PATH_KIND_TREE,
+    BENCH_PATH_KIND_MANIFEST,
+    BENCH_PATH_KIND_STDOUT,
+    BENCH_PATH_KIND_STDERR,
+    BENCH_PATH_KINDS_COUNT
+};
+
+static char bench_paths[BENCH_PATH_KINDS_COUNT][FILEPATH_BUFFER_TSIZE];
+
+static
+int
+uhashtools_bench_remove_tree_entry
+(
+    const char* path,
+    const struct stat* entry_stat,
+    int type_flag,
+    struct FTW* ftw_buf
+)
+{
+    (void) entry_stat;
+    (void) type_flag;
+    (void) ftw_buf;
+
+    return remove(path);
+}
+
+static
+void
+uhashtools_bench_get_file_path
+(
+    size_t file_index,
+    char* path_buf
+)
+{
+    const size_t directory_index = file_index / BENCH_FILES_PER_DIRECTORY;
+
+    (void) sprintf(path_buf,
+                   "%s/group_%04lu/directory_%02lu/file_%03lu.bin",
+                   bench_paths[BENCH_PATH_KIND_TREE],
+                   (unsigned long) (directory_index / BENCH_DIRECTORIES_PER_GROUP),
+                   (unsigned long) (directory_index % BENCH_DIRECTORIES_PER_GROUP),
+                   (unsigned long) (file_index % BENCH_FILES_PER_DIRECTORY));
+}
+
+/* Writes random content with the given last write time. */
+static
+void
+uhashtools_bench_write_file
+(
+    const char* path,
+    unsigned char* content_buf,
+    time_t last_write_time
+)
+{
+    struct timespec file_times[2];
+    FILE* handle = fopen(path, "wb");
+
+    UHASHTOOLS_TEST_CHECK(handle);
+    if (!handle)
+    {
+        return;
+    }
+
+    uhashtools_test_fill_data(TEST_DATA_KIND_RANDOM, content_buf, BENCH_FILE_SIZE);
+
+    UHASHTOOLS_TEST_CHECK(fwrite((const void*) content_buf, 1, BENCH_FILE_SIZE, handle) == BENCH_FILE_SIZE);
+    UHASHTOOLS_TEST_CHECK(fclose(handle) == 0);
+
+    file_times[0].tv_sec = last_write_time;
+    file_times[0].tv_nsec = 0;
+    file_times[1] = file_times[0];
+
+    UHASHTOOLS_TEST_CHECK(utimensat(AT_FDCWD, path, file_times, 0) == 0);
+}
+
+static
+void
+uhashtools_bench_make_tree
+(
+    size_t files_count
+)
+{
+    unsigned char* content_buf = (unsigned char*) malloc(BENCH_FILE_SIZE);
+    char path[FILEPATH_BUFFER_TSIZE * 2];
+    size_t file_index = 0;
+
+    UHASHTOOLS_TEST_CHECK(content_buf);
+    if (!content_buf)
+    {
+        return;
+    }
+
+    UHASHTOOLS_TEST_CHECK(mkdir(bench_paths[BENCH_PATH_KIND_TREE], 0755) == 0);
+
+    for (file_index = 0; file_index < files_count; ++file_index)
+    {
+        uhashtools_bench_get_file_path(file_index, path);
+
+        /* Creates the group and the directory with their first file. */
+        if (file_index % (BENCH_FILES_PER_DIRECTORY * BENCH_DIRECTORIES_PER_GROUP) == 0)
+        {
+            *strrchr(path, '/') = '\0';
+            *strrchr(path, '/') = '\0';
+            UHASHTOOLS_TEST_CHECK(mkdir(path, 0755) == 0);
+            uhashtools_bench_get_file_path(file_index, path);
+        }
+
+        if (file_index % BENCH_FILES_PER_DIRECTORY == 0)
+        {
+            *strrchr(path, '/') = '\0';
+            UHASHTOOLS_TEST_CHECK(mkdir(path, 0755) == 0);
+            uhashtools_bench_get_file_path(file_index, path);
+        }
+
+        uhashtools_bench_write_file(path, content_buf, BENCH_FIRST_WRITE_TIME);
+    }
+
+    free((void*) content_buf);
+}
+
+/* Changes every 1000th file, starting in the middle of the first 1000. */
+static
+size_t
+uhashtools_bench_change_files
+(
+    size_t files_count
+)
+{
+    unsigned char* content_buf = (unsigned char*) malloc(BENCH_FILE_SIZE);
+    char path[FILEPATH_BUFFER_TSIZE * 2];
+    size_t changed_files_count = 0;
+    size_t file_index = 0;
+
+    UHASHTOOLS_TEST_CHECK(content_buf);
+    if (!content_buf)
+    {
+        return 0;
+    }
+
+    for (file_index = BENCH_CHANGED_FILES_DIVISOR / 2; file_index < files_count; file_index += BENCH_CHANGED_FILES_DIVISOR)
+    {
+        uhashtools_bench_get_file_path(file_index, path);
+        uhashtools_bench_write_file(path, content_buf, BENCH_FIRST_WRITE_TIME + 1);
+        ++changed_files_count;
+    }
+
+    free((void*) content_buf);
+
+    return changed_files_count;
+}
+
+/*
+ * Runs the mode, prints its duration and summary and returns the root
+ * digest of its last output line.
+ */
+static
+void
+uhashtools_bench_run_mode
+(
+    const char* run_name,
+    const struct CliArguments* cli_arguments,
+    int expected_exit_code,
+    char* root_digest_hex
+)
+{
+    char line[FILEPATH_BUFFER_TSIZE * 2];
+    const double start_seconds = uhashtools_test_get_seconds();
+    const int exit_code = uhashtools_test_run_mode(uhashtools_manifest_mode_run,
+                                                   cli_arguments,
+                                                   bench_paths[BENCH_PATH_KIND_STDOUT],
+                                                   bench_paths[BENCH_PATH_KIND_STDERR]);
+    const double seconds = uhashtools_test_get_seconds() - start_seconds;
+    FILE* output_file = NULL;
+
+    (void) printf("%-28s %8.3f s\n", run_name, seconds);
+
+    UHASHTOOLS_TEST_CHECK(exit_code == expected_exit_code);
+
+    root_digest_hex[0] = '\0';
+    output_file = fopen(bench_paths[BENCH_PATH_KIND_STDOUT], "r");
+    UHASHTOOLS_TEST_CHECK(output_file);
+    if (!output_file)
+    {
+        return;
+    }
+
+    /* Only the summary is printed, the difference lines are skipped. */
+    while (fgets(line, sizeof line, output_file))
+    {
+        /* "root digest" of the written and "Root digest" of the verified manifest */
+        const char* root_digest = strstr(line, "oot digest ");
+
+        if (line[0] == '#')
+        {
+            (void) printf("    %s", line + 2);
+        }
+
+        if (root_digest)
+        {
+            (void) sscanf(root_digest, "oot digest %128s", root_digest_hex);
+        }
+    }
+
+    (void) fclose(output_file);
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    static const char* const path_suffixes[BENCH_PATH_KINDS_COUNT] = { ".tree", ".manifest", ".out", ".err" };
+    const size_t files_count = argc > 1 ? (size_t) strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_FILES_COUNT;
+    wchar_t tree_wpath[FILEPATH_BUFFER_TSIZE];
+    wchar_t manifest_wpath[FILEPATH_BUFFER_TSIZE];
+    struct CliArguments write_cli_arguments;
+    struct CliArguments verify_cli_arguments;
+    char written_root_digest_hex[HASH_DIGEST_MAX_SIZE * 2 + 1];
+    char verified_root_digest_hex[HASH_DIGEST_MAX_SIZE * 2 + 1];
+    char fresh_root_digest_hex[HASH_DIGEST_MAX_SIZE * 2 + 1];
+    wchar_t* cli_argv[4];
+    double start_seconds = 0.0;
+    size_t changed_files_count = 0;
+    unsigned int i = 0;
+
+    for (i = 0; i < BENCH_PATH_KINDS_COUNT; ++i)
+    {
+        (void) sprintf(bench_paths[i], "%.*s%s", (int) (FILEPATH_BUFFER_TSIZE - 16), argv[0], path_suffixes[i]);
+        (void) remove(bench_paths[i]);
+    }
+
+    (void) nftw(bench_paths[BENCH_PATH_KIND_TREE], uhashtools_bench_remove_tree_entry, 16, FTW_DEPTH | FTW_PHYS);
+
+    (void) mbstowcs(tree_wpath, bench_paths[BENCH_PATH_KIND_TREE], FILEPATH_BUFFER_TSIZE);
+    (void) mbstowcs(manifest_wpath, bench_paths[BENCH_PATH_KIND_MANIFEST], FILEPATH_BUFFER_TSIZE);
+
+    cli_argv[0] = L"uhashtools.exe";
+    cli_argv[1] = L"--write-manifest";
+    cli_argv[2] = manifest_wpath;
+    cli_argv[3] = tree_wpath;
+    uhashtools_cli_arguments_fill_from_argc_argv(&write_cli_arguments, 4, cli_argv);
+
+    cli_argv[1] = L"--verify-manifest";
+    uhashtools_cli_arguments_fill_from_argc_argv(&verify_cli_arguments, 4, cli_argv);
+
+    start_seconds = uhashtools_test_get_seconds();
+    uhashtools_bench_make_tree(files_count);
+    (void) printf("%-28s %8.3f s %10lu files\n", "Generate tree", uhashtools_test_get_seconds() - start_seconds, (unsigned long) files_count);
+
+    uhashtools_bench_run_mode("Write manifest", &write_cli_arguments, 0, written_root_digest_hex);
+    uhashtools_bench_run_mode("Verify unchanged tree", &verify_cli_arguments, 0, verified_root_digest_hex);
+    UHASHTOOLS_TEST_CHECK(strcmp(verified_root_digest_hex, written_root_digest_hex) == 0);
+
+    changed_files_count = uhashtools_bench_change_files(files_count);
+    (void) printf("%-28s %10lu files\n", "Changed files", (unsigned long) changed_files_count);
+
+    uhashtools_bench_run_mode("Verify changed tree", &verify_cli_arguments, changed_files_count > 0 ? 1 : 0, verified_root_digest_hex);
+    uhashtools_bench_run_mode("Write manifest again", &write_cli_arguments, 0, fresh_root_digest_hex);
+
+    /* The recalculated root digest has to be the one of the fresh manifest. */
+    UHASHTOOLS_TEST_CHECK(verified_root_digest_hex[0] != '\0');
+    UHASHTOOLS_TEST_CHECK(strcmp(verified_root_digest_hex, fresh_root_digest_hex) == 0);
+    UHASHTOOLS_TEST_CHECK((strcmp(fresh_root_digest_hex, written_root_digest_hex) == 0) == (changed_files_count == 0));
+
+    (void) nftw(bench_paths[BENCH_PATH_KIND_TREE], uhashtools_bench_remove_tree_entry, 16, FTW_DEPTH | FTW_PHYS);
+
+    for (i = 0; i < BENCH_PATH_KINDS_COUNT; ++i)
+    {
+        (void) remove(bench_paths[i]);
+    }
+
+    return uhashtools_test_finish("bench_manifest_mode");
+}
@@ -0,0 +1,125 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Measures appending to a result store and building its views with a
+ * batch of 1M rows (or the amount of rows passed as first argument). The
+ * rows are spread over directories of 100 files, like a big directory
+ * tree which has been dropped onto the main window.
+ */
+
+#include "test_utilities.h"
+
+#include "result_store.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#define BENCH_DEFAULT_ROWS_COUNT 1000000
+#define BENCH_DIGEST_SIZE 32
+
+static
+void
+uhashtools_bench_build_view
+(
+    const struct ResultStore* result_store,
+    const char* view_name,
+    enum ResultStoreColumn sort_column,
+    BOOL is_sort_descending,
+    const wchar_t* filter_txt
+)
+{
+    struct ResultStoreViewSpec view_spec;
+    struct ResultStoreView view;
+    double start_seconds = 0.0;
+    BOOL is_built = FALSE;
+
+    (void) memset((void*) &view_spec, 0, sizeof view_spec);
+    view_spec.sort_column = sort_column;
+    view_spec.is_sort_descending = is_sort_descending;
+    (void) wcscpy_s(view_spec.filter_txt, RESULT_STORE_FILTER_TXT_TSIZE, filter_txt);
+
+    start_seconds = uhashtools_test_get_seconds();
+    is_built = uhashtools_result_store_build_view(result_store,
+                                                  uhashtools_result_store_get_rows_count(result_store),
+                                                  &view_spec,
+                                                  &view);
+    UHASHTOOLS_TEST_CHECK(is_built);
+
+    (void) printf("%-28s %8.3f s %10lu rows\n",
+                  view_name,
+                  uhashtools_test_get_seconds() - start_seconds,
+                  (unsigned long) view.rows_count);
+
+    uhashtools_result_store_view_free(&view);
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    const size_t rows_count = argc > 1 ? (size_t) strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_ROWS_COUNT;
+    struct ResultStore* result_store = uhashtools_result_store_create();
+    struct HashDigest digest;
+    wchar_t filepath[64];
+    double start_seconds = 0.0;
+    size_t row_index = 0;
+    unsigned int byte_index = 0;
+
+    UHASHTOOLS_TEST_CHECK(result_store != NULL);
+
+    digest.size = BENCH_DIGEST_SIZE;
+    start_seconds = uhashtools_test_get_seconds();
+
+    for (row_index = 0; row_index < rows_count; ++row_index)
+    {
+        (void) swprintf(filepath,
+                        sizeof filepath / sizeof filepath[0],
+                        L"C:\\Data\\Directory_%06lu\\File_%08lx.bin",
+                        (unsigned long) (row_index / 100),
+                        (unsigned long) (uhashtools_test_random() % 100000000));
+
+        for (byte_index = 0; byte_index < BENCH_DIGEST_SIZE; ++byte_index)
+        {
+            digest.bytes[byte_index] = (unsigned char) uhashtools_test_random();
+        }
+
+        if (!uhashtools_result_store_append(result_store,
+                                            filepath,
+                                            uhashtools_test_random() % 1000000,
+                                            uhashtools_test_random() % 50 == 0 ? NULL : &digest,
+                                            L"Failed to open the selected file!"))
+        {
+            UHASHTOOLS_TEST_CHECK(!"Appending the row failed.");
+            break;
+        }
+    }
+
+    (void) printf("%-28s %8.3f s %10lu rows\n",
+                  "Append",
+                  uhashtools_test_get_seconds() - start_seconds,
+                  (unsigned long) uhashtools_result_store_get_rows_count(result_store));
+
+    uhashtools_bench_build_view(result_store, "Append order", RESULT_STORE_COLUMN_NONE, FALSE, L"");
+    uhashtools_bench_build_view(result_store, "Sort by filepath", RESULT_STORE_COLUMN_FILEPATH, FALSE, L"");
+    uhashtools_bench_build_view(result_store, "Sort by filepath descending", RESULT_STORE_COLUMN_FILEPATH, TRUE, L"");
+    uhashtools_bench_build_view(result_store, "Sort by file size", RESULT_STORE_COLUMN_FILE_SIZE, FALSE, L"");
+    uhashtools_bench_build_view(result_store, "Sort by digest", RESULT_STORE_COLUMN_DIGEST, FALSE, L"");
+    uhashtools_bench_build_view(result_store, "Filter directory", RESULT_STORE_COLUMN_NONE, FALSE, L"directory_0042");
+    uhashtools_bench_build_view(result_store, "Filter across directories", RESULT_STORE_COLUMN_NONE, FALSE, L"42\\file_0");
+    uhashtools_bench_build_view(result_store, "Filter hex digest", RESULT_STORE_COLUMN_FILEPATH, FALSE, L"c0ffee");
+
+    uhashtools_result_store_destroy(result_store);
+
+    return uhashtools_test_finish("bench_result_store");
+}
@@ -0,0 +1,477 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Load test client of the serve mode. Runs the server in a child process
+ * and sends hash requests for 1024 files of 4 KiB (or the file size in
+ * bytes passed as first argument) from 1, 4 and 16 clients at the same
+ * time. Every client has its own connection and waits for the response
+ * before it sends the next request, like a tool which hashes file after
+ * file. Prints the requests per second and the 50th and 99th percentile
+ * and the maximum of the request latencies.
+ * 
+ * Every client count is measured twice: Once after the last write time
+ * of all files has been changed, so every request hashes its file, and
+ * once again with the same requests, which are all answered from the
+ * digest cache.
+ * 
+ * The files are written next to the benchmark executable and removed
+ * afterwards.
+ */
+
+#define _GNU_SOURCE
+
+#include "test_utilities.h"
+
+#include "buffer_sizes.h"
+#include "cli_arguments.h"
+#include "serve_mode.h"
+
+#include <fcntl.h>
+#include <process.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wchar.h>
+
+#define BENCH_FILES_COUNT 1024
+#define BENCH_DEFAULT_FILE_SIZE (4 * 1024)
+#define BENCH_MAX_CLIENTS_COUNT 16
+
+/* The server needs some time for creating its pipe instances. */
+#define BENCH_CONNECT_TIMEOUT_MS 10000
+#define BENCH_CONNECT_RETRY_INTERVAL_MS 10
+
+#define BENCH_FIRST_WRITE_TIME 1600000000
+
+#define BENCH_REQUEST_BUFFER_SIZE (SERVE_MODE_MESSAGE_HEADER_SIZE + FILEPATH_BUFFER_TSIZE * sizeof(wchar_t))
+#define BENCH_RESPONSE_BUFFER_SIZE (SERVE_MODE_MESSAGE_HEADER_SIZE + GENERIC_TXT_MESSAGES_BUFFER_TSIZE * sizeof(wchar_t))
+
+enum BenchPathKind
+{
+    BENCH_PATH_KIND_FILES,
+    BENCH_PATH_KIND_STDOUT,
+    BENCH_PATH_KIND_STDERR,
+    BENCH_PATH_KINDS_COUNT
+};
+
+struct BenchClientCtx
+{
+    /* Files [first_file_index, first_file_index + requests_count) are requested. */
+    unsigned int first_file_index;
+    unsigned int requests_count;
+    BOOL is_cached_expected;
+
+    /* Latency of every request in seconds */
+    double* latencies;
+
+    BOOL had_errors;
+};
+
+static char bench_paths[BENCH_PATH_KINDS_COUNT][FILEPATH_BUFFER_TSIZE];
+static wchar_t bench_pipe_path[FILEPATH_BUFFER_TSIZE];
+
+static
+void
+uhashtools_bench_get_file_path
+(
+    unsigned int file_index,
+    char* path_buf
+)
+{
+    (void) sprintf(path_buf, "%s/file_%04u.bin", bench_paths[BENCH_PATH_KIND_FILES], file_index);
+}
+
+static
+void
+uhashtools_bench_make_files
+(
+    size_t file_size
+)
+{
+    unsigned char* content_buf = (unsigned char*) malloc(file_size);
+    char path[FILEPATH_BUFFER_TSIZE * 2];
+    unsigned int file_index = 0;
+
+    UHASHTOOLS_TEST_CHECK(content_buf);
+    if (!content_buf)
+    {
+        return;
+    }
+
+    UHASHTOOLS_TEST_CHECK(mkdir(bench_paths[BENCH_PATH_KIND_FILES], 0755) == 0);
+
+    for (file_index = 0; file_index < BENCH_FILES_COUNT; ++file_index)
+    {
+        FILE* handle = NULL;
+
+        uhashtools_bench_get_file_path(file_index, path);
+        handle = fopen(path, "wb");
+
+        UHASHTOOLS_TEST_CHECK(handle);
+        if (!handle)
+        {
+            break;
+        }
+
+        uhashtools_test_fill_data(TEST_DATA_KIND_RANDOM, content_buf, file_size);
+
+        UHASHTOOLS_TEST_CHECK(fwrite((const void*) content_buf, 1, file_size, handle) == file_size);
+        UHASHTOOLS_TEST_CHECK(fclose(handle) == 0);
+    }
+
+    free((void*) content_buf);
+}
+
+/* Changes the last write time of all files, so their cached digests are outdated. */
+static
+void
+uhashtools_bench_touch_files
+(
+    time_t last_write_time
+)
+{
+    char path[FILEPATH_BUFFER_TSIZE * 2];
+    struct timespec file_times[2];
+    unsigned int file_index = 0;
+
+    file_times[0].tv_sec = last_write_time;
+    file_times[0].tv_nsec = 0;
+    file_times[1] = file_times[0];
+
+    for (file_index = 0; file_index < BENCH_FILES_COUNT; ++file_index)
+    {
+        uhashtools_bench_get_file_path(file_index, path);
+        UHASHTOOLS_TEST_CHECK(utimensat(AT_FDCWD, path, file_times, 0) == 0);
+    }
+}
+
+static
+void
+uhashtools_bench_remove_files
+(
+    void
+)
+{
+    char path[FILEPATH_BUFFER_TSIZE * 2];
+    unsigned int file_index = 0;
+
+    for (file_index = 0; file_index < BENCH_FILES_COUNT; ++file_index)
+    {
+        uhashtools_bench_get_file_path(file_index, path);
+        (void) remove(path);
+    }
+
+    (void) rmdir(bench_paths[BENCH_PATH_KIND_FILES]);
+}
+
+/* Connects to the server, which may still be creating its pipe instances. */
+static
+HANDLE
+uhashtools_bench_connect
+(
+    void
+)
+{
+    DWORD pipe_mode = PIPE_READMODE_MESSAGE;
+    unsigned int waited_ms = 0;
+    HANDLE pipe_handle = INVALID_HANDLE_VALUE;
+
+    for (;;)
+    {
+        pipe_handle = CreateFileW(bench_pipe_path,
+                                  GENERIC_READ | GENERIC_WRITE,
+                                  0,
+                                  NULL,
+                                  OPEN_EXISTING,
+                                  0,
+                                  NULL);
+
+        if (pipe_handle != INVALID_HANDLE_VALUE || waited_ms >= BENCH_CONNECT_TIMEOUT_MS)
+        {
+            break;
+        }
+
+        Sleep(BENCH_CONNECT_RETRY_INTERVAL_MS);
+        waited_ms += BENCH_CONNECT_RETRY_INTERVAL_MS;
+    }
+
+    if (pipe_handle != INVALID_HANDLE_VALUE && !SetNamedPipeHandleState(pipe_handle, &pipe_mode, NULL, NULL))
+    {
+        (void) CloseHandle(pipe_handle);
+        pipe_handle = INVALID_HANDLE_VALUE;
+    }
+
+    return pipe_handle;
+}
+
+/*
+ * Sends a request and reads its response.
+ * 
+ * @return Size of the response or zero if the request has failed.
+ */
+static
+DWORD
+uhashtools_bench_send_request
+(
+    HANDLE pipe_handle,
+    const unsigned char* request_buf,
+    DWORD request_size,
+    unsigned char* response_buf
+)
+{
+    DWORD written_bytes = 0;
+    DWORD response_size = 0;
+
+    if (!WriteFile(pipe_handle, (LPCVOID) request_buf, request_size, &written_bytes, NULL) ||
+        written_bytes != request_size ||
+        !ReadFile(pipe_handle, (LPVOID) response_buf, BENCH_RESPONSE_BUFFER_SIZE, &response_size, NULL))
+    {
+        return 0;
+    }
+
+    return response_size;
+}
+
+static
+unsigned int
+__stdcall
+uhashtools_bench_client_thread_function
+(
+    void* thread_param
+)
+{
+    struct BenchClientCtx* ctx = (struct BenchClientCtx*) thread_param;
+    unsigned char request_buf[BENCH_REQUEST_BUFFER_SIZE];
+    unsigned char response_buf[BENCH_RESPONSE_BUFFER_SIZE];
+    char path[FILEPATH_BUFFER_TSIZE * 2];
+    wchar_t wpath[FILEPATH_BUFFER_TSIZE];
+    unsigned int request_index = 0;
+    HANDLE pipe_handle = uhashtools_bench_connect();
+
+    if (pipe_handle == INVALID_HANDLE_VALUE)
+    {
+        ctx->had_errors = TRUE;
+
+        return 0;
+    }
+
+    (void) memset((void*) request_buf, 0, SERVE_MODE_MESSAGE_HEADER_SIZE);
+    request_buf[0] = SERVE_MODE_REQUEST_HASH_FILE;
+
+    for (request_index = 0; request_index < ctx->requests_count; ++request_index)
+    {
+        size_t wpath_tlen = 0;
+        DWORD response_size = 0;
+        double start_seconds = 0.0;
+
+        uhashtools_bench_get_file_path(ctx->first_file_index + request_index, path);
+        wpath_tlen = mbstowcs(wpath, path, FILEPATH_BUFFER_TSIZE);
+        (void) memcpy((void*) (request_buf + SERVE_MODE_MESSAGE_HEADER_SIZE), (const void*) wpath, wpath_tlen * sizeof(wchar_t));
+
+        start_seconds = uhashtools_test_get_seconds();
+        response_size = uhashtools_bench_send_request(pipe_handle,
+                                                      request_buf,
+                                                      (DWORD) (SERVE_MODE_MESSAGE_HEADER_SIZE + wpath_tlen * sizeof(wchar_t)),
+                                                      response_buf);
+        ctx->latencies[request_index] = uhashtools_test_get_seconds() - start_seconds;
+
+        /* The response has to carry the digest and tell whether it has been cached. */
+        if (response_size <= SERVE_MODE_MESSAGE_HEADER_SIZE ||
+            response_buf[0] != SERVE_MODE_RESPONSE_OK ||
+            response_size != SERVE_MODE_MESSAGE_HEADER_SIZE + (DWORD) response_buf[2] ||
+            ((response_buf[1] & SERVE_MODE_RESPONSE_FLAG_CACHED) != 0) != ctx->is_cached_expected)
+        {
+            ctx->had_errors = TRUE;
+            break;
+        }
+    }
+
+    (void) CloseHandle(pipe_handle);
+
+    return 0;
+}
+
+static
+int
+uhashtools_bench_compare_latencies
+(
+    const void* lhs,
+    const void* rhs
+)
+{
+    const double lhs_latency = *(const double*) lhs;
+    const double rhs_latency = *(const double*) rhs;
+
+    return lhs_latency < rhs_latency ? -1 : lhs_latency > rhs_latency ? 1 : 0;
+}
+
+/* Requests all files, split evenly between the clients. */
+static
+void
+uhashtools_bench_run_clients
+(
+    const char* run_name,
+    unsigned int clients_count,
+    BOOL is_cached_expected
+)
+{
+    const unsigned int requests_per_client = BENCH_FILES_COUNT / clients_count;
+    const unsigned int requests_count = requests_per_client * clients_count;
+    struct BenchClientCtx client_ctxs[BENCH_MAX_CLIENTS_COUNT];
+    HANDLE thread_handles[BENCH_MAX_CLIENTS_COUNT];
+    double* latencies = (double*) malloc(requests_count * sizeof(double));
+    double start_seconds = 0.0;
+    double seconds = 0.0;
+    unsigned int client_index = 0;
+
+    UHASHTOOLS_TEST_CHECK(latencies);
+    if (!latencies)
+    {
+        return;
+    }
+
+    start_seconds = uhashtools_test_get_seconds();
+
+    for (client_index = 0; client_index < clients_count; ++client_index)
+    {
+        unsigned int thread_id = 0;
+        struct BenchClientCtx* client_ctx = &client_ctxs[client_index];
+
+        (void) memset((void*) client_ctx, 0, sizeof *client_ctx);
+        client_ctx->first_file_index = client_index * requests_per_client;
+        client_ctx->requests_count = requests_per_client;
+        client_ctx->is_cached_expected = is_cached_expected;
+        client_ctx->latencies = latencies + client_index * requests_per_client;
+
+        thread_handles[client_index] = (HANDLE) _beginthreadex(NULL,
+                                                               0,
+                                                               uhashtools_bench_client_thread_function,
+                                                               (void*) client_ctx,
+                                                               0,
+                                                               &thread_id);
+
+        UHASHTOOLS_TEST_CHECK(thread_handles[client_index]);
+        if (!thread_handles[client_index])
+        {
+            exit(uhashtools_test_finish("bench_serve_mode"));
+        }
+    }
+
+    for (client_index = 0; client_index < clients_count; ++client_index)
+    {
+        UHASHTOOLS_TEST_CHECK(WaitForSingleObject(thread_handles[client_index], INFINITE) == WAIT_OBJECT_0);
+        (void) CloseHandle(thread_handles[client_index]);
+        UHASHTOOLS_TEST_CHECK(!client_ctxs[client_index].had_errors);
+    }
+
+    seconds = uhashtools_test_get_seconds() - start_seconds;
+
+    qsort((void*) latencies, requests_count, sizeof(double), uhashtools_bench_compare_latencies);
+
+    (void) printf("%-10s %2u client(s) %10.0f requests/s   p50 %8.1f us   p99 %8.1f us   max %8.1f us\n",
+                  run_name,
+                  clients_count,
+                  (double) requests_count / seconds,
+                  latencies[requests_count / 2] * 1e6,
+                  latencies[requests_count * 99 / 100] * 1e6,
+                  latencies[requests_count - 1] * 1e6);
+
+    free((void*) latencies);
+}
+
+static
+void
+uhashtools_bench_stop_server
+(
+    void
+)
+{
+    unsigned char request_buf[SERVE_MODE_MESSAGE_HEADER_SIZE];
+    unsigned char response_buf[BENCH_RESPONSE_BUFFER_SIZE];
+    HANDLE pipe_handle = uhashtools_bench_connect();
+
+    UHASHTOOLS_TEST_CHECK(pipe_handle != INVALID_HANDLE_VALUE);
+    if (pipe_handle == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    (void) memset((void*) request_buf, 0, sizeof request_buf);
+    request_buf[0] = SERVE_MODE_REQUEST_STOP;
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_bench_send_request(pipe_handle, request_buf, sizeof request_buf, response_buf) == SERVE_MODE_MESSAGE_HEADER_SIZE);
+    UHASHTOOLS_TEST_CHECK(response_buf[0] == SERVE_MODE_RESPONSE_OK);
+
+    (void) CloseHandle(pipe_handle);
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    static const char* const path_suffixes[BENCH_PATH_KINDS_COUNT] = { ".files", ".out", ".err" };
+    static const unsigned int clients_counts[] = { 1, 4, BENCH_MAX_CLIENTS_COUNT };
+    const size_t file_size = argc > 1 ? (size_t) strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_FILE_SIZE;
+    wchar_t pipe_name[64];
+    struct CliArguments cli_arguments;
+    wchar_t* cli_argv[3];
+    int server_process_id = -1;
+    unsigned int i = 0;
+
+    for (i = 0; i < BENCH_PATH_KINDS_COUNT; ++i)
+    {
+        (void) sprintf(bench_paths[i], "%.*s%s", (int) (FILEPATH_BUFFER_TSIZE - 16), argv[0], path_suffixes[i]);
+        (void) remove(bench_paths[i]);
+    }
+
+    uhashtools_bench_remove_files();
+    uhashtools_bench_make_files(file_size);
+    (void) printf("%u files of %lu bytes\n", BENCH_FILES_COUNT, (unsigned long) file_size);
+
+    /* The pipe name is unique, so the benchmark can run next to other ones. */
+    (void) swprintf(pipe_name, sizeof pipe_name / sizeof pipe_name[0], L"uhashtools-bench-%ld", (long) getpid());
+    (void) swprintf(bench_pipe_path, FILEPATH_BUFFER_TSIZE, L"%ls%ls", SERVE_MODE_PIPE_PREFIX, pipe_name);
+
+    cli_argv[0] = L"uhashtools.exe";
+    cli_argv[1] = L"--serve";
+    cli_argv[2] = pipe_name;
+    uhashtools_cli_arguments_fill_from_argc_argv(&cli_arguments, 3, cli_argv);
+
+    server_process_id = uhashtools_test_start_mode(uhashtools_serve_mode_run,
+                                                   &cli_arguments,
+                                                   bench_paths[BENCH_PATH_KIND_STDOUT],
+                                                   bench_paths[BENCH_PATH_KIND_STDERR]);
+
+    if (server_process_id > 0)
+    {
+        for (i = 0; i < sizeof clients_counts / sizeof clients_counts[0]; ++i)
+        {
+            uhashtools_bench_touch_files((time_t) (BENCH_FIRST_WRITE_TIME + i));
+            uhashtools_bench_run_clients("Uncached", clients_counts[i], FALSE);
+            uhashtools_bench_run_clients("Cached", clients_counts[i], TRUE);
+        }
+
+        uhashtools_bench_stop_server();
+        UHASHTOOLS_TEST_CHECK(uhashtools_test_wait_mode(server_process_id) == 0);
+    }
+
+    uhashtools_bench_remove_files();
+
+    for (i = 0; i < BENCH_PATH_KINDS_COUNT; ++i)
+    {
+        (void) remove(bench_paths[i]);
+    }
+
+    return uhashtools_test_finish("bench_serve_mode");
+}
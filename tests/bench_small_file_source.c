@@ -0,0 +1,158 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Measures hashing small files of 1 byte up to 64 KiB, which are taken
+ * by the fast path of "hash_calculation_impl.c". Every size is hashed
+ * 20000 times (or the amount of times passed as first argument) with
+ * the read buffer of the worker. The time per file contains opening,
+ * reading and closing the file, which is in the disk cache after the
+ * first time. From a few KiB on the time is mostly taken by the hasher.
+ * 
+ * For comparison every size is hashed as well with a read buffer which
+ * is one byte smaller than the file, so the file is taken by the regular
+ * loop and read twice.
+ * 
+ * The test file is written next to the benchmark executable and removed
+ * afterwards.
+ */
+
+#include "test_utilities.h"
+
+#include "buffer_sizes.h"
+#include "hash_calculation_impl.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#define BENCH_DEFAULT_FILES_COUNT 20000
+#define BENCH_MAX_FILE_SIZE (1024 * 64)
+
+/* The fastest of several runs is printed, so other processes disturb less. */
+#define BENCH_RUNS_COUNT 3
+
+static
+void
+uhashtools_bench_hash_files
+(
+    const char* run_name,
+    const wchar_t* file_wpath,
+    size_t file_size,
+    unsigned char* file_read_buf,
+    size_t file_read_buf_size,
+    unsigned int files_count
+)
+{
+    wchar_t error_message_buf[256];
+    struct HashDigest file_digest;
+    double seconds = 0.0;
+    unsigned int file_index = 0;
+    unsigned int run_index = 0;
+
+    for (run_index = 0; run_index < BENCH_RUNS_COUNT; ++run_index)
+    {
+        const double start_seconds = uhashtools_test_get_seconds();
+        double run_seconds = 0.0;
+
+        for (file_index = 0; file_index < files_count; ++file_index)
+        {
+            if (uhashtools_hash_calculator_impl_hash_file_to_digest(file_read_buf,
+                                                                    file_read_buf_size,
+                                                                    &file_digest,
+                                                                    error_message_buf,
+                                                                    sizeof error_message_buf / sizeof error_message_buf[0],
+                                                                    file_wpath,
+                                                                    NULL,
+                                                                    NULL,
+                                                                    NULL,
+                                                                    NULL) != HashCalculatorResultCode_SUCCESS)
+            {
+                (void) printf("Hashing failed: %ls\n", error_message_buf);
+                UHASHTOOLS_TEST_CHECK(FALSE);
+                return;
+            }
+        }
+
+        run_seconds = uhashtools_test_get_seconds() - start_seconds;
+
+        if (run_index == 0 || run_seconds < seconds)
+        {
+            seconds = run_seconds;
+        }
+    }
+
+    (void) printf("%-14s %6lu B: %10.0f files/s %8.2f us/file %9.1f MiB/s\n",
+                  run_name,
+                  (unsigned long) file_size,
+                  (double) files_count / seconds,
+                  seconds * 1000000.0 / (double) files_count,
+                  (double) file_size * (double) files_count / seconds / (1024.0 * 1024.0));
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    static const size_t file_sizes[] = { 1, 64, 512, 1024 * 4, 1024 * 16, BENCH_MAX_FILE_SIZE };
+    const unsigned int files_count = argc > 1 ? (unsigned int) strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_FILES_COUNT;
+    unsigned char* data = (unsigned char*) malloc(BENCH_MAX_FILE_SIZE);
+    unsigned char* file_read_buf = (unsigned char*) malloc(FILE_READ_BUF_TSIZE);
+    char file_path[FILEPATH_BUFFER_TSIZE];
+    wchar_t file_wpath[FILEPATH_BUFFER_TSIZE];
+    unsigned int i = 0;
+
+    (void) sprintf(file_path, "%.*s.bin", (int) (FILEPATH_BUFFER_TSIZE - 8), argv[0]);
+    (void) mbstowcs(file_wpath, file_path, FILEPATH_BUFFER_TSIZE);
+
+    UHASHTOOLS_TEST_CHECK(data);
+    UHASHTOOLS_TEST_CHECK(file_read_buf);
+    if (!data || !file_read_buf)
+    {
+        free((void*) file_read_buf);
+        free((void*) data);
+
+        return uhashtools_test_finish("bench_small_file_source");
+    }
+
+    uhashtools_test_fill_data(TEST_DATA_KIND_RANDOM, data, BENCH_MAX_FILE_SIZE);
+
+    (void) printf("%u files per size\n", files_count);
+
+    for (i = 0; i < sizeof file_sizes / sizeof file_sizes[0]; ++i)
+    {
+        FILE* file = fopen(file_path, "wb");
+
+        UHASHTOOLS_TEST_CHECK(file);
+        if (!file)
+        {
+            break;
+        }
+
+        UHASHTOOLS_TEST_CHECK(fwrite((const void*) data, 1, file_sizes[i], file) == file_sizes[i]);
+        UHASHTOOLS_TEST_CHECK(fclose(file) == 0);
+
+        uhashtools_bench_hash_files("fast path", file_wpath, file_sizes[i], file_read_buf, FILE_READ_BUF_TSIZE, files_count);
+
+        if (file_sizes[i] > 1)
+        {
+            uhashtools_bench_hash_files("regular loop", file_wpath, file_sizes[i], file_read_buf, file_sizes[i] - 1, files_count);
+        }
+    }
+
+    (void) remove(file_path);
+
+    free((void*) file_read_buf);
+    free((void*) data);
+
+    return uhashtools_test_finish("bench_small_file_source");
+}
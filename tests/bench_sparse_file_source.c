@@ -0,0 +1,188 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Measures hashing a sparse file of 256 MiB (or the size in MiB passed as
+ * first argument) with a data extent of 64 KiB every 4 MiB. The sparse
+ * file is read through "file_source_crt.c", which returns the holes from
+ * a buffer of zeros. For comparison the same data is hashed from a dense
+ * copy, which is in the disk cache after it has been written, so the
+ * difference only shows the cost of reading instead of the cost of disk
+ * accesses. Both runs have to result in the same digest.
+ * 
+ * The test files are written next to the benchmark executable and removed
+ * afterwards.
+ */
+
+#include "test_utilities.h"
+
+#include "buffer_sizes.h"
+#include "hash_calculation_impl.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <wchar.h>
+
+#define BENCH_DEFAULT_FILE_SIZE_MIB 256
+#define BENCH_EXTENT_SIZE (1024 * 64)
+#define BENCH_EXTENTS_DISTANCE (1024 * 1024 * 4)
+
+/* The fastest of several runs is printed, so other processes disturb less. */
+#define BENCH_RUNS_COUNT 3
+
+static
+BOOL
+uhashtools_bench_write_files
+(
+    const char* sparse_file_path,
+    const char* dense_file_path,
+    unsigned __int64 file_size
+)
+{
+    unsigned char* data = (unsigned char*) calloc(1, BENCH_EXTENTS_DISTANCE);
+    const int sparse_file_fd = open(sparse_file_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    const int dense_file_fd = open(dense_file_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    unsigned __int64 offset = 0;
+    BOOL ret = data && sparse_file_fd >= 0 && dense_file_fd >= 0;
+
+    for (offset = 0; ret && offset < file_size; offset += BENCH_EXTENTS_DISTANCE)
+    {
+        const size_t block_size = file_size - offset < BENCH_EXTENTS_DISTANCE ? (size_t) (file_size - offset)
+                                                                              : BENCH_EXTENTS_DISTANCE;
+        const size_t extent_size = block_size < BENCH_EXTENT_SIZE ? block_size : BENCH_EXTENT_SIZE;
+
+        uhashtools_test_fill_data(TEST_DATA_KIND_RANDOM, data, extent_size);
+
+        ret = pwrite(sparse_file_fd, (const void*) data, extent_size, (off_t) offset) == (ssize_t) extent_size &&
+              write(dense_file_fd, (const void*) data, block_size) == (ssize_t) block_size;
+    }
+
+    if (ret && ftruncate(sparse_file_fd, (off_t) file_size) != 0)
+    {
+        ret = FALSE;
+    }
+
+    if (sparse_file_fd >= 0)
+    {
+        (void) close(sparse_file_fd);
+    }
+
+    if (dense_file_fd >= 0)
+    {
+        (void) close(dense_file_fd);
+    }
+
+    free((void*) data);
+
+    return ret;
+}
+
+static
+void
+uhashtools_bench_hash_file
+(
+    const char* run_name,
+    const wchar_t* file_wpath,
+    unsigned __int64 file_size,
+    unsigned char* file_read_buf,
+    struct HashDigest* file_digest
+)
+{
+    wchar_t error_message_buf[256];
+    double seconds = 0.0;
+    unsigned int run_index = 0;
+
+    for (run_index = 0; run_index < BENCH_RUNS_COUNT; ++run_index)
+    {
+        const double start_seconds = uhashtools_test_get_seconds();
+        double run_seconds = 0.0;
+
+        if (uhashtools_hash_calculator_impl_hash_file_to_digest(file_read_buf,
+                                                                FILE_READ_BUF_TSIZE,
+                                                                file_digest,
+                                                                error_message_buf,
+                                                                sizeof error_message_buf / sizeof error_message_buf[0],
+                                                                file_wpath,
+                                                                NULL,
+                                                                NULL,
+                                                                NULL,
+                                                                NULL) != HashCalculatorResultCode_SUCCESS)
+        {
+            (void) printf("Hashing failed: %ls\n", error_message_buf);
+            UHASHTOOLS_TEST_CHECK(FALSE);
+            return;
+        }
+
+        run_seconds = uhashtools_test_get_seconds() - start_seconds;
+
+        if (run_index == 0 || run_seconds < seconds)
+        {
+            seconds = run_seconds;
+        }
+    }
+
+    (void) printf("%-24s %8.3f s %9.1f MiB/s\n",
+                  run_name,
+                  seconds,
+                  (double) file_size / seconds / (1024.0 * 1024.0));
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    const unsigned __int64 file_size = (unsigned __int64) (argc > 1 ? strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_FILE_SIZE_MIB) * 1024 * 1024;
+    unsigned char* file_read_buf = (unsigned char*) malloc(FILE_READ_BUF_TSIZE);
+    char sparse_file_path[FILEPATH_BUFFER_TSIZE];
+    char dense_file_path[FILEPATH_BUFFER_TSIZE];
+    wchar_t sparse_file_wpath[FILEPATH_BUFFER_TSIZE];
+    wchar_t dense_file_wpath[FILEPATH_BUFFER_TSIZE];
+    struct HashDigest sparse_digest;
+    struct HashDigest dense_digest;
+
+    (void) sprintf(sparse_file_path, "%.*s.bin", (int) (FILEPATH_BUFFER_TSIZE - 8), argv[0]);
+    (void) sprintf(dense_file_path, "%.*s.dense", (int) (FILEPATH_BUFFER_TSIZE - 8), argv[0]);
+    (void) mbstowcs(sparse_file_wpath, sparse_file_path, FILEPATH_BUFFER_TSIZE);
+    (void) mbstowcs(dense_file_wpath, dense_file_path, FILEPATH_BUFFER_TSIZE);
+
+    (void) memset((void*) &sparse_digest, 0, sizeof sparse_digest);
+    (void) memset((void*) &dense_digest, 0, sizeof dense_digest);
+
+    UHASHTOOLS_TEST_CHECK(file_read_buf);
+    UHASHTOOLS_TEST_CHECK(file_size > 0);
+    if (file_read_buf && file_size > 0 && uhashtools_bench_write_files(sparse_file_path, dense_file_path, file_size))
+    {
+        (void) printf("%lu MiB with %u KiB of data every %u MiB\n",
+                      (unsigned long) (file_size / (1024 * 1024)),
+                      (unsigned int) (BENCH_EXTENT_SIZE / 1024),
+                      (unsigned int) (BENCH_EXTENTS_DISTANCE / (1024 * 1024)));
+
+        uhashtools_bench_hash_file("Sparse file", sparse_file_wpath, file_size, file_read_buf, &sparse_digest);
+        uhashtools_bench_hash_file("Dense file (cached)", dense_file_wpath, file_size, file_read_buf, &dense_digest);
+
+        UHASHTOOLS_TEST_CHECK(sparse_digest.size == dense_digest.size);
+        UHASHTOOLS_TEST_CHECK(memcmp((const void*) sparse_digest.bytes, (const void*) dense_digest.bytes, dense_digest.size) == 0);
+    }
+    else
+    {
+        UHASHTOOLS_TEST_CHECK(FALSE);
+    }
+
+    (void) remove(sparse_file_path);
+    (void) remove(dense_file_path);
+
+    free((void*) file_read_buf);
+
+    return uhashtools_test_finish("bench_sparse_file_source");
+}
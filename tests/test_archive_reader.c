@@ -0,0 +1,1133 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Tests the archive reader with ZIP, tar and tar.gz archives which are
+ * written by the test itself (zlib compresses the data). Next to the
+ * variants of the supported formats the test covers the crafted archives
+ * of the review: a ZIP central directory entry with a long name, the
+ * maximum extra field and the maximum comment, and tar entries with pax
+ * and GNU sizes close to 2^64. Damaged archives must be rejected without
+ * reading or writing out of bounds (see the sanitizers in "makefile").
+ * 
+ * The archives are written next to the test executable and removed
+ * afterwards.
+ */
+
+#include "test_utilities.h"
+
+#include "archive_reader.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <zlib.h>
+
+#define TEST_ENTRIES_COUNT 9
+#define TEST_LONG_NAME_LEN 300
+#define TEST_MAX_READ_SIZE (70 * 1000)
+#define TEST_DAMAGED_ARCHIVES_COUNT 300
+
+#define TEST_ZIP_FLAG_DEFLATE 0x01u
+#define TEST_ZIP_FLAG_ZIP64 0x02u
+#define TEST_ZIP_FLAG_LONG_FIELDS 0x04u
+
+#define TEST_TAR_FLAG_PAX 0x01u
+#define TEST_TAR_FLAG_GZIP 0x02u
+#define TEST_TAR_FLAG_NO_END_BLOCKS 0x04u
+
+struct TestEntry
+{
+    /* UTF-8 name within the archive, directories end with a slash. */
+    char name[TEST_LONG_NAME_LEN + 1];
+    wchar_t expected_name[TEST_LONG_NAME_LEN + 1];
+    unsigned char* data;
+    size_t data_size;
+};
+
+struct TestBuf
+{
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+};
+
+static struct TestEntry test_entries[TEST_ENTRIES_COUNT];
+
+static char test_archive_path[FILEPATH_BUFFER_TSIZE];
+static wchar_t test_archive_wpath[FILEPATH_BUFFER_TSIZE];
+
+/* Helpers for writing the archives */
+
+static
+void
+uhashtools_test_buf_append
+(
+    struct TestBuf* buf,
+    const void* data,
+    size_t data_size
+)
+{
+    if (buf->size + data_size > buf->capacity)
+    {
+        buf->capacity = (buf->size + data_size) * 2;
+        buf->data = (unsigned char*) realloc(buf->data, buf->capacity);
+
+        if (!buf->data)
+        {
+            (void) printf("Out of memory!\n");
+            abort();
+        }
+    }
+
+    if (data_size > 0)
+    {
+        (void) memcpy((void*) (buf->data + buf->size), data, data_size);
+        buf->size += data_size;
+    }
+}
+
+static
+void
+uhashtools_test_buf_append_zeros
+(
+    struct TestBuf* buf,
+    size_t count
+)
+{
+    static const unsigned char zeros[512] = { 0 };
+
+    while (count > 0)
+    {
+        const size_t chunk_size = count < sizeof zeros ? count : sizeof zeros;
+
+        uhashtools_test_buf_append(buf, zeros, chunk_size);
+        count -= chunk_size;
+    }
+}
+
+static
+void
+uhashtools_test_buf_append_le
+(
+    struct TestBuf* buf,
+    unsigned __int64 value,
+    size_t byte_count
+)
+{
+    unsigned char bytes[8];
+    size_t i = 0;
+
+    for (i = 0; i < byte_count; ++i)
+    {
+        bytes[i] = (unsigned char) (value >> (i * 8));
+    }
+
+    uhashtools_test_buf_append(buf, bytes, byte_count);
+}
+
+static
+void
+uhashtools_test_buf_free
+(
+    struct TestBuf* buf
+)
+{
+    free(buf->data);
+    (void) memset((void*) buf, 0, sizeof *buf);
+}
+
+/* Compresses the data into a raw deflate stream or a gzip stream with a file name. */
+static
+void
+uhashtools_test_compress
+(
+    struct TestBuf* out,
+    const unsigned char* data,
+    size_t data_size,
+    BOOL is_gzip
+)
+{
+    z_stream stream;
+    gz_header gzip_header;
+    uLong bound = 0;
+    int deflate_result = Z_OK;
+
+    (void) memset((void*) &stream, 0, sizeof stream);
+    (void) memset((void*) &gzip_header, 0, sizeof gzip_header);
+
+    if (deflateInit2(&stream, 6, Z_DEFLATED, is_gzip ? 31 : -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        UHASHTOOLS_TEST_CHECK(!"deflateInit2() failed.");
+        return;
+    }
+
+    if (is_gzip)
+    {
+        gzip_header.name = (Bytef*) "test.tar";
+        (void) deflateSetHeader(&stream, &gzip_header);
+    }
+
+    /* The bound misses the 5 bytes of the empty stored block of level 0. */
+    bound = deflateBound(&stream, (uLong) data_size) + 64;
+    uhashtools_test_buf_append_zeros(out, (size_t) bound);
+    out->size -= (size_t) bound;
+
+    stream.next_in = (Bytef*) data;
+    stream.avail_in = (uInt) data_size;
+    stream.next_out = out->data + out->size;
+    stream.avail_out = (uInt) bound;
+
+    deflate_result = deflate(&stream, Z_FINISH);
+    UHASHTOOLS_TEST_CHECK(deflate_result == Z_STREAM_END);
+
+    out->size += (size_t) stream.total_out;
+    (void) deflateEnd(&stream);
+}
+
+static
+BOOL
+uhashtools_test_write_archive
+(
+    const struct TestBuf* archive
+)
+{
+    FILE* archive_file = fopen(test_archive_path, "wb");
+    BOOL is_written = FALSE;
+
+    if (archive_file)
+    {
+        is_written = fwrite(archive->data, 1, archive->size, archive_file) == archive->size;
+        is_written = fclose(archive_file) == 0 && is_written;
+    }
+
+    UHASHTOOLS_TEST_CHECK(is_written);
+
+    return is_written;
+}
+
+/* ZIP archives */
+
+static
+BOOL
+uhashtools_test_zip_is_long_fields_entry
+(
+    unsigned int zip_flags,
+    size_t entry_index
+)
+{
+    return (zip_flags & TEST_ZIP_FLAG_LONG_FIELDS) && strlen(test_entries[entry_index].name) == TEST_LONG_NAME_LEN;
+}
+
+static
+void
+uhashtools_test_make_zip
+(
+    struct TestBuf* archive,
+    unsigned int zip_flags
+)
+{
+    struct TestBuf central_directory;
+    unsigned __int64 local_header_offsets[TEST_ENTRIES_COUNT];
+    unsigned __int64 compressed_sizes[TEST_ENTRIES_COUNT];
+    unsigned __int64 central_directory_offset = 0;
+    const BOOL is_zip64 = (zip_flags & TEST_ZIP_FLAG_ZIP64) != 0;
+    size_t entry_index = 0;
+
+    (void) memset((void*) &central_directory, 0, sizeof central_directory);
+
+    for (entry_index = 0; entry_index < TEST_ENTRIES_COUNT; ++entry_index)
+    {
+        const struct TestEntry* entry = &test_entries[entry_index];
+        const size_t name_len = strlen(entry->name);
+        const BOOL is_deflated = (zip_flags & TEST_ZIP_FLAG_DEFLATE) && entry->data_size > 0;
+        const unsigned int crc = (unsigned int) crc32(0, entry->data, (uInt) entry->data_size);
+        size_t compressed_size_pos = 0;
+        size_t data_pos = 0;
+        size_t i = 0;
+        BOOL is_utf8 = FALSE;
+
+        for (i = 0; i < name_len; ++i)
+        {
+            is_utf8 = is_utf8 || (entry->name[i] & 0x80);
+        }
+
+        local_header_offsets[entry_index] = archive->size;
+
+        uhashtools_test_buf_append_le(archive, 0x04034B50u, 4);
+        uhashtools_test_buf_append_le(archive, is_zip64 ? 45 : 20, 2);
+        uhashtools_test_buf_append_le(archive, is_utf8 ? 0x0800u : 0, 2);
+        uhashtools_test_buf_append_le(archive, is_deflated ? 8 : 0, 2);
+        uhashtools_test_buf_append_le(archive, 0x4A3C5000u, 4);
+        uhashtools_test_buf_append_le(archive, crc, 4);
+        compressed_size_pos = archive->size;
+        uhashtools_test_buf_append_le(archive, is_zip64 ? 0xFFFFFFFFu : 0, 4);
+        uhashtools_test_buf_append_le(archive, is_zip64 ? 0xFFFFFFFFu : entry->data_size, 4);
+        uhashtools_test_buf_append_le(archive, name_len, 2);
+        uhashtools_test_buf_append_le(archive, is_zip64 ? 20 : 0, 2);
+        uhashtools_test_buf_append(archive, entry->name, name_len);
+
+        if (is_zip64)
+        {
+            uhashtools_test_buf_append_le(archive, 0x0001u, 2);
+            uhashtools_test_buf_append_le(archive, 16, 2);
+            uhashtools_test_buf_append_le(archive, entry->data_size, 8);
+            uhashtools_test_buf_append_le(archive, 0, 8);
+        }
+
+        data_pos = archive->size;
+
+        if (is_deflated)
+        {
+            uhashtools_test_compress(archive, entry->data, entry->data_size, FALSE);
+        }
+        else
+        {
+            uhashtools_test_buf_append(archive, entry->data, entry->data_size);
+        }
+
+        compressed_sizes[entry_index] = archive->size - data_pos;
+
+        if (!is_zip64)
+        {
+            for (i = 0; i < 4; ++i)
+            {
+                archive->data[compressed_size_pos + i] = (unsigned char) (compressed_sizes[entry_index] >> (i * 8));
+            }
+        }
+    }
+
+    central_directory_offset = archive->size;
+
+    for (entry_index = 0; entry_index < TEST_ENTRIES_COUNT; ++entry_index)
+    {
+        const struct TestEntry* entry = &test_entries[entry_index];
+        const size_t name_len = strlen(entry->name);
+        const BOOL is_deflated = (zip_flags & TEST_ZIP_FLAG_DEFLATE) && entry->data_size > 0;
+        const BOOL has_long_fields = uhashtools_test_zip_is_long_fields_entry(zip_flags, entry_index);
+        size_t extra_len = is_zip64 ? 28 : 0;
+        size_t i = 0;
+        BOOL is_utf8 = FALSE;
+
+        for (i = 0; i < name_len; ++i)
+        {
+            is_utf8 = is_utf8 || (entry->name[i] & 0x80);
+        }
+
+        if (has_long_fields)
+        {
+            extra_len = 0xFFFF;
+        }
+
+        uhashtools_test_buf_append_le(&central_directory, 0x02014B50u, 4);
+        uhashtools_test_buf_append_le(&central_directory, 0x031E, 2);
+        uhashtools_test_buf_append_le(&central_directory, is_zip64 ? 45 : 20, 2);
+        uhashtools_test_buf_append_le(&central_directory, is_utf8 ? 0x0800u : 0, 2);
+        uhashtools_test_buf_append_le(&central_directory, is_deflated ? 8 : 0, 2);
+        uhashtools_test_buf_append_le(&central_directory, 0x4A3C5000u, 4);
+        uhashtools_test_buf_append_le(&central_directory, crc32(0, entry->data, (uInt) entry->data_size), 4);
+        uhashtools_test_buf_append_le(&central_directory, is_zip64 ? 0xFFFFFFFFu : compressed_sizes[entry_index], 4);
+        uhashtools_test_buf_append_le(&central_directory, is_zip64 ? 0xFFFFFFFFu : entry->data_size, 4);
+        uhashtools_test_buf_append_le(&central_directory, name_len, 2);
+        uhashtools_test_buf_append_le(&central_directory, extra_len, 2);
+        uhashtools_test_buf_append_le(&central_directory, has_long_fields ? 0xFFFF : 0, 2);
+        uhashtools_test_buf_append_le(&central_directory, 0, 2);
+        uhashtools_test_buf_append_le(&central_directory, 0, 2);
+        uhashtools_test_buf_append_le(&central_directory, 0, 4);
+        uhashtools_test_buf_append_le(&central_directory, is_zip64 ? 0xFFFFFFFFu : local_header_offsets[entry_index], 4);
+        uhashtools_test_buf_append(&central_directory, entry->name, name_len);
+
+        if (is_zip64)
+        {
+            uhashtools_test_buf_append_le(&central_directory, 0x0001u, 2);
+            uhashtools_test_buf_append_le(&central_directory, 24, 2);
+            uhashtools_test_buf_append_le(&central_directory, entry->data_size, 8);
+            uhashtools_test_buf_append_le(&central_directory, compressed_sizes[entry_index], 8);
+            uhashtools_test_buf_append_le(&central_directory, local_header_offsets[entry_index], 8);
+        }
+
+        if (has_long_fields)
+        {
+            /* An unknown extra block fills the extra field up to its maximum size. */
+            uhashtools_test_buf_append_le(&central_directory, 0xCAFEu, 2);
+            uhashtools_test_buf_append_le(&central_directory, 0xFFFF - 4 - (is_zip64 ? 28 : 0), 2);
+            uhashtools_test_buf_append_zeros(&central_directory, 0xFFFF - 4 - (is_zip64 ? 28 : 0));
+            uhashtools_test_buf_append_zeros(&central_directory, 0xFFFF);
+        }
+    }
+
+    uhashtools_test_buf_append(archive, central_directory.data, central_directory.size);
+
+    if (is_zip64)
+    {
+        const unsigned __int64 zip64_eocd_offset = archive->size;
+
+        uhashtools_test_buf_append_le(archive, 0x06064B50u, 4);
+        uhashtools_test_buf_append_le(archive, 44, 8);
+        uhashtools_test_buf_append_le(archive, 0x031E, 2);
+        uhashtools_test_buf_append_le(archive, 45, 2);
+        uhashtools_test_buf_append_le(archive, 0, 4);
+        uhashtools_test_buf_append_le(archive, 0, 4);
+        uhashtools_test_buf_append_le(archive, TEST_ENTRIES_COUNT, 8);
+        uhashtools_test_buf_append_le(archive, TEST_ENTRIES_COUNT, 8);
+        uhashtools_test_buf_append_le(archive, central_directory.size, 8);
+        uhashtools_test_buf_append_le(archive, central_directory_offset, 8);
+
+        uhashtools_test_buf_append_le(archive, 0x07064B50u, 4);
+        uhashtools_test_buf_append_le(archive, 0, 4);
+        uhashtools_test_buf_append_le(archive, zip64_eocd_offset, 8);
+        uhashtools_test_buf_append_le(archive, 1, 4);
+    }
+
+    uhashtools_test_buf_append_le(archive, 0x06054B50u, 4);
+    uhashtools_test_buf_append_le(archive, 0, 2);
+    uhashtools_test_buf_append_le(archive, 0, 2);
+    uhashtools_test_buf_append_le(archive, is_zip64 ? 0xFFFFu : TEST_ENTRIES_COUNT, 2);
+    uhashtools_test_buf_append_le(archive, is_zip64 ? 0xFFFFu : TEST_ENTRIES_COUNT, 2);
+    uhashtools_test_buf_append_le(archive, is_zip64 ? 0xFFFFFFFFu : central_directory.size, 4);
+    uhashtools_test_buf_append_le(archive, is_zip64 ? 0xFFFFFFFFu : central_directory_offset, 4);
+
+    if (zip_flags & TEST_ZIP_FLAG_LONG_FIELDS)
+    {
+        /* An archive comment of the maximum size, which contains no signature. */
+        uhashtools_test_buf_append_le(archive, 0xFFFF, 2);
+        uhashtools_test_buf_append_zeros(archive, 0xFFFF);
+    }
+    else
+    {
+        uhashtools_test_buf_append_le(archive, 0, 2);
+    }
+
+    uhashtools_test_buf_free(&central_directory);
+}
+
+/* tar archives */
+
+static
+void
+uhashtools_test_tar_set_octal
+(
+    unsigned char* field,
+    size_t field_size,
+    unsigned __int64 value
+)
+{
+    size_t i = field_size - 1;
+
+    field[i] = '\0';
+
+    while (i > 0)
+    {
+        --i;
+        field[i] = (unsigned char) ('0' + (value & 7));
+        value >>= 3;
+    }
+}
+
+/* GNU base-256 encoding of the size field */
+static
+void
+uhashtools_test_tar_set_base256
+(
+    unsigned char* field,
+    size_t field_size,
+    unsigned __int64 value
+)
+{
+    size_t i = field_size;
+
+    (void) memset((void*) field, 0, field_size);
+
+    while (i > 1)
+    {
+        --i;
+        field[i] = (unsigned char) value;
+        value >>= 8;
+    }
+
+    field[0] = 0x80u;
+}
+
+static
+void
+uhashtools_test_tar_set_checksum
+(
+    unsigned char* header
+)
+{
+    unsigned int checksum = 0;
+    size_t i = 0;
+
+    (void) memset((void*) (header + 148), ' ', 8);
+
+    for (i = 0; i < 512; ++i)
+    {
+        checksum += header[i];
+    }
+
+    uhashtools_test_tar_set_octal(header + 148, 7, checksum);
+}
+
+static
+void
+uhashtools_test_tar_append_header
+(
+    struct TestBuf* archive,
+    const char* name,
+    unsigned char type_flag,
+    unsigned __int64 size,
+    BOOL is_base256_size
+)
+{
+    unsigned char header[512];
+    const size_t name_len = strlen(name);
+
+    (void) memset((void*) header, 0, sizeof header);
+
+    if (name_len <= 100)
+    {
+        (void) memcpy((void*) header, (const void*) name, name_len);
+    }
+    else
+    {
+        /* Split into the ustar prefix and name if possible, else truncated like GNU tar does. */
+        const char* split = name_len - 101 < 155 ? strchr(name + name_len - 101, '/') : NULL;
+
+        if (split && (size_t) (split - name) <= 155)
+        {
+            (void) memcpy((void*) (header + 345), (const void*) name, (size_t) (split - name));
+            (void) memcpy((void*) header, (const void*) (split + 1), name_len - (size_t) (split - name) - 1);
+        }
+        else
+        {
+            (void) memcpy((void*) header, (const void*) name, 100);
+        }
+    }
+
+    uhashtools_test_tar_set_octal(header + 100, 8, type_flag == '5' ? 0755 : 0644);
+    uhashtools_test_tar_set_octal(header + 108, 8, 1000);
+    uhashtools_test_tar_set_octal(header + 116, 8, 1000);
+
+    if (is_base256_size)
+    {
+        uhashtools_test_tar_set_base256(header + 124, 12, size);
+    }
+    else
+    {
+        uhashtools_test_tar_set_octal(header + 124, 12, size);
+    }
+
+    uhashtools_test_tar_set_octal(header + 136, 12, 01234567012);
+    header[156] = type_flag;
+    (void) memcpy((void*) (header + 257), (const void*) "ustar\0" "00", 8);
+
+    uhashtools_test_tar_set_checksum(header);
+    uhashtools_test_buf_append(archive, header, sizeof header);
+}
+
+static
+void
+uhashtools_test_tar_append_data
+(
+    struct TestBuf* archive,
+    const void* data,
+    size_t data_size
+)
+{
+    uhashtools_test_buf_append(archive, data, data_size);
+    uhashtools_test_buf_append_zeros(archive, (512 - data_size % 512) % 512);
+}
+
+/* Appends a pax extended header with a single record. */
+static
+void
+uhashtools_test_tar_append_pax_record
+(
+    struct TestBuf* archive,
+    const char* key,
+    const char* value
+)
+{
+    char record[TEST_LONG_NAME_LEN + 64];
+    size_t record_len = strlen(key) + strlen(value) + 3;
+    int digits_count = 0;
+
+    /* The length includes its own digits. */
+    for (digits_count = 1; record_len + (size_t) digits_count >= (digits_count == 1 ? 10u : digits_count == 2 ? 100u : 1000u); ++digits_count)
+    {
+    }
+
+    record_len += (size_t) digits_count;
+    (void) sprintf(record, "%lu %s=%s\n", (unsigned long) record_len, key, value);
+    UHASHTOOLS_TEST_CHECK(strlen(record) == record_len);
+
+    uhashtools_test_tar_append_header(archive, "PaxHeaders/entry", 'x', record_len, FALSE);
+    uhashtools_test_tar_append_data(archive, record, record_len);
+}
+
+static
+void
+uhashtools_test_make_tar
+(
+    struct TestBuf* archive,
+    unsigned int tar_flags
+)
+{
+    struct TestBuf tar;
+    size_t entry_index = 0;
+
+    (void) memset((void*) &tar, 0, sizeof tar);
+
+    for (entry_index = 0; entry_index < TEST_ENTRIES_COUNT; ++entry_index)
+    {
+        const struct TestEntry* entry = &test_entries[entry_index];
+        const size_t name_len = strlen(entry->name);
+        const BOOL is_directory = entry->name[name_len - 1] == '/';
+        unsigned __int64 header_size = entry->data_size;
+        BOOL is_base256_size = FALSE;
+
+        if (tar_flags & TEST_TAR_FLAG_PAX)
+        {
+            if (name_len > 100)
+            {
+                uhashtools_test_tar_append_pax_record(&tar, "path", entry->name);
+            }
+
+            if (entry_index % 3 == 1)
+            {
+                /* The pax size replaces the size of the header. */
+                char size_txt[32];
+
+                (void) sprintf(size_txt, "%lu", (unsigned long) entry->data_size);
+                uhashtools_test_tar_append_pax_record(&tar, "size", size_txt);
+                header_size = 0;
+            }
+        }
+        else
+        {
+            if (name_len > 100)
+            {
+                uhashtools_test_tar_append_header(&tar, "././@LongLink", 'L', name_len + 1, FALSE);
+                uhashtools_test_tar_append_data(&tar, entry->name, name_len + 1);
+            }
+
+            is_base256_size = entry_index % 3 == 1;
+        }
+
+        uhashtools_test_tar_append_header(&tar, entry->name, is_directory ? '5' : '0', header_size, is_base256_size);
+        uhashtools_test_tar_append_data(&tar, entry->data, entry->data_size);
+    }
+
+    if (!(tar_flags & TEST_TAR_FLAG_NO_END_BLOCKS))
+    {
+        uhashtools_test_buf_append_zeros(&tar, 512 * 2);
+    }
+
+    if (tar_flags & TEST_TAR_FLAG_GZIP)
+    {
+        uhashtools_test_compress(archive, tar.data, tar.size, TRUE);
+    }
+    else
+    {
+        uhashtools_test_buf_append(archive, tar.data, tar.size);
+    }
+
+    uhashtools_test_buf_free(&tar);
+}
+
+/* Reading the archives */
+
+/*
+ * Reads all entries of the written archive. Entries are read with
+ * buffers of random sizes, or skipped partially if "skip_entries" is set.
+ * 
+ * @return TRUE if all entries have been read and matched the test
+ *         entries, FALSE if the archive has been rejected.
+ */
+static
+BOOL
+uhashtools_test_read_archive
+(
+    BOOL skip_entries,
+    BOOL print_mismatches
+)
+{
+    static unsigned char read_buf[TEST_MAX_READ_SIZE];
+    wchar_t error_message[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    struct ArchiveReader* archive_reader = NULL;
+    struct ArchiveEntryInfo entry_info;
+    enum ArchiveReaderResult next_result = ARCHIVE_READER_RESULT_OK;
+    size_t entry_index = 0;
+    BOOL ret = FALSE;
+
+    archive_reader = uhashtools_archive_reader_open(error_message, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, test_archive_wpath);
+
+    if (!archive_reader)
+    {
+        if (print_mismatches)
+        {
+            (void) printf("Opening the archive failed: %ls\n", error_message);
+        }
+
+        return FALSE;
+    }
+
+    for (;;)
+    {
+        const struct TestEntry* entry = NULL;
+        size_t read_total = 0;
+        size_t read_limit = 0;
+        BOOL reached_eof = FALSE;
+
+        while (entry_index < TEST_ENTRIES_COUNT && test_entries[entry_index].name[strlen(test_entries[entry_index].name) - 1] == '/')
+        {
+            /* Directories aren't reported. */
+            ++entry_index;
+        }
+
+        next_result = uhashtools_archive_reader_next_entry(archive_reader, &entry_info);
+
+        if (next_result != ARCHIVE_READER_RESULT_OK)
+        {
+            break;
+        }
+
+        if (entry_index >= TEST_ENTRIES_COUNT)
+        {
+            if (print_mismatches)
+            {
+                (void) printf("Unexpected entry \"%ls\".\n", entry_info.entry_name);
+            }
+
+            goto cleanup_and_out;
+        }
+
+        entry = &test_entries[entry_index++];
+
+        if (wcscmp(entry_info.entry_name, entry->expected_name) != 0 || entry_info.size != entry->data_size)
+        {
+            if (print_mismatches)
+            {
+                (void) printf("Expected entry \"%ls\" of %lu bytes, got \"%ls\" of %lu bytes.\n",
+                              entry->expected_name,
+                              (unsigned long) entry->data_size,
+                              entry_info.entry_name,
+                              (unsigned long) entry_info.size);
+            }
+
+            goto cleanup_and_out;
+        }
+
+        /* When skipping, every other entry is left unread or read partially. */
+        read_limit = skip_entries && entry_index % 2 == 0 ? entry->data_size / 3 : (size_t) -1;
+
+        while (!reached_eof && read_total < read_limit)
+        {
+            const size_t buf_size = (size_t) (uhashtools_test_random() % TEST_MAX_READ_SIZE) + 1;
+            size_t read_size = 0;
+
+            if (!uhashtools_archive_reader_read_entry_data(archive_reader, read_buf, buf_size, &read_size, &reached_eof))
+            {
+                if (print_mismatches)
+                {
+                    (void) printf("Reading \"%ls\" failed: %ls\n",
+                                  entry->expected_name,
+                                  uhashtools_archive_reader_get_error_message(archive_reader));
+                }
+
+                goto cleanup_and_out;
+            }
+
+            if (read_size > buf_size ||
+                read_size > entry->data_size - read_total ||
+                memcmp(read_buf, entry->data + read_total, read_size) != 0)
+            {
+                if (print_mismatches)
+                {
+                    (void) printf("Data of \"%ls\" differs at offset %lu.\n", entry->expected_name, (unsigned long) read_total);
+                }
+
+                goto cleanup_and_out;
+            }
+
+            read_total += read_size;
+        }
+
+        if (read_limit == (size_t) -1 && read_total != entry->data_size)
+        {
+            goto cleanup_and_out;
+        }
+    }
+
+    if (next_result == ARCHIVE_READER_RESULT_FAILED)
+    {
+        if (print_mismatches)
+        {
+            (void) printf("Reading the next entry failed: %ls\n", uhashtools_archive_reader_get_error_message(archive_reader));
+        }
+
+        goto cleanup_and_out;
+    }
+
+    /* The end stays the end. */
+    UHASHTOOLS_TEST_CHECK(uhashtools_archive_reader_next_entry(archive_reader, &entry_info) == ARCHIVE_READER_RESULT_END);
+
+    ret = entry_index == TEST_ENTRIES_COUNT;
+
+cleanup_and_out:
+    uhashtools_archive_reader_close(archive_reader);
+
+    return ret;
+}
+
+static
+void
+uhashtools_test_valid_archive
+(
+    const char* archive_description,
+    const struct TestBuf* archive
+)
+{
+    if (!uhashtools_test_write_archive(archive))
+    {
+        return;
+    }
+
+    if (!uhashtools_test_read_archive(FALSE, TRUE) || !uhashtools_test_read_archive(TRUE, TRUE))
+    {
+        (void) printf("Reading the %s failed.\n", archive_description);
+        UHASHTOOLS_TEST_CHECK(!"Valid archive rejected.");
+    }
+}
+
+/*
+ * Checks that the written archive is rejected. Skipping entries is checked
+ * as well if "is_rejected_when_skipping" is set. It isn't set for damages
+ * which only show once an entry has been read completely.
+ */
+static
+void
+uhashtools_test_rejected_archive
+(
+    const char* archive_description,
+    const struct TestBuf* archive,
+    BOOL is_rejected_when_skipping
+)
+{
+    if (!uhashtools_test_write_archive(archive))
+    {
+        return;
+    }
+
+    if (uhashtools_test_read_archive(FALSE, FALSE) || (is_rejected_when_skipping && uhashtools_test_read_archive(TRUE, FALSE)))
+    {
+        (void) printf("The %s has been accepted.\n", archive_description);
+        UHASHTOOLS_TEST_CHECK(!"Invalid archive accepted.");
+    }
+}
+
+/* Test cases */
+
+static
+void
+uhashtools_test_init_entries
+(
+    void
+)
+{
+    static const char* const names[TEST_ENTRIES_COUNT] =
+    {
+        "empty.bin",
+        "sub/",
+        "small.txt",
+        "sub/random.bin",
+        "sub/text.txt",
+        "zeros.bin",
+        "sub/m\xC3\xBCller.txt",
+        "sub/long/",
+        NULL
+    };
+    static const enum TestDataKind data_kinds[TEST_ENTRIES_COUNT] =
+    {
+        TEST_DATA_KIND_ZEROS,
+        TEST_DATA_KIND_ZEROS,
+        TEST_DATA_KIND_TEXT,
+        TEST_DATA_KIND_RANDOM,
+        TEST_DATA_KIND_TEXT,
+        TEST_DATA_KIND_ZEROS,
+        TEST_DATA_KIND_REPEATS,
+        TEST_DATA_KIND_ZEROS,
+        TEST_DATA_KIND_REPEATS
+    };
+    static const size_t data_sizes[TEST_ENTRIES_COUNT] = { 0, 0, 12, 100000, 300000, 70000, 5000, 0, 9 };
+    size_t entry_index = 0;
+    size_t i = 0;
+
+    for (entry_index = 0; entry_index < TEST_ENTRIES_COUNT; ++entry_index)
+    {
+        struct TestEntry* entry = &test_entries[entry_index];
+
+        if (names[entry_index])
+        {
+            (void) strcpy(entry->name, names[entry_index]);
+        }
+        else
+        {
+            /* A name which needs a GNU long name entry or a pax header */
+            (void) strcpy(entry->name, "sub/long/");
+
+            for (i = strlen(entry->name); i < TEST_LONG_NAME_LEN - 4; ++i)
+            {
+                entry->name[i] = 'x';
+            }
+
+            (void) strcpy(entry->name + i, ".txt");
+        }
+
+        for (i = 0; entry->name[i] != '\0'; ++i)
+        {
+            entry->expected_name[i] = (wchar_t) (unsigned char) entry->name[i];
+        }
+
+        entry->expected_name[i] = L'\0';
+
+        entry->data_size = data_sizes[entry_index];
+        entry->data = (unsigned char*) malloc(entry->data_size + 1);
+        UHASHTOOLS_TEST_CHECK(entry->data != NULL);
+        uhashtools_test_fill_data(data_kinds[entry_index], entry->data, entry->data_size);
+    }
+
+    (void) wcscpy(test_entries[6].expected_name, L"sub/m\x00FCller.txt");
+}
+
+static
+void
+uhashtools_test_valid_archives
+(
+    void
+)
+{
+    struct TestBuf archive;
+
+    (void) memset((void*) &archive, 0, sizeof archive);
+
+    uhashtools_test_make_zip(&archive, 0);
+    uhashtools_test_valid_archive("stored ZIP archive", &archive);
+    archive.size = 0;
+
+    uhashtools_test_make_zip(&archive, TEST_ZIP_FLAG_DEFLATE);
+    uhashtools_test_valid_archive("deflated ZIP archive", &archive);
+    archive.size = 0;
+
+    uhashtools_test_make_zip(&archive, TEST_ZIP_FLAG_DEFLATE | TEST_ZIP_FLAG_ZIP64);
+    uhashtools_test_valid_archive("ZIP64 archive", &archive);
+    archive.size = 0;
+
+    uhashtools_test_make_zip(&archive, TEST_ZIP_FLAG_LONG_FIELDS);
+    uhashtools_test_valid_archive("ZIP archive with long fields", &archive);
+    archive.size = 0;
+
+    uhashtools_test_make_zip(&archive, TEST_ZIP_FLAG_DEFLATE | TEST_ZIP_FLAG_ZIP64 | TEST_ZIP_FLAG_LONG_FIELDS);
+    uhashtools_test_valid_archive("ZIP64 archive with long fields", &archive);
+    archive.size = 0;
+
+    uhashtools_test_make_tar(&archive, 0);
+    uhashtools_test_valid_archive("GNU tar archive", &archive);
+    archive.size = 0;
+
+    uhashtools_test_make_tar(&archive, TEST_TAR_FLAG_PAX);
+    uhashtools_test_valid_archive("pax tar archive", &archive);
+    archive.size = 0;
+
+    uhashtools_test_make_tar(&archive, TEST_TAR_FLAG_NO_END_BLOCKS);
+    uhashtools_test_valid_archive("tar archive without end blocks", &archive);
+    archive.size = 0;
+
+    uhashtools_test_make_tar(&archive, TEST_TAR_FLAG_GZIP);
+    uhashtools_test_valid_archive("GNU tar.gz archive", &archive);
+    archive.size = 0;
+
+    uhashtools_test_make_tar(&archive, TEST_TAR_FLAG_PAX | TEST_TAR_FLAG_GZIP | TEST_TAR_FLAG_NO_END_BLOCKS);
+    uhashtools_test_valid_archive("pax tar.gz archive without end blocks", &archive);
+
+    uhashtools_test_buf_free(&archive);
+}
+
+static
+void
+uhashtools_test_invalid_archives
+(
+    void
+)
+{
+    struct TestBuf archive;
+    size_t data_pos = 0;
+
+    (void) memset((void*) &archive, 0, sizeof archive);
+
+    /*
+     * Changed data of a stored entry doesn't match its CRC-32 anymore. The
+     * expected data is changed as well, so only the CRC-32 check catches it.
+     */
+    uhashtools_test_make_zip(&archive, 0);
+
+    for (data_pos = 0; data_pos + test_entries[3].data_size <= archive.size; ++data_pos)
+    {
+        if (memcmp(archive.data + data_pos, test_entries[3].data, test_entries[3].data_size) == 0)
+        {
+            break;
+        }
+    }
+
+    UHASHTOOLS_TEST_CHECK(data_pos + test_entries[3].data_size <= archive.size);
+    archive.data[data_pos + 1000] ^= 0x01u;
+    test_entries[3].data[1000] ^= 0x01u;
+    uhashtools_test_rejected_archive("ZIP archive with changed data", &archive, FALSE);
+    test_entries[3].data[1000] ^= 0x01u;
+    archive.size = 0;
+
+    /* Without the end of central directory record */
+    uhashtools_test_make_zip(&archive, TEST_ZIP_FLAG_DEFLATE);
+    archive.size -= 22;
+    uhashtools_test_rejected_archive("ZIP archive without end of central directory", &archive, TRUE);
+    archive.size = 0;
+
+    uhashtools_test_make_tar(&archive, 0);
+    archive.size /= 2;
+    uhashtools_test_rejected_archive("truncated tar archive", &archive, TRUE);
+    archive.size = 0;
+
+    uhashtools_test_make_tar(&archive, TEST_TAR_FLAG_GZIP);
+    archive.size /= 2;
+    uhashtools_test_rejected_archive("truncated tar.gz archive", &archive, TRUE);
+    archive.size = 0;
+
+    /* A pax size close to 2^64 for an entry followed by a few blocks only */
+    uhashtools_test_tar_append_pax_record(&archive, "size", "18446744073709551516");
+    uhashtools_test_tar_append_header(&archive, "huge.bin", '0', 0, FALSE);
+    uhashtools_test_buf_append_zeros(&archive, 512 * 4);
+    uhashtools_test_rejected_archive("tar archive with a huge pax size", &archive, TRUE);
+    archive.size = 0;
+
+    /* The same size for the data of a pax header, and for a GNU long name */
+    uhashtools_test_tar_append_header(&archive, "PaxHeaders/huge", 'x', _UI64_MAX - 99, TRUE);
+    uhashtools_test_buf_append_zeros(&archive, 512 * 4);
+    uhashtools_test_rejected_archive("tar archive with a huge pax header", &archive, TRUE);
+    archive.size = 0;
+
+    uhashtools_test_tar_append_header(&archive, "././@LongLink", 'L', _UI64_MAX - 99, TRUE);
+    uhashtools_test_buf_append_zeros(&archive, 512 * 4);
+    uhashtools_test_rejected_archive("tar archive with a huge long name", &archive, TRUE);
+    archive.size = 0;
+
+    /* A regular entry whose base-256 size doesn't fit into 64 bits */
+    uhashtools_test_tar_append_header(&archive, "overflow.bin", '0', 0, TRUE);
+    (void) memset((void*) (archive.data + 124 + 1), 0xFF, 11);
+    uhashtools_test_tar_set_checksum(archive.data);
+    uhashtools_test_buf_append_zeros(&archive, 512 * 4);
+    uhashtools_test_rejected_archive("tar archive with an overflowing size", &archive, TRUE);
+
+    uhashtools_test_buf_free(&archive);
+}
+
+/*
+ * Damaged archives may be accepted if they still form a valid archive,
+ * but the archive reader must never leave its buffers or hang.
+ */
+static
+void
+uhashtools_test_damaged_archives
+(
+    void
+)
+{
+    struct TestBuf archives[4];
+    struct TestBuf damaged;
+    size_t archive_index = 0;
+    size_t damaged_index = 0;
+    size_t entry_index = 0;
+
+    (void) memset((void*) archives, 0, sizeof archives);
+    (void) memset((void*) &damaged, 0, sizeof damaged);
+
+    /* Smaller entries keep the archives small, so more of them can be damaged. */
+    for (entry_index = 0; entry_index < TEST_ENTRIES_COUNT; ++entry_index)
+    {
+        if (test_entries[entry_index].data_size > 3000)
+        {
+            test_entries[entry_index].data_size = 3000;
+        }
+    }
+
+    uhashtools_test_make_zip(&archives[0], TEST_ZIP_FLAG_DEFLATE);
+    uhashtools_test_make_zip(&archives[1], TEST_ZIP_FLAG_ZIP64);
+    uhashtools_test_make_tar(&archives[2], TEST_TAR_FLAG_PAX);
+    uhashtools_test_make_tar(&archives[3], TEST_TAR_FLAG_GZIP);
+
+    for (damaged_index = 0; damaged_index < TEST_DAMAGED_ARCHIVES_COUNT; ++damaged_index)
+    {
+        unsigned int changes_count = (unsigned int) (uhashtools_test_random() % 8) + 1;
+
+        archive_index = (size_t) (uhashtools_test_random() % 4);
+        damaged.size = 0;
+        uhashtools_test_buf_append(&damaged, archives[archive_index].data, archives[archive_index].size);
+
+        for (; changes_count > 0; --changes_count)
+        {
+            damaged.data[uhashtools_test_random() % damaged.size] = (unsigned char) uhashtools_test_random();
+        }
+
+        if (uhashtools_test_random() % 5 == 0)
+        {
+            damaged.size = (size_t) (uhashtools_test_random() % (damaged.size + 1));
+        }
+
+        if (uhashtools_test_write_archive(&damaged))
+        {
+            (void) uhashtools_test_read_archive(uhashtools_test_random() % 2 == 0, FALSE);
+        }
+    }
+
+    for (archive_index = 0; archive_index < 4; ++archive_index)
+    {
+        uhashtools_test_buf_free(&archives[archive_index]);
+    }
+
+    uhashtools_test_buf_free(&damaged);
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    size_t entry_index = 0;
+
+    (void) argc;
+
+    /* The archives are written next to the test executable. */
+    (void) sprintf(test_archive_path, "%.*s.tmp", (int) (FILEPATH_BUFFER_TSIZE - 5), argv[0]);
+    (void) mbstowcs(test_archive_wpath, test_archive_path, FILEPATH_BUFFER_TSIZE);
+
+    uhashtools_test_init_entries();
+    uhashtools_test_valid_archives();
+    uhashtools_test_invalid_archives();
+    uhashtools_test_damaged_archives();
+
+    (void) remove(test_archive_path);
+
+    for (entry_index = 0; entry_index < TEST_ENTRIES_COUNT; ++entry_index)
+    {
+        free(test_entries[entry_index].data);
+    }
+
+    return uhashtools_test_finish("test_archive_reader");
+}
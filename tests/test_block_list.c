@@ -0,0 +1,301 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Tests saving and loading block lists, including file sizes beyond
+ * 4 GiB in the "%I64u" fields of the header, and rejecting damaged block
+ * lists. The block lists are written next to the test executable and
+ * removed afterwards.
+ */
+
+#include "test_utilities.h"
+
+#include "block_list.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#define TEST_GIB (1024ULL * 1024 * 1024)
+
+static char test_list_path[FILEPATH_BUFFER_TSIZE];
+static wchar_t test_list_wpath[FILEPATH_BUFFER_TSIZE];
+
+/* Formats the number in decimal, independent of the "%I64u" support of the runtime. */
+static
+const char*
+uhashtools_test_u64_to_txt
+(
+    unsigned __int64 value,
+    char* txt_buf
+)
+{
+    char digits[24];
+    size_t digits_count = 0;
+    size_t i = 0;
+
+    do
+    {
+        digits[digits_count++] = (char) ('0' + value % 10);
+        value /= 10;
+    }
+    while (value > 0);
+
+    for (i = 0; i < digits_count; ++i)
+    {
+        txt_buf[i] = digits[digits_count - 1 - i];
+    }
+
+    txt_buf[digits_count] = '\0';
+
+    return txt_buf;
+}
+
+static
+void
+uhashtools_test_write_list_txt
+(
+    const char* list_txt
+)
+{
+    FILE* list_file = fopen(test_list_path, "wb");
+    BOOL is_written = FALSE;
+
+    if (list_file)
+    {
+        is_written = fwrite(list_txt, 1, strlen(list_txt), list_file) == strlen(list_txt);
+        is_written = fclose(list_file) == 0 && is_written;
+    }
+
+    UHASHTOOLS_TEST_CHECK(is_written);
+}
+
+static
+BOOL
+uhashtools_test_load_list
+(
+    unsigned int digest_size,
+    struct BlockList* block_list
+)
+{
+    wchar_t error_message[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    BOOL is_loaded = FALSE;
+
+    (void) memset((void*) block_list, 0, sizeof *block_list);
+
+    is_loaded = uhashtools_block_list_load(error_message,
+                                           GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                           test_list_wpath,
+                                           digest_size,
+                                           block_list);
+
+    /* A failed load leaves the list empty. */
+    if (!is_loaded)
+    {
+        UHASHTOOLS_TEST_CHECK(block_list->digests == NULL && block_list->blocks_count == 0);
+    }
+
+    return is_loaded;
+}
+
+static
+void
+uhashtools_test_round_trip
+(
+    unsigned int digest_size,
+    unsigned __int64 block_size,
+    unsigned __int64 file_size
+)
+{
+    static char expected_header[128];
+    wchar_t error_message[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    struct BlockList block_list;
+    struct BlockList loaded_block_list;
+    char header[128];
+    char number_txt[2][24];
+    unsigned __int64 block_index = 0;
+    FILE* list_file = NULL;
+    unsigned int i = 0;
+
+    (void) memset((void*) &block_list, 0, sizeof block_list);
+
+    if (!uhashtools_block_list_init(error_message,
+                                    GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                    &block_list,
+                                    digest_size,
+                                    block_size,
+                                    file_size))
+    {
+        UHASHTOOLS_TEST_CHECK(!"Initializing the block list failed.");
+        return;
+    }
+
+    UHASHTOOLS_TEST_CHECK(block_list.blocks_count == (file_size + block_size - 1) / block_size);
+
+    for (block_index = 0; block_index < block_list.blocks_count; ++block_index)
+    {
+        unsigned char* digest = uhashtools_block_list_get_digest(&block_list, block_index);
+
+        for (i = 0; i < digest_size; ++i)
+        {
+            digest[i] = (unsigned char) uhashtools_test_random();
+        }
+    }
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_block_list_save(error_message,
+                                                     GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                     test_list_wpath,
+                                                     &block_list));
+
+    /* The header has to contain the sizes in decimal, also beyond 32 bits. */
+    (void) sprintf(expected_header,
+                   "# uhashtools blocks 1 %u %s %s\n",
+                   digest_size,
+                   uhashtools_test_u64_to_txt(block_size, number_txt[0]),
+                   uhashtools_test_u64_to_txt(file_size, number_txt[1]));
+
+    list_file = fopen(test_list_path, "rb");
+    UHASHTOOLS_TEST_CHECK(list_file != NULL);
+
+    if (list_file)
+    {
+        UHASHTOOLS_TEST_CHECK(fgets(header, sizeof header, list_file) && strcmp(header, expected_header) == 0);
+        (void) fclose(list_file);
+    }
+
+    if (uhashtools_test_load_list(digest_size, &loaded_block_list))
+    {
+        UHASHTOOLS_TEST_CHECK(loaded_block_list.digest_size == digest_size);
+        UHASHTOOLS_TEST_CHECK(loaded_block_list.block_size == block_size);
+        UHASHTOOLS_TEST_CHECK(loaded_block_list.file_size == file_size);
+        UHASHTOOLS_TEST_CHECK(loaded_block_list.blocks_count == block_list.blocks_count);
+        UHASHTOOLS_TEST_CHECK(block_list.blocks_count == 0 ||
+                              memcmp(loaded_block_list.digests,
+                                     block_list.digests,
+                                     (size_t) block_list.blocks_count * digest_size) == 0);
+
+        uhashtools_block_list_free(&loaded_block_list);
+    }
+    else
+    {
+        UHASHTOOLS_TEST_CHECK(!"Loading the saved block list failed.");
+    }
+
+    /* Block lists of other hash algorithms are rejected. */
+    UHASHTOOLS_TEST_CHECK(!uhashtools_test_load_list(digest_size == 4 ? 32 : 4, &loaded_block_list));
+
+    uhashtools_block_list_free(&block_list);
+}
+
+/* Checks a hand written block list with two blocks of 4 byte digests. */
+static
+void
+uhashtools_test_list_txt
+(
+    const char* list_txt,
+    BOOL is_valid
+)
+{
+    struct BlockList block_list;
+    BOOL is_loaded = FALSE;
+
+    uhashtools_test_write_list_txt(list_txt);
+    is_loaded = uhashtools_test_load_list(4, &block_list);
+
+    if (is_loaded != is_valid)
+    {
+        (void) printf("The block list \"%s\" has %s.\n", list_txt, is_loaded ? "been loaded" : "been rejected");
+        UHASHTOOLS_TEST_CHECK(!"Unexpected result of loading the block list.");
+    }
+
+    if (is_loaded)
+    {
+        UHASHTOOLS_TEST_CHECK(block_list.blocks_count == 2);
+        UHASHTOOLS_TEST_CHECK(memcmp(block_list.digests, "\x01\x23\xAB\xCD\xFF\xFF\x00\x00", 8) == 0);
+        uhashtools_block_list_free(&block_list);
+    }
+}
+
+static
+void
+uhashtools_test_hand_written_lists
+(
+    void
+)
+{
+    struct BlockList block_list;
+    wchar_t error_message[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    wchar_t missing_path[FILEPATH_BUFFER_TSIZE];
+
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 65536 70000\n0123abcd\nffff0000\n", TRUE);
+
+    /* Edited with an editor which writes CRLF line endings and upper case hex digits */
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 65536 70000\r\n0123ABCD\r\nFFFF0000\r\n", TRUE);
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 65536 70000\n0123ABCD\r\nFFFF0000\r\n", TRUE);
+
+    /* Damaged headers */
+    uhashtools_test_list_txt("", FALSE);
+    uhashtools_test_list_txt("0123abcd\nffff0000\n", FALSE);
+    uhashtools_test_list_txt("# uhashtools blocks 2 4 65536 70000\n0123abcd\nffff0000\n", FALSE);
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 65536 70000", FALSE);
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 65536 70000 \n0123abcd\nffff0000\n", FALSE);
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 65535 70000\n0123abcd\nffff0000\n", FALSE);
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 1073741825 70000\n0123abcd\n", FALSE);
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 65536 x70000\n0123abcd\nffff0000\n", FALSE);
+
+    /* Damaged digest lines */
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 65536 70000\n0123abcd\n", FALSE);
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 65536 70000\n0123abcd\nffff0000\nffff0000\n", FALSE);
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 65536 70000\n0123abcd\nffff0000\n\n", FALSE);
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 65536 70000\n0123abcd\nffff000\n", FALSE);
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 65536 70000\n0123abcd\nffff00000\n", FALSE);
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 65536 70000\n0123abcd\nffff000g\n", FALSE);
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 65536 70000\n0123abcd\nffff0000 \n", FALSE);
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 65536 70000\n0123abcd\nffff0000", FALSE);
+
+    /* The file size of 64 GiB needs 2^20 digest lines, of which only one follows. */
+    uhashtools_test_list_txt("# uhashtools blocks 1 4 65536 68719476736\n0123abcd\n", FALSE);
+
+    (void) swprintf(missing_path, FILEPATH_BUFFER_TSIZE, L"%ls.missing", test_list_wpath);
+    (void) memset((void*) &block_list, 0, sizeof block_list);
+    UHASHTOOLS_TEST_CHECK(!uhashtools_block_list_load(error_message, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, missing_path, 4, &block_list));
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    (void) argc;
+
+    /* The block lists are written next to the test executable. */
+    (void) sprintf(test_list_path, "%.*s.tmp", (int) (FILEPATH_BUFFER_TSIZE - 5), argv[0]);
+    (void) mbstowcs(test_list_wpath, test_list_path, FILEPATH_BUFFER_TSIZE);
+
+    /* CRC-32C, SHA-256 and SHA-512 */
+    uhashtools_test_round_trip(4, BLOCK_LIST_MIN_BLOCK_SIZE, 0);
+    uhashtools_test_round_trip(4, BLOCK_LIST_MIN_BLOCK_SIZE, 1);
+    uhashtools_test_round_trip(32, BLOCK_LIST_MIN_BLOCK_SIZE, BLOCK_LIST_MIN_BLOCK_SIZE - 1);
+    uhashtools_test_round_trip(32, BLOCK_LIST_MIN_BLOCK_SIZE, BLOCK_LIST_MIN_BLOCK_SIZE);
+    uhashtools_test_round_trip(32, BLOCK_LIST_MIN_BLOCK_SIZE, BLOCK_LIST_MIN_BLOCK_SIZE + 1);
+    uhashtools_test_round_trip(64, 1024 * 1024, 1024 * 1024 * 10 + 5);
+
+    /* Sizes beyond 32 bits */
+    uhashtools_test_round_trip(32, BLOCK_LIST_MAX_BLOCK_SIZE, TEST_GIB * 5);
+    uhashtools_test_round_trip(64, BLOCK_LIST_MAX_BLOCK_SIZE, TEST_GIB * 1024 * 3 + 7);
+    uhashtools_test_round_trip(4, BLOCK_LIST_MIN_BLOCK_SIZE, TEST_GIB * 8 + 1);
+
+    uhashtools_test_hand_written_lists();
+
+    (void) remove(test_list_path);
+
+    return uhashtools_test_finish("test_block_list");
+}
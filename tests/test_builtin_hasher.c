@@ -0,0 +1,661 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Tests the built-in hasher of a product through the interface of
+ * "product.h". The test is built once per product together with the
+ * product unit and its built-in implementation (see "makefile").
+ * 
+ * The known answers were generated with Python 3.11. The input of a
+ * known answer is the test pattern with the given size (byte i is
+ * i % 251). The sources of the digests are:
+ * 
+ * - MD5, SHA-1, SHA-2, BLAKE2b and SHA-3: "hashlib".
+ * - BLAKE2sp: eight "hashlib.blake2s" leaves (fanout 8, depth 2) which
+ *   take turns on the 64 byte blocks, and a root node over their digests.
+ * - CRC-32C: a bitwise implementation with the reflected polynomial
+ *   0x82F63B78.
+ * - XXH3 and XXH128: "xxh3_64" and "xxh3_128" with seed 0 from the
+ *   "xxhash" package 4.0.1 from PyPI.
+ */
+
+#include "test_utilities.h"
+
+#include "product.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#define TEST_MAX_DIGEST_SIZE 64
+#define TEST_MAX_DATA_SIZE (1024 * 1024)
+#define TEST_RANDOM_SPLITS_COUNT 300
+
+struct TestVector
+{
+    /* Title of the product without the leading micro sign. */
+    const wchar_t* algorithm_name;
+    size_t pattern_size;
+    const char* expected_hex_digest;
+};
+
+static const struct TestVector test_vectors[] =
+{
+    /* MD5 */
+    { L"MD5", 0,
+      "d41d8cd98f00b204e9800998ecf8427e" },
+    { L"MD5", 3,
+      "b95f67f61ebb03619622d798f45fc2d3" },
+    { L"MD5", 55,
+      "6912ee65fff2d9f9ce2508cddf8bcda0" },
+    { L"MD5", 56,
+      "51fdd1acda72405dfdfa03fcb85896d7" },
+    { L"MD5", 64,
+      "b2d3f56bc197fd985d5965079b5e7148" },
+    { L"MD5", 65,
+      "8bd7053801c768420faf816fadba971c" },
+    { L"MD5", 127,
+      "8402b21e7bc7906493bae0dac017f1f9" },
+    { L"MD5", 128,
+      "37eff01866ba3f538421b30b7cbefcac" },
+    { L"MD5", 1000,
+      "a24f1e3ef66950e1327f210e3997ba2c" },
+    { L"MD5", 65539,
+      "b9d4747f059d26bd5a801670a01b8142" },
+    /* SHA-1 */
+    { L"SHA-1", 0,
+      "da39a3ee5e6b4b0d3255bfef95601890afd80709" },
+    { L"SHA-1", 3,
+      "0c7a623fd2bbc05b06423be359e4021d36e721ad" },
+    { L"SHA-1", 55,
+      "8ae2d46729cfe68ff927af5eec9c7d1b66d65ac2" },
+    { L"SHA-1", 56,
+      "636e2ec698dac903498e648bd2f3af641d3c88cb" },
+    { L"SHA-1", 64,
+      "c6138d514ffa2135bfce0ed0b8fac65669917ec7" },
+    { L"SHA-1", 65,
+      "69bd728ad6e13cd76ff19751fde427b00e395746" },
+    { L"SHA-1", 127,
+      "89d7312a903f65cd2b3e34a975e55dbea9033353" },
+    { L"SHA-1", 128,
+      "e6434bc401f98603d7eda504790c98c67385d535" },
+    { L"SHA-1", 1000,
+      "c9c960a0b925474fab83942cc27d504fc24ac37b" },
+    { L"SHA-1", 65539,
+      "1ffeb515f7b2e0b60fbbc28ab24961d6589ec3da" },
+    /* SHA-256 */
+    { L"SHA-256", 0,
+      "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+    { L"SHA-256", 3,
+      "ae4b3280e56e2faf83f414a6e3dabe9d5fbe18976544c05fed121accb85b53fc" },
+    { L"SHA-256", 55,
+      "463eb28e72f82e0a96c0a4cc53690c571281131f672aa229e0d45ae59b598b59" },
+    { L"SHA-256", 56,
+      "da2ae4d6b36748f2a318f23e7ab1dfdf45acdc9d049bd80e59de82a60895f562" },
+    { L"SHA-256", 64,
+      "fdeab9acf3710362bd2658cdc9a29e8f9c757fcf9811603a8c447cd1d9151108" },
+    { L"SHA-256", 65,
+      "4bfd2c8b6f1eec7a2afeb48b934ee4b2694182027e6d0fc075074f2fabb31781" },
+    { L"SHA-256", 127,
+      "92ca0fa6651ee2f97b884b7246a562fa71250fedefe5ebf270d31c546bfea976" },
+    { L"SHA-256", 128,
+      "471fb943aa23c511f6f72f8d1652d9c880cfa392ad80503120547703e56a2be5" },
+    { L"SHA-256", 1000,
+      "4e4c294b331f7a2099a379bec34b9f9fc03dc46ab465d998f4d683da53487e6d" },
+    { L"SHA-256", 65539,
+      "6859d9b53d73fd394a476c8cbf60367e041a0188a670fa853913becda71267fc" },
+
+    /* SHA-384 */
+    { L"SHA-384", 0,
+      "38b060a751ac96384cd9327eb1b1e36a21fdb71114be07434c0cc7bf63f6e1da"
+      "274edebfe76f65fbd51ad2f14898b95b" },
+    { L"SHA-384", 3,
+      "4f895854c1a4fc5aa2e0456eaf8d0ecaa70c196bd901153861d76b8fa3cd95ce"
+      "ea29eab6a279f8b08437703ce0b4b91a" },
+    { L"SHA-384", 111,
+      "f5f9fe110d809d34029de262a01b208356caec6e054c7f926b2591f6c9780579"
+      "d4b59f5578c6f531a84f158a33660cef" },
+    { L"SHA-384", 112,
+      "33ba080ec0ccb378e4e95fed3b26c23aa1a280476e007519ee47f60cd9c5c8a6"
+      "5d627259a9aa2fd33ca06d3c14ee5548" },
+    { L"SHA-384", 127,
+      "d5fcfe2fcf6b3ef375ede37c8123d9b78065fecc1d55197e2f7721e6e9a93d0b"
+      "a4d7fd15f9b96dea2744df24141ba2ef" },
+    { L"SHA-384", 128,
+      "ca2385773319124534111a36d0581fc3f00815e907034b90cff9c3a861e126a7"
+      "41d5dfcff65a417b6d7296863ac0ec17" },
+    { L"SHA-384", 129,
+      "ef49ae5b9ad51433d00323528d81ea8d2e4d2b507dbd9f1cb84f952b66249a78"
+      "8b1c89fcdb77a0db9f1feb901d47fc73" },
+    { L"SHA-384", 239,
+      "2556cf077a788c49bb6d600f4a3cee635c4443832d169f761537afee2980742b"
+      "9f34afbc87f598dd0aedc4a826ed6a73" },
+    { L"SHA-384", 240,
+      "d64769ad58f5a338669b935f3431e5bef31667d0a2437bff78f1e5275075f434"
+      "fff675f9833ea04ac4e5c2e2c2c99b8c" },
+    { L"SHA-384", 255,
+      "0ba9892ce126be582d86f75cd5e682092525cc6a232c5d8b83ce4b8b0eefd644"
+      "a14cb58c7989108d90a16a99325e99b5" },
+    { L"SHA-384", 256,
+      "2786ae11483c719dcb61b32652daf932d7c304f0d5d1e3904f6be6b44826d94d"
+      "e4fc922065558ad6aa10ae8b9eba005d" },
+    { L"SHA-384", 1000,
+      "7a2f8c7f12344964a13cb9260492b845e56615d6152b9eb9e54b580fc88405e6"
+      "4f31813bfda10de2a642fdf1676c61b4" },
+    { L"SHA-384", 65539,
+      "05003a86c53ccd0ecd8819b1a958b5bd9c66b9566d6196e5921bcf1bcd36bcc6"
+      "058cc5540eba3840165bdfbdfe2b67f6" },
+    /* SHA-512 */
+    { L"SHA-512", 0,
+      "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce"
+      "47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e" },
+    { L"SHA-512", 3,
+      "8081da5f9c1e3d0e1aa16f604d5e5064543cff5d7bace2bb312252461e151b3f"
+      "e0f034ea8dc1dacff3361a892d625fbe1b614cda265f87a473c24b0fa1d91dfd" },
+    { L"SHA-512", 111,
+      "a1a111449b198d9b1f538bad7f3fc1022b3a5b1a5e90a0bc860de8512746cbc3"
+      "1599e6c834de3a3235327af0b51ff57bf7acf1974a73014d9c3953812edc7c8d" },
+    { L"SHA-512", 112,
+      "c5fbd731d19d2ae1180f001be72c2c1aaba1d7b094b3748880e24593b8e117a7"
+      "50e11c1bd867cc2f96dace8c8b74abd2d5c4f236be444e77d30d1916174070b9" },
+    { L"SHA-512", 127,
+      "eab89674feaa34e27aebeeff3c0a4d70070bb872d5e9f186cf1dbbdee517b6e3"
+      "5724d629ff025a5b07185e911ada7e3c8acf830aa0e4f71777bd2d44f504f7f0" },
+    { L"SHA-512", 128,
+      "1dffd5e3adb71d45d2245939665521ae001a317a03720a45732ba1900ca3b835"
+      "1fc5c9b4ca513eba6f80bc7b1d1fdad4abd13491cb824d61b08d8c0e1561b3f7" },
+    { L"SHA-512", 129,
+      "1d9da57fbbdab09afb3506ab2d223d06109d65c1c8ad197f50138f714bc4c3f2"
+      "fe5787922639c680acad1c651f955990425954ce2cba0c5cc83f2667d878eb0f" },
+    { L"SHA-512", 239,
+      "cb4c7fd522756d5781ad3a4f590a1d862906b960e7720136cb3fb36b563caa1e"
+      "a5689134291fa79c80ccc2b4092b41df32ebdcb36dbe79db483440228c1622a8" },
+    { L"SHA-512", 240,
+      "6c48466c9f6c07e4ab762c696b7eeb35cfe236fca73683e5fab873ac3489b4d2"
+      "eb3d7afcce7e8165dbbf37aded3b5b0c889c0b7e0f1790a8330d8677429d91a5" },
+    { L"SHA-512", 255,
+      "e9746a5516961da1fdc8e6c59350cd147b7d80c120cc7ed621399faeb2462c28"
+      "f34217a13009a8e6a721f538356db9a9b64d9a5412e0fd07d24cac1315d95548" },
+    { L"SHA-512", 256,
+      "7ff1cd1e9773a4b7ba1f40e642db0d879bd5f6cc151a7d3401a0bc7778b8270c"
+      "108b530fb195f2383f4cec8cf05778e6af4db56811673371674cec1524488f83" },
+    { L"SHA-512", 1000,
+      "5096498d96f50f9a137c4db5b8b0cd38383ad55350fb5a98805fedc31fa1262f"
+      "1f0cf4d6f12d7ecd8dedd933a4c9126344fe22e937a8ad35fdeae1e876ae698b" },
+    { L"SHA-512", 65539,
+      "eeb8e5d7bb7f2c2631725a7f527481a4d7c8596fd20b2fb9c9f97820f6620fde"
+      "b40e62e80b04cbc03776f8e43e3eddbe641543785bf284c17cd93970116f4e96" },
+    /* SHA-512/256 */
+    { L"SHA-512/256", 0,
+      "c672b8d1ef56ed28ab87c3622c5114069bdd3ad7b8f9737498d0c01ecef0967a" },
+    { L"SHA-512/256", 3,
+      "daca0762a6678e4e26cb8a893d71d72cf3239e29cc837629590b84625dec14af" },
+    { L"SHA-512/256", 111,
+      "bd209f60b0d04102a09175297fd255367e54b5a5605b928635c606306914363f" },
+    { L"SHA-512/256", 112,
+      "2cafeb0882cc405167e9a255b8581a66dc683212474902dd453dbca20a94e61a" },
+    { L"SHA-512/256", 127,
+      "c26bc7e9315e62ab0dc6aeb577724d07c09b0c6fdfc0a9f08d8548047c032248" },
+    { L"SHA-512/256", 128,
+      "2ff11194b2aec1f943cb5f130ba647c151334068083194d7281a55d607ae255f" },
+    { L"SHA-512/256", 129,
+      "c4a3bbf841ed2a289e5109fb392229c80db61c72fd92079b5a4f0441f095a111" },
+    { L"SHA-512/256", 239,
+      "b81472d255d80182e196481e5866aa207761a152302a0237e242eb88c577a428" },
+    { L"SHA-512/256", 240,
+      "6ca13c55886b74a5ca2ac9782c4b9a49fe3aeeefdfc0cefc34984872fb4c54fd" },
+    { L"SHA-512/256", 255,
+      "282a7af172c05b48cb02870d79ec5bc32fc2c6fd32d237d9b84728b6c36d2ed1" },
+    { L"SHA-512/256", 256,
+      "0ea4199eb79185d8198973ee464a7e0eb26345b54b361ac6af8b1dc10d41911c" },
+    { L"SHA-512/256", 1000,
+      "974bc1ca87fcb8f487f65a650d1eeeebdc0cc269381b9eeb708cc4ea6d4954f2" },
+    { L"SHA-512/256", 65539,
+      "96e06c9e51b32df129b8d3e3c75a0976129a2a061c357d8a73c0c42a1a317063" },
+
+    /* CRC-32C */
+    { L"CRC-32C", 0,
+      "00000000" },
+    { L"CRC-32C", 1,
+      "527d5351" },
+    { L"CRC-32C", 3,
+      "92fd4bfa" },
+    { L"CRC-32C", 4,
+      "d9331aa3" },
+    { L"CRC-32C", 8,
+      "8a2cbc3b" },
+    { L"CRC-32C", 9,
+      "7144c5a8" },
+    { L"CRC-32C", 16,
+      "d9c908eb" },
+    { L"CRC-32C", 17,
+      "38435e17" },
+    { L"CRC-32C", 128,
+      "30d9c515" },
+    { L"CRC-32C", 129,
+      "f514629f" },
+    { L"CRC-32C", 240,
+      "9f4f71d6" },
+    { L"CRC-32C", 241,
+      "54fe7516" },
+    { L"CRC-32C", 1000,
+      "11f66220" },
+    { L"CRC-32C", 1024,
+      "2af62c0c" },
+    { L"CRC-32C", 65539,
+      "0a384f83" },
+    /* XXH3 */
+    { L"XXH3", 0,
+      "2d06800538d394c2" },
+    { L"XXH3", 1,
+      "c44bdff4074eecdb" },
+    { L"XXH3", 3,
+      "5f4299fc161c9cbb" },
+    { L"XXH3", 4,
+      "60dab036a58211f2" },
+    { L"XXH3", 8,
+      "3a1c2d7c85af88f8" },
+    { L"XXH3", 9,
+      "e9612598145bb9dc" },
+    { L"XXH3", 16,
+      "8355e3a6f61770db" },
+    { L"XXH3", 17,
+      "9ef341a99de37328" },
+    { L"XXH3", 128,
+      "85c6174c7ff4c46b" },
+    { L"XXH3", 129,
+      "ec7642b431ba3e5a" },
+    { L"XXH3", 240,
+      "375a384d957fe865" },
+    { L"XXH3", 241,
+      "02e8cd95421c6d02" },
+    { L"XXH3", 1000,
+      "33ef703fb2b20ed1" },
+    { L"XXH3", 1024,
+      "e5d78bafa45b2aa5" },
+    { L"XXH3", 65539,
+      "afe3c94f82eba3b7" },
+    /* XXH128 */
+    { L"XXH128", 0,
+      "99aa06d3014798d86001c324468d497f" },
+    { L"XXH128", 1,
+      "a6cd5e9392000f6ac44bdff4074eecdb" },
+    { L"XXH128", 3,
+      "e3b55f57945a17cf5f4299fc161c9cbb" },
+    { L"XXH128", 4,
+      "eb70bf5fc779e9e6a6111d53e80a3db5" },
+    { L"XXH128", 8,
+      "e1e4432a62217fe4cfd50c61c8bb98c1" },
+    { L"XXH128", 9,
+      "16c769d83e4aebce907931979dca3746" },
+    { L"XXH128", 16,
+      "72950631827607e2842812cc870dcae2" },
+    { L"XXH128", 17,
+      "685bc458b37d057fc06e233df7729217" },
+    { L"XXH128", 128,
+      "14792fc3af88dc6c05321a0b64d67b41" },
+    { L"XXH128", 129,
+      "dd5e74ac6b45f54ebc30b63382b09a3b" },
+    { L"XXH128", 240,
+      "65b5be86da5540e7c92b68e16f83bbb6" },
+    { L"XXH128", 241,
+      "1da1cb61bcb8a2a102e8cd95421c6d02" },
+    { L"XXH128", 1000,
+      "18bf41bc8229e27733ef703fb2b20ed1" },
+    { L"XXH128", 1024,
+      "d0ac1f7b93bf57b9e5d78bafa45b2aa5" },
+    { L"XXH128", 65539,
+      "7a9866c7279ffea8afe3c94f82eba3b7" },
+
+    /* BLAKE2b */
+    { L"BLAKE2b", 0,
+      "786a02f742015903c6c6fd852552d272912f4740e15847618a86e217f71f5419"
+      "d25e1031afee585313896444934eb04b903a685b1448b755d56f701afe9be2ce" },
+    { L"BLAKE2b", 1,
+      "2fa3f686df876995167e7c2e5d74c4c7b6e48f8068fe0e44208344d480f7904c"
+      "36963e44115fe3eb2a3ac8694c28bcb4f5a0f3276f2e79487d8219057a506e4b" },
+    { L"BLAKE2b", 63,
+      "d10bf9a15b1c9fc8d41f89bb140bf0be08d2f3666176d13baac4d381358ad074"
+      "c9d4748c300520eb026daeaea7c5b158892fde4e8ec17dc998dcd507df26eb63" },
+    { L"BLAKE2b", 64,
+      "2fc6e69fa26a89a5ed269092cb9b2a449a4409a7a44011eecad13d7c4b045660"
+      "2d402fa5844f1a7a758136ce3d5d8d0e8b86921ffff4f692dd95bdc8e5ff0052" },
+    { L"BLAKE2b", 65,
+      "fcbe8be7dcb49a32dbdf239459e26308b84dff1ea480df8d104eeff34b46fae9"
+      "8627b450c2267d48c0946a697c5b59531452ac0484f1c84e3a33d0c339bb2e28" },
+    { L"BLAKE2b", 127,
+      "b6292669ccd38d5f01caae96ba272c76a879a45743afa0725d83b9ebb26665b7"
+      "31f1848c52f11972b6644f554c064fa90780dbbbf3a89d4fc31f67df3e5857ef" },
+    { L"BLAKE2b", 128,
+      "2319e3789c47e2daa5fe807f61bec2a1a6537fa03f19ff32e87eecbfd64b7e0e"
+      "8ccff439ac333b040f19b0c4ddd11a61e24ac1fe0f10a039806c5dcc0da3d115" },
+    { L"BLAKE2b", 129,
+      "f59711d44a031d5f97a9413c065d1e614c417ede998590325f49bad2fd444d3e"
+      "4418be19aec4e11449ac1a57207898bc57d76a1bcf3566292c20c683a5c4648f" },
+    { L"BLAKE2b", 255,
+      "fe2c02da499516b0e9fb2dd70c49eb3629039f632e20a880946fb7bc97a7ab09"
+      "deb7d48774d7f0648141c9d9ede19ae6e0dbf07863a128cf4b00195f0f179f74" },
+    { L"BLAKE2b", 256,
+      "93463ac058b6163eb43be3f5bb32b28541498f4e3366f1effe253ad44e1e076e"
+      "41c3616046027c82a7124f8f4746668ad10b12e8e25a95ac8f3151df01cd5a93" },
+    { L"BLAKE2b", 511,
+      "1b4f20f55a9a973172babeb97dbf2b36c0ac86b08a7371fbc2aa66bbead4fc53"
+      "dbe4a9342494bb3911971c6a7a1a06e5c4432c9c202adcb84137e83d09699a5b" },
+    { L"BLAKE2b", 512,
+      "57cfa337c698dfb59527a8c569c96f90cd0a87420b1073b7ae83b9556f9523de"
+      "001f45c384c33f74f5076b6ab0c14910c345e410b6df084ca83b519d5cb35f33" },
+    { L"BLAKE2b", 513,
+      "852267f9bb00f298f5bee46f5a6aecec28262f25450f31915c1c765732800b82"
+      "88232c93313a08dd7be7820d097b8e0bef5737106ad6acb4b73cbc3cbea3c9e4" },
+    { L"BLAKE2b", 1000,
+      "c11e1c0340bd7e5a1b275f1230c962fad215ecb1391486e74e31b960a2f29963"
+      "81a5fad092da06841d5f26e38f6ecfeaf441acbcd1c2de61aef121e7927175f5" },
+    { L"BLAKE2b", 4096,
+      "c7a3d6a53bd11772ecf077c1dc9633a39c6fe691ec07a530e0e765c0a9d5a01a"
+      "16f00995536578b83e54c2821766ac7ac6ae86e22269a5d14208ccac954cc95f" },
+    { L"BLAKE2b", 65539,
+      "1d8d93af49e5b1083b36b7caae908619a07cc00b4718655aef6dfb90740aa1e6"
+      "96df1d5e624e91ef009f254f7df9b12d1c56e2a712ff79093e1b34bd291e5d21" },
+    /* BLAKE2sp */
+    { L"BLAKE2sp", 0,
+      "dd0e891776933f43c7d032b08a917e25741f8aa9a12c12e1cac8801500f2ca4f" },
+    { L"BLAKE2sp", 1,
+      "a6b9eecc25227ad788c99d3f236debc8da408849e9a5178978727a81457f7239" },
+    { L"BLAKE2sp", 63,
+      "1024c940be7341449b5010522b509f65bbdc1287b455c2bb7f72b2c92fd0d189" },
+    { L"BLAKE2sp", 64,
+      "52603b6cbfad4966cb044cb267568385cf35f21e6c45cf30aed19832cb51e9f5" },
+    { L"BLAKE2sp", 65,
+      "fff24d3cc729d395daf978b0157306cb495797e6c8dca1731d2f6f81b849baae" },
+    { L"BLAKE2sp", 127,
+      "a626543c271fccc3e4450b48d66bc9cbdeb25e5d077a6213cd90cbbd0fd22076" },
+    { L"BLAKE2sp", 128,
+      "05cf3a90049116dc60efc31536aaa3d167762994892876dcb7ef3fbecd7449c0" },
+    { L"BLAKE2sp", 129,
+      "ccd61c926cc1e5e9128c021c0c6e92aefc4ffbde394dd6f3b7d87a8ced896014" },
+    { L"BLAKE2sp", 255,
+      "3aafcdc0f0ec17f0d35db5dae359b9fa2045f4ed5af4e708bd3b8817e1722d21" },
+    { L"BLAKE2sp", 256,
+      "d1b35d04c0849d6dc758990229c9539784b9e9a8592aa5db63b7cb424ac7105c" },
+    { L"BLAKE2sp", 511,
+      "8e1e8ee1ffa0a01028fff3bff0ae9df2565a82e55a04e9541bb78b9c4778336f" },
+    { L"BLAKE2sp", 512,
+      "8d9e357863298dd8364b7caf4234317f8a49f180d788b7abffb521925f1e1ff1" },
+    { L"BLAKE2sp", 513,
+      "8a4bc3330497e681f15daf24fc496044a1c32bf0a837a210399e1ae4af7e92be" },
+    { L"BLAKE2sp", 1000,
+      "611f1af6610cdaf674ec2c9178f6376ebe234ef50998a3be3f1fa698fb779274" },
+    { L"BLAKE2sp", 4096,
+      "dd02c617ddc87d204cbcb5795b637368467fa516710f880e9c782b00b0dca78c" },
+    { L"BLAKE2sp", 65539,
+      "3eb2d0f7f06f392f5ac96c3120a879701bc2378cba019a2a31e1f53ee6c5e5d3" },
+
+    /* SHA3-256 */
+    { L"SHA3-256", 0,
+      "a7ffc6f8bf1ed76651c14756a061d662f580ff4de43b49fa82d80a4b80f8434a" },
+    { L"SHA3-256", 1,
+      "5d53469f20fef4f8eab52b88044ede69c77a6a68a60728609fc4a65ff531e7d0" },
+    { L"SHA3-256", 71,
+      "881ad9ffbd7f090efa51cbdfe93da23a0401f4446f7adf150d1c226851cbfff2" },
+    { L"SHA3-256", 72,
+      "fe58866b2893c6c40ee832ce40fb6eb4c70ff7c4794380d95c2ebeec62decd31" },
+    { L"SHA3-256", 73,
+      "797061b3aad8e724740c79dc697ef3de4c96c4db4483dba4e56f852222c72474" },
+    { L"SHA3-256", 135,
+      "fded8fd9d6551c601eeb3b7c6bc5e5cfd8aad1d015b7e9aaa9c9b9475231d5e2" },
+    { L"SHA3-256", 136,
+      "cf3ccff92480a29160c2d38317c430e14749bfee1788106957dfe73f8c4930e5" },
+    { L"SHA3-256", 137,
+      "ce9d7dc90913ee5d92745019479a5352c6d6279bef18ed07dc0a83ee8084daca" },
+    { L"SHA3-256", 143,
+      "295fef4d46110ee21fba0d1798a1bb7c1bbc88306bc9b7661b18ace7170f02ae" },
+    { L"SHA3-256", 144,
+      "a32aeb728cd50069f906559158f1d0a9df3a8c6795e5cbafde00c632f08bade3" },
+    { L"SHA3-256", 271,
+      "0153fcdb6825d836b10835ccb3999dc1d8b68492f77e7e38afa31f8e244bd7af" },
+    { L"SHA3-256", 272,
+      "b7ccd55b6c2c3fa144c9e0624059294975a348b02f321abe289701d3012f7794" },
+    { L"SHA3-256", 1000,
+      "48e66a01861d0eadaacdb7a6ae7db6b9ac79242ecced4154a9fbb33c4e3cc571" },
+    { L"SHA3-256", 65539,
+      "6f79ffe144b7e9b57b856822d4ee5ee4def7e0147c90408dbbd8a7fd9fad6589" },
+    /* SHA3-512 */
+    { L"SHA3-512", 0,
+      "a69f73cca23a9ac5c8b567dc185a756e97c982164fe25859e0d1dcc1475c80a6"
+      "15b2123af1f5f94c11e3e9402c3ac558f500199d95b6d3e301758586281dcd26" },
+    { L"SHA3-512", 1,
+      "7127aab211f82a18d06cf7578ff49d5089017944139aa60d8bee057811a15fb5"
+      "5a53887600a3eceba004de51105139f32506fe5b53e1913bfa6b32e716fe97da" },
+    { L"SHA3-512", 71,
+      "3ccc850d53a1287af7b4560b2ef0d43eb5d9a80d62a0e9cf1dbc040135921104"
+      "d4395168e90bfc871773ebb34bca1bd67056e1cc7dc7a48ff7c3167d389f117c" },
+    { L"SHA3-512", 72,
+      "5d63f2bbe971a983ac6847480106e4e1264ee3a0befd79954914e1d86e795b2e"
+      "18238f12fc5e46cb9cc78efdec610a93647cc04e1c23d8caaa6a58c21dd26c07" },
+    { L"SHA3-512", 73,
+      "921d9b7b2b0f3066a1646dbb058c979cb3925dec0f8c269faaa7f9648e73465a"
+      "e55ec527257d5d5e1cfdbf5d6799bea1004b6186f5108c74e3b92fe924166558" },
+    { L"SHA3-512", 135,
+      "d942df0df09ac042cd3b641144c98d8fda0980bb037fc5c0e7f2e9a073b073dc"
+      "4bb8a8c1f4cb5b45f5805c6523741ed0571d6779b15829b2faa280fc60b50645" },
+    { L"SHA3-512", 136,
+      "ad8edff4f1b7aa1c63bbe49728ab9b165f7245b3d7102e6f99c261fc15d2d0bf"
+      "6afef6a491720454a1349fbf5d848854875ac83a1156fd7f6e2a37af26c07fb2" },
+    { L"SHA3-512", 137,
+      "3f827e5d7ddbd54ea1dba28cae0154eb5ff8d8d973770865861b7cdf5f091040"
+      "889d55c0e74b672cead274fac1d4a559fd9185be898ab8969b5e78681527660d" },
+    { L"SHA3-512", 143,
+      "eb9748309c6b70ffe82820052ad26ea99f43968d2af359adc804b2a76741a62e"
+      "a8d710f018ea113c2259d0bd6687e3838602ae6c1dff727ae985f059141c7217" },
+    { L"SHA3-512", 144,
+      "e1951b8bcb58ca75a34af80a7a2b765cad4257fe383a79b55bf21f180b75f6e5"
+      "b08f09598851eeea7d13486387618d6c6bf88cf23c0088a3f783f59a06d60493" },
+    { L"SHA3-512", 271,
+      "c0fb7dd03978aab87c5bbb9c58281204f5ec30b77d50cf53b20d6caf04659edb"
+      "2e006a1f539cb3b9e7edfb2d8ec20fcba0585823fbed4179810554a6700d4486" },
+    { L"SHA3-512", 272,
+      "bf2a338b73a027c9a73495b80c0434f17dc7146f4a3a2fb1c7d2b0abd1defeb2"
+      "f0d838e9e39c0bb3e3197662359ad654bba11907b2d993857e3fe15458b7ca2f" },
+    { L"SHA3-512", 1000,
+      "b8030d306ae990bc794bfb3a6100f67851889d6c272257afac7d1077a18660d6"
+      "ea8d0da5d2299c3ebaa0d34baf62cc58ac1fd4476506cf512a4897bb083a6fc4" },
+    { L"SHA3-512", 65539,
+      "3123f2f9460e2383014c6e553ab81afbf8162fe2cf8a757a8e2d21ef4e927014"
+      "bbb1673d8b9dd2598f68c86132dba40b66598caa188a490b1dc6ce2b38bfbb8b" }
+};
+
+static unsigned char test_data[TEST_MAX_DATA_SIZE];
+
+/* Every hasher but CRC-32C counts the hashed bytes in its state. */
+static BOOL is_hashed_size_in_state = FALSE;
+
+static
+void
+uhashtools_test_fill_pattern
+(
+    void
+)
+{
+    size_t data_index = 0;
+
+    for (data_index = 0; data_index < TEST_MAX_DATA_SIZE; ++data_index)
+    {
+        test_data[data_index] = (unsigned char) (data_index % 251);
+    }
+}
+
+/*
+ * Hashes the data with updates of random sizes up to "max_update_size".
+ * The state is moved to another buffer between the updates like the
+ * resume of a hash calculation loads it from a state file.
+ */
+static
+void
+uhashtools_test_hash_data
+(
+    const unsigned char* data,
+    size_t data_size,
+    size_t max_update_size,
+    unsigned char* digest
+)
+{
+    const size_t state_size = uhashtools_product_get_builtin_hasher_state_size();
+    void* state = malloc(state_size);
+    void* moved_state = malloc(state_size);
+    size_t hashed_size = 0;
+
+    UHASHTOOLS_TEST_CHECK(state && moved_state);
+
+    uhashtools_product_builtin_hasher_init(state);
+    UHASHTOOLS_TEST_CHECK(uhashtools_product_builtin_hasher_is_state_valid(state, 0));
+
+    while (hashed_size < data_size)
+    {
+        size_t update_size = data_size - hashed_size;
+
+        if (update_size > max_update_size)
+        {
+            update_size = (size_t) (uhashtools_test_random() % max_update_size) + 1;
+        }
+
+        uhashtools_product_builtin_hasher_update(state, data + hashed_size, update_size);
+        hashed_size += update_size;
+
+        UHASHTOOLS_TEST_CHECK(uhashtools_product_builtin_hasher_is_state_valid(state, hashed_size));
+        UHASHTOOLS_TEST_CHECK(!is_hashed_size_in_state ||
+                              !uhashtools_product_builtin_hasher_is_state_valid(state, hashed_size + 1));
+
+        (void) memcpy(moved_state, (const void*) state, state_size);
+        (void) memset(state, 0xCD, state_size);
+        (void) memcpy(state, (const void*) moved_state, state_size);
+    }
+
+    uhashtools_product_builtin_hasher_finish(state, digest);
+
+    free(moved_state);
+    free(state);
+}
+
+static
+void
+uhashtools_test_known_answers
+(
+    const wchar_t* algorithm_name
+)
+{
+    const size_t digest_size = uhashtools_product_get_builtin_hasher_digest_size();
+    unsigned char digest[TEST_MAX_DIGEST_SIZE];
+    char hex_digest[TEST_MAX_DIGEST_SIZE * 2 + 1];
+    size_t vector_index = 0;
+    size_t byte_index = 0;
+    size_t known_answers_count = 0;
+
+    for (vector_index = 0; vector_index < sizeof test_vectors / sizeof test_vectors[0]; ++vector_index)
+    {
+        const struct TestVector* test_vector = &test_vectors[vector_index];
+
+        if (wcscmp(test_vector->algorithm_name, algorithm_name) != 0)
+        {
+            continue;
+        }
+
+        ++known_answers_count;
+        UHASHTOOLS_TEST_CHECK(strlen(test_vector->expected_hex_digest) == digest_size * 2);
+
+        /* Once in a single update and once in updates of random sizes up to 128 bytes. */
+        uhashtools_test_hash_data(test_data, test_vector->pattern_size, TEST_MAX_DATA_SIZE, digest);
+
+        for (byte_index = 0; byte_index < digest_size; ++byte_index)
+        {
+            (void) sprintf(hex_digest + byte_index * 2, "%02x", digest[byte_index]);
+        }
+
+        if (strcmp(hex_digest, test_vector->expected_hex_digest) != 0)
+        {
+            (void) printf("%ls of %lu bytes: Expected %s, got %s.\n",
+                          algorithm_name,
+                          (unsigned long) test_vector->pattern_size,
+                          test_vector->expected_hex_digest,
+                          hex_digest);
+            UHASHTOOLS_TEST_CHECK(strcmp(hex_digest, test_vector->expected_hex_digest) == 0);
+        }
+
+        uhashtools_test_hash_data(test_data, test_vector->pattern_size, 128, digest);
+
+        for (byte_index = 0; byte_index < digest_size; ++byte_index)
+        {
+            (void) sprintf(hex_digest + byte_index * 2, "%02x", digest[byte_index]);
+        }
+
+        UHASHTOOLS_TEST_CHECK(strcmp(hex_digest, test_vector->expected_hex_digest) == 0);
+    }
+
+    UHASHTOOLS_TEST_CHECK(known_answers_count > 0);
+}
+
+/* The digest mustn't depend on how the data is split into updates. */
+static
+void
+uhashtools_test_random_splits
+(
+    void
+)
+{
+    const size_t digest_size = uhashtools_product_get_builtin_hasher_digest_size();
+    unsigned char expected_digest[TEST_MAX_DIGEST_SIZE];
+    unsigned char digest[TEST_MAX_DIGEST_SIZE];
+    size_t split_index = 0;
+
+    for (split_index = 0; split_index < TEST_RANDOM_SPLITS_COUNT; ++split_index)
+    {
+        const size_t data_offset = (size_t) (uhashtools_test_random() % 64);
+        const size_t data_size = split_index + 1 == TEST_RANDOM_SPLITS_COUNT ? TEST_MAX_DATA_SIZE - data_offset
+                                                                             : (size_t) (uhashtools_test_random() % 5000);
+        const size_t max_update_size = (size_t) (uhashtools_test_random() % 1100) + 1;
+
+        /* Unaligned data as well, the built-in hashers mustn't expect aligned input. */
+        uhashtools_test_hash_data(test_data + data_offset, data_size, TEST_MAX_DATA_SIZE, expected_digest);
+        uhashtools_test_hash_data(test_data + data_offset, data_size, max_update_size, digest);
+
+        if (memcmp((const void*) digest, (const void*) expected_digest, digest_size) != 0)
+        {
+            (void) printf("Digest of %lu bytes at offset %lu differs with updates of up to %lu bytes.\n",
+                          (unsigned long) data_size,
+                          (unsigned long) data_offset,
+                          (unsigned long) max_update_size);
+            UHASHTOOLS_TEST_CHECK(memcmp((const void*) digest, (const void*) expected_digest, digest_size) == 0);
+        }
+    }
+}
+
+int
+main
+(
+    void
+)
+{
+    const wchar_t* algorithm_name = uhashtools_product_get_mainwin_title() + 1;
+    char test_name[64];
+
+#if defined(_M_X64)
+    (void) sprintf(test_name, "test_builtin_hasher (%ls, x64)", algorithm_name);
+#else
+    (void) sprintf(test_name, "test_builtin_hasher (%ls)", algorithm_name);
+#endif
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_product_get_builtin_hasher_digest_size() <= TEST_MAX_DIGEST_SIZE);
+
+    is_hashed_size_in_state = wcscmp(algorithm_name, L"CRC-32C") != 0;
+
+    uhashtools_test_fill_pattern();
+    uhashtools_test_known_answers(algorithm_name);
+    uhashtools_test_random_splits();
+
+    return uhashtools_test_finish(test_name);
+}
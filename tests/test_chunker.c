@@ -0,0 +1,523 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Tests the chunker against a plain byte by byte implementation of the
+ * FastCDC variant described in "chunker.h". The chunks have to be the
+ * same for every average size, data kind and way of splitting the data
+ * into "uhashtools_chunker_feed()" calls. The test is built with the
+ * SHA-256 product and once more with the AVX2 scanner, which MSVC only
+ * builds since Visual Studio 2012 (see "makefile").
+ */
+
+#include "test_utilities.h"
+
+#include "chunker.h"
+#include "product.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_MAX_CHUNKS_COUNT (1024 * 64)
+#define TEST_MAX_DATA_SIZE (1024 * 1024 * 3)
+#define TEST_MAX_AVERAGE_DATA_SIZE (1024 * 1024 * 34)
+
+/* Must match the seed in "chunker.c". */
+#define TEST_GEAR_TABLE_SEED 0x7548617368746F6FULL
+
+enum TestFeedMode
+{
+    /* The whole data in a single call */
+    TEST_FEED_MODE_SINGLE,
+    /* Random parts of up to 200 KB, which cross the scan windows */
+    TEST_FEED_MODE_RANDOM,
+    /* Random parts of up to 7 bytes */
+    TEST_FEED_MODE_TINY,
+    TEST_FEED_MODE_COUNT
+};
+
+struct TestChunkList
+{
+    struct ChunkerChunk chunks[TEST_MAX_CHUNKS_COUNT];
+    size_t chunks_count;
+    /* The callback returns FALSE for the chunk with this index. */
+    size_t failing_chunk_index;
+};
+
+static struct TestChunkList test_expected_chunks;
+static struct TestChunkList test_found_chunks;
+
+static
+BOOL
+uhashtools_test_collect_chunk
+(
+    const struct ChunkerChunk* chunk,
+    void* userdata
+)
+{
+    struct TestChunkList* chunk_list = (struct TestChunkList*) userdata;
+
+    if (chunk_list->chunks_count == chunk_list->failing_chunk_index)
+    {
+        return FALSE;
+    }
+
+    UHASHTOOLS_TEST_CHECK(chunk_list->chunks_count < TEST_MAX_CHUNKS_COUNT);
+
+    if (chunk_list->chunks_count < TEST_MAX_CHUNKS_COUNT)
+    {
+        chunk_list->chunks[chunk_list->chunks_count++] = *chunk;
+    }
+
+    return TRUE;
+}
+
+/* Appends a chunk of the reference implementation, hashed in a single update. */
+static
+void
+uhashtools_test_append_reference_chunk
+(
+    struct TestChunkList* chunk_list,
+    const unsigned char* data,
+    size_t chunk_offset,
+    size_t chunk_size
+)
+{
+    static unsigned char hasher_state[4096];
+    struct ChunkerChunk chunk;
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_product_get_builtin_hasher_state_size() <= sizeof hasher_state);
+
+    (void) memset((void*) &chunk, 0, sizeof chunk);
+
+    chunk.offset = chunk_offset;
+    chunk.size = chunk_size;
+    chunk.digest.size = (unsigned int) uhashtools_product_get_builtin_hasher_digest_size();
+
+    uhashtools_product_builtin_hasher_init(hasher_state);
+    uhashtools_product_builtin_hasher_update(hasher_state, data + chunk_offset, chunk_size);
+    uhashtools_product_builtin_hasher_finish(hasher_state, chunk.digest.bytes);
+
+    (void) uhashtools_test_collect_chunk(&chunk, chunk_list);
+}
+
+/*
+ * Chunks the data byte by byte. The gear hash isn't reset between the
+ * chunks. A chunk of "size" bytes ends behind the current byte if the
+ * small mask matches for sizes from min_size to average_size - 1, if the
+ * large mask matches for sizes from average_size to max_size - 1, or if
+ * it has reached max_size.
+ */
+static
+void
+uhashtools_test_reference_chunks
+(
+    struct TestChunkList* chunk_list,
+    const unsigned char* data,
+    size_t data_size,
+    size_t average_size
+)
+{
+    unsigned __int64 gear_table[256];
+    unsigned __int64 seed = TEST_GEAR_TABLE_SEED;
+    unsigned __int64 gear_hash = 0;
+    unsigned __int64 small_chunk_mask = 0;
+    unsigned __int64 large_chunk_mask = 0;
+    unsigned int average_size_bits = 0;
+    size_t chunk_offset = 0;
+    size_t i = 0;
+
+    /* SplitMix64 */
+    for (i = 0; i < 256; ++i)
+    {
+        unsigned __int64 value = 0;
+
+        seed += 0x9E3779B97F4A7C15ULL;
+        value = seed;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        gear_table[i] = value ^ (value >> 31);
+    }
+
+    while (((size_t) 1 << average_size_bits) < average_size)
+    {
+        ++average_size_bits;
+    }
+
+    small_chunk_mask = _UI64_MAX << (64 - (average_size_bits + 2));
+    large_chunk_mask = _UI64_MAX << (64 - (average_size_bits - 2));
+
+    chunk_list->chunks_count = 0;
+    chunk_list->failing_chunk_index = (size_t) -1;
+
+    for (i = 0; i < data_size; ++i)
+    {
+        const size_t chunk_size = i + 1 - chunk_offset;
+        BOOL is_boundary = FALSE;
+
+        gear_hash = (gear_hash << 1) + gear_table[data[i]];
+
+        if (chunk_size >= average_size / 4 && chunk_size < average_size)
+        {
+            is_boundary = (gear_hash & small_chunk_mask) == 0;
+        }
+        else if (chunk_size >= average_size)
+        {
+            is_boundary = (gear_hash & large_chunk_mask) == 0 || chunk_size == average_size * 8;
+        }
+
+        if (is_boundary)
+        {
+            uhashtools_test_append_reference_chunk(chunk_list, data, chunk_offset, chunk_size);
+            chunk_offset = i + 1;
+        }
+    }
+
+    if (chunk_offset < data_size)
+    {
+        uhashtools_test_append_reference_chunk(chunk_list, data, chunk_offset, data_size - chunk_offset);
+    }
+}
+
+/* Chunks the data with the chunker. */
+static
+BOOL
+uhashtools_test_chunk_data
+(
+    struct TestChunkList* chunk_list,
+    const unsigned char* data,
+    size_t data_size,
+    size_t average_size,
+    enum TestFeedMode feed_mode
+)
+{
+    wchar_t error_message[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    struct Chunker* chunker = NULL;
+    size_t fed_size = 0;
+    BOOL ret = FALSE;
+
+    chunk_list->chunks_count = 0;
+
+    chunker = uhashtools_chunker_create(error_message,
+                                        GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                        average_size,
+                                        &uhashtools_test_collect_chunk,
+                                        chunk_list);
+
+    UHASHTOOLS_TEST_CHECK(chunker != NULL);
+
+    if (!chunker)
+    {
+        return FALSE;
+    }
+
+    while (fed_size < data_size)
+    {
+        size_t feed_size = data_size - fed_size;
+
+        if (feed_mode == TEST_FEED_MODE_RANDOM)
+        {
+            feed_size = (size_t) (uhashtools_test_random() % 200000) + 1;
+        }
+        else if (feed_mode == TEST_FEED_MODE_TINY)
+        {
+            feed_size = (size_t) (uhashtools_test_random() % 7) + 1;
+        }
+
+        if (feed_size > data_size - fed_size)
+        {
+            feed_size = data_size - fed_size;
+        }
+
+        if (!uhashtools_chunker_feed(chunker, data + fed_size, feed_size))
+        {
+            goto cleanup_and_out;
+        }
+
+        /* Empty parts don't change anything. */
+        if (!uhashtools_chunker_feed(chunker, NULL, 0))
+        {
+            goto cleanup_and_out;
+        }
+
+        fed_size += feed_size;
+    }
+
+    ret = uhashtools_chunker_finish(chunker);
+
+cleanup_and_out:
+    uhashtools_chunker_destroy(chunker);
+
+    return ret;
+}
+
+static
+BOOL
+uhashtools_test_are_chunks_equal
+(
+    const struct TestChunkList* expected_chunks,
+    const struct TestChunkList* found_chunks
+)
+{
+    size_t i = 0;
+
+    if (expected_chunks->chunks_count != found_chunks->chunks_count)
+    {
+        (void) printf("Expected %lu chunks, got %lu.\n",
+                      (unsigned long) expected_chunks->chunks_count,
+                      (unsigned long) found_chunks->chunks_count);
+        return FALSE;
+    }
+
+    for (i = 0; i < expected_chunks->chunks_count; ++i)
+    {
+        const struct ChunkerChunk* expected_chunk = &expected_chunks->chunks[i];
+        const struct ChunkerChunk* found_chunk = &found_chunks->chunks[i];
+
+        if (expected_chunk->offset != found_chunk->offset ||
+            expected_chunk->size != found_chunk->size ||
+            expected_chunk->digest.size != found_chunk->digest.size ||
+            memcmp(expected_chunk->digest.bytes, found_chunk->digest.bytes, expected_chunk->digest.size) != 0)
+        {
+            (void) printf("Chunk %lu differs: expected offset %lu and size %lu, got offset %lu and size %lu.\n",
+                          (unsigned long) i,
+                          (unsigned long) expected_chunk->offset,
+                          (unsigned long) expected_chunk->size,
+                          (unsigned long) found_chunk->offset,
+                          (unsigned long) found_chunk->size);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/* Checks that the reference chunks cover the data and keep the size limits. */
+static
+void
+uhashtools_test_check_reference_chunks
+(
+    const struct TestChunkList* chunk_list,
+    size_t data_size,
+    size_t average_size
+)
+{
+    unsigned __int64 offset = 0;
+    size_t i = 0;
+
+    for (i = 0; i < chunk_list->chunks_count; ++i)
+    {
+        const struct ChunkerChunk* chunk = &chunk_list->chunks[i];
+
+        UHASHTOOLS_TEST_CHECK(chunk->offset == offset);
+        UHASHTOOLS_TEST_CHECK(chunk->size > 0 && chunk->size <= average_size * 8);
+        UHASHTOOLS_TEST_CHECK(chunk->size >= average_size / 4 || i + 1 == chunk_list->chunks_count);
+
+        offset += chunk->size;
+    }
+
+    UHASHTOOLS_TEST_CHECK(offset == data_size);
+}
+
+static
+void
+uhashtools_test_chunks
+(
+    const unsigned char* data,
+    size_t data_size,
+    size_t average_size,
+    const char* data_description
+)
+{
+    int feed_mode = 0;
+
+    uhashtools_test_reference_chunks(&test_expected_chunks, data, data_size, average_size);
+    uhashtools_test_check_reference_chunks(&test_expected_chunks, data_size, average_size);
+
+    for (feed_mode = 0; feed_mode < TEST_FEED_MODE_COUNT; ++feed_mode)
+    {
+        /* Tiny parts take long for big data. */
+        if (feed_mode == TEST_FEED_MODE_TINY && data_size > 1024 * 300)
+        {
+            continue;
+        }
+
+        test_found_chunks.failing_chunk_index = (size_t) -1;
+
+        if (!uhashtools_test_chunk_data(&test_found_chunks, data, data_size, average_size, (enum TestFeedMode) feed_mode) ||
+            !uhashtools_test_are_chunks_equal(&test_expected_chunks, &test_found_chunks))
+        {
+            (void) printf("Chunking %lu bytes of %s with an average size of %lu in feed mode %d failed.\n",
+                          (unsigned long) data_size,
+                          data_description,
+                          (unsigned long) average_size,
+                          feed_mode);
+            UHASHTOOLS_TEST_CHECK(!"Chunks differ from the reference.");
+        }
+    }
+}
+
+static
+void
+uhashtools_test_data_kinds
+(
+    unsigned char* data
+)
+{
+    static const char* const data_kind_names[TEST_DATA_KIND_COUNT] = { "random data", "text", "zeros", "repeats" };
+    static const size_t data_sizes[] = { 0, 1, 255, 256, 4095, 4096, 65536, 65600, 1024 * 300, TEST_MAX_DATA_SIZE };
+    static const size_t average_sizes[] = { CHUNKER_MIN_AVERAGE_SIZE, 1024 * 8, 1024 * 64 };
+    int data_kind = 0;
+    size_t size_index = 0;
+    size_t average_index = 0;
+
+    for (data_kind = 0; data_kind < TEST_DATA_KIND_COUNT; ++data_kind)
+    {
+        uhashtools_test_fill_data((enum TestDataKind) data_kind, data, TEST_MAX_DATA_SIZE);
+
+        for (size_index = 0; size_index < sizeof data_sizes / sizeof data_sizes[0]; ++size_index)
+        {
+            for (average_index = 0; average_index < sizeof average_sizes / sizeof average_sizes[0]; ++average_index)
+            {
+                uhashtools_test_chunks(data,
+                                       data_sizes[size_index],
+                                       average_sizes[average_index],
+                                       data_kind_names[data_kind]);
+            }
+        }
+    }
+}
+
+/* The largest average size, the forced boundaries of zeros lie 32 MiB apart. */
+static
+void
+uhashtools_test_max_average_size
+(
+    void
+)
+{
+    unsigned char* data = (unsigned char*) malloc(TEST_MAX_AVERAGE_DATA_SIZE);
+
+    UHASHTOOLS_TEST_CHECK(data != NULL);
+
+    if (!data)
+    {
+        return;
+    }
+
+    uhashtools_test_fill_data(TEST_DATA_KIND_ZEROS, data, TEST_MAX_AVERAGE_DATA_SIZE);
+    uhashtools_test_chunks(data, TEST_MAX_AVERAGE_DATA_SIZE, CHUNKER_MAX_AVERAGE_SIZE, "zeros");
+    UHASHTOOLS_TEST_CHECK(test_expected_chunks.chunks_count == 2);
+
+    uhashtools_test_fill_data(TEST_DATA_KIND_RANDOM, data, TEST_MAX_AVERAGE_DATA_SIZE);
+    uhashtools_test_chunks(data, TEST_MAX_AVERAGE_DATA_SIZE, CHUNKER_MAX_AVERAGE_SIZE, "random data");
+
+    free(data);
+}
+
+/* Inserting data only changes the chunks around the insertion. */
+static
+void
+uhashtools_test_insertion
+(
+    unsigned char* data
+)
+{
+    static const unsigned char inserted_data[] = "inserted";
+    const size_t data_size = 1024 * 1024;
+    const size_t insert_offset = data_size / 2;
+    const size_t average_size = 1024 * 8;
+    size_t i = 0;
+    size_t j = 0;
+
+    uhashtools_test_fill_data(TEST_DATA_KIND_RANDOM, data, data_size);
+    (void) uhashtools_test_chunk_data(&test_expected_chunks, data, data_size, average_size, TEST_FEED_MODE_SINGLE);
+
+    (void) memmove((void*) (data + insert_offset + sizeof inserted_data),
+                   (const void*) (data + insert_offset),
+                   data_size - insert_offset);
+    (void) memcpy((void*) (data + insert_offset), (const void*) inserted_data, sizeof inserted_data);
+    (void) uhashtools_test_chunk_data(&test_found_chunks, data, data_size + sizeof inserted_data, average_size, TEST_FEED_MODE_RANDOM);
+
+    /* The chunks in front of the insertion stay the same. */
+    for (i = 0; i < test_expected_chunks.chunks_count && test_expected_chunks.chunks[i].offset + test_expected_chunks.chunks[i].size <= insert_offset; ++i)
+    {
+        UHASHTOOLS_TEST_CHECK(i < test_found_chunks.chunks_count &&
+                              memcmp(test_expected_chunks.chunks[i].digest.bytes,
+                                     test_found_chunks.chunks[i].digest.bytes,
+                                     test_expected_chunks.chunks[i].digest.size) == 0);
+    }
+
+    /* Further behind it the chunks are the same again, only moved by the inserted bytes. */
+    for (; i < test_expected_chunks.chunks_count && test_expected_chunks.chunks[i].offset < insert_offset + average_size * 16; ++i)
+    {
+    }
+
+    for (j = 0; j < test_found_chunks.chunks_count && test_found_chunks.chunks[j].offset < insert_offset + average_size * 16; ++j)
+    {
+    }
+
+    UHASHTOOLS_TEST_CHECK(test_expected_chunks.chunks_count - i == test_found_chunks.chunks_count - j);
+
+    for (; i < test_expected_chunks.chunks_count && j < test_found_chunks.chunks_count; ++i, ++j)
+    {
+        UHASHTOOLS_TEST_CHECK(test_expected_chunks.chunks[i].offset + sizeof inserted_data == test_found_chunks.chunks[j].offset &&
+                              memcmp(test_expected_chunks.chunks[i].digest.bytes,
+                                     test_found_chunks.chunks[j].digest.bytes,
+                                     test_expected_chunks.chunks[i].digest.size) == 0);
+    }
+}
+
+/* A callback returning FALSE lets the call fail which has found the chunk. */
+static
+void
+uhashtools_test_failing_callback
+(
+    unsigned char* data
+)
+{
+    uhashtools_test_fill_data(TEST_DATA_KIND_RANDOM, data, TEST_MAX_DATA_SIZE);
+
+    test_found_chunks.failing_chunk_index = 3;
+    UHASHTOOLS_TEST_CHECK(!uhashtools_test_chunk_data(&test_found_chunks, data, TEST_MAX_DATA_SIZE, 1024 * 8, TEST_FEED_MODE_RANDOM));
+    UHASHTOOLS_TEST_CHECK(test_found_chunks.chunks_count == 3);
+
+    /* The last chunk is passed by "uhashtools_chunker_finish()". */
+    test_found_chunks.failing_chunk_index = 0;
+    UHASHTOOLS_TEST_CHECK(!uhashtools_test_chunk_data(&test_found_chunks, data, 100, 1024 * 8, TEST_FEED_MODE_SINGLE));
+
+    test_found_chunks.failing_chunk_index = (size_t) -1;
+}
+
+int
+main
+(
+    void
+)
+{
+    unsigned char* data = (unsigned char*) malloc(TEST_MAX_DATA_SIZE + 64);
+
+    UHASHTOOLS_TEST_CHECK(data != NULL);
+
+    if (data)
+    {
+        uhashtools_test_data_kinds(data);
+        uhashtools_test_insertion(data);
+        uhashtools_test_failing_callback(data);
+        free(data);
+    }
+
+    uhashtools_test_max_average_size();
+
+#if defined(_MSC_VER)
+    return uhashtools_test_finish("test_chunker (AVX2)");
+#else
+    return uhashtools_test_finish("test_chunker");
+#endif
+}
@@ -0,0 +1,254 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Tests hashing the standard input ("-") through "file_source_stream.c"
+ * like "cat file | uhashtools -". The standard input of the test is
+ * connected to a pipe which is written by "cat" in a child process, so
+ * the pipe is read in pieces of the pipe buffer. The digests have to
+ * match the digests of the same data hashed from memory, and since the
+ * size of a pipe isn't known the progress has to be reported without a
+ * percentage.
+ * 
+ * Then the standard input is redirected from the file itself, in this
+ * case the size is known and the progress has a percentage again.
+ * 
+ * The test file is written next to the test executable and removed
+ * afterwards.
+ */
+
+#include "test_utilities.h"
+
+#include "buffer_sizes.h"
+#include "hash_calculation_impl.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <wchar.h>
+
+#define TEST_MAX_FILE_SIZE (1024 * 1024 * 3 + 17)
+
+struct TestProgressReports
+{
+    unsigned int reports_count;
+    unsigned int reports_with_known_size_count;
+};
+
+static
+void
+uhashtools_test_on_progress
+(
+    const struct HashCalculationProgress* current_calculation_progress,
+    void* userdata
+)
+{
+    struct TestProgressReports* progress_reports = (struct TestProgressReports*) userdata;
+
+    ++progress_reports->reports_count;
+
+    if (current_calculation_progress->is_size_known)
+    {
+        ++progress_reports->reports_with_known_size_count;
+    }
+}
+
+/* Starts "cat file_path" with its stdout connected to the stdin of the test. */
+static
+pid_t
+uhashtools_test_start_cat
+(
+    const char* file_path
+)
+{
+    int pipe_fds[2];
+    pid_t pid = 0;
+
+    if (pipe(pipe_fds) != 0)
+    {
+        return -1;
+    }
+
+    pid = fork();
+
+    if (pid == 0)
+    {
+        (void) close(pipe_fds[0]);
+
+        if (dup2(pipe_fds[1], STDOUT_FILENO) >= 0)
+        {
+            (void) close(pipe_fds[1]);
+            (void) execlp("cat", "cat", file_path, (char*) NULL);
+        }
+
+        _exit(127);
+    }
+
+    (void) close(pipe_fds[1]);
+
+    if (pid < 0 || dup2(pipe_fds[0], STDIN_FILENO) < 0)
+    {
+        (void) close(pipe_fds[0]);
+
+        return -1;
+    }
+
+    (void) close(pipe_fds[0]);
+
+    return pid;
+}
+
+static
+void
+uhashtools_test_hash_stdin
+(
+    const char* run_name,
+    const char* file_path,
+    const unsigned char* data,
+    size_t file_size,
+    BOOL is_piped
+)
+{
+    unsigned char* file_read_buf = (unsigned char*) malloc(FILE_READ_BUF_TSIZE);
+    wchar_t error_message_buf[256];
+    struct TestProgressReports progress_reports;
+    struct HashDigest expected_digest;
+    struct HashDigest stdin_digest;
+    enum HashCalculatorResultCode result_code = HashCalculatorResultCode_FAILED;
+    FILE* file = NULL;
+    pid_t cat_pid = -1;
+    int status = 0;
+
+    (void) memset((void*) &progress_reports, 0, sizeof progress_reports);
+
+    UHASHTOOLS_TEST_CHECK(file_read_buf);
+    if (!file_read_buf)
+    {
+        return;
+    }
+
+    file = fopen(file_path, "wb");
+    UHASHTOOLS_TEST_CHECK(file);
+    if (!file)
+    {
+        free((void*) file_read_buf);
+        return;
+    }
+
+    UHASHTOOLS_TEST_CHECK(fwrite((const void*) data, 1, file_size, file) == file_size);
+    UHASHTOOLS_TEST_CHECK(fclose(file) == 0);
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_hash_calculator_impl_hash_buffer_to_digest(data,
+                                                                                file_size,
+                                                                                &expected_digest,
+                                                                                error_message_buf,
+                                                                                sizeof error_message_buf / sizeof error_message_buf[0]));
+
+    if (is_piped)
+    {
+        cat_pid = uhashtools_test_start_cat(file_path);
+        UHASHTOOLS_TEST_CHECK(cat_pid > 0);
+    }
+    else
+    {
+        const int file_fd = open(file_path, O_RDONLY);
+
+        UHASHTOOLS_TEST_CHECK(file_fd >= 0 && dup2(file_fd, STDIN_FILENO) >= 0);
+        (void) close(file_fd);
+    }
+
+    result_code = uhashtools_hash_calculator_impl_hash_file_to_digest(file_read_buf,
+                                                                      FILE_READ_BUF_TSIZE,
+                                                                      &stdin_digest,
+                                                                      error_message_buf,
+                                                                      sizeof error_message_buf / sizeof error_message_buf[0],
+                                                                      L"-",
+                                                                      NULL,
+                                                                      NULL,
+                                                                      &uhashtools_test_on_progress,
+                                                                      &progress_reports);
+
+    if (cat_pid > 0)
+    {
+        UHASHTOOLS_TEST_CHECK(waitpid(cat_pid, &status, 0) == cat_pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+
+    (void) remove(file_path);
+    free((void*) file_read_buf);
+
+    (void) printf("test_file_source_stream: %-16s %8lu bytes, %u progress reports\n",
+                  run_name,
+                  (unsigned long) file_size,
+                  progress_reports.reports_count);
+
+    if (result_code != HashCalculatorResultCode_SUCCESS)
+    {
+        (void) printf("Hashing failed: %ls\n", error_message_buf);
+        UHASHTOOLS_TEST_CHECK(FALSE);
+        return;
+    }
+
+    UHASHTOOLS_TEST_CHECK(stdin_digest.size == expected_digest.size);
+    UHASHTOOLS_TEST_CHECK(memcmp((const void*) stdin_digest.bytes, (const void*) expected_digest.bytes, expected_digest.size) == 0);
+
+    if (is_piped)
+    {
+        /* The size of a pipe is unknown, the first report tells the receiver so right away. */
+        UHASHTOOLS_TEST_CHECK(progress_reports.reports_count > 0);
+        UHASHTOOLS_TEST_CHECK(progress_reports.reports_with_known_size_count == 0);
+    }
+    else if (file_size > FILE_READ_BUF_TSIZE)
+    {
+        UHASHTOOLS_TEST_CHECK(progress_reports.reports_count > 0);
+        UHASHTOOLS_TEST_CHECK(progress_reports.reports_with_known_size_count == progress_reports.reports_count);
+    }
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    static const size_t file_sizes[] = { 0, 1, 1024 * 64 + 1, TEST_MAX_FILE_SIZE };
+    unsigned char* data = (unsigned char*) malloc(TEST_MAX_FILE_SIZE);
+    char file_path[FILEPATH_BUFFER_TSIZE];
+    int original_stdin_fd = -1;
+    unsigned int i = 0;
+
+    (void) argc;
+
+    (void) sprintf(file_path, "%.*s.bin", (int) (FILEPATH_BUFFER_TSIZE - 8), argv[0]);
+
+    original_stdin_fd = dup(STDIN_FILENO);
+
+    UHASHTOOLS_TEST_CHECK(data);
+    UHASHTOOLS_TEST_CHECK(original_stdin_fd >= 0);
+    if (data && original_stdin_fd >= 0)
+    {
+        uhashtools_test_fill_data(TEST_DATA_KIND_RANDOM, data, TEST_MAX_FILE_SIZE);
+
+        for (i = 0; i < sizeof file_sizes / sizeof file_sizes[0]; ++i)
+        {
+            uhashtools_test_hash_stdin("cat file | -", file_path, data, file_sizes[i], TRUE);
+        }
+
+        uhashtools_test_hash_stdin("- < file", file_path, data, TEST_MAX_FILE_SIZE, FALSE);
+
+        (void) dup2(original_stdin_fd, STDIN_FILENO);
+        (void) close(original_stdin_fd);
+    }
+
+    free((void*) data);
+
+    return uhashtools_test_finish("test_file_source_stream");
+}
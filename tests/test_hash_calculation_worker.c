@@ -0,0 +1,392 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Tests the persistent hash calculation worker like the main window uses
+ * it: the test thread receives the event messages of the worker and
+ * signals after every message that the worker may write the next one.
+ * 
+ * Many jobs for a small file are submitted one after another. Every job
+ * has to be reported as started and as complete with the digest of the
+ * file. The time from the submission until the start message and until
+ * the complete message is measured per job and printed as median and
+ * 99th percentile. For comparison the time which creating a thread per
+ * job takes until the thread runs is measured the same way.
+ * 
+ * Finally a job for a bigger file is cancelled right after submitting it
+ * and has to be reported as cancelled.
+ * 
+ * The test files are written next to the test executable and removed
+ * afterwards.
+ */
+
+#include "test_utilities.h"
+
+#include "buffer_sizes.h"
+#include "hash_calculation_impl.h"
+#include "hash_calculation_worker.h"
+#include "hash_calculation_worker_com.h"
+
+#include <process.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#define TEST_JOBS_COUNT 2000
+#define TEST_SMALL_FILE_SIZE (1024 * 4)
+#define TEST_BIG_FILE_SIZE (1024 * 1024 * 4)
+
+struct TestReceiver
+{
+    struct HashCalculationWorkerEventMessage event_message_buf;
+    HANDLE event_message_buf_is_writeable_event;
+};
+
+static
+BOOL
+uhashtools_test_write_file
+(
+    const char* path,
+    const unsigned char* data,
+    size_t data_size
+)
+{
+    FILE* file = fopen(path, "wb");
+    BOOL is_written = FALSE;
+
+    if (!file)
+    {
+        return FALSE;
+    }
+
+    is_written = fwrite((const void*) data, 1, data_size, file) == data_size;
+    is_written = fclose(file) == 0 && is_written;
+
+    return is_written;
+}
+
+/* Waits for the next event message of the worker and lets it write the following one. */
+static
+struct HashCalculationWorkerEventMessage
+uhashtools_test_receive_event_message
+(
+    struct TestReceiver* receiver
+)
+{
+    struct HashCalculationWorkerEventMessage event_message;
+    MSG received_msg;
+
+    (void) memset((void*) &event_message, 0, sizeof event_message);
+
+    if (GetMessageW(&received_msg, NULL, WM_USER, WM_USER) > 0)
+    {
+        UHASHTOOLS_TEST_CHECK(received_msg.wParam == (WPARAM) &receiver->event_message_buf);
+        event_message = receiver->event_message_buf;
+    }
+    else
+    {
+        UHASHTOOLS_TEST_CHECK(FALSE);
+    }
+
+    (void) SetEvent(receiver->event_message_buf_is_writeable_event);
+
+    return event_message;
+}
+
+/* Skips the progress messages and returns the next other event message. */
+static
+struct HashCalculationWorkerEventMessage
+uhashtools_test_receive_result_message
+(
+    struct TestReceiver* receiver
+)
+{
+    struct HashCalculationWorkerEventMessage event_message;
+
+    do
+    {
+        event_message = uhashtools_test_receive_event_message(receiver);
+    } while (event_message.event_type == HCWET_CALCULATION_PROGRESS_CHANGED);
+
+    if (event_message.event_type == HCWET_CALCULATION_FAILED)
+    {
+        (void) printf("Hashing failed: %ls\n", event_message.event_data.operation_failed_data.user_error_message);
+        free((void*) event_message.event_data.operation_failed_data.user_error_message);
+    }
+
+    return event_message;
+}
+
+static
+int
+uhashtools_test_compare_latencies
+(
+    const void* a,
+    const void* b
+)
+{
+    const double latency_a = *(const double*) a;
+    const double latency_b = *(const double*) b;
+
+    return latency_a < latency_b ? -1 : (latency_a > latency_b ? 1 : 0);
+}
+
+/* Sorts the latencies and prints their median and 99th percentile in microseconds. */
+static
+void
+uhashtools_test_print_latencies
+(
+    const char* run_name,
+    double* latencies,
+    size_t latencies_count
+)
+{
+    qsort((void*) latencies, latencies_count, sizeof *latencies, uhashtools_test_compare_latencies);
+
+    (void) printf("test_hash_calculation_worker: %-28s median %8.1f us   p99 %8.1f us\n",
+                  run_name,
+                  latencies[latencies_count / 2] * 1000000.0,
+                  latencies[latencies_count * 99 / 100] * 1000000.0);
+}
+
+static
+void
+uhashtools_test_submitted_jobs
+(
+    struct TestReceiver* receiver,
+    struct HashCalculationWorkerInstanceData* worker_instance_data,
+    const wchar_t* small_file_wpath,
+    const struct HashDigest* expected_digest,
+    double* start_latencies,
+    double* complete_latencies
+)
+{
+    unsigned int completed_jobs_count = 0;
+    unsigned int job_index = 0;
+
+    for (job_index = 0; job_index < TEST_JOBS_COUNT; ++job_index)
+    {
+        struct HashCalculationWorkerEventMessage event_message;
+        const double submit_seconds = uhashtools_test_get_seconds();
+
+        if (!uhashtools_hash_calculation_worker_submit_job(worker_instance_data, small_file_wpath))
+        {
+            UHASHTOOLS_TEST_CHECK(FALSE);
+            return;
+        }
+
+        event_message = uhashtools_test_receive_event_message(receiver);
+        start_latencies[job_index] = uhashtools_test_get_seconds() - submit_seconds;
+        UHASHTOOLS_TEST_CHECK(event_message.event_type == HCWET_MESSAGE_RECEIVER_INITIALIZED);
+
+        event_message = uhashtools_test_receive_result_message(receiver);
+        complete_latencies[job_index] = uhashtools_test_get_seconds() - submit_seconds;
+        UHASHTOOLS_TEST_CHECK(event_message.event_type == HCWET_CALCULATION_COMPLETE);
+
+        if (event_message.event_type == HCWET_CALCULATION_COMPLETE &&
+            event_message.event_data.operation_finished_data.calculated_digest.size == expected_digest->size &&
+            memcmp((const void*) event_message.event_data.operation_finished_data.calculated_digest.bytes,
+                   (const void*) expected_digest->bytes,
+                   expected_digest->size) == 0)
+        {
+            ++completed_jobs_count;
+        }
+    }
+
+    UHASHTOOLS_TEST_CHECK(completed_jobs_count == TEST_JOBS_COUNT);
+    UHASHTOOLS_TEST_CHECK(worker_instance_data->current_job_id == TEST_JOBS_COUNT);
+
+    uhashtools_test_print_latencies("job started", start_latencies, TEST_JOBS_COUNT);
+    uhashtools_test_print_latencies("job complete", complete_latencies, TEST_JOBS_COUNT);
+}
+
+static
+unsigned int
+__stdcall
+uhashtools_test_job_thread_function
+(
+    void* thread_param
+)
+{
+    (void) SetEvent((HANDLE) thread_param);
+
+    return 0;
+}
+
+/* Measures the time from creating a thread per job until the thread runs. */
+static
+void
+uhashtools_test_thread_per_job
+(
+    double* start_latencies
+)
+{
+    HANDLE thread_started_event = CreateEventW(NULL, FALSE, FALSE, NULL);
+    unsigned int job_index = 0;
+
+    UHASHTOOLS_TEST_CHECK(thread_started_event);
+    if (!thread_started_event)
+    {
+        return;
+    }
+
+    for (job_index = 0; job_index < TEST_JOBS_COUNT; ++job_index)
+    {
+        const double create_seconds = uhashtools_test_get_seconds();
+        unsigned int thread_id = 0;
+        HANDLE thread_handle = (HANDLE) _beginthreadex(NULL,
+                                                       0,
+                                                       uhashtools_test_job_thread_function,
+                                                       (void*) thread_started_event,
+                                                       0,
+                                                       &thread_id);
+
+        UHASHTOOLS_TEST_CHECK(thread_handle);
+        if (!thread_handle)
+        {
+            break;
+        }
+
+        UHASHTOOLS_TEST_CHECK(WaitForSingleObject(thread_started_event, INFINITE) == WAIT_OBJECT_0);
+        start_latencies[job_index] = uhashtools_test_get_seconds() - create_seconds;
+
+        UHASHTOOLS_TEST_CHECK(WaitForSingleObject(thread_handle, INFINITE) == WAIT_OBJECT_0);
+        (void) CloseHandle(thread_handle);
+    }
+
+    (void) CloseHandle(thread_started_event);
+
+    if (job_index == TEST_JOBS_COUNT)
+    {
+        uhashtools_test_print_latencies("thread per job started", start_latencies, TEST_JOBS_COUNT);
+    }
+}
+
+static
+void
+uhashtools_test_cancelled_job
+(
+    struct TestReceiver* receiver,
+    struct HashCalculationWorkerInstanceData* worker_instance_data,
+    const wchar_t* big_file_wpath
+)
+{
+    struct HashCalculationWorkerEventMessage event_message;
+
+    if (!uhashtools_hash_calculation_worker_submit_job(worker_instance_data, big_file_wpath))
+    {
+        UHASHTOOLS_TEST_CHECK(FALSE);
+        return;
+    }
+
+    /* The cancel request is queued behind the job, so the worker sees it before the first read. */
+    uhashtools_hash_calculation_worker_request_cancellation(worker_instance_data);
+
+    event_message = uhashtools_test_receive_event_message(receiver);
+    UHASHTOOLS_TEST_CHECK(event_message.event_type == HCWET_MESSAGE_RECEIVER_INITIALIZED);
+
+    event_message = uhashtools_test_receive_result_message(receiver);
+    UHASHTOOLS_TEST_CHECK(event_message.event_type == HCWET_CALCULATION_CANCELED);
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    unsigned char* data = (unsigned char*) malloc(TEST_BIG_FILE_SIZE);
+    double* start_latencies = (double*) malloc(sizeof(double) * TEST_JOBS_COUNT);
+    double* complete_latencies = (double*) malloc(sizeof(double) * TEST_JOBS_COUNT);
+    char small_file_path[FILEPATH_BUFFER_TSIZE];
+    char big_file_path[FILEPATH_BUFFER_TSIZE];
+    wchar_t small_file_wpath[FILEPATH_BUFFER_TSIZE];
+    wchar_t big_file_wpath[FILEPATH_BUFFER_TSIZE];
+    wchar_t error_message_buf[256];
+    struct HashCalculationWorkerParam worker_param;
+    struct HashCalculationWorkerInstanceData worker_instance_data;
+    struct TestReceiver receiver;
+    struct HashDigest expected_digest;
+    MSG peeked_msg;
+
+    (void) argc;
+
+    (void) memset((void*) &receiver, 0, sizeof receiver);
+    (void) memset((void*) &worker_param, 0, sizeof worker_param);
+
+    (void) sprintf(small_file_path, "%.*s.small", (int) (FILEPATH_BUFFER_TSIZE - 8), argv[0]);
+    (void) sprintf(big_file_path, "%.*s.big", (int) (FILEPATH_BUFFER_TSIZE - 8), argv[0]);
+    (void) mbstowcs(small_file_wpath, small_file_path, FILEPATH_BUFFER_TSIZE);
+    (void) mbstowcs(big_file_wpath, big_file_path, FILEPATH_BUFFER_TSIZE);
+
+    UHASHTOOLS_TEST_CHECK(data);
+    UHASHTOOLS_TEST_CHECK(start_latencies);
+    UHASHTOOLS_TEST_CHECK(complete_latencies);
+    if (!data || !start_latencies || !complete_latencies)
+    {
+        goto cleanup_and_out;
+    }
+
+    uhashtools_test_fill_data(TEST_DATA_KIND_RANDOM, data, TEST_BIG_FILE_SIZE);
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_test_write_file(small_file_path, data, TEST_SMALL_FILE_SIZE));
+    UHASHTOOLS_TEST_CHECK(uhashtools_test_write_file(big_file_path, data, TEST_BIG_FILE_SIZE));
+    UHASHTOOLS_TEST_CHECK(uhashtools_hash_calculator_impl_hash_buffer_to_digest(data,
+                                                                                TEST_SMALL_FILE_SIZE,
+                                                                                &expected_digest,
+                                                                                error_message_buf,
+                                                                                sizeof error_message_buf / sizeof error_message_buf[0]));
+
+    /* Like the main window the test thread receives the event messages of the worker. */
+    (void) PeekMessageW(&peeked_msg, NULL, WM_USER, WM_USER, PM_NOREMOVE);
+
+    receiver.event_message_buf_is_writeable_event = CreateEventW(NULL, FALSE, TRUE, NULL);
+    UHASHTOOLS_TEST_CHECK(receiver.event_message_buf_is_writeable_event);
+    if (!receiver.event_message_buf_is_writeable_event)
+    {
+        goto cleanup_and_out;
+    }
+
+    worker_instance_data = uhashtools_hash_calculation_worker_start(&worker_param,
+                                                                    &receiver.event_message_buf,
+                                                                    receiver.event_message_buf_is_writeable_event,
+                                                                    (HWND) (size_t) GetCurrentThreadId());
+    UHASHTOOLS_TEST_CHECK(worker_instance_data.created_successfully);
+
+    if (worker_instance_data.created_successfully)
+    {
+        uhashtools_test_submitted_jobs(&receiver,
+                                       &worker_instance_data,
+                                       small_file_wpath,
+                                       &expected_digest,
+                                       start_latencies,
+                                       complete_latencies);
+        uhashtools_test_thread_per_job(start_latencies);
+        uhashtools_test_cancelled_job(&receiver, &worker_instance_data, big_file_wpath);
+
+        /* The worker runs until the process exits, so it's only ended here. */
+        (void) PostThreadMessageW(worker_instance_data.thread_id, WM_QUIT, 0, 0);
+        UHASHTOOLS_TEST_CHECK(WaitForSingleObject(worker_instance_data.thread_handle, INFINITE) == WAIT_OBJECT_0);
+        (void) CloseHandle(worker_instance_data.thread_handle);
+    }
+
+    (void) CloseHandle(receiver.event_message_buf_is_writeable_event);
+
+cleanup_and_out:
+    (void) remove(small_file_path);
+    (void) remove(big_file_path);
+
+    free((void*) complete_latencies);
+    free((void*) start_latencies);
+    free((void*) data);
+
+    return uhashtools_test_finish("test_hash_calculation_worker");
+}
@@ -0,0 +1,531 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Tests the incremental mode with SHA-256 on a file which is appended
+ * to by another thread while the mode is run again and again, like a
+ * log file which is hashed by a scheduled task. Every run has to resume
+ * at the end of the previous one and print the digest of the part it
+ * has hashed. After the writer has stopped the printed digest has to be
+ * the one of the whole file. Afterwards the whole file has to be hashed
+ * again for state files which don't belong to the hashed size, damaged
+ * state files and rewritten or truncated files.
+ * 
+ * Every run is made by a child process like from the command line,
+ * since the mode switches the standard streams to wide output. The
+ * child writes its stdout and stderr into files. All files are written
+ * next to the test executable and removed afterwards.
+ */
+
+#define _GNU_SOURCE
+
+#include "test_utilities.h"
+
+#include "buffer_sizes.h"
+#include "cli_arguments.h"
+#include "file_source_range.h"
+#include "hash_calculation_impl.h"
+#include "incremental_mode.h"
+#include "incremental_state.h"
+
+#include <io.h>
+#include <process.h>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <wchar.h>
+
+#define TEST_RUNS_COUNT 16
+
+/* Records cross the check blocks and the read buffer in every possible way. */
+#define TEST_MAX_RECORD_SIZE (INCREMENTAL_STATE_CHECK_BLOCK_SIZE + 1)
+#define TEST_WRITE_PAUSE_MS 20
+
+enum TestPathKind
+{
+    TEST_PATH_KIND_TARGET,
+    TEST_PATH_KIND_STATE,
+    TEST_PATH_KIND_STDOUT,
+    TEST_PATH_KIND_STDERR,
+    TEST_PATH_KINDS_COUNT
+};
+
+struct TestWriterCtx
+{
+    CRITICAL_SECTION lock;
+    BOOL is_stop_requested;
+    BOOL had_write_errors;
+};
+
+/* Output of a run of the mode */
+struct TestRunResult
+{
+    int exit_code;
+    BOOL has_error_output;
+    char digest_hex[HASH_DIGEST_MAX_SIZE * 2 + 1];
+    unsigned __int64 resumed_size;
+    unsigned __int64 hashed_size;
+};
+
+static char test_paths[TEST_PATH_KINDS_COUNT][FILEPATH_BUFFER_TSIZE];
+static wchar_t test_target_wpath[FILEPATH_BUFFER_TSIZE];
+static wchar_t test_state_wpath[FILEPATH_BUFFER_TSIZE];
+static struct CliArguments test_cli_arguments;
+
+static
+BOOL
+uhashtools_test_append_record
+(
+    int target_fd
+)
+{
+    static unsigned char record[TEST_MAX_RECORD_SIZE];
+    const size_t record_size = (size_t) (uhashtools_test_random() % TEST_MAX_RECORD_SIZE) + 1;
+
+    uhashtools_test_fill_data(TEST_DATA_KIND_RANDOM, record, record_size);
+
+    return write(target_fd, (const void*) record, record_size) == (ssize_t) record_size;
+}
+
+/*
+ * Appends with unbuffered writes, because buffered streams would take
+ * locks which a forked child might inherit in the locked state.
+ */
+static
+unsigned int
+__stdcall
+uhashtools_test_writer_thread_function
+(
+    void* thread_param
+)
+{
+    struct TestWriterCtx* ctx = (struct TestWriterCtx*) thread_param;
+    const int target_fd = open(test_paths[TEST_PATH_KIND_TARGET], O_WRONLY | O_APPEND);
+    BOOL is_stop_requested = FALSE;
+    BOOL had_write_errors = target_fd < 0;
+
+    while (!is_stop_requested && !had_write_errors)
+    {
+        had_write_errors = !uhashtools_test_append_record(target_fd);
+
+        Sleep(TEST_WRITE_PAUSE_MS);
+
+        EnterCriticalSection(&ctx->lock);
+        is_stop_requested = ctx->is_stop_requested;
+        LeaveCriticalSection(&ctx->lock);
+    }
+
+    if (target_fd >= 0)
+    {
+        (void) close(target_fd);
+    }
+
+    EnterCriticalSection(&ctx->lock);
+    ctx->had_write_errors = had_write_errors;
+    LeaveCriticalSection(&ctx->lock);
+
+    return 0;
+}
+
+static
+unsigned __int64
+uhashtools_test_get_file_size
+(
+    const char* path
+)
+{
+    FILE* file = fopen(path, "rb");
+    __int64 file_size = -1;
+
+    if (file)
+    {
+        file_size = _filelengthi64(_fileno(file));
+        (void) fclose(file);
+    }
+
+    UHASHTOOLS_TEST_CHECK(file_size >= 0);
+
+    return file_size >= 0 ? (unsigned __int64) file_size : 0;
+}
+
+/* Hashes the first "size" bytes of the target file at once. */
+static
+void
+uhashtools_test_hash_prefix
+(
+    unsigned __int64 size,
+    char* digest_hex
+)
+{
+    static unsigned char file_read_buf[FILE_READ_BUF_TSIZE];
+    wchar_t error_message[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    wchar_t digest_whex[HASH_DIGEST_MAX_SIZE * 2 + 1];
+    struct FileSource file_source;
+    struct HashDigest digest;
+    enum HashCalculatorResultCode hash_rc = HashCalculatorResultCode_FAILED;
+
+    digest_hex[0] = '\0';
+
+    file_source = uhashtools_file_source_range_open(error_message,
+                                                    GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                    test_target_wpath,
+                                                    0,
+                                                    size);
+
+    UHASHTOOLS_TEST_CHECK(file_source.is_ok && file_source.size == size);
+    if (!file_source.is_ok)
+    {
+        return;
+    }
+
+    hash_rc = uhashtools_hash_calculator_impl_hash_file_source_to_digest(file_read_buf,
+                                                                         FILE_READ_BUF_TSIZE,
+                                                                         &digest,
+                                                                         error_message,
+                                                                         GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                                         &file_source,
+                                                                         NULL,
+                                                                         NULL,
+                                                                         NULL,
+                                                                         NULL);
+
+    uhashtools_file_source_close(&file_source);
+
+    UHASHTOOLS_TEST_CHECK(hash_rc == HashCalculatorResultCode_SUCCESS);
+    UHASHTOOLS_TEST_CHECK(uhashtools_hash_calculator_impl_digest_to_hex(&digest, digest_whex, HASH_DIGEST_MAX_SIZE * 2 + 1));
+    (void) wcstombs(digest_hex, digest_whex, HASH_DIGEST_MAX_SIZE * 2 + 1);
+}
+
+/* Runs the mode in a child process and parses its output. */
+static
+void
+uhashtools_test_run_incremental_mode
+(
+    struct TestRunResult* result
+)
+{
+    char expected_digest_line_end[FILEPATH_BUFFER_TSIZE + 4];
+    char line[FILEPATH_BUFFER_TSIZE + HASH_DIGEST_MAX_SIZE * 2 + 8];
+    char* digest_end = NULL;
+    FILE* output_file = NULL;
+
+    (void) memset((void*) result, 0, sizeof *result);
+
+    result->exit_code = uhashtools_test_run_mode(uhashtools_incremental_mode_run,
+                                                 &test_cli_arguments,
+                                                 test_paths[TEST_PATH_KIND_STDOUT],
+                                                 test_paths[TEST_PATH_KIND_STDERR]);
+    if (result->exit_code < 0)
+    {
+        return;
+    }
+
+    result->has_error_output = uhashtools_test_get_file_size(test_paths[TEST_PATH_KIND_STDERR]) > 0;
+
+    output_file = fopen(test_paths[TEST_PATH_KIND_STDOUT], "r");
+    if (!output_file)
+    {
+        return;
+    }
+
+    /* "<hash> *<filepath>" */
+    (void) sprintf(expected_digest_line_end, " *%s\n", test_paths[TEST_PATH_KIND_TARGET]);
+
+    if (fgets(line, sizeof line, output_file) &&
+        (digest_end = strchr(line, ' ')) != NULL &&
+        strcmp(digest_end, expected_digest_line_end) == 0 &&
+        (size_t) (digest_end - line) < sizeof result->digest_hex)
+    {
+        (void) memcpy((void*) result->digest_hex, (const void*) line, (size_t) (digest_end - line));
+        result->digest_hex[digest_end - line] = '\0';
+    }
+
+    if (!fgets(line, sizeof line, output_file) ||
+        sscanf(line,
+               "# Resumed at offset %llu, %llu bytes hashed",
+               &result->resumed_size,
+               &result->hashed_size) != 2)
+    {
+        result->digest_hex[0] = '\0';
+    }
+
+    (void) fclose(output_file);
+}
+
+/* Reads the hashed size of the state file written by the last run. */
+static
+unsigned __int64
+uhashtools_test_get_state_hashed_size
+(
+    void
+)
+{
+    wchar_t error_message[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    struct IncrementalState state;
+    unsigned __int64 hashed_size = 0;
+
+    (void) memset((void*) &state, 0, sizeof state);
+
+    if (uhashtools_incremental_state_load(error_message, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, test_state_wpath, &state))
+    {
+        hashed_size = state.resume_state.hashed_size;
+        uhashtools_incremental_state_free(&state);
+    }
+    else
+    {
+        UHASHTOOLS_TEST_CHECK(!"Loading the state file failed.");
+    }
+
+    return hashed_size;
+}
+
+/*
+ * Runs the mode while the file is appended to. The size of the file
+ * isn't known when the mode reads it, so every run is checked against
+ * the size stored in the state file.
+ */
+static
+void
+uhashtools_test_appended_file
+(
+    void
+)
+{
+    struct TestWriterCtx ctx;
+    struct TestRunResult result;
+    HANDLE writer_thread_handle = NULL;
+    unsigned int thread_id = 0;
+    unsigned __int64 previous_hashed_size = 0;
+    unsigned __int64 state_hashed_size = 0;
+    char expected_digest_hex[HASH_DIGEST_MAX_SIZE * 2 + 1];
+    unsigned int run_index = 0;
+
+    (void) memset((void*) &ctx, 0, sizeof ctx);
+    InitializeCriticalSection(&ctx.lock);
+
+    writer_thread_handle = (HANDLE) _beginthreadex(NULL,
+                                                   0,
+                                                   uhashtools_test_writer_thread_function,
+                                                   (void*) &ctx,
+                                                   0,
+                                                   &thread_id);
+
+    UHASHTOOLS_TEST_CHECK(writer_thread_handle);
+    if (!writer_thread_handle)
+    {
+        exit(uhashtools_test_finish("test_incremental_mode"));
+    }
+
+    for (run_index = 0; run_index < TEST_RUNS_COUNT; ++run_index)
+    {
+        Sleep(TEST_WRITE_PAUSE_MS * 2);
+
+        uhashtools_test_run_incremental_mode(&result);
+
+        UHASHTOOLS_TEST_CHECK(result.exit_code == 0);
+        UHASHTOOLS_TEST_CHECK(!result.has_error_output);
+        UHASHTOOLS_TEST_CHECK(result.resumed_size == previous_hashed_size);
+
+        state_hashed_size = uhashtools_test_get_state_hashed_size();
+        UHASHTOOLS_TEST_CHECK(state_hashed_size == result.resumed_size + result.hashed_size);
+        UHASHTOOLS_TEST_CHECK(state_hashed_size <= uhashtools_test_get_file_size(test_paths[TEST_PATH_KIND_TARGET]));
+
+        uhashtools_test_hash_prefix(state_hashed_size, expected_digest_hex);
+        UHASHTOOLS_TEST_CHECK(strcmp(result.digest_hex, expected_digest_hex) == 0);
+
+        previous_hashed_size = state_hashed_size;
+    }
+
+    EnterCriticalSection(&ctx.lock);
+    ctx.is_stop_requested = TRUE;
+    LeaveCriticalSection(&ctx.lock);
+
+    UHASHTOOLS_TEST_CHECK(WaitForSingleObject(writer_thread_handle, INFINITE) == WAIT_OBJECT_0);
+    (void) CloseHandle(writer_thread_handle);
+    DeleteCriticalSection(&ctx.lock);
+
+    UHASHTOOLS_TEST_CHECK(!ctx.had_write_errors);
+
+    /* The last run sees the complete file. */
+    uhashtools_test_run_incremental_mode(&result);
+
+    state_hashed_size = uhashtools_test_get_file_size(test_paths[TEST_PATH_KIND_TARGET]);
+    uhashtools_test_hash_prefix(state_hashed_size, expected_digest_hex);
+
+    (void) printf("test_incremental_mode: %u runs hashed %llu bytes\n", TEST_RUNS_COUNT + 1, state_hashed_size);
+
+    UHASHTOOLS_TEST_CHECK(result.exit_code == 0 && !result.has_error_output);
+    UHASHTOOLS_TEST_CHECK(result.resumed_size == previous_hashed_size);
+    UHASHTOOLS_TEST_CHECK(result.resumed_size + result.hashed_size == state_hashed_size);
+    UHASHTOOLS_TEST_CHECK(uhashtools_test_get_state_hashed_size() == state_hashed_size);
+    UHASHTOOLS_TEST_CHECK(strcmp(result.digest_hex, expected_digest_hex) == 0);
+}
+
+/*
+ * Runs the mode after the state file or the file has been tampered with.
+ * The mode has to report it and hash the whole file again.
+ */
+static
+void
+uhashtools_test_rehashed_file
+(
+    const char* case_name
+)
+{
+    struct TestRunResult result;
+    unsigned __int64 file_size = uhashtools_test_get_file_size(test_paths[TEST_PATH_KIND_TARGET]);
+    char expected_digest_hex[HASH_DIGEST_MAX_SIZE * 2 + 1];
+
+    uhashtools_test_run_incremental_mode(&result);
+    uhashtools_test_hash_prefix(file_size, expected_digest_hex);
+
+    if (result.exit_code != 0 ||
+        !result.has_error_output ||
+        result.resumed_size != 0 ||
+        result.hashed_size != file_size ||
+        strcmp(result.digest_hex, expected_digest_hex) != 0)
+    {
+        (void) printf("test_incremental_mode: %s: The file hasn't been hashed again.\n", case_name);
+        UHASHTOOLS_TEST_CHECK(!"The file has to be hashed again.");
+    }
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_test_get_state_hashed_size() == file_size);
+}
+
+/* Saves a state whose hasher state doesn't belong to the hashed size of the state file. */
+static
+void
+uhashtools_test_save_mismatching_state
+(
+    void
+)
+{
+    wchar_t error_message[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    struct IncrementalState state;
+    struct IncrementalState loaded_state;
+
+    (void) memset((void*) &state, 0, sizeof state);
+    (void) memset((void*) &loaded_state, 0, sizeof loaded_state);
+
+    if (!uhashtools_incremental_state_load(error_message, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, test_state_wpath, &state))
+    {
+        UHASHTOOLS_TEST_CHECK(!"Loading the state file failed.");
+        return;
+    }
+
+    state.resume_state.hashed_size -= 1;
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_incremental_state_save(error_message,
+                                                            GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                            test_state_wpath,
+                                                            &state));
+
+    UHASHTOOLS_TEST_CHECK(!uhashtools_incremental_state_load(error_message,
+                                                             GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                             test_state_wpath,
+                                                             &loaded_state));
+    UHASHTOOLS_TEST_CHECK(loaded_state.resume_state.hasher_state == NULL);
+
+    uhashtools_incremental_state_free(&loaded_state);
+    uhashtools_incremental_state_free(&state);
+}
+
+static
+void
+uhashtools_test_truncate_file
+(
+    const char* path,
+    unsigned __int64 size
+)
+{
+    UHASHTOOLS_TEST_CHECK(truncate(path, (off_t) size) == 0);
+}
+
+static
+void
+uhashtools_test_overwrite_first_byte
+(
+    void
+)
+{
+    FILE* target_file = fopen(test_paths[TEST_PATH_KIND_TARGET], "r+b");
+    int first_byte = EOF;
+
+    UHASHTOOLS_TEST_CHECK(target_file != NULL);
+    if (!target_file)
+    {
+        return;
+    }
+
+    first_byte = fgetc(target_file);
+    UHASHTOOLS_TEST_CHECK(first_byte != EOF);
+
+    UHASHTOOLS_TEST_CHECK(fseek(target_file, 0, SEEK_SET) == 0);
+    UHASHTOOLS_TEST_CHECK(fputc(first_byte ^ 0xFF, target_file) != EOF);
+    UHASHTOOLS_TEST_CHECK(fclose(target_file) == 0);
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    static const char* const path_suffixes[TEST_PATH_KINDS_COUNT] = { ".log", ".state", ".out", ".err" };
+    wchar_t* cli_argv[4];
+    unsigned int i = 0;
+
+    (void) argc;
+
+    for (i = 0; i < TEST_PATH_KINDS_COUNT; ++i)
+    {
+        (void) sprintf(test_paths[i], "%.*s%s", (int) (FILEPATH_BUFFER_TSIZE - 8), argv[0], path_suffixes[i]);
+        (void) remove(test_paths[i]);
+    }
+
+    (void) mbstowcs(test_target_wpath, test_paths[TEST_PATH_KIND_TARGET], FILEPATH_BUFFER_TSIZE);
+    (void) mbstowcs(test_state_wpath, test_paths[TEST_PATH_KIND_STATE], FILEPATH_BUFFER_TSIZE);
+
+    /* Like "uhashtools.exe --incremental <state file> <file>" */
+    cli_argv[0] = L"uhashtools.exe";
+    cli_argv[1] = L"--incremental";
+    cli_argv[2] = test_state_wpath;
+    cli_argv[3] = test_target_wpath;
+    uhashtools_cli_arguments_fill_from_argc_argv(&test_cli_arguments, 4, cli_argv);
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_cli_arguments_has_incremental_state_file(&test_cli_arguments));
+
+    /* The first run starts with an empty file and without a state file. */
+    fclose(fopen(test_paths[TEST_PATH_KIND_TARGET], "wb"));
+
+    uhashtools_test_appended_file();
+
+    uhashtools_test_save_mismatching_state();
+    uhashtools_test_rehashed_file("Mismatching state");
+
+    uhashtools_test_truncate_file(test_paths[TEST_PATH_KIND_STATE], 100);
+    uhashtools_test_rehashed_file("Damaged state");
+
+    uhashtools_test_overwrite_first_byte();
+    uhashtools_test_rehashed_file("Rewritten file");
+
+    uhashtools_test_truncate_file(test_paths[TEST_PATH_KIND_TARGET],
+                                  uhashtools_test_get_file_size(test_paths[TEST_PATH_KIND_TARGET]) / 2);
+    uhashtools_test_rehashed_file("Truncated file");
+
+    for (i = 0; i < TEST_PATH_KINDS_COUNT; ++i)
+    {
+        (void) remove(test_paths[i]);
+    }
+
+    return uhashtools_test_finish("test_incremental_mode");
+}
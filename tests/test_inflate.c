@@ -0,0 +1,517 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Tests the inflate implementation with raw deflate streams of zlib. The
+ * streams are compressed with all levels and strategies which lead to
+ * different block types, then inflated with input and output chunks of
+ * random sizes. Damaged and truncated streams must be rejected without
+ * reading or writing out of bounds (see the sanitizers in "makefile").
+ */
+
+#include "test_utilities.h"
+
+#include "inflate.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#define TEST_MAX_DATA_SIZE (300 * 1000)
+#define TEST_TRUNCATED_DATA_SIZE 1500
+#define TEST_DAMAGED_STREAMS_COUNT 3000
+
+/*
+ * The inflate implementation notices the end of a stream only when there
+ * is room for more output, so the output buffer needs a spare byte.
+ */
+#define TEST_OUT_BUF_SIZE (TEST_MAX_DATA_SIZE + 1)
+
+struct TestInput
+{
+    const unsigned char* data;
+    size_t data_size;
+    size_t data_pos;
+    /* Maximum size of a read, 0 to fill the whole buffer. */
+    size_t max_read_size;
+};
+
+static const size_t test_data_sizes[] = { 0, 1, 100, 32768, 65535, 65536, 70000, TEST_MAX_DATA_SIZE };
+
+static const int test_levels[] = { 0, 1, 6, 9 };
+
+static const int test_strategies[] = { Z_DEFAULT_STRATEGY, Z_FIXED, Z_HUFFMAN_ONLY, Z_RLE };
+
+static
+BOOL
+uhashtools_test_read_input
+(
+    void* userdata,
+    unsigned char* buf,
+    size_t buf_size,
+    size_t* read_size
+)
+{
+    struct TestInput* input = (struct TestInput*) userdata;
+    size_t chunk_size = input->data_size - input->data_pos;
+
+    if (chunk_size > buf_size)
+    {
+        chunk_size = buf_size;
+    }
+
+    if (input->max_read_size > 0 && chunk_size > 0)
+    {
+        const size_t random_size = (size_t) (uhashtools_test_random() % input->max_read_size) + 1;
+
+        if (chunk_size > random_size)
+        {
+            chunk_size = random_size;
+        }
+    }
+
+    (void) memcpy((void*) buf, (const void*) (input->data + input->data_pos), chunk_size);
+    input->data_pos += chunk_size;
+    *read_size = chunk_size;
+
+    return TRUE;
+}
+
+/*
+ * Compresses the data into a raw deflate stream. The returned buffer must
+ * be freed by the caller.
+ */
+static
+unsigned char*
+uhashtools_test_deflate
+(
+    const unsigned char* data,
+    size_t data_size,
+    int level,
+    int strategy,
+    size_t* compressed_size
+)
+{
+    z_stream stream;
+    unsigned char* compressed = NULL;
+    uLong compressed_capacity = 0;
+    int deflate_result = Z_OK;
+
+    (void) memset((void*) &stream, 0, sizeof stream);
+
+    if (deflateInit2(&stream, level, Z_DEFLATED, -15, 9, strategy) != Z_OK)
+    {
+        UHASHTOOLS_TEST_CHECK(!"deflateInit2() failed.");
+        return NULL;
+    }
+
+    /* The bound misses the 5 bytes of the empty stored block of level 0. */
+    compressed_capacity = deflateBound(&stream, (uLong) data_size) + 16;
+    compressed = (unsigned char*) malloc(compressed_capacity);
+    UHASHTOOLS_TEST_CHECK(compressed != NULL);
+
+    stream.next_in = (Bytef*) data;
+    stream.avail_in = (uInt) data_size;
+    stream.next_out = compressed;
+    stream.avail_out = (uInt) compressed_capacity;
+
+    deflate_result = deflate(&stream, Z_FINISH);
+    UHASHTOOLS_TEST_CHECK(deflate_result == Z_STREAM_END);
+
+    *compressed_size = (size_t) stream.total_out;
+    (void) deflateEnd(&stream);
+
+    return compressed;
+}
+
+/*
+ * Inflates the stream into "out_buf" with output chunks of random sizes
+ * up to "max_write_size" (0 for the whole remaining buffer).
+ * 
+ * @return TRUE if the end of the stream has been reached without an
+ *         error, FALSE otherwise.
+ */
+static
+BOOL
+uhashtools_test_inflate
+(
+    struct InflateStream* inflate_stream,
+    const unsigned char* compressed,
+    size_t compressed_size,
+    size_t max_read_size,
+    size_t max_write_size,
+    unsigned char* out_buf,
+    size_t out_buf_size,
+    size_t* out_size
+)
+{
+    struct TestInput input;
+    BOOL reached_end = FALSE;
+
+    input.data = compressed;
+    input.data_size = compressed_size;
+    input.data_pos = 0;
+    input.max_read_size = max_read_size;
+
+    uhashtools_inflate_init(inflate_stream, uhashtools_test_read_input, &input);
+    *out_size = 0;
+
+    while (!reached_end)
+    {
+        size_t write_size = out_buf_size - *out_size;
+        size_t produced_size = 0;
+
+        if (max_write_size > 0)
+        {
+            const size_t random_size = (size_t) (uhashtools_test_random() % max_write_size) + 1;
+
+            if (write_size > random_size)
+            {
+                write_size = random_size;
+            }
+        }
+
+        /* Streams which inflate to more than the buffer are wrong anyway. */
+        if (write_size == 0)
+        {
+            return FALSE;
+        }
+
+        if (!uhashtools_inflate_read(inflate_stream,
+                                     out_buf + *out_size,
+                                     write_size,
+                                     &produced_size,
+                                     &reached_end))
+        {
+            return FALSE;
+        }
+
+        UHASHTOOLS_TEST_CHECK(produced_size <= write_size);
+        UHASHTOOLS_TEST_CHECK(produced_size == write_size || reached_end);
+        *out_size += produced_size;
+    }
+
+    UHASHTOOLS_TEST_CHECK(inflate_stream->total_out == *out_size);
+
+    return TRUE;
+}
+
+static
+void
+uhashtools_test_valid_streams
+(
+    struct InflateStream* inflate_stream,
+    unsigned char* data,
+    unsigned char* out_buf
+)
+{
+    /* Whole buffers, single input bytes with small outputs and mixed chunks. */
+    static const size_t max_read_sizes[] = { 0, 1, 13 };
+    static const size_t max_write_sizes[] = { 0, 7, 1000 };
+    int data_kind = 0;
+    size_t size_index = 0;
+    size_t level_index = 0;
+    size_t strategy_index = 0;
+    size_t chunks_index = 0;
+
+    for (data_kind = 0; data_kind < TEST_DATA_KIND_COUNT; ++data_kind)
+    {
+        for (size_index = 0; size_index < sizeof test_data_sizes / sizeof test_data_sizes[0]; ++size_index)
+        {
+            const size_t data_size = test_data_sizes[size_index];
+
+            uhashtools_test_fill_data((enum TestDataKind) data_kind, data, data_size);
+
+            for (level_index = 0; level_index < sizeof test_levels / sizeof test_levels[0]; ++level_index)
+            {
+                for (strategy_index = 0; strategy_index < sizeof test_strategies / sizeof test_strategies[0]; ++strategy_index)
+                {
+                    size_t compressed_size = 0;
+                    unsigned char* compressed = uhashtools_test_deflate(data,
+                                                                        data_size,
+                                                                        test_levels[level_index],
+                                                                        test_strategies[strategy_index],
+                                                                        &compressed_size);
+
+                    for (chunks_index = 0; compressed && chunks_index < sizeof max_read_sizes / sizeof max_read_sizes[0]; ++chunks_index)
+                    {
+                        size_t out_size = 0;
+                        const BOOL is_inflated = uhashtools_test_inflate(inflate_stream,
+                                                                         compressed,
+                                                                         compressed_size,
+                                                                         max_read_sizes[chunks_index],
+                                                                         max_write_sizes[chunks_index],
+                                                                         out_buf,
+                                                                         TEST_OUT_BUF_SIZE,
+                                                                         &out_size);
+
+                        if (!is_inflated || out_size != data_size || memcmp(out_buf, data, data_size) != 0)
+                        {
+                            (void) printf("Inflating %lu bytes of kind %d (level %d, strategy %d, chunks %lu) failed.\n",
+                                          (unsigned long) data_size,
+                                          data_kind,
+                                          test_levels[level_index],
+                                          test_strategies[strategy_index],
+                                          (unsigned long) chunks_index);
+                            UHASHTOOLS_TEST_CHECK(!"Inflated data differs.");
+                        }
+                    }
+
+                    free(compressed);
+                }
+            }
+        }
+    }
+}
+
+/* Every stream which misses its last byte ends before its final block does. */
+static
+void
+uhashtools_test_truncated_streams
+(
+    struct InflateStream* inflate_stream,
+    unsigned char* data,
+    unsigned char* out_buf
+)
+{
+    int data_kind = 0;
+    size_t strategy_index = 0;
+
+    for (data_kind = 0; data_kind < TEST_DATA_KIND_COUNT; ++data_kind)
+    {
+        uhashtools_test_fill_data((enum TestDataKind) data_kind, data, TEST_TRUNCATED_DATA_SIZE);
+
+        for (strategy_index = 0; strategy_index < sizeof test_strategies / sizeof test_strategies[0]; ++strategy_index)
+        {
+            size_t compressed_size = 0;
+            unsigned char* compressed = uhashtools_test_deflate(data, TEST_TRUNCATED_DATA_SIZE, 6, test_strategies[strategy_index], &compressed_size);
+            size_t truncated_size = 0;
+
+            for (truncated_size = 0; compressed && truncated_size < compressed_size; ++truncated_size)
+            {
+                size_t out_size = 0;
+
+                /*
+                 * The padding zeros of a truncated stream are decoded until
+                 * the output is full, a few times the data size is enough.
+                 */
+                if (uhashtools_test_inflate(inflate_stream, compressed, truncated_size, 0, 0, out_buf, TEST_TRUNCATED_DATA_SIZE * 4, &out_size))
+                {
+                    (void) printf("Stream of kind %d truncated to %lu of %lu bytes has been accepted.\n",
+                                  data_kind,
+                                  (unsigned long) truncated_size,
+                                  (unsigned long) compressed_size);
+                    UHASHTOOLS_TEST_CHECK(!"Truncated stream accepted.");
+                }
+            }
+
+            free(compressed);
+        }
+    }
+}
+
+/* Appends the bits starting with the least significant one like deflate. */
+static
+void
+uhashtools_test_put_bits
+(
+    unsigned char* buf,
+    size_t* bit_pos,
+    unsigned int value,
+    int bit_count
+)
+{
+    for (; bit_count > 0; --bit_count)
+    {
+        if (value & 1u)
+        {
+            buf[*bit_pos / 8] |= (unsigned char) (1u << (*bit_pos % 8));
+        }
+
+        value >>= 1;
+        ++*bit_pos;
+    }
+}
+
+/* Appends a code of the fixed Huffman table, which starts with its most significant bit. */
+static
+void
+uhashtools_test_put_fixed_code
+(
+    unsigned char* buf,
+    size_t* bit_pos,
+    unsigned int code,
+    int bit_count
+)
+{
+    for (; bit_count > 0; --bit_count)
+    {
+        uhashtools_test_put_bits(buf, bit_pos, (code >> (bit_count - 1)) & 1u, 1);
+    }
+}
+
+/*
+ * Streams which zlib never produces: matches which overlap themselves
+ * or reach before the start of the data, and invalid block headers.
+ */
+static
+void
+uhashtools_test_crafted_streams
+(
+    struct InflateStream* inflate_stream,
+    unsigned char* out_buf
+)
+{
+    static const unsigned char stored_length_mismatch[] = { 0x01, 0x05, 0x00, 0x00, 0x00, 'a', 'b', 'c', 'd', 'e' };
+    static const unsigned char reserved_block_type[] = { 0x07, 0x00 };
+    unsigned char crafted[16];
+    size_t bit_pos = 0;
+    size_t out_size = 0;
+    BOOL is_inflated = FALSE;
+
+    /* Final fixed Huffman block: literal "a", match of length 3 at distance 1, end of block */
+    (void) memset((void*) crafted, 0, sizeof crafted);
+    uhashtools_test_put_bits(crafted, &bit_pos, 1, 1);
+    uhashtools_test_put_bits(crafted, &bit_pos, 1, 2);
+    uhashtools_test_put_fixed_code(crafted, &bit_pos, 0x30 + 'a', 8);
+    uhashtools_test_put_fixed_code(crafted, &bit_pos, 257 - 256, 7);
+    uhashtools_test_put_fixed_code(crafted, &bit_pos, 0, 5);
+    uhashtools_test_put_fixed_code(crafted, &bit_pos, 0, 7);
+
+    is_inflated = uhashtools_test_inflate(inflate_stream, crafted, (bit_pos + 7) / 8, 0, 0, out_buf, TEST_OUT_BUF_SIZE, &out_size);
+    UHASHTOOLS_TEST_CHECK(is_inflated && out_size == 4 && memcmp(out_buf, "aaaa", 4) == 0);
+
+    /* The same match without the literal refers to data before the start. */
+    bit_pos = 0;
+    (void) memset((void*) crafted, 0, sizeof crafted);
+    uhashtools_test_put_bits(crafted, &bit_pos, 1, 1);
+    uhashtools_test_put_bits(crafted, &bit_pos, 1, 2);
+    uhashtools_test_put_fixed_code(crafted, &bit_pos, 257 - 256, 7);
+    uhashtools_test_put_fixed_code(crafted, &bit_pos, 0, 5);
+    uhashtools_test_put_fixed_code(crafted, &bit_pos, 0, 7);
+
+    is_inflated = uhashtools_test_inflate(inflate_stream, crafted, (bit_pos + 7) / 8, 0, 0, out_buf, TEST_OUT_BUF_SIZE, &out_size);
+    UHASHTOOLS_TEST_CHECK(!is_inflated);
+
+    is_inflated = uhashtools_test_inflate(inflate_stream,
+                                          stored_length_mismatch,
+                                          sizeof stored_length_mismatch,
+                                          0,
+                                          0,
+                                          out_buf,
+                                          TEST_OUT_BUF_SIZE,
+                                          &out_size);
+    UHASHTOOLS_TEST_CHECK(!is_inflated);
+
+    is_inflated = uhashtools_test_inflate(inflate_stream,
+                                          reserved_block_type,
+                                          sizeof reserved_block_type,
+                                          0,
+                                          0,
+                                          out_buf,
+                                          TEST_OUT_BUF_SIZE,
+                                          &out_size);
+    UHASHTOOLS_TEST_CHECK(!is_inflated);
+}
+
+/*
+ * Damaged streams may be accepted if they still form a valid stream, but
+ * they must never make the inflate implementation leave its buffers.
+ */
+static
+void
+uhashtools_test_damaged_streams
+(
+    struct InflateStream* inflate_stream,
+    unsigned char* data,
+    unsigned char* out_buf
+)
+{
+    size_t base_sizes[TEST_DATA_KIND_COUNT * 2];
+    unsigned char* bases[TEST_DATA_KIND_COUNT * 2];
+    unsigned char* damaged = (unsigned char*) malloc(TEST_MAX_DATA_SIZE);
+    size_t base_index = 0;
+    size_t stream_index = 0;
+
+    UHASHTOOLS_TEST_CHECK(damaged != NULL);
+
+    for (base_index = 0; base_index < TEST_DATA_KIND_COUNT * 2; ++base_index)
+    {
+        uhashtools_test_fill_data((enum TestDataKind) (base_index / 2), data, 3000);
+        bases[base_index] = uhashtools_test_deflate(data,
+                                                    3000,
+                                                    6,
+                                                    base_index % 2 == 0 ? Z_DEFAULT_STRATEGY : Z_FIXED,
+                                                    &base_sizes[base_index]);
+        UHASHTOOLS_TEST_CHECK(bases[base_index] && base_sizes[base_index] <= TEST_MAX_DATA_SIZE);
+    }
+
+    for (stream_index = 0; damaged && stream_index < TEST_DAMAGED_STREAMS_COUNT; ++stream_index)
+    {
+        size_t damaged_size = 0;
+        size_t out_size = 0;
+        unsigned int changes_count = (unsigned int) (uhashtools_test_random() % 8) + 1;
+
+        base_index = (size_t) (uhashtools_test_random() % (TEST_DATA_KIND_COUNT * 2));
+
+        if (!bases[base_index])
+        {
+            continue;
+        }
+
+        damaged_size = base_sizes[base_index];
+        (void) memcpy((void*) damaged, (const void*) bases[base_index], damaged_size);
+
+        for (; changes_count > 0; --changes_count)
+        {
+            damaged[uhashtools_test_random() % damaged_size] = (unsigned char) uhashtools_test_random();
+        }
+
+        if (uhashtools_test_random() % 5 == 0)
+        {
+            damaged_size = (size_t) (uhashtools_test_random() % (damaged_size + 1));
+        }
+
+        (void) uhashtools_test_inflate(inflate_stream, damaged, damaged_size, 0, 0, out_buf, TEST_OUT_BUF_SIZE, &out_size);
+    }
+
+    for (base_index = 0; base_index < TEST_DATA_KIND_COUNT * 2; ++base_index)
+    {
+        free(bases[base_index]);
+    }
+
+    free(damaged);
+}
+
+int
+main
+(
+    void
+)
+{
+    struct InflateStream* inflate_stream = (struct InflateStream*) malloc(sizeof *inflate_stream);
+    unsigned char* data = (unsigned char*) malloc(TEST_MAX_DATA_SIZE);
+    unsigned char* out_buf = (unsigned char*) malloc(TEST_OUT_BUF_SIZE);
+
+    UHASHTOOLS_TEST_CHECK(inflate_stream && data && out_buf);
+
+    if (inflate_stream && data && out_buf)
+    {
+        uhashtools_test_valid_streams(inflate_stream, data, out_buf);
+        uhashtools_test_truncated_streams(inflate_stream, data, out_buf);
+        uhashtools_test_crafted_streams(inflate_stream, out_buf);
+        uhashtools_test_damaged_streams(inflate_stream, data, out_buf);
+    }
+
+    free(out_buf);
+    free(data);
+    free(inflate_stream);
+
+    return uhashtools_test_finish("test_inflate");
+}
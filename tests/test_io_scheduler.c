@@ -0,0 +1,595 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Tests the scheduling policy of the I/O scheduler with simulated
+ * devices: the amount of readers per media type, the order in which the
+ * files of a device are taken and the separation of the devices. Then
+ * the reader and opener threads of "uhashtools_io_scheduler_run()" are
+ * checked with a job function which sleeps instead of reading.
+ * 
+ * Finally the opener threads are measured with 120 files, whose opening
+ * takes 20 ms each like on a network share and whose hashing takes 20 ms
+ * each, once with a single reader and once with four readers.
+ * 
+ * The simulated files are identified by their file size, which is their
+ * index within the test.
+ */
+
+#include "test_utilities.h"
+
+#include "io_scheduler.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+
+#define TEST_MAX_JOBS_COUNT 128
+#define TEST_MAX_DEVICES_COUNT 4
+
+#define TEST_RUN_READ_MS 10
+
+#define TEST_OPEN_LATENCY_FILES_COUNT 120
+#define TEST_OPEN_LATENCY_MS 20
+#define TEST_OPEN_LATENCY_READ_MS 20
+
+struct TestJobRecord
+{
+    unsigned int opened_count;
+    unsigned int processed_count;
+    size_t processed_order;
+    size_t reader_index;
+};
+
+struct TestRunCtx
+{
+    CRITICAL_SECTION lock;
+    struct TestJobRecord job_records[TEST_MAX_JOBS_COUNT];
+    size_t processed_jobs_count;
+    BOOL had_wrong_opened_data;
+    unsigned int read_ms;
+    unsigned int open_ms;
+
+    /* Readers which are processing a file at the same time */
+    size_t active_readers_count[TEST_MAX_DEVICES_COUNT];
+    size_t max_active_readers_count[TEST_MAX_DEVICES_COUNT];
+    size_t all_active_readers_count;
+    size_t max_all_active_readers_count;
+};
+
+static
+void
+uhashtools_test_add_job
+(
+    struct IoScheduler* io_scheduler,
+    size_t job_id,
+    size_t device_index,
+    unsigned __int64 physical_offset
+)
+{
+    wchar_t filepath[32];
+
+    (void) swprintf(filepath, sizeof filepath / sizeof filepath[0], L"C:\\test\\file_%03u.bin", (unsigned int) job_id);
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_add_job(io_scheduler,
+                                                          filepath,
+                                                          (unsigned __int64) job_id,
+                                                          device_index,
+                                                          physical_offset));
+}
+
+/* Checks that the device hands out exactly the expected jobs in the expected order. */
+static
+void
+uhashtools_test_check_taken_jobs
+(
+    struct IoScheduler* io_scheduler,
+    size_t device_index,
+    const size_t* expected_job_ids,
+    size_t expected_jobs_count
+)
+{
+    size_t job_index = 0;
+
+    for (job_index = 0; job_index < expected_jobs_count; ++job_index)
+    {
+        const struct IoSchedulerJob* job = uhashtools_io_scheduler_take_job(io_scheduler, device_index);
+
+        UHASHTOOLS_TEST_CHECK(job != NULL);
+        if (!job)
+        {
+            return;
+        }
+
+        UHASHTOOLS_TEST_CHECK(job->file_size == expected_job_ids[job_index]);
+        UHASHTOOLS_TEST_CHECK(job->device_index == device_index);
+    }
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_take_job(io_scheduler, device_index) == NULL);
+}
+
+static
+void
+uhashtools_test_seek_penalty_device
+(
+    void
+)
+{
+    static const size_t expected_job_ids[] = { 2, 5, 3, 0, 1, 4, 6 };
+    struct IoScheduler* io_scheduler = uhashtools_io_scheduler_create();
+    size_t device_index = 0;
+
+    UHASHTOOLS_TEST_CHECK(io_scheduler != NULL);
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_add_device(io_scheduler,
+                                                             IoSchedulerMediaType_SEEK_PENALTY,
+                                                             &device_index));
+
+    /* Files with an unknown position are read last in the order in which they have been added. */
+    uhashtools_test_add_job(io_scheduler, 0, device_index, 5000000000ULL);
+    uhashtools_test_add_job(io_scheduler, 1, device_index, IO_SCHEDULER_UNKNOWN_PHYSICAL_OFFSET);
+    uhashtools_test_add_job(io_scheduler, 2, device_index, 4096);
+    uhashtools_test_add_job(io_scheduler, 3, device_index, 3000000000ULL);
+    uhashtools_test_add_job(io_scheduler, 4, device_index, IO_SCHEDULER_UNKNOWN_PHYSICAL_OFFSET);
+    uhashtools_test_add_job(io_scheduler, 5, device_index, 8192);
+    uhashtools_test_add_job(io_scheduler, 6, device_index, IO_SCHEDULER_UNKNOWN_PHYSICAL_OFFSET);
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_prepare(io_scheduler) == 1);
+
+    uhashtools_test_check_taken_jobs(io_scheduler,
+                                     device_index,
+                                     expected_job_ids,
+                                     sizeof expected_job_ids / sizeof expected_job_ids[0]);
+
+    uhashtools_io_scheduler_destroy(io_scheduler);
+}
+
+static
+void
+uhashtools_test_unknown_device
+(
+    void
+)
+{
+    static const size_t expected_job_ids[] = { 0, 1, 2, 3 };
+    struct IoScheduler* io_scheduler = uhashtools_io_scheduler_create();
+    size_t device_index = 0;
+
+    UHASHTOOLS_TEST_CHECK(io_scheduler != NULL);
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_add_device(io_scheduler,
+                                                             IoSchedulerMediaType_UNKNOWN,
+                                                             &device_index));
+
+    /* Without a known seek penalty the positions are ignored. */
+    uhashtools_test_add_job(io_scheduler, 0, device_index, 3000);
+    uhashtools_test_add_job(io_scheduler, 1, device_index, 1000);
+    uhashtools_test_add_job(io_scheduler, 2, device_index, IO_SCHEDULER_UNKNOWN_PHYSICAL_OFFSET);
+    uhashtools_test_add_job(io_scheduler, 3, device_index, 2000);
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_prepare(io_scheduler) == 1);
+
+    uhashtools_test_check_taken_jobs(io_scheduler,
+                                     device_index,
+                                     expected_job_ids,
+                                     sizeof expected_job_ids / sizeof expected_job_ids[0]);
+
+    uhashtools_io_scheduler_destroy(io_scheduler);
+}
+
+static
+void
+uhashtools_test_no_seek_penalty_device
+(
+    size_t jobs_count
+)
+{
+    struct IoScheduler* io_scheduler = uhashtools_io_scheduler_create();
+    size_t expected_job_ids[TEST_MAX_JOBS_COUNT];
+    size_t expected_readers_count = jobs_count < IO_SCHEDULER_SSD_READERS ? jobs_count : IO_SCHEDULER_SSD_READERS;
+    size_t device_index = 0;
+    size_t job_id = 0;
+
+    UHASHTOOLS_TEST_CHECK(io_scheduler != NULL);
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_add_device(io_scheduler,
+                                                             IoSchedulerMediaType_NO_SEEK_PENALTY,
+                                                             &device_index));
+
+    /* Descending positions, which would reverse the order if they were used. */
+    for (job_id = 0; job_id < jobs_count; ++job_id)
+    {
+        uhashtools_test_add_job(io_scheduler, job_id, device_index, (unsigned __int64) (jobs_count - job_id) * 4096);
+        expected_job_ids[job_id] = job_id;
+    }
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_prepare(io_scheduler) == expected_readers_count);
+
+    uhashtools_test_check_taken_jobs(io_scheduler, device_index, expected_job_ids, jobs_count);
+
+    uhashtools_io_scheduler_destroy(io_scheduler);
+}
+
+static
+void
+uhashtools_test_separate_devices
+(
+    void
+)
+{
+    static const size_t expected_hdd_job_ids[] = { 3, 0, 6 };
+    static const size_t expected_ssd_job_ids[] = { 1, 4, 7, 8, 9 };
+    static const size_t expected_unknown_job_ids[] = { 2, 5 };
+    struct IoScheduler* io_scheduler = uhashtools_io_scheduler_create();
+    size_t hdd_device_index = 0;
+    size_t ssd_device_index = 0;
+    size_t unknown_device_index = 0;
+    size_t empty_device_index = 0;
+
+    UHASHTOOLS_TEST_CHECK(io_scheduler != NULL);
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_add_device(io_scheduler,
+                                                             IoSchedulerMediaType_SEEK_PENALTY,
+                                                             &hdd_device_index));
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_add_device(io_scheduler,
+                                                             IoSchedulerMediaType_NO_SEEK_PENALTY,
+                                                             &ssd_device_index));
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_add_device(io_scheduler,
+                                                             IoSchedulerMediaType_UNKNOWN,
+                                                             &unknown_device_index));
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_add_device(io_scheduler,
+                                                             IoSchedulerMediaType_NO_SEEK_PENALTY,
+                                                             &empty_device_index));
+
+    /* The files of the devices are interleaved and share their positions. */
+    uhashtools_test_add_job(io_scheduler, 0, hdd_device_index, 2000);
+    uhashtools_test_add_job(io_scheduler, 1, ssd_device_index, 2000);
+    uhashtools_test_add_job(io_scheduler, 2, unknown_device_index, 2000);
+    uhashtools_test_add_job(io_scheduler, 3, hdd_device_index, 1000);
+    uhashtools_test_add_job(io_scheduler, 4, ssd_device_index, 1000);
+    uhashtools_test_add_job(io_scheduler, 5, unknown_device_index, 1000);
+    uhashtools_test_add_job(io_scheduler, 6, hdd_device_index, 3000);
+    uhashtools_test_add_job(io_scheduler, 7, ssd_device_index, 3000);
+    uhashtools_test_add_job(io_scheduler, 8, ssd_device_index, 500);
+    uhashtools_test_add_job(io_scheduler, 9, ssd_device_index, 4000);
+
+    /* One reader for the hard disk and the unknown device, four for the SSD and none for the empty device. */
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_prepare(io_scheduler) == 1 + IO_SCHEDULER_SSD_READERS + 1);
+
+    /* Taking all files of one device leaves the other devices untouched. */
+    uhashtools_test_check_taken_jobs(io_scheduler,
+                                     ssd_device_index,
+                                     expected_ssd_job_ids,
+                                     sizeof expected_ssd_job_ids / sizeof expected_ssd_job_ids[0]);
+    uhashtools_test_check_taken_jobs(io_scheduler,
+                                     hdd_device_index,
+                                     expected_hdd_job_ids,
+                                     sizeof expected_hdd_job_ids / sizeof expected_hdd_job_ids[0]);
+    uhashtools_test_check_taken_jobs(io_scheduler,
+                                     unknown_device_index,
+                                     expected_unknown_job_ids,
+                                     sizeof expected_unknown_job_ids / sizeof expected_unknown_job_ids[0]);
+    uhashtools_test_check_taken_jobs(io_scheduler, empty_device_index, NULL, 0);
+
+    uhashtools_io_scheduler_destroy(io_scheduler);
+}
+
+/* Without volumes on Linux all files are landing on the shared unknown device. */
+static
+void
+uhashtools_test_add_file
+(
+    void
+)
+{
+    static const size_t expected_job_ids[] = { 0, 1, 2 };
+    struct IoScheduler* io_scheduler = uhashtools_io_scheduler_create();
+    const struct IoSchedulerJob* job = NULL;
+
+    UHASHTOOLS_TEST_CHECK(io_scheduler != NULL);
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_add_file(io_scheduler, L"C:\\test\\a.bin", 0));
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_add_file(io_scheduler, L"D:\\test\\b.bin", 1));
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_add_file(io_scheduler, L"\\\\server\\share\\c.bin", 2));
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_prepare(io_scheduler) == 1);
+
+    job = uhashtools_io_scheduler_take_job(io_scheduler, 0);
+    UHASHTOOLS_TEST_CHECK(job && wcscmp(job->filepath, L"C:\\test\\a.bin") == 0);
+    UHASHTOOLS_TEST_CHECK(job && job->physical_offset == IO_SCHEDULER_UNKNOWN_PHYSICAL_OFFSET);
+
+    uhashtools_test_check_taken_jobs(io_scheduler,
+                                     0,
+                                     expected_job_ids + 1,
+                                     sizeof expected_job_ids / sizeof expected_job_ids[0] - 1);
+
+    uhashtools_io_scheduler_destroy(io_scheduler);
+}
+
+static
+void*
+uhashtools_test_open_function
+(
+    const struct IoSchedulerJob* job,
+    void* userdata
+)
+{
+    struct TestRunCtx* ctx = (struct TestRunCtx*) userdata;
+    struct TestJobRecord* job_record = &ctx->job_records[job->file_size];
+
+    Sleep(ctx->open_ms);
+
+    EnterCriticalSection(&ctx->lock);
+    ++job_record->opened_count;
+    LeaveCriticalSection(&ctx->lock);
+
+    return (void*) job_record;
+}
+
+static
+void
+uhashtools_test_job_function
+(
+    const struct IoSchedulerJob* job,
+    void* opened_data,
+    size_t reader_index,
+    void* userdata
+)
+{
+    struct TestRunCtx* ctx = (struct TestRunCtx*) userdata;
+    struct TestJobRecord* job_record = &ctx->job_records[job->file_size];
+
+    EnterCriticalSection(&ctx->lock);
+
+    if (ctx->open_ms > 0 && opened_data != (void*) job_record)
+    {
+        ctx->had_wrong_opened_data = TRUE;
+    }
+
+    ++job_record->processed_count;
+    job_record->processed_order = ctx->processed_jobs_count++;
+    job_record->reader_index = reader_index;
+
+    if (++ctx->active_readers_count[job->device_index] > ctx->max_active_readers_count[job->device_index])
+    {
+        ctx->max_active_readers_count[job->device_index] = ctx->active_readers_count[job->device_index];
+    }
+
+    if (++ctx->all_active_readers_count > ctx->max_all_active_readers_count)
+    {
+        ctx->max_all_active_readers_count = ctx->all_active_readers_count;
+    }
+
+    LeaveCriticalSection(&ctx->lock);
+
+    Sleep(ctx->read_ms);
+
+    EnterCriticalSection(&ctx->lock);
+    --ctx->active_readers_count[job->device_index];
+    --ctx->all_active_readers_count;
+    LeaveCriticalSection(&ctx->lock);
+}
+
+static
+void
+uhashtools_test_run
+(
+    BOOL use_open_function
+)
+{
+    static const unsigned __int64 hdd_physical_offsets[] = { 7000, 1000, IO_SCHEDULER_UNKNOWN_PHYSICAL_OFFSET, 5000,
+                                                             3000, 2000, 6000, 4000 };
+    const size_t hdd_jobs_count = sizeof hdd_physical_offsets / sizeof hdd_physical_offsets[0];
+    const size_t ssd_jobs_count = 12;
+    const size_t unknown_jobs_count = 5;
+    const size_t jobs_count = hdd_jobs_count + ssd_jobs_count + unknown_jobs_count;
+    struct IoScheduler* io_scheduler = uhashtools_io_scheduler_create();
+    struct TestRunCtx ctx;
+    size_t hdd_device_index = 0;
+    size_t ssd_device_index = 0;
+    size_t unknown_device_index = 0;
+    size_t readers_count = 0;
+    size_t job_id = 0;
+    size_t other_job_id = 0;
+
+    (void) memset((void*) &ctx, 0, sizeof ctx);
+    InitializeCriticalSection(&ctx.lock);
+    ctx.read_ms = TEST_RUN_READ_MS;
+    ctx.open_ms = use_open_function ? 1 : 0;
+
+    UHASHTOOLS_TEST_CHECK(io_scheduler != NULL);
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_add_device(io_scheduler,
+                                                             IoSchedulerMediaType_SEEK_PENALTY,
+                                                             &hdd_device_index));
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_add_device(io_scheduler,
+                                                             IoSchedulerMediaType_NO_SEEK_PENALTY,
+                                                             &ssd_device_index));
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_add_device(io_scheduler,
+                                                             IoSchedulerMediaType_UNKNOWN,
+                                                             &unknown_device_index));
+
+    for (job_id = 0; job_id < jobs_count; ++job_id)
+    {
+        if (job_id < hdd_jobs_count)
+        {
+            uhashtools_test_add_job(io_scheduler, job_id, hdd_device_index, hdd_physical_offsets[job_id]);
+        }
+        else if (job_id < hdd_jobs_count + ssd_jobs_count)
+        {
+            uhashtools_test_add_job(io_scheduler, job_id, ssd_device_index, 0);
+        }
+        else
+        {
+            uhashtools_test_add_job(io_scheduler, job_id, unknown_device_index, 0);
+        }
+    }
+
+    readers_count = uhashtools_io_scheduler_prepare(io_scheduler);
+    UHASHTOOLS_TEST_CHECK(readers_count == 1 + IO_SCHEDULER_SSD_READERS + 1);
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_run(io_scheduler,
+                                                      use_open_function ? uhashtools_test_open_function : NULL,
+                                                      uhashtools_test_job_function,
+                                                      (void*) &ctx));
+
+    UHASHTOOLS_TEST_CHECK(ctx.processed_jobs_count == jobs_count);
+    UHASHTOOLS_TEST_CHECK(!ctx.had_wrong_opened_data);
+
+    for (job_id = 0; job_id < jobs_count; ++job_id)
+    {
+        const struct TestJobRecord* job_record = &ctx.job_records[job_id];
+
+        UHASHTOOLS_TEST_CHECK(job_record->processed_count == 1);
+        UHASHTOOLS_TEST_CHECK(job_record->opened_count == (use_open_function ? 1U : 0U));
+        UHASHTOOLS_TEST_CHECK(job_record->reader_index < readers_count);
+    }
+
+    /* The single readers are processing their files in the order of "uhashtools_test_seek_penalty_device()". */
+    for (job_id = 0; job_id < hdd_jobs_count; ++job_id)
+    {
+        for (other_job_id = 0; other_job_id < hdd_jobs_count; ++other_job_id)
+        {
+            if (hdd_physical_offsets[job_id] < hdd_physical_offsets[other_job_id])
+            {
+                UHASHTOOLS_TEST_CHECK(ctx.job_records[job_id].processed_order < ctx.job_records[other_job_id].processed_order);
+            }
+        }
+    }
+
+    for (job_id = hdd_jobs_count + ssd_jobs_count + 1; job_id < jobs_count; ++job_id)
+    {
+        UHASHTOOLS_TEST_CHECK(ctx.job_records[job_id - 1].processed_order < ctx.job_records[job_id].processed_order);
+    }
+
+    UHASHTOOLS_TEST_CHECK(ctx.max_active_readers_count[hdd_device_index] == 1);
+    UHASHTOOLS_TEST_CHECK(ctx.max_active_readers_count[unknown_device_index] == 1);
+    UHASHTOOLS_TEST_CHECK(ctx.max_active_readers_count[ssd_device_index] > 1);
+    UHASHTOOLS_TEST_CHECK(ctx.max_active_readers_count[ssd_device_index] <= IO_SCHEDULER_SSD_READERS);
+
+    /* The devices are read in parallel. */
+    UHASHTOOLS_TEST_CHECK(ctx.max_all_active_readers_count > ctx.max_active_readers_count[ssd_device_index]);
+
+    uhashtools_io_scheduler_destroy(io_scheduler);
+    DeleteCriticalSection(&ctx.lock);
+}
+
+/* Returns the seconds for processing the files of a simulated network share. */
+static
+double
+uhashtools_test_measure_open_latency
+(
+    enum IoSchedulerMediaType media_type,
+    BOOL use_open_function
+)
+{
+    struct IoScheduler* io_scheduler = uhashtools_io_scheduler_create();
+    struct TestRunCtx ctx;
+    size_t device_index = 0;
+    size_t readers_count = 0;
+    size_t job_id = 0;
+    double start_seconds = 0.0;
+    double elapsed_seconds = 0.0;
+
+    (void) memset((void*) &ctx, 0, sizeof ctx);
+    InitializeCriticalSection(&ctx.lock);
+    ctx.read_ms = TEST_OPEN_LATENCY_READ_MS;
+    ctx.open_ms = TEST_OPEN_LATENCY_MS;
+
+    UHASHTOOLS_TEST_CHECK(io_scheduler != NULL);
+    UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_add_device(io_scheduler, media_type, &device_index));
+
+    for (job_id = 0; job_id < TEST_OPEN_LATENCY_FILES_COUNT; ++job_id)
+    {
+        uhashtools_test_add_job(io_scheduler, job_id, device_index, 0);
+    }
+
+    readers_count = uhashtools_io_scheduler_prepare(io_scheduler);
+
+    start_seconds = uhashtools_test_get_seconds();
+
+    if (use_open_function)
+    {
+        UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_run(io_scheduler,
+                                                          uhashtools_test_open_function,
+                                                          uhashtools_test_job_function,
+                                                          (void*) &ctx));
+    }
+    else
+    {
+        /* The job function opens the files itself. */
+        ctx.read_ms += ctx.open_ms;
+        ctx.open_ms = 0;
+
+        UHASHTOOLS_TEST_CHECK(uhashtools_io_scheduler_run(io_scheduler,
+                                                          NULL,
+                                                          uhashtools_test_job_function,
+                                                          (void*) &ctx));
+    }
+
+    elapsed_seconds = uhashtools_test_get_seconds() - start_seconds;
+
+    UHASHTOOLS_TEST_CHECK(ctx.processed_jobs_count == TEST_OPEN_LATENCY_FILES_COUNT);
+    UHASHTOOLS_TEST_CHECK(!ctx.had_wrong_opened_data);
+
+    for (job_id = 0; readers_count == 1 && job_id < TEST_OPEN_LATENCY_FILES_COUNT; ++job_id)
+    {
+        UHASHTOOLS_TEST_CHECK(ctx.job_records[job_id].processed_order == job_id);
+    }
+
+    (void) printf("test_io_scheduler: %u files, %u ms to open, %u ms to hash, %u reader(s), %s: %.2f s\n",
+                  TEST_OPEN_LATENCY_FILES_COUNT,
+                  TEST_OPEN_LATENCY_MS,
+                  TEST_OPEN_LATENCY_READ_MS,
+                  (unsigned int) readers_count,
+                  use_open_function ? "opened ahead" : "opened by the readers",
+                  elapsed_seconds);
+
+    uhashtools_io_scheduler_destroy(io_scheduler);
+    DeleteCriticalSection(&ctx.lock);
+
+    return elapsed_seconds;
+}
+
+static
+void
+uhashtools_test_open_latency
+(
+    void
+)
+{
+    double serial_seconds = 0.0;
+    double open_ahead_seconds = 0.0;
+
+    /* The opener hides the whole open latency behind the hashing of the single reader. */
+    serial_seconds = uhashtools_test_measure_open_latency(IoSchedulerMediaType_UNKNOWN, FALSE);
+    open_ahead_seconds = uhashtools_test_measure_open_latency(IoSchedulerMediaType_UNKNOWN, TRUE);
+    UHASHTOOLS_TEST_CHECK(open_ahead_seconds < serial_seconds * 0.6);
+
+    /* With four readers the opener is a fifth thread which opens files. */
+    serial_seconds = uhashtools_test_measure_open_latency(IoSchedulerMediaType_NO_SEEK_PENALTY, FALSE);
+    open_ahead_seconds = uhashtools_test_measure_open_latency(IoSchedulerMediaType_NO_SEEK_PENALTY, TRUE);
+    UHASHTOOLS_TEST_CHECK(open_ahead_seconds < serial_seconds * 0.95);
+}
+
+int
+main
+(
+    void
+)
+{
+    uhashtools_test_seek_penalty_device();
+    uhashtools_test_unknown_device();
+    uhashtools_test_no_seek_penalty_device(1);
+    uhashtools_test_no_seek_penalty_device(IO_SCHEDULER_SSD_READERS - 1);
+    uhashtools_test_no_seek_penalty_device(IO_SCHEDULER_SSD_READERS);
+    uhashtools_test_no_seek_penalty_device(IO_SCHEDULER_SSD_READERS * 3 + 1);
+    uhashtools_test_separate_devices();
+    uhashtools_test_add_file();
+
+    uhashtools_test_run(FALSE);
+    uhashtools_test_run(TRUE);
+
+    uhashtools_test_open_latency();
+
+    return uhashtools_test_finish("test_io_scheduler");
+}
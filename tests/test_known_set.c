@@ -0,0 +1,492 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Tests building known sets from digest lists with the line formats of
+ * the common digest files, looking the digests up again and opening
+ * damaged known set files. The lookup in a damaged table without any
+ * empty slot must end. The digest lists and known sets are written next
+ * to the test executable and removed afterwards.
+ */
+
+#include "test_utilities.h"
+
+#include "buffer_sizes.h"
+#include "known_set.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#define TEST_MAX_DIGEST_SIZE 64
+#define TEST_DIGESTS_COUNT 20000
+#define TEST_HEADER_SIZE 64
+
+static char test_list_path[FILEPATH_BUFFER_TSIZE];
+static char test_set_path[FILEPATH_BUFFER_TSIZE];
+static wchar_t test_list_wpath[FILEPATH_BUFFER_TSIZE];
+static wchar_t test_set_wpath[FILEPATH_BUFFER_TSIZE];
+
+static unsigned char test_digests[TEST_DIGESTS_COUNT][TEST_MAX_DIGEST_SIZE];
+static unsigned char test_unknown_digests[TEST_DIGESTS_COUNT][TEST_MAX_DIGEST_SIZE];
+
+static
+void
+uhashtools_test_random_digest
+(
+    unsigned char* digest,
+    size_t digest_size
+)
+{
+    size_t i = 0;
+
+    for (i = 0; i < digest_size; ++i)
+    {
+        digest[i] = (unsigned char) uhashtools_test_random();
+    }
+}
+
+static
+void
+uhashtools_test_fprint_hex
+(
+    FILE* file,
+    const unsigned char* digest,
+    size_t digest_size,
+    BOOL is_upper_case
+)
+{
+    size_t i = 0;
+
+    for (i = 0; i < digest_size; ++i)
+    {
+        (void) fprintf(file, is_upper_case ? "%02X" : "%02x", digest[i]);
+    }
+}
+
+static
+unsigned char*
+uhashtools_test_read_file
+(
+    const char* path,
+    size_t* file_size
+)
+{
+    FILE* file = fopen(path, "rb");
+    unsigned char* content = NULL;
+    long size = 0;
+
+    *file_size = 0;
+
+    if (!file)
+    {
+        return NULL;
+    }
+
+    if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) >= 0 && fseek(file, 0, SEEK_SET) == 0)
+    {
+        content = (unsigned char*) malloc((size_t) size + 1);
+
+        if (content && fread(content, 1, (size_t) size, file) != (size_t) size)
+        {
+            free(content);
+            content = NULL;
+        }
+    }
+
+    (void) fclose(file);
+
+    *file_size = (size_t) size;
+
+    return content;
+}
+
+static
+void
+uhashtools_test_write_file
+(
+    const char* path,
+    const unsigned char* content,
+    size_t content_size
+)
+{
+    FILE* file = fopen(path, "wb");
+    BOOL is_written = FALSE;
+
+    if (file)
+    {
+        is_written = fwrite(content, 1, content_size, file) == content_size;
+        is_written = fclose(file) == 0 && is_written;
+    }
+
+    UHASHTOOLS_TEST_CHECK(is_written);
+}
+
+static
+unsigned __int64
+uhashtools_test_le64
+(
+    const unsigned char* bytes
+)
+{
+    unsigned __int64 value = 0;
+    size_t i = 0;
+
+    for (i = 8; i > 0; --i)
+    {
+        value = (value << 8) | bytes[i - 1];
+    }
+
+    return value;
+}
+
+/*
+ * Writes a digest list with the digests in the formats of the common
+ * digest files (followed by the file name, quoted as in CSV files,
+ * upper case, CRLF line endings, leading white space) and with lines
+ * which aren't digests of the given size.
+ * 
+ * @return Amount of lines which have to be skipped.
+ */
+static
+unsigned __int64
+uhashtools_test_write_digest_list
+(
+    size_t digest_size,
+    size_t digests_count,
+    BOOL with_zero_digest
+)
+{
+    static const unsigned char zero_digest[TEST_MAX_DIGEST_SIZE] = { 0 };
+    FILE* list_file = fopen(test_list_path, "wb");
+    unsigned __int64 skipped_lines_count = 0;
+    size_t i = 0;
+
+    UHASHTOOLS_TEST_CHECK(list_file != NULL);
+
+    if (!list_file)
+    {
+        return 0;
+    }
+
+    (void) fprintf(list_file, "# Digest list of the unit test\n\n");
+    skipped_lines_count += 2;
+
+    for (i = 0; i < digests_count; ++i)
+    {
+        switch (i % 6)
+        {
+            case 0:
+                uhashtools_test_fprint_hex(list_file, test_digests[i], digest_size, FALSE);
+                (void) fprintf(list_file, "  file_%lu.bin\n", (unsigned long) i);
+                break;
+            case 1:
+                uhashtools_test_fprint_hex(list_file, test_digests[i], digest_size, TRUE);
+                (void) fprintf(list_file, " *file_%lu.bin\r\n", (unsigned long) i);
+                break;
+            case 2:
+                (void) fprintf(list_file, "\"");
+                uhashtools_test_fprint_hex(list_file, test_digests[i], digest_size, FALSE);
+                (void) fprintf(list_file, "\",\"file_%lu.bin\",%lu\n", (unsigned long) i, (unsigned long) i * 7);
+                break;
+            case 3:
+                (void) fprintf(list_file, " \t");
+                uhashtools_test_fprint_hex(list_file, test_digests[i], digest_size, FALSE);
+                (void) fprintf(list_file, "\n");
+                break;
+            case 4:
+                /* The rest of the overlong line has to be skipped, it would be a digest of its own. */
+                uhashtools_test_fprint_hex(list_file, test_digests[i], digest_size, FALSE);
+                (void) fprintf(list_file, "%1100s", "");
+                uhashtools_test_fprint_hex(list_file, test_unknown_digests[i], digest_size, FALSE);
+                (void) fprintf(list_file, "\n");
+                break;
+            default:
+                /* Duplicates are added once. */
+                uhashtools_test_fprint_hex(list_file, test_digests[i], digest_size, FALSE);
+                (void) fprintf(list_file, "\n");
+                uhashtools_test_fprint_hex(list_file, test_digests[i], digest_size, TRUE);
+                (void) fprintf(list_file, "\n");
+                break;
+        }
+
+        if (i % 100 == 0)
+        {
+            /* Digests of another size, a digit which isn't hex and a quote without a digest */
+            uhashtools_test_fprint_hex(list_file, test_unknown_digests[i], digest_size - 1, FALSE);
+            (void) fprintf(list_file, "\n");
+            uhashtools_test_fprint_hex(list_file, test_unknown_digests[i], digest_size, FALSE);
+            (void) fprintf(list_file, "0\n");
+            uhashtools_test_fprint_hex(list_file, test_unknown_digests[i], digest_size / 2, FALSE);
+            (void) fprintf(list_file, "g");
+            uhashtools_test_fprint_hex(list_file, test_unknown_digests[i], digest_size / 2, FALSE);
+            (void) fprintf(list_file, "\n\"\",\"file\"\n");
+            skipped_lines_count += 4;
+        }
+    }
+
+    if (with_zero_digest)
+    {
+        uhashtools_test_fprint_hex(list_file, zero_digest, digest_size, FALSE);
+        (void) fprintf(list_file, "  empty_file.bin\n");
+    }
+
+    /* The last line has no line ending. */
+    uhashtools_test_fprint_hex(list_file, test_unknown_digests[0], digest_size, FALSE);
+    (void) fprintf(list_file, "ab");
+    ++skipped_lines_count;
+
+    UHASHTOOLS_TEST_CHECK(fclose(list_file) == 0);
+
+    return skipped_lines_count;
+}
+
+static
+void
+uhashtools_test_build_and_lookup
+(
+    size_t digest_size,
+    size_t digests_count,
+    BOOL with_zero_digest
+)
+{
+    static const unsigned char zero_digest[TEST_MAX_DIGEST_SIZE] = { 0 };
+    wchar_t error_message[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    struct KnownSet* known_set = NULL;
+    unsigned __int64 expected_skipped_lines_count = 0;
+    unsigned __int64 added_digests_count = 0;
+    unsigned __int64 skipped_lines_count = 0;
+    size_t i = 0;
+
+    /* The lowest bit keeps the short random digests of both sets apart. */
+    for (i = 0; i < TEST_DIGESTS_COUNT; ++i)
+    {
+        uhashtools_test_random_digest(test_digests[i], digest_size);
+        uhashtools_test_random_digest(test_unknown_digests[i], digest_size);
+        test_digests[i][0] &= 0xFEu;
+        test_unknown_digests[i][0] |= 0x01u;
+    }
+
+    expected_skipped_lines_count = uhashtools_test_write_digest_list(digest_size, digests_count, with_zero_digest);
+
+    if (!uhashtools_known_set_build(error_message,
+                                    GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                    test_list_wpath,
+                                    test_set_wpath,
+                                    digest_size,
+                                    &added_digests_count,
+                                    &skipped_lines_count))
+    {
+        (void) printf("Building the known set failed: %ls\n", error_message);
+        UHASHTOOLS_TEST_CHECK(!"Building the known set failed.");
+        return;
+    }
+
+    UHASHTOOLS_TEST_CHECK(added_digests_count == digests_count + (with_zero_digest ? 1 : 0));
+    UHASHTOOLS_TEST_CHECK(skipped_lines_count == expected_skipped_lines_count);
+
+    known_set = uhashtools_known_set_open(error_message, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, test_set_wpath, digest_size);
+
+    if (!known_set)
+    {
+        (void) printf("Opening the known set failed: %ls\n", error_message);
+        UHASHTOOLS_TEST_CHECK(!"Opening the known set failed.");
+        return;
+    }
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_known_set_get_digests_count(known_set) == added_digests_count);
+
+    for (i = 0; i < digests_count; ++i)
+    {
+        UHASHTOOLS_TEST_CHECK(uhashtools_known_set_contains(known_set, test_digests[i]));
+    }
+
+    /* The table compares the whole digest, so the false positives of the Bloom filter don't show. */
+    for (i = 0; i < TEST_DIGESTS_COUNT; ++i)
+    {
+        UHASHTOOLS_TEST_CHECK(!uhashtools_known_set_contains(known_set, test_unknown_digests[i]));
+    }
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_known_set_contains(known_set, zero_digest) == with_zero_digest);
+
+    uhashtools_known_set_close(known_set);
+
+    /* Other hash algorithms have another digest size. */
+    known_set = uhashtools_known_set_open(error_message, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, test_set_wpath, digest_size + 1);
+    UHASHTOOLS_TEST_CHECK(known_set == NULL);
+    uhashtools_known_set_close(known_set);
+}
+
+/* Opens a damaged known set, which must be rejected. */
+static
+void
+uhashtools_test_rejected_set
+(
+    const unsigned char* set_content,
+    size_t set_size,
+    size_t digest_size
+)
+{
+    wchar_t error_message[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    struct KnownSet* known_set = NULL;
+
+    uhashtools_test_write_file(test_set_path, set_content, set_size);
+
+    known_set = uhashtools_known_set_open(error_message, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, test_set_wpath, digest_size);
+    UHASHTOOLS_TEST_CHECK(known_set == NULL);
+    uhashtools_known_set_close(known_set);
+}
+
+static
+void
+uhashtools_test_damaged_sets
+(
+    void
+)
+{
+    const size_t digest_size = 32;
+    wchar_t error_message[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    struct KnownSet* known_set = NULL;
+    unsigned char* set_content = NULL;
+    unsigned char* damaged_content = NULL;
+    size_t set_size = 0;
+    size_t bloom_size = 0;
+    size_t i = 0;
+
+    uhashtools_test_build_and_lookup(digest_size, 1000, FALSE);
+
+    set_content = uhashtools_test_read_file(test_set_path, &set_size);
+    damaged_content = (unsigned char*) malloc(set_size + 1);
+    UHASHTOOLS_TEST_CHECK(set_content != NULL && damaged_content != NULL && set_size > TEST_HEADER_SIZE);
+
+    if (!set_content || !damaged_content || set_size <= TEST_HEADER_SIZE)
+    {
+        goto cleanup_and_out;
+    }
+
+    bloom_size = (size_t) uhashtools_test_le64(set_content + 32) * 64;
+    UHASHTOOLS_TEST_CHECK(TEST_HEADER_SIZE + bloom_size + (size_t) uhashtools_test_le64(set_content + 24) * digest_size == set_size);
+
+    /* Truncated and extended files */
+    uhashtools_test_rejected_set(set_content, TEST_HEADER_SIZE - 1, digest_size);
+    uhashtools_test_rejected_set(set_content, set_size - 1, digest_size);
+    (void) memcpy((void*) damaged_content, (const void*) set_content, set_size);
+    damaged_content[set_size] = 0;
+    uhashtools_test_rejected_set(damaged_content, set_size + 1, digest_size);
+
+    /* Another magic, a digest size which isn't supported and counts which aren't powers of two or overflow the sizes */
+    (void) memcpy((void*) damaged_content, (const void*) set_content, set_size);
+    damaged_content[0] ^= 0x01u;
+    uhashtools_test_rejected_set(damaged_content, set_size, digest_size);
+
+    (void) memcpy((void*) damaged_content, (const void*) set_content, set_size);
+    damaged_content[8] = 65;
+    uhashtools_test_rejected_set(damaged_content, set_size, 65);
+
+    (void) memcpy((void*) damaged_content, (const void*) set_content, set_size);
+    damaged_content[24] ^= 0x03u;
+    uhashtools_test_rejected_set(damaged_content, set_size, digest_size);
+
+    (void) memcpy((void*) damaged_content, (const void*) set_content, set_size);
+    (void) memset((void*) (damaged_content + 24), 0, 8);
+    damaged_content[24 + 7] = 0x80u;
+    uhashtools_test_rejected_set(damaged_content, set_size, digest_size);
+
+    (void) memcpy((void*) damaged_content, (const void*) set_content, set_size);
+    (void) memset((void*) (damaged_content + 32), 0, 8);
+    damaged_content[32 + 7] = 0x04u;
+    uhashtools_test_rejected_set(damaged_content, set_size, digest_size);
+
+    /*
+     * A table without any empty slot and a Bloom filter with all bits set.
+     * Lookups of unknown digests have to stop after probing every slot.
+     */
+    (void) memcpy((void*) damaged_content, (const void*) set_content, set_size);
+    (void) memset((void*) (damaged_content + TEST_HEADER_SIZE), 0xFF, bloom_size);
+    (void) memset((void*) (damaged_content + TEST_HEADER_SIZE + bloom_size), 0x5A, set_size - TEST_HEADER_SIZE - bloom_size);
+    uhashtools_test_write_file(test_set_path, damaged_content, set_size);
+
+    known_set = uhashtools_known_set_open(error_message, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, test_set_wpath, digest_size);
+    UHASHTOOLS_TEST_CHECK(known_set != NULL);
+
+    if (known_set)
+    {
+        for (i = 0; i < 100; ++i)
+        {
+            UHASHTOOLS_TEST_CHECK(!uhashtools_known_set_contains(known_set, test_unknown_digests[i]));
+        }
+
+        uhashtools_known_set_close(known_set);
+    }
+
+cleanup_and_out:
+    free(damaged_content);
+    free(set_content);
+}
+
+static
+void
+uhashtools_test_missing_files
+(
+    void
+)
+{
+    wchar_t error_message[GENERIC_TXT_MESSAGES_BUFFER_TSIZE];
+    wchar_t missing_path[FILEPATH_BUFFER_TSIZE];
+    unsigned __int64 added_digests_count = 0;
+    unsigned __int64 skipped_lines_count = 0;
+
+    (void) swprintf(missing_path, FILEPATH_BUFFER_TSIZE, L"%ls.missing", test_list_wpath);
+
+    UHASHTOOLS_TEST_CHECK(!uhashtools_known_set_build(error_message,
+                                                      GENERIC_TXT_MESSAGES_BUFFER_TSIZE,
+                                                      missing_path,
+                                                      test_set_wpath,
+                                                      32,
+                                                      &added_digests_count,
+                                                      &skipped_lines_count));
+    UHASHTOOLS_TEST_CHECK(uhashtools_known_set_open(error_message, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, missing_path, 32) == NULL);
+
+    /* A digest list isn't a known set. */
+    (void) uhashtools_test_write_digest_list(32, 10, FALSE);
+    UHASHTOOLS_TEST_CHECK(uhashtools_known_set_open(error_message, GENERIC_TXT_MESSAGES_BUFFER_TSIZE, test_list_wpath, 32) == NULL);
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    (void) argc;
+
+    /* The files are written next to the test executable. */
+    (void) sprintf(test_list_path, "%.*s.list.tmp", (int) (FILEPATH_BUFFER_TSIZE - 10), argv[0]);
+    (void) sprintf(test_set_path, "%.*s.set.tmp", (int) (FILEPATH_BUFFER_TSIZE - 10), argv[0]);
+    (void) mbstowcs(test_list_wpath, test_list_path, FILEPATH_BUFFER_TSIZE);
+    (void) mbstowcs(test_set_wpath, test_set_path, FILEPATH_BUFFER_TSIZE);
+
+    /* CRC-32C, SHA-256 and SHA-512 */
+    uhashtools_test_build_and_lookup(4, 2000, TRUE);
+    uhashtools_test_build_and_lookup(32, TEST_DIGESTS_COUNT, FALSE);
+    uhashtools_test_build_and_lookup(64, TEST_DIGESTS_COUNT, TRUE);
+
+    /* Empty sets */
+    uhashtools_test_build_and_lookup(32, 0, FALSE);
+    uhashtools_test_build_and_lookup(32, 0, TRUE);
+
+    uhashtools_test_damaged_sets();
+    uhashtools_test_missing_files();
+
+    (void) remove(test_list_path);
+    (void) remove(test_set_path);
+
+    return uhashtools_test_finish("test_known_set");
+}
@@ -0,0 +1,321 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Tests the asynchronous logger. Several threads write more lines than
+ * the ring buffer has slots, so it wraps around many times and the
+ * writers have to wait for free slots. Every line has to be written
+ * exactly once and the lines of a thread in their order. The lines
+ * which are written before the start and after the stop have to be
+ * written synchronously, and the lines which are queued when the
+ * logger is stopped have to be flushed by the stop.
+ * 
+ * stderr is redirected into a file next to the test executable, which
+ * is removed afterwards.
+ */
+
+#include "test_utilities.h"
+
+#include "buffer_sizes.h"
+#include "logger.h"
+
+#include <process.h>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <wchar.h>
+
+#define TEST_WRITER_THREADS_COUNT 4
+#define TEST_LINES_PER_THREAD 5000
+
+static char test_stderr_path[FILEPATH_BUFFER_TSIZE];
+
+/* Reads the lines which have been written to stderr so far. */
+static
+char*
+uhashtools_test_read_stderr
+(
+    void
+)
+{
+    FILE* file = NULL;
+    char* content = NULL;
+    long size = 0;
+
+    (void) fflush(stderr);
+
+    file = fopen(test_stderr_path, "rb");
+    if (!file)
+    {
+        return NULL;
+    }
+
+    if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) >= 0 && fseek(file, 0, SEEK_SET) == 0)
+    {
+        content = (char*) malloc((size_t) size + 1);
+
+        if (content)
+        {
+            content[fread((void*) content, 1, (size_t) size, file)] = '\0';
+        }
+    }
+
+    (void) fclose(file);
+
+    return content;
+}
+
+/* The file is opened for appending, so stderr writes at its start again. */
+static
+void
+uhashtools_test_reset_stderr
+(
+    void
+)
+{
+    (void) fflush(stderr);
+    UHASHTOOLS_TEST_CHECK(ftruncate(STDERR_FILENO, 0) == 0);
+}
+
+static
+BOOL
+uhashtools_test_is_written
+(
+    const char* line
+)
+{
+    char* content = uhashtools_test_read_stderr();
+    BOOL is_written = FALSE;
+
+    if (content)
+    {
+        is_written = strstr(content, line) != NULL;
+        free((void*) content);
+    }
+
+    return is_written;
+}
+
+static
+unsigned int
+__stdcall
+uhashtools_test_writer_thread_function
+(
+    void* thread_param
+)
+{
+    const unsigned int thread_index = (unsigned int) (size_t) thread_param;
+    unsigned int line_index = 0;
+
+    for (line_index = 0; line_index < TEST_LINES_PER_THREAD; ++line_index)
+    {
+        uhashtools_logger_write_line(LOGGER_LEVEL_INFO, L"thread %u line %u", thread_index, line_index);
+    }
+
+    return 0;
+}
+
+static
+void
+uhashtools_test_synchronous_lines
+(
+    void
+)
+{
+    uhashtools_test_reset_stderr();
+
+    /* Before the start */
+    uhashtools_logger_write_line(LOGGER_LEVEL_DEBUG, L"before %s", L"start");
+    UHASHTOOLS_TEST_CHECK(uhashtools_test_is_written("[DEBUG]: before start\n"));
+
+    uhashtools_logger_start();
+    uhashtools_logger_stop();
+
+    /* After the stop */
+    uhashtools_logger_write_line(LOGGER_LEVEL_WARN, L"after stop %d", 1);
+    UHASHTOOLS_TEST_CHECK(uhashtools_test_is_written("[WARNING]: after stop 1\n"));
+
+    /* A second stop doesn't wait for the stopped thread again. */
+    uhashtools_logger_stop();
+
+    uhashtools_logger_write_line(LOGGER_LEVEL_ERROR, L"after stop %d", 2);
+    UHASHTOOLS_TEST_CHECK(uhashtools_test_is_written("[ERROR]: after stop 2\n"));
+}
+
+static
+void
+uhashtools_test_queued_lines
+(
+    void
+)
+{
+    HANDLE thread_handles[TEST_WRITER_THREADS_COUNT];
+    unsigned int next_line_indexes[TEST_WRITER_THREADS_COUNT];
+    unsigned int written_lines_count = 0;
+    BOOL has_foreign_lines = FALSE;
+    char* content = NULL;
+    char* line = NULL;
+    unsigned int i = 0;
+
+    uhashtools_test_reset_stderr();
+    uhashtools_logger_start();
+
+    /* A second start doesn't start a second writer thread. */
+    uhashtools_logger_start();
+
+    for (i = 0; i < TEST_WRITER_THREADS_COUNT; ++i)
+    {
+        unsigned int thread_id = 0;
+
+        thread_handles[i] = (HANDLE) _beginthreadex(NULL,
+                                                    0,
+                                                    uhashtools_test_writer_thread_function,
+                                                    (void*) (size_t) i,
+                                                    0,
+                                                    &thread_id);
+
+        UHASHTOOLS_TEST_CHECK(thread_handles[i]);
+        if (!thread_handles[i])
+        {
+            exit(uhashtools_test_finish("test_logger"));
+        }
+
+        next_line_indexes[i] = 0;
+    }
+
+    for (i = 0; i < TEST_WRITER_THREADS_COUNT; ++i)
+    {
+        UHASHTOOLS_TEST_CHECK(WaitForSingleObject(thread_handles[i], INFINITE) == WAIT_OBJECT_0);
+        (void) CloseHandle(thread_handles[i]);
+    }
+
+    /* The line is usually still queued, the stop has to write it. */
+    uhashtools_logger_write_line(LOGGER_LEVEL_INFO, L"last queued line");
+    uhashtools_logger_stop();
+
+    content = uhashtools_test_read_stderr();
+    UHASHTOOLS_TEST_CHECK(content);
+    if (!content)
+    {
+        return;
+    }
+
+    for (line = strtok(content, "\n"); line; line = strtok(NULL, "\n"))
+    {
+        unsigned int thread_index = 0;
+        unsigned int line_index = 0;
+
+        if (sscanf(line, "[INFO]: thread %u line %u", &thread_index, &line_index) == 2 &&
+            thread_index < TEST_WRITER_THREADS_COUNT)
+        {
+            /* Lost, repeated or reordered lines of a thread */
+            UHASHTOOLS_TEST_CHECK(line_index == next_line_indexes[thread_index]);
+            next_line_indexes[thread_index] = line_index + 1;
+            ++written_lines_count;
+        }
+        else if (strcmp(line, "[INFO]: last queued line") == 0)
+        {
+            /* The threads have finished before the last line has been queued. */
+            UHASHTOOLS_TEST_CHECK(written_lines_count == TEST_WRITER_THREADS_COUNT * TEST_LINES_PER_THREAD);
+        }
+        else
+        {
+            has_foreign_lines = TRUE;
+        }
+    }
+
+    free((void*) content);
+
+    (void) printf("test_logger: %u threads wrote %u queued lines\n", TEST_WRITER_THREADS_COUNT, written_lines_count);
+
+    UHASHTOOLS_TEST_CHECK(written_lines_count == TEST_WRITER_THREADS_COUNT * TEST_LINES_PER_THREAD);
+    UHASHTOOLS_TEST_CHECK(!has_foreign_lines);
+    UHASHTOOLS_TEST_CHECK(uhashtools_test_is_written("[INFO]: last queued line\n"));
+}
+
+static
+void
+uhashtools_test_long_line
+(
+    void
+)
+{
+    wchar_t* long_text = (wchar_t*) malloc(sizeof(wchar_t) * LOG_LINE_BUFFER_TSIZE * 2);
+    char* content = NULL;
+    size_t i = 0;
+
+    UHASHTOOLS_TEST_CHECK(long_text);
+    if (!long_text)
+    {
+        return;
+    }
+
+    for (i = 0; i < LOG_LINE_BUFFER_TSIZE * 2 - 1; ++i)
+    {
+        long_text[i] = L'x';
+    }
+    long_text[i] = L'\0';
+
+    uhashtools_test_reset_stderr();
+    uhashtools_logger_start();
+    uhashtools_logger_write_line(LOGGER_LEVEL_INFO, L"%s", long_text);
+    uhashtools_logger_stop();
+
+    free((void*) long_text);
+
+    /* The line is cut to the size of a slot including the prefix, plus the line break. */
+    content = uhashtools_test_read_stderr();
+    UHASHTOOLS_TEST_CHECK(content);
+    if (content)
+    {
+        UHASHTOOLS_TEST_CHECK(strncmp(content, "[INFO]: xxx", 11) == 0);
+        UHASHTOOLS_TEST_CHECK(strlen(content) == LOG_LINE_BUFFER_TSIZE);
+        free((void*) content);
+    }
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    int original_stderr_fd = -1;
+    int stderr_file_fd = -1;
+
+    (void) argc;
+
+    (void) sprintf(test_stderr_path, "%.*s.err", (int) (FILEPATH_BUFFER_TSIZE - 8), argv[0]);
+
+    original_stderr_fd = dup(STDERR_FILENO);
+    stderr_file_fd = open(test_stderr_path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    UHASHTOOLS_TEST_CHECK(original_stderr_fd >= 0);
+    UHASHTOOLS_TEST_CHECK(stderr_file_fd >= 0);
+    if (original_stderr_fd < 0 || stderr_file_fd < 0 || dup2(stderr_file_fd, STDERR_FILENO) < 0)
+    {
+        return uhashtools_test_finish("test_logger");
+    }
+
+    (void) close(stderr_file_fd);
+
+    uhashtools_test_synchronous_lines();
+    uhashtools_test_queued_lines();
+    uhashtools_test_long_line();
+
+    /* The sanitizers report to the original stderr again. */
+    (void) fflush(stderr);
+    (void) dup2(original_stderr_fd, STDERR_FILENO);
+    (void) close(original_stderr_fd);
+    (void) remove(test_stderr_path);
+
+    return uhashtools_test_finish("test_logger");
+}
@@ -0,0 +1,554 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Tests the manifest mode with SHA-256 on a synthetic directory tree with
+ * nested directories and names which only differ in case. After each
+ * change of the tree the verification has to report the difference, hash
+ * only the files whose size or last write time has changed and calculate
+ * only the Merkle digests of the directories on the path to the change
+ * again. Its root digest has to be the one of a manifest which is written
+ * from scratch afterwards, which is then the manifest for the next change.
+ * Removed directories have to be skipped in the manifest without losing
+ * the entries behind them, and damaged manifests have to be rejected.
+ * 
+ * The last write times are set explicitly, so a change is always visible
+ * regardless of the timestamp resolution of the file system. All files
+ * are written next to the test executable and removed afterwards.
+ */
+
+#define _GNU_SOURCE
+
+#include "test_utilities.h"
+
+#include "buffer_sizes.h"
+#include "cli_arguments.h"
+#include "hash_calculation_impl.h"
+#include "manifest_mode.h"
+
+#include <fcntl.h>
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wchar.h>
+
+/* Last write time of the generated files, every change uses a later one. */
+#define TEST_FIRST_WRITE_TIME 1600000000
+
+enum TestPathKind
+{
+    TEST_PATH_KIND_TREE,
+    TEST_PATH_KIND_MANIFEST,
+    TEST_PATH_KIND_STDOUT,
+    TEST_PATH_KIND_STDERR,
+    TEST_PATH_KINDS_COUNT
+};
+
+/* Output of a run of the mode */
+struct TestRunResult
+{
+    int exit_code;
+    BOOL has_error_output;
+    char root_digest_hex[HASH_DIGEST_MAX_SIZE * 2 + 1];
+    BOOL is_root_matching;
+
+    /* Counts of the difference lines */
+    unsigned int changed_lines_count;
+    unsigned int added_lines_count;
+    unsigned int removed_lines_count;
+
+    /* Counts of the summary lines */
+    unsigned __int64 changed_files_count;
+    unsigned __int64 added_entries_count;
+    unsigned __int64 removed_entries_count;
+    unsigned __int64 hashed_files_count;
+    unsigned __int64 skipped_files_count;
+    unsigned __int64 recalculated_directories_count;
+};
+
+/* Expected result of a verification */
+struct TestExpectedResult
+{
+    const char* case_name;
+    unsigned __int64 changed_files_count;
+    unsigned __int64 added_entries_count;
+    unsigned __int64 removed_entries_count;
+    unsigned __int64 hashed_files_count;
+    unsigned __int64 recalculated_directories_count;
+};
+
+static char test_paths[TEST_PATH_KINDS_COUNT][FILEPATH_BUFFER_TSIZE];
+static wchar_t test_tree_wpath[FILEPATH_BUFFER_TSIZE];
+static wchar_t test_manifest_wpath[FILEPATH_BUFFER_TSIZE];
+static struct CliArguments test_write_cli_arguments;
+static struct CliArguments test_verify_cli_arguments;
+
+/* Count of the files in the tree, which have to be either hashed or skipped by the verification */
+static unsigned __int64 test_files_count = 0;
+static time_t test_next_write_time = TEST_FIRST_WRITE_TIME;
+
+static
+void
+uhashtools_test_get_tree_path
+(
+    const char* relative_path,
+    char* path_buf
+)
+{
+    (void) sprintf(path_buf, "%s/%s", test_paths[TEST_PATH_KIND_TREE], relative_path);
+}
+
+static
+void
+uhashtools_test_make_directory
+(
+    const char* relative_path
+)
+{
+    char path[FILEPATH_BUFFER_TSIZE * 2];
+
+    uhashtools_test_get_tree_path(relative_path, path);
+
+    UHASHTOOLS_TEST_CHECK(mkdir(path, 0755) == 0);
+}
+
+/* Writes the file with the content and the next last write time. */
+static
+void
+uhashtools_test_write_file
+(
+    const char* relative_path,
+    const char* content
+)
+{
+    char path[FILEPATH_BUFFER_TSIZE * 2];
+    struct timespec file_times[2];
+    FILE* handle = NULL;
+    BOOL is_new = FALSE;
+
+    uhashtools_test_get_tree_path(relative_path, path);
+    is_new = access(path, F_OK) != 0;
+
+    handle = fopen(path, "wb");
+    UHASHTOOLS_TEST_CHECK(handle);
+    if (!handle)
+    {
+        return;
+    }
+
+    UHASHTOOLS_TEST_CHECK(fputs(content, handle) >= 0);
+    UHASHTOOLS_TEST_CHECK(fclose(handle) == 0);
+
+    file_times[0].tv_sec = test_next_write_time;
+    file_times[0].tv_nsec = 0;
+    file_times[1] = file_times[0];
+    ++test_next_write_time;
+
+    UHASHTOOLS_TEST_CHECK(utimensat(AT_FDCWD, path, file_times, 0) == 0);
+
+    if (is_new)
+    {
+        ++test_files_count;
+    }
+}
+
+static
+void
+uhashtools_test_remove_file
+(
+    const char* relative_path
+)
+{
+    char path[FILEPATH_BUFFER_TSIZE * 2];
+
+    uhashtools_test_get_tree_path(relative_path, path);
+
+    UHASHTOOLS_TEST_CHECK(unlink(path) == 0);
+    --test_files_count;
+}
+
+static
+int
+uhashtools_test_remove_tree_entry
+(
+    const char* path,
+    const struct stat* entry_stat,
+    int type_flag,
+    struct FTW* ftw_buf
+)
+{
+    (void) entry_stat;
+    (void) ftw_buf;
+
+    if (type_flag == FTW_F)
+    {
+        --test_files_count;
+    }
+
+    return remove(path);
+}
+
+static
+void
+uhashtools_test_remove_tree
+(
+    const char* relative_path
+)
+{
+    char path[FILEPATH_BUFFER_TSIZE * 2];
+
+    uhashtools_test_get_tree_path(relative_path, path);
+
+    UHASHTOOLS_TEST_CHECK(nftw(path, uhashtools_test_remove_tree_entry, 16, FTW_DEPTH | FTW_PHYS) == 0);
+}
+
+/* Runs the mode in a child process and parses its output. */
+static
+void
+uhashtools_test_run_manifest_mode
+(
+    const struct CliArguments* cli_arguments,
+    struct TestRunResult* result
+)
+{
+    char line[FILEPATH_BUFFER_TSIZE * 2];
+    char root_digest_state[16];
+    FILE* output_file = NULL;
+    struct stat stderr_stat;
+
+    (void) memset((void*) result, 0, sizeof *result);
+
+    result->exit_code = uhashtools_test_run_mode(uhashtools_manifest_mode_run,
+                                                 cli_arguments,
+                                                 test_paths[TEST_PATH_KIND_STDOUT],
+                                                 test_paths[TEST_PATH_KIND_STDERR]);
+    if (result->exit_code < 0)
+    {
+        return;
+    }
+
+    result->has_error_output = stat(test_paths[TEST_PATH_KIND_STDERR], &stderr_stat) == 0 && stderr_stat.st_size > 0;
+
+    output_file = fopen(test_paths[TEST_PATH_KIND_STDOUT], "r");
+    if (!output_file)
+    {
+        return;
+    }
+
+    while (fgets(line, sizeof line, output_file))
+    {
+        if (strncmp(line, "CHANGED ", 8) == 0)
+        {
+            ++result->changed_lines_count;
+        }
+        else if (strncmp(line, "ADDED ", 6) == 0)
+        {
+            ++result->added_lines_count;
+        }
+        else if (strncmp(line, "REMOVED ", 8) == 0)
+        {
+            ++result->removed_lines_count;
+        }
+        /* A failed "sscanf()" may have assigned some values already, so the kind of the line is checked first. */
+        else if (strstr(line, " files changed, ") != NULL &&
+                 sscanf(line,
+                        "# %llu files changed, %llu entries added, %llu entries removed",
+                        &result->changed_files_count,
+                        &result->added_entries_count,
+                        &result->removed_entries_count) == 3)
+        {
+            continue;
+        }
+        else if (strstr(line, " directory digests recalculated") != NULL &&
+                 sscanf(line,
+                        "# %llu files hashed, %llu files unchanged by size and last write time, %llu directory digests recalculated",
+                        &result->hashed_files_count,
+                        &result->skipped_files_count,
+                        &result->recalculated_directories_count) == 3)
+        {
+            continue;
+        }
+        else if (strstr(line, " files hashed, root digest ") != NULL &&
+                 sscanf(line, "# %llu files hashed, root digest %128s", &result->hashed_files_count, result->root_digest_hex) == 2)
+        {
+            continue;
+        }
+        else if (sscanf(line, "# Root digest %128s %15s the manifest", result->root_digest_hex, root_digest_state) == 2)
+        {
+            result->is_root_matching = strcmp(root_digest_state, "matches") == 0;
+        }
+        else
+        {
+            (void) printf("test_manifest_mode: Unexpected output line: %s", line);
+            UHASHTOOLS_TEST_CHECK(FALSE);
+        }
+    }
+
+    (void) fclose(output_file);
+}
+
+/* Writes the manifest from scratch and returns the root digest of the tree. */
+static
+void
+uhashtools_test_write_manifest
+(
+    char* root_digest_hex
+)
+{
+    struct TestRunResult result;
+
+    uhashtools_test_run_manifest_mode(&test_write_cli_arguments, &result);
+
+    UHASHTOOLS_TEST_CHECK(result.exit_code == 0);
+    UHASHTOOLS_TEST_CHECK(!result.has_error_output);
+    UHASHTOOLS_TEST_CHECK(result.hashed_files_count == test_files_count);
+    UHASHTOOLS_TEST_CHECK(result.root_digest_hex[0] != '\0');
+
+    (void) strcpy(root_digest_hex, result.root_digest_hex);
+}
+
+/*
+ * Verifies the changed tree against the manifest of the previous case,
+ * then replaces the manifest with one of the changed tree.
+ */
+static
+void
+uhashtools_test_verify_manifest
+(
+    const struct TestExpectedResult* expected_result,
+    char* previous_root_digest_hex
+)
+{
+    const BOOL is_changed = expected_result->changed_files_count > 0 ||
+                            expected_result->added_entries_count > 0 ||
+                            expected_result->removed_entries_count > 0;
+    struct TestRunResult result;
+    char fresh_root_digest_hex[HASH_DIGEST_MAX_SIZE * 2 + 1];
+
+    uhashtools_test_run_manifest_mode(&test_verify_cli_arguments, &result);
+
+    (void) printf("test_manifest_mode: %s: %llu files hashed, %llu skipped, %llu directory digests recalculated\n",
+                  expected_result->case_name,
+                  result.hashed_files_count,
+                  result.skipped_files_count,
+                  result.recalculated_directories_count);
+
+    UHASHTOOLS_TEST_CHECK(result.exit_code == (is_changed ? 1 : 0));
+    UHASHTOOLS_TEST_CHECK(!result.has_error_output);
+
+    UHASHTOOLS_TEST_CHECK(result.changed_files_count == expected_result->changed_files_count);
+    UHASHTOOLS_TEST_CHECK(result.added_entries_count == expected_result->added_entries_count);
+    UHASHTOOLS_TEST_CHECK(result.removed_entries_count == expected_result->removed_entries_count);
+    UHASHTOOLS_TEST_CHECK(result.changed_lines_count == expected_result->changed_files_count);
+    UHASHTOOLS_TEST_CHECK(result.added_lines_count == expected_result->added_entries_count);
+    UHASHTOOLS_TEST_CHECK(result.removed_lines_count == expected_result->removed_entries_count);
+
+    /* Every file is either hashed or taken from the manifest. */
+    UHASHTOOLS_TEST_CHECK(result.hashed_files_count == expected_result->hashed_files_count);
+    UHASHTOOLS_TEST_CHECK(result.skipped_files_count + result.hashed_files_count == test_files_count);
+    UHASHTOOLS_TEST_CHECK(result.recalculated_directories_count == expected_result->recalculated_directories_count);
+
+    UHASHTOOLS_TEST_CHECK(result.is_root_matching == !is_changed);
+    UHASHTOOLS_TEST_CHECK((strcmp(result.root_digest_hex, previous_root_digest_hex) == 0) == !is_changed);
+
+    uhashtools_test_write_manifest(fresh_root_digest_hex);
+
+    UHASHTOOLS_TEST_CHECK(strcmp(result.root_digest_hex, fresh_root_digest_hex) == 0);
+
+    (void) strcpy(previous_root_digest_hex, fresh_root_digest_hex);
+}
+
+/* Replaces the manifest with its first "kept_size" bytes followed by "appended_txt". */
+static
+void
+uhashtools_test_damage_manifest
+(
+    const char* case_name,
+    long kept_size,
+    const char* appended_txt
+)
+{
+    struct TestRunResult result;
+    char manifest_content[4096];
+    size_t manifest_size = 0;
+    FILE* handle = fopen(test_paths[TEST_PATH_KIND_MANIFEST], "rb");
+
+    UHASHTOOLS_TEST_CHECK(handle);
+    if (!handle)
+    {
+        return;
+    }
+
+    manifest_size = fread((void*) manifest_content, 1, sizeof manifest_content, handle);
+    (void) fclose(handle);
+
+    UHASHTOOLS_TEST_CHECK(manifest_size < sizeof manifest_content);
+
+    if (kept_size < 0)
+    {
+        kept_size += (long) manifest_size;
+    }
+
+    handle = fopen(test_paths[TEST_PATH_KIND_MANIFEST], "wb");
+    UHASHTOOLS_TEST_CHECK(handle);
+    if (!handle)
+    {
+        return;
+    }
+
+    (void) fwrite((const void*) manifest_content, 1, (size_t) kept_size, handle);
+    (void) fputs(appended_txt, handle);
+    (void) fclose(handle);
+
+    uhashtools_test_run_manifest_mode(&test_verify_cli_arguments, &result);
+
+    (void) printf("test_manifest_mode: %s: exit code %d\n", case_name, result.exit_code);
+
+    UHASHTOOLS_TEST_CHECK(result.exit_code == 1);
+    UHASHTOOLS_TEST_CHECK(result.has_error_output);
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    static const char* const path_suffixes[TEST_PATH_KINDS_COUNT] = { ".tree", ".manifest", ".out", ".err" };
+    char root_digest_hex[HASH_DIGEST_MAX_SIZE * 2 + 1];
+    struct TestExpectedResult expected_result;
+    wchar_t* cli_argv[4];
+    unsigned int i = 0;
+
+    (void) argc;
+
+    for (i = 0; i < TEST_PATH_KINDS_COUNT; ++i)
+    {
+        (void) sprintf(test_paths[i], "%.*s%s", (int) (FILEPATH_BUFFER_TSIZE - 16), argv[0], path_suffixes[i]);
+        (void) remove(test_paths[i]);
+    }
+
+    /* Leftovers of an aborted run */
+    (void) nftw(test_paths[TEST_PATH_KIND_TREE], uhashtools_test_remove_tree_entry, 16, FTW_DEPTH | FTW_PHYS);
+    test_files_count = 0;
+
+    (void) mbstowcs(test_tree_wpath, test_paths[TEST_PATH_KIND_TREE], FILEPATH_BUFFER_TSIZE);
+    (void) mbstowcs(test_manifest_wpath, test_paths[TEST_PATH_KIND_MANIFEST], FILEPATH_BUFFER_TSIZE);
+
+    /* Like "uhashtools.exe --write-manifest <manifest> <directory>" */
+    cli_argv[0] = L"uhashtools.exe";
+    cli_argv[1] = L"--write-manifest";
+    cli_argv[2] = test_manifest_wpath;
+    cli_argv[3] = test_tree_wpath;
+    uhashtools_cli_arguments_fill_from_argc_argv(&test_write_cli_arguments, 4, cli_argv);
+
+    cli_argv[1] = L"--verify-manifest";
+    uhashtools_cli_arguments_fill_from_argc_argv(&test_verify_cli_arguments, 4, cli_argv);
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_cli_arguments_has_manifest_file(&test_write_cli_arguments));
+    UHASHTOOLS_TEST_CHECK(!test_write_cli_arguments.is_manifest_verify);
+    UHASHTOOLS_TEST_CHECK(test_verify_cli_arguments.is_manifest_verify);
+
+    /* The ordinal order puts the upper case names first, "Readme.txt" and "readme.TXT" are different files. */
+    UHASHTOOLS_TEST_CHECK(mkdir(test_paths[TEST_PATH_KIND_TREE], 0755) == 0);
+    uhashtools_test_make_directory("Docs");
+    uhashtools_test_make_directory("Docs/old");
+    uhashtools_test_make_directory("Docs/old/drafts");
+    uhashtools_test_make_directory("a");
+    uhashtools_test_make_directory("a/b");
+    uhashtools_test_make_directory("a/b/c");
+    uhashtools_test_make_directory("empty");
+    uhashtools_test_write_file("Docs/Manual.txt", "manual");
+    uhashtools_test_write_file("Docs/old/notes.txt", "notes");
+    uhashtools_test_write_file("Docs/old/drafts/draft.txt", "draft");
+    uhashtools_test_write_file("Docs/zz.txt", "behind the old directory");
+    uhashtools_test_write_file("Readme.txt", "upper case");
+    uhashtools_test_write_file("a/b/c/deep.bin", "deep file, version 1");
+    uhashtools_test_write_file("a/other.txt", "other");
+    uhashtools_test_write_file("readme.TXT", "lower case");
+    uhashtools_test_write_file("z.bin", "last entry");
+
+    uhashtools_test_write_manifest(root_digest_hex);
+
+    (void) memset((void*) &expected_result, 0, sizeof expected_result);
+    expected_result.case_name = "Unchanged tree";
+    uhashtools_test_verify_manifest(&expected_result, root_digest_hex);
+
+    /* Same size, so only the last write time shows the change. */
+    uhashtools_test_write_file("a/b/c/deep.bin", "deep file, version 2");
+    (void) memset((void*) &expected_result, 0, sizeof expected_result);
+    expected_result.case_name = "Changed deep file";
+    expected_result.changed_files_count = 1;
+    expected_result.hashed_files_count = 1;
+    expected_result.recalculated_directories_count = 4;
+    uhashtools_test_verify_manifest(&expected_result, root_digest_hex);
+
+    uhashtools_test_write_file("Readme.txt", "upper case");
+    (void) memset((void*) &expected_result, 0, sizeof expected_result);
+    expected_result.case_name = "Touched file";
+    expected_result.hashed_files_count = 1;
+    uhashtools_test_verify_manifest(&expected_result, root_digest_hex);
+
+    uhashtools_test_write_file("a/b/new.txt", "added");
+    (void) memset((void*) &expected_result, 0, sizeof expected_result);
+    expected_result.case_name = "Added file";
+    expected_result.added_entries_count = 1;
+    expected_result.hashed_files_count = 1;
+    expected_result.recalculated_directories_count = 3;
+    uhashtools_test_verify_manifest(&expected_result, root_digest_hex);
+
+    uhashtools_test_remove_file("z.bin");
+    (void) memset((void*) &expected_result, 0, sizeof expected_result);
+    expected_result.case_name = "Removed file";
+    expected_result.removed_entries_count = 1;
+    expected_result.recalculated_directories_count = 1;
+    uhashtools_test_verify_manifest(&expected_result, root_digest_hex);
+
+    /* Only the directory is reported, its subtree is skipped up to "Docs/zz.txt". */
+    uhashtools_test_remove_tree("Docs/old");
+    (void) memset((void*) &expected_result, 0, sizeof expected_result);
+    expected_result.case_name = "Removed directory";
+    expected_result.removed_entries_count = 1;
+    expected_result.recalculated_directories_count = 2;
+    uhashtools_test_verify_manifest(&expected_result, root_digest_hex);
+
+    /* A file replaced by a directory is removed, the files of the directory are added. */
+    uhashtools_test_remove_file("readme.TXT");
+    uhashtools_test_make_directory("readme.TXT");
+    uhashtools_test_write_file("readme.TXT/inner.txt", "inner");
+    (void) memset((void*) &expected_result, 0, sizeof expected_result);
+    expected_result.case_name = "File replaced by a directory";
+    expected_result.added_entries_count = 1;
+    expected_result.removed_entries_count = 1;
+    expected_result.hashed_files_count = 1;
+    expected_result.recalculated_directories_count = 2;
+    uhashtools_test_verify_manifest(&expected_result, root_digest_hex);
+
+    (void) memset((void*) &expected_result, 0, sizeof expected_result);
+    expected_result.case_name = "Unchanged tree again";
+    uhashtools_test_verify_manifest(&expected_result, root_digest_hex);
+
+    uhashtools_test_damage_manifest("Truncated manifest", -10, "");
+    uhashtools_test_write_manifest(root_digest_hex);
+    uhashtools_test_damage_manifest("Trailing line", -1, "\nF 00 0 0 x\n");
+    uhashtools_test_write_manifest(root_digest_hex);
+    uhashtools_test_damage_manifest("Damaged header", 0, "# uhashtools manifest 2 32\n");
+
+    (void) nftw(test_paths[TEST_PATH_KIND_TREE], uhashtools_test_remove_tree_entry, 16, FTW_DEPTH | FTW_PHYS);
+
+    for (i = 0; i < TEST_PATH_KINDS_COUNT; ++i)
+    {
+        (void) remove(test_paths[i]);
+    }
+
+    return uhashtools_test_finish("test_manifest_mode");
+}
@@ -0,0 +1,480 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#define _GNU_SOURCE
+
+#include "test_utilities.h"
+
+#include "result_store.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <wctype.h>
+
+#define TEST_ROWS_COUNT 5000
+#define TEST_DIGEST_SIZE 32
+#define TEST_ERROR_MESSAGE L"Failed to open the selected file!"
+
+struct TestRow
+{
+    wchar_t filepath[64];
+    unsigned __int64 file_size;
+    BOOL is_failed;
+    unsigned char digest[TEST_DIGEST_SIZE];
+    unsigned int row_index;
+};
+
+static struct TestRow test_rows[TEST_ROWS_COUNT];
+static enum ResultStoreColumn expected_sort_column = RESULT_STORE_COLUMN_NONE;
+static BOOL expected_is_sort_descending = FALSE;
+
+/*
+ * Generates rows in directory batches like the batch worker appends
+ * them. The names only differ in the case sometimes, because sorting and
+ * filtering ignore the case.
+ */
+static
+void
+uhashtools_test_generate_rows
+(
+    void
+)
+{
+    unsigned int row_index = 0;
+    unsigned int byte_index = 0;
+
+    for (row_index = 0; row_index < TEST_ROWS_COUNT; ++row_index)
+    {
+        struct TestRow* test_row = &test_rows[row_index];
+        const unsigned int directory_index = (row_index / 50) % 37;
+
+        (void) swprintf(test_row->filepath,
+                        sizeof test_row->filepath / sizeof test_row->filepath[0],
+                        L"C:\\Data\\%ls%02u\\File_%04x.bin",
+                        (directory_index % 3 == 0) ? L"Dir" : L"dir",
+                        directory_index,
+                        (unsigned int) (uhashtools_test_random() % 0x1000));
+
+        test_row->file_size = uhashtools_test_random() % 100000;
+        test_row->is_failed = uhashtools_test_random() % 20 == 0;
+        test_row->row_index = row_index;
+
+        for (byte_index = 0; byte_index < TEST_DIGEST_SIZE; ++byte_index)
+        {
+            /* Few different leading bytes, so the digests have to be compared behind the sort key. */
+            test_row->digest[byte_index] = (unsigned char) (byte_index < 8 ? uhashtools_test_random() % 3 : uhashtools_test_random());
+        }
+    }
+}
+
+static
+int
+uhashtools_test_compare_txt
+(
+    const wchar_t* lhs_txt,
+    const wchar_t* rhs_txt
+)
+{
+    const int compare_rc = wcscasecmp(lhs_txt, rhs_txt);
+
+    return compare_rc < 0 ? -1 : (compare_rc > 0 ? 1 : 0);
+}
+
+/* Reference order of the views, equal rows keep the append order. */
+static
+int
+uhashtools_test_compare_rows
+(
+    const void* lhs,
+    const void* rhs
+)
+{
+    const struct TestRow* lhs_row = (const struct TestRow*) lhs;
+    const struct TestRow* rhs_row = (const struct TestRow*) rhs;
+    int compare_rc = 0;
+
+    switch (expected_sort_column)
+    {
+        case RESULT_STORE_COLUMN_FILEPATH:
+        {
+            const wchar_t* lhs_name = wcsrchr(lhs_row->filepath, L'\\');
+            const wchar_t* rhs_name = wcsrchr(rhs_row->filepath, L'\\');
+            wchar_t lhs_directory[64];
+            wchar_t rhs_directory[64];
+
+            (void) wcsncpy_s(lhs_directory, 64, lhs_row->filepath, (size_t) (lhs_name - lhs_row->filepath));
+            (void) wcsncpy_s(rhs_directory, 64, rhs_row->filepath, (size_t) (rhs_name - rhs_row->filepath));
+
+            compare_rc = uhashtools_test_compare_txt(lhs_directory, rhs_directory);
+
+            if (compare_rc == 0)
+            {
+                compare_rc = uhashtools_test_compare_txt(lhs_name + 1, rhs_name + 1);
+            }
+        } break;
+        case RESULT_STORE_COLUMN_FILE_SIZE:
+        {
+            compare_rc = lhs_row->file_size < rhs_row->file_size ? -1 : (lhs_row->file_size > rhs_row->file_size ? 1 : 0);
+        } break;
+        case RESULT_STORE_COLUMN_DIGEST:
+        {
+            if (lhs_row->is_failed || rhs_row->is_failed)
+            {
+                compare_rc = lhs_row->is_failed - rhs_row->is_failed;
+            }
+            else
+            {
+                compare_rc = memcmp((const void*) lhs_row->digest, (const void*) rhs_row->digest, TEST_DIGEST_SIZE);
+                compare_rc = compare_rc < 0 ? -1 : (compare_rc > 0 ? 1 : 0);
+            }
+        } break;
+        default:
+        {
+            /* Without a sort column descending means the reversed append order. */
+            compare_rc = lhs_row->row_index < rhs_row->row_index ? -1 : (lhs_row->row_index > rhs_row->row_index ? 1 : 0);
+        }
+    }
+
+    if (expected_is_sort_descending)
+    {
+        compare_rc = -compare_rc;
+    }
+
+    if (compare_rc == 0)
+    {
+        compare_rc = lhs_row->row_index < rhs_row->row_index ? -1 : 1;
+    }
+
+    return compare_rc;
+}
+
+static
+struct ResultStore*
+uhashtools_test_create_filled_store
+(
+    void
+)
+{
+    struct ResultStore* result_store = uhashtools_result_store_create();
+    struct HashDigest digest;
+    unsigned int row_index = 0;
+
+    UHASHTOOLS_TEST_CHECK(result_store != NULL);
+
+    digest.size = TEST_DIGEST_SIZE;
+
+    for (row_index = 0; row_index < TEST_ROWS_COUNT; ++row_index)
+    {
+        const struct TestRow* test_row = &test_rows[row_index];
+
+        (void) memcpy((void*) digest.bytes, (const void*) test_row->digest, TEST_DIGEST_SIZE);
+
+        UHASHTOOLS_TEST_CHECK(uhashtools_result_store_append(result_store,
+                                                             test_row->filepath,
+                                                             test_row->file_size,
+                                                             test_row->is_failed ? NULL : &digest,
+                                                             TEST_ERROR_MESSAGE));
+    }
+
+    return result_store;
+}
+
+static
+void
+uhashtools_test_rows_are_stored
+(
+    void
+)
+{
+    struct ResultStore* result_store = uhashtools_test_create_filled_store();
+    wchar_t filepath_buf[64];
+    struct HashDigest digest;
+    size_t failed_rows_count = 0;
+    unsigned int row_index = 0;
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_result_store_get_rows_count(result_store) == TEST_ROWS_COUNT);
+
+    for (row_index = 0; row_index < TEST_ROWS_COUNT; ++row_index)
+    {
+        const struct TestRow* test_row = &test_rows[row_index];
+
+        uhashtools_result_store_get_filepath(result_store, row_index, filepath_buf, 64);
+        UHASHTOOLS_TEST_CHECK(wcscmp(filepath_buf, test_row->filepath) == 0);
+        UHASHTOOLS_TEST_CHECK(uhashtools_result_store_get_file_size(result_store, row_index) == test_row->file_size);
+
+        if (test_row->is_failed)
+        {
+            ++failed_rows_count;
+            UHASHTOOLS_TEST_CHECK(!uhashtools_result_store_get_digest(result_store, row_index, &digest));
+            UHASHTOOLS_TEST_CHECK(wcscmp(uhashtools_result_store_get_error_message(result_store, row_index), TEST_ERROR_MESSAGE) == 0);
+        }
+        else
+        {
+            UHASHTOOLS_TEST_CHECK(uhashtools_result_store_get_digest(result_store, row_index, &digest));
+            UHASHTOOLS_TEST_CHECK(digest.size == TEST_DIGEST_SIZE);
+            UHASHTOOLS_TEST_CHECK(memcmp((const void*) digest.bytes, (const void*) test_row->digest, TEST_DIGEST_SIZE) == 0);
+            UHASHTOOLS_TEST_CHECK(uhashtools_result_store_get_error_message(result_store, row_index) == NULL);
+        }
+    }
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_result_store_get_failed_rows_count(result_store) == failed_rows_count);
+
+    uhashtools_result_store_destroy(result_store);
+}
+
+static
+void
+uhashtools_test_special_filepaths_are_stored
+(
+    void
+)
+{
+    struct ResultStore* result_store = uhashtools_result_store_create();
+    wchar_t filepath_buf[16];
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_result_store_append(result_store, L"name_only.txt", 1, NULL, NULL));
+    UHASHTOOLS_TEST_CHECK(uhashtools_result_store_append(result_store, L"C:\\root.txt", 2, NULL, L"Error"));
+    UHASHTOOLS_TEST_CHECK(uhashtools_result_store_append(result_store, L"C:\\directory\\", 3, NULL, L"Error"));
+
+    uhashtools_result_store_get_filepath(result_store, 0, filepath_buf, 16);
+    UHASHTOOLS_TEST_CHECK(wcscmp(filepath_buf, L"name_only.txt") == 0);
+    UHASHTOOLS_TEST_CHECK(wcscmp(uhashtools_result_store_get_error_message(result_store, 0), L"") == 0);
+
+    uhashtools_result_store_get_filepath(result_store, 1, filepath_buf, 16);
+    UHASHTOOLS_TEST_CHECK(wcscmp(filepath_buf, L"C:\\root.txt") == 0);
+
+    uhashtools_result_store_get_filepath(result_store, 2, filepath_buf, 16);
+    UHASHTOOLS_TEST_CHECK(wcscmp(filepath_buf, L"C:\\directory\\") == 0);
+
+    /* Too long paths are truncated. */
+    uhashtools_result_store_get_filepath(result_store, 2, filepath_buf, 8);
+    UHASHTOOLS_TEST_CHECK(wcslen(filepath_buf) < 8);
+    UHASHTOOLS_TEST_CHECK(wcsncmp(filepath_buf, L"C:\\directory\\", wcslen(filepath_buf)) == 0);
+
+    uhashtools_result_store_destroy(result_store);
+}
+
+static
+void
+uhashtools_test_check_sorted_view
+(
+    const struct ResultStore* result_store,
+    enum ResultStoreColumn sort_column,
+    BOOL is_sort_descending
+)
+{
+    struct ResultStoreViewSpec view_spec;
+    struct ResultStoreView view;
+    struct TestRow* expected_rows = NULL;
+    size_t row_index = 0;
+
+    (void) memset((void*) &view_spec, 0, sizeof view_spec);
+    view_spec.sort_column = sort_column;
+    view_spec.is_sort_descending = is_sort_descending;
+
+    expected_rows = (struct TestRow*) malloc(sizeof test_rows);
+    UHASHTOOLS_TEST_CHECK(expected_rows != NULL);
+    (void) memcpy((void*) expected_rows, (const void*) test_rows, sizeof test_rows);
+
+    expected_sort_column = sort_column;
+    expected_is_sort_descending = is_sort_descending;
+    qsort((void*) expected_rows, TEST_ROWS_COUNT, sizeof *expected_rows, &uhashtools_test_compare_rows);
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_result_store_build_view(result_store, TEST_ROWS_COUNT, &view_spec, &view));
+    UHASHTOOLS_TEST_CHECK(view.store_rows_count == TEST_ROWS_COUNT);
+    UHASHTOOLS_TEST_CHECK(view.rows_count == TEST_ROWS_COUNT);
+
+    for (row_index = 0; row_index < view.rows_count; ++row_index)
+    {
+        if (view.row_indexes[row_index] != expected_rows[row_index].row_index)
+        {
+            (void) printf("Sort column %d (descending: %d): Unexpected row at position %lu.\n",
+                          (int) sort_column,
+                          is_sort_descending,
+                          (unsigned long) row_index);
+            UHASHTOOLS_TEST_CHECK(view.row_indexes[row_index] == expected_rows[row_index].row_index);
+            break;
+        }
+    }
+
+    uhashtools_result_store_view_free(&view);
+    UHASHTOOLS_TEST_CHECK(view.row_indexes == NULL && view.rows_count == 0);
+
+    free((void*) expected_rows);
+}
+
+static
+void
+uhashtools_test_views_are_sorted
+(
+    void
+)
+{
+    struct ResultStore* result_store = uhashtools_test_create_filled_store();
+    int sort_column = 0;
+
+    for (sort_column = RESULT_STORE_COLUMN_NONE; sort_column <= RESULT_STORE_COLUMN_DIGEST; ++sort_column)
+    {
+        uhashtools_test_check_sorted_view(result_store, (enum ResultStoreColumn) sort_column, FALSE);
+        uhashtools_test_check_sorted_view(result_store, (enum ResultStoreColumn) sort_column, TRUE);
+    }
+
+    uhashtools_result_store_destroy(result_store);
+}
+
+static
+void
+uhashtools_test_lower_txt
+(
+    wchar_t* txt
+)
+{
+    for (; *txt; ++txt)
+    {
+        *txt = (wchar_t) towlower((wint_t) *txt);
+    }
+}
+
+/* Reference filter: the filepath or the hex digest contains the text ignoring the case. */
+static
+BOOL
+uhashtools_test_matches_filter
+(
+    const struct TestRow* test_row,
+    const wchar_t* lowered_filter_txt
+)
+{
+    wchar_t lowered_filepath[64];
+    wchar_t hex_digest[TEST_DIGEST_SIZE * 2 + 1];
+    unsigned int byte_index = 0;
+
+    (void) wcscpy_s(lowered_filepath, 64, test_row->filepath);
+    uhashtools_test_lower_txt(lowered_filepath);
+
+    if (wcsstr(lowered_filepath, lowered_filter_txt))
+    {
+        return TRUE;
+    }
+
+    if (test_row->is_failed)
+    {
+        return FALSE;
+    }
+
+    for (byte_index = 0; byte_index < TEST_DIGEST_SIZE; ++byte_index)
+    {
+        (void) swprintf(hex_digest + byte_index * 2, 3, L"%02x", test_row->digest[byte_index]);
+    }
+
+    return wcsstr(hex_digest, lowered_filter_txt) != NULL;
+}
+
+static
+void
+uhashtools_test_check_filtered_view
+(
+    const struct ResultStore* result_store,
+    size_t rows_count,
+    const wchar_t* filter_txt
+)
+{
+    struct ResultStoreViewSpec view_spec;
+    struct ResultStoreView view;
+    wchar_t lowered_filter_txt[RESULT_STORE_FILTER_TXT_TSIZE];
+    size_t expected_rows_count = 0;
+    size_t row_index = 0;
+    BOOL is_view_expected = TRUE;
+
+    (void) memset((void*) &view_spec, 0, sizeof view_spec);
+    (void) wcscpy_s(view_spec.filter_txt, RESULT_STORE_FILTER_TXT_TSIZE, filter_txt);
+    (void) wcscpy_s(lowered_filter_txt, RESULT_STORE_FILTER_TXT_TSIZE, filter_txt);
+    uhashtools_test_lower_txt(lowered_filter_txt);
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_result_store_build_view(result_store, rows_count, &view_spec, &view));
+
+    /* The view keeps the append order, so it has to list the matching rows one after another. */
+    for (row_index = 0; row_index < rows_count; ++row_index)
+    {
+        if (!uhashtools_test_matches_filter(&test_rows[row_index], lowered_filter_txt))
+        {
+            continue;
+        }
+
+        if (expected_rows_count >= view.rows_count || view.row_indexes[expected_rows_count] != row_index)
+        {
+            is_view_expected = FALSE;
+        }
+
+        ++expected_rows_count;
+    }
+
+    if (!is_view_expected || view.rows_count != expected_rows_count)
+    {
+        (void) printf("Filter \"%ls\": Expected %lu rows, got %lu rows.\n",
+                      filter_txt,
+                      (unsigned long) expected_rows_count,
+                      (unsigned long) view.rows_count);
+    }
+
+    UHASHTOOLS_TEST_CHECK(is_view_expected);
+    UHASHTOOLS_TEST_CHECK(view.rows_count == expected_rows_count);
+    UHASHTOOLS_TEST_CHECK(view.store_rows_count == rows_count);
+
+    uhashtools_result_store_view_free(&view);
+}
+
+static
+void
+uhashtools_test_views_are_filtered
+(
+    void
+)
+{
+    struct ResultStore* result_store = uhashtools_test_create_filled_store();
+    wchar_t hex_filter_txt[9];
+    unsigned int byte_index = 0;
+
+    for (byte_index = 0; byte_index < 4; ++byte_index)
+    {
+        (void) swprintf(hex_filter_txt + byte_index * 2, 3, L"%02X", test_rows[TEST_ROWS_COUNT / 2].digest[8 + byte_index]);
+    }
+
+    uhashtools_test_check_filtered_view(result_store, TEST_ROWS_COUNT, L"");
+    uhashtools_test_check_filtered_view(result_store, TEST_ROWS_COUNT, L"DIR07");
+    uhashtools_test_check_filtered_view(result_store, TEST_ROWS_COUNT, L"file_0a");
+    uhashtools_test_check_filtered_view(result_store, TEST_ROWS_COUNT, L"dir1\\");
+    uhashtools_test_check_filtered_view(result_store, TEST_ROWS_COUNT, L"dir12\\file_00");
+    uhashtools_test_check_filtered_view(result_store, TEST_ROWS_COUNT, L".BIN");
+    uhashtools_test_check_filtered_view(result_store, TEST_ROWS_COUNT, L"does not exist");
+    uhashtools_test_check_filtered_view(result_store, TEST_ROWS_COUNT, hex_filter_txt);
+    uhashtools_test_check_filtered_view(result_store, TEST_ROWS_COUNT, L"0a0");
+
+    /* A view which has been built while rows were still being appended. */
+    uhashtools_test_check_filtered_view(result_store, TEST_ROWS_COUNT / 3, L"dir0");
+    uhashtools_test_check_filtered_view(result_store, 0, L"dir0");
+
+    uhashtools_result_store_destroy(result_store);
+}
+
+int
+main
+(
+    void
+)
+{
+    uhashtools_test_generate_rows();
+
+    uhashtools_test_rows_are_stored();
+    uhashtools_test_special_filepaths_are_stored();
+    uhashtools_test_views_are_sorted();
+    uhashtools_test_views_are_filtered();
+
+    return uhashtools_test_finish("test_result_store");
+}
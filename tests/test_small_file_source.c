@@ -0,0 +1,191 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Tests the fast path of "hash_calculation_impl.c" for files which fit
+ * into the read buffer. Files of sizes around the size of the read
+ * buffer are hashed from the disk and their digests are compared with
+ * the digests of the same data hashed from memory.
+ * 
+ * The files up to the size of the read buffer are taken by the fast
+ * path, which neither reports progress nor checks for cancel requests.
+ * A file which is one byte bigger is taken by the regular loop, which
+ * does both, so a pending cancel request has to cancel it.
+ * 
+ * The test file is written next to the test executable and removed
+ * afterwards.
+ */
+
+#include "test_utilities.h"
+
+#include "buffer_sizes.h"
+#include "hash_calculation_impl.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#define TEST_READ_BUF_SIZE (1024 * 64)
+
+struct TestCallbackCounts
+{
+    unsigned int cancel_checks_count;
+    unsigned int progress_reports_count;
+    BOOL is_cancel_requested;
+};
+
+static
+BOOL
+uhashtools_test_check_is_cancel_requested
+(
+    void* userdata
+)
+{
+    struct TestCallbackCounts* callback_counts = (struct TestCallbackCounts*) userdata;
+
+    ++callback_counts->cancel_checks_count;
+
+    return callback_counts->is_cancel_requested;
+}
+
+static
+void
+uhashtools_test_on_progress
+(
+    const struct HashCalculationProgress* current_calculation_progress,
+    void* userdata
+)
+{
+    struct TestCallbackCounts* callback_counts = (struct TestCallbackCounts*) userdata;
+
+    (void) current_calculation_progress;
+
+    ++callback_counts->progress_reports_count;
+}
+
+static
+void
+uhashtools_test_hash_file_of_size
+(
+    const char* file_path,
+    const unsigned char* data,
+    size_t file_size,
+    unsigned char* file_read_buf,
+    BOOL is_cancel_requested
+)
+{
+    const BOOL is_fast_path = file_size <= TEST_READ_BUF_SIZE;
+    wchar_t file_wpath[FILEPATH_BUFFER_TSIZE];
+    wchar_t error_message_buf[256];
+    struct TestCallbackCounts callback_counts;
+    struct HashDigest expected_digest;
+    struct HashDigest file_digest;
+    enum HashCalculatorResultCode result_code = HashCalculatorResultCode_FAILED;
+    FILE* file = NULL;
+
+    (void) memset((void*) &callback_counts, 0, sizeof callback_counts);
+    callback_counts.is_cancel_requested = is_cancel_requested;
+
+    (void) mbstowcs(file_wpath, file_path, FILEPATH_BUFFER_TSIZE);
+
+    file = fopen(file_path, "wb");
+    UHASHTOOLS_TEST_CHECK(file);
+    if (!file)
+    {
+        return;
+    }
+
+    UHASHTOOLS_TEST_CHECK(fwrite((const void*) data, 1, file_size, file) == file_size);
+    UHASHTOOLS_TEST_CHECK(fclose(file) == 0);
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_hash_calculator_impl_hash_buffer_to_digest(data,
+                                                                                file_size,
+                                                                                &expected_digest,
+                                                                                error_message_buf,
+                                                                                sizeof error_message_buf / sizeof error_message_buf[0]));
+
+    result_code = uhashtools_hash_calculator_impl_hash_file_to_digest(file_read_buf,
+                                                                      TEST_READ_BUF_SIZE,
+                                                                      &file_digest,
+                                                                      error_message_buf,
+                                                                      sizeof error_message_buf / sizeof error_message_buf[0],
+                                                                      file_wpath,
+                                                                      &uhashtools_test_check_is_cancel_requested,
+                                                                      &callback_counts,
+                                                                      &uhashtools_test_on_progress,
+                                                                      &callback_counts);
+
+    (void) remove(file_path);
+
+    if (is_cancel_requested && !is_fast_path)
+    {
+        UHASHTOOLS_TEST_CHECK(result_code == HashCalculatorResultCode_CANCELED);
+        UHASHTOOLS_TEST_CHECK(callback_counts.cancel_checks_count > 0);
+
+        return;
+    }
+
+    UHASHTOOLS_TEST_CHECK(result_code == HashCalculatorResultCode_SUCCESS);
+    UHASHTOOLS_TEST_CHECK(file_digest.size == expected_digest.size);
+    UHASHTOOLS_TEST_CHECK(memcmp((const void*) file_digest.bytes, (const void*) expected_digest.bytes, expected_digest.size) == 0);
+
+    if (is_fast_path)
+    {
+        UHASHTOOLS_TEST_CHECK(callback_counts.cancel_checks_count == 0);
+        UHASHTOOLS_TEST_CHECK(callback_counts.progress_reports_count == 0);
+    }
+    else
+    {
+        UHASHTOOLS_TEST_CHECK(callback_counts.cancel_checks_count > 0);
+        UHASHTOOLS_TEST_CHECK(callback_counts.progress_reports_count > 0);
+    }
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    static const size_t file_sizes[] = { 0,
+                                         1,
+                                         TEST_READ_BUF_SIZE - 1,
+                                         TEST_READ_BUF_SIZE,
+                                         TEST_READ_BUF_SIZE + 1,
+                                         TEST_READ_BUF_SIZE * 3 };
+    unsigned char* data = (unsigned char*) malloc(TEST_READ_BUF_SIZE * 3);
+    unsigned char* file_read_buf = (unsigned char*) malloc(TEST_READ_BUF_SIZE);
+    char file_path[FILEPATH_BUFFER_TSIZE];
+    unsigned int i = 0;
+
+    (void) argc;
+
+    (void) sprintf(file_path, "%.*s.bin", (int) (FILEPATH_BUFFER_TSIZE - 8), argv[0]);
+
+    UHASHTOOLS_TEST_CHECK(data);
+    UHASHTOOLS_TEST_CHECK(file_read_buf);
+    if (data && file_read_buf)
+    {
+        uhashtools_test_fill_data(TEST_DATA_KIND_RANDOM, data, TEST_READ_BUF_SIZE * 3);
+
+        for (i = 0; i < sizeof file_sizes / sizeof file_sizes[0]; ++i)
+        {
+            uhashtools_test_hash_file_of_size(file_path, data, file_sizes[i], file_read_buf, FALSE);
+
+            /* The fast path ignores the cancel request, since the result is available immediately. */
+            uhashtools_test_hash_file_of_size(file_path, data, file_sizes[i], file_read_buf, TRUE);
+        }
+    }
+
+    free((void*) file_read_buf);
+    free((void*) data);
+
+    return uhashtools_test_finish("test_small_file_source");
+}
@@ -0,0 +1,290 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Tests reading sparse files through "file_source_crt.c", which returns
+ * the holes from a buffer of zeros instead of reading them. Files with
+ * holes at the start, between more data extents than are queried at once
+ * and at the end are written with "pwrite()" and "ftruncate()". The data
+ * of the file source has to be equal to the data of the file, and the
+ * holes must not be read into the read buffer. The digest of the sparse
+ * file has to match the digest of the same data written densely.
+ * 
+ * The test files are written next to the test executable and removed
+ * afterwards. The file system has to support holes.
+ */
+
+#include "test_utilities.h"
+
+#include "buffer_sizes.h"
+#include "file_source.h"
+#include "file_source_crt.h"
+#include "hash_calculation_impl.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wchar.h>
+
+#define TEST_MAX_FILE_SIZE (1024 * 1024 * 16 + 123)
+
+/* More extents than "file_source_crt.c" queries at once */
+#define TEST_EXTENTS_COUNT 100
+#define TEST_EXTENTS_DISTANCE (1024 * 128)
+
+struct TestSparseLayout
+{
+    const char* name;
+    size_t file_size;
+    size_t first_extent_offset;
+    unsigned int extents_count;
+};
+
+/* Writes the extents of the layout into the file and into "data", which stays zero elsewhere. */
+static
+BOOL
+uhashtools_test_write_sparse_file
+(
+    const char* file_path,
+    const struct TestSparseLayout* layout,
+    unsigned char* data
+)
+{
+    int file_fd = open(file_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    unsigned int i = 0;
+    BOOL ret = TRUE;
+
+    if (file_fd < 0)
+    {
+        return FALSE;
+    }
+
+    (void) memset((void*) data, 0, layout->file_size);
+
+    for (i = 0; i < layout->extents_count; ++i)
+    {
+        const size_t extent_offset = layout->first_extent_offset + (size_t) i * TEST_EXTENTS_DISTANCE;
+        size_t extent_size = 4096 + (size_t) i * 7;
+
+        if (extent_offset + extent_size > layout->file_size)
+        {
+            extent_size = layout->file_size - extent_offset;
+        }
+
+        uhashtools_test_fill_data(TEST_DATA_KIND_RANDOM, data + extent_offset, extent_size);
+
+        if (pwrite(file_fd, (const void*) (data + extent_offset), extent_size, (off_t) extent_offset) != (ssize_t) extent_size)
+        {
+            ret = FALSE;
+        }
+    }
+
+    if (ftruncate(file_fd, (off_t) layout->file_size) != 0)
+    {
+        ret = FALSE;
+    }
+
+    (void) close(file_fd);
+
+    return ret;
+}
+
+static
+BOOL
+uhashtools_test_write_dense_file
+(
+    const char* file_path,
+    const unsigned char* data,
+    size_t file_size
+)
+{
+    FILE* file = fopen(file_path, "wb");
+    BOOL ret = FALSE;
+
+    if (!file)
+    {
+        return FALSE;
+    }
+
+    ret = fwrite((const void*) data, 1, file_size, file) == file_size;
+
+    return fclose(file) == 0 && ret;
+}
+
+/* Reads the file through the CRT file source and compares the data with "data". */
+static
+void
+uhashtools_test_read_sparse_file
+(
+    const wchar_t* file_wpath,
+    const unsigned char* data,
+    size_t file_size,
+    unsigned char* file_read_buf,
+    size_t* hole_bytes_count
+)
+{
+    wchar_t error_message_buf[256];
+    struct FileSource file_source = uhashtools_file_source_crt_open(error_message_buf,
+                                                                    sizeof error_message_buf / sizeof error_message_buf[0],
+                                                                    file_wpath);
+    size_t position = 0;
+    BOOL reached_eof = FALSE;
+
+    *hole_bytes_count = 0;
+
+    UHASHTOOLS_TEST_CHECK(file_source.is_ok);
+    if (!file_source.is_ok)
+    {
+        return;
+    }
+
+    UHASHTOOLS_TEST_CHECK(file_source.has_known_size && file_source.size == file_size);
+
+    while (!reached_eof)
+    {
+        const unsigned char* read_data = NULL;
+        size_t read_data_size = 0;
+
+        if (!uhashtools_file_source_read(&file_source, file_read_buf, FILE_READ_BUF_TSIZE, &read_data, &read_data_size, &reached_eof))
+        {
+            UHASHTOOLS_TEST_CHECK(FALSE);
+            break;
+        }
+
+        if (position + read_data_size > file_size)
+        {
+            UHASHTOOLS_TEST_CHECK(FALSE);
+            break;
+        }
+
+        UHASHTOOLS_TEST_CHECK(memcmp((const void*) read_data, (const void*) (data + position), read_data_size) == 0);
+
+        if (read_data != file_read_buf)
+        {
+            *hole_bytes_count += read_data_size;
+        }
+
+        position += read_data_size;
+    }
+
+    UHASHTOOLS_TEST_CHECK(position == file_size);
+
+    uhashtools_file_source_close(&file_source);
+}
+
+static
+void
+uhashtools_test_hash_sparse_file
+(
+    const char* file_path,
+    const char* dense_file_path,
+    const struct TestSparseLayout* layout,
+    unsigned char* data,
+    unsigned char* file_read_buf
+)
+{
+    wchar_t file_wpath[FILEPATH_BUFFER_TSIZE];
+    wchar_t dense_file_wpath[FILEPATH_BUFFER_TSIZE];
+    wchar_t error_message_buf[256];
+    WIN32_FILE_ATTRIBUTE_DATA file_attribute_data;
+    struct HashDigest sparse_digest;
+    struct HashDigest dense_digest;
+    size_t hole_bytes_count = 0;
+
+    (void) mbstowcs(file_wpath, file_path, FILEPATH_BUFFER_TSIZE);
+    (void) mbstowcs(dense_file_wpath, dense_file_path, FILEPATH_BUFFER_TSIZE);
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_test_write_sparse_file(file_path, layout, data));
+    UHASHTOOLS_TEST_CHECK(uhashtools_test_write_dense_file(dense_file_path, data, layout->file_size));
+
+    /* The sparse file has to be recognized, otherwise the regular read path would be tested. */
+    UHASHTOOLS_TEST_CHECK(GetFileAttributesExW(file_wpath, GetFileExInfoStandard, (LPVOID) &file_attribute_data));
+    UHASHTOOLS_TEST_CHECK(file_attribute_data.dwFileAttributes & FILE_ATTRIBUTE_SPARSE_FILE);
+    UHASHTOOLS_TEST_CHECK(GetFileAttributesExW(dense_file_wpath, GetFileExInfoStandard, (LPVOID) &file_attribute_data));
+    UHASHTOOLS_TEST_CHECK(!(file_attribute_data.dwFileAttributes & FILE_ATTRIBUTE_SPARSE_FILE));
+
+    uhashtools_test_read_sparse_file(file_wpath, data, layout->file_size, file_read_buf, &hole_bytes_count);
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_hash_calculator_impl_hash_file_to_digest(file_read_buf,
+                                                                              FILE_READ_BUF_TSIZE,
+                                                                              &sparse_digest,
+                                                                              error_message_buf,
+                                                                              sizeof error_message_buf / sizeof error_message_buf[0],
+                                                                              file_wpath,
+                                                                              NULL,
+                                                                              NULL,
+                                                                              NULL,
+                                                                              NULL) == HashCalculatorResultCode_SUCCESS);
+    UHASHTOOLS_TEST_CHECK(uhashtools_hash_calculator_impl_hash_file_to_digest(file_read_buf,
+                                                                              FILE_READ_BUF_TSIZE,
+                                                                              &dense_digest,
+                                                                              error_message_buf,
+                                                                              sizeof error_message_buf / sizeof error_message_buf[0],
+                                                                              dense_file_wpath,
+                                                                              NULL,
+                                                                              NULL,
+                                                                              NULL,
+                                                                              NULL) == HashCalculatorResultCode_SUCCESS);
+
+    (void) remove(file_path);
+    (void) remove(dense_file_path);
+
+    (void) printf("test_sparse_file_source: %-14s %8lu bytes, %8lu bytes of holes\n",
+                  layout->name,
+                  (unsigned long) layout->file_size,
+                  (unsigned long) hole_bytes_count);
+
+    /* The holes are allocated in blocks, so only the bigger part of the zeros are holes. */
+    UHASHTOOLS_TEST_CHECK(hole_bytes_count > layout->file_size / 2);
+
+    UHASHTOOLS_TEST_CHECK(sparse_digest.size == dense_digest.size);
+    UHASHTOOLS_TEST_CHECK(memcmp((const void*) sparse_digest.bytes, (const void*) dense_digest.bytes, dense_digest.size) == 0);
+}
+
+int
+main
+(
+    int argc,
+    char** argv
+)
+{
+    static const struct TestSparseLayout layouts[] = {
+        { "leading hole", TEST_MAX_FILE_SIZE, 1024 * 1024, TEST_EXTENTS_COUNT },
+        { "leading data", TEST_MAX_FILE_SIZE, 0, TEST_EXTENTS_COUNT },
+        { "trailing data", TEST_EXTENTS_DISTANCE * 2 + 4096 + 14, 0, 3 },
+        { "only hole", TEST_MAX_FILE_SIZE, 0, 0 }
+    };
+    unsigned char* data = (unsigned char*) malloc(TEST_MAX_FILE_SIZE);
+    unsigned char* file_read_buf = (unsigned char*) malloc(FILE_READ_BUF_TSIZE);
+    char file_path[FILEPATH_BUFFER_TSIZE];
+    char dense_file_path[FILEPATH_BUFFER_TSIZE];
+    unsigned int i = 0;
+
+    (void) argc;
+
+    (void) sprintf(file_path, "%.*s.bin", (int) (FILEPATH_BUFFER_TSIZE - 8), argv[0]);
+    (void) sprintf(dense_file_path, "%.*s.dense", (int) (FILEPATH_BUFFER_TSIZE - 8), argv[0]);
+
+    UHASHTOOLS_TEST_CHECK(data);
+    UHASHTOOLS_TEST_CHECK(file_read_buf);
+    if (data && file_read_buf)
+    {
+        for (i = 0; i < sizeof layouts / sizeof layouts[0]; ++i)
+        {
+            uhashtools_test_hash_sparse_file(file_path, dense_file_path, &layouts[i], data, file_read_buf);
+        }
+    }
+
+    free((void*) file_read_buf);
+    free((void*) data);
+
+    return uhashtools_test_finish("test_sparse_file_source");
+}
@@ -0,0 +1,305 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Tests the hashing loop with the synthetic file source of debug builds
+ * ("file_source_synthetic.c"), which is opened by "file_source.c" for
+ * targets starting with "synthetic:". The sources are hashed with
+ * "uhashtools_hash_calculator_impl_hash_file_source()" like the worker
+ * hashes its opened file sources.
+ * 
+ * The digest of the generated content mustn't depend on the size of the
+ * reads or on a hidden size, and the digest of zeros has to match the
+ * digest of a buffer of zeros. The injected read errors have to fail the
+ * calculation after the data up to the failure offset has been hashed,
+ * and a cancel request has to stop a slow source.
+ */
+
+#include "test_utilities.h"
+
+#include "buffer_sizes.h"
+#include "file_source.h"
+#include "hash_calculation_impl.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#define TEST_RESULT_STRING_TSIZE 256
+#define TEST_ZERO_DATA_SIZE (1024 * 1024 + 17)
+
+struct TestCallbackState
+{
+    unsigned int cancel_checks_count;
+    unsigned int cancel_after_checks_count;
+    unsigned int progress_reports_count;
+    unsigned int progress_reports_with_known_size_count;
+    unsigned __int64 last_processed_bytes;
+};
+
+static
+BOOL
+uhashtools_test_check_is_cancel_requested
+(
+    void* userdata
+)
+{
+    struct TestCallbackState* callback_state = (struct TestCallbackState*) userdata;
+
+    ++callback_state->cancel_checks_count;
+
+    return callback_state->cancel_after_checks_count > 0 &&
+           callback_state->cancel_checks_count > callback_state->cancel_after_checks_count;
+}
+
+static
+void
+uhashtools_test_on_progress
+(
+    const struct HashCalculationProgress* current_calculation_progress,
+    void* userdata
+)
+{
+    struct TestCallbackState* callback_state = (struct TestCallbackState*) userdata;
+
+    ++callback_state->progress_reports_count;
+
+    if (current_calculation_progress->is_size_known)
+    {
+        ++callback_state->progress_reports_with_known_size_count;
+    }
+
+    callback_state->last_processed_bytes = current_calculation_progress->processed_bytes;
+}
+
+/* Opens the synthetic source through "file_source.c" and hashes it into "result_string_buf". */
+static
+enum HashCalculatorResultCode
+uhashtools_test_hash_synthetic
+(
+    const wchar_t* synthetic_spec,
+    unsigned char* file_read_buf,
+    wchar_t* result_string_buf,
+    struct TestCallbackState* callback_state
+)
+{
+    struct FileSource file_source;
+    enum HashCalculatorResultCode ret = HashCalculatorResultCode_FAILED;
+
+    file_source = uhashtools_file_source_open(result_string_buf, TEST_RESULT_STRING_TSIZE, synthetic_spec);
+
+    UHASHTOOLS_TEST_CHECK(file_source.is_ok);
+    if (!file_source.is_ok)
+    {
+        (void) printf("Failed to open \"%ls\": %ls\n", synthetic_spec, result_string_buf);
+
+        return HashCalculatorResultCode_FAILED;
+    }
+
+    ret = uhashtools_hash_calculator_impl_hash_file_source(file_read_buf,
+                                                           FILE_READ_BUF_TSIZE,
+                                                           result_string_buf,
+                                                           TEST_RESULT_STRING_TSIZE,
+                                                           &file_source,
+                                                           &uhashtools_test_check_is_cancel_requested,
+                                                           callback_state,
+                                                           &uhashtools_test_on_progress,
+                                                           callback_state);
+
+    uhashtools_file_source_close(&file_source);
+
+    return ret;
+}
+
+/* Every spec describes the same content, so all of them have to result in the same digest. */
+static
+void
+uhashtools_test_equal_digests
+(
+    const wchar_t* const* synthetic_specs,
+    size_t synthetic_specs_count,
+    const wchar_t* expected_result,
+    unsigned char* file_read_buf
+)
+{
+    wchar_t first_result[TEST_RESULT_STRING_TSIZE];
+    wchar_t result_string_buf[TEST_RESULT_STRING_TSIZE];
+    size_t i = 0;
+
+    first_result[0] = L'\0';
+
+    for (i = 0; i < synthetic_specs_count; ++i)
+    {
+        struct TestCallbackState callback_state;
+
+        (void) memset((void*) &callback_state, 0, sizeof callback_state);
+
+        UHASHTOOLS_TEST_CHECK(uhashtools_test_hash_synthetic(synthetic_specs[i],
+                                                             file_read_buf,
+                                                             result_string_buf,
+                                                             &callback_state) == HashCalculatorResultCode_SUCCESS);
+
+        (void) printf("test_synthetic_file_source: %-56ls %ls\n", synthetic_specs[i], result_string_buf);
+
+        if (i == 0)
+        {
+            (void) wcscpy(first_result, result_string_buf);
+        }
+
+        UHASHTOOLS_TEST_CHECK(wcscmp(result_string_buf, first_result) == 0);
+
+        if (expected_result)
+        {
+            UHASHTOOLS_TEST_CHECK(wcscmp(result_string_buf, expected_result) == 0);
+        }
+
+        if (wcsstr(synthetic_specs[i], L"hide_size=1"))
+        {
+            /* The first report tells the receiver right away that the size is unknown. */
+            UHASHTOOLS_TEST_CHECK(callback_state.progress_reports_count > 0);
+            UHASHTOOLS_TEST_CHECK(callback_state.progress_reports_with_known_size_count == 0);
+        }
+        else
+        {
+            UHASHTOOLS_TEST_CHECK(callback_state.progress_reports_with_known_size_count == callback_state.progress_reports_count);
+        }
+    }
+}
+
+static
+void
+uhashtools_test_injected_read_error
+(
+    const wchar_t* synthetic_spec,
+    unsigned __int64 fail_at,
+    unsigned char* file_read_buf
+)
+{
+    wchar_t result_string_buf[TEST_RESULT_STRING_TSIZE];
+    struct TestCallbackState callback_state;
+
+    (void) memset((void*) &callback_state, 0, sizeof callback_state);
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_test_hash_synthetic(synthetic_spec,
+                                                         file_read_buf,
+                                                         result_string_buf,
+                                                         &callback_state) == HashCalculatorResultCode_FAILED);
+    UHASHTOOLS_TEST_CHECK(wcscmp(result_string_buf, L"Failed to read the selected file!") == 0);
+
+    /* Nothing behind the failure offset may have been hashed. */
+    UHASHTOOLS_TEST_CHECK(callback_state.last_processed_bytes <= fail_at);
+
+    /* Without a known size the progress is only reported in an interval. */
+    if (fail_at >= FILE_READ_BUF_TSIZE * 2 && !wcsstr(synthetic_spec, L"hide_size=1"))
+    {
+        UHASHTOOLS_TEST_CHECK(callback_state.progress_reports_count > 0);
+        UHASHTOOLS_TEST_CHECK(callback_state.last_processed_bytes > 0);
+    }
+
+    (void) printf("test_synthetic_file_source: %-56ls failed after %lu bytes\n",
+                  synthetic_spec,
+                  (unsigned long) callback_state.last_processed_bytes);
+}
+
+static
+void
+uhashtools_test_cancel_slow_source
+(
+    unsigned char* file_read_buf
+)
+{
+    static const wchar_t synthetic_spec[] = L"synthetic:size=1048576,chunk_size=4096,latency_ms=1,jitter_ms=2";
+    wchar_t result_string_buf[TEST_RESULT_STRING_TSIZE];
+    struct TestCallbackState callback_state;
+
+    (void) memset((void*) &callback_state, 0, sizeof callback_state);
+    callback_state.cancel_after_checks_count = 8;
+
+    UHASHTOOLS_TEST_CHECK(uhashtools_test_hash_synthetic(synthetic_spec,
+                                                         file_read_buf,
+                                                         result_string_buf,
+                                                         &callback_state) == HashCalculatorResultCode_CANCELED);
+    UHASHTOOLS_TEST_CHECK(callback_state.cancel_checks_count == callback_state.cancel_after_checks_count + 1);
+    UHASHTOOLS_TEST_CHECK(callback_state.last_processed_bytes <= 4096 * 8);
+}
+
+static
+void
+uhashtools_test_invalid_specs
+(
+    void
+)
+{
+    static const wchar_t* const synthetic_specs[] = { L"synthetic:size",
+                                                      L"synthetic:size=12ab",
+                                                      L"synthetic:chunk_size=0",
+                                                      L"synthetic:hide_size=2",
+                                                      L"synthetic:pattern=ones",
+                                                      L"synthetic:unknown=1" };
+    wchar_t error_message_buf[TEST_RESULT_STRING_TSIZE];
+    size_t i = 0;
+
+    for (i = 0; i < sizeof synthetic_specs / sizeof synthetic_specs[0]; ++i)
+    {
+        struct FileSource file_source = uhashtools_file_source_open(error_message_buf,
+                                                                    TEST_RESULT_STRING_TSIZE,
+                                                                    synthetic_specs[i]);
+
+        UHASHTOOLS_TEST_CHECK(!file_source.is_ok);
+        UHASHTOOLS_TEST_CHECK(wcscmp(error_message_buf, L"Invalid specification of the synthetic file source!") == 0);
+    }
+}
+
+int
+main
+(
+    void
+)
+{
+    static const wchar_t* const random_specs[] = { L"synthetic:size=3145745",
+                                                   L"synthetic:size=3145745,chunk_size=1000",
+                                                   L"synthetic:size=3145745,chunk_size=65537",
+                                                   L"synthetic:size=3145745,hide_size=1",
+                                                   L"synthetic:size=3145745,fail_at=3145745",
+                                                   L"synthetic:pattern=random,size=3145745,chunk_size=333,hide_size=1" };
+    static const wchar_t* const zero_specs[] = { L"synthetic:size=1048593,pattern=zero",
+                                                 L"synthetic:size=1048593,pattern=zero,chunk_size=4096,hide_size=1" };
+    unsigned char* file_read_buf = (unsigned char*) malloc(FILE_READ_BUF_TSIZE);
+    unsigned char* zero_data = (unsigned char*) calloc(1, TEST_ZERO_DATA_SIZE);
+    wchar_t zero_result[TEST_RESULT_STRING_TSIZE];
+    struct HashDigest zero_digest;
+
+    UHASHTOOLS_TEST_CHECK(file_read_buf);
+    UHASHTOOLS_TEST_CHECK(zero_data);
+    if (file_read_buf && zero_data)
+    {
+        UHASHTOOLS_TEST_CHECK(uhashtools_hash_calculator_impl_hash_buffer_to_digest(zero_data,
+                                                                                    TEST_ZERO_DATA_SIZE,
+                                                                                    &zero_digest,
+                                                                                    zero_result,
+                                                                                    TEST_RESULT_STRING_TSIZE));
+        UHASHTOOLS_TEST_CHECK(uhashtools_hash_calculator_impl_digest_to_hex(&zero_digest, zero_result, TEST_RESULT_STRING_TSIZE));
+
+        uhashtools_test_equal_digests(random_specs, sizeof random_specs / sizeof random_specs[0], NULL, file_read_buf);
+        uhashtools_test_equal_digests(zero_specs, sizeof zero_specs / sizeof zero_specs[0], zero_result, file_read_buf);
+
+        uhashtools_test_injected_read_error(L"synthetic:size=4194304,fail_at=0", 0, file_read_buf);
+        uhashtools_test_injected_read_error(L"synthetic:size=4194304,fail_at=1", 1, file_read_buf);
+        uhashtools_test_injected_read_error(L"synthetic:size=4194304,fail_at=2097155", 2097155, file_read_buf);
+        uhashtools_test_injected_read_error(L"synthetic:size=4194304,fail_at=4194303,hide_size=1", 4194303, file_read_buf);
+
+        uhashtools_test_cancel_slow_source(file_read_buf);
+        uhashtools_test_invalid_specs();
+    }
+
+    free((void*) zero_data);
+    free((void*) file_read_buf);
+
+    return uhashtools_test_finish("test_synthetic_file_source");
+}
@@ -0,0 +1,286 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Tests that the read throttle keeps the throughput of one reader and of
+ * several readers within 5% of the limit, and that it limits the files
+ * which are hashed at the same time.
+ * 
+ * The throttle can only be started once per process, so all cases share
+ * one limit. The throughput is measured after the readers have used up
+ * the burst tolerance, because the burst is allowed on top of the limit.
+ */
+
+#include "test_utilities.h"
+
+#include "throttle.h"
+
+#include <process.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_MAX_BYTES_PER_SECOND (32ULL * 1024 * 1024)
+#define TEST_MAX_HASHING_THREADS 2
+#define TEST_READ_SIZE (64 * 1024)
+#define TEST_MAX_READERS_COUNT 8
+
+/* Several times the burst tolerance, so the burst is used up before the measurement. */
+#define TEST_WARM_UP_MS (THROTTLE_BURST_TOLERANCE_MS * 5)
+#define TEST_MEASUREMENT_MS 2000
+
+#define TEST_FILE_HOLD_MS 50
+
+struct TestReadersCtx
+{
+    CRITICAL_SECTION lock;
+    BOOL is_stop_requested;
+    unsigned __int64 read_bytes;
+
+    /* Files which are hashed at the same time in the thread slots case */
+    unsigned int active_files_count;
+    unsigned int max_active_files_count;
+    BOOL had_background_mode_errors;
+};
+
+static
+unsigned int
+__stdcall
+uhashtools_test_reader_thread_function
+(
+    void* thread_param
+)
+{
+    struct TestReadersCtx* ctx = (struct TestReadersCtx*) thread_param;
+    BOOL is_stop_requested = FALSE;
+
+    while (!is_stop_requested)
+    {
+        uhashtools_throttle_pace_read(TEST_READ_SIZE);
+
+        EnterCriticalSection(&ctx->lock);
+        ctx->read_bytes += TEST_READ_SIZE;
+        is_stop_requested = ctx->is_stop_requested;
+        LeaveCriticalSection(&ctx->lock);
+    }
+
+    return 0;
+}
+
+static
+unsigned int
+__stdcall
+uhashtools_test_file_thread_function
+(
+    void* thread_param
+)
+{
+    struct TestReadersCtx* ctx = (struct TestReadersCtx*) thread_param;
+    struct ThrottleFileState file_state;
+
+    uhashtools_throttle_begin_file(&file_state);
+
+    EnterCriticalSection(&ctx->lock);
+
+    if (++ctx->active_files_count > ctx->max_active_files_count)
+    {
+        ctx->max_active_files_count = ctx->active_files_count;
+    }
+
+    if (!file_state.has_thread_slot || !file_state.is_in_background_mode)
+    {
+        ctx->had_background_mode_errors = TRUE;
+    }
+
+    LeaveCriticalSection(&ctx->lock);
+
+    Sleep(TEST_FILE_HOLD_MS);
+
+    EnterCriticalSection(&ctx->lock);
+    --ctx->active_files_count;
+    LeaveCriticalSection(&ctx->lock);
+
+    uhashtools_throttle_end_file(&file_state);
+
+    if (file_state.has_thread_slot || file_state.is_in_background_mode)
+    {
+        EnterCriticalSection(&ctx->lock);
+        ctx->had_background_mode_errors = TRUE;
+        LeaveCriticalSection(&ctx->lock);
+    }
+
+    return 0;
+}
+
+static
+void
+uhashtools_test_run_threads
+(
+    struct TestReadersCtx* ctx,
+    unsigned int (__stdcall* thread_function)(void*),
+    unsigned int threads_count,
+    HANDLE* thread_handles
+)
+{
+    unsigned int thread_index = 0;
+
+    for (thread_index = 0; thread_index < threads_count; ++thread_index)
+    {
+        unsigned int thread_id = 0;
+
+        thread_handles[thread_index] = (HANDLE) _beginthreadex(NULL,
+                                                               0,
+                                                               thread_function,
+                                                               (void*) ctx,
+                                                               0,
+                                                               &thread_id);
+
+        UHASHTOOLS_TEST_CHECK(thread_handles[thread_index]);
+        if (!thread_handles[thread_index])
+        {
+            exit(uhashtools_test_finish("test_throttle"));
+        }
+    }
+}
+
+static
+void
+uhashtools_test_join_threads
+(
+    unsigned int threads_count,
+    HANDLE* thread_handles
+)
+{
+    unsigned int thread_index = 0;
+
+    for (thread_index = 0; thread_index < threads_count; ++thread_index)
+    {
+        UHASHTOOLS_TEST_CHECK(WaitForSingleObject(thread_handles[thread_index], INFINITE) == WAIT_OBJECT_0);
+        (void) CloseHandle(thread_handles[thread_index]);
+    }
+}
+
+static
+unsigned __int64
+uhashtools_test_get_read_bytes
+(
+    struct TestReadersCtx* ctx
+)
+{
+    unsigned __int64 read_bytes = 0;
+
+    EnterCriticalSection(&ctx->lock);
+    read_bytes = ctx->read_bytes;
+    LeaveCriticalSection(&ctx->lock);
+
+    return read_bytes;
+}
+
+static
+void
+uhashtools_test_throughput
+(
+    unsigned int readers_count
+)
+{
+    struct TestReadersCtx ctx;
+    HANDLE thread_handles[TEST_MAX_READERS_COUNT];
+    unsigned __int64 start_read_bytes = 0;
+    unsigned __int64 end_read_bytes = 0;
+    double start_seconds = 0.0;
+    double end_seconds = 0.0;
+    double bytes_per_second = 0.0;
+
+    (void) memset((void*) &ctx, 0, sizeof ctx);
+    InitializeCriticalSection(&ctx.lock);
+
+    uhashtools_test_run_threads(&ctx, uhashtools_test_reader_thread_function, readers_count, thread_handles);
+
+    Sleep(TEST_WARM_UP_MS);
+
+    start_seconds = uhashtools_test_get_seconds();
+    start_read_bytes = uhashtools_test_get_read_bytes(&ctx);
+
+    Sleep(TEST_MEASUREMENT_MS);
+
+    end_seconds = uhashtools_test_get_seconds();
+    end_read_bytes = uhashtools_test_get_read_bytes(&ctx);
+
+    EnterCriticalSection(&ctx.lock);
+    ctx.is_stop_requested = TRUE;
+    LeaveCriticalSection(&ctx.lock);
+
+    uhashtools_test_join_threads(readers_count, thread_handles);
+
+    DeleteCriticalSection(&ctx.lock);
+
+    bytes_per_second = (double) (end_read_bytes - start_read_bytes) / (end_seconds - start_seconds);
+
+    (void) printf("test_throttle: %u reader(s): %.2f MiB/s of %.2f MiB/s\n",
+                  readers_count,
+                  bytes_per_second / (1024.0 * 1024.0),
+                  (double) TEST_MAX_BYTES_PER_SECOND / (1024.0 * 1024.0));
+
+    UHASHTOOLS_TEST_CHECK(bytes_per_second >= (double) TEST_MAX_BYTES_PER_SECOND * 0.95);
+    UHASHTOOLS_TEST_CHECK(bytes_per_second <= (double) TEST_MAX_BYTES_PER_SECOND * 1.05);
+}
+
+static
+void
+uhashtools_test_thread_slots
+(
+    void
+)
+{
+    struct TestReadersCtx ctx;
+    HANDLE thread_handles[TEST_MAX_READERS_COUNT];
+
+    (void) memset((void*) &ctx, 0, sizeof ctx);
+    InitializeCriticalSection(&ctx.lock);
+
+    uhashtools_test_run_threads(&ctx, uhashtools_test_file_thread_function, TEST_MAX_READERS_COUNT, thread_handles);
+    uhashtools_test_join_threads(TEST_MAX_READERS_COUNT, thread_handles);
+
+    DeleteCriticalSection(&ctx.lock);
+
+    UHASHTOOLS_TEST_CHECK(ctx.max_active_files_count == TEST_MAX_HASHING_THREADS);
+    UHASHTOOLS_TEST_CHECK(ctx.active_files_count == 0);
+    UHASHTOOLS_TEST_CHECK(!ctx.had_background_mode_errors);
+}
+
+int
+main
+(
+    void
+)
+{
+    LARGE_INTEGER counter_frequency;
+    LARGE_INTEGER start_counter;
+    LARGE_INTEGER end_counter;
+    struct ThrottleFileState file_state;
+
+    /* Without a started throttle nothing is paced or limited. */
+    (void) QueryPerformanceFrequency(&counter_frequency);
+    (void) QueryPerformanceCounter(&start_counter);
+    uhashtools_throttle_pace_read((size_t) TEST_MAX_BYTES_PER_SECOND * 10);
+    (void) QueryPerformanceCounter(&end_counter);
+    UHASHTOOLS_TEST_CHECK(end_counter.QuadPart - start_counter.QuadPart < counter_frequency.QuadPart / 10);
+
+    uhashtools_throttle_begin_file(&file_state);
+    UHASHTOOLS_TEST_CHECK(!file_state.has_thread_slot && !file_state.is_in_background_mode);
+    uhashtools_throttle_end_file(&file_state);
+
+    uhashtools_throttle_start(TEST_MAX_BYTES_PER_SECOND, TRUE, TEST_MAX_HASHING_THREADS);
+
+    uhashtools_test_throughput(1);
+    uhashtools_test_throughput(4);
+    uhashtools_test_throughput(TEST_MAX_READERS_COUNT);
+
+    uhashtools_test_thread_slots();
+
+    return uhashtools_test_finish("test_throttle");
+}
@@ -0,0 +1,271 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "test_utilities.h"
+
+#include "error_utilities.h"
+#include "hash_calculation_impl.h"
+#include "logger.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+static unsigned int failed_checks_count = 0;
+static unsigned __int64 random_state = 0x9E3779B97F4A7C15ULL;
+
+void
+uhashtools_test_report_failure
+(
+    const char* filename,
+    int line,
+    const char* cond_expr_txt
+)
+{
+    ++failed_checks_count;
+
+    (void) printf("%s:%d: Check failed: %s\n", filename, line, cond_expr_txt);
+}
+
+int
+uhashtools_test_finish
+(
+    const char* test_name
+)
+{
+    if (failed_checks_count > 0)
+    {
+        (void) printf("%s: %u check(s) failed.\n", test_name, failed_checks_count);
+
+        return EXIT_FAILURE;
+    }
+
+    (void) printf("%s: All checks passed.\n", test_name);
+
+    return EXIT_SUCCESS;
+}
+
+unsigned __int64
+uhashtools_test_random
+(
+    void
+)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+
+    return random_state;
+}
+
+void
+uhashtools_test_fill_data
+(
+    enum TestDataKind data_kind,
+    unsigned char* buf,
+    size_t buf_size
+)
+{
+    static const char* const words[] = { "lorem ", "ipsum ", "dolor ", "sit ", "amet,\r\n", "hash " };
+    size_t buf_pos = 0;
+
+    while (buf_pos < buf_size)
+    {
+        switch (data_kind)
+        {
+            case TEST_DATA_KIND_RANDOM:
+            {
+                buf[buf_pos++] = (unsigned char) uhashtools_test_random();
+            } break;
+            case TEST_DATA_KIND_TEXT:
+            {
+                const char* word = words[uhashtools_test_random() % (sizeof words / sizeof words[0])];
+
+                while (*word != '\0' && buf_pos < buf_size)
+                {
+                    buf[buf_pos++] = (unsigned char) *word++;
+                }
+            } break;
+            case TEST_DATA_KIND_ZEROS:
+            {
+                buf[buf_pos++] = 0;
+            } break;
+            default:
+            {
+                /* Copies may overlap themselves like the matches of deflate. */
+                size_t copy_size = (size_t) (uhashtools_test_random() % 300) + 3;
+
+                if (buf_pos == 0 || uhashtools_test_random() % 2 == 0)
+                {
+                    for (; copy_size > 0 && buf_pos < buf_size; --copy_size)
+                    {
+                        buf[buf_pos++] = (unsigned char) uhashtools_test_random();
+                    }
+                }
+                else
+                {
+                    const size_t max_distance = buf_pos < 32768 ? buf_pos : 32768;
+                    const size_t distance = (size_t) (uhashtools_test_random() % max_distance) + 1;
+
+                    for (; copy_size > 0 && buf_pos < buf_size; --copy_size)
+                    {
+                        buf[buf_pos] = buf[buf_pos - distance];
+                        ++buf_pos;
+                    }
+                }
+            }
+        }
+    }
+}
+
+double
+uhashtools_test_get_seconds
+(
+    void
+)
+{
+    struct timespec now;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+/* A failed assertion of a tested unit ends the test. */
+void
+uhashtools_handle_fatal_error
+(
+    const wchar_t* error_title,
+    const wchar_t* error_txt
+)
+{
+    (void) printf("Fatal error: %ls: %ls\n", error_title, error_txt);
+
+    abort();
+}
+
+/*
+ * The log lines of the tested units aren't checked. It's weak, so the
+ * tests of the logger use the original.
+ */
+__attribute__((weak))
+void
+uhashtools_logger_write_line
+(
+    enum LoggerLevel level,
+    const wchar_t* format,
+    ...
+)
+{
+    (void) level;
+    (void) format;
+}
+
+/*
+ * Same encoding as the original for the tests of units which don't link
+ * "hash_calculation_impl.c". It's weak, so the tests which link it use
+ * the original.
+ */
+__attribute__((weak))
+BOOL
+uhashtools_hash_calculator_impl_digest_to_hex
+(
+    const struct HashDigest* digest,
+    wchar_t* out_buf,
+    size_t out_buf_tsize
+)
+{
+    static const wchar_t hex_digits[] = L"0123456789abcdef";
+    unsigned int byte_index = 0;
+
+    if (out_buf_tsize < (size_t) digest->size * 2 + 1)
+    {
+        return FALSE;
+    }
+
+    for (byte_index = 0; byte_index < digest->size; ++byte_index)
+    {
+        out_buf[byte_index * 2] = hex_digits[digest->bytes[byte_index] >> 4];
+        out_buf[byte_index * 2 + 1] = hex_digits[digest->bytes[byte_index] & 0x0F];
+    }
+
+    out_buf[digest->size * 2] = L'\0';
+
+    return TRUE;
+}
+
+int
+uhashtools_test_start_mode
+(
+    int (*mode_function)(const struct CliArguments*),
+    const struct CliArguments* cli_arguments,
+    const char* stdout_path,
+    const char* stderr_path
+)
+{
+    pid_t pid = 0;
+
+    /* Output which is still buffered would be written by the child again. */
+    (void) fflush(stdout);
+    (void) fflush(stderr);
+
+    pid = fork();
+
+    if (pid == 0)
+    {
+        int exit_code = 1;
+
+        if (freopen(stdout_path, "w", stdout) &&
+            freopen(stderr_path, "w", stderr))
+        {
+            exit_code = mode_function(cli_arguments);
+        }
+
+        (void) fflush(stdout);
+        (void) fflush(stderr);
+
+        _exit(exit_code);
+    }
+
+    UHASHTOOLS_TEST_CHECK(pid > 0);
+
+    return pid > 0 ? (int) pid : -1;
+}
+
+int
+uhashtools_test_wait_mode
+(
+    int process_id
+)
+{
+    int status = 0;
+
+    UHASHTOOLS_TEST_CHECK(process_id > 0 && waitpid((pid_t) process_id, &status, 0) == (pid_t) process_id && WIFEXITED(status));
+    if (process_id <= 0 || !WIFEXITED(status))
+    {
+        return -1;
+    }
+
+    return WEXITSTATUS(status);
+}
+
+int
+uhashtools_test_run_mode
+(
+    int (*mode_function)(const struct CliArguments*),
+    const struct CliArguments* cli_arguments,
+    const char* stdout_path,
+    const char* stderr_path
+)
+{
+    return uhashtools_test_wait_mode(uhashtools_test_start_mode(mode_function, cli_arguments, stdout_path, stderr_path));
+}
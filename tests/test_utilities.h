@@ -0,0 +1,159 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "cli_arguments.h"
+
+#include <Windows.h>
+
+/*
+ * Helpers shared by the unit tests and benchmarks of the portable units
+ * (see "makefile").
+ * 
+ * Besides the functions declared here "test_utilities.c" replaces the
+ * functions of the non-portable units which are called by the tested
+ * units: the fatal error handler, the logger and the hex encoder of
+ * "hash_calculation_impl.c".
+ */
+
+/**
+ * Reports a failed check with the file and the line of the check, the
+ * test continues afterwards.
+ */
+#define UHASHTOOLS_TEST_CHECK(cond_expr) { if (!(cond_expr)) { uhashtools_test_report_failure(__FILE__, __LINE__, #cond_expr); } }
+
+extern
+void
+uhashtools_test_report_failure
+(
+    const char* filename,
+    int line,
+    const char* cond_expr_txt
+);
+
+/**
+ * Prints the result of the test.
+ * 
+ * @param test_name Name of the test for the result line.
+ * 
+ * @return Exit code of the test, 0 if no check has failed.
+ */
+extern
+int
+uhashtools_test_finish
+(
+    const char* test_name
+);
+
+/**
+ * Returns the next value of a xorshift generator with a fixed seed, so
+ * the generated test data is the same on every run.
+ */
+extern
+unsigned __int64
+uhashtools_test_random
+(
+    void
+);
+
+enum TestDataKind
+{
+    TEST_DATA_KIND_RANDOM,
+    TEST_DATA_KIND_TEXT,
+    TEST_DATA_KIND_ZEROS,
+    TEST_DATA_KIND_REPEATS,
+    TEST_DATA_KIND_COUNT
+};
+
+/**
+ * Fills the buffer with generated test data for compressors.
+ * 
+ * @param data_kind Random bytes which can't be compressed, text of a
+ *                  few words, zeros only or random bytes mixed with
+ *                  long copies of the preceding 32 KiB.
+ * @param buf Buffer to fill.
+ * @param buf_size Size of the buffer in bytes.
+ */
+extern
+void
+uhashtools_test_fill_data
+(
+    enum TestDataKind data_kind,
+    unsigned char* buf,
+    size_t buf_size
+);
+
+/**
+ * Returns the value of a monotonic clock in seconds for measuring the
+ * benchmarks.
+ */
+extern
+double
+uhashtools_test_get_seconds
+(
+    void
+);
+
+/**
+ * Starts a mode without a window in a child process like from the
+ * command line, since the modes switch the standard streams to wide
+ * output. The child writes its stdout and stderr into the given files.
+ * 
+ * @param mode_function Run function of the mode.
+ * @param cli_arguments Arguments for the mode.
+ * @param stdout_path File for the stdout of the child.
+ * @param stderr_path File for the stderr of the child.
+ * 
+ * @return Process id of the child or -1 if it couldn't be started.
+ */
+extern
+int
+uhashtools_test_start_mode
+(
+    int (*mode_function)(const struct CliArguments*),
+    const struct CliArguments* cli_arguments,
+    const char* stdout_path,
+    const char* stderr_path
+);
+
+/**
+ * Waits for the child of "uhashtools_test_start_mode()".
+ * 
+ * @param process_id Process id of the child.
+ * 
+ * @return Exit code of the mode or -1 if the child didn't exit.
+ */
+extern
+int
+uhashtools_test_wait_mode
+(
+    int process_id
+);
+
+/**
+ * Runs a mode without a window in a child process like from the command
+ * line, since the modes switch the standard streams to wide output. The
+ * child writes its stdout and stderr into the given files.
+ * 
+ * @param mode_function Run function of the mode.
+ * @param cli_arguments Arguments for the mode.
+ * @param stdout_path File for the stdout of the child.
+ * @param stderr_path File for the stderr of the child.
+ * 
+ * @return Exit code of the mode or -1 if the child couldn't be run.
+ */
+extern
+int
+uhashtools_test_run_mode
+(
+    int (*mode_function)(const struct CliArguments*),
+    const struct CliArguments* cli_arguments,
+    const char* stdout_path,
+    const char* stderr_path
+);
@@ -0,0 +1,1106 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/*
+ * Minimal replacement of the Windows SDK header for building the
+ * portable units of "src" with GCC or Clang on Linux (see "makefile").
+ * 
+ * Only the types, macros and functions which are used by the tested
+ * units are provided. The functions are implemented on top of the C
+ * runtime and POSIX by "win32_compat.c". Differences to the originals
+ * which matter for the tests are documented there.
+ */
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+
+/* Compiler extensions of MSVC */
+
+#define __int64 long long
+#define __declspec(attribute)
+#define __forceinline __inline__ __attribute__((always_inline))
+#define __stdcall
+#define __cdecl
+#define CALLBACK __stdcall
+#define UNALIGNED
+#define UNREFERENCED_PARAMETER(parameter) ((void) (parameter))
+#define C_ASSERT(expr) typedef char __C_ASSERT__[(expr) ? 1 : -1]
+
+
+/* Types */
+
+#define MAX_PATH 260
+
+typedef int BOOL;
+typedef BOOL* LPBOOL;
+typedef unsigned char BYTE;
+typedef unsigned char BOOLEAN;
+typedef unsigned char UCHAR;
+typedef unsigned char* PUCHAR;
+typedef unsigned short WORD;
+typedef unsigned int DWORD;
+typedef unsigned int UINT;
+typedef int LONG;
+typedef unsigned int ULONG;
+typedef long long LONGLONG;
+typedef size_t SIZE_T;
+typedef size_t ULONG_PTR;
+typedef unsigned long long ULONGLONG;
+typedef int errno_t;
+
+typedef void* HANDLE;
+typedef HANDLE HWND;
+typedef void* PVOID;
+typedef const void* LPCVOID;
+typedef void* LPVOID;
+typedef wchar_t WCHAR;
+typedef const wchar_t* LPCWSTR;
+typedef wchar_t* LPWSTR;
+typedef char* LPSTR;
+typedef const char* LPCSTR;
+
+typedef union _LARGE_INTEGER
+{
+    struct
+    {
+        DWORD LowPart;
+        LONG HighPart;
+    } u;
+    LONGLONG QuadPart;
+} LARGE_INTEGER;
+
+typedef struct _SECURITY_ATTRIBUTES* LPSECURITY_ATTRIBUTES;
+
+typedef struct _INIT_ONCE
+{
+    BOOL is_done;
+} INIT_ONCE;
+
+typedef INIT_ONCE* PINIT_ONCE;
+
+typedef BOOL (CALLBACK* PINIT_ONCE_FN)(PINIT_ONCE init_once, PVOID parameter, PVOID* context);
+
+/* Like the original a critical section may be entered again by the owning thread. */
+typedef struct _CRITICAL_SECTION
+{
+    pthread_mutex_t mutex;
+} CRITICAL_SECTION;
+
+typedef struct _CONDITION_VARIABLE
+{
+    pthread_cond_t cond;
+} CONDITION_VARIABLE;
+
+typedef struct _OVERLAPPED
+{
+    ULONG_PTR Internal;
+    ULONG_PTR InternalHigh;
+    DWORD Offset;
+    DWORD OffsetHigh;
+    HANDLE hEvent;
+} OVERLAPPED;
+
+typedef OVERLAPPED* LPOVERLAPPED;
+
+typedef struct _FILETIME
+{
+    DWORD dwLowDateTime;
+    DWORD dwHighDateTime;
+} FILETIME;
+
+typedef struct _WIN32_FILE_ATTRIBUTE_DATA
+{
+    DWORD dwFileAttributes;
+    FILETIME ftCreationTime;
+    FILETIME ftLastAccessTime;
+    FILETIME ftLastWriteTime;
+    DWORD nFileSizeHigh;
+    DWORD nFileSizeLow;
+} WIN32_FILE_ATTRIBUTE_DATA;
+
+typedef struct _BY_HANDLE_FILE_INFORMATION
+{
+    DWORD dwFileAttributes;
+    FILETIME ftCreationTime;
+    FILETIME ftLastAccessTime;
+    FILETIME ftLastWriteTime;
+    DWORD dwVolumeSerialNumber;
+    DWORD nFileSizeHigh;
+    DWORD nFileSizeLow;
+    DWORD nNumberOfLinks;
+    DWORD nFileIndexHigh;
+    DWORD nFileIndexLow;
+} BY_HANDLE_FILE_INFORMATION;
+
+typedef struct _WIN32_FIND_DATAW
+{
+    DWORD dwFileAttributes;
+    FILETIME ftCreationTime;
+    FILETIME ftLastAccessTime;
+    FILETIME ftLastWriteTime;
+    DWORD nFileSizeHigh;
+    DWORD nFileSizeLow;
+    DWORD dwReserved0;
+    DWORD dwReserved1;
+    WCHAR cFileName[MAX_PATH];
+    WCHAR cAlternateFileName[14];
+} WIN32_FIND_DATAW;
+
+typedef WIN32_FIND_DATAW* LPWIN32_FIND_DATAW;
+
+typedef enum _FINDEX_INFO_LEVELS
+{
+    FindExInfoStandard,
+    FindExInfoBasic
+} FINDEX_INFO_LEVELS;
+
+typedef enum _FINDEX_SEARCH_OPS
+{
+    FindExSearchNameMatch
+} FINDEX_SEARCH_OPS;
+
+typedef struct _SYSTEM_INFO
+{
+    WORD wProcessorArchitecture;
+    WORD wReserved;
+    DWORD dwPageSize;
+    LPVOID lpMinimumApplicationAddress;
+    LPVOID lpMaximumApplicationAddress;
+    ULONG_PTR dwActiveProcessorMask;
+    DWORD dwNumberOfProcessors;
+    DWORD dwProcessorType;
+    DWORD dwAllocationGranularity;
+    WORD wProcessorLevel;
+    WORD wProcessorRevision;
+} SYSTEM_INFO;
+
+typedef SYSTEM_INFO* LPSYSTEM_INFO;
+
+typedef DWORD* LPDWORD;
+
+typedef ptrdiff_t LONG_PTR;
+typedef ULONG_PTR WPARAM;
+typedef LONG_PTR LPARAM;
+
+typedef struct tagMSG
+{
+    HWND hwnd;
+    UINT message;
+    WPARAM wParam;
+    LPARAM lParam;
+    DWORD time;
+} MSG;
+
+typedef MSG* LPMSG;
+
+typedef enum _GET_FILEEX_INFO_LEVELS
+{
+    GetFileExInfoStandard
+} GET_FILEEX_INFO_LEVELS;
+
+
+/* Constants */
+
+#define TRUE 1
+#define FALSE 0
+
+#define _TRUNCATE ((size_t) -1)
+#define _UI64_MAX 0xFFFFFFFFFFFFFFFFULL
+#define _I64_MAX 0x7FFFFFFFFFFFFFFFLL
+#define MAXDWORD 0xFFFFFFFF
+
+#define INIT_ONCE_STATIC_INIT {FALSE}
+
+#define INVALID_HANDLE_VALUE ((HANDLE) (size_t) -1)
+
+#define GENERIC_READ 0x80000000
+#define GENERIC_WRITE 0x40000000
+#define FILE_READ_ATTRIBUTES 0x00000080
+#define FILE_SHARE_READ 0x00000001
+#define FILE_SHARE_WRITE 0x00000002
+#define FILE_SHARE_DELETE 0x00000004
+#define OPEN_EXISTING 3
+#define FILE_ATTRIBUTE_DIRECTORY 0x00000010
+#define FILE_ATTRIBUTE_DEVICE 0x00000040
+#define FILE_ATTRIBUTE_NORMAL 0x00000080
+#define FILE_ATTRIBUTE_REPARSE_POINT 0x00000400
+#define FILE_ATTRIBUTE_SPARSE_FILE 0x00000200
+#define FILE_ATTRIBUTE_COMPRESSED 0x00000800
+#define FILE_ATTRIBUTE_ENCRYPTED 0x00004000
+#define FILE_FLAG_OVERLAPPED 0x40000000
+#define FILE_FLAG_NO_BUFFERING 0x20000000
+#define FILE_FLAG_RANDOM_ACCESS 0x10000000
+#define FILE_FLAG_FIRST_PIPE_INSTANCE 0x00080000
+#define FIND_FIRST_EX_LARGE_FETCH 0x00000002
+#define PAGE_READONLY 0x02
+#define PAGE_READWRITE 0x04
+#define MEM_COMMIT 0x00001000
+#define MEM_RESERVE 0x00002000
+#define MEM_RELEASE 0x00008000
+#define MOVEFILE_REPLACE_EXISTING 0x00000001
+#define MOVEFILE_WRITE_THROUGH 0x00000008
+#define FILE_MAP_READ 0x0004
+
+#define PIPE_ACCESS_DUPLEX 0x00000003
+#define PIPE_TYPE_MESSAGE 0x00000004
+#define PIPE_READMODE_MESSAGE 0x00000002
+#define PIPE_WAIT 0x00000000
+#define PIPE_REJECT_REMOTE_CLIENTS 0x00000008
+#define PIPE_UNLIMITED_INSTANCES 255
+
+#define STD_INPUT_HANDLE ((DWORD) -10)
+#define STD_OUTPUT_HANDLE ((DWORD) -11)
+#define STD_ERROR_HANDLE ((DWORD) -12)
+
+#define FILE_TYPE_UNKNOWN 0x0000
+#define FILE_TYPE_DISK 0x0001
+#define FILE_TYPE_CHAR 0x0002
+#define FILE_TYPE_PIPE 0x0003
+
+#define ATTACH_PARENT_PROCESS ((DWORD) -1)
+
+#define CP_ACP 0
+#define CP_UTF8 65001
+#define MB_ERR_INVALID_CHARS 0x00000008
+
+#define MB_ICONERROR 0x00000010
+
+#define ERROR_FILE_NOT_FOUND 2
+#define ERROR_ACCESS_DENIED 5
+#define ERROR_NOT_ENOUGH_MEMORY 8
+#define ERROR_NO_MORE_FILES 18
+#define ERROR_READ_FAULT 30
+#define ERROR_HANDLE_EOF 38
+#define ERROR_NOT_SUPPORTED 50
+#define ERROR_BROKEN_PIPE 109
+#define ERROR_PIPE_BUSY 231
+#define ERROR_NO_DATA 232
+#define ERROR_MORE_DATA 234
+#define ERROR_PIPE_CONNECTED 535
+#define ERROR_OPERATION_ABORTED 995
+#define ERROR_IO_PENDING 997
+#define ERROR_NOT_FOUND 1168
+#define ERROR_INVALID_THREAD_ID 1444
+
+#define INFINITE 0xFFFFFFFF
+#define WAIT_OBJECT_0 0x00000000
+#define WAIT_TIMEOUT 0x00000102
+#define WAIT_FAILED 0xFFFFFFFF
+
+#define WM_QUIT 0x0012
+#define WM_USER 0x0400
+#define PM_NOREMOVE 0x0000
+#define PM_REMOVE 0x0001
+
+#define THREAD_MODE_BACKGROUND_BEGIN 0x00010000
+#define THREAD_MODE_BACKGROUND_END 0x00020000
+
+
+/* Windows API */
+
+extern
+BOOL
+CloseHandle
+(
+    HANDLE handle
+);
+
+extern
+HANDLE
+CreateFileW
+(
+    LPCWSTR filename,
+    DWORD desired_access,
+    DWORD share_mode,
+    LPSECURITY_ATTRIBUTES security_attributes,
+    DWORD creation_disposition,
+    DWORD flags_and_attributes,
+    HANDLE template_file
+);
+
+extern
+BOOL
+GetFileSizeEx
+(
+    HANDLE file_handle,
+    LARGE_INTEGER* file_size
+);
+
+/*
+ * Reads synchronously, also with an OVERLAPPED structure. The result of
+ * an overlapped read is stored in the structure for
+ * "GetOverlappedResult()". Like for a pipe whose writing side has been
+ * closed, reading the end of a pipe fails with ERROR_BROKEN_PIPE.
+ */
+extern
+BOOL
+ReadFile
+(
+    HANDLE file_handle,
+    LPVOID buf,
+    DWORD bytes_to_read,
+    DWORD* read_bytes,
+    LPOVERLAPPED overlapped
+);
+
+/*
+ * Writes synchronously, an OVERLAPPED structure isn't supported. A write
+ * to a named pipe is one message.
+ */
+extern
+BOOL
+WriteFile
+(
+    HANDLE file_handle,
+    LPCVOID buf,
+    DWORD bytes_to_write,
+    DWORD* written_bytes,
+    LPOVERLAPPED overlapped
+);
+
+/* Does nothing for named pipes, since their written messages stay readable after closing. */
+extern
+BOOL
+FlushFileBuffers
+(
+    HANDLE file_handle
+);
+
+/* Reads which start at or behind the end of the file fail with ERROR_HANDLE_EOF. */
+extern
+BOOL
+GetOverlappedResult
+(
+    HANDLE file_handle,
+    LPOVERLAPPED overlapped,
+    DWORD* transferred_bytes,
+    BOOL wait
+);
+
+/* Does nothing, since every read has already been completed. */
+extern
+BOOL
+CancelIoEx
+(
+    HANDLE file_handle,
+    LPOVERLAPPED overlapped
+);
+
+/*
+ * Only the attributes FILE_ATTRIBUTE_DIRECTORY, FILE_ATTRIBUTE_DEVICE,
+ * FILE_ATTRIBUTE_SPARSE_FILE and FILE_ATTRIBUTE_NORMAL are set besides the
+ * times, the size and the file index. Files with fewer allocated blocks
+ * than their size are reported as sparse.
+ */
+extern
+BOOL
+GetFileInformationByHandle
+(
+    HANDLE file_handle,
+    BY_HANDLE_FILE_INFORMATION* file_information
+);
+
+/* Only the attributes like for "GetFileInformationByHandle()", the times and the size are set. */
+extern
+BOOL
+GetFileAttributesExW
+(
+    LPCWSTR filename,
+    GET_FILEEX_INFO_LEVELS info_level_id,
+    LPVOID file_information
+);
+
+/*
+ * Only lists whole directories with the pattern "<directory>\*". Symbolic
+ * links are reported as reparse points.
+ */
+extern
+HANDLE
+FindFirstFileExW
+(
+    LPCWSTR filename,
+    FINDEX_INFO_LEVELS info_level_id,
+    LPVOID find_file_data,
+    FINDEX_SEARCH_OPS search_op,
+    LPVOID search_filter,
+    DWORD additional_flags
+);
+
+extern
+BOOL
+FindNextFileW
+(
+    HANDLE find_handle,
+    LPWIN32_FIND_DATAW find_file_data
+);
+
+extern
+BOOL
+FindClose
+(
+    HANDLE find_handle
+);
+
+/* Like the original on NTFS the file is replaced atomically. */
+extern
+BOOL
+MoveFileExW
+(
+    LPCWSTR existing_filename,
+    LPCWSTR new_filename,
+    DWORD flags
+);
+
+extern
+BOOL
+DeleteFileW
+(
+    LPCWSTR filename
+);
+
+/*
+ * The handles of the standard streams belong to the process and must
+ * not be closed.
+ */
+extern
+HANDLE
+GetStdHandle
+(
+    DWORD std_handle
+);
+
+extern
+DWORD
+GetFileType
+(
+    HANDLE file_handle
+);
+
+/*
+ * Named pipes are emulated by local sequenced packet sockets in the
+ * abstract namespace, so they are visible to other processes like the
+ * originals. Only the message mode without overlapped I/O is supported.
+ * Like the original the first instance fails with ERROR_ACCESS_DENIED if
+ * the pipe exists already. "CreateFileW()" connects to a pipe.
+ */
+extern
+HANDLE
+CreateNamedPipeW
+(
+    LPCWSTR name,
+    DWORD open_mode,
+    DWORD pipe_mode,
+    DWORD max_instances,
+    DWORD out_buffer_size,
+    DWORD in_buffer_size,
+    DWORD default_timeout,
+    LPSECURITY_ATTRIBUTES security_attributes
+);
+
+extern
+BOOL
+ConnectNamedPipe
+(
+    HANDLE named_pipe_handle,
+    LPOVERLAPPED overlapped
+);
+
+extern
+BOOL
+DisconnectNamedPipe
+(
+    HANDLE named_pipe_handle
+);
+
+/* Only checks that the message read mode is requested. */
+extern
+BOOL
+SetNamedPipeHandleState
+(
+    HANDLE named_pipe_handle,
+    LPDWORD mode,
+    LPDWORD max_collection_count,
+    LPDWORD collect_data_timeout
+);
+
+/*
+ * Interrupts a blocking pipe operation of a thread of "_beginthreadex()",
+ * which then fails with ERROR_OPERATION_ABORTED. Like the original an
+ * operation which starts after the call isn't canceled.
+ */
+extern
+BOOL
+CancelSynchronousIo
+(
+    HANDLE thread_handle
+);
+
+/* Always fails, because the emulated named pipes have no busy instances. */
+extern
+BOOL
+WaitNamedPipeW
+(
+    LPCWSTR named_pipe_name,
+    DWORD timeout
+);
+
+/* Always fails, because the replacement has no consoles to attach to. */
+extern
+BOOL
+AttachConsole
+(
+    DWORD process_id
+);
+
+/*
+ * Only FSCTL_QUERY_ALLOCATED_RANGES is supported for files, it reports the
+ * data ranges found by SEEK_DATA and SEEK_HOLE. Everything else fails with
+ * ERROR_NOT_SUPPORTED, the tested units are using the device queries to
+ * optimize the I/O only.
+ */
+extern
+BOOL
+DeviceIoControl
+(
+    HANDLE device_handle,
+    DWORD io_control_code,
+    LPVOID in_buf,
+    DWORD in_buf_size,
+    LPVOID out_buf,
+    DWORD out_buf_size,
+    DWORD* returned_bytes,
+    LPOVERLAPPED overlapped
+);
+
+/* The volume functions always fail with ERROR_NOT_SUPPORTED, because Linux has no volume names. */
+extern
+BOOL
+GetVolumePathNameW
+(
+    LPCWSTR filename,
+    LPWSTR volume_path_name,
+    DWORD volume_path_name_tsize
+);
+
+extern
+BOOL
+GetVolumeNameForVolumeMountPointW
+(
+    LPCWSTR volume_mount_point,
+    LPWSTR volume_name,
+    DWORD volume_name_tsize
+);
+
+extern
+BOOL
+GetDiskFreeSpaceW
+(
+    LPCWSTR root_path_name,
+    DWORD* sectors_per_cluster,
+    DWORD* bytes_per_sector,
+    DWORD* free_clusters,
+    DWORD* total_clusters
+);
+
+/* Error code of the last failed function of the replacement in the calling thread. */
+extern
+DWORD
+GetLastError
+(
+    void
+);
+
+/* The allocated memory is zero initialized and page aligned like the original. */
+extern
+LPVOID
+VirtualAlloc
+(
+    LPVOID address,
+    SIZE_T size,
+    DWORD allocation_type,
+    DWORD protect
+);
+
+extern
+BOOL
+VirtualFree
+(
+    LPVOID address,
+    SIZE_T size,
+    DWORD free_type
+);
+
+extern
+HANDLE
+CreateFileMappingW
+(
+    HANDLE file_handle,
+    LPSECURITY_ATTRIBUTES security_attributes,
+    DWORD protect,
+    DWORD maximum_size_high,
+    DWORD maximum_size_low,
+    LPCWSTR name
+);
+
+extern
+LPVOID
+MapViewOfFile
+(
+    HANDLE file_mapping_handle,
+    DWORD desired_access,
+    DWORD file_offset_high,
+    DWORD file_offset_low,
+    size_t bytes_to_map
+);
+
+extern
+BOOL
+UnmapViewOfFile
+(
+    LPCVOID base_address
+);
+
+/*
+ * Unlike the original this isn't thread safe. The tests call it from a
+ * single thread only.
+ */
+extern
+BOOL
+InitOnceExecuteOnce
+(
+    PINIT_ONCE init_once,
+    PINIT_ONCE_FN init_fn,
+    PVOID parameter,
+    LPVOID* context
+);
+
+extern
+int
+MultiByteToWideChar
+(
+    UINT code_page,
+    DWORD flags,
+    LPCSTR multi_byte_str,
+    int multi_byte_len,
+    LPWSTR wide_char_str,
+    int wide_char_len
+);
+
+extern
+int
+WideCharToMultiByte
+(
+    UINT code_page,
+    DWORD flags,
+    LPCWSTR wide_char_str,
+    int wide_char_len,
+    LPSTR multi_byte_str,
+    int multi_byte_len,
+    LPCSTR default_char,
+    LPBOOL used_default_char
+);
+
+
+extern
+BOOL
+QueryPerformanceCounter
+(
+    LARGE_INTEGER* performance_count
+);
+
+/* The counter of the replacement counts nanoseconds. */
+extern
+BOOL
+QueryPerformanceFrequency
+(
+    LARGE_INTEGER* frequency
+);
+
+extern
+DWORD
+GetTickCount
+(
+    void
+);
+
+extern
+void
+Sleep
+(
+    DWORD milliseconds
+);
+
+extern
+void
+InitializeCriticalSection
+(
+    CRITICAL_SECTION* critical_section
+);
+
+extern
+void
+EnterCriticalSection
+(
+    CRITICAL_SECTION* critical_section
+);
+
+extern
+void
+LeaveCriticalSection
+(
+    CRITICAL_SECTION* critical_section
+);
+
+extern
+void
+DeleteCriticalSection
+(
+    CRITICAL_SECTION* critical_section
+);
+
+extern
+void
+InitializeConditionVariable
+(
+    CONDITION_VARIABLE* condition_variable
+);
+
+/* Only INFINITE is supported as timeout. */
+extern
+BOOL
+SleepConditionVariableCS
+(
+    CONDITION_VARIABLE* condition_variable,
+    CRITICAL_SECTION* critical_section,
+    DWORD milliseconds
+);
+
+extern
+void
+WakeConditionVariable
+(
+    CONDITION_VARIABLE* condition_variable
+);
+
+extern
+void
+WakeAllConditionVariable
+(
+    CONDITION_VARIABLE* condition_variable
+);
+
+extern
+HANDLE
+CreateSemaphoreW
+(
+    LPSECURITY_ATTRIBUTES security_attributes,
+    LONG initial_count,
+    LONG maximum_count,
+    LPCWSTR name
+);
+
+extern
+BOOL
+ReleaseSemaphore
+(
+    HANDLE semaphore_handle,
+    LONG release_count,
+    LONG* previous_count
+);
+
+/* Creates a manual or auto reset event without a name. */
+extern
+HANDLE
+CreateEventW
+(
+    LPSECURITY_ATTRIBUTES security_attributes,
+    BOOL manual_reset,
+    BOOL initial_state,
+    LPCWSTR name
+);
+
+extern
+BOOL
+SetEvent
+(
+    HANDLE event_handle
+);
+
+/* Waits for an event, a semaphore or a thread of "_beginthreadex()". */
+extern
+DWORD
+WaitForSingleObject
+(
+    HANDLE handle,
+    DWORD milliseconds
+);
+
+/* Only the page size, the allocation granularity and the number of processors are set. */
+extern
+void
+GetSystemInfo
+(
+    LPSYSTEM_INFO system_info
+);
+
+extern
+HANDLE
+GetCurrentThread
+(
+    void
+);
+
+extern
+DWORD
+GetCurrentThreadId
+(
+    void
+);
+
+/*
+ * The replacement has no windows. The handle of a window is the id of
+ * the thread which receives its messages, so "PostMessageW()" posts
+ * the message into the queue of that thread. Like the original a
+ * thread has a message queue after its first call of "PeekMessageW()"
+ * or "GetMessageW()", and the window filter of both is ignored, since
+ * all messages are thread messages.
+ */
+extern
+BOOL
+PostThreadMessageW
+(
+    DWORD thread_id,
+    UINT message,
+    WPARAM w_param,
+    LPARAM l_param
+);
+
+extern
+BOOL
+PostMessageW
+(
+    HWND window,
+    UINT message,
+    WPARAM w_param,
+    LPARAM l_param
+);
+
+extern
+BOOL
+PeekMessageW
+(
+    LPMSG msg,
+    HWND window,
+    UINT filter_min,
+    UINT filter_max,
+    UINT remove_flags
+);
+
+extern
+BOOL
+GetMessageW
+(
+    LPMSG msg,
+    HWND window,
+    UINT filter_min,
+    UINT filter_max
+);
+
+/*
+ * Linux has no background mode with a lowered I/O priority, so the
+ * replacement only checks the mode changes. Like the original it fails
+ * if the thread is already in the requested mode.
+ */
+extern
+BOOL
+SetThreadPriority
+(
+    HANDLE thread_handle,
+    int priority
+);
+
+
+/* Secure and wide character functions of the Microsoft C runtime */
+
+extern
+errno_t
+wcscpy_s
+(
+    wchar_t* dest,
+    size_t dest_tsize,
+    const wchar_t* src
+);
+
+extern
+errno_t
+wcsncpy_s
+(
+    wchar_t* dest,
+    size_t dest_tsize,
+    const wchar_t* src,
+    size_t count
+);
+
+extern
+errno_t
+wcscat_s
+(
+    wchar_t* dest,
+    size_t dest_tsize,
+    const wchar_t* src
+);
+
+/*
+ * Like the original "%s" means a wide string and "%I64" a 64 bit
+ * integer in the format strings.
+ */
+extern
+int
+_snwprintf_s
+(
+    wchar_t* buf,
+    size_t buf_tsize,
+    size_t count,
+    const wchar_t* format,
+    ...
+);
+
+extern
+int
+_vsnwprintf_s
+(
+    wchar_t* buf,
+    size_t buf_tsize,
+    size_t count,
+    const wchar_t* format,
+    va_list format_args
+);
+
+extern
+int
+fwprintf_s
+(
+    FILE* handle,
+    const wchar_t* format,
+    ...
+);
+
+extern
+int
+wprintf_s
+(
+    const wchar_t* format,
+    ...
+);
+
+extern
+int
+sscanf_s
+(
+    const char* buf,
+    const char* format,
+    ...
+);
+
+extern
+int
+sprintf_s
+(
+    char* buf,
+    size_t buf_size,
+    const char* format,
+    ...
+);
+
+/*
+ * "fprintf()" of the Microsoft C runtime understands "%I64". The macro
+ * is defined after "stdio.h" has been included, so it isn't undone by
+ * including "stdio.h" again.
+ */
+extern
+int
+uhashtools_win32_compat_fprintf
+(
+    FILE* handle,
+    const char* format,
+    ...
+);
+
+#define fprintf uhashtools_win32_compat_fprintf
+
+extern
+errno_t
+_wfopen_s
+(
+    FILE** handle,
+    const wchar_t* filename,
+    const wchar_t* mode
+);
+
+extern
+errno_t
+freopen_s
+(
+    FILE** handle,
+    const char* filename,
+    const char* mode,
+    FILE* stream
+);
+
+extern
+errno_t
+clearerr_s
+(
+    FILE* handle
+);
+
+extern
+size_t
+fread_s
+(
+    void* buf,
+    size_t buf_size,
+    size_t element_size,
+    size_t count,
+    FILE* handle
+);
+
+extern
+int
+_fseeki64
+(
+    FILE* handle,
+    __int64 offset,
+    int origin
+);
+
+extern
+__int64
+_ftelli64
+(
+    FILE* handle
+);
+
+#define _wcsdup wcsdup
+#define _wcsicmp wcscasecmp
+#define _wcsnicmp wcsncasecmp
+#define _wcstoui64 wcstoull
+
+/* The context is passed like to the POSIX "wcstok()". */
+#define wcstok_s wcstok
+
+/* Like the original, which includes it unless WIN32_LEAN_AND_MEAN is defined. */
+#include <winioctl.h>
@@ -0,0 +1,104 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/*
+ * Minimal replacement of the Windows SDK header "bcrypt.h". The product
+ * headers only need the names of the hash algorithms.
+ * 
+ * "BCryptOpenAlgorithmProvider()" reports every algorithm as missing, so
+ * "hash_calculation_impl.c" falls back to the built-in hasher like on a
+ * Windows without the algorithm. The other functions are never reached.
+ */
+
+#include <Windows.h>
+
+typedef LONG NTSTATUS;
+typedef void* BCRYPT_HANDLE;
+typedef BCRYPT_HANDLE BCRYPT_ALG_HANDLE;
+typedef BCRYPT_HANDLE BCRYPT_HASH_HANDLE;
+
+#define BCRYPT_MD5_ALGORITHM L"MD5"
+#define BCRYPT_SHA1_ALGORITHM L"SHA1"
+#define BCRYPT_SHA256_ALGORITHM L"SHA256"
+#define BCRYPT_SHA384_ALGORITHM L"SHA384"
+#define BCRYPT_SHA512_ALGORITHM L"SHA512"
+
+#define BCRYPT_OBJECT_LENGTH L"ObjectLength"
+#define BCRYPT_HASH_LENGTH L"HashDigestLength"
+
+extern
+NTSTATUS
+BCryptOpenAlgorithmProvider
+(
+    BCRYPT_ALG_HANDLE* algorithm_handle,
+    LPCWSTR algorithm_id,
+    LPCWSTR implementation,
+    ULONG flags
+);
+
+extern
+NTSTATUS
+BCryptCloseAlgorithmProvider
+(
+    BCRYPT_ALG_HANDLE algorithm_handle,
+    ULONG flags
+);
+
+extern
+NTSTATUS
+BCryptGetProperty
+(
+    BCRYPT_HANDLE object_handle,
+    LPCWSTR property_name,
+    PUCHAR output,
+    ULONG output_size,
+    ULONG* result_size,
+    ULONG flags
+);
+
+extern
+NTSTATUS
+BCryptCreateHash
+(
+    BCRYPT_ALG_HANDLE algorithm_handle,
+    BCRYPT_HASH_HANDLE* hash_handle,
+    PUCHAR hash_object,
+    ULONG hash_object_size,
+    PUCHAR secret,
+    ULONG secret_size,
+    ULONG flags
+);
+
+extern
+NTSTATUS
+BCryptHashData
+(
+    BCRYPT_HASH_HANDLE hash_handle,
+    PUCHAR input,
+    ULONG input_size,
+    ULONG flags
+);
+
+extern
+NTSTATUS
+BCryptFinishHash
+(
+    BCRYPT_HASH_HANDLE hash_handle,
+    PUCHAR output,
+    ULONG output_size,
+    ULONG flags
+);
+
+extern
+NTSTATUS
+BCryptDestroyHash
+(
+    BCRYPT_HASH_HANDLE hash_handle
+);
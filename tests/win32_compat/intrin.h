@@ -0,0 +1,62 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/*
+ * Minimal replacement of the MSVC intrinsics header (see "Windows.h").
+ * The intrinsics are mapped to the built-ins of GCC and Clang.
+ */
+
+#include <immintrin.h>
+
+static
+__inline__
+void
+__cpuid
+(
+    int cpu_info[4],
+    int function_id
+)
+{
+    __asm__ __volatile__("cpuid"
+                         : "=a" (cpu_info[0]), "=b" (cpu_info[1]), "=c" (cpu_info[2]), "=d" (cpu_info[3])
+                         : "a" (function_id), "c" (0));
+}
+
+static
+__inline__
+void
+__cpuidex
+(
+    int cpu_info[4],
+    int function_id,
+    int subfunction_id
+)
+{
+    __asm__ __volatile__("cpuid"
+                         : "=a" (cpu_info[0]), "=b" (cpu_info[1]), "=c" (cpu_info[2]), "=d" (cpu_info[3])
+                         : "a" (function_id), "c" (subfunction_id));
+}
+
+static
+__inline__
+unsigned __int64
+_umul128
+(
+    unsigned __int64 multiplier,
+    unsigned __int64 multiplicand,
+    unsigned __int64* product_high
+)
+{
+    const unsigned __int128 product = (unsigned __int128) multiplier * multiplicand;
+
+    *product_high = (unsigned __int64) (product >> 64);
+
+    return (unsigned __int64) product;
+}
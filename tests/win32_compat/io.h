@@ -0,0 +1,52 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/*
+ * Minimal replacement of the low level I/O header of the Microsoft C
+ * runtime (see "Windows.h").
+ */
+
+#include <Windows.h>
+
+#include <stdint.h>
+
+#include <stdio.h>
+
+extern
+__int64
+_filelengthi64
+(
+    int fd
+);
+
+#define _fileno fileno
+
+/* The handle belongs to the file descriptor and must not be closed. */
+extern
+intptr_t
+_get_osfhandle
+(
+    int fd
+);
+
+#define _O_U16TEXT 0x20000
+#define _O_U8TEXT 0x40000
+
+/*
+ * Linux streams have no translation mode, so this does nothing. Wide
+ * characters are written in the encoding of the locale.
+ */
+extern
+int
+_setmode
+(
+    int fd,
+    int mode
+);
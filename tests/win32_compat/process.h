@@ -0,0 +1,45 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/*
+ * Minimal replacement of the process and thread header of the Microsoft
+ * C runtime (see "Windows.h").
+ */
+
+#include <Windows.h>
+
+#include <stdint.h>
+
+#define CREATE_SUSPENDED 0x00000004
+
+/*
+ * The threads are started with the default stack size of the C runtime
+ * instead of "stack_size", because the sanitizers need a lot more stack
+ * than the units reserve for MSVC builds. The returned handle has to be
+ * closed by "CloseHandle()".
+ */
+extern
+uintptr_t
+_beginthreadex
+(
+    void* security,
+    unsigned int stack_size,
+    unsigned int (__stdcall* start_address)(void*),
+    void* arglist,
+    unsigned int init_flag,
+    unsigned int* thread_id
+);
+
+extern
+DWORD
+ResumeThread
+(
+    HANDLE thread_handle
+);
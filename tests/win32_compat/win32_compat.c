@@ -0,0 +1,3179 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#define _GNU_SOURCE
+#define _FILE_OFFSET_BITS 64
+
+#include <Windows.h>
+#include <bcrypt.h>
+#include <io.h>
+#include <process.h>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+/* The replacement itself has to call the original. */
+#undef fprintf
+
+/* Longer formats aren't used by the tested units. */
+#define WIN32_COMPAT_FORMAT_TSIZE 512
+
+/* Path buffer size in bytes after the conversion to the locale encoding. */
+#define WIN32_COMPAT_PATH_SIZE 4096
+
+/* File descriptors for which "_get_osfhandle()" and "GetStdHandle()" provide a handle. */
+#define WIN32_COMPAT_FD_HANDLES_COUNT 1024
+
+/* Prefix of the abstract socket names of the named pipes */
+#define WIN32_COMPAT_PIPE_SOCKET_PREFIX "uhashtools-compat-pipe-"
+
+/* Interrupts the blocking pipe operations for "CancelSynchronousIo()". */
+#define WIN32_COMPAT_CANCEL_SIGNAL SIGUSR1
+
+/* Seconds between 1601-01-01, the epoch of FILETIME, and 1970-01-01 */
+#define WIN32_COMPAT_FILETIME_EPOCH_OFFSET 11644473600ULL
+
+/* Results of the CNG API, which only reports every algorithm as missing. */
+#define WIN32_COMPAT_STATUS_NOT_FOUND ((NTSTATUS) 0xC0000225L)
+#define WIN32_COMPAT_STATUS_INVALID_HANDLE ((NTSTATUS) 0xC0000008L)
+
+/* Pseudo handle of "GetCurrentThread()", which doesn't need to be closed. */
+#define WIN32_COMPAT_CURRENT_THREAD_HANDLE ((HANDLE) (size_t) -2)
+
+enum Win32CompatHandleKind
+{
+    WIN32_COMPAT_HANDLE_KIND_FILE,
+    WIN32_COMPAT_HANDLE_KIND_FIND,
+    WIN32_COMPAT_HANDLE_KIND_PIPE,
+    WIN32_COMPAT_HANDLE_KIND_EVENT,
+    WIN32_COMPAT_HANDLE_KIND_SEMAPHORE,
+    WIN32_COMPAT_HANDLE_KIND_THREAD
+};
+
+/* Listening socket of a named pipe, which is shared by all its server instances */
+struct Win32CompatPipeListener
+{
+    struct Win32CompatPipeListener* next;
+    struct sockaddr_un address;
+    int fd;
+    unsigned int instances_count;
+};
+
+/* Message queue of a thread, which lives until the process exits */
+struct Win32CompatMessageQueue
+{
+    struct Win32CompatMessageQueue* next;
+    DWORD thread_id;
+    pthread_mutex_t lock;
+    pthread_cond_t message_posted;
+    MSG* messages;
+    size_t messages_count;
+    size_t messages_capacity;
+};
+
+struct Win32CompatHandle
+{
+    enum Win32CompatHandleKind kind;
+
+    /* File and file mapping handles */
+    int fd;
+
+    /* Find handles */
+    DIR* directory;
+    char directory_path[WIN32_COMPAT_PATH_SIZE];
+
+    /*
+     * Named pipe handles. "fd" is the connected socket, which is -1 for
+     * a server instance without a client. "pipe_listener" is NULL for
+     * the client side. A message which doesn't fit into the buffer of
+     * "ReadFile()" is kept in "pending_message" for the following reads.
+     */
+    struct Win32CompatPipeListener* pipe_listener;
+    unsigned char* pending_message;
+    size_t pending_message_size;
+    size_t pending_message_offset;
+
+    /*
+     * Waitable handles. "state" is TRUE for a signaled event, the count
+     * of a semaphore and TRUE after a thread has returned.
+     */
+    pthread_mutex_t lock;
+    pthread_cond_t state_changed;
+    LONG state;
+    LONG max_state;
+    BOOL is_manual_reset;
+
+    /* Thread handles, which are released by the handle and by the thread. */
+    unsigned int references_count;
+    unsigned int thread_id;
+    BOOL is_suspended;
+    unsigned int (__stdcall* thread_function)(void*);
+    void* thread_param;
+    pthread_t thread;
+};
+
+static __thread DWORD last_error = 0;
+
+/* Background mode of the calling thread for "SetThreadPriority()". */
+static __thread BOOL is_current_thread_in_background_mode = FALSE;
+
+static unsigned int last_thread_id = 0;
+
+/* Id of the calling thread, which is assigned by its first "GetCurrentThreadId()" or by "_beginthreadex()". */
+static __thread unsigned int current_thread_id = 0;
+
+/* Handles of the file descriptors, which belong to the C runtime and are never closed */
+static struct Win32CompatHandle fd_handles[WIN32_COMPAT_FD_HANDLES_COUNT];
+
+static pthread_mutex_t pipe_listeners_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct Win32CompatPipeListener* pipe_listeners = NULL;
+
+static pthread_once_t cancel_signal_once = PTHREAD_ONCE_INIT;
+
+static pthread_mutex_t message_queues_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct Win32CompatMessageQueue* message_queues = NULL;
+
+/*
+ * Translates the MSVC extensions of a printf or scanf format string to
+ * the C99 equivalents: "%I64" becomes "%ll". Within wide format strings
+ * MSVC interprets "%s" and "%c" as wide arguments, so if "is_wide_format"
+ * is TRUE they become "%ls" and "%lc".
+ */
+static
+void
+uhashtools_win32_compat_translate_format
+(
+    const wchar_t* format,
+    BOOL is_wide_format,
+    wchar_t* translated_format,
+    size_t translated_format_tsize
+)
+{
+    size_t used_tsize = 0;
+
+    /* A conversion specification grows by at most one character per step. */
+    while (*format && used_tsize + 3 < translated_format_tsize)
+    {
+        if (*format != L'%')
+        {
+            translated_format[used_tsize++] = *format++;
+            continue;
+        }
+
+        translated_format[used_tsize++] = *format++;
+
+        while (*format && wcschr(L"-+ #.*0123456789", *format) && used_tsize + 3 < translated_format_tsize)
+        {
+            translated_format[used_tsize++] = *format++;
+        }
+
+        if (wcsncmp(format, L"I64", 3) == 0)
+        {
+            translated_format[used_tsize++] = L'l';
+            translated_format[used_tsize++] = L'l';
+            format += 3;
+        }
+        else if (is_wide_format && (*format == L's' || *format == L'c'))
+        {
+            translated_format[used_tsize++] = L'l';
+        }
+
+        if (*format)
+        {
+            translated_format[used_tsize++] = *format++;
+        }
+    }
+
+    translated_format[used_tsize] = L'\0';
+}
+
+/* The narrow formats of the tested units only consist of ASCII characters. */
+static
+void
+uhashtools_win32_compat_translate_narrow_format
+(
+    const char* format,
+    char* translated_format,
+    size_t translated_format_size
+)
+{
+    wchar_t wide_format[WIN32_COMPAT_FORMAT_TSIZE];
+    wchar_t translated_wide_format[WIN32_COMPAT_FORMAT_TSIZE];
+
+    if (mbstowcs(wide_format, format, WIN32_COMPAT_FORMAT_TSIZE) >= WIN32_COMPAT_FORMAT_TSIZE)
+    {
+        wide_format[0] = L'\0';
+    }
+
+    uhashtools_win32_compat_translate_format(wide_format, FALSE, translated_wide_format, WIN32_COMPAT_FORMAT_TSIZE);
+
+    if (wcstombs(translated_format, translated_wide_format, translated_format_size) >= translated_format_size)
+    {
+        translated_format[0] = '\0';
+    }
+}
+
+static
+BOOL
+uhashtools_win32_compat_narrow_path
+(
+    const wchar_t* wide_path,
+    char* path_buf
+)
+{
+    const size_t converted_size = wcstombs(path_buf, wide_path, WIN32_COMPAT_PATH_SIZE);
+    size_t i = 0;
+
+    if (converted_size == (size_t) -1 || converted_size >= WIN32_COMPAT_PATH_SIZE)
+    {
+        return FALSE;
+    }
+
+    /* The tested units join the paths with the Windows separator. */
+    for (i = 0; i < converted_size; ++i)
+    {
+        if (path_buf[i] == '\\')
+        {
+            path_buf[i] = '/';
+        }
+    }
+
+    return TRUE;
+}
+
+static
+FILETIME
+uhashtools_win32_compat_to_filetime
+(
+    const struct timespec* time
+)
+{
+    const unsigned __int64 filetime_value = ((unsigned __int64) time->tv_sec + WIN32_COMPAT_FILETIME_EPOCH_OFFSET) * 10000000ULL +
+                                            (unsigned __int64) time->tv_nsec / 100;
+    FILETIME ret;
+
+    ret.dwLowDateTime = (DWORD) filetime_value;
+    ret.dwHighDateTime = (DWORD) (filetime_value >> 32);
+
+    return ret;
+}
+
+/*
+ * Regular files with fewer allocated blocks than their size have holes,
+ * which is reported like the sparse attribute of NTFS.
+ */
+static
+DWORD
+uhashtools_win32_compat_get_file_attributes
+(
+    const struct stat* file_stat
+)
+{
+    if (S_ISDIR(file_stat->st_mode))
+    {
+        return FILE_ATTRIBUTE_DIRECTORY;
+    }
+
+    if (S_ISCHR(file_stat->st_mode) || S_ISBLK(file_stat->st_mode))
+    {
+        return FILE_ATTRIBUTE_DEVICE;
+    }
+
+    if (S_ISREG(file_stat->st_mode) && (unsigned __int64) file_stat->st_blocks * 512 < (unsigned __int64) file_stat->st_size)
+    {
+        return FILE_ATTRIBUTE_SPARSE_FILE;
+    }
+
+    return FILE_ATTRIBUTE_NORMAL;
+}
+
+/* Reads the next entry of a find handle. Returns FALSE with ERROR_NO_MORE_FILES at the end. */
+static
+BOOL
+uhashtools_win32_compat_find_next
+(
+    struct Win32CompatHandle* compat_handle,
+    WIN32_FIND_DATAW* find_data
+)
+{
+    const struct dirent* directory_entry = NULL;
+
+    while ((directory_entry = readdir(compat_handle->directory)) != NULL)
+    {
+        char entry_path[WIN32_COMPAT_PATH_SIZE];
+        struct stat entry_stat;
+
+        /* Entries which vanished or don't fit are skipped. */
+        if (snprintf(entry_path, sizeof entry_path, "%s/%s", compat_handle->directory_path, directory_entry->d_name) >= (int) sizeof entry_path ||
+            lstat(entry_path, &entry_stat) != 0 ||
+            mbstowcs(find_data->cFileName, directory_entry->d_name, MAX_PATH) >= MAX_PATH)
+        {
+            continue;
+        }
+
+        find_data->dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
+
+        if (S_ISDIR(entry_stat.st_mode))
+        {
+            find_data->dwFileAttributes = FILE_ATTRIBUTE_DIRECTORY;
+        }
+        else if (S_ISLNK(entry_stat.st_mode))
+        {
+            find_data->dwFileAttributes = FILE_ATTRIBUTE_REPARSE_POINT;
+        }
+
+        find_data->ftCreationTime = uhashtools_win32_compat_to_filetime(&entry_stat.st_ctim);
+        find_data->ftLastAccessTime = uhashtools_win32_compat_to_filetime(&entry_stat.st_atim);
+        find_data->ftLastWriteTime = uhashtools_win32_compat_to_filetime(&entry_stat.st_mtim);
+        find_data->nFileSizeHigh = S_ISDIR(entry_stat.st_mode) ? 0 : (DWORD) ((unsigned __int64) entry_stat.st_size >> 32);
+        find_data->nFileSizeLow = S_ISDIR(entry_stat.st_mode) ? 0 : (DWORD) entry_stat.st_size;
+        find_data->cAlternateFileName[0] = L'\0';
+
+        return TRUE;
+    }
+
+    last_error = ERROR_NO_MORE_FILES;
+
+    return FALSE;
+}
+
+static
+struct Win32CompatHandle*
+uhashtools_win32_compat_create_waitable_handle
+(
+    enum Win32CompatHandleKind kind
+)
+{
+    struct Win32CompatHandle* compat_handle = (struct Win32CompatHandle*) calloc(1, sizeof *compat_handle);
+
+    if (!compat_handle)
+    {
+        return NULL;
+    }
+
+    compat_handle->kind = kind;
+    compat_handle->fd = -1;
+
+    if (pthread_mutex_init(&compat_handle->lock, NULL) != 0)
+    {
+        free((void*) compat_handle);
+
+        return NULL;
+    }
+
+    if (pthread_cond_init(&compat_handle->state_changed, NULL) != 0)
+    {
+        (void) pthread_mutex_destroy(&compat_handle->lock);
+        free((void*) compat_handle);
+
+        return NULL;
+    }
+
+    return compat_handle;
+}
+
+/* The last one of the handle and the thread frees the handle. */
+static
+void
+uhashtools_win32_compat_release_thread_handle
+(
+    struct Win32CompatHandle* compat_handle
+)
+{
+    unsigned int references_count = 0;
+
+    (void) pthread_mutex_lock(&compat_handle->lock);
+    references_count = --compat_handle->references_count;
+    (void) pthread_mutex_unlock(&compat_handle->lock);
+
+    if (references_count == 0)
+    {
+        (void) pthread_cond_destroy(&compat_handle->state_changed);
+        (void) pthread_mutex_destroy(&compat_handle->lock);
+        free((void*) compat_handle);
+    }
+}
+
+static
+void*
+uhashtools_win32_compat_thread_main
+(
+    void* thread_param
+)
+{
+    struct Win32CompatHandle* compat_handle = (struct Win32CompatHandle*) thread_param;
+
+    (void) pthread_mutex_lock(&compat_handle->lock);
+
+    current_thread_id = compat_handle->thread_id;
+
+    while (compat_handle->is_suspended)
+    {
+        (void) pthread_cond_wait(&compat_handle->state_changed, &compat_handle->lock);
+    }
+
+    (void) pthread_mutex_unlock(&compat_handle->lock);
+
+    (void) compat_handle->thread_function(compat_handle->thread_param);
+
+    (void) pthread_mutex_lock(&compat_handle->lock);
+    compat_handle->state = TRUE;
+    (void) pthread_cond_broadcast(&compat_handle->state_changed);
+    (void) pthread_mutex_unlock(&compat_handle->lock);
+
+    uhashtools_win32_compat_release_thread_handle(compat_handle);
+
+    return NULL;
+}
+
+/*
+ * Converts "\\.\pipe\<name>" to the abstract socket address of the
+ * named pipe. Returns FALSE for other paths.
+ */
+static
+BOOL
+uhashtools_win32_compat_get_pipe_address
+(
+    const wchar_t* pipe_path,
+    struct sockaddr_un* address
+)
+{
+    static const wchar_t pipe_prefix[] = L"\\\\.\\pipe\\";
+    const size_t pipe_prefix_tlen = sizeof pipe_prefix / sizeof pipe_prefix[0] - 1;
+    char pipe_name[WIN32_COMPAT_PATH_SIZE];
+    size_t pipe_name_len = 0;
+
+    if (wcsncasecmp(pipe_path, pipe_prefix, pipe_prefix_tlen) != 0)
+    {
+        return FALSE;
+    }
+
+    pipe_name_len = wcstombs(pipe_name, pipe_path + pipe_prefix_tlen, WIN32_COMPAT_PATH_SIZE);
+
+    /* The abstract name starts behind the leading zero byte and isn't terminated. */
+    if (pipe_name_len == 0 || pipe_name_len == (size_t) -1 ||
+        1 + strlen(WIN32_COMPAT_PIPE_SOCKET_PREFIX) + pipe_name_len > sizeof address->sun_path)
+    {
+        return FALSE;
+    }
+
+    (void) memset((void*) address, 0, sizeof *address);
+    address->sun_family = AF_UNIX;
+    (void) memcpy((void*) (address->sun_path + 1), WIN32_COMPAT_PIPE_SOCKET_PREFIX, strlen(WIN32_COMPAT_PIPE_SOCKET_PREFIX));
+    (void) memcpy((void*) (address->sun_path + 1 + strlen(WIN32_COMPAT_PIPE_SOCKET_PREFIX)), pipe_name, pipe_name_len);
+
+    return TRUE;
+}
+
+static
+socklen_t
+uhashtools_win32_compat_get_pipe_address_size
+(
+    const struct sockaddr_un* address
+)
+{
+    return (socklen_t) (offsetof(struct sockaddr_un, sun_path) + 1 + strlen(WIN32_COMPAT_PIPE_SOCKET_PREFIX) +
+                        strnlen(address->sun_path + 1 + strlen(WIN32_COMPAT_PIPE_SOCKET_PREFIX),
+                                sizeof address->sun_path - 1 - strlen(WIN32_COMPAT_PIPE_SOCKET_PREFIX)));
+}
+
+static
+void
+uhashtools_win32_compat_release_pipe_listener
+(
+    struct Win32CompatPipeListener* pipe_listener
+)
+{
+    struct Win32CompatPipeListener** link = NULL;
+
+    (void) pthread_mutex_lock(&pipe_listeners_lock);
+
+    if (--pipe_listener->instances_count == 0)
+    {
+        for (link = &pipe_listeners; *link != pipe_listener; link = &(*link)->next)
+        {
+        }
+
+        *link = pipe_listener->next;
+        (void) close(pipe_listener->fd);
+        free((void*) pipe_listener);
+    }
+
+    (void) pthread_mutex_unlock(&pipe_listeners_lock);
+}
+
+static
+void
+uhashtools_win32_compat_drop_pending_message
+(
+    struct Win32CompatHandle* compat_handle
+)
+{
+    free((void*) compat_handle->pending_message);
+    compat_handle->pending_message = NULL;
+    compat_handle->pending_message_size = 0;
+    compat_handle->pending_message_offset = 0;
+}
+
+/*
+ * Reads the next message of a named pipe in message mode. Like the
+ * original a message which doesn't fit into the buffer fails with
+ * ERROR_MORE_DATA and the rest is returned by the following reads.
+ */
+static
+BOOL
+uhashtools_win32_compat_read_pipe
+(
+    struct Win32CompatHandle* compat_handle,
+    LPVOID buf,
+    DWORD bytes_to_read,
+    DWORD* read_bytes
+)
+{
+    size_t copied_size = 0;
+
+    if (!compat_handle->pending_message)
+    {
+        ssize_t message_size = recv(compat_handle->fd, NULL, 0, MSG_PEEK | MSG_TRUNC);
+
+        /* The protocols of the tested units have no empty messages, so no data means that the other side is gone. */
+        if (message_size <= 0)
+        {
+            last_error = message_size < 0 && errno == EINTR ? ERROR_OPERATION_ABORTED : ERROR_BROKEN_PIPE;
+
+            return FALSE;
+        }
+
+        if ((size_t) message_size <= bytes_to_read)
+        {
+            message_size = recv(compat_handle->fd, buf, bytes_to_read, 0);
+
+            if (message_size <= 0)
+            {
+                last_error = ERROR_BROKEN_PIPE;
+
+                return FALSE;
+            }
+
+            *read_bytes = (DWORD) message_size;
+
+            return TRUE;
+        }
+
+        compat_handle->pending_message = (unsigned char*) malloc((size_t) message_size);
+
+        if (!compat_handle->pending_message ||
+            recv(compat_handle->fd, (void*) compat_handle->pending_message, (size_t) message_size, 0) != message_size)
+        {
+            uhashtools_win32_compat_drop_pending_message(compat_handle);
+            last_error = ERROR_BROKEN_PIPE;
+
+            return FALSE;
+        }
+
+        compat_handle->pending_message_size = (size_t) message_size;
+    }
+
+    copied_size = compat_handle->pending_message_size - compat_handle->pending_message_offset;
+
+    if (copied_size > bytes_to_read)
+    {
+        copied_size = bytes_to_read;
+    }
+
+    (void) memcpy(buf, (const void*) (compat_handle->pending_message + compat_handle->pending_message_offset), copied_size);
+    compat_handle->pending_message_offset += copied_size;
+    *read_bytes = (DWORD) copied_size;
+
+    if (compat_handle->pending_message_offset < compat_handle->pending_message_size)
+    {
+        last_error = ERROR_MORE_DATA;
+
+        return FALSE;
+    }
+
+    uhashtools_win32_compat_drop_pending_message(compat_handle);
+
+    return TRUE;
+}
+
+/* The signal only interrupts the blocking calls, since it's installed without SA_RESTART. */
+static
+void
+uhashtools_win32_compat_on_cancel_signal
+(
+    int signal_number
+)
+{
+    (void) signal_number;
+}
+
+static
+void
+uhashtools_win32_compat_install_cancel_signal
+(
+    void
+)
+{
+    struct sigaction signal_action;
+
+    (void) memset((void*) &signal_action, 0, sizeof signal_action);
+    signal_action.sa_handler = uhashtools_win32_compat_on_cancel_signal;
+    (void) sigemptyset(&signal_action.sa_mask);
+
+    (void) sigaction(WIN32_COMPAT_CANCEL_SIGNAL, &signal_action, NULL);
+}
+
+BOOL
+CloseHandle
+(
+    HANDLE handle
+)
+{
+    struct Win32CompatHandle* compat_handle = (struct Win32CompatHandle*) handle;
+    int close_rc = 0;
+
+    switch (compat_handle->kind)
+    {
+        case WIN32_COMPAT_HANDLE_KIND_FILE:
+        {
+            close_rc = close(compat_handle->fd);
+        } break;
+        case WIN32_COMPAT_HANDLE_KIND_PIPE:
+        {
+            if (compat_handle->fd >= 0)
+            {
+                close_rc = close(compat_handle->fd);
+            }
+
+            if (compat_handle->pipe_listener)
+            {
+                uhashtools_win32_compat_release_pipe_listener(compat_handle->pipe_listener);
+            }
+
+            uhashtools_win32_compat_drop_pending_message(compat_handle);
+        } break;
+        case WIN32_COMPAT_HANDLE_KIND_THREAD:
+        {
+            uhashtools_win32_compat_release_thread_handle(compat_handle);
+
+            return TRUE;
+        }
+        default:
+        {
+            (void) pthread_cond_destroy(&compat_handle->state_changed);
+            (void) pthread_mutex_destroy(&compat_handle->lock);
+        }
+    }
+
+    free((void*) compat_handle);
+
+    return close_rc == 0;
+}
+
+HANDLE
+CreateFileW
+(
+    LPCWSTR filename,
+    DWORD desired_access,
+    DWORD share_mode,
+    LPSECURITY_ATTRIBUTES security_attributes,
+    DWORD creation_disposition,
+    DWORD flags_and_attributes,
+    HANDLE template_file
+)
+{
+    char path[WIN32_COMPAT_PATH_SIZE];
+    struct sockaddr_un pipe_address;
+    struct Win32CompatHandle* compat_handle = NULL;
+
+    (void) share_mode;
+    (void) security_attributes;
+    (void) flags_and_attributes;
+    (void) template_file;
+
+    if (creation_disposition != OPEN_EXISTING)
+    {
+        return INVALID_HANDLE_VALUE;
+    }
+
+    /* The client side of a named pipe connects to the socket of "CreateNamedPipeW()". */
+    if (uhashtools_win32_compat_get_pipe_address(filename, &pipe_address))
+    {
+        compat_handle = (struct Win32CompatHandle*) calloc(1, sizeof *compat_handle);
+
+        if (!compat_handle)
+        {
+            return INVALID_HANDLE_VALUE;
+        }
+
+        compat_handle->kind = WIN32_COMPAT_HANDLE_KIND_PIPE;
+        compat_handle->fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+
+        if (compat_handle->fd < 0 ||
+            connect(compat_handle->fd,
+                    (const struct sockaddr*) &pipe_address,
+                    uhashtools_win32_compat_get_pipe_address_size(&pipe_address)) != 0)
+        {
+            if (compat_handle->fd >= 0)
+            {
+                (void) close(compat_handle->fd);
+            }
+
+            free((void*) compat_handle);
+            last_error = ERROR_FILE_NOT_FOUND;
+
+            return INVALID_HANDLE_VALUE;
+        }
+
+        return (HANDLE) compat_handle;
+    }
+
+    /* Only existing files can be opened, either for reading or for reading their attributes. */
+    if ((desired_access != GENERIC_READ && desired_access != FILE_READ_ATTRIBUTES) ||
+        !uhashtools_win32_compat_narrow_path(filename, path))
+    {
+        return INVALID_HANDLE_VALUE;
+    }
+
+    compat_handle = (struct Win32CompatHandle*) calloc(1, sizeof *compat_handle);
+
+    if (!compat_handle)
+    {
+        return INVALID_HANDLE_VALUE;
+    }
+
+    /* Opening only the attributes of a named pipe or a device doesn't block. */
+    compat_handle->fd = open(path, desired_access == GENERIC_READ ? O_RDONLY : O_PATH);
+
+    if (compat_handle->fd < 0)
+    {
+        free((void*) compat_handle);
+
+        return INVALID_HANDLE_VALUE;
+    }
+
+    return (HANDLE) compat_handle;
+}
+
+BOOL
+GetFileSizeEx
+(
+    HANDLE file_handle,
+    LARGE_INTEGER* file_size
+)
+{
+    const struct Win32CompatHandle* compat_handle = (const struct Win32CompatHandle*) file_handle;
+    struct stat file_stat;
+
+    if (fstat(compat_handle->fd, &file_stat) != 0)
+    {
+        return FALSE;
+    }
+
+    file_size->QuadPart = (LONGLONG) file_stat.st_size;
+
+    return TRUE;
+}
+
+BOOL
+ReadFile
+(
+    HANDLE file_handle,
+    LPVOID buf,
+    DWORD bytes_to_read,
+    DWORD* read_bytes,
+    LPOVERLAPPED overlapped
+)
+{
+    struct Win32CompatHandle* compat_handle = (struct Win32CompatHandle*) file_handle;
+    struct stat file_stat;
+    ssize_t read_rc = -1;
+
+    if (read_bytes)
+    {
+        *read_bytes = 0;
+    }
+
+    if (compat_handle->kind == WIN32_COMPAT_HANDLE_KIND_PIPE)
+    {
+        DWORD pipe_read_bytes = 0;
+        const BOOL is_read = uhashtools_win32_compat_read_pipe(compat_handle, buf, bytes_to_read, &pipe_read_bytes);
+
+        if (read_bytes)
+        {
+            *read_bytes = pipe_read_bytes;
+        }
+
+        return is_read;
+    }
+
+    if (overlapped)
+    {
+        const unsigned __int64 offset = ((unsigned __int64) overlapped->OffsetHigh << 32) | overlapped->Offset;
+
+        do
+        {
+            read_rc = pread(compat_handle->fd, buf, bytes_to_read, (off_t) offset);
+        }
+        while (read_rc < 0 && errno == EINTR);
+
+        overlapped->Internal = 0;
+        overlapped->InternalHigh = read_rc > 0 ? (ULONG_PTR) read_rc : 0;
+    }
+    else
+    {
+        do
+        {
+            read_rc = read(compat_handle->fd, buf, bytes_to_read);
+        }
+        while (read_rc < 0 && errno == EINTR);
+    }
+
+    if (read_rc < 0)
+    {
+        last_error = ERROR_READ_FAULT;
+
+        return FALSE;
+    }
+
+    if (read_rc == 0 && overlapped)
+    {
+        last_error = ERROR_HANDLE_EOF;
+
+        return FALSE;
+    }
+
+    if (read_rc == 0 && fstat(compat_handle->fd, &file_stat) == 0 && S_ISFIFO(file_stat.st_mode))
+    {
+        last_error = ERROR_BROKEN_PIPE;
+
+        return FALSE;
+    }
+
+    if (read_bytes)
+    {
+        *read_bytes = (DWORD) read_rc;
+    }
+
+    return TRUE;
+}
+
+BOOL
+WriteFile
+(
+    HANDLE file_handle,
+    LPCVOID buf,
+    DWORD bytes_to_write,
+    DWORD* written_bytes,
+    LPOVERLAPPED overlapped
+)
+{
+    const struct Win32CompatHandle* compat_handle = (const struct Win32CompatHandle*) file_handle;
+    ssize_t write_rc = -1;
+
+    if (written_bytes)
+    {
+        *written_bytes = 0;
+    }
+
+    if (overlapped)
+    {
+        last_error = ERROR_NOT_SUPPORTED;
+
+        return FALSE;
+    }
+
+    /* A message of a named pipe is written as one packet. */
+    if (compat_handle->kind == WIN32_COMPAT_HANDLE_KIND_PIPE)
+    {
+        write_rc = send(compat_handle->fd, buf, bytes_to_write, MSG_NOSIGNAL);
+    }
+    else
+    {
+        write_rc = write(compat_handle->fd, buf, bytes_to_write);
+    }
+
+    if (write_rc < 0)
+    {
+        last_error = errno == EINTR ? ERROR_OPERATION_ABORTED : ERROR_NO_DATA;
+
+        return FALSE;
+    }
+
+    if (written_bytes)
+    {
+        *written_bytes = (DWORD) write_rc;
+    }
+
+    return TRUE;
+}
+
+BOOL
+FlushFileBuffers
+(
+    HANDLE file_handle
+)
+{
+    const struct Win32CompatHandle* compat_handle = (const struct Win32CompatHandle*) file_handle;
+
+    /* The written messages of a socket stay readable after it has been closed, so only files are synced. */
+    if (compat_handle->kind == WIN32_COMPAT_HANDLE_KIND_PIPE)
+    {
+        return TRUE;
+    }
+
+    return fsync(compat_handle->fd) == 0;
+}
+
+BOOL
+GetOverlappedResult
+(
+    HANDLE file_handle,
+    LPOVERLAPPED overlapped,
+    DWORD* transferred_bytes,
+    BOOL wait
+)
+{
+    (void) file_handle;
+    (void) wait;
+
+    *transferred_bytes = (DWORD) overlapped->InternalHigh;
+
+    if (*transferred_bytes == 0)
+    {
+        last_error = ERROR_HANDLE_EOF;
+
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+BOOL
+CancelIoEx
+(
+    HANDLE file_handle,
+    LPOVERLAPPED overlapped
+)
+{
+    (void) file_handle;
+    (void) overlapped;
+
+    return TRUE;
+}
+
+BOOL
+GetFileInformationByHandle
+(
+    HANDLE file_handle,
+    BY_HANDLE_FILE_INFORMATION* file_information
+)
+{
+    const struct Win32CompatHandle* compat_handle = (const struct Win32CompatHandle*) file_handle;
+    struct stat file_stat;
+
+    if (fstat(compat_handle->fd, &file_stat) != 0)
+    {
+        return FALSE;
+    }
+
+    (void) memset((void*) file_information, 0, sizeof *file_information);
+    file_information->dwFileAttributes = uhashtools_win32_compat_get_file_attributes(&file_stat);
+
+    file_information->ftCreationTime = uhashtools_win32_compat_to_filetime(&file_stat.st_ctim);
+    file_information->ftLastAccessTime = uhashtools_win32_compat_to_filetime(&file_stat.st_atim);
+    file_information->ftLastWriteTime = uhashtools_win32_compat_to_filetime(&file_stat.st_mtim);
+    file_information->nFileSizeHigh = (DWORD) ((unsigned __int64) file_stat.st_size >> 32);
+    file_information->nFileSizeLow = (DWORD) file_stat.st_size;
+    file_information->nNumberOfLinks = (DWORD) file_stat.st_nlink;
+    file_information->nFileIndexHigh = (DWORD) ((unsigned __int64) file_stat.st_ino >> 32);
+    file_information->nFileIndexLow = (DWORD) file_stat.st_ino;
+
+    return TRUE;
+}
+
+BOOL
+GetFileAttributesExW
+(
+    LPCWSTR filename,
+    GET_FILEEX_INFO_LEVELS info_level_id,
+    LPVOID file_information
+)
+{
+    WIN32_FILE_ATTRIBUTE_DATA* file_attributes = (WIN32_FILE_ATTRIBUTE_DATA*) file_information;
+    char path[WIN32_COMPAT_PATH_SIZE];
+    struct stat file_stat;
+
+    if (info_level_id != GetFileExInfoStandard || !uhashtools_win32_compat_narrow_path(filename, path))
+    {
+        return FALSE;
+    }
+
+    if (stat(path, &file_stat) != 0)
+    {
+        last_error = ERROR_FILE_NOT_FOUND;
+
+        return FALSE;
+    }
+
+    (void) memset((void*) file_attributes, 0, sizeof *file_attributes);
+    file_attributes->dwFileAttributes = uhashtools_win32_compat_get_file_attributes(&file_stat);
+    file_attributes->ftCreationTime = uhashtools_win32_compat_to_filetime(&file_stat.st_ctim);
+    file_attributes->ftLastAccessTime = uhashtools_win32_compat_to_filetime(&file_stat.st_atim);
+    file_attributes->ftLastWriteTime = uhashtools_win32_compat_to_filetime(&file_stat.st_mtim);
+    file_attributes->nFileSizeHigh = (DWORD) ((unsigned __int64) file_stat.st_size >> 32);
+    file_attributes->nFileSizeLow = (DWORD) file_stat.st_size;
+
+    return TRUE;
+}
+
+HANDLE
+FindFirstFileExW
+(
+    LPCWSTR filename,
+    FINDEX_INFO_LEVELS info_level_id,
+    LPVOID find_file_data,
+    FINDEX_SEARCH_OPS search_op,
+    LPVOID search_filter,
+    DWORD additional_flags
+)
+{
+    wchar_t directory_path[WIN32_COMPAT_PATH_SIZE];
+    const size_t filename_tlen = wcslen(filename);
+    struct Win32CompatHandle* compat_handle = NULL;
+
+    (void) info_level_id;
+    (void) search_filter;
+    (void) additional_flags;
+
+    /* Only listing a whole directory with "<directory>\*" is supported. */
+    if (search_op != FindExSearchNameMatch || filename_tlen < 2 || filename_tlen >= WIN32_COMPAT_PATH_SIZE ||
+        wcscmp(filename + filename_tlen - 2, L"\\*") != 0)
+    {
+        last_error = ERROR_NOT_SUPPORTED;
+
+        return INVALID_HANDLE_VALUE;
+    }
+
+    (void) wcsncpy_s(directory_path, WIN32_COMPAT_PATH_SIZE, filename, filename_tlen - 2);
+
+    compat_handle = (struct Win32CompatHandle*) calloc(1, sizeof *compat_handle);
+
+    if (!compat_handle)
+    {
+        return INVALID_HANDLE_VALUE;
+    }
+
+    compat_handle->kind = WIN32_COMPAT_HANDLE_KIND_FIND;
+    compat_handle->fd = -1;
+
+    if (!uhashtools_win32_compat_narrow_path(directory_path, compat_handle->directory_path) ||
+        (compat_handle->directory = opendir(compat_handle->directory_path)) == NULL)
+    {
+        free((void*) compat_handle);
+        last_error = ERROR_FILE_NOT_FOUND;
+
+        return INVALID_HANDLE_VALUE;
+    }
+
+    /* Like on Windows a directory always has the entries "." and "..", so it's never empty. */
+    if (!uhashtools_win32_compat_find_next(compat_handle, (WIN32_FIND_DATAW*) find_file_data))
+    {
+        (void) FindClose((HANDLE) compat_handle);
+
+        return INVALID_HANDLE_VALUE;
+    }
+
+    return (HANDLE) compat_handle;
+}
+
+BOOL
+FindNextFileW
+(
+    HANDLE find_handle,
+    LPWIN32_FIND_DATAW find_file_data
+)
+{
+    return uhashtools_win32_compat_find_next((struct Win32CompatHandle*) find_handle, find_file_data);
+}
+
+BOOL
+FindClose
+(
+    HANDLE find_handle
+)
+{
+    struct Win32CompatHandle* compat_handle = (struct Win32CompatHandle*) find_handle;
+    const int close_rc = closedir(compat_handle->directory);
+
+    free((void*) compat_handle);
+
+    return close_rc == 0;
+}
+
+BOOL
+MoveFileExW
+(
+    LPCWSTR existing_filename,
+    LPCWSTR new_filename,
+    DWORD flags
+)
+{
+    char existing_path[WIN32_COMPAT_PATH_SIZE];
+    char new_path[WIN32_COMPAT_PATH_SIZE];
+    struct stat file_stat;
+
+    if (!uhashtools_win32_compat_narrow_path(existing_filename, existing_path) ||
+        !uhashtools_win32_compat_narrow_path(new_filename, new_path))
+    {
+        return FALSE;
+    }
+
+    /* "rename()" always replaces the target. */
+    if (!(flags & MOVEFILE_REPLACE_EXISTING) && stat(new_path, &file_stat) == 0)
+    {
+        return FALSE;
+    }
+
+    return rename(existing_path, new_path) == 0;
+}
+
+BOOL
+DeleteFileW
+(
+    LPCWSTR filename
+)
+{
+    char path[WIN32_COMPAT_PATH_SIZE];
+
+    return uhashtools_win32_compat_narrow_path(filename, path) && unlink(path) == 0;
+}
+
+HANDLE
+GetStdHandle
+(
+    DWORD std_handle
+)
+{
+    int fd = -1;
+
+    switch (std_handle)
+    {
+        case STD_INPUT_HANDLE:
+        {
+            fd = 0;
+        } break;
+        case STD_OUTPUT_HANDLE:
+        {
+            fd = 1;
+        } break;
+        case STD_ERROR_HANDLE:
+        {
+            fd = 2;
+        } break;
+        default:
+        {
+            return INVALID_HANDLE_VALUE;
+        }
+    }
+
+    return (HANDLE) _get_osfhandle(fd);
+}
+
+DWORD
+GetFileType
+(
+    HANDLE file_handle
+)
+{
+    const struct Win32CompatHandle* compat_handle = (const struct Win32CompatHandle*) file_handle;
+    struct stat file_stat;
+
+    if (compat_handle->kind == WIN32_COMPAT_HANDLE_KIND_PIPE)
+    {
+        return FILE_TYPE_PIPE;
+    }
+
+    if (fstat(compat_handle->fd, &file_stat) != 0)
+    {
+        return FILE_TYPE_UNKNOWN;
+    }
+
+    /* Like on Windows directories are on a disk, too. */
+    if (S_ISREG(file_stat.st_mode) || S_ISDIR(file_stat.st_mode))
+    {
+        return FILE_TYPE_DISK;
+    }
+
+    if (S_ISCHR(file_stat.st_mode))
+    {
+        return FILE_TYPE_CHAR;
+    }
+
+    if (S_ISFIFO(file_stat.st_mode) || S_ISSOCK(file_stat.st_mode))
+    {
+        return FILE_TYPE_PIPE;
+    }
+
+    return FILE_TYPE_UNKNOWN;
+}
+
+HANDLE
+CreateNamedPipeW
+(
+    LPCWSTR name,
+    DWORD open_mode,
+    DWORD pipe_mode,
+    DWORD max_instances,
+    DWORD out_buffer_size,
+    DWORD in_buffer_size,
+    DWORD default_timeout,
+    LPSECURITY_ATTRIBUTES security_attributes
+)
+{
+    struct sockaddr_un pipe_address;
+    struct Win32CompatPipeListener* pipe_listener = NULL;
+    struct Win32CompatHandle* compat_handle = NULL;
+
+    (void) max_instances;
+    (void) out_buffer_size;
+    (void) in_buffer_size;
+    (void) default_timeout;
+    (void) security_attributes;
+
+    if (!(pipe_mode & PIPE_TYPE_MESSAGE) || !uhashtools_win32_compat_get_pipe_address(name, &pipe_address))
+    {
+        last_error = ERROR_NOT_SUPPORTED;
+
+        return INVALID_HANDLE_VALUE;
+    }
+
+    compat_handle = (struct Win32CompatHandle*) calloc(1, sizeof *compat_handle);
+
+    if (!compat_handle)
+    {
+        return INVALID_HANDLE_VALUE;
+    }
+
+    compat_handle->kind = WIN32_COMPAT_HANDLE_KIND_PIPE;
+    compat_handle->fd = -1;
+
+    (void) pthread_mutex_lock(&pipe_listeners_lock);
+
+    for (pipe_listener = pipe_listeners; pipe_listener; pipe_listener = pipe_listener->next)
+    {
+        if (memcmp((const void*) &pipe_listener->address, (const void*) &pipe_address, sizeof pipe_address) == 0)
+        {
+            break;
+        }
+    }
+
+    /* Like the original the first instance fails if the pipe exists already, also in another process. */
+    if (!pipe_listener && (open_mode & FILE_FLAG_FIRST_PIPE_INSTANCE))
+    {
+        pipe_listener = (struct Win32CompatPipeListener*) calloc(1, sizeof *pipe_listener);
+
+        if (pipe_listener)
+        {
+            pipe_listener->address = pipe_address;
+            pipe_listener->fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+
+            if (pipe_listener->fd < 0 ||
+                bind(pipe_listener->fd,
+                     (const struct sockaddr*) &pipe_address,
+                     uhashtools_win32_compat_get_pipe_address_size(&pipe_address)) != 0 ||
+                listen(pipe_listener->fd, SOMAXCONN) != 0)
+            {
+                if (pipe_listener->fd >= 0)
+                {
+                    (void) close(pipe_listener->fd);
+                }
+
+                free((void*) pipe_listener);
+                pipe_listener = NULL;
+            }
+            else
+            {
+                pipe_listener->next = pipe_listeners;
+                pipe_listeners = pipe_listener;
+            }
+        }
+    }
+    else if (pipe_listener && (open_mode & FILE_FLAG_FIRST_PIPE_INSTANCE))
+    {
+        pipe_listener = NULL;
+    }
+
+    if (pipe_listener)
+    {
+        ++pipe_listener->instances_count;
+    }
+
+    (void) pthread_mutex_unlock(&pipe_listeners_lock);
+
+    if (!pipe_listener)
+    {
+        free((void*) compat_handle);
+        last_error = ERROR_ACCESS_DENIED;
+
+        return INVALID_HANDLE_VALUE;
+    }
+
+    compat_handle->pipe_listener = pipe_listener;
+
+    return (HANDLE) compat_handle;
+}
+
+BOOL
+ConnectNamedPipe
+(
+    HANDLE named_pipe_handle,
+    LPOVERLAPPED overlapped
+)
+{
+    struct Win32CompatHandle* compat_handle = (struct Win32CompatHandle*) named_pipe_handle;
+
+    if (overlapped)
+    {
+        last_error = ERROR_NOT_SUPPORTED;
+
+        return FALSE;
+    }
+
+    if (compat_handle->fd >= 0)
+    {
+        last_error = ERROR_PIPE_CONNECTED;
+
+        return FALSE;
+    }
+
+    compat_handle->fd = accept4(compat_handle->pipe_listener->fd, NULL, NULL, SOCK_CLOEXEC);
+
+    if (compat_handle->fd < 0)
+    {
+        last_error = errno == EINTR ? ERROR_OPERATION_ABORTED : ERROR_NO_DATA;
+
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+BOOL
+DisconnectNamedPipe
+(
+    HANDLE named_pipe_handle
+)
+{
+    struct Win32CompatHandle* compat_handle = (struct Win32CompatHandle*) named_pipe_handle;
+
+    uhashtools_win32_compat_drop_pending_message(compat_handle);
+
+    if (compat_handle->fd < 0)
+    {
+        return TRUE;
+    }
+
+    (void) close(compat_handle->fd);
+    compat_handle->fd = -1;
+
+    return TRUE;
+}
+
+BOOL
+SetNamedPipeHandleState
+(
+    HANDLE named_pipe_handle,
+    LPDWORD mode,
+    LPDWORD max_collection_count,
+    LPDWORD collect_data_timeout
+)
+{
+    (void) named_pipe_handle;
+    (void) max_collection_count;
+    (void) collect_data_timeout;
+
+    return !mode || (*mode & PIPE_READMODE_MESSAGE) != 0;
+}
+
+BOOL
+CancelSynchronousIo
+(
+    HANDLE thread_handle
+)
+{
+    struct Win32CompatHandle* compat_handle = (struct Win32CompatHandle*) thread_handle;
+    BOOL is_running = FALSE;
+
+    (void) pthread_once(&cancel_signal_once, uhashtools_win32_compat_install_cancel_signal);
+
+    /* The thread is only signaled while it's running, a returned thread may be gone already. */
+    (void) pthread_mutex_lock(&compat_handle->lock);
+
+    is_running = !compat_handle->state;
+
+    if (is_running)
+    {
+        (void) pthread_kill(compat_handle->thread, WIN32_COMPAT_CANCEL_SIGNAL);
+    }
+
+    (void) pthread_mutex_unlock(&compat_handle->lock);
+
+    if (!is_running)
+    {
+        last_error = ERROR_NOT_FOUND;
+    }
+
+    return is_running;
+}
+
+BOOL
+WaitNamedPipeW
+(
+    LPCWSTR named_pipe_name,
+    DWORD timeout
+)
+{
+    (void) named_pipe_name;
+    (void) timeout;
+
+    last_error = ERROR_NOT_SUPPORTED;
+
+    return FALSE;
+}
+
+BOOL
+AttachConsole
+(
+    DWORD process_id
+)
+{
+    (void) process_id;
+
+    return FALSE;
+}
+
+/*
+ * Emulates FSCTL_QUERY_ALLOCATED_RANGES with SEEK_DATA and SEEK_HOLE. The
+ * file offset is shared with the FILE of the caller, so it is restored.
+ */
+static
+BOOL
+uhashtools_win32_compat_query_allocated_ranges
+(
+    const struct Win32CompatHandle* compat_handle,
+    const FILE_ALLOCATED_RANGE_BUFFER* query_range,
+    FILE_ALLOCATED_RANGE_BUFFER* ranges,
+    DWORD ranges_size,
+    DWORD* returned_bytes
+)
+{
+    const off_t query_end = (off_t) (query_range->FileOffset.QuadPart + query_range->Length.QuadPart);
+    const DWORD max_ranges_count = ranges_size / sizeof *ranges;
+    const off_t saved_offset = lseek(compat_handle->fd, 0, SEEK_CUR);
+    DWORD ranges_count = 0;
+    off_t data_start = (off_t) query_range->FileOffset.QuadPart;
+    BOOL ret = TRUE;
+
+    *returned_bytes = 0;
+
+    if (saved_offset < 0)
+    {
+        last_error = ERROR_NOT_SUPPORTED;
+
+        return FALSE;
+    }
+
+    while (data_start < query_end)
+    {
+        off_t data_end = 0;
+
+        data_start = lseek(compat_handle->fd, data_start, SEEK_DATA);
+
+        /* ENXIO: No more data behind the offset */
+        if (data_start < 0 || data_start >= query_end)
+        {
+            break;
+        }
+
+        data_end = lseek(compat_handle->fd, data_start, SEEK_HOLE);
+
+        if (data_end < 0 || data_end > query_end)
+        {
+            data_end = query_end;
+        }
+
+        if (ranges_count == max_ranges_count)
+        {
+            last_error = ERROR_MORE_DATA;
+            ret = FALSE;
+            break;
+        }
+
+        ranges[ranges_count].FileOffset.QuadPart = (LONGLONG) data_start;
+        ranges[ranges_count].Length.QuadPart = (LONGLONG) (data_end - data_start);
+        ++ranges_count;
+
+        data_start = data_end;
+    }
+
+    (void) lseek(compat_handle->fd, saved_offset, SEEK_SET);
+
+    *returned_bytes = ranges_count * (DWORD) sizeof *ranges;
+
+    return ret;
+}
+
+BOOL
+DeviceIoControl
+(
+    HANDLE device_handle,
+    DWORD io_control_code,
+    LPVOID in_buf,
+    DWORD in_buf_size,
+    LPVOID out_buf,
+    DWORD out_buf_size,
+    DWORD* returned_bytes,
+    LPOVERLAPPED overlapped
+)
+{
+    const struct Win32CompatHandle* compat_handle = (const struct Win32CompatHandle*) device_handle;
+
+    (void) overlapped;
+
+    if (returned_bytes)
+    {
+        *returned_bytes = 0;
+    }
+
+    if (io_control_code == FSCTL_QUERY_ALLOCATED_RANGES &&
+        device_handle != INVALID_HANDLE_VALUE &&
+        compat_handle->kind == WIN32_COMPAT_HANDLE_KIND_FILE &&
+        in_buf_size >= sizeof(FILE_ALLOCATED_RANGE_BUFFER) &&
+        returned_bytes)
+    {
+        return uhashtools_win32_compat_query_allocated_ranges(compat_handle,
+                                                              (const FILE_ALLOCATED_RANGE_BUFFER*) in_buf,
+                                                              (FILE_ALLOCATED_RANGE_BUFFER*) out_buf,
+                                                              out_buf_size,
+                                                              returned_bytes);
+    }
+
+    last_error = ERROR_NOT_SUPPORTED;
+
+    return FALSE;
+}
+
+BOOL
+GetVolumePathNameW
+(
+    LPCWSTR filename,
+    LPWSTR volume_path_name,
+    DWORD volume_path_name_tsize
+)
+{
+    (void) filename;
+    (void) volume_path_name;
+    (void) volume_path_name_tsize;
+
+    last_error = ERROR_NOT_SUPPORTED;
+
+    return FALSE;
+}
+
+BOOL
+GetVolumeNameForVolumeMountPointW
+(
+    LPCWSTR volume_mount_point,
+    LPWSTR volume_name,
+    DWORD volume_name_tsize
+)
+{
+    (void) volume_mount_point;
+    (void) volume_name;
+    (void) volume_name_tsize;
+
+    last_error = ERROR_NOT_SUPPORTED;
+
+    return FALSE;
+}
+
+BOOL
+GetDiskFreeSpaceW
+(
+    LPCWSTR root_path_name,
+    DWORD* sectors_per_cluster,
+    DWORD* bytes_per_sector,
+    DWORD* free_clusters,
+    DWORD* total_clusters
+)
+{
+    (void) root_path_name;
+    (void) sectors_per_cluster;
+    (void) bytes_per_sector;
+    (void) free_clusters;
+    (void) total_clusters;
+
+    last_error = ERROR_NOT_SUPPORTED;
+
+    return FALSE;
+}
+
+DWORD
+GetLastError
+(
+    void
+)
+{
+    return last_error;
+}
+
+LPVOID
+VirtualAlloc
+(
+    LPVOID address,
+    SIZE_T size,
+    DWORD allocation_type,
+    DWORD protect
+)
+{
+    void* allocated_memory = NULL;
+
+    if (address || allocation_type != (MEM_COMMIT | MEM_RESERVE) || protect != PAGE_READWRITE)
+    {
+        return NULL;
+    }
+
+    if (posix_memalign(&allocated_memory, 4096, size) != 0)
+    {
+        return NULL;
+    }
+
+    (void) memset(allocated_memory, 0, size);
+
+    return allocated_memory;
+}
+
+BOOL
+VirtualFree
+(
+    LPVOID address,
+    SIZE_T size,
+    DWORD free_type
+)
+{
+    if (size != 0 || free_type != MEM_RELEASE)
+    {
+        return FALSE;
+    }
+
+    free(address);
+
+    return TRUE;
+}
+
+/* The mapping handle shares the file descriptor of the file handle. */
+HANDLE
+CreateFileMappingW
+(
+    HANDLE file_handle,
+    LPSECURITY_ATTRIBUTES security_attributes,
+    DWORD protect,
+    DWORD maximum_size_high,
+    DWORD maximum_size_low,
+    LPCWSTR name
+)
+{
+    const struct Win32CompatHandle* compat_file_handle = (const struct Win32CompatHandle*) file_handle;
+    struct Win32CompatHandle* compat_mapping_handle = NULL;
+
+    if (protect != PAGE_READONLY || maximum_size_high != 0 || maximum_size_low != 0 || name)
+    {
+        return NULL;
+    }
+
+    (void) security_attributes;
+
+    compat_mapping_handle = (struct Win32CompatHandle*) calloc(1, sizeof *compat_mapping_handle);
+
+    if (!compat_mapping_handle)
+    {
+        return NULL;
+    }
+
+    compat_mapping_handle->fd = dup(compat_file_handle->fd);
+
+    if (compat_mapping_handle->fd < 0)
+    {
+        free((void*) compat_mapping_handle);
+
+        return NULL;
+    }
+
+    return (HANDLE) compat_mapping_handle;
+}
+
+/*
+ * The file is mapped behind a page which keeps the size of the view for
+ * "UnmapViewOfFile()". The rest of the last page is zero, so an empty
+ * file has a view as well.
+ */
+LPVOID
+MapViewOfFile
+(
+    HANDLE file_mapping_handle,
+    DWORD desired_access,
+    DWORD file_offset_high,
+    DWORD file_offset_low,
+    size_t bytes_to_map
+)
+{
+    const size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+    LARGE_INTEGER file_size;
+    unsigned char* view_base = NULL;
+    size_t view_size = 0;
+
+    if (desired_access != FILE_MAP_READ || file_offset_high != 0 || file_offset_low != 0 || bytes_to_map != 0 ||
+        !GetFileSizeEx(file_mapping_handle, &file_size))
+    {
+        return NULL;
+    }
+
+    view_size = page_size + ((size_t) file_size.QuadPart / page_size + 1) * page_size;
+    view_base = (unsigned char*) mmap(NULL, view_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (view_base == (unsigned char*) MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    *(size_t*) view_base = view_size;
+
+    if (file_size.QuadPart > 0 &&
+        mmap(view_base + page_size,
+             (size_t) file_size.QuadPart,
+             PROT_READ,
+             MAP_PRIVATE | MAP_FIXED,
+             ((const struct Win32CompatHandle*) file_mapping_handle)->fd,
+             0) == MAP_FAILED)
+    {
+        (void) munmap((void*) view_base, view_size);
+
+        return NULL;
+    }
+
+    return (LPVOID) (view_base + page_size);
+}
+
+BOOL
+UnmapViewOfFile
+(
+    LPCVOID base_address
+)
+{
+    unsigned char* view_base = (unsigned char*) base_address - sysconf(_SC_PAGESIZE);
+
+    return munmap((void*) view_base, *(const size_t*) view_base) == 0;
+}
+
+BOOL
+InitOnceExecuteOnce
+(
+    PINIT_ONCE init_once,
+    PINIT_ONCE_FN init_fn,
+    PVOID parameter,
+    LPVOID* context
+)
+{
+    if (!init_once->is_done)
+    {
+        if (!init_fn(init_once, parameter, context))
+        {
+            return FALSE;
+        }
+
+        init_once->is_done = TRUE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Only UTF-8 is decoded. Every other code page is treated as ISO 8859-1,
+ * so each byte becomes the character with the same value.
+ */
+int
+MultiByteToWideChar
+(
+    UINT code_page,
+    DWORD flags,
+    LPCSTR multi_byte_str,
+    int multi_byte_len,
+    LPWSTR wide_char_str,
+    int wide_char_len
+)
+{
+    const unsigned char* bytes = (const unsigned char*) multi_byte_str;
+    int bytes_index = 0;
+    int converted_tsize = 0;
+
+    /* Like the original a negative length converts the terminator, too. */
+    if (multi_byte_len < 0)
+    {
+        multi_byte_len = (int) strlen(multi_byte_str) + 1;
+    }
+
+    while (bytes_index < multi_byte_len)
+    {
+        unsigned long code_point = bytes[bytes_index++];
+
+        if (code_page == CP_UTF8 && code_point >= 0x80)
+        {
+            int continuation_count = code_point >= 0xF0 ? 3 : code_point >= 0xE0 ? 2 : 1;
+            const unsigned long min_code_point = continuation_count == 3 ? 0x10000 : continuation_count == 2 ? 0x800 : 0x80;
+
+            if (code_point < 0xC2 || code_point > 0xF4)
+            {
+                code_point = 0xFFFD;
+                continuation_count = 0;
+            }
+            else
+            {
+                code_point &= 0x3F >> continuation_count;
+            }
+
+            while (continuation_count > 0)
+            {
+                if (bytes_index >= multi_byte_len || (bytes[bytes_index] & 0xC0) != 0x80)
+                {
+                    code_point = 0xFFFD;
+                    break;
+                }
+
+                code_point = (code_point << 6) | (bytes[bytes_index++] & 0x3F);
+                --continuation_count;
+            }
+
+            if (code_point != 0xFFFD && (code_point < min_code_point || code_point > 0x10FFFF ||
+                                         (code_point >= 0xD800 && code_point <= 0xDFFF)))
+            {
+                code_point = 0xFFFD;
+            }
+
+            if (code_point == 0xFFFD && (flags & MB_ERR_INVALID_CHARS))
+            {
+                return 0;
+            }
+        }
+
+        if (converted_tsize >= wide_char_len)
+        {
+            return 0;
+        }
+
+        wide_char_str[converted_tsize++] = (wchar_t) code_point;
+    }
+
+    return converted_tsize;
+}
+
+/* Only UTF-8 is encoded. The default character arguments aren't supported. */
+int
+WideCharToMultiByte
+(
+    UINT code_page,
+    DWORD flags,
+    LPCWSTR wide_char_str,
+    int wide_char_len,
+    LPSTR multi_byte_str,
+    int multi_byte_len,
+    LPCSTR default_char,
+    LPBOOL used_default_char
+)
+{
+    int chars_index = 0;
+    int converted_size = 0;
+
+    (void) flags;
+    (void) default_char;
+    (void) used_default_char;
+
+    if (code_page != CP_UTF8)
+    {
+        return 0;
+    }
+
+    if (wide_char_len < 0)
+    {
+        wide_char_len = (int) wcslen(wide_char_str) + 1;
+    }
+
+    while (chars_index < wide_char_len)
+    {
+        const unsigned long code_point = (unsigned long) wide_char_str[chars_index++];
+        const int continuation_count = code_point >= 0x10000 ? 3 : code_point >= 0x800 ? 2 : code_point >= 0x80 ? 1 : 0;
+        int i = 0;
+
+        if (code_point > 0x10FFFF || converted_size + continuation_count >= multi_byte_len)
+        {
+            return 0;
+        }
+
+        /* The lead byte starts with one set bit per byte of the sequence. */
+        multi_byte_str[converted_size++] = (char) (continuation_count == 0 ? code_point
+                                                                            : ((0xFF00 >> (continuation_count + 1)) & 0xFF) | (code_point >> (6 * continuation_count)));
+
+        for (i = continuation_count - 1; i >= 0; --i)
+        {
+            multi_byte_str[converted_size++] = (char) (0x80 | ((code_point >> (6 * i)) & 0x3F));
+        }
+    }
+
+    return converted_size;
+}
+
+BOOL
+QueryPerformanceCounter
+(
+    LARGE_INTEGER* performance_count
+)
+{
+    struct timespec now;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+    {
+        return FALSE;
+    }
+
+    performance_count->QuadPart = (LONGLONG) now.tv_sec * 1000000000 + now.tv_nsec;
+
+    return TRUE;
+}
+
+BOOL
+QueryPerformanceFrequency
+(
+    LARGE_INTEGER* frequency
+)
+{
+    frequency->QuadPart = 1000000000;
+
+    return TRUE;
+}
+
+DWORD
+GetTickCount
+(
+    void
+)
+{
+    struct timespec now;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (DWORD) ((unsigned __int64) now.tv_sec * 1000 + (unsigned __int64) now.tv_nsec / 1000000);
+}
+
+void
+Sleep
+(
+    DWORD milliseconds
+)
+{
+    struct timespec remaining_time;
+
+    remaining_time.tv_sec = (time_t) (milliseconds / 1000);
+    remaining_time.tv_nsec = (long) (milliseconds % 1000) * 1000000;
+
+    while (nanosleep(&remaining_time, &remaining_time) != 0 && errno == EINTR)
+    {
+    }
+}
+
+void
+InitializeCriticalSection
+(
+    CRITICAL_SECTION* critical_section
+)
+{
+    pthread_mutexattr_t mutex_attributes;
+
+    (void) pthread_mutexattr_init(&mutex_attributes);
+    (void) pthread_mutexattr_settype(&mutex_attributes, PTHREAD_MUTEX_RECURSIVE);
+    (void) pthread_mutex_init(&critical_section->mutex, &mutex_attributes);
+    (void) pthread_mutexattr_destroy(&mutex_attributes);
+}
+
+void
+EnterCriticalSection
+(
+    CRITICAL_SECTION* critical_section
+)
+{
+    (void) pthread_mutex_lock(&critical_section->mutex);
+}
+
+void
+LeaveCriticalSection
+(
+    CRITICAL_SECTION* critical_section
+)
+{
+    (void) pthread_mutex_unlock(&critical_section->mutex);
+}
+
+void
+DeleteCriticalSection
+(
+    CRITICAL_SECTION* critical_section
+)
+{
+    (void) pthread_mutex_destroy(&critical_section->mutex);
+}
+
+void
+InitializeConditionVariable
+(
+    CONDITION_VARIABLE* condition_variable
+)
+{
+    (void) pthread_cond_init(&condition_variable->cond, NULL);
+}
+
+BOOL
+SleepConditionVariableCS
+(
+    CONDITION_VARIABLE* condition_variable,
+    CRITICAL_SECTION* critical_section,
+    DWORD milliseconds
+)
+{
+    if (milliseconds != INFINITE)
+    {
+        last_error = ERROR_NOT_SUPPORTED;
+
+        return FALSE;
+    }
+
+    return pthread_cond_wait(&condition_variable->cond, &critical_section->mutex) == 0;
+}
+
+void
+WakeConditionVariable
+(
+    CONDITION_VARIABLE* condition_variable
+)
+{
+    (void) pthread_cond_signal(&condition_variable->cond);
+}
+
+void
+WakeAllConditionVariable
+(
+    CONDITION_VARIABLE* condition_variable
+)
+{
+    (void) pthread_cond_broadcast(&condition_variable->cond);
+}
+
+HANDLE
+CreateSemaphoreW
+(
+    LPSECURITY_ATTRIBUTES security_attributes,
+    LONG initial_count,
+    LONG maximum_count,
+    LPCWSTR name
+)
+{
+    struct Win32CompatHandle* compat_handle = NULL;
+
+    if (initial_count < 0 || maximum_count <= 0 || initial_count > maximum_count || name)
+    {
+        return NULL;
+    }
+
+    (void) security_attributes;
+
+    compat_handle = uhashtools_win32_compat_create_waitable_handle(WIN32_COMPAT_HANDLE_KIND_SEMAPHORE);
+
+    if (!compat_handle)
+    {
+        return NULL;
+    }
+
+    compat_handle->state = initial_count;
+    compat_handle->max_state = maximum_count;
+
+    return (HANDLE) compat_handle;
+}
+
+BOOL
+ReleaseSemaphore
+(
+    HANDLE semaphore_handle,
+    LONG release_count,
+    LONG* previous_count
+)
+{
+    struct Win32CompatHandle* compat_handle = (struct Win32CompatHandle*) semaphore_handle;
+    BOOL ret = FALSE;
+
+    (void) pthread_mutex_lock(&compat_handle->lock);
+
+    if (release_count > 0 && release_count <= compat_handle->max_state - compat_handle->state)
+    {
+        if (previous_count)
+        {
+            *previous_count = compat_handle->state;
+        }
+
+        compat_handle->state += release_count;
+        (void) pthread_cond_broadcast(&compat_handle->state_changed);
+
+        ret = TRUE;
+    }
+
+    (void) pthread_mutex_unlock(&compat_handle->lock);
+
+    return ret;
+}
+
+HANDLE
+CreateEventW
+(
+    LPSECURITY_ATTRIBUTES security_attributes,
+    BOOL manual_reset,
+    BOOL initial_state,
+    LPCWSTR name
+)
+{
+    struct Win32CompatHandle* compat_handle = NULL;
+
+    if (name)
+    {
+        return NULL;
+    }
+
+    (void) security_attributes;
+
+    compat_handle = uhashtools_win32_compat_create_waitable_handle(WIN32_COMPAT_HANDLE_KIND_EVENT);
+
+    if (!compat_handle)
+    {
+        return NULL;
+    }
+
+    compat_handle->state = initial_state ? TRUE : FALSE;
+    compat_handle->is_manual_reset = manual_reset;
+
+    return (HANDLE) compat_handle;
+}
+
+DWORD
+WaitForSingleObject
+(
+    HANDLE handle,
+    DWORD milliseconds
+)
+{
+    struct Win32CompatHandle* compat_handle = (struct Win32CompatHandle*) handle;
+    struct timespec deadline;
+
+    if (compat_handle->kind == WIN32_COMPAT_HANDLE_KIND_FILE || compat_handle->kind == WIN32_COMPAT_HANDLE_KIND_PIPE)
+    {
+        return WAIT_FAILED;
+    }
+
+    /* The condition variables wait with the realtime clock. */
+    if (milliseconds != INFINITE)
+    {
+        (void) clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += (time_t) (milliseconds / 1000);
+        deadline.tv_nsec += (long) (milliseconds % 1000) * 1000000;
+
+        if (deadline.tv_nsec >= 1000000000)
+        {
+            ++deadline.tv_sec;
+            deadline.tv_nsec -= 1000000000;
+        }
+    }
+
+    (void) pthread_mutex_lock(&compat_handle->lock);
+
+    while (compat_handle->state == 0)
+    {
+        if (milliseconds == INFINITE)
+        {
+            (void) pthread_cond_wait(&compat_handle->state_changed, &compat_handle->lock);
+        }
+        else if (pthread_cond_timedwait(&compat_handle->state_changed, &compat_handle->lock, &deadline) == ETIMEDOUT)
+        {
+            break;
+        }
+    }
+
+    if (compat_handle->state == 0)
+    {
+        (void) pthread_mutex_unlock(&compat_handle->lock);
+
+        return WAIT_TIMEOUT;
+    }
+
+    /* A returned thread and a manual reset event stay signaled. */
+    if (compat_handle->kind == WIN32_COMPAT_HANDLE_KIND_SEMAPHORE ||
+        (compat_handle->kind == WIN32_COMPAT_HANDLE_KIND_EVENT && !compat_handle->is_manual_reset))
+    {
+        --compat_handle->state;
+    }
+
+    (void) pthread_mutex_unlock(&compat_handle->lock);
+
+    return WAIT_OBJECT_0;
+}
+
+BOOL
+SetEvent
+(
+    HANDLE event_handle
+)
+{
+    struct Win32CompatHandle* compat_handle = (struct Win32CompatHandle*) event_handle;
+
+    (void) pthread_mutex_lock(&compat_handle->lock);
+    compat_handle->state = TRUE;
+    (void) pthread_cond_broadcast(&compat_handle->state_changed);
+    (void) pthread_mutex_unlock(&compat_handle->lock);
+
+    return TRUE;
+}
+
+void
+GetSystemInfo
+(
+    LPSYSTEM_INFO system_info
+)
+{
+    const long processors_count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    (void) memset((void*) system_info, 0, sizeof *system_info);
+    system_info->dwPageSize = (DWORD) sysconf(_SC_PAGESIZE);
+    system_info->dwNumberOfProcessors = processors_count > 0 ? (DWORD) processors_count : 1;
+    system_info->dwAllocationGranularity = 64 * 1024;
+}
+
+HANDLE
+GetCurrentThread
+(
+    void
+)
+{
+    return WIN32_COMPAT_CURRENT_THREAD_HANDLE;
+}
+
+DWORD
+GetCurrentThreadId
+(
+    void
+)
+{
+    if (current_thread_id == 0)
+    {
+        current_thread_id = __sync_add_and_fetch(&last_thread_id, 1);
+    }
+
+    return (DWORD) current_thread_id;
+}
+
+/* Returns NULL if the thread has no message queue and "is_creating" is FALSE. */
+static
+struct Win32CompatMessageQueue*
+uhashtools_win32_compat_get_message_queue
+(
+    DWORD thread_id,
+    BOOL is_creating
+)
+{
+    struct Win32CompatMessageQueue* queue = NULL;
+
+    (void) pthread_mutex_lock(&message_queues_lock);
+
+    for (queue = message_queues; queue && queue->thread_id != thread_id; queue = queue->next)
+    {
+    }
+
+    if (!queue && is_creating)
+    {
+        queue = (struct Win32CompatMessageQueue*) calloc(1, sizeof *queue);
+
+        if (queue)
+        {
+            queue->thread_id = thread_id;
+            (void) pthread_mutex_init(&queue->lock, NULL);
+            (void) pthread_cond_init(&queue->message_posted, NULL);
+            queue->next = message_queues;
+            message_queues = queue;
+        }
+    }
+
+    (void) pthread_mutex_unlock(&message_queues_lock);
+
+    return queue;
+}
+
+/* Returns the index of the first message within the filter or "messages_count". */
+static
+size_t
+uhashtools_win32_compat_find_message
+(
+    const struct Win32CompatMessageQueue* queue,
+    UINT filter_min,
+    UINT filter_max
+)
+{
+    size_t message_index = 0;
+
+    for (message_index = 0; message_index < queue->messages_count; ++message_index)
+    {
+        const UINT message = queue->messages[message_index].message;
+
+        /* Like on Windows a quit message is received regardless of the filter. */
+        if ((filter_min == 0 && filter_max == 0) || (message >= filter_min && message <= filter_max) || message == WM_QUIT)
+        {
+            break;
+        }
+    }
+
+    return message_index;
+}
+
+static
+void
+uhashtools_win32_compat_take_message
+(
+    struct Win32CompatMessageQueue* queue,
+    size_t message_index,
+    LPMSG msg,
+    BOOL is_removing
+)
+{
+    *msg = queue->messages[message_index];
+
+    if (is_removing)
+    {
+        --queue->messages_count;
+        (void) memmove((void*) (queue->messages + message_index),
+                       (const void*) (queue->messages + message_index + 1),
+                       (queue->messages_count - message_index) * sizeof *queue->messages);
+    }
+}
+
+BOOL
+PostThreadMessageW
+(
+    DWORD thread_id,
+    UINT message,
+    WPARAM w_param,
+    LPARAM l_param
+)
+{
+    struct Win32CompatMessageQueue* queue = uhashtools_win32_compat_get_message_queue(thread_id, FALSE);
+    BOOL ret = FALSE;
+
+    if (!queue)
+    {
+        last_error = ERROR_INVALID_THREAD_ID;
+
+        return FALSE;
+    }
+
+    (void) pthread_mutex_lock(&queue->lock);
+
+    if (queue->messages_count == queue->messages_capacity)
+    {
+        const size_t new_capacity = queue->messages_capacity > 0 ? queue->messages_capacity * 2 : 16;
+        MSG* new_messages = (MSG*) realloc((void*) queue->messages, new_capacity * sizeof *new_messages);
+
+        if (new_messages)
+        {
+            queue->messages = new_messages;
+            queue->messages_capacity = new_capacity;
+        }
+    }
+
+    if (queue->messages_count < queue->messages_capacity)
+    {
+        MSG* msg = &queue->messages[queue->messages_count++];
+
+        (void) memset((void*) msg, 0, sizeof *msg);
+        msg->message = message;
+        msg->wParam = w_param;
+        msg->lParam = l_param;
+        (void) pthread_cond_broadcast(&queue->message_posted);
+        ret = TRUE;
+    }
+    else
+    {
+        last_error = ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    (void) pthread_mutex_unlock(&queue->lock);
+
+    return ret;
+}
+
+BOOL
+PostMessageW
+(
+    HWND window,
+    UINT message,
+    WPARAM w_param,
+    LPARAM l_param
+)
+{
+    return PostThreadMessageW((DWORD) (size_t) window, message, w_param, l_param);
+}
+
+BOOL
+PeekMessageW
+(
+    LPMSG msg,
+    HWND window,
+    UINT filter_min,
+    UINT filter_max,
+    UINT remove_flags
+)
+{
+    struct Win32CompatMessageQueue* queue = uhashtools_win32_compat_get_message_queue(GetCurrentThreadId(), TRUE);
+    size_t message_index = 0;
+    BOOL is_found = FALSE;
+
+    (void) window;
+
+    if (!queue)
+    {
+        return FALSE;
+    }
+
+    (void) pthread_mutex_lock(&queue->lock);
+
+    message_index = uhashtools_win32_compat_find_message(queue, filter_min, filter_max);
+    is_found = message_index < queue->messages_count;
+
+    if (is_found)
+    {
+        uhashtools_win32_compat_take_message(queue, message_index, msg, (remove_flags & PM_REMOVE) != 0);
+    }
+
+    (void) pthread_mutex_unlock(&queue->lock);
+
+    return is_found;
+}
+
+BOOL
+GetMessageW
+(
+    LPMSG msg,
+    HWND window,
+    UINT filter_min,
+    UINT filter_max
+)
+{
+    struct Win32CompatMessageQueue* queue = uhashtools_win32_compat_get_message_queue(GetCurrentThreadId(), TRUE);
+    size_t message_index = 0;
+
+    (void) window;
+
+    if (!queue)
+    {
+        return -1;
+    }
+
+    (void) pthread_mutex_lock(&queue->lock);
+
+    while ((message_index = uhashtools_win32_compat_find_message(queue, filter_min, filter_max)) == queue->messages_count)
+    {
+        (void) pthread_cond_wait(&queue->message_posted, &queue->lock);
+    }
+
+    uhashtools_win32_compat_take_message(queue, message_index, msg, TRUE);
+
+    (void) pthread_mutex_unlock(&queue->lock);
+
+    return msg->message != WM_QUIT;
+}
+
+BOOL
+SetThreadPriority
+(
+    HANDLE thread_handle,
+    int priority
+)
+{
+    if (thread_handle != WIN32_COMPAT_CURRENT_THREAD_HANDLE)
+    {
+        return FALSE;
+    }
+
+    if (priority == THREAD_MODE_BACKGROUND_BEGIN || priority == THREAD_MODE_BACKGROUND_END)
+    {
+        const BOOL is_background_mode_requested = priority == THREAD_MODE_BACKGROUND_BEGIN;
+
+        if (is_current_thread_in_background_mode == is_background_mode_requested)
+        {
+            return FALSE;
+        }
+
+        is_current_thread_in_background_mode = is_background_mode_requested;
+    }
+
+    return TRUE;
+}
+
+uintptr_t
+_beginthreadex
+(
+    void* security,
+    unsigned int stack_size,
+    unsigned int (__stdcall* start_address)(void*),
+    void* arglist,
+    unsigned int init_flag,
+    unsigned int* thread_id
+)
+{
+    struct Win32CompatHandle* compat_handle = NULL;
+    pthread_t thread;
+
+    (void) security;
+    (void) stack_size;
+
+    compat_handle = uhashtools_win32_compat_create_waitable_handle(WIN32_COMPAT_HANDLE_KIND_THREAD);
+
+    if (!compat_handle)
+    {
+        return 0;
+    }
+
+    compat_handle->references_count = 2;
+    compat_handle->is_suspended = (init_flag & CREATE_SUSPENDED) != 0;
+    compat_handle->thread_function = start_address;
+    compat_handle->thread_param = arglist;
+    compat_handle->thread_id = __sync_add_and_fetch(&last_thread_id, 1);
+
+    (void) pthread_mutex_lock(&compat_handle->lock);
+
+    if (pthread_create(&thread, NULL, uhashtools_win32_compat_thread_main, (void*) compat_handle) != 0)
+    {
+        (void) pthread_mutex_unlock(&compat_handle->lock);
+        (void) pthread_cond_destroy(&compat_handle->state_changed);
+        (void) pthread_mutex_destroy(&compat_handle->lock);
+        free((void*) compat_handle);
+
+        return 0;
+    }
+
+    /* The thread waits for the lock before it runs, so "CancelSynchronousIo()" always finds its id. */
+    compat_handle->thread = thread;
+    (void) pthread_mutex_unlock(&compat_handle->lock);
+
+    (void) pthread_detach(thread);
+
+    if (thread_id)
+    {
+        *thread_id = compat_handle->thread_id;
+    }
+
+    return (uintptr_t) compat_handle;
+}
+
+DWORD
+ResumeThread
+(
+    HANDLE thread_handle
+)
+{
+    struct Win32CompatHandle* compat_handle = (struct Win32CompatHandle*) thread_handle;
+    DWORD previous_suspend_count = 0;
+
+    (void) pthread_mutex_lock(&compat_handle->lock);
+
+    previous_suspend_count = compat_handle->is_suspended ? 1 : 0;
+    compat_handle->is_suspended = FALSE;
+    (void) pthread_cond_broadcast(&compat_handle->state_changed);
+
+    (void) pthread_mutex_unlock(&compat_handle->lock);
+
+    return previous_suspend_count;
+}
+
+errno_t
+wcscpy_s
+(
+    wchar_t* dest,
+    size_t dest_tsize,
+    const wchar_t* src
+)
+{
+    if (!dest || dest_tsize == 0)
+    {
+        return EINVAL;
+    }
+
+    if (wcslen(src) >= dest_tsize)
+    {
+        dest[0] = L'\0';
+
+        return ERANGE;
+    }
+
+    (void) wcscpy(dest, src);
+
+    return 0;
+}
+
+errno_t
+wcsncpy_s
+(
+    wchar_t* dest,
+    size_t dest_tsize,
+    const wchar_t* src,
+    size_t count
+)
+{
+    size_t copy_tsize = 0;
+
+    if (!dest || dest_tsize == 0)
+    {
+        return EINVAL;
+    }
+
+    while (copy_tsize < count && src[copy_tsize] != L'\0')
+    {
+        if (copy_tsize + 1 >= dest_tsize)
+        {
+            if (count == _TRUNCATE)
+            {
+                break;
+            }
+
+            dest[0] = L'\0';
+
+            return ERANGE;
+        }
+
+        dest[copy_tsize] = src[copy_tsize];
+        ++copy_tsize;
+    }
+
+    dest[copy_tsize] = L'\0';
+
+    return 0;
+}
+
+errno_t
+wcscat_s
+(
+    wchar_t* dest,
+    size_t dest_tsize,
+    const wchar_t* src
+)
+{
+    size_t dest_tlen = 0;
+
+    if (!dest || dest_tsize == 0)
+    {
+        return EINVAL;
+    }
+
+    dest_tlen = wcslen(dest);
+
+    if (dest_tlen + wcslen(src) >= dest_tsize)
+    {
+        dest[0] = L'\0';
+
+        return ERANGE;
+    }
+
+    (void) wcscpy(dest + dest_tlen, src);
+
+    return 0;
+}
+
+int
+_vsnwprintf_s
+(
+    wchar_t* buf,
+    size_t buf_tsize,
+    size_t count,
+    const wchar_t* format,
+    va_list format_args
+)
+{
+    wchar_t translated_format[WIN32_COMPAT_FORMAT_TSIZE];
+    wchar_t* formatted_txt = NULL;
+    size_t formatted_txt_tsize = 256;
+    int formatted_tsize = -1;
+    va_list args;
+
+    uhashtools_win32_compat_translate_format(format, TRUE, translated_format, WIN32_COMPAT_FORMAT_TSIZE);
+
+    /* "vswprintf()" doesn't report the required size, so the buffer is grown until the text fits. */
+    for (;;)
+    {
+        formatted_txt = (wchar_t*) malloc(formatted_txt_tsize * sizeof *formatted_txt);
+
+        if (!formatted_txt)
+        {
+            return -1;
+        }
+
+        va_copy(args, format_args);
+        formatted_tsize = vswprintf(formatted_txt, formatted_txt_tsize, translated_format, args);
+        va_end(args);
+
+        if (formatted_tsize >= 0 || formatted_txt_tsize >= 1024 * 1024)
+        {
+            break;
+        }
+
+        free((void*) formatted_txt);
+        formatted_txt_tsize *= 2;
+    }
+
+    if (formatted_tsize < 0)
+    {
+        free((void*) formatted_txt);
+        buf[0] = L'\0';
+
+        return -1;
+    }
+
+    if (count != _TRUNCATE && (size_t) formatted_tsize > count)
+    {
+        formatted_txt[count] = L'\0';
+        formatted_tsize = (int) count;
+    }
+
+    if ((size_t) formatted_tsize >= buf_tsize)
+    {
+        (void) wcsncpy_s(buf, buf_tsize, formatted_txt, _TRUNCATE);
+        formatted_tsize = -1;
+    }
+    else
+    {
+        (void) wcscpy(buf, formatted_txt);
+    }
+
+    free((void*) formatted_txt);
+
+    return formatted_tsize;
+}
+
+int
+_snwprintf_s
+(
+    wchar_t* buf,
+    size_t buf_tsize,
+    size_t count,
+    const wchar_t* format,
+    ...
+)
+{
+    int formatted_tsize = -1;
+    va_list args;
+
+    va_start(args, format);
+    formatted_tsize = _vsnwprintf_s(buf, buf_tsize, count, format, args);
+    va_end(args);
+
+    return formatted_tsize;
+}
+
+int
+fwprintf_s
+(
+    FILE* handle,
+    const wchar_t* format,
+    ...
+)
+{
+    wchar_t translated_format[WIN32_COMPAT_FORMAT_TSIZE];
+    int print_rc = 0;
+    va_list args;
+
+    uhashtools_win32_compat_translate_format(format, TRUE, translated_format, WIN32_COMPAT_FORMAT_TSIZE);
+
+    va_start(args, format);
+    print_rc = vfwprintf(handle, translated_format, args);
+    va_end(args);
+
+    return print_rc;
+}
+
+int
+wprintf_s
+(
+    const wchar_t* format,
+    ...
+)
+{
+    wchar_t translated_format[WIN32_COMPAT_FORMAT_TSIZE];
+    int print_rc = 0;
+    va_list args;
+
+    uhashtools_win32_compat_translate_format(format, TRUE, translated_format, WIN32_COMPAT_FORMAT_TSIZE);
+
+    va_start(args, format);
+    print_rc = vwprintf(translated_format, args);
+    va_end(args);
+
+    return print_rc;
+}
+
+/*
+ * The buffer size arguments which follow the arguments of "%c", "%s" and
+ * "%[" are only supported at the end of the argument list, where they
+ * are ignored by "vsscanf()".
+ */
+int
+sscanf_s
+(
+    const char* buf,
+    const char* format,
+    ...
+)
+{
+    char translated_format[WIN32_COMPAT_FORMAT_TSIZE];
+    int scan_rc = 0;
+    va_list args;
+
+    uhashtools_win32_compat_translate_narrow_format(format, translated_format, WIN32_COMPAT_FORMAT_TSIZE);
+
+    va_start(args, format);
+    scan_rc = vsscanf(buf, translated_format, args);
+    va_end(args);
+
+    return scan_rc;
+}
+
+int
+sprintf_s
+(
+    char* buf,
+    size_t buf_size,
+    const char* format,
+    ...
+)
+{
+    char translated_format[WIN32_COMPAT_FORMAT_TSIZE];
+    int print_rc = 0;
+    va_list args;
+
+    uhashtools_win32_compat_translate_narrow_format(format, translated_format, WIN32_COMPAT_FORMAT_TSIZE);
+
+    va_start(args, format);
+    print_rc = vsnprintf(buf, buf_size, translated_format, args);
+    va_end(args);
+
+    /* The original fails instead of truncating. */
+    if (print_rc < 0 || (size_t) print_rc >= buf_size)
+    {
+        buf[0] = '\0';
+
+        return -1;
+    }
+
+    return print_rc;
+}
+
+int
+uhashtools_win32_compat_fprintf
+(
+    FILE* handle,
+    const char* format,
+    ...
+)
+{
+    char translated_format[WIN32_COMPAT_FORMAT_TSIZE];
+    int print_rc = 0;
+    va_list args;
+
+    uhashtools_win32_compat_translate_narrow_format(format, translated_format, WIN32_COMPAT_FORMAT_TSIZE);
+
+    va_start(args, format);
+    print_rc = vfprintf(handle, translated_format, args);
+    va_end(args);
+
+    return print_rc;
+}
+
+errno_t
+_wfopen_s
+(
+    FILE** handle,
+    const wchar_t* filename,
+    const wchar_t* mode
+)
+{
+    char path[WIN32_COMPAT_PATH_SIZE];
+    char narrow_mode[8];
+
+    *handle = NULL;
+
+    if (!uhashtools_win32_compat_narrow_path(filename, path) ||
+        wcstombs(narrow_mode, mode, sizeof narrow_mode) >= sizeof narrow_mode)
+    {
+        return EINVAL;
+    }
+
+    *handle = fopen(path, narrow_mode);
+
+    return *handle ? 0 : errno;
+}
+
+errno_t
+freopen_s
+(
+    FILE** handle,
+    const char* filename,
+    const char* mode,
+    FILE* stream
+)
+{
+    *handle = freopen(filename, mode, stream);
+
+    return *handle ? 0 : errno;
+}
+
+errno_t
+clearerr_s
+(
+    FILE* handle
+)
+{
+    clearerr(handle);
+
+    return 0;
+}
+
+size_t
+fread_s
+(
+    void* buf,
+    size_t buf_size,
+    size_t element_size,
+    size_t count,
+    FILE* handle
+)
+{
+    if (element_size != 0 && count > buf_size / element_size)
+    {
+        errno = ERANGE;
+
+        return 0;
+    }
+
+    return fread(buf, element_size, count, handle);
+}
+
+int
+_fseeki64
+(
+    FILE* handle,
+    __int64 offset,
+    int origin
+)
+{
+    return fseeko(handle, (off_t) offset, origin);
+}
+
+__int64
+_ftelli64
+(
+    FILE* handle
+)
+{
+    return (__int64) ftello(handle);
+}
+
+__int64
+_filelengthi64
+(
+    int fd
+)
+{
+    struct stat file_stat;
+
+    if (fstat(fd, &file_stat) != 0)
+    {
+        return -1;
+    }
+
+    return (__int64) file_stat.st_size;
+}
+
+int
+_setmode
+(
+    int fd,
+    int mode
+)
+{
+    (void) fd;
+    (void) mode;
+
+    /* The previous mode would be _O_TEXT. */
+    return 0x4000;
+}
+
+intptr_t
+_get_osfhandle
+(
+    int fd
+)
+{
+    if (fd < 0 || fd >= WIN32_COMPAT_FD_HANDLES_COUNT)
+    {
+        return (intptr_t) INVALID_HANDLE_VALUE;
+    }
+
+    fd_handles[fd].kind = WIN32_COMPAT_HANDLE_KIND_FILE;
+    fd_handles[fd].fd = fd;
+
+    return (intptr_t) &fd_handles[fd];
+}
+
+NTSTATUS
+BCryptOpenAlgorithmProvider
+(
+    BCRYPT_ALG_HANDLE* algorithm_handle,
+    LPCWSTR algorithm_id,
+    LPCWSTR implementation,
+    ULONG flags
+)
+{
+    (void) algorithm_id;
+    (void) implementation;
+    (void) flags;
+
+    *algorithm_handle = NULL;
+
+    return WIN32_COMPAT_STATUS_NOT_FOUND;
+}
+
+NTSTATUS
+BCryptCloseAlgorithmProvider
+(
+    BCRYPT_ALG_HANDLE algorithm_handle,
+    ULONG flags
+)
+{
+    (void) algorithm_handle;
+    (void) flags;
+
+    return WIN32_COMPAT_STATUS_INVALID_HANDLE;
+}
+
+NTSTATUS
+BCryptGetProperty
+(
+    BCRYPT_HANDLE object_handle,
+    LPCWSTR property_name,
+    PUCHAR output,
+    ULONG output_size,
+    ULONG* result_size,
+    ULONG flags
+)
+{
+    (void) object_handle;
+    (void) property_name;
+    (void) output;
+    (void) output_size;
+    (void) result_size;
+    (void) flags;
+
+    return WIN32_COMPAT_STATUS_INVALID_HANDLE;
+}
+
+NTSTATUS
+BCryptCreateHash
+(
+    BCRYPT_ALG_HANDLE algorithm_handle,
+    BCRYPT_HASH_HANDLE* hash_handle,
+    PUCHAR hash_object,
+    ULONG hash_object_size,
+    PUCHAR secret,
+    ULONG secret_size,
+    ULONG flags
+)
+{
+    (void) algorithm_handle;
+    (void) hash_object;
+    (void) hash_object_size;
+    (void) secret;
+    (void) secret_size;
+    (void) flags;
+
+    *hash_handle = NULL;
+
+    return WIN32_COMPAT_STATUS_INVALID_HANDLE;
+}
+
+NTSTATUS
+BCryptHashData
+(
+    BCRYPT_HASH_HANDLE hash_handle,
+    PUCHAR input,
+    ULONG input_size,
+    ULONG flags
+)
+{
+    (void) hash_handle;
+    (void) input;
+    (void) input_size;
+    (void) flags;
+
+    return WIN32_COMPAT_STATUS_INVALID_HANDLE;
+}
+
+NTSTATUS
+BCryptFinishHash
+(
+    BCRYPT_HASH_HANDLE hash_handle,
+    PUCHAR output,
+    ULONG output_size,
+    ULONG flags
+)
+{
+    (void) hash_handle;
+    (void) output;
+    (void) output_size;
+    (void) flags;
+
+    return WIN32_COMPAT_STATUS_INVALID_HANDLE;
+}
+
+NTSTATUS
+BCryptDestroyHash
+(
+    BCRYPT_HASH_HANDLE hash_handle
+)
+{
+    (void) hash_handle;
+
+    return WIN32_COMPAT_STATUS_INVALID_HANDLE;
+}
@@ -0,0 +1,94 @@
+/*
+ * This file is part of µHashtools.
+ * µHashtools is a small graphical file hashing tool for Microsoft Windows.
+ * 
+ * SPDX-FileCopyrightText: 2025 Marcel Gosmann <thafiredragonofdeath@gmail.com>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/*
+ * Minimal replacement of the Windows SDK header "winioctl.h" (see
+ * "Windows.h"). The structures only have the members which are used by
+ * the tested units. "DeviceIoControl()" of the replacement only supports
+ * FSCTL_QUERY_ALLOCATED_RANGES, for the device queries the units fall back
+ * to the behavior for unknown devices.
+ */
+
+#include <Windows.h>
+
+#define FILE_DEVICE_CD_ROM 0x00000002
+#define FILE_DEVICE_DVD 0x00000033
+
+#define IOCTL_STORAGE_GET_DEVICE_NUMBER 0x002D1080
+#define IOCTL_STORAGE_QUERY_PROPERTY 0x002D1400
+#define IOCTL_VOLUME_GET_VOLUME_DISK_EXTENTS 0x00560000
+#define FSCTL_GET_RETRIEVAL_POINTERS 0x00090073
+#define FSCTL_QUERY_ALLOCATED_RANGES 0x000940CF
+
+typedef struct _STORAGE_DEVICE_NUMBER
+{
+    DWORD DeviceType;
+    DWORD DeviceNumber;
+    DWORD PartitionNumber;
+} STORAGE_DEVICE_NUMBER;
+
+typedef enum _STORAGE_PROPERTY_ID
+{
+    StorageDeviceSeekPenaltyProperty = 7
+} STORAGE_PROPERTY_ID;
+
+typedef enum _STORAGE_QUERY_TYPE
+{
+    PropertyStandardQuery = 0
+} STORAGE_QUERY_TYPE;
+
+typedef struct _STORAGE_PROPERTY_QUERY
+{
+    STORAGE_PROPERTY_ID PropertyId;
+    STORAGE_QUERY_TYPE QueryType;
+    BYTE AdditionalParameters[1];
+} STORAGE_PROPERTY_QUERY;
+
+typedef struct _DEVICE_SEEK_PENALTY_DESCRIPTOR
+{
+    DWORD Version;
+    DWORD Size;
+    BOOLEAN IncursSeekPenalty;
+} DEVICE_SEEK_PENALTY_DESCRIPTOR;
+
+typedef struct _DISK_EXTENT
+{
+    DWORD DiskNumber;
+    LARGE_INTEGER StartingOffset;
+    LARGE_INTEGER ExtentLength;
+} DISK_EXTENT;
+
+typedef struct _VOLUME_DISK_EXTENTS
+{
+    DWORD NumberOfDiskExtents;
+    DISK_EXTENT Extents[1];
+} VOLUME_DISK_EXTENTS;
+
+typedef struct _STARTING_VCN_INPUT_BUFFER
+{
+    LARGE_INTEGER StartingVcn;
+} STARTING_VCN_INPUT_BUFFER;
+
+typedef struct _RETRIEVAL_POINTERS_BUFFER
+{
+    DWORD ExtentCount;
+    LARGE_INTEGER StartingVcn;
+    struct
+    {
+        LARGE_INTEGER NextVcn;
+        LARGE_INTEGER Lcn;
+    } Extents[1];
+} RETRIEVAL_POINTERS_BUFFER;
+
+typedef struct _FILE_ALLOCATED_RANGE_BUFFER
+{
+    LARGE_INTEGER FileOffset;
+    LARGE_INTEGER Length;
+} FILE_ALLOCATED_RANGE_BUFFER;